@@ -1,11 +1,39 @@
 #include "AssetsOps.h"
 
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 
 namespace Corium3D {	
 
-	typedef unsigned int file_loc_t;
-	typedef unsigned short collection_sz_t;
+	typedef uint64_t file_loc_t;
+	typedef uint32_t collection_sz_t;
+	// the first version's - headerless, with 16 bits counts and 32 bits offsets, and the models' descriptions without the
+	// baked data
+	typedef unsigned int legacy_file_loc_t;
+	typedef unsigned short legacy_collection_sz_t;
+	const unsigned int LEGACY_STREAM_ASSETS_VERSION = 1;
+	// the first version with the models' data baked
+	const unsigned int BAKED_STREAM_ASSETS_VERSION = 2;
+	// the first version with levels of detail
+	const unsigned int LODS_STREAM_ASSETS_VERSION = 3;
+
+	struct StreamAssetsHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t modelsNr;
+		uint32_t scenesNr;
+	};
+
+	// the animations' descriptions of the versions preceding the baked data - without their durations
+	struct PreBakeAnimationDesc {
+		unsigned int keyFramesNr;
+		unsigned int channelsNr;
+		unsigned int transformatsHierarchyNodesMeshesNrs;
+		unsigned int transformatsHierarchyNodesChildrenNr;
+		unsigned int transformatsHierarchyNodesNr;
+		unsigned int transformatsHierarchyDepthMax;
+	};
 
 	template <class T>
 	inline T readVal(std::ifstream& file) {
@@ -19,8 +47,9 @@ namespace Corium3D {
 		file.write((char*)&val, sizeof(T));		
 	}
 
+	template <class SzT>
 	inline void readStr(std::ifstream& file, std::string& outStr) {
-		unsigned int sz = readVal<collection_sz_t>(file);
+		unsigned int sz = readVal<SzT>(file);
 		outStr.resize(sz);		
 		//std::istreambuf_iterator<char> startIt(file);
 		//std::istreambuf_iterator<char> endIt(std::next(startIt, sz));		
@@ -46,9 +75,9 @@ namespace Corium3D {
 		file.write((char*)&arr[0], sizeof(T) * SZ);		
 	}
 
-	template <class T>
+	template <class SzT, class T>
 	inline void readVec(std::ifstream& file, std::vector<T>& outVec) {		
-		collection_sz_t sz = readVal<collection_sz_t>(file);
+		SzT sz = readVal<SzT>(file);
 		outVec.resize(sz);
 		if (sz > 0)
 			file.read((char*)&outVec[0], sizeof(T) * sz);
@@ -63,25 +92,67 @@ namespace Corium3D {
 	}
 
 	template <class T>
-	inline void readValsSeq(std::ifstream& file, collection_sz_t valsNr, std::vector<T>& outVec) {
+	inline void readValsSeq(std::ifstream& file, unsigned int valsNr, std::vector<T>& outVec) {
 		outVec.resize(valsNr);
 		if (valsNr > 0)
 			file.read((char*)&outVec[0], sizeof(T) * valsNr);
 	}	
 
 	template <class T>
-	inline void writeValsSeq(std::ofstream& file, T const* valsArr, collection_sz_t arrSz) {
+	inline void writeValsSeq(std::ofstream& file, T const* valsArr, unsigned int arrSz) {
 		if (arrSz > 0) 
 			file.write((char*)valsArr, sizeof(T) * arrSz);
 	}
 
-	void readModelDesc(std::ifstream& modelDescFile, ModelDesc& outSceneModl);
+	template <class SzT>
+	void readModelDesc(std::ifstream& modelDescFile, unsigned int version, ModelDesc& outSceneModl);
 
 	void writeModelDesc(std::ofstream& modelDescFile, ModelDesc const& modelDesc);
 	
+	template <class SzT>
 	void readSceneData(std::ifstream& sceneDataFile, SceneData& outSceneData);
 	
 	void writeSceneData(std::ofstream& sceneDataFile, SceneData const& sceneDesc);
+
+	// reads out the models' and the scenes' file locations, of any supported version (throws on others). returns the file's version
+	static unsigned int readFileLocs(std::ifstream& assetsFile, std::string const& assetsFileFullPath, std::vector<file_loc_t>& outModelDescsFileLocs, std::vector<file_loc_t>& outScenesDataFileLocs) {
+		StreamAssetsHeader header;
+		if (assetsFile.read((char*)&header, sizeof(header)) && memcmp(header.magic, STREAM_ASSETS_MAGIC, sizeof(header.magic)) == 0) {
+			if (header.version <= LEGACY_STREAM_ASSETS_VERSION || header.version > STREAM_ASSETS_VERSION)
+				throw std::ios_base::failure(assetsFileFullPath + " is of an unsupported version.");
+			readValsSeq(assetsFile, header.modelsNr, outModelDescsFileLocs);
+			readValsSeq(assetsFile, header.scenesNr, outScenesDataFileLocs);
+			return header.version;
+		}
+
+		assetsFile.clear();
+		assetsFile.seekg(0);
+		std::vector<legacy_file_loc_t> modelDescsFileLocs;
+		readVec<legacy_collection_sz_t>(assetsFile, modelDescsFileLocs);
+		// the scenes locations are not counted - they span up to the first model (or the first scene, if there are no models)
+		legacy_file_loc_t scenesDataFileLocsEnd = modelDescsFileLocs.empty() ? readVal<legacy_file_loc_t>(assetsFile) : modelDescsFileLocs[0];
+		legacy_file_loc_t scenesDataFileLocsStart = sizeof(legacy_collection_sz_t) + modelDescsFileLocs.size() * sizeof(legacy_file_loc_t);
+		assetsFile.seekg(scenesDataFileLocsStart);
+		std::vector<legacy_file_loc_t> scenesDataFileLocs;
+		readValsSeq(assetsFile, (scenesDataFileLocsEnd - scenesDataFileLocsStart) / sizeof(legacy_file_loc_t), scenesDataFileLocs);
+		outModelDescsFileLocs.assign(modelDescsFileLocs.begin(), modelDescsFileLocs.end());
+		outScenesDataFileLocs.assign(scenesDataFileLocs.begin(), scenesDataFileLocs.end());
+		return LEGACY_STREAM_ASSETS_VERSION;
+	}
+
+	static void readModelDesc(std::ifstream& assetsFile, unsigned int version, ModelDesc& outModelDesc) {
+		if (version == LEGACY_STREAM_ASSETS_VERSION)
+			readModelDesc<legacy_collection_sz_t>(assetsFile, version, outModelDesc);
+		else
+			readModelDesc<collection_sz_t>(assetsFile, version, outModelDesc);
+	}
+
+	static void readSceneData(std::ifstream& assetsFile, unsigned int version, SceneData& outSceneData) {
+		if (version == LEGACY_STREAM_ASSETS_VERSION)
+			readSceneData<legacy_collection_sz_t>(assetsFile, outSceneData);
+		else
+			readSceneData<collection_sz_t>(assetsFile, outSceneData);
+	}
 	
 	void readSceneAssets(std::string const& assetsFileFullPath, unsigned int sceneIdx, SceneData& outSceneData, std::vector<ModelDesc>& outModelDescs, std::vector<unsigned int>& outModelSceneModelIdxsMap)
 	{
@@ -91,34 +162,81 @@ namespace Corium3D {
 			throw std::ios_base::failure(assetsFileFullPath + " failed to open.");
 #endif	
 
-		// readout models number
-		collection_sz_t modelsNr = readVal<collection_sz_t>(assetsFile);
-		assetsFile.seekg(sizeof(collection_sz_t) + modelsNr * sizeof(file_loc_t) + sceneIdx * sizeof(file_loc_t));		
-		assetsFile.seekg(readVal<file_loc_t>(assetsFile));
-		readSceneData(assetsFile, outSceneData);
+		std::vector<file_loc_t> modelDescsFileLocs;
+		std::vector<file_loc_t> scenesDataFileLocs;
+		unsigned int version = readFileLocs(assetsFile, assetsFileFullPath, modelDescsFileLocs, scenesDataFileLocs);
+
+		assetsFile.seekg(scenesDataFileLocs[sceneIdx]);
+		readSceneData(assetsFile, version, outSceneData);
 		unsigned int sceneModelsNr = outSceneData.sceneModelsData.size();
 		outModelDescs.resize(sceneModelsNr);
-		outModelSceneModelIdxsMap.resize(modelsNr);		
+		outModelSceneModelIdxsMap.resize(modelDescsFileLocs.size());		
 
 		unsigned int staticModelIdx = 0;
 		unsigned int mobileModelIdx = 0;
 		for (unsigned int modelIdx = 0; modelIdx < sceneModelsNr; ++modelIdx) {
-			assetsFile.seekg(sizeof(collection_sz_t) + outSceneData.sceneModelsData[modelIdx].modelIdx * sizeof(file_loc_t));
-			assetsFile.seekg(readVal<file_loc_t>(assetsFile));			
+			assetsFile.seekg(modelDescsFileLocs[outSceneData.sceneModelsData[modelIdx].modelIdx]);
 			if (outSceneData.sceneModelsData[modelIdx].isStatic) {				
 				outModelSceneModelIdxsMap[outSceneData.sceneModelsData[modelIdx].modelIdx] = staticModelIdx;
-				readModelDesc(assetsFile, outModelDescs[staticModelIdx++]);
+				readModelDesc(assetsFile, version, outModelDescs[staticModelIdx++]);
 			}				
 			else {
 				unsigned int modelIdxMapped = sceneModelsNr - 1 - mobileModelIdx++;
 				outModelSceneModelIdxsMap[outSceneData.sceneModelsData[modelIdx].modelIdx] = modelIdxMapped;
-				readModelDesc(assetsFile, outModelDescs[modelIdxMapped]);				
+				readModelDesc(assetsFile, version, outModelDescs[modelIdxMapped]);				
 			}						
 		}
 
 		assetsFile.close();
 	}
 
+	void readModelDescs(std::string const& assetsFileFullPath, std::vector<ModelDesc>& outModelDescs)
+	{
+		std::ifstream assetsFile(assetsFileFullPath, std::ios::binary);
+#ifdef DEBUG
+		if (!assetsFile.is_open())
+			throw std::ios_base::failure(assetsFileFullPath + " failed to open.");
+#endif	
+
+		std::vector<file_loc_t> modelDescsFileLocs;
+		std::vector<file_loc_t> scenesDataFileLocs;
+		unsigned int version = readFileLocs(assetsFile, assetsFileFullPath, modelDescsFileLocs, scenesDataFileLocs);
+
+		outModelDescs.resize(modelDescsFileLocs.size());
+		for (unsigned int modelIdx = 0; modelIdx < modelDescsFileLocs.size(); ++modelIdx) {
+			assetsFile.seekg(modelDescsFileLocs[modelIdx]);
+			readModelDesc(assetsFile, version, outModelDescs[modelIdx]);
+		}
+
+		assetsFile.close();
+	}
+
+	void readAssetsFile(std::string const& assetsFileFullPath, std::vector<ModelDesc>& outModelDescs, std::vector<SceneData>& outScenesData)
+	{
+		std::ifstream assetsFile(assetsFileFullPath, std::ios::binary);
+#ifdef DEBUG
+		if (!assetsFile.is_open())
+			throw std::ios_base::failure(assetsFileFullPath + " failed to open.");
+#endif	
+
+		std::vector<file_loc_t> modelDescsFileLocs;
+		std::vector<file_loc_t> scenesDataFileLocs;
+		unsigned int version = readFileLocs(assetsFile, assetsFileFullPath, modelDescsFileLocs, scenesDataFileLocs);
+
+		outModelDescs.resize(modelDescsFileLocs.size());
+		for (unsigned int modelIdx = 0; modelIdx < modelDescsFileLocs.size(); ++modelIdx) {
+			assetsFile.seekg(modelDescsFileLocs[modelIdx]);
+			readModelDesc(assetsFile, version, outModelDescs[modelIdx]);
+		}
+		outScenesData.resize(scenesDataFileLocs.size());
+		for (unsigned int sceneIdx = 0; sceneIdx < scenesDataFileLocs.size(); ++sceneIdx) {
+			assetsFile.seekg(scenesDataFileLocs[sceneIdx]);
+			readSceneData(assetsFile, version, outScenesData[sceneIdx]);
+		}
+
+		assetsFile.close();
+	}
+
 	void writeAssetsFile(std::string const& assetsFileFullPath, std::vector<ModelDesc const*> const& modelDescs, std::vector<SceneData const*> const& scenesData)
 	{
 		std::ofstream assetsFile(assetsFileFullPath, std::ios::binary);
@@ -127,30 +245,35 @@ namespace Corium3D {
 			throw std::ios_base::failure(assetsFileFullPath + " failed to open.");
 #endif	
 
-		unsigned int modelsNr = modelDescs.size();
-		unsigned int scenesNr = scenesData.size();
-		std::vector<file_loc_t> modelDescsFileLocs(modelsNr);
-		std::vector<file_loc_t> scenesDataFileLocs(scenesNr);
-		writeVec(assetsFile, modelDescsFileLocs);
-		writeValsSeq(assetsFile, &scenesDataFileLocs[0], scenesNr);
-		for (unsigned int modelIdx = 0; modelIdx < modelsNr; ++modelIdx) {
+		StreamAssetsHeader header;
+		memcpy(header.magic, STREAM_ASSETS_MAGIC, sizeof(header.magic));
+		header.version = STREAM_ASSETS_VERSION;
+		header.modelsNr = modelDescs.size();
+		header.scenesNr = scenesData.size();
+		std::vector<file_loc_t> modelDescsFileLocs(header.modelsNr);
+		std::vector<file_loc_t> scenesDataFileLocs(header.scenesNr);
+		writeVal(assetsFile, header);
+		writeValsSeq(assetsFile, modelDescsFileLocs.data(), header.modelsNr);
+		writeValsSeq(assetsFile, scenesDataFileLocs.data(), header.scenesNr);
+		for (unsigned int modelIdx = 0; modelIdx < header.modelsNr; ++modelIdx) {
 			modelDescsFileLocs[modelIdx] = assetsFile.tellp();
 			writeModelDesc(assetsFile, *modelDescs[modelIdx]);						
 		}
-		for (unsigned int sceneIdx = 0; sceneIdx < scenesNr; ++sceneIdx) {
+		for (unsigned int sceneIdx = 0; sceneIdx < header.scenesNr; ++sceneIdx) {
 			scenesDataFileLocs[sceneIdx] = assetsFile.tellp();
 			writeSceneData(assetsFile, *scenesData[sceneIdx]);
 		}
 
-		assetsFile.seekp(0);
-		writeVec(assetsFile, modelDescsFileLocs);
-		writeValsSeq(assetsFile, &scenesDataFileLocs[0], scenesNr);
+		assetsFile.seekp(sizeof(header));
+		writeValsSeq(assetsFile, modelDescsFileLocs.data(), header.modelsNr);
+		writeValsSeq(assetsFile, scenesDataFileLocs.data(), header.scenesNr);
 
 		assetsFile.close();
 	}
 
-	void readModelDesc(std::ifstream& modelDescFile, ModelDesc& outModelDesc) {
-		readStr(modelDescFile, outModelDesc.colladaPath);
+	template <class SzT>
+	void readModelDesc(std::ifstream& modelDescFile, unsigned int version, ModelDesc& outModelDesc) {
+		readStr<SzT>(modelDescFile, outModelDesc.colladaPath);
 		if (!outModelDesc.colladaPath.empty()) {
 			outModelDesc.verticesNr = readVal<unsigned int>(modelDescFile);
 			outModelDesc.meshesNr = readVal<unsigned int>(modelDescFile);
@@ -171,7 +294,51 @@ namespace Corium3D {
 			outModelDesc.progIdx = readVal<unsigned int>(modelDescFile);
 			outModelDesc.bonesNr = readVal<unsigned int>(modelDescFile);
 			readValsSeq<unsigned int>(modelDescFile, outModelDesc.meshesNr, outModelDesc.bonesNrsPerMesh);
-			readVec<ModelDesc::AnimationDesc>(modelDescFile, outModelDesc.animationsDescs);
+			if (version < BAKED_STREAM_ASSETS_VERSION) {
+				// the models' data is not baked - it is left to be imported from their model files
+				std::vector<PreBakeAnimationDesc> animationsDescs;
+				readVec<SzT>(modelDescFile, animationsDescs);
+				outModelDesc.animationsDescs.resize(animationsDescs.size());
+				for (unsigned int animationIdx = 0; animationIdx < animationsDescs.size(); animationIdx++) {
+					ModelDesc::AnimationDesc& animationDesc = outModelDesc.animationsDescs[animationIdx];
+					animationDesc.keyFramesNr = animationsDescs[animationIdx].keyFramesNr;
+					animationDesc.channelsNr = animationsDescs[animationIdx].channelsNr;
+					animationDesc.transformatsHierarchyNodesMeshesNrs = animationsDescs[animationIdx].transformatsHierarchyNodesMeshesNrs;
+					animationDesc.transformatsHierarchyNodesChildrenNr = animationsDescs[animationIdx].transformatsHierarchyNodesChildrenNr;
+					animationDesc.transformatsHierarchyNodesNr = animationsDescs[animationIdx].transformatsHierarchyNodesNr;
+					animationDesc.transformatsHierarchyDepthMax = animationsDescs[animationIdx].transformatsHierarchyDepthMax;
+					animationDesc.dur = 0.0;
+					animationDesc.ticksPerSecond = 0.0;
+				}
+			}
+			else {
+				readVec<SzT>(modelDescFile, outModelDesc.animationsDescs);
+
+				readValsSeq<ModelDesc::VertexData>(modelDescFile, outModelDesc.verticesNr, outModelDesc.vertices);
+				readValsSeq<unsigned int>(modelDescFile, 3 * outModelDesc.facesNr, outModelDesc.idxs);
+				readValsSeq<ModelDesc::SubmeshDesc>(modelDescFile, outModelDesc.meshesNr, outModelDesc.submeshesDescs);
+				readValsSeq<glm::mat4>(modelDescFile, outModelDesc.meshesNr, outModelDesc.meshesTransforms);
+				readValsSeq<glm::mat4>(modelDescFile, outModelDesc.bonesNr, outModelDesc.bonesOffsets);
+				readValsSeq<ModelDesc::TransformatsHierarchyNodeDesc>(modelDescFile, readVal<unsigned int>(modelDescFile), outModelDesc.transformatsHierarchy);
+				readValsSeq<unsigned int>(modelDescFile, readVal<unsigned int>(modelDescFile), outModelDesc.transformatsHierarchyMeshesIdxs);
+				unsigned int animationsNr = outModelDesc.animationsDescs.size();
+				outModelDesc.animationsKeys.resize(animationsNr);
+				for (unsigned int animationIdx = 0; animationIdx < animationsNr; animationIdx++) {
+					ModelDesc::AnimationDesc const& animationDesc = outModelDesc.animationsDescs[animationIdx];
+					ModelDesc::AnimationKeys& animationKeys = outModelDesc.animationsKeys[animationIdx];
+					unsigned int keysNr = animationDesc.channelsNr * animationDesc.keyFramesNr;
+					readValsSeq<double>(modelDescFile, animationDesc.keyFramesNr, animationKeys.keyFramesTimes);
+					readValsSeq<unsigned int>(modelDescFile, animationDesc.channelsNr, animationKeys.channelsNodesIdxs);
+					readValsSeq<glm::vec3>(modelDescFile, keysNr, animationKeys.scales);
+					readValsSeq<glm::quat>(modelDescFile, keysNr, animationKeys.rots);
+					readValsSeq<glm::vec3>(modelDescFile, keysNr, animationKeys.translations);
+				}
+				if (version >= LODS_STREAM_ASSETS_VERSION) {
+					readVec<SzT>(modelDescFile, outModelDesc.lodsDescs);
+					readVec<SzT>(modelDescFile, outModelDesc.lodsIdxs);
+					readValsSeq<ModelDesc::SubmeshDesc>(modelDescFile, outModelDesc.lodsDescs.size() * outModelDesc.meshesNr, outModelDesc.lodsSubmeshesDescs);
+				}
+			}
 		}
 
 		outModelDesc.boundingSphereCenter = readVal<glm::vec3>(modelDescFile);
@@ -232,6 +399,29 @@ namespace Corium3D {
 			writeVal<unsigned int>(modelDescFile, modelDesc.bonesNr);
 			writeValsSeq<unsigned int>(modelDescFile, &modelDesc.bonesNrsPerMesh[0], modelDesc.meshesNr);
 			writeVec<ModelDesc::AnimationDesc>(modelDescFile, modelDesc.animationsDescs);
+
+			writeValsSeq<ModelDesc::VertexData>(modelDescFile, modelDesc.vertices.data(), modelDesc.verticesNr);
+			writeValsSeq<unsigned int>(modelDescFile, modelDesc.idxs.data(), 3 * modelDesc.facesNr);
+			writeValsSeq<ModelDesc::SubmeshDesc>(modelDescFile, modelDesc.submeshesDescs.data(), modelDesc.meshesNr);
+			writeValsSeq<glm::mat4>(modelDescFile, modelDesc.meshesTransforms.data(), modelDesc.meshesNr);
+			writeValsSeq<glm::mat4>(modelDescFile, modelDesc.bonesOffsets.data(), modelDesc.bonesNr);
+			writeVal<unsigned int>(modelDescFile, modelDesc.transformatsHierarchy.size());
+			writeValsSeq<ModelDesc::TransformatsHierarchyNodeDesc>(modelDescFile, modelDesc.transformatsHierarchy.data(), modelDesc.transformatsHierarchy.size());
+			writeVal<unsigned int>(modelDescFile, modelDesc.transformatsHierarchyMeshesIdxs.size());
+			writeValsSeq<unsigned int>(modelDescFile, modelDesc.transformatsHierarchyMeshesIdxs.data(), modelDesc.transformatsHierarchyMeshesIdxs.size());
+			for (unsigned int animationIdx = 0; animationIdx < modelDesc.animationsDescs.size(); animationIdx++) {
+				ModelDesc::AnimationDesc const& animationDesc = modelDesc.animationsDescs[animationIdx];
+				ModelDesc::AnimationKeys const& animationKeys = modelDesc.animationsKeys[animationIdx];
+				unsigned int keysNr = animationDesc.channelsNr * animationDesc.keyFramesNr;
+				writeValsSeq<double>(modelDescFile, animationKeys.keyFramesTimes.data(), animationDesc.keyFramesNr);
+				writeValsSeq<unsigned int>(modelDescFile, animationKeys.channelsNodesIdxs.data(), animationDesc.channelsNr);
+				writeValsSeq<glm::vec3>(modelDescFile, animationKeys.scales.data(), keysNr);
+				writeValsSeq<glm::quat>(modelDescFile, animationKeys.rots.data(), keysNr);
+				writeValsSeq<glm::vec3>(modelDescFile, animationKeys.translations.data(), keysNr);
+			}
+			writeVec<ModelDesc::LodDesc>(modelDescFile, modelDesc.lodsDescs);
+			writeVec<unsigned int>(modelDescFile, modelDesc.lodsIdxs);
+			writeValsSeq<ModelDesc::SubmeshDesc>(modelDescFile, modelDesc.lodsSubmeshesDescs.data(), modelDesc.lodsDescs.size() * modelDesc.meshesNr);
 		}
 
 		writeVal<glm::vec3>(modelDescFile, modelDesc.boundingSphereCenter);
@@ -272,6 +462,7 @@ namespace Corium3D {
 		}				
 	}
 
+	template <class SzT>
 	void readSceneData(std::ifstream& sceneDataFile, SceneData& outSceneData) {
 		outSceneData.staticModelsNr = readVal<unsigned int>(sceneDataFile);		
 		unsigned int modelsNr = readVal<unsigned int>(sceneDataFile);
@@ -281,7 +472,7 @@ namespace Corium3D {
 			sceneModelData.modelIdx = readVal<unsigned int>(sceneDataFile);
 			sceneModelData.isStatic = readVal<bool>(sceneDataFile);
 			sceneModelData.instancesNrMax = readVal<unsigned int>(sceneDataFile);			
-			readVec<Transform3D>(sceneDataFile, sceneModelData.instancesTransformsInit);
+			readVec<SzT>(sceneDataFile, sceneModelData.instancesTransformsInit);
 		}
 
 		readArr<unsigned int, CollisionPrimitive3DType::__PRIMITIVE3D_TYPES_NR__>(sceneDataFile, outSceneData.collisionPrimitives3DInstancesNrsMaxima);
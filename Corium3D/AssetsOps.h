@@ -6,8 +6,20 @@
 #include <vector>
 #include <array>
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 namespace Corium3D {
+
+	const unsigned int BONES_NR_PER_VERTEX_MAX = 4;
+	// including the full detail level
+	const unsigned int MODEL_LODS_NR_MAX = 4;
+
+	// Stream assets file (writeAssetsFile) - a header, the models' and the scenes' 64 bits file locations and the records,
+	// whose collections are prefixed by 32 bits counts. Files of the first, headerless version (16 bits counts and 32 bits
+	// locations), which hold the models' descriptions without their baked data, are still read, and so are files of the second
+	// version (no levels of detail).
+	const char STREAM_ASSETS_MAGIC[4] = { 'C', '3', 'D', 'S' };
+	const unsigned int STREAM_ASSETS_VERSION = 3;
 	
 	enum CollisionPrimitive3DType { BOX, SPHERE, CAPSULE, __PRIMITIVE3D_TYPES_NR__, NO_3D_COLLIDER };
 	enum CollisionPrimitive2DType { RECT, CIRCLE, STADIUM, __PRIMITIVE2D_TYPES_NR__, NO_2D_COLLIDER };
@@ -86,6 +98,50 @@ namespace Corium3D {
 			unsigned int transformatsHierarchyNodesChildrenNr;
 			unsigned int transformatsHierarchyNodesNr;
 			unsigned int transformatsHierarchyDepthMax;
+			double dur;
+			double ticksPerSecond;
+		};
+
+		// the renderer's vertex buffer layout - baked as is and uploaded without processing
+		struct VertexData {
+			glm::vec3 pos;
+			unsigned int bonesIDs[BONES_NR_PER_VERTEX_MAX];
+			float bonesWeights[BONES_NR_PER_VERTEX_MAX];
+		};
+
+		// vertices and indices ranges of a mesh within the model's baked buffers (indices are relative to baseVertex)
+		struct SubmeshDesc {
+			unsigned int baseVertex;
+			unsigned int verticesNr;
+			unsigned int firstIdx;
+			unsigned int idxsNr;
+		};
+
+		// a coarser level of detail - a simplification of the model's meshes over the same vertices
+		struct LodDesc {
+			// the level is drawn where the model's bounding sphere's projected diameter is smaller than this share of the
+			// viewport's height. descending along the levels
+			float screenSzMax;
+			unsigned int facesNr;
+		};
+
+		// transformats hierarchy node - the hierarchy is laid out in depth-first pre-order, root first
+		struct TransformatsHierarchyNodeDesc {
+			glm::mat4 transformat;
+			unsigned int childrenNr;
+			unsigned int boneIdx; // UINT_MAX for nodes that are not bones
+			unsigned int meshesIdxsBaseIdx; // into transformatsHierarchyMeshesIdxs
+			unsigned int meshesNr;
+		};
+
+		// keys resampled onto the union of the channels' key times, so every channel has a key on every key frame.
+		// keys are channel-major: [channelIdx * keyFramesNr + keyFrameIdx]
+		struct AnimationKeys {
+			std::vector<double> keyFramesTimes; // starts at 0
+			std::vector<unsigned int> channelsNodesIdxs; // ascending
+			std::vector<glm::vec3> scales;
+			std::vector<glm::quat> rots;
+			std::vector<glm::vec3> translations;
 		};
 
 		std::string colladaPath;
@@ -104,6 +160,22 @@ namespace Corium3D {
 		std::vector<unsigned int> bonesNrsPerMesh;		
 		std::vector<AnimationDesc> animationsDescs;
 
+		// baked by the assets generator, so that loading a scene involves no model files parsing
+		std::vector<VertexData> vertices;
+		std::vector<unsigned int> idxs;
+		std::vector<SubmeshDesc> submeshesDescs;
+		// the levels coarser than the full detail one, finest first (up to MODEL_LODS_NR_MAX - 1)
+		std::vector<LodDesc> lodsDescs;
+		// the levels' indices, level after level, laid out as idxs
+		std::vector<unsigned int> lodsIdxs;
+		// [lodIdx * meshesNr + meshIdx] (lodIdx into lodsDescs) - the mesh's vertices ranges, with indices ranges into lodsIdxs
+		std::vector<SubmeshDesc> lodsSubmeshesDescs;
+		std::vector<glm::mat4> meshesTransforms;
+		std::vector<glm::mat4> bonesOffsets;
+		std::vector<TransformatsHierarchyNodeDesc> transformatsHierarchy;
+		std::vector<unsigned int> transformatsHierarchyMeshesIdxs;
+		std::vector<AnimationKeys> animationsKeys;
+
 		glm::vec3 boundingSphereCenter;
 		float boundingSphereRadius;
 
@@ -112,6 +184,12 @@ namespace Corium3D {
 
 	void readSceneAssets(std::string const& assetsFileFullPath, unsigned int sceneIdx, SceneData& outSceneData, std::vector<ModelDesc>& outModelDescs, std::vector<unsigned int>& outModelSceneModelIdxsMap);
 
+	// reads out every model description in the file, in the models' indices order
+	void readModelDescs(std::string const& assetsFileFullPath, std::vector<ModelDesc>& outModelDescs);
+
+	// reads out the whole file - every model description and every scene's data, in their indices orders
+	void readAssetsFile(std::string const& assetsFileFullPath, std::vector<ModelDesc>& outModelDescs, std::vector<SceneData>& outScenesData);
+
 	void writeAssetsFile(std::string const& fullPath, std::vector<ModelDesc const*> const& modelDescs, std::vector<SceneData const*> const& scenesData);
 
 	void readFileToStr(std::string const& fileName, std::string& strOut);
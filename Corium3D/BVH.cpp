@@ -1,10 +1,12 @@
 #include "BVH.h"
 
 #include "ServiceLocator.h"
+#include "Profiler.h"
 #include <math.h>
 #include <glm/gtx/norm.hpp>
 #include <limits.h>
 #include <string>
+#include <algorithm>
 
 using namespace Corium3DUtils;
 
@@ -16,13 +18,13 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 
 	BVH::BVH(unsigned int staticGameLmnts3DNrMax, unsigned int mobileGameLmnts3DNrMax, unsigned int staticGameLmnts2DNrMax, unsigned int mobileGameLmnts2DNrMax, unsigned int collisions2DNrMax, unsigned int collisions3DNrMax) {
 		// 3D pools	
-		branchNodes3DPool = new ObjPool<Node3D>(staticGameLmnts3DNrMax + mobileGameLmnts3DNrMax - 2);
-		staticNodes3DPool = new ObjPool<DataNode3D>(staticGameLmnts3DNrMax);
-		mobileNodes3DPool = new ObjPool<MobileGameLmntDataNode3D>(mobileGameLmnts3DNrMax);		
+		branchNodes3DPool = new ChunkedObjPool<Node3D>(std::max(staticGameLmnts3DNrMax + mobileGameLmnts3DNrMax, 2u) - 2);
+		staticNodes3DPool = new ChunkedObjPool<DataNode3D>(staticGameLmnts3DNrMax);
+		mobileNodes3DPool = new ChunkedObjPool<MobileGameLmntDataNode3D>(mobileGameLmnts3DNrMax);		
 		// 2D pools	
-		branchNodes2DPool = new ObjPool<Node2D>(staticGameLmnts2DNrMax + mobileGameLmnts2DNrMax - 2);
-		staticNodes2DPool = new ObjPool<DataNode2D>(staticGameLmnts2DNrMax);
-		mobileNodes2DPool = new ObjPool<MobileGameLmntDataNode2D>(mobileGameLmnts2DNrMax);	
+		branchNodes2DPool = new ChunkedObjPool<Node2D>(std::max(staticGameLmnts2DNrMax + mobileGameLmnts2DNrMax, 2u) - 2);
+		staticNodes2DPool = new ChunkedObjPool<DataNode2D>(staticGameLmnts2DNrMax);
+		mobileNodes2DPool = new ChunkedObjPool<MobileGameLmntDataNode2D>(mobileGameLmnts2DNrMax);	
 	
 		// theoretically possible maximum collisions number: mobileGameLmntsNrMax*staticGameLmntsNrMax + mobileGameLmntsNrMax*[mobileGameLmntsNrMax - 1)]/2	
 		collisionsBuffers3D.collisionsData.collisionsDataBuffer = new CollisionData<glm::vec3>[collisions3DNrMax];
@@ -31,6 +33,7 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 		collisionsBuffers3D.broadPhaseResBuffer.collisionsData = new CollisionData<glm::vec3>[collisions3DNrMax];
 		collisionsBuffers3D.collisionsRecord = new SearchTreeAVL<CollisionData<glm::vec3>>(collisions3DNrMax);
 		collisionsBuffers3D.collisionsRecordIt = new SearchTreeAVL<CollisionData<glm::vec3>>::InOrderIt(*collisionsBuffers3D.collisionsRecord);
+		collisionsBuffers3D.bufferSz = collisions3DNrMax;
 
 		collisionsBuffers2D.collisionsData.collisionsDataBuffer = new CollisionData<glm::vec2>[collisions2DNrMax];
 		collisionsBuffers2D.collisionsData.detachmentsDataBuffer = new CollisionData<glm::vec2>[collisions2DNrMax];
@@ -38,6 +41,7 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 		collisionsBuffers2D.broadPhaseResBuffer.collisionsData = new CollisionData<glm::vec2>[collisions2DNrMax];
 		collisionsBuffers2D.collisionsRecord = new SearchTreeAVL<CollisionData<glm::vec2>>(collisions2DNrMax);
 		collisionsBuffers2D.collisionsRecordIt = new SearchTreeAVL<CollisionData<glm::vec2>>::InOrderIt(*collisionsBuffers2D.collisionsRecord);
+		collisionsBuffers2D.bufferSz = collisions2DNrMax;
 	}
 
 	BVH::~BVH() {
@@ -61,7 +65,13 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 		delete branchNodes3DPool;
 	}
 
+	void BVH::setTestedModelsPairs(unsigned char const* testedModelsPairs, unsigned int modelsNr) {
+		collisionsBuffers3D.broadPhaseResBuffer.testedModelsPairs = collisionsBuffers2D.broadPhaseResBuffer.testedModelsPairs = testedModelsPairs;
+		collisionsBuffers3D.broadPhaseResBuffer.modelsNr = collisionsBuffers2D.broadPhaseResBuffer.modelsNr = modelsNr;
+	}
+
 	void BVH::refitBPsDueToUpdate() {
+		PROFILE_ZONE("BVH::refitBPsDueToUpdate");
 		if (mobileNodes3DRoot != NULL && !mobileNodes3DRoot->isLeaf())
 			doRefitBPsDueToUpdate<AABB3DRotatable>(mobileNodes3DRoot);
 		if (mobileNodes2DRoot != NULL && !mobileNodes2DRoot->isLeaf())
@@ -353,6 +363,7 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 	*/
 
 	BVH::CollisionsData<glm::vec3> const& BVH::getCollisionsData3D() {
+		PROFILE_ZONE("BVH::getCollisionsData3D");
 		return doCollisionsSearch<AABB3DRotatable, DataNode3D, glm::vec3>(staticNodes3DRoot, mobileNodes3DRoot, collisionsBuffers3D);
 		//return collisionsBuffers3D.collisionsData;
 	}
@@ -544,7 +555,7 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 	}
 
 	template <class TAABB, class TNode>
-	void BVH::doInsert(TNode** nodesRoot, TNode* newNode, Corium3DUtils::ObjPool<TNode>* nodesPool, unsigned int& nodesCounter) {
+	void BVH::doInsert(TNode** nodesRoot, TNode* newNode, Corium3DUtils::ChunkedObjPool<TNode>* nodesPool, unsigned int& nodesCounter) {
 		// T const& data	
 		if (*nodesRoot != NULL) {
 			if (!(*nodesRoot)->isLeaf()) {
@@ -556,6 +567,9 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 						newNodeSiblingParent->replaceChild(newBranch, 0);
 					else
 						newNodeSiblingParent->replaceChild(newBranch, 1);
+					// replaceChild() refits the parent only - the rest of the ancestors' BVs must enclose the new node as well
+					for (Node<TAABB>* ancestorsIt = newNodeSiblingParent->parent; ancestorsIt != NULL; ancestorsIt = ancestorsIt->parent)
+						ancestorsIt->refitBVs();
 				}
 				else {
 					*nodesRoot = newBranch;
@@ -576,7 +590,7 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 	}
 
 	template <class TAABB, class TNode>
-	void BVH::doRemove(TNode** nodesRoot, TNode* nodeToRemove, Corium3DUtils::ObjPool<TNode>* nodesPool, unsigned int& nodesCounter) {
+	void BVH::doRemove(TNode** nodesRoot, TNode* nodeToRemove, Corium3DUtils::ChunkedObjPool<TNode>* nodesPool, unsigned int& nodesCounter) {
 		if (*nodesRoot != nodeToRemove) {
 			Node<TAABB>* nodeParent = nodeToRemove->parent;
 			Node<TAABB>* nodeSibling;
@@ -591,6 +605,8 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 					nodeGrandParent->replaceChild(nodeSibling, 0);
 				else
 					nodeGrandParent->replaceChild(nodeSibling, 1);
+				for (Node<TAABB>* ancestorsIt = nodeGrandParent->parent; ancestorsIt != NULL; ancestorsIt = ancestorsIt->parent)
+					ancestorsIt->refitBVs();
 
 				//balanceTreeUpwards(nodeParent->parent);
 			}
@@ -681,6 +697,7 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 		/*  ================================================================================================ */
 
 		// NARROW PHASE //	
+		PROFILE_ZONE("BVH::narrowPhase");
 		BroadPhaseCollisionsData<V>& broadPhaseResBuffer = collisionsBuffers.broadPhaseResBuffer;
 		for (unsigned int duoIdx = 0; duoIdx < broadPhaseResBuffer.collisionsNr; duoIdx++) {		
 			if (broadPhaseResBuffer.collisionPrimitivesDuos[duoIdx][0]->testCollision(broadPhaseResBuffer.collisionPrimitivesDuos[duoIdx][1], broadPhaseResBuffer.collisionsData[duoIdx].contactManifold)) {
@@ -689,6 +706,7 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 					returnedCollisionData.collisionState = CollisionData<V>::CollisionState::persist;
 			}
 		}
+		collisionsBuffers.broadPhaseCollisionsNrMax = std::max(collisionsBuffers.broadPhaseCollisionsNrMax, collisionsBuffers.broadPhaseResBuffer.collisionsNr);
 		collisionsBuffers.broadPhaseResBuffer.collisionsNr = 0;
 
 		collisionsBuffers.collisionsRecordIt->reset();
@@ -707,10 +725,34 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 					break;
 			}
 		}
+		collisionsBuffers.collisionsNrMax = std::max(collisionsBuffers.collisionsNrMax, collisionsBuffers.collisionsData.collisionsNr);
+		collisionsBuffers.detachmentsNrMax = std::max(collisionsBuffers.detachmentsNrMax, collisionsBuffers.collisionsData.detachmentsNr);
 
 		return collisionsBuffers.collisionsData;
 	}
 
+	void BVH::reportMemory(MemoryReport& memoryReport) const {
+		memoryReport.addPool("BVH", "branchNodes3D", *branchNodes3DPool);
+		memoryReport.addPool("BVH", "staticNodes3D", *staticNodes3DPool);
+		memoryReport.addPool("BVH", "mobileNodes3D", *mobileNodes3DPool);
+		memoryReport.addPool("BVH", "branchNodes2D", *branchNodes2DPool);
+		memoryReport.addPool("BVH", "staticNodes2D", *staticNodes2DPool);
+		memoryReport.addPool("BVH", "mobileNodes2D", *mobileNodes2DPool);
+		reportCollisionsBuffersMemory(collisionsBuffers3D, "3D", memoryReport);
+		reportCollisionsBuffersMemory(collisionsBuffers2D, "2D", memoryReport);
+	}
+
+	// REMINDER: the collisions records' search trees are not included
+	template <class V>
+	void BVH::reportCollisionsBuffersMemory(CollisionsBuffers<V> const& collisionsBuffers, const char* dimsStr, MemoryReport& memoryReport) {
+		memoryReport.addEntry("BVH", std::string("broadPhaseBuffer") + dimsStr, sizeof(std::array<CollisionPrimitive<V>*, 2>) + sizeof(CollisionData<V>),
+			collisionsBuffers.bufferSz, collisionsBuffers.broadPhaseResBuffer.collisionsNr, collisionsBuffers.broadPhaseCollisionsNrMax);
+		memoryReport.addEntry("BVH", std::string("collisionsDataBuffer") + dimsStr, sizeof(CollisionData<V>),
+			collisionsBuffers.bufferSz, collisionsBuffers.collisionsData.collisionsNr, collisionsBuffers.collisionsNrMax);
+		memoryReport.addEntry("BVH", std::string("detachmentsDataBuffer") + dimsStr, sizeof(CollisionData<V>),
+			collisionsBuffers.bufferSz, collisionsBuffers.collisionsData.detachmentsNr, collisionsBuffers.detachmentsNrMax);
+	}
+
 	template <class TAABB>
 	void BVH::setSubtreeDepthValues(Node<TAABB>* subtreeRoot) {
 		Node<TAABB>* nodesIt = subtreeRoot->children[0];
@@ -758,6 +800,8 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 				childR->replaceChild(childLL, 0);
 				childR->refitBVs();
 				childL->refitBVs();
+				// the AABB of the node is unchanged by the roll, its bounding sphere (combined out of the children's) is not
+				node->refitBVs();
 				break;
 			}
 
@@ -767,6 +811,7 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 				childR->replaceChild(childLL, 1);
 				childR->refitBVs();
 				childL->refitBVs();
+				node->refitBVs();
 				break;
 			}
 
@@ -863,7 +908,7 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 	*/
 
 	template <class TAABB>
-	static BVH::Node<TAABB>* BVH::findNewNodeSibling(Node<TAABB>* root, Node<TAABB>* newNode) {
+	BVH::Node<TAABB>* BVH::findNewNodeSibling(Node<TAABB>* root, Node<TAABB>* newNode) {
 		Node<TAABB>* nodesIt = root;
 		bool wasInsertionPlaceFound = false;
 		while (!nodesIt->isLeaf()) {
@@ -895,7 +940,7 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 	}
 
 	template <class TAABB>
-	static BVH::Node<TAABB>* BVH::heightUp(Node<TAABB>* retNode, unsigned int height) {
+	BVH::Node<TAABB>* BVH::heightUp(Node<TAABB>* retNode, unsigned int height) {
 		while (height--) retNode = retNode->parent;	
 		return retNode;
 	}
@@ -984,6 +1029,9 @@ const float RAY_DESTINATION_EXTRA_FACTOR = 0.01f;
 
 	template <class TDataNode, class V>
 	void BVH::recordBroadPhaseCollisionIdxsDuo(TDataNode* node1, TDataNode* node2, BroadPhaseCollisionsData<V>& broadPhaseResBuffer) {
+		if (broadPhaseResBuffer.testedModelsPairs && !broadPhaseResBuffer.testedModelsPairs[node1->modelIdx * broadPhaseResBuffer.modelsNr + node2->modelIdx])
+			return;
+
 		broadPhaseResBuffer.collisionPrimitivesDuos[broadPhaseResBuffer.collisionsNr][0] = &(node1->collisionPrimitive);
 		broadPhaseResBuffer.collisionPrimitivesDuos[broadPhaseResBuffer.collisionsNr][1] = &(node2->collisionPrimitive);
 		broadPhaseResBuffer.collisionsData[broadPhaseResBuffer.collisionsNr] =
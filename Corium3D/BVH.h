@@ -3,9 +3,11 @@
 #include "AABB.h"
 #include "BoundingSphere.h"
 #include "ObjPool.h"
+#include "ChunkedObjPool.h"
 #include "SearchTreeAVL.h"
 #include "PhysicsEngine.h"
 #include "CollisionPrimitives.h"
+#include "MemoryReport.h"
 
 #include <vector>
 #include <array>
@@ -49,7 +51,7 @@ namespace Corium3D {
 		class Node {
 		public:
 			friend BVH;
-			friend Corium3DUtils::ObjPool<Node<TAABB>>;
+			friend Corium3DUtils::ChunkedObjPool<Node<TAABB>>;
 
 			TAABB const& getAABB() const { return aabb; }
 			Node* getParent() const { return parent; }
@@ -89,10 +91,15 @@ namespace Corium3D {
 		class Node3D : public BVH::Node<AABB3DRotatable> {
 		public:
 			friend BVH;
-			friend Corium3DUtils::ObjPool<Node3D>;
+			friend Corium3DUtils::ChunkedObjPool<Node3D>;
 
 			BoundingSphere const& getBoundingSphere() const { return boundingSphere; }
 
+			static const unsigned int CULLING_VIEWS_NR_MAX = 8;
+
+			// frustum culling's coherency records, per view - the plane that rejected the node last (see FrustumCuller)
+			unsigned char lastRejectingPlanesIdxs[CULLING_VIEWS_NR_MAX] = {};
+
 		protected:
 			BoundingSphere boundingSphere;
 
@@ -106,10 +113,13 @@ namespace Corium3D {
 		class DataNode3D : public BVH::Node3D {
 		public:
 			friend BVH;
-			friend Corium3DUtils::ObjPool<DataNode3D>;
+			friend Corium3DUtils::ChunkedObjPool<DataNode3D>;
 			unsigned int getModelIdx() const { return modelIdx; }
 			unsigned int getInstanceIdx() const { return instanceIdx; }
 
+			// levels of detail selection's hysteresis records, per view - the level the instance was drawn in last (see DrawListBuilder)
+			unsigned char lastLodsIdxs[CULLING_VIEWS_NR_MAX] = {};
+
 		protected:
 			unsigned int modelIdx;
 			unsigned int instanceIdx;
@@ -123,7 +133,7 @@ namespace Corium3D {
 		class MobileGameLmntDataNode3D : public BVH::DataNode3D {
 		public:
 			friend BVH;
-			friend Corium3DUtils::ObjPool<MobileGameLmntDataNode3D>;
+			friend Corium3DUtils::ChunkedObjPool<MobileGameLmntDataNode3D>;
 
 			PhysicsEngine::MobilityInterface const& getMobilityInterface() { return mobilityInterface; }
 
@@ -146,7 +156,7 @@ namespace Corium3D {
 		class DataNode2D : public BVH::Node<AABB2DRotatable> {
 		public:
 			friend BVH;
-			friend Corium3DUtils::ObjPool<DataNode2D>;
+			friend Corium3DUtils::ChunkedObjPool<DataNode2D>;
 			unsigned int getModelIdx() const { return modelIdx; }
 			unsigned int getInstanceIdx() const { return instanceIdx; }
 
@@ -163,7 +173,7 @@ namespace Corium3D {
 		class MobileGameLmntDataNode2D : public BVH::DataNode2D {
 		public:
 			friend BVH;
-			friend Corium3DUtils::ObjPool<MobileGameLmntDataNode2D>;
+			friend Corium3DUtils::ChunkedObjPool<MobileGameLmntDataNode2D>;
 
 			PhysicsEngine::MobilityInterface const& getMobilityInterface() { return mobilityInterface; }
 
@@ -226,6 +236,8 @@ namespace Corium3D {
 		BVH(BVH const&) = delete;
 		~BVH();
 		void refitBPsDueToUpdate();
+		// modelsNr x modelsNr matrix - broad phase pairs of models marked 0 are culled before the narrow phase (NULL tests all pairs)
+		void setTestedModelsPairs(unsigned char const* testedModelsPairs, unsigned int modelsNr);
 
 		// 3D methods
 		DataNode3D* insert(AABB3DRotatable const& aabb, BoundingSphere const& boundingSphere, unsigned int modelIdx, unsigned int instanceIdx, CollisionVolume& collisionVolume);
@@ -255,6 +267,7 @@ namespace Corium3D {
 		Node2D* getMobileNodes2DRoot() const { return mobileNodes2DRoot; }
 		// Reminder: Right now CollisionData is only 3D (to simplify debugging)
 		CollisionsData<glm::vec2> const& getCollisionsData2D();
+		void reportMemory(Corium3DUtils::MemoryReport& memoryReport) const;
 
 	private:
 		template <class V>
@@ -262,6 +275,8 @@ namespace Corium3D {
 			unsigned int collisionsNr = 0;
 			std::array<CollisionPrimitive<V>*, 2>* collisionPrimitivesDuos;
 			CollisionData<V>* collisionsData;
+			unsigned char const* testedModelsPairs = NULL;
+			unsigned int modelsNr = 0;
 		};
 		template <class V>
 		struct CollisionsBuffers {
@@ -269,16 +284,21 @@ namespace Corium3D {
 			BroadPhaseCollisionsData<V> broadPhaseResBuffer;
 			typename Corium3DUtils::SearchTreeAVL<CollisionData<V>>* collisionsRecord;
 			typename Corium3DUtils::SearchTreeAVL<CollisionData<V>>::InOrderIt* collisionsRecordIt;
+			unsigned int bufferSz;
+			// high-water marks since construction
+			unsigned int broadPhaseCollisionsNrMax = 0;
+			unsigned int collisionsNrMax = 0;
+			unsigned int detachmentsNrMax = 0;
 		};
 
 		// 3D pools	
-		Corium3DUtils::ObjPool<Node3D>* branchNodes3DPool;
-		Corium3DUtils::ObjPool<DataNode3D>* staticNodes3DPool;
-		Corium3DUtils::ObjPool<MobileGameLmntDataNode3D>* mobileNodes3DPool;
+		Corium3DUtils::ChunkedObjPool<Node3D>* branchNodes3DPool;
+		Corium3DUtils::ChunkedObjPool<DataNode3D>* staticNodes3DPool;
+		Corium3DUtils::ChunkedObjPool<MobileGameLmntDataNode3D>* mobileNodes3DPool;
 		// 2D pools
-		Corium3DUtils::ObjPool<Node2D>* branchNodes2DPool;
-		Corium3DUtils::ObjPool<DataNode2D>* staticNodes2DPool;
-		Corium3DUtils::ObjPool<MobileGameLmntDataNode2D>* mobileNodes2DPool;
+		Corium3DUtils::ChunkedObjPool<Node2D>* branchNodes2DPool;
+		Corium3DUtils::ChunkedObjPool<DataNode2D>* staticNodes2DPool;
+		Corium3DUtils::ChunkedObjPool<MobileGameLmntDataNode2D>* mobileNodes2DPool;
 
 		// 3D trees roots
 		Node3D* staticNodes3DRoot = NULL;
@@ -308,11 +328,13 @@ namespace Corium3D {
 		template <class TAABB>
 		void doRefitBPsDueToUpdate(Node<TAABB>* nodesRoot);
 		template <class TAABB, class TNode>
-		void doInsert(TNode** nodesRoot, TNode* newNode, Corium3DUtils::ObjPool<TNode>* nodesPool, unsigned int& nodesCounter);
+		void doInsert(TNode** nodesRoot, TNode* newNode, Corium3DUtils::ChunkedObjPool<TNode>* nodesPool, unsigned int& nodesCounter);
 		template <class TAABB, class TNode>
-		void doRemove(TNode** nodesRoot, TNode* nodeToRemove, Corium3DUtils::ObjPool<TNode>* nodesPool, unsigned int& nodesCounter);
+		void doRemove(TNode** nodesRoot, TNode* nodeToRemove, Corium3DUtils::ChunkedObjPool<TNode>* nodesPool, unsigned int& nodesCounter);
 		template <class TAABB, class TDataNode, class V>
 		CollisionsData<V> const& doCollisionsSearch(Node<TAABB>* staticNodesRoot, Node<TAABB>* mobileNodesRoot, CollisionsBuffers<V>& searchBuffers);
+		template <class V>
+		static void reportCollisionsBuffersMemory(CollisionsBuffers<V> const& collisionsBuffers, const char* dimsStr, Corium3DUtils::MemoryReport& memoryReport);
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		// TODO: move these statics to the anonymous part of the translation unit (it is an implementation detail) //
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1,5 +1,3 @@
-#include "..\DxVisualizer\BoundingSphere.h"
-#include "..\DxVisualizer\BoundingSphere.h"
 #include "BoundingSphere.h"
 
 #include <glm/gtx/norm.hpp>
@@ -208,8 +206,13 @@ namespace Corium3D {
 
 	BoundingSphere BoundingSphere::calcCombinedBoundingSphere(BoundingSphere const& sphere1, BoundingSphere const& sphere2) {
 		glm::vec3 centersVec = sphere1.c - sphere2.c;
-		float centersVecLen = glm::fastLength(centersVec);
-		if (centersVecLen > EPSILON)
+		// exact - the BVH's culling relies on a parent's sphere enclosing its children's
+		float centersVecLen = glm::length(centersVec);
+		if (centersVecLen + sphere2.r <= sphere1.r)
+			return sphere1;
+		else if (centersVecLen + sphere1.r <= sphere2.r)
+			return sphere2;
+		else if (centersVecLen > EPSILON)
 			return BoundingSphere((sphere1.c + sphere2.c + (centersVec / centersVecLen) * (sphere1.r - sphere2.r)) / 2.0f, (centersVecLen + sphere1.r + sphere2.r) / 2.0f);
 		else
 			return BoundingSphere(sphere1.c, std::fmax(sphere1.r, sphere2.r));
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "IdxPool.h"
+#include <type_traits>
+#include <utility>
+#include <new>
+
+namespace Corium3DUtils {
+
+	// Growable counterparts of ObjPool and ObjPoolIteratable - storage is added in chunks of chunkSz objects,
+	// so live objects are never relocated and acquire/release stay O(1) (amortized over chunks allocations).
+	template <class T>
+	class ChunkedObjPool {
+	public:
+		ChunkedObjPool(unsigned int initialSz, unsigned int chunkSz = ChunkedIdxPool::CHUNK_SZ_DEFAULT);
+		ChunkedObjPool(ChunkedObjPool const& objPool) = delete;
+		~ChunkedObjPool();
+		template <class ...Args> T* acquire(Args&&... args);
+		void release(T* obj);
+		unsigned int getAcquiredObjsNr() const { return idxPool.getAcquiredIdxsNr(); }
+		unsigned int getAcquiredObjsNrMax() const { return idxPool.getAcquiredIdxsNrMax(); }
+		void resetAcquiredObjsNrMax() { idxPool.resetAcquiredIdxsNrMax(); }
+		unsigned int getCapacity() const { return idxPool.getCapacity(); }
+		unsigned int getChunksNr() const { return (unsigned int)slotsChunks.size(); }
+		size_t getReservedBytesNr() const { return slotsChunks.size() * idxPool.getChunkSz() * sizeof(Slot); }
+
+	private:
+		// REMINDER: the object's storage has to stay the first member - T* and Slot* are cast to each other
+		struct Slot {
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type objMem;
+			unsigned int idx;
+		};
+
+		ChunkedIdxPool idxPool;
+		std::vector<Slot*> slotsChunks;
+
+		Slot* accessSlot(unsigned int idx);
+	};
+
+	template <class T>
+	ChunkedObjPool<T>::ChunkedObjPool(unsigned int initialSz, unsigned int chunkSz) : idxPool(initialSz, chunkSz) {
+		while (slotsChunks.size() < idxPool.getChunksNr())
+			slotsChunks.push_back(new Slot[idxPool.getChunkSz()]);
+	}
+
+	// REMINDER: objects that are still acquired are not destructed
+	template <class T>
+	ChunkedObjPool<T>::~ChunkedObjPool() {
+		for (Slot* slotsChunk : slotsChunks)
+			delete[] slotsChunk;
+	}
+
+	template <class T>
+	template <class ...Args>
+	T* ChunkedObjPool<T>::acquire(Args&&... args) {
+		unsigned int idx = idxPool.acquire();
+		Slot* slot = accessSlot(idx);
+		slot->idx = idx;
+		try {
+			return new(&slot->objMem) T(std::forward<Args>(args)...);
+		}
+		catch (...) {
+			idxPool.release(idx);
+			throw;
+		}
+	}
+
+	template <class T>
+	void ChunkedObjPool<T>::release(T* obj) {
+		Slot* slot = reinterpret_cast<Slot*>(obj);
+		try {
+			idxPool.release(slot->idx);
+		}
+		catch (std::invalid_argument&) {
+			throw std::invalid_argument("Object was not previously acquired.");
+		}
+		obj->~T();
+	}
+
+	template <class T>
+	typename ChunkedObjPool<T>::Slot* ChunkedObjPool<T>::accessSlot(unsigned int idx) {
+		unsigned int chunkSz = idxPool.getChunkSz();
+		while (slotsChunks.size() <= idx / chunkSz)
+			slotsChunks.push_back(new Slot[chunkSz]);
+
+		return slotsChunks[idx / chunkSz] + idx % chunkSz;
+	}
+
+	template <class T>
+	class ChunkedObjPoolIteratable {
+	public:
+		// REMINDER: Iteration order is unspecified
+		class ObjPoolIt {
+		public:
+			ObjPoolIt(ChunkedObjPoolIteratable& _objPool);
+			void reset();
+			T& next();
+			void removeCurr();
+			bool hasNext() const;
+
+		private:
+			ChunkedObjPoolIteratable<T>& objPool;
+			typename ChunkedObjPoolIteratable::Slot* curr;
+			typename ChunkedObjPoolIteratable::Slot* prev;
+		};
+
+		ChunkedObjPoolIteratable(unsigned int initialSz, unsigned int chunkSz = ChunkedIdxPool::CHUNK_SZ_DEFAULT);
+		ChunkedObjPoolIteratable(ChunkedObjPoolIteratable const& objPool) = delete;
+		~ChunkedObjPoolIteratable();
+		template <class ...Args> T* acquire(Args&&... args);
+		void release(T* obj);
+		// the index is stable for the object's lifetime and below getCapacity()
+		unsigned int getObjIdxInPool(T const* obj) const;
+		unsigned int getAcquiredObjsNr() const { return idxPool.getAcquiredIdxsNr(); }
+		unsigned int getAcquiredObjsNrMax() const { return idxPool.getAcquiredIdxsNrMax(); }
+		void resetAcquiredObjsNrMax() { idxPool.resetAcquiredIdxsNrMax(); }
+		unsigned int getCapacity() const { return idxPool.getCapacity(); }
+		unsigned int getChunksNr() const { return (unsigned int)slotsChunks.size(); }
+		size_t getReservedBytesNr() const { return slotsChunks.size() * idxPool.getChunkSz() * sizeof(Slot); }
+
+	private:
+		// REMINDER: the object's storage has to stay the first member - T* and Slot* are cast to each other
+		struct Slot {
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type objMem;
+			unsigned int idx;
+			Slot* prev;
+			Slot* next;
+
+			T& accessObj() { return *reinterpret_cast<T*>(&objMem); }
+		};
+
+		ChunkedIdxPool idxPool;
+		std::vector<Slot*> slotsChunks;
+		Slot* listHead = NULL;
+		Slot* listTail = NULL;
+
+		Slot* accessSlot(unsigned int idx);
+	};
+
+	template <class T>
+	ChunkedObjPoolIteratable<T>::ChunkedObjPoolIteratable(unsigned int initialSz, unsigned int chunkSz) : idxPool(initialSz, chunkSz) {
+		while (slotsChunks.size() < idxPool.getChunksNr())
+			slotsChunks.push_back(new Slot[idxPool.getChunkSz()]);
+	}
+
+	template <class T>
+	ChunkedObjPoolIteratable<T>::~ChunkedObjPoolIteratable() {
+		for (Slot* slotsChunk : slotsChunks)
+			delete[] slotsChunk;
+	}
+
+	template <class T>
+	template <class ...Args>
+	T* ChunkedObjPoolIteratable<T>::acquire(Args&&... args) {
+		unsigned int idx = idxPool.acquire();
+		Slot* slot = accessSlot(idx);
+		try {
+			new(&slot->objMem) T(std::forward<Args>(args)...);
+		}
+		catch (...) {
+			idxPool.release(idx);
+			throw;
+		}
+
+		slot->idx = idx;
+		slot->prev = listTail;
+		slot->next = NULL;
+		if (listTail != NULL)
+			listTail->next = slot;
+		else
+			listHead = slot;
+		listTail = slot;
+
+		return &slot->accessObj();
+	}
+
+	template <class T>
+	void ChunkedObjPoolIteratable<T>::release(T* obj) {
+		Slot* releasedSlot = reinterpret_cast<Slot*>(obj);
+		try {
+			idxPool.release(releasedSlot->idx);
+		}
+		catch (std::invalid_argument&) {
+			throw std::invalid_argument("Object was not previously acquired.");
+		}
+
+		if (releasedSlot->prev)
+			releasedSlot->prev->next = releasedSlot->next;
+		else
+			listHead = releasedSlot->next;
+
+		if (releasedSlot->next)
+			releasedSlot->next->prev = releasedSlot->prev;
+		else
+			listTail = releasedSlot->prev;
+
+		releasedSlot->prev = NULL;
+		releasedSlot->next = NULL;
+
+		obj->~T();
+	}
+
+	template <class T>
+	unsigned int ChunkedObjPoolIteratable<T>::getObjIdxInPool(T const* obj) const {
+		unsigned int idx = reinterpret_cast<Slot const*>(obj)->idx;
+#if DEBUG
+		if (!idxPool.isAcquired(idx))
+			throw std::invalid_argument("Object was not previously acquired.");
+#endif
+		return idx;
+	}
+
+	template <class T>
+	typename ChunkedObjPoolIteratable<T>::Slot* ChunkedObjPoolIteratable<T>::accessSlot(unsigned int idx) {
+		unsigned int chunkSz = idxPool.getChunkSz();
+		while (slotsChunks.size() <= idx / chunkSz)
+			slotsChunks.push_back(new Slot[chunkSz]);
+
+		return slotsChunks[idx / chunkSz] + idx % chunkSz;
+	}
+
+	template <class T>
+	ChunkedObjPoolIteratable<T>::ObjPoolIt::ObjPoolIt(ChunkedObjPoolIteratable<T>& _objPool) : objPool(_objPool), curr(objPool.listHead), prev(NULL) {}
+
+	template <class T>
+	void ChunkedObjPoolIteratable<T>::ObjPoolIt::reset() {
+		curr = objPool.listHead;
+		prev = NULL;
+	}
+
+	template <class T>
+	T& ChunkedObjPoolIteratable<T>::ObjPoolIt::next() {
+#if DEBUG
+		if (!hasNext())
+			throw std::out_of_range("Iterator was nexted while done.");
+#endif
+
+		T& currObj = curr->accessObj();
+		prev = curr;
+		curr = curr->next;
+
+		return currObj;
+	}
+
+	template <class T>
+	void ChunkedObjPoolIteratable<T>::ObjPoolIt::removeCurr() {
+#if DEBUG
+		if (prev == NULL)
+			throw std::out_of_range("Iterator was asked to remove current elemnt before beginning.");
+#endif
+		Slot* removedSlot = prev;
+		prev = removedSlot->prev;
+		objPool.release(&removedSlot->accessObj());
+	}
+
+	template <class T>
+	bool ChunkedObjPoolIteratable<T>::ObjPoolIt::hasNext() const {
+		return curr != NULL;
+	}
+
+} // namespace Corium3DUtils
@@ -269,12 +269,12 @@ namespace Corium3D {
 	*/
 
 	CollisionPrimitivesFactory::CollisionPrimitivesFactory(unsigned int* primitive3DInstancesNrsMaxima, unsigned int* primitive2DInstancesNrsMaxima) :
-		collisionBoxesPool(new ObjPool<CollisionBox>(primitive3DInstancesNrsMaxima[CollisionPrimitive3DType::BOX])),
-		collisionSpheresPool(new ObjPool<CollisionSphere>(primitive3DInstancesNrsMaxima[CollisionPrimitive3DType::SPHERE])),
-		collisionCapsulesPool(new ObjPool<CollisionCapsule>(primitive3DInstancesNrsMaxima[CollisionPrimitive3DType::CAPSULE])),
-		collisionRectsPool(new ObjPool<CollisionRect>(primitive2DInstancesNrsMaxima[CollisionPrimitive2DType::RECT])),
-		collisionCirclesPool(new ObjPool<CollisionCircle>(primitive2DInstancesNrsMaxima[CollisionPrimitive2DType::CIRCLE])),
-		collisionStadiumsPool(new ObjPool<CollisionStadium>(primitive2DInstancesNrsMaxima[CollisionPrimitive2DType::STADIUM])) {}
+		collisionBoxesPool(new ChunkedObjPool<CollisionBox>(primitive3DInstancesNrsMaxima[CollisionPrimitive3DType::BOX])),
+		collisionSpheresPool(new ChunkedObjPool<CollisionSphere>(primitive3DInstancesNrsMaxima[CollisionPrimitive3DType::SPHERE])),
+		collisionCapsulesPool(new ChunkedObjPool<CollisionCapsule>(primitive3DInstancesNrsMaxima[CollisionPrimitive3DType::CAPSULE])),
+		collisionRectsPool(new ChunkedObjPool<CollisionRect>(primitive2DInstancesNrsMaxima[CollisionPrimitive2DType::RECT])),
+		collisionCirclesPool(new ChunkedObjPool<CollisionCircle>(primitive2DInstancesNrsMaxima[CollisionPrimitive2DType::CIRCLE])),
+		collisionStadiumsPool(new ChunkedObjPool<CollisionStadium>(primitive2DInstancesNrsMaxima[CollisionPrimitive2DType::STADIUM])) {}
 
 	CollisionPrimitivesFactory::~CollisionPrimitivesFactory() {
 		delete collisionBoxesPool;
@@ -343,6 +343,15 @@ namespace Corium3D {
 		collisionStadiumsPool->release(collisionStadium);
 	}
 
+	void CollisionPrimitivesFactory::reportMemory(MemoryReport& memoryReport) const {
+		memoryReport.addPool("CollisionPrimitives", "collisionBoxes", *collisionBoxesPool);
+		memoryReport.addPool("CollisionPrimitives", "collisionSpheres", *collisionSpheresPool);
+		memoryReport.addPool("CollisionPrimitives", "collisionCapsules", *collisionCapsulesPool);
+		memoryReport.addPool("CollisionPrimitives", "collisionRects", *collisionRectsPool);
+		memoryReport.addPool("CollisionPrimitives", "collisionCircles", *collisionCirclesPool);
+		memoryReport.addPool("CollisionPrimitives", "collisionStadiums", *collisionStadiumsPool);
+	}
+
 	vec3 CollisionVolume::GjkJohnsonsDistanceIterator3D::iterate(vec3 const& aAdded, vec3 const& bAdded) {
 		vec3 wAdded = aAdded - bAdded;
 		vec3 d[4];
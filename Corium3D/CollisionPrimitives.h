@@ -2,6 +2,8 @@
 
 #include "TransformsStructs.h"
 #include "ObjPool.h"
+#include "ChunkedObjPool.h"
+#include "MemoryReport.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtx/norm.hpp>
@@ -133,14 +135,15 @@ namespace Corium3D {
 		void destroyCollisionRect(CollisionRect* collisionRect);
 		void destroyCollisionCircle(CollisionCircle* collisionCircle);
 		void destroyCollisionStadium(CollisionStadium* collisionStadium);
+		void reportMemory(Corium3DUtils::MemoryReport& memoryReport) const;
 
 	private:
-		Corium3DUtils::ObjPool<CollisionBox>* collisionBoxesPool;
-		Corium3DUtils::ObjPool<CollisionSphere>* collisionSpheresPool;
-		Corium3DUtils::ObjPool<CollisionCapsule>* collisionCapsulesPool;
-		Corium3DUtils::ObjPool<CollisionRect>* collisionRectsPool;
-		Corium3DUtils::ObjPool<CollisionCircle>* collisionCirclesPool;
-		Corium3DUtils::ObjPool<CollisionStadium>* collisionStadiumsPool;
+		Corium3DUtils::ChunkedObjPool<CollisionBox>* collisionBoxesPool;
+		Corium3DUtils::ChunkedObjPool<CollisionSphere>* collisionSpheresPool;
+		Corium3DUtils::ChunkedObjPool<CollisionCapsule>* collisionCapsulesPool;
+		Corium3DUtils::ChunkedObjPool<CollisionRect>* collisionRectsPool;
+		Corium3DUtils::ChunkedObjPool<CollisionCircle>* collisionCirclesPool;
+		Corium3DUtils::ChunkedObjPool<CollisionStadium>* collisionStadiumsPool;
 	};
 
 	class CollisionVolume : public CollisionPrimitive<glm::vec3> {
@@ -213,7 +216,7 @@ namespace Corium3D {
 	class CollisionBox : public CollisionVolume {
 	public:
 		friend class CollisionPrimitivesFactory;
-		friend class Corium3DUtils::ObjPool<CollisionBox>;
+		friend class Corium3DUtils::ChunkedObjPool<CollisionBox>;
 
 		void translate(glm::vec3 const& translation) override { c += translation; }		
 		void scale(float scaleFactor) override  
@@ -305,7 +308,7 @@ namespace Corium3D {
 	class CollisionSphere : public CollisionVolume {
 	public:
 		friend class CollisionPrimitivesFactory;
-		friend class Corium3DUtils::ObjPool<CollisionSphere>;
+		friend class Corium3DUtils::ChunkedObjPool<CollisionSphere>;
 
 		void translate(glm::vec3 const& translation) override { c += translation; }		
 		void scale(float scaleFactor) override 
@@ -364,7 +367,7 @@ namespace Corium3D {
 	class CollisionCapsule : public CollisionVolume {
 	public:
 		friend class CollisionPrimitivesFactory;
-		friend class Corium3DUtils::ObjPool<CollisionCapsule>;
+		friend class Corium3DUtils::ChunkedObjPool<CollisionCapsule>;
 
 		void translate(glm::vec3 const& translation) override { c1 += translation; }		
 		void scale(float scaleFactor) override 
@@ -559,7 +562,7 @@ namespace Corium3D {
 	class CollisionRect : public CollisionPerimeter {
 	public:
 		friend class CollisionPrimitivesFactory;
-		friend class Corium3DUtils::ObjPool<CollisionRect>;
+		friend class Corium3DUtils::ChunkedObjPool<CollisionRect>;
 
 		void translate(glm::vec2 const& translation) override { c += translation; }		
 		void scale(float scaleFactor) override 
@@ -637,7 +640,7 @@ namespace Corium3D {
 	class CollisionCircle : public CollisionPerimeter {
 	public:
 		friend class CollisionPrimitivesFactory;
-		friend class Corium3DUtils::ObjPool<CollisionCircle>;
+		friend class Corium3DUtils::ChunkedObjPool<CollisionCircle>;
 
 		void translate(glm::vec2 const& translation) override { c += translation; }		
 		void scale(float scaleFactor) override
@@ -698,7 +701,7 @@ namespace Corium3D {
 	class CollisionStadium : public CollisionPerimeter {
 	public:
 		friend class CollisionPrimitivesFactory;
-		friend class Corium3DUtils::ObjPool<CollisionStadium>;
+		friend class Corium3DUtils::ChunkedObjPool<CollisionStadium>;
 
 		void translate(glm::vec2 const& translation) override { c1 += translation; }		
 		void scale(float scaleFactor) override
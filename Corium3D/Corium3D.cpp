@@ -10,13 +10,19 @@
 #include "Logger.h"
 #include "OpenGlTxtGen.h"
 #include "IdxPool.h"
+#include "ChunkedObjPool.h"
+#include "ProximityHandlersRegistry.h"
+#include "GameLmntsStorage.h"
+#include "MemoryReport.h"
+#include "RingBufferSPSC.h"
+#include "Profiler.h"
 #include "AssetsOps.h"
+#include "MappedAssets.h"
 #include <thread>
 #include <mutex>
 #include <condition_variable>
-#include <assimp/scene.h>
-#include <assimp/Importer.hpp>
-#include <assimp/postprocess.h>
+#include <atomic>
+#include <exception>
 #include <vector>
 #include <fstream>
 
@@ -81,7 +87,8 @@ namespace Corium3D {
 		"}";
 
 	const float SECS_PER_UPDATE = 0.016666667f;
-	const unsigned int INPUTS_BUFFER_SZ = 10;
+	const long long NS_PER_UPDATE = 16666667LL;
+	const unsigned int INPUTS_BUFFER_SZ = 256;
 
 	const char* bonelessVertexShader =
 		"#version 430 core \n"
@@ -124,7 +131,19 @@ namespace Corium3D {
 		void signalSurfaceDestroyed();
 		void signalWindowFocusChanged(bool hasFocus);
 		void signalDetachedFromWindow();	
+		void setLoopPacing(bool isLoopPaced);
+		void setDebugGeometryRendering(bool isOn);
 		std::vector<std::vector<Transform3D>> loadScene(Corium3DEngine& owningEngine, unsigned int sceneIdx);
+		void preloadScene(unsigned int sceneIdx);
+		float getScenePreloadProgress() const;
+		bool isScenePreloaded() const;
+		void cancelScenePreload();
+		std::vector<std::vector<Transform3D>> commitPreloadedScene();
+		void setModelsPairProximityHandlers(unsigned int modelIdx, unsigned int otherModelIdx, GameLmnt::ProximityHandlingMethods const& proximityHandlingMethods);
+		void setModelCollisionLayers(unsigned int modelIdx, unsigned int layers, unsigned int layersMask);
+		void setModelOccluder(unsigned int modelIdx, bool isOccluder);
+		// collected on the loop thread, between its ticks
+		void reportMemory(MemoryReport& memoryReport);
 		void registerKeyboardInputStartCallback(KeyboardInputID inputId, KeyboardInputCallback inputCallback);
 		void registerKeyboardInputEndCallback(KeyboardInputID inputId, KeyboardInputCallback inputCallback);
 		void registerCursorInputCallback(CursorInputID inputId, CursorInputCallback inputCallback);
@@ -135,10 +154,39 @@ namespace Corium3D {
 		Corium3DEngine::CameraAPI& accessCameraAPI();		
 
 	private:    		
+		// a scene's state short of its rendering - built off the loop thread by prepareScene and swapped in by commitPreloadedScene.
+		// frees whatever it still holds (a cancelled preload's partial state or a scene swapped out)
+		struct PreparedScene {
+			MappedAssets* sceneAssets = NULL;
+			std::vector<ModelDescView> modelDescs;
+			std::vector<unsigned int> modelSceneModelIdxsMap;
+			std::vector<std::vector<Transform3D>> instancesTransformsInit;
+			unsigned int sceneModelsNr = 0;
+			unsigned int staticModelsNr = 0;
+			unsigned int* modelsInstancesNrsMaxima = NULL;
+			ChunkedIdxPool** modelsInstancesIdxPools = NULL;
+			GameLmnt*** gameLmnts = NULL;
+			GameLmnt::OnRayHit** onRayHitCallbacks = NULL;
+			BoundingSphere* modelsPrimalBoundingSpheres = NULL;
+			AABB3DRotatable* modelsPrimalAABB3Ds = NULL;
+			CollisionVolume** modelsPrimalCollisionVolumesPtrs = NULL;
+			AABB2DRotatable* modelsPrimalAABB2Ds = NULL;
+			CollisionPerimeter** modelsPrimalCollisionPerimetersPtrs = NULL;
+			CollisionPrimitivesFactory* collisionPrimitivesFactory = NULL;
+			BVH* bvh = NULL;
+			ProximityHandlersRegistry* proximityHandlersRegistry = NULL;
+			PhysicsEngine* physicsEngine = NULL;
+			ChunkedObjPoolIteratable<GameLmnt::StateUpdater>* stateUpdatersPool = NULL;
+			ChunkedObjPoolIteratable<GameLmnt::StateUpdater>::ObjPoolIt* stateUpdatersIt = NULL;
+			GameLmntsStorage* gameLmntsStorage = NULL;
+
+			~PreparedScene();
+		};
+
 		Corium3DEngineOnlineCallback& corium3DEngineOnlineCallback;
-		BVH* bvh;	
-		CollisionPrimitivesFactory* collisionPrimitivesFactory;
-		PhysicsEngine* physicsEngine;
+		BVH* bvh = NULL;	
+		CollisionPrimitivesFactory* collisionPrimitivesFactory = NULL;
+		PhysicsEngine* physicsEngine = NULL;
 		GUI** guis;
 		GuiAPI** guiAPIs;
 		GuiAPI::GuiApiImpl** guiApiImpls;
@@ -153,6 +201,23 @@ namespace Corium3D {
 		std::mutex loopMutex;
 		std::mutex eglMutex;
 		std::condition_variable waitCond;
+		// a caller's request to run on the loop thread - see runOnLoopThread
+		struct LoopTask {
+			std::function<void()> run;
+			std::exception_ptr exception;
+		};
+		// guarded by loopMutex
+		LoopTask* loopTask = NULL;
+		bool isLoopRunning = true;
+		std::condition_variable loopTaskDoneCond;
+
+		std::thread scenePreloadThread;
+		PreparedScene* preparedScene = NULL;
+		std::atomic<bool> isScenePreloadCancelled{ false };
+		std::atomic<bool> isScenePreloadDone{ false };
+		std::atomic<unsigned int> scenePreloadStepsDone{ 0 };
+		std::atomic<unsigned int> scenePreloadStepsNr{ 1 };
+		std::exception_ptr scenePreloadException;
 	
 		bool isGameOn = true;
 		bool isPaused = false;
@@ -162,63 +227,73 @@ namespace Corium3D {
 		bool needInit = true;
 		bool isSurfaceSzChangedSig = false;
 		bool isSceneLoaded = false;
+		std::atomic<bool> isLoopPaced{ false };
 
 		std::string modelsScenesFullPath;
+		MappedAssets* sceneAssets = NULL; // the loaded scene's model descriptions point into it
 		std::vector<unsigned int> modelSceneModelIdxsMap;
 		std::string guisDescsPath;		
 
-		unsigned int sceneModelsNr;
-		unsigned int staticModelsNr;		
-		unsigned int* modelsInstancesNrsMaxima;
-		IdxPool** modelsInstancesIdxPools;		
-		GameLmnt*** gameLmnts;
-		GameLmnt::ProximityHandlingMethods*** proximityHandlingMethods;		
-		GameLmnt::OnRayHit** onRayHitCallbacks;
-		ObjPoolIteratable<GameLmnt::StateUpdater>* stateUpdatersPool;
-		ObjPoolIteratable<GameLmnt::StateUpdater>::ObjPoolIt* stateUpdatersIt;
-
-		BoundingSphere* modelsPrimalBoundingSpheres;
-		AABB3DRotatable* modelsPrimalAABB3Ds;	
-		CollisionVolume** modelsPrimalCollisionVolumesPtrs;		
-
-		AABB2DRotatable* modelsPrimalAABB2Ds;
-		CollisionPerimeter** modelsPrimalCollisionPerimetersPtrs;
+		unsigned int sceneModelsNr = 0;
+		unsigned int staticModelsNr = 0;		
+		// the per model instances' arrays are grown (along with the renderer's) past the scene's maxima when an instances' pool does
+		unsigned int* modelsInstancesNrsMaxima = NULL;
+		ChunkedIdxPool** modelsInstancesIdxPools = NULL;		
+		GameLmnt*** gameLmnts = NULL;
+		ProximityHandlersRegistry* proximityHandlersRegistry = NULL;
+		GameLmnt::OnRayHit** onRayHitCallbacks = NULL;
+		ChunkedObjPoolIteratable<GameLmnt::StateUpdater>* stateUpdatersPool = NULL;
+		ChunkedObjPoolIteratable<GameLmnt::StateUpdater>::ObjPoolIt* stateUpdatersIt = NULL;
+		GameLmntsStorage* gameLmntsStorage = NULL;
+
+		BoundingSphere* modelsPrimalBoundingSpheres = NULL;
+		AABB3DRotatable* modelsPrimalAABB3Ds = NULL;	
+		CollisionVolume** modelsPrimalCollisionVolumesPtrs = NULL;		
+
+		AABB2DRotatable* modelsPrimalAABB2Ds = NULL;
+		CollisionPerimeter** modelsPrimalCollisionPerimetersPtrs = NULL;
 
 		KeyboardInputCallback* keyboardInputStartCallbacks;
 		KeyboardInputCallback* keyboardInputEndCallbacks;
 		CursorInputCallback* cursorInputCallbacks;
 	
 		struct InputEvent {
-			KeyboardInputCallback keyboardInputCallback;
-			CursorInputCallback cursorInputCallback;
+			enum InputType { KEYBOARD_START, KEYBOARD_END, CURSOR };
+
+			InputType inputType;
+			unsigned int inputId;
 			double inputTimeStamp;
 			vec2 cursorPos;
 		};
-		InputEvent inputEventsBuffer[INPUTS_BUFFER_SZ];
-		unsigned int currUpdateInputsNr = 0;	
+		// written by the platform thread, drained once per tick by the loop thread
+		RingBufferSPSC<InputEvent> inputEventsQueue;
 
 		bool loop();	
 		bool canLoopContinue();
+		// runs task on the loop thread between its ticks, where the loop's state is not in use, and waits for it - rethrowing
+		// what it threw. on the loop thread itself, and once the loop is over, task is run right away
+		void runOnLoopThread(std::function<void()> const& task);
+		// the loop thread's side of runOnLoopThread. REMINDER: loopMutexLock is to be locked, and is locked on return
+		void runLoopTask(std::unique_lock<std::mutex>& loopMutexLock);
+		// lets the callers waiting on runOnLoopThread run their tasks themselves
+		void endLoop();
+		void collectMemoryReport(MemoryReport& memoryReport) const;
 		void unloadScene();
+		// the scene loading's CPU phase - file I/O, colliders, BVH, physics and pools. runs on scenePreloadThread
+		void prepareScene(unsigned int sceneIdx, PreparedScene& scene);
+		void swapScene(PreparedScene& scene);
+		// for instanceIdx to fit into the model's instances' arrays
+		void growModelInstances(unsigned int modelIdx, unsigned int instanceIdx);
 		void processInput();
 		void update();
+		void syncMobileGameLmnts();
 		void resolveCollisions3D();
 		void resolveCollisions2D();
 		template <class V>
 		void doResolveCollisions(BVH::CollisionsData<V> const& collisionsData);
 		//bool loopThreadStarter();
-		inline void updateInputsCallbackBuffer(KeyboardInputCallback inputCallback) {
-			inputEventsBuffer[currUpdateInputsNr].keyboardInputCallback = inputCallback;				
-			inputEventsBuffer[currUpdateInputsNr].cursorInputCallback = NULL;
-			inputEventsBuffer[currUpdateInputsNr].inputTimeStamp = ServiceLocator::getTimer().getCurrentTime();
-			currUpdateInputsNr = (currUpdateInputsNr + 1) % INPUTS_BUFFER_SZ;
-		}
-		inline void updateInputsCallbackBuffer(CursorInputCallback inputCallback, vec2 const& cursorPos) {
-			inputEventsBuffer[currUpdateInputsNr].keyboardInputCallback = NULL;
-			inputEventsBuffer[currUpdateInputsNr].cursorInputCallback = inputCallback;
-			inputEventsBuffer[currUpdateInputsNr].inputTimeStamp = ServiceLocator::getTimer().getCurrentTime();
-			inputEventsBuffer[currUpdateInputsNr].cursorPos = cursorPos;
-			currUpdateInputsNr = (currUpdateInputsNr + 1) % INPUTS_BUFFER_SZ;
+		inline void pushInputEvent(InputEvent::InputType inputType, unsigned int inputId, vec2 const& cursorPos) {
+			inputEventsQueue.push({ inputType, inputId, ServiceLocator::getTimer().getCurrentTime(), cursorPos });
 		}
 	};
 
@@ -236,18 +311,18 @@ namespace Corium3D {
 		~GameLmntImpl();
 		void changeVerticesColors(unsigned int meshIdx, unsigned int colorsArrIdx);
 		void changeAnimation(unsigned int animationIdx);
-		void translate(glm::vec3 const& translate) { mobilityInterface->translate(translate); }
-		void scale(float scaleFactor) { mobilityInterface->scale(scaleFactor); }
-		void rot(float rot, glm::vec3 const& rotAx) { mobilityInterface->rot(rot, rotAx); }
-		void rot(glm::quat const& rot) { mobilityInterface->rot(rot); }
-		void setLinVel(glm::vec3 const& linVel) { mobilityInterface->setLinVel(linVel); }
-		glm::vec3 getLinVel() const { return mobilityInterface->getLinVel(); }
-		void setAngVel(float angVelMag, glm::vec3 const& angVelAx) { mobilityInterface->setAngVel(angVelMag, angVelAx); }
-		void setLinAccel(glm::vec3 const& linAccel) { mobilityInterface->setLinAccel(linAccel); }
-		void setAngAccel(glm::vec3 const& angAccel) { mobilityInterface->setAngAccel(angAccel); }
-		void setLinVelX(float x) { mobilityInterface->setLinVelX(x); }
-		void setLinVelY(float y) { mobilityInterface->setLinVelY(y); }
-		void setLinVelZ(float z) { mobilityInterface->setLinVelZ(z); }
+		void translate(glm::vec3 const& translate) { accessMobilityInterface()->translate(translate); }
+		void scale(float scaleFactor) { accessMobilityInterface()->scale(scaleFactor); }
+		void rot(float rot, glm::vec3 const& rotAx) { accessMobilityInterface()->rot(rot, rotAx); }
+		void rot(glm::quat const& rot) { accessMobilityInterface()->rot(rot); }
+		void setLinVel(glm::vec3 const& linVel) { accessMobilityInterface()->setLinVel(linVel); }
+		glm::vec3 getLinVel() const { return accessMobilityInterface()->getLinVel(); }
+		void setAngVel(float angVelMag, glm::vec3 const& angVelAx) { accessMobilityInterface()->setAngVel(angVelMag, angVelAx); }
+		void setLinAccel(glm::vec3 const& linAccel) { accessMobilityInterface()->setLinAccel(linAccel); }
+		void setAngAccel(glm::vec3 const& angAccel) { accessMobilityInterface()->setAngAccel(angAccel); }
+		void setLinVelX(float x) { accessMobilityInterface()->setLinVelX(x); }
+		void setLinVelY(float y) { accessMobilityInterface()->setLinVelY(y); }
+		void setLinVelZ(float z) { accessMobilityInterface()->setLinVelZ(z); }
 		// void assignStateUpdater(StateUpdater stateUpdater);
 		// void assignOnMovementMadeCallback(OnMovementMadeCallback onMovementMadeCallback);
 		// void assignProximityHandlingMethods(ProximityHandlingMethods* proximityHandlingMethods);
@@ -261,23 +336,16 @@ namespace Corium3D {
 		unsigned int instanceIdx;
 		StateUpdater* stateUpdater;
 		unsigned int componentsFlag;
-		union {
-			BVH::DataNode3D* staticGameLmntBvhDataNode3D;
-			BVH::MobileGameLmntDataNode3D* mobileGameLmntBvhDataNode3D;
-		};
-		union {
-			BVH::DataNode2D* staticGameLmntBvhDataNode2D;
-			BVH::MobileGameLmntDataNode2D* mobileGameLmntBvhDataNode2D;
-		};
-		CollisionVolume* collisionVolume = NULL;
-		CollisionPerimeter* collisionPerimeter = NULL;
-		PhysicsEngine::MobilityInterface* mobilityInterface = NULL;
+		// the mobility interface, collision primitives and BVH nodes live in the engine's game elements storage
+		GameLmntsStorage::Handle storageHandle;
 		GraphicsAPI* graphicsAPI = NULL;
 		Renderer::InstanceAnimationInterface* instanceAnimationInterface = NULL;
 		MobilityAPI* mobilityAPI = NULL;
 
-		void updateBvhNodeBVs(Transform3DUS const& transformDelta);
-		void updateBvhNodeBPs(Transform2DUS const& transformDelta);		
+		PhysicsEngine::MobilityInterface* accessMobilityInterface() const {
+			GameLmntsStorage& storage = *corium3DEngineImpl.gameLmntsStorage;
+			return storage.accessArchetype(componentsFlag).mobilityInterfaces[storage.getRowIdx(storageHandle)];
+		}
 	};
 	
 	class Corium3DEngine::GuiAPI::GuiApiImpl {
@@ -381,11 +449,70 @@ namespace Corium3D {
 		corium3DEngineImpl->signalDetachedFromWindow();
 	}
 
+	void Corium3DEngine::setLoopPacing(bool isLoopPaced) {
+		corium3DEngineImpl->setLoopPacing(isLoopPaced);
+	}
+
+	void Corium3DEngine::setDebugGeometryRendering(bool isOn) {
+		corium3DEngineImpl->setDebugGeometryRendering(isOn);
+	}
+
 	std::vector<std::vector<Transform3D>> Corium3DEngine::loadScene(unsigned int sceneIdx)
 	{			
 		return corium3DEngineImpl->loadScene(*this, sceneIdx);		
 	}
 
+	void Corium3DEngine::preloadScene(unsigned int sceneIdx) {
+		corium3DEngineImpl->preloadScene(sceneIdx);
+	}
+
+	float Corium3DEngine::getScenePreloadProgress() const {
+		return corium3DEngineImpl->getScenePreloadProgress();
+	}
+
+	bool Corium3DEngine::isScenePreloaded() const {
+		return corium3DEngineImpl->isScenePreloaded();
+	}
+
+	void Corium3DEngine::cancelScenePreload() {
+		corium3DEngineImpl->cancelScenePreload();
+	}
+
+	std::vector<std::vector<Transform3D>> Corium3DEngine::commitPreloadedScene() {
+		return corium3DEngineImpl->commitPreloadedScene();
+	}
+
+	void Corium3DEngine::setModelsPairProximityHandlers(unsigned int modelIdx, unsigned int otherModelIdx, std::function<void(GameLmnt*, GameLmnt*)> collisionCallback, std::function<void(GameLmnt*, GameLmnt*)> detachmentCallback) {
+		corium3DEngineImpl->setModelsPairProximityHandlers(modelIdx, otherModelIdx, { collisionCallback, detachmentCallback });
+	}
+
+	void Corium3DEngine::setModelCollisionLayers(unsigned int modelIdx, unsigned int layers, unsigned int layersMask) {
+		corium3DEngineImpl->setModelCollisionLayers(modelIdx, layers, layersMask);
+	}
+
+	void Corium3DEngine::setModelOccluder(unsigned int modelIdx, bool isOccluder) {
+		corium3DEngineImpl->setModelOccluder(modelIdx, isOccluder);
+	}
+
+	std::string Corium3DEngine::genMemoryReportJson() {
+		MemoryReport memoryReport;
+		corium3DEngineImpl->reportMemory(memoryReport);
+		return memoryReport.toJson();
+	}
+
+	bool Corium3DEngine::writeMemoryReportJson(std::string const& jsonFilePath) {
+		std::ofstream jsonFile(jsonFilePath);
+		if (!jsonFile.is_open()) {
+			LOGE("Corium3DEngine", "Could not open %s for the memory report.", jsonFilePath.c_str());
+			return false;
+		}
+
+		MemoryReport memoryReport;
+		corium3DEngineImpl->reportMemory(memoryReport);
+		memoryReport.writeJson(jsonFile);
+		return jsonFile.good();
+	}
+
 	void Corium3DEngine::registerKeyboardInputStartCallback(KeyboardInputID inputId, KeyboardInputCallback inputCallback) {
 		corium3DEngineImpl->registerKeyboardInputStartCallback(inputId, inputCallback);
 	}
@@ -419,7 +546,7 @@ namespace Corium3D {
 	}	
 
 	Corium3DEngine::Corium3DEngineImpl::Corium3DEngineImpl(Corium3DEngineOnlineCallback& _corium3DEngineOnlineCallback, AssetsFilesFullPaths const& assetsFilesFullPaths) :
-			corium3DEngineOnlineCallback(_corium3DEngineOnlineCallback), modelsScenesFullPath(assetsFilesFullPaths.modelsScenesFullPath) { //guisDescsPath(_guisDescsPath), 		
+			corium3DEngineOnlineCallback(_corium3DEngineOnlineCallback), modelsScenesFullPath(assetsFilesFullPaths.modelsScenesFullPath), inputEventsQueue(INPUTS_BUFFER_SZ) { //guisDescsPath(_guisDescsPath), 		
 		unsigned int glyphsWidths[96] = { 8, 6, 0, 0, 0, 0, 0, 0, 12, 12, 0, 0, 8, 0, 8, 0,
 										30,16,27,25,27,26,27,25,25,27, 0, 0, 0, 0, 0, 0,
 										0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8, 0,
@@ -456,6 +583,8 @@ namespace Corium3D {
 	}
 
 	Corium3DEngine::Corium3DEngineImpl::~Corium3DEngineImpl() {
+		cancelScenePreload();
+
 		delete[] keyboardInputStartCallbacks;
 		delete[] keyboardInputEndCallbacks;
 		delete[] cursorInputCallbacks;
@@ -490,7 +619,7 @@ namespace Corium3D {
 	}
 
 	void Corium3DEngine::Corium3DEngineImpl::signalSurfaceCreated(Corium3DEngineNativeWindowType _window) {
-		ServiceLocator::getLogger().logd("Corium3DEngineImpl", "signalSurfaceCreated called.");	
+		LOGD("Corium3DEngineImpl", "signalSurfaceCreated called.");	
 		loopMutex.lock();
 		window = _window;
 		hasSurface = true;	
@@ -499,7 +628,7 @@ namespace Corium3D {
 	}
 
 	void Corium3DEngine::Corium3DEngineImpl::signalSurfaceSzChanged(unsigned int width, unsigned int height) {
-		ServiceLocator::getLogger().logd("Corium3DEngine", "signalSurfaceSzChanged called.");	
+		LOGD("Corium3DEngine", "signalSurfaceSzChanged called.");	
 		loopMutex.lock();
 		surfaceWidth = width;
 		surfaceHeight = height;
@@ -512,7 +641,7 @@ namespace Corium3D {
 	}
 
 	void Corium3DEngine::Corium3DEngineImpl::signalSurfaceDestroyed() {
-		ServiceLocator::getLogger().logd("Corium3DEngine", "signalSurfaceDestroyed called.");	
+		LOGD("Corium3DEngine", "signalSurfaceDestroyed called.");	
 		loopMutex.lock();
 		hasSurface = false;
 		isSurfaceSzKnown = false;	
@@ -521,7 +650,7 @@ namespace Corium3D {
 	}
 
 	void Corium3DEngine::Corium3DEngineImpl::signalWindowFocusChanged(bool _hasFocus) {
-		ServiceLocator::getLogger().logd("Corium3DEngine", "onWindowFocusChanged called.");	
+		LOGD("Corium3DEngine", "onWindowFocusChanged called.");	
 		loopMutex.lock();
 		hasFocus = _hasFocus;
 		if (hasFocus)					
@@ -531,12 +660,21 @@ namespace Corium3D {
 	}
 
 	void Corium3DEngine::Corium3DEngineImpl::signalDetachedFromWindow() {
-		ServiceLocator::getLogger().logd("Corium3DEngine", "onDitachedFromWindow called.");	
+		LOGD("Corium3DEngine", "onDitachedFromWindow called.");	
 		isGameOn = false;	
 		waitCond.notify_one();		
 		loopThread.join();
+		ServiceLocator::getLogger().flush();
 	}	
 
+	void Corium3DEngine::Corium3DEngineImpl::setLoopPacing(bool _isLoopPaced) {
+		isLoopPaced.store(_isLoopPaced, std::memory_order_relaxed);
+	}
+
+	void Corium3DEngine::Corium3DEngineImpl::setDebugGeometryRendering(bool isOn) {
+		renderer->setDebugGeometryRendering(isOn);
+	}
+
 	void Corium3DEngine::Corium3DEngineImpl::registerKeyboardInputStartCallback(KeyboardInputID inputId, KeyboardInputCallback inputCallback) {
 		keyboardInputStartCallbacks[inputId] = inputCallback;
 	}
@@ -550,147 +688,224 @@ namespace Corium3D {
 	}
 
 	void Corium3DEngine::Corium3DEngineImpl::systemKeyboardInputStartCallback(KeyboardInputID inputId) {
-		updateInputsCallbackBuffer(keyboardInputStartCallbacks[inputId]);
+		pushInputEvent(InputEvent::KEYBOARD_START, inputId, vec2(0.0f));
 	}
 
 	void Corium3DEngine::Corium3DEngineImpl::systemKeyboardInputEndCallback(KeyboardInputID inputId) {
-		updateInputsCallbackBuffer(keyboardInputEndCallbacks[inputId]);
+		pushInputEvent(InputEvent::KEYBOARD_END, inputId, vec2(0.0f));
 	}
 
 	void Corium3DEngine::Corium3DEngineImpl::systemCursorInputCallback(CursorInputID inputId, vec2 const& cursorPos) {
-		updateInputsCallbackBuffer(cursorInputCallbacks[inputId], cursorPos);
+		pushInputEvent(InputEvent::CURSOR, inputId, cursorPos);
 	}	
 
+	void Corium3DEngine::Corium3DEngineImpl::preloadScene(unsigned int sceneIdx) {
+		cancelScenePreload();
+
+		preparedScene = new PreparedScene();
+		scenePreloadException = NULL;
+		scenePreloadStepsDone.store(0, std::memory_order_relaxed);
+		scenePreloadStepsNr.store(1, std::memory_order_relaxed);
+		isScenePreloadCancelled.store(false, std::memory_order_relaxed);
+		isScenePreloadDone.store(false, std::memory_order_release);
+		scenePreloadThread = std::thread([this, sceneIdx]() {
+			try {
+				prepareScene(sceneIdx, *preparedScene);
+			}
+			catch (...) {
+				scenePreloadException = std::current_exception();
+			}
+			isScenePreloadDone.store(true, std::memory_order_release);
+		});
+	}
+
+	float Corium3DEngine::Corium3DEngineImpl::getScenePreloadProgress() const {
+		if (isScenePreloadDone.load(std::memory_order_acquire))
+			return preparedScene && !scenePreloadException ? 1.0f : 0.0f;
+
+		return (float)scenePreloadStepsDone.load(std::memory_order_relaxed) / scenePreloadStepsNr.load(std::memory_order_relaxed);
+	}
+
+	bool Corium3DEngine::Corium3DEngineImpl::isScenePreloaded() const {
+		return preparedScene && isScenePreloadDone.load(std::memory_order_acquire) && !scenePreloadException;
+	}
+
+	void Corium3DEngine::Corium3DEngineImpl::cancelScenePreload() {
+		if (!scenePreloadThread.joinable())
+			return;
+
+		isScenePreloadCancelled.store(true, std::memory_order_relaxed);
+		scenePreloadThread.join();
+		delete preparedScene;
+		preparedScene = NULL;
+	}
+
+	std::vector<std::vector<Transform3D>> Corium3DEngine::Corium3DEngineImpl::commitPreloadedScene() {
+#if DEBUG
+		if (!scenePreloadThread.joinable())
+			throw std::logic_error("commitPreloadedScene called with no scene preloaded.");
+#endif
+		// the preload usually finished by now - otherwise this is where a synchronous load waits for it
+		scenePreloadThread.join();
+		if (scenePreloadException) {
+			delete preparedScene;
+			preparedScene = NULL;
+			std::rethrow_exception(scenePreloadException);
+		}
+
+		PreparedScene* committedScene = preparedScene;
+		preparedScene = NULL;
+		std::vector<std::vector<Transform3D>> instancesTransformsInit = std::move(committedScene->instancesTransformsInit);
+		// the loop's scene state is swapped between its ticks
+		try {
+			runOnLoopThread([this, committedScene]() {
+				unloadScene();
+				swapScene(*committedScene);
+				renderer->loadScene(std::move(committedScene->modelDescs), staticModelsNr, sceneModelsNr - staticModelsNr, modelsInstancesNrsMaxima, *bvh);
+				isSceneLoaded = true;
+			});
+		}
+		catch (...) {
+			delete committedScene;
+			throw;
+		}
+		// holds the (empty) state swapped out
+		delete committedScene;
+
+		return instancesTransformsInit;
+	}
+
 	std::vector<std::vector<Transform3D>> Corium3DEngine::Corium3DEngineImpl::loadScene(Corium3DEngine& owningEngine, unsigned int sceneIdx) {
-		unloadScene();
-		
-		SceneData sceneData;
-		std::vector<ModelDesc> modelDescs;		
+		preloadScene(sceneIdx);
+		return commitPreloadedScene();
+	}
+
+	void Corium3DEngine::Corium3DEngineImpl::prepareScene(unsigned int sceneIdx, PreparedScene& scene) {
+		SceneDataView sceneData;
 #ifdef DEBUG
 		try
 		{
-			readSceneAssets(modelsScenesFullPath, sceneIdx, sceneData, modelDescs, modelSceneModelIdxsMap);
+			scene.sceneAssets = new MappedAssets(modelsScenesFullPath);
+			scene.sceneAssets->getSceneAssets(sceneIdx, sceneData, scene.modelDescs, scene.modelSceneModelIdxsMap);
 		}
 		catch (std::ios_base::failure const& e)
 		{
-			ServiceLocator::getLogger().logd("loadScene", "failed to read scene assets");
+			LOGD("prepareScene", "failed to read scene assets");
 			throw e;
 		}
 #else
-		readSceneAssets(modelsScenesFullPath, sceneIdx, sceneData, modelDescs, modelSceneModelIdxsMap);
+		scene.sceneAssets = new MappedAssets(modelsScenesFullPath);
+		scene.sceneAssets->getSceneAssets(sceneIdx, sceneData, scene.modelDescs, scene.modelSceneModelIdxsMap);
 #endif
 
-		staticModelsNr = sceneData.staticModelsNr;
-		sceneModelsNr = sceneData.sceneModelsData.size();
+		scene.staticModelsNr = sceneData.staticModelsNr;
+		scene.sceneModelsNr = sceneData.sceneModelsData.size();
+		scenePreloadStepsNr.store(scene.sceneModelsNr + 2, std::memory_order_relaxed);
+		scenePreloadStepsDone.store(1, std::memory_order_relaxed);
 		
-		// create game elements buffers		
-		gameLmnts = new GameLmnt**[sceneModelsNr];
-		modelsInstancesNrsMaxima = new unsigned int[sceneModelsNr];
-		proximityHandlingMethods = new GameLmnt::ProximityHandlingMethods**[sceneModelsNr];
-		onRayHitCallbacks = new GameLmnt::OnRayHit*[sceneModelsNr];
-		modelsInstancesIdxPools = new IdxPool*[sceneModelsNr];
-		modelsPrimalBoundingSpheres = new BoundingSphere[sceneModelsNr];
-		modelsPrimalAABB3Ds = new AABB3DRotatable[sceneModelsNr];
-		modelsPrimalCollisionVolumesPtrs = new CollisionVolume*[sceneModelsNr];
-		modelsPrimalAABB2Ds = new AABB2DRotatable[sceneModelsNr];
-		modelsPrimalCollisionPerimetersPtrs = new CollisionPerimeter*[sceneModelsNr];
-		std::vector<std::vector<Transform3D>> instancesTransformsInit(modelSceneModelIdxsMap.size());
-
-		collisionPrimitivesFactory = new CollisionPrimitivesFactory(&sceneData.collisionPrimitives3DInstancesNrsMaxima[0], &sceneData.collisionPrimitives2DInstancesNrsMaxima[0]);
+		// create game elements buffers (the per model entries are zeroed, so that a cancelled preparation can be freed as is)
+		scene.gameLmnts = new GameLmnt**[scene.sceneModelsNr]();
+		scene.modelsInstancesNrsMaxima = new unsigned int[scene.sceneModelsNr];
+		scene.onRayHitCallbacks = new GameLmnt::OnRayHit*[scene.sceneModelsNr]();
+		scene.modelsInstancesIdxPools = new ChunkedIdxPool*[scene.sceneModelsNr]();
+		scene.modelsPrimalBoundingSpheres = new BoundingSphere[scene.sceneModelsNr];
+		scene.modelsPrimalAABB3Ds = new AABB3DRotatable[scene.sceneModelsNr];
+		scene.modelsPrimalCollisionVolumesPtrs = new CollisionVolume*[scene.sceneModelsNr]();
+		scene.modelsPrimalAABB2Ds = new AABB2DRotatable[scene.sceneModelsNr];
+		scene.modelsPrimalCollisionPerimetersPtrs = new CollisionPerimeter*[scene.sceneModelsNr]();
+		scene.instancesTransformsInit.resize(scene.modelSceneModelIdxsMap.size());
+
+		scene.collisionPrimitivesFactory = new CollisionPrimitivesFactory(&sceneData.collisionPrimitives3DInstancesNrsMaxima[0], &sceneData.collisionPrimitives2DInstancesNrsMaxima[0]);
 		unsigned int staticInstancesNrOverallMax = 0;
 		unsigned int mobileInstancesNrOverallMax = 0;
-		for (unsigned int sceneModelIdx = 0; sceneModelIdx < sceneModelsNr; ++sceneModelIdx)
+		for (unsigned int sceneModelIdx = 0; sceneModelIdx < scene.sceneModelsNr; ++sceneModelIdx)
 		{
-			SceneData::SceneModelData& sceneModelData = sceneData.sceneModelsData[sceneModelIdx];
-			unsigned int modelIdxMapped = modelSceneModelIdxsMap[sceneModelData.modelIdx];
-			unsigned int instancesNrMax = modelsInstancesNrsMaxima[modelIdxMapped] = sceneModelData.instancesNrMax;
+			if (isScenePreloadCancelled.load(std::memory_order_relaxed))
+				return;
+
+			SceneDataView::SceneModelDataView sceneModelData = sceneData.sceneModelsData[sceneModelIdx];
+			unsigned int modelIdxMapped = scene.modelSceneModelIdxsMap[sceneModelData.modelIdx];
+			unsigned int instancesNrMax = scene.modelsInstancesNrsMaxima[modelIdxMapped] = sceneModelData.instancesNrMax;
 			if (sceneModelData.isStatic)
 				staticInstancesNrOverallMax += instancesNrMax;
 			else
 				mobileInstancesNrOverallMax += instancesNrMax;
-			modelsInstancesIdxPools[modelIdxMapped] = new IdxPool(instancesNrMax);
-			gameLmnts[modelIdxMapped] = new GameLmnt * [instancesNrMax];
-			proximityHandlingMethods[modelIdxMapped] = new GameLmnt::ProximityHandlingMethods * [instancesNrMax];
-			for (unsigned int collidedWithModelIdx = 0; collidedWithModelIdx < instancesNrMax; collidedWithModelIdx++)
-				proximityHandlingMethods[modelIdxMapped][collidedWithModelIdx] = new GameLmnt::ProximityHandlingMethods[sceneModelsNr];
-			onRayHitCallbacks[modelIdxMapped] = new GameLmnt::OnRayHit[instancesNrMax];
+			scene.modelsInstancesIdxPools[modelIdxMapped] = new ChunkedIdxPool(instancesNrMax);
+			scene.gameLmnts[modelIdxMapped] = new GameLmnt * [instancesNrMax];
+			scene.onRayHitCallbacks[modelIdxMapped] = new GameLmnt::OnRayHit[instancesNrMax];
 			
-			modelsPrimalBoundingSpheres[modelIdxMapped] = BoundingSphere(modelDescs[modelIdxMapped].boundingSphereCenter, modelDescs[modelIdxMapped].boundingSphereRadius);
+			scene.modelsPrimalBoundingSpheres[modelIdxMapped] = BoundingSphere(scene.modelDescs[modelIdxMapped].boundingSphereCenter, scene.modelDescs[modelIdxMapped].boundingSphereRadius);
 
-			ColliderData colliderData = modelDescs[modelIdxMapped].colliderData;			
+			ColliderData colliderData = scene.modelDescs[modelIdxMapped].colliderData;			
 			if (colliderData.collisionPrimitive3DType != CollisionPrimitive3DType::NO_3D_COLLIDER) {
-				modelsPrimalAABB3Ds[modelIdxMapped] = AABB3DRotatable(colliderData.aabb3DMinVertex, colliderData.aabb3DMaxVertex);
+				scene.modelsPrimalAABB3Ds[modelIdxMapped] = AABB3DRotatable(colliderData.aabb3DMinVertex, colliderData.aabb3DMaxVertex);
 				switch (colliderData.collisionPrimitive3DType) {
 					case CollisionPrimitive3DType::BOX: {
 						ColliderData::CollisionBoxData& collisionBoxData = colliderData.collisionPrimitive3dData.collisionBoxData;
-						modelsPrimalCollisionVolumesPtrs[modelIdxMapped] = collisionPrimitivesFactory->genCollisionBox(collisionBoxData.center, collisionBoxData.scale);
+						scene.modelsPrimalCollisionVolumesPtrs[modelIdxMapped] = scene.collisionPrimitivesFactory->genCollisionBox(collisionBoxData.center, collisionBoxData.scale);
 						break;
 					}
 					case CollisionPrimitive3DType::SPHERE: {
 						ColliderData::CollisionSphereData& collisionSphereData = colliderData.collisionPrimitive3dData.collisionSphereData;
-						modelsPrimalCollisionVolumesPtrs[modelIdxMapped] = collisionPrimitivesFactory->genCollisionSphere(collisionSphereData.center, collisionSphereData.radius);
+						scene.modelsPrimalCollisionVolumesPtrs[modelIdxMapped] = scene.collisionPrimitivesFactory->genCollisionSphere(collisionSphereData.center, collisionSphereData.radius);
 						break;
 					}
 					case CollisionPrimitive3DType::CAPSULE: {
 						ColliderData::CollisionCapsuleData collisionCapsuleData = colliderData.collisionPrimitive3dData.collisionCapsuleData;
-						modelsPrimalCollisionVolumesPtrs[modelIdxMapped] = collisionPrimitivesFactory->genCollisionCapsule(collisionCapsuleData.center1, collisionCapsuleData.axisVec, collisionCapsuleData.radius);
+						scene.modelsPrimalCollisionVolumesPtrs[modelIdxMapped] = scene.collisionPrimitivesFactory->genCollisionCapsule(collisionCapsuleData.center1, collisionCapsuleData.axisVec, collisionCapsuleData.radius);
 						break;
 					}
 				}
 			}
 			else {
 				// assigning aabb such that aabb.min = max_float && aabb.max == min_float, thus no intersection will be detected with this aabb
-				modelsPrimalAABB3Ds[modelIdxMapped] = AABB3DRotatable(glm::vec3(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()),
+				scene.modelsPrimalAABB3Ds[modelIdxMapped] = AABB3DRotatable(glm::vec3(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()),
 																	  glm::vec3(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max()));
-				modelsPrimalCollisionVolumesPtrs[modelIdxMapped] = NULL;
+				scene.modelsPrimalCollisionVolumesPtrs[modelIdxMapped] = NULL;
 			}
 
 			if (colliderData.collisionPrimitive2DType != CollisionPrimitive2DType::NO_2D_COLLIDER) {
-				modelsPrimalAABB2Ds[modelIdxMapped] = AABB2DRotatable(colliderData.aabb2DMinVertex, colliderData.aabb2DMaxVertex);
+				scene.modelsPrimalAABB2Ds[modelIdxMapped] = AABB2DRotatable(colliderData.aabb2DMinVertex, colliderData.aabb2DMaxVertex);
 				switch (colliderData.collisionPrimitive3DType) {
 					case CollisionPrimitive2DType::RECT: {
 						ColliderData::CollisionRectData& collisionRectData = colliderData.collisionPrimitive2dData.collisionRectData;
-						modelsPrimalCollisionPerimetersPtrs[modelIdxMapped] = collisionPrimitivesFactory->genCollisionRect(collisionRectData.center, collisionRectData.scale);
+						scene.modelsPrimalCollisionPerimetersPtrs[modelIdxMapped] = scene.collisionPrimitivesFactory->genCollisionRect(collisionRectData.center, collisionRectData.scale);
 						break;
 					}
 					case CollisionPrimitive2DType::CIRCLE: {
 						ColliderData::CollisionCircleData& collisionCircleData = colliderData.collisionPrimitive2dData.collisionCircleData;
-						modelsPrimalCollisionPerimetersPtrs[modelIdxMapped] = collisionPrimitivesFactory->genCollisionCircle(collisionCircleData.center, collisionCircleData.radius);
+						scene.modelsPrimalCollisionPerimetersPtrs[modelIdxMapped] = scene.collisionPrimitivesFactory->genCollisionCircle(collisionCircleData.center, collisionCircleData.radius);
 						break;
 					}
 					case CollisionPrimitive2DType::STADIUM: {
 						ColliderData::CollisionStadiumData& collisionStadiumData = colliderData.collisionPrimitive2dData.collisionStadiumData;
-						modelsPrimalCollisionPerimetersPtrs[modelIdxMapped] = collisionPrimitivesFactory->genCollisionStadium(collisionStadiumData.center1, collisionStadiumData.axisVec, collisionStadiumData.radius);
+						scene.modelsPrimalCollisionPerimetersPtrs[modelIdxMapped] = scene.collisionPrimitivesFactory->genCollisionStadium(collisionStadiumData.center1, collisionStadiumData.axisVec, collisionStadiumData.radius);
 						break;
 					}
 				}
 			}
 			else {
 				// assigning aabb such that aabb.min = max_float && aabb.max == min_float, thus no intersection will be detected with this aabb
-				modelsPrimalAABB2Ds[modelIdxMapped] = AABB2DRotatable(glm::vec2(std::numeric_limits<float>::max(), std::numeric_limits<float>::max()),
+				scene.modelsPrimalAABB2Ds[modelIdxMapped] = AABB2DRotatable(glm::vec2(std::numeric_limits<float>::max(), std::numeric_limits<float>::max()),
 																	  -glm::vec2(std::numeric_limits<float>::max(), -std::numeric_limits<float>::max()));
-				modelsPrimalCollisionPerimetersPtrs[modelIdxMapped] = NULL;
+				scene.modelsPrimalCollisionPerimetersPtrs[modelIdxMapped] = NULL;
 			}
 			
-			instancesTransformsInit[sceneModelData.modelIdx] = sceneModelData.instancesTransformsInit;
+			scene.instancesTransformsInit[sceneModelData.modelIdx].assign(sceneModelData.instancesTransformsInit.begin(), sceneModelData.instancesTransformsInit.end());
+			scenePreloadStepsDone.fetch_add(1, std::memory_order_relaxed);
 		}
 
-		bvh = new BVH(staticInstancesNrOverallMax, mobileInstancesNrOverallMax, staticInstancesNrOverallMax, mobileInstancesNrOverallMax, 1000, 1000);
-		physicsEngine = new PhysicsEngine(mobileInstancesNrOverallMax + staticInstancesNrOverallMax, SECS_PER_UPDATE);
-		renderer->loadScene(std::move(modelDescs), staticModelsNr, sceneModelsNr - staticModelsNr, modelsInstancesNrsMaxima, *bvh);
-		stateUpdatersPool = new ObjPoolIteratable<GameLmnt::StateUpdater>(mobileInstancesNrOverallMax + staticInstancesNrOverallMax);
-		stateUpdatersIt = new ObjPoolIteratable<GameLmnt::StateUpdater>::ObjPoolIt(*stateUpdatersPool);
-
-		cameraApiImpl = new CameraAPI::CameraApiImpl(*this);
-		cameraAPI = new CameraAPI(*cameraApiImpl);
+		if (isScenePreloadCancelled.load(std::memory_order_relaxed))
+			return;
 
-		keyboardInputStartCallbacks = new KeyboardInputCallback[KeyboardInputID::__KEYBOARD_INPUT_IDS_NR__];
-		keyboardInputEndCallbacks = new KeyboardInputCallback[KeyboardInputID::__KEYBOARD_INPUT_IDS_NR__];
-		for (unsigned int keyboardInputCallbackIdx = 0; keyboardInputCallbackIdx < KeyboardInputID::__KEYBOARD_INPUT_IDS_NR__; keyboardInputCallbackIdx++)
-			keyboardInputStartCallbacks[keyboardInputCallbackIdx] = keyboardInputEndCallbacks[keyboardInputCallbackIdx] = NULL;
-		cursorInputCallbacks = new CursorInputCallback[CursorInputID::__CURSOR_INPUT_IDS_NR__];		
-		
-		return instancesTransformsInit;
+		scene.bvh = new BVH(staticInstancesNrOverallMax, mobileInstancesNrOverallMax, staticInstancesNrOverallMax, mobileInstancesNrOverallMax, 1000, 1000);
+		scene.proximityHandlersRegistry = new ProximityHandlersRegistry(scene.sceneModelsNr);
+		scene.bvh->setTestedModelsPairs(scene.proximityHandlersRegistry->getTestedModelsPairs(), scene.sceneModelsNr);
+		scene.physicsEngine = new PhysicsEngine(mobileInstancesNrOverallMax + staticInstancesNrOverallMax, SECS_PER_UPDATE);
+		scene.stateUpdatersPool = new ChunkedObjPoolIteratable<GameLmnt::StateUpdater>(mobileInstancesNrOverallMax + staticInstancesNrOverallMax);
+		scene.stateUpdatersIt = new ChunkedObjPoolIteratable<GameLmnt::StateUpdater>::ObjPoolIt(*scene.stateUpdatersPool);
+		scene.gameLmntsStorage = new GameLmntsStorage(mobileInstancesNrOverallMax + staticInstancesNrOverallMax);
+		scenePreloadStepsDone.fetch_add(1, std::memory_order_relaxed);
 	}
 
 	Corium3DEngine::GuiAPI& Corium3DEngine::Corium3DEngineImpl::accessGuiAPI(unsigned int guiIdx) {
@@ -703,20 +918,28 @@ namespace Corium3D {
 
 	bool Corium3DEngine::Corium3DEngineImpl::loop() {			
 		eglMutex.lock();		
-		double previous = ServiceLocator::getTimer().getCurrentTime();
-		double lag = 0.0;
+		UpdatesPacer updatesPacer(ServiceLocator::getTimer(), NS_PER_UPDATE);
 		bool isSurfaceSzChanged;	 		
 		std::unique_lock<std::mutex> loopMutexLock(loopMutex, std::defer_lock);
 		while (isGameOn) {		
 			loopMutexLock.lock();
-			if (isPaused) {
+			if (isPaused && !needInit) {
 				renderer->destroy();
 				needInit = true;
 			}
 		
-			waitCond.wait(loopMutexLock, std::bind(&Corium3DEngineImpl::canLoopContinue, this));		
+			waitCond.wait(loopMutexLock, [this]() { return canLoopContinue() || loopTask; });
+			if (loopTask) {
+				runLoopTask(loopMutexLock);
+				// woken up for the task only
+				if (!canLoopContinue()) {
+					loopMutexLock.unlock();
+					continue;
+				}
+			}
 
 			if (!isGameOn) {
+				loopMutexLock.unlock();
 				break;
 			}
 
@@ -731,7 +954,8 @@ namespace Corium3D {
 
 			if (isSurfaceSzChanged) {
 				if (!renderer->surfaceSzChanged(surfaceWidth, surfaceHeight)) {
-					ServiceLocator::getLogger().loge("Corium3DEngine", "surfaceSzChanged failed."); //TODO: handle failure in the game loop thread			
+					LOGE("Corium3DEngine", "surfaceSzChanged failed."); //TODO: handle failure in the game loop thread			
+					endLoop();
 					eglMutex.unlock();
 					return false;
 				}
@@ -740,14 +964,10 @@ namespace Corium3D {
 			}
 		
 			processInput();
-			double current = ServiceLocator::getTimer().getCurrentTime();
-			double elapsed = current - previous;
-			previous = current;
-			lag += elapsed;
-			while (lag >= SECS_PER_UPDATE) {
+			unsigned int updatesNr = updatesPacer.beginFrame();
+			for (unsigned int updateIdx = 0; updateIdx < updatesNr; updateIdx++)
 				update();
-				lag -= SECS_PER_UPDATE;
-			}
+			double lag = (double)updatesPacer.getLagNs() / Timer::NS_PER_SEC;
 			bvh->refitBPsDueToUpdate();
 			resolveCollisions3D();
 			//resolveCollisions2D();
@@ -756,12 +976,18 @@ namespace Corium3D {
 			renderer->render(lag);
 	#else
 			if (!renderer->render(lag)) {
-				ServiceLocator::getLogger().loge("Corium3DEngine", "render failed."); //TODO: handle failure in the GameLoop thread			
+				LOGE("Corium3DEngine", "render failed."); //TODO: handle failure in the GameLoop thread			
+				endLoop();
 				eglMutex.unlock();
 				return false;
 			}
 	#endif
+			PROFILE_FRAME_END();
+
+			if (isLoopPaced.load(std::memory_order_relaxed))
+				updatesPacer.sleepUntilNextUpdate();
 		}	
+		endLoop();
 		eglMutex.unlock();
 		return true;
 	}
@@ -770,34 +996,125 @@ namespace Corium3D {
 		return !((isPaused || !hasFocus || !hasSurface || !isSurfaceSzKnown) && isGameOn);
 	}
 
+	void Corium3DEngine::Corium3DEngineImpl::runOnLoopThread(std::function<void()> const& task) {
+		if (std::this_thread::get_id() == loopThread.get_id()) {
+			task();
+			return;
+		}
+
+		LoopTask callerTask = { task, NULL };
+		std::unique_lock<std::mutex> loopMutexLock(loopMutex);
+		// a task at a time
+		loopTaskDoneCond.wait(loopMutexLock, [this]() { return !loopTask || !isLoopRunning; });
+		bool isRunByLoop = false;
+		if (isLoopRunning) {
+			loopTask = &callerTask;
+			waitCond.notify_one();
+			loopTaskDoneCond.wait(loopMutexLock, [this, &callerTask]() { return loopTask != &callerTask || !isLoopRunning; });
+			isRunByLoop = loopTask != &callerTask;
+			// the loop ended before getting to it
+			if (!isRunByLoop)
+				loopTask = NULL;
+		}
+		loopMutexLock.unlock();
+
+		if (!isRunByLoop)
+			task();
+		else if (callerTask.exception)
+			std::rethrow_exception(callerTask.exception);
+	}
+
+	void Corium3DEngine::Corium3DEngineImpl::runLoopTask(std::unique_lock<std::mutex>& loopMutexLock) {
+		LoopTask& task = *loopTask;
+		// the signals are not held back by the task
+		loopMutexLock.unlock();
+		try {
+			task.run();
+		}
+		catch (...) {
+			task.exception = std::current_exception();
+		}
+		loopMutexLock.lock();
+		loopTask = NULL;
+		loopTaskDoneCond.notify_all();
+	}
+
+	void Corium3DEngine::Corium3DEngineImpl::endLoop() {
+		std::lock_guard<std::mutex> loopMutexLock(loopMutex);
+		isLoopRunning = false;
+		loopTaskDoneCond.notify_all();
+	}
+
 	void Corium3DEngine::Corium3DEngineImpl::unloadScene() {
 		if (!isSceneLoaded)
 			return;
 	
-		delete[] cursorInputCallbacks;
-		delete[] keyboardInputEndCallbacks;
-		delete[] keyboardInputStartCallbacks;
-
-		delete cameraAPI;
-		delete cameraApiImpl;
-
+		// the renderer holds views into the scene's assets
+		renderer->unloadScene();
+		PreparedScene unloadedScene;
+		swapScene(unloadedScene);
+		isSceneLoaded = false;
+	}
+
+	void Corium3DEngine::Corium3DEngineImpl::swapScene(PreparedScene& scene) {
+		std::swap(sceneAssets, scene.sceneAssets);
+		modelSceneModelIdxsMap.swap(scene.modelSceneModelIdxsMap);
+		std::swap(sceneModelsNr, scene.sceneModelsNr);
+		std::swap(staticModelsNr, scene.staticModelsNr);
+		std::swap(modelsInstancesNrsMaxima, scene.modelsInstancesNrsMaxima);
+		std::swap(modelsInstancesIdxPools, scene.modelsInstancesIdxPools);
+		std::swap(gameLmnts, scene.gameLmnts);
+		std::swap(onRayHitCallbacks, scene.onRayHitCallbacks);
+		std::swap(modelsPrimalBoundingSpheres, scene.modelsPrimalBoundingSpheres);
+		std::swap(modelsPrimalAABB3Ds, scene.modelsPrimalAABB3Ds);
+		std::swap(modelsPrimalCollisionVolumesPtrs, scene.modelsPrimalCollisionVolumesPtrs);
+		std::swap(modelsPrimalAABB2Ds, scene.modelsPrimalAABB2Ds);
+		std::swap(modelsPrimalCollisionPerimetersPtrs, scene.modelsPrimalCollisionPerimetersPtrs);
+		std::swap(collisionPrimitivesFactory, scene.collisionPrimitivesFactory);
+		std::swap(bvh, scene.bvh);
+		std::swap(proximityHandlersRegistry, scene.proximityHandlersRegistry);
+		std::swap(physicsEngine, scene.physicsEngine);
+		std::swap(stateUpdatersPool, scene.stateUpdatersPool);
+		std::swap(stateUpdatersIt, scene.stateUpdatersIt);
+		std::swap(gameLmntsStorage, scene.gameLmntsStorage);
+	}
+
+	void Corium3DEngine::Corium3DEngineImpl::growModelInstances(unsigned int modelIdx, unsigned int instanceIdx) {
+		unsigned int instancesNrMaxPrev = modelsInstancesNrsMaxima[modelIdx];
+		unsigned int instancesNrMax = InstancesRanges::calcGrownInstancesNrMax(instancesNrMaxPrev, instanceIdx);
+
+		GameLmnt** modelGameLmnts = new GameLmnt*[instancesNrMax];
+		std::copy(gameLmnts[modelIdx], gameLmnts[modelIdx] + instancesNrMaxPrev, modelGameLmnts);
+		delete[] gameLmnts[modelIdx];
+		gameLmnts[modelIdx] = modelGameLmnts;
+		GameLmnt::OnRayHit* modelOnRayHitCallbacks = new GameLmnt::OnRayHit[instancesNrMax];
+		std::copy(onRayHitCallbacks[modelIdx], onRayHitCallbacks[modelIdx] + instancesNrMaxPrev, modelOnRayHitCallbacks);
+		delete[] onRayHitCallbacks[modelIdx];
+		onRayHitCallbacks[modelIdx] = modelOnRayHitCallbacks;
+
+		modelsInstancesNrsMaxima[modelIdx] = instancesNrMax;
+		renderer->setModelInstancesNrMax(modelIdx, instancesNrMax);
+	}
+
+	Corium3DEngine::Corium3DEngineImpl::PreparedScene::~PreparedScene() {
+		delete gameLmntsStorage;
 		delete stateUpdatersIt;	
 		delete stateUpdatersPool;
 		delete physicsEngine;
+		delete proximityHandlersRegistry;
 		delete bvh;	
 
 		delete collisionPrimitivesFactory;
 		for (unsigned int modelIdx = 0; modelIdx < sceneModelsNr; modelIdx++) {
-			delete modelsInstancesIdxPools[modelIdx];		
-			delete[] gameLmnts[modelIdx];	
-			for (unsigned int collidedWithModelIdx = 0; collidedWithModelIdx < modelsInstancesNrsMaxima[modelIdx]; collidedWithModelIdx++)
-				delete[] proximityHandlingMethods[modelIdx][collidedWithModelIdx];
-			delete[] proximityHandlingMethods[modelIdx];
-			delete[] onRayHitCallbacks[modelIdx];
+			if (modelsInstancesIdxPools)
+				delete modelsInstancesIdxPools[modelIdx];
+			if (gameLmnts)
+				delete[] gameLmnts[modelIdx];	
+			if (onRayHitCallbacks)
+				delete[] onRayHitCallbacks[modelIdx];
 		}
 		delete[] modelsInstancesIdxPools;
 		delete[] onRayHitCallbacks;
-		delete[] proximityHandlingMethods;
 		delete[] modelsInstancesNrsMaxima;
 		delete[] gameLmnts;
 					
@@ -807,51 +1124,138 @@ namespace Corium3D {
 		delete[] modelsPrimalAABB2Ds;
 		delete[] modelsPrimalCollisionPerimetersPtrs;
 
-		renderer->unloadScene();
+		delete sceneAssets;
+	}
+
+	void Corium3DEngine::Corium3DEngineImpl::setModelsPairProximityHandlers(unsigned int modelIdx, unsigned int otherModelIdx, GameLmnt::ProximityHandlingMethods const& proximityHandlingMethods) {
+		proximityHandlersRegistry->setModelsPairHandlers(modelSceneModelIdxsMap[modelIdx], modelSceneModelIdxsMap[otherModelIdx], proximityHandlingMethods);
+	}
+
+	void Corium3DEngine::Corium3DEngineImpl::setModelCollisionLayers(unsigned int modelIdx, unsigned int layers, unsigned int layersMask) {
+		proximityHandlersRegistry->setModelCollisionLayers(modelSceneModelIdxsMap[modelIdx], layers, layersMask);
+	}
+
+	void Corium3DEngine::Corium3DEngineImpl::setModelOccluder(unsigned int modelIdx, bool isOccluder) {
+		renderer->setModelOccluder(modelSceneModelIdxsMap[modelIdx], isOccluder);
+	}
+
+	void Corium3DEngine::Corium3DEngineImpl::reportMemory(MemoryReport& memoryReport) {
+		runOnLoopThread([this, &memoryReport]() { collectMemoryReport(memoryReport); });
+	}
+
+	void Corium3DEngine::Corium3DEngineImpl::collectMemoryReport(MemoryReport& memoryReport) const {
+		guis[0]->reportMemory(memoryReport, "GUI");
+		// no scene was loaded yet
+		if (!gameLmntsStorage)
+			return;
+
+		for (unsigned int modelIdx = 0; modelIdx < sceneModelsNr; modelIdx++) {
+			ChunkedIdxPool const& instancesIdxPool = *modelsInstancesIdxPools[modelIdx];
+			memoryReport.addEntry("GameLmnts", std::string("model#") + std::to_string(modelIdx) + " instances", sizeof(GameLmnt*) + sizeof(GameLmnt::OnRayHit) + sizeof(unsigned int),
+				instancesIdxPool.getCapacity(), instancesIdxPool.getAcquiredIdxsNr(), instancesIdxPool.getAcquiredIdxsNrMax());
+		}
+		gameLmntsStorage->reportMemory(memoryReport);
+		memoryReport.addPool("GameLmnts", "stateUpdaters", *stateUpdatersPool);
+		bvh->reportMemory(memoryReport);
+		collisionPrimitivesFactory->reportMemory(memoryReport);
+		physicsEngine->reportMemory(memoryReport);
+		renderer->reportMemory(memoryReport);
 	}
 
 	void Corium3DEngine::Corium3DEngineImpl::processInput() {
+		PROFILE_ZONE("Corium3DEngine::processInput");
+		// events arriving while draining are left for the next tick
+		unsigned int currUpdateInputsNr = inputEventsQueue.getAvailableNr();
+		InputEvent inputEvent;
 		for (unsigned int currUpdateInputIdx = 0; currUpdateInputIdx < currUpdateInputsNr; currUpdateInputIdx++) {
-			InputEvent const& inputEvent = inputEventsBuffer[currUpdateInputIdx];
-			if (inputEvent.keyboardInputCallback)
-				inputEvent.keyboardInputCallback(inputEvent.inputTimeStamp);
-			else if (!guis[0]->select(inputEvent.cursorPos.x, inputEvent.cursorPos.y) && inputEvent.cursorInputCallback)
-				inputEvent.cursorInputCallback(inputEvent.inputTimeStamp, inputEvent.cursorPos);
+			inputEventsQueue.pop(inputEvent);
+			switch (inputEvent.inputType) {
+				case InputEvent::KEYBOARD_START:
+					if (keyboardInputStartCallbacks[inputEvent.inputId])
+						keyboardInputStartCallbacks[inputEvent.inputId](inputEvent.inputTimeStamp);
+					break;
+				case InputEvent::KEYBOARD_END:
+					if (keyboardInputEndCallbacks[inputEvent.inputId])
+						keyboardInputEndCallbacks[inputEvent.inputId](inputEvent.inputTimeStamp);
+					break;
+				case InputEvent::CURSOR:
+					if (!guis[0]->select(inputEvent.cursorPos.x, inputEvent.cursorPos.y) && cursorInputCallbacks[inputEvent.inputId])
+						cursorInputCallbacks[inputEvent.inputId](inputEvent.inputTimeStamp, inputEvent.cursorPos);
+					break;
+			}
+		}
+
+#if DEBUG
+		RingBufferSPSC<InputEvent>::Stats inputEventsQueueStats = inputEventsQueue.getStats();
+		if (inputEventsQueueStats.droppedNr > 0) {
+			LOGD("Corium3DEngine", "input events queue overflowed: %llu of %llu events dropped (max occupancy: %u/%u).",
+				inputEventsQueueStats.droppedNr, inputEventsQueueStats.pushedNr + inputEventsQueueStats.droppedNr, inputEventsQueueStats.occupancyMax, inputEventsQueue.getCapacity());
+			inputEventsQueue.resetStats();
 		}
-		currUpdateInputsNr = 0;
+#endif
 	}
 
+	// the mobile elements are updated along the storage's archetypes rather than the physics engine's pool, so that their
+	// transforms and deltas land in the archetypes' columns
 	void Corium3DEngine::Corium3DEngineImpl::update() {
-		physicsEngine->update();
+		PROFILE_ZONE("Corium3DEngine::update");
+		for (unsigned int components = 0; components < GameLmntsStorage::ARCHETYPES_NR; components++) {
+			if (!(components & GameLmnt::Component::Mobility))
+				continue;
+
+			GameLmntsStorage::Archetype& archetype = gameLmntsStorage->accessArchetype(components);
+			physicsEngine->update(archetype.mobilityInterfaces.data(), archetype.transforms.data(), archetype.transformDeltas.data(), archetype.transform2DRotDeltas.data(), archetype.getLmntsNr());
+		}
+		syncMobileGameLmnts();
+	}
+
+	// one linear pass over the mobile graphical archetypes' deltas columns - replaces a bound listener call per moved element
+	void Corium3DEngine::Corium3DEngineImpl::syncMobileGameLmnts() {
+		PROFILE_ZONE("Corium3DEngine::syncMobileGameLmnts");
+		for (unsigned int components = 0; components < GameLmntsStorage::ARCHETYPES_NR; components++) {
+			if (!(components & GameLmnt::Component::Mobility) || !(components & GameLmnt::Component::Graphics))
+				continue;
+
+			GameLmntsStorage::Archetype& archetype = gameLmntsStorage->accessArchetype(components);
+			unsigned int lmntsNr = archetype.getLmntsNr();
+			for (unsigned int rowIdx = 0; rowIdx < lmntsNr; rowIdx++) {
+				Transform3DUS const& transformDelta = archetype.transformDeltas[rowIdx];
+				bvh->updateNodeBPs(static_cast<BVH::MobileGameLmntDataNode3D*>(archetype.bvhDataNodes3D[rowIdx]), transformDelta);
+				if (archetype.bvhDataNodes2D[rowIdx])
+					bvh->updateNodeBPs(static_cast<BVH::MobileGameLmntDataNode2D*>(archetype.bvhDataNodes2D[rowIdx]), Transform2DUS({ transformDelta.translate, transformDelta.scale, archetype.transform2DRotDeltas[rowIdx] }));
+			}
+		}
 	}
 
 	void Corium3DEngine::Corium3DEngineImpl::resolveCollisions3D() {
+		PROFILE_ZONE("Corium3DEngine::resolveCollisions3D");
 		BVH::CollisionsData<glm::vec3> const& collisionsData3D = bvh->getCollisionsData3D();
 		doResolveCollisions<glm::vec3>(collisionsData3D);
 	}
 
 	void Corium3DEngine::Corium3DEngineImpl::resolveCollisions2D() {
+		PROFILE_ZONE("Corium3DEngine::resolveCollisions2D");
 		BVH::CollisionsData<glm::vec2> const& collisionsData2D = bvh->getCollisionsData2D();
 		doResolveCollisions<glm::vec2>(collisionsData2D);
 	}
 
 	template <class V>
 	void Corium3DEngine::Corium3DEngineImpl::doResolveCollisions(BVH::CollisionsData<V> const& collisionsData) {	
-		GameLmnt::ProximityHandlingMethod proximityHandlingMethod;
+		GameLmnt::ProximityHandlingMethods const* proximityHandlingMethods;
 		for (unsigned int collisionDataIdx = 0; collisionDataIdx < collisionsData.collisionsNr; collisionDataIdx++) {
 			BVH::CollisionData<V>& collisionData = collisionsData.collisionsDataBuffer[collisionDataIdx];
-			if (proximityHandlingMethod = proximityHandlingMethods[collisionData.modelIdx1][collisionData.instanceIdx1][collisionData.modelIdx2].collisionCallback)
-				proximityHandlingMethod(gameLmnts[collisionData.modelIdx1][collisionData.instanceIdx1], gameLmnts[collisionData.modelIdx2][collisionData.instanceIdx2]);
-			if (proximityHandlingMethod = proximityHandlingMethods[collisionData.modelIdx2][collisionData.instanceIdx2][collisionData.modelIdx1].collisionCallback)
-				proximityHandlingMethod(gameLmnts[collisionData.modelIdx2][collisionData.instanceIdx2], gameLmnts[collisionData.modelIdx1][collisionData.instanceIdx1]);
+			if ((proximityHandlingMethods = proximityHandlersRegistry->find(collisionData.modelIdx1, collisionData.instanceIdx1, collisionData.modelIdx2)) && proximityHandlingMethods->collisionCallback)
+				proximityHandlingMethods->collisionCallback(gameLmnts[collisionData.modelIdx1][collisionData.instanceIdx1], gameLmnts[collisionData.modelIdx2][collisionData.instanceIdx2]);
+			if ((proximityHandlingMethods = proximityHandlersRegistry->find(collisionData.modelIdx2, collisionData.instanceIdx2, collisionData.modelIdx1)) && proximityHandlingMethods->collisionCallback)
+				proximityHandlingMethods->collisionCallback(gameLmnts[collisionData.modelIdx2][collisionData.instanceIdx2], gameLmnts[collisionData.modelIdx1][collisionData.instanceIdx1]);
 		}
 
 		for (unsigned int detachmentDataIdx = 0; detachmentDataIdx < collisionsData.detachmentsNr; detachmentDataIdx++) {
 			BVH::CollisionData<V>& detachmentData = collisionsData.detachmentsDataBuffer[detachmentDataIdx];
-			if (proximityHandlingMethod = proximityHandlingMethods[detachmentData.modelIdx1][detachmentData.instanceIdx1][detachmentData.modelIdx2].detachmentCallback)
-				proximityHandlingMethod(gameLmnts[detachmentData.modelIdx1][detachmentData.instanceIdx1], gameLmnts[detachmentData.modelIdx2][detachmentData.instanceIdx2]);
-			if (proximityHandlingMethod = proximityHandlingMethods[detachmentData.modelIdx2][detachmentData.instanceIdx2][detachmentData.modelIdx1].detachmentCallback)
-				proximityHandlingMethod(gameLmnts[detachmentData.modelIdx2][detachmentData.instanceIdx2], gameLmnts[detachmentData.modelIdx1][detachmentData.instanceIdx1]);
+			if ((proximityHandlingMethods = proximityHandlersRegistry->find(detachmentData.modelIdx1, detachmentData.instanceIdx1, detachmentData.modelIdx2)) && proximityHandlingMethods->detachmentCallback)
+				proximityHandlingMethods->detachmentCallback(gameLmnts[detachmentData.modelIdx1][detachmentData.instanceIdx1], gameLmnts[detachmentData.modelIdx2][detachmentData.instanceIdx2]);
+			if ((proximityHandlingMethods = proximityHandlersRegistry->find(detachmentData.modelIdx2, detachmentData.instanceIdx2, detachmentData.modelIdx1)) && proximityHandlingMethods->detachmentCallback)
+				proximityHandlingMethods->detachmentCallback(gameLmnts[detachmentData.modelIdx2][detachmentData.instanceIdx2], gameLmnts[detachmentData.modelIdx1][detachmentData.instanceIdx1]);
 		}
 	}
 
@@ -915,53 +1319,53 @@ namespace Corium3D {
 		//if (components & Component::State)
 		//	stateUpdater = corium3DEngineImpl.stateUpdatersPool->acquire(stateUpdater);
 
+		GameLmntsStorage::Row storageRow;
+		storageRow.transform = initTransformNormed;
+		storageRow.modelIdx = modelIdx;
 		if (components & Component::Mobility) {
-			if (onMovementMadeCallback == NULL) {
-				PhysicsEngine::OnMovementMadeCallback3D listener3D[1] = { std::bind(&GameLmntImpl::updateBvhNodeBVs, this, std::placeholders::_1) };
-				if (corium3DEngineImpl.modelsPrimalCollisionPerimetersPtrs[modelIdx]) {								
-					PhysicsEngine::OnMovementMadeCallback2D listener2D[1] = { std::bind(&GameLmntImpl::updateBvhNodeBPs, this, std::placeholders::_1) };
-					mobilityInterface = corium3DEngineImpl.physicsEngine->addMobileGameLmnt(initTransformNormed, listener3D, 1, initCollisionPerimeterRotComplex, listener2D, 1);
-				}
-				else 				
-					mobilityInterface = corium3DEngineImpl.physicsEngine->addMobileGameLmnt(initTransformNormed, listener3D, 1);			
-			}
-			else {
-				PhysicsEngine::OnMovementMadeCallback3D listeners3D[2] = { onMovementMadeCallback , std::bind(&GameLmntImpl::updateBvhNodeBVs, this, std::placeholders::_1) };
-				if (corium3DEngineImpl.modelsPrimalCollisionPerimetersPtrs[modelIdx]) {				
-					PhysicsEngine::OnMovementMadeCallback2D listener2D[1] = { std::bind(&GameLmntImpl::updateBvhNodeBPs, this, std::placeholders::_1) };
-					mobilityInterface = corium3DEngineImpl.physicsEngine->addMobileGameLmnt(initTransformNormed, listeners3D, 2, initCollisionPerimeterRotComplex, listener2D, 1);
-				}
-				else
-					mobilityInterface = corium3DEngineImpl.physicsEngine->addMobileGameLmnt(initTransformNormed, listeners3D, 2);				
-			}
+			// the BVH nodes are refitted by the engine's linear pass over the mobile elements after the physics update
+			PhysicsEngine::OnMovementMadeCallback3D listener3D[1] = { onMovementMadeCallback };
+			unsigned int listeners3DNr = onMovementMadeCallback == NULL ? 0 : 1;
+			if (corium3DEngineImpl.modelsPrimalCollisionPerimetersPtrs[modelIdx])
+				storageRow.mobilityInterface = corium3DEngineImpl.physicsEngine->addMobileGameLmnt(initTransformNormed, listener3D, listeners3DNr, initCollisionPerimeterRotComplex, NULL, 0);
+			else
+				storageRow.mobilityInterface = corium3DEngineImpl.physicsEngine->addMobileGameLmnt(initTransformNormed, listener3D, listeners3DNr);
 			mobilityAPI = new MobilityAPI(*this);
 		}			
 
 		if (components & Component::Graphics) {			
 			instanceIdx = corium3DEngineImpl.modelsInstancesIdxPools[modelIdx]->acquire();
+			if (instanceIdx >= corium3DEngineImpl.modelsInstancesNrsMaxima[modelIdx])
+				corium3DEngineImpl.growModelInstances(modelIdx, instanceIdx);
+			storageRow.instanceIdx = instanceIdx;
 
-			collisionVolume = static_cast<CollisionVolume*>(corium3DEngineImpl.collisionPrimitivesFactory->genCollisionPrimitive<glm::vec3>(*(corium3DEngineImpl.modelsPrimalCollisionVolumesPtrs[modelIdx]), initTransformNormed));
+			CollisionVolume* collisionVolume = static_cast<CollisionVolume*>(corium3DEngineImpl.collisionPrimitivesFactory->genCollisionPrimitive<glm::vec3>(*(corium3DEngineImpl.modelsPrimalCollisionVolumesPtrs[modelIdx]), initTransformNormed));
+			CollisionPerimeter* collisionPerimeter = NULL;
 			if (corium3DEngineImpl.modelsPrimalCollisionPerimetersPtrs[modelIdx])
 				collisionPerimeter = static_cast<CollisionPerimeter*>(corium3DEngineImpl.collisionPrimitivesFactory->genCollisionPrimitive<glm::vec2>(*(corium3DEngineImpl.modelsPrimalCollisionPerimetersPtrs[modelIdx]), initTransformNormed));							
+			storageRow.collisionVolume = collisionVolume;
+			storageRow.collisionPerimeter = collisionPerimeter;
 
 			if (components & Component::Mobility) {						
-				mobileGameLmntBvhDataNode3D = corium3DEngineImpl.bvh->insert(AABB3DRotatable::calcTransformedAABB(corium3DEngineImpl.modelsPrimalAABB3Ds[modelIdx], initTransformNormed),				
+				storageRow.bvhDataNode3D = corium3DEngineImpl.bvh->insert(AABB3DRotatable::calcTransformedAABB(corium3DEngineImpl.modelsPrimalAABB3Ds[modelIdx], initTransformNormed),				
 					BoundingSphere::calcTransformedBoundingSphere(corium3DEngineImpl.modelsPrimalBoundingSpheres[modelIdx], initTransformNormed),
-																  modelIdx, instanceIdx, *collisionVolume, *mobilityInterface);
-				if (corium3DEngineImpl.modelsPrimalCollisionPerimetersPtrs[modelIdx])
-					mobileGameLmntBvhDataNode2D = corium3DEngineImpl.bvh->insert(AABB2DRotatable::calcTransformedAABB(corium3DEngineImpl.modelsPrimalAABB2Ds[modelIdx], Transform2D({ initTransformNormed.translate, initTransformNormed.scale, initCollisionPerimeterRotComplex })), modelIdx, instanceIdx, *collisionPerimeter, *mobilityInterface);
+																  modelIdx, instanceIdx, *collisionVolume, *storageRow.mobilityInterface);
+				if (collisionPerimeter)
+					storageRow.bvhDataNode2D = corium3DEngineImpl.bvh->insert(AABB2DRotatable::calcTransformedAABB(corium3DEngineImpl.modelsPrimalAABB2Ds[modelIdx], Transform2D({ initTransformNormed.translate, initTransformNormed.scale, initCollisionPerimeterRotComplex })), modelIdx, instanceIdx, *collisionPerimeter, *storageRow.mobilityInterface);
 			}
 			else {						
-				staticGameLmntBvhDataNode3D = corium3DEngineImpl.bvh->insert(AABB3DRotatable::calcTransformedAABB(corium3DEngineImpl.modelsPrimalAABB3Ds[modelIdx], initTransformNormed),
+				storageRow.bvhDataNode3D = corium3DEngineImpl.bvh->insert(AABB3DRotatable::calcTransformedAABB(corium3DEngineImpl.modelsPrimalAABB3Ds[modelIdx], initTransformNormed),
 					BoundingSphere::calcTransformedBoundingSphere(corium3DEngineImpl.modelsPrimalBoundingSpheres[modelIdx], initTransformNormed),
 					modelIdx, instanceIdx, *collisionVolume);
-				if (corium3DEngineImpl.modelsPrimalCollisionPerimetersPtrs[modelIdx])
-					staticGameLmntBvhDataNode2D = corium3DEngineImpl.bvh->insert(AABB2DRotatable::calcTransformedAABB(corium3DEngineImpl.modelsPrimalAABB2Ds[modelIdx], Transform2D({ initTransformNormed.translate, initTransformNormed.scale, initCollisionPerimeterRotComplex })), modelIdx, instanceIdx, *collisionPerimeter);
+				if (collisionPerimeter)
+					storageRow.bvhDataNode2D = corium3DEngineImpl.bvh->insert(AABB2DRotatable::calcTransformedAABB(corium3DEngineImpl.modelsPrimalAABB2Ds[modelIdx], Transform2D({ initTransformNormed.translate, initTransformNormed.scale, initCollisionPerimeterRotComplex })), modelIdx, instanceIdx, *collisionPerimeter);
 		
 				corium3DEngineImpl.renderer->setStaticModelInstanceTransform(modelIdx, instanceIdx, glm::translate(initTransformNormed.translate) * glm::mat4_cast(initTransformNormed.rot) * glm::scale(initTransformNormed.scale));
 			}		
-			for (unsigned int otherModelIdx = 0; otherModelIdx < corium3DEngineImpl.sceneModelsNr; otherModelIdx++)
-				corium3DEngineImpl.proximityHandlingMethods[modelIdx][instanceIdx][otherModelIdx] = proximityHandlingMethods[otherModelIdx];
+			if (proximityHandlingMethods) {
+				for (unsigned int otherModelIdx = 0; otherModelIdx < corium3DEngineImpl.sceneModelsNr; otherModelIdx++)
+					corium3DEngineImpl.proximityHandlersRegistry->setInstanceHandlers(modelIdx, instanceIdx, otherModelIdx, proximityHandlingMethods[otherModelIdx]);
+			}
 			corium3DEngineImpl.onRayHitCallbacks[modelIdx][instanceIdx] = onRayHitCallback;
 			corium3DEngineImpl.gameLmnts[modelIdx][instanceIdx] = &owningGameLmnt;
 			//instanceAnimationInterface = corium3DEngineImpl.renderer->activateAnimation(modelIdx, instanceIdx);
@@ -969,46 +1373,44 @@ namespace Corium3D {
 		}	
 		
 		componentsFlag = components;
+		storageHandle = corium3DEngineImpl.gameLmntsStorage->add(components, storageRow);
 	}
 
 	Corium3DEngine::GameLmnt::GameLmntImpl::~GameLmntImpl() {		
+		GameLmntsStorage& storage = *corium3DEngineImpl.gameLmntsStorage;
+		GameLmntsStorage::Archetype& archetype = storage.accessArchetype(componentsFlag);
+		unsigned int rowIdx = storage.getRowIdx(storageHandle);
+
 		if (componentsFlag & Component::State)
 			corium3DEngineImpl.stateUpdatersPool->release(stateUpdater);	
 
 		if (componentsFlag & Component::Mobility) {
 			delete mobilityAPI;
-			corium3DEngineImpl.physicsEngine->removeMobileGameLmnt(mobilityInterface);
+			corium3DEngineImpl.physicsEngine->removeMobileGameLmnt(archetype.mobilityInterfaces[rowIdx]);
 		}
 
 		if (componentsFlag & Component::Graphics) {
 			delete graphicsAPI;
 			//corium3DEngineImpl.renderer->deactivateAnimation(instanceAnimationInterface);		
 			if (componentsFlag & Component::Mobility) {
-				corium3DEngineImpl.bvh->remove(mobileGameLmntBvhDataNode3D);
-				if (corium3DEngineImpl.modelsPrimalCollisionPerimetersPtrs[modelIdx])
-					corium3DEngineImpl.bvh->remove(mobileGameLmntBvhDataNode2D);
+				corium3DEngineImpl.bvh->remove(static_cast<BVH::MobileGameLmntDataNode3D*>(archetype.bvhDataNodes3D[rowIdx]));
+				if (archetype.bvhDataNodes2D[rowIdx])
+					corium3DEngineImpl.bvh->remove(static_cast<BVH::MobileGameLmntDataNode2D*>(archetype.bvhDataNodes2D[rowIdx]));
 			}
 			else {
-				corium3DEngineImpl.bvh->remove(staticGameLmntBvhDataNode3D);
-				if (corium3DEngineImpl.modelsPrimalCollisionPerimetersPtrs[modelIdx])
-					corium3DEngineImpl.bvh->remove(staticGameLmntBvhDataNode2D);
+				corium3DEngineImpl.bvh->remove(archetype.bvhDataNodes3D[rowIdx]);
+				if (archetype.bvhDataNodes2D[rowIdx])
+					corium3DEngineImpl.bvh->remove(archetype.bvhDataNodes2D[rowIdx]);
 			}		
-			corium3DEngineImpl.collisionPrimitivesFactory->destroyCollisionPrimitive(collisionVolume);
-			corium3DEngineImpl.collisionPrimitivesFactory->destroyCollisionPrimitive(collisionPerimeter);
+			corium3DEngineImpl.collisionPrimitivesFactory->destroyCollisionPrimitive(archetype.collisionVolumes[rowIdx]);
+			corium3DEngineImpl.collisionPrimitivesFactory->destroyCollisionPrimitive(archetype.collisionPerimeters[rowIdx]);
 
-			for (unsigned int otherModelIdx = 0; otherModelIdx < corium3DEngineImpl.sceneModelsNr; otherModelIdx++)
-				corium3DEngineImpl.proximityHandlingMethods[modelIdx][instanceIdx][otherModelIdx] = { NULL, NULL };				
+			corium3DEngineImpl.proximityHandlersRegistry->clearInstanceHandlers(modelIdx, instanceIdx);
 			corium3DEngineImpl.gameLmnts[modelIdx][instanceIdx] = NULL;		
 			corium3DEngineImpl.modelsInstancesIdxPools[modelIdx]->release(instanceIdx);
 		}	
-	}
-
-	void Corium3DEngine::GameLmnt::GameLmntImpl::updateBvhNodeBVs(Transform3DUS const& transformDelta) {
-		corium3DEngineImpl.bvh->updateNodeBPs(mobileGameLmntBvhDataNode3D, transformDelta);	
-	}
 
-	void Corium3DEngine::GameLmnt::GameLmntImpl::updateBvhNodeBPs(Transform2DUS const& transformDelta) {
-		corium3DEngineImpl.bvh->updateNodeBPs(mobileGameLmntBvhDataNode2D, transformDelta);
+		storage.remove(storageHandle);
 	}
 
 	void Corium3DEngine::GameLmnt::GameLmntImpl::changeVerticesColors(unsigned int meshIdx, unsigned int colorsArrIdx) {
@@ -1222,11 +1624,11 @@ namespace Corium3D {
 		const BVH::RayCollisionData rayCollisionData = corium3DEngineImpl.bvh->getRayCollisionData(renderer.getCameraPos(), cursorPosVirtualScreenCoords.x*cameraRight + cursorPosVirtualScreenCoords.y*cameraUp + renderer.getFrustumNear()*cameraLookDirection);
 		if (rayCollisionData.hasCollided) {
 			corium3DEngineImpl.onRayHitCallbacks[rayCollisionData.modelIdx][rayCollisionData.instanceIdx]();
-			ServiceLocator::getLogger().logd("shoot ray", "ray hit.");
+			LOGD("shoot ray", "ray hit.");
 			return true;
 		}
 		else {
-			ServiceLocator::getLogger().logd("shoot ray", "ray missed.");
+			LOGD("shoot ray", "ray missed.");
 			return false;
 		}
 	}
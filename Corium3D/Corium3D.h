@@ -51,10 +51,40 @@ namespace Corium3D {
 		void signalSurfaceDestroyed();
 		void signalWindowFocusChanged(bool hasFocus);
 		void signalDetachedFromWindow();		
+		// when on, the loop thread sleeps until the next update tick instead of spinning through frames
+		void setLoopPacing(bool isLoopPaced);
+		// the visible nodes' AABBs and the contact manifolds, drawn over the scene. off by default
+		void setDebugGeometryRendering(bool isOn);
 		void registerKeyboardInputStartCallback(KeyboardInputID inputId, KeyboardInputCallback inputCallback);
 		void registerKeyboardInputEndCallback(KeyboardInputID inputId, KeyboardInputCallback inputCallback);
 		void registerCursorInputCallback(CursorInputID inputId, CursorInputCallback inputCallback);		
+		// blocks until the scene is loaded - preloadScene followed by commitPreloadedScene
 		std::vector<std::vector<Transform3D>> loadScene(unsigned int sceneIdx);
+		// reads the scene's assets and builds its colliders, BVH, physics and pools on a background thread, while the loaded scene
+		// (if any) keeps running. a preload in progress is cancelled
+		void preloadScene(unsigned int sceneIdx);
+		// the preload's completed fraction, in [0, 1]
+		float getScenePreloadProgress() const;
+		bool isScenePreloaded() const;
+		// waits for the background thread to stop and discards what was built
+		void cancelScenePreload();
+		// swaps the preloaded scene in place of the loaded one, waiting for the preload to finish if it has not yet.
+		// returns the scene's instances initial transforms per model, as loadScene does.
+		// the swap itself is run on the loop thread between its ticks - blocks until then when called from another thread.
+		// the camera and the registered input callbacks are kept
+		std::vector<std::vector<Transform3D>> commitPreloadedScene();
+		// REMINDER: the following apply to the loaded scene and have to be called after loadScene
+		// handlers for all the instances of modelIdx - instances' own handlers (given on construction) take precedence
+		void setModelsPairProximityHandlers(unsigned int modelIdx, unsigned int otherModelIdx, std::function<void(GameLmnt*, GameLmnt*)> collisionCallback, std::function<void(GameLmnt*, GameLmnt*)> detachmentCallback);
+		// instances of two models are tested for collision only if (layers1 & layersMask2) && (layers2 & layersMask1)
+		void setModelCollisionLayers(unsigned int modelIdx, unsigned int layers, unsigned int layersMask);
+		// the static model's instances are rasterized on the CPU to cull what they hide from the camera. meant for large, low
+		// poly models - walls, buildings, terrain. off by default
+		void setModelOccluder(unsigned int modelIdx, bool isOccluder);
+		// bytes reserved vs. used per pool and buffer of every subsystem, with high-water marks since loadScene, as JSON.
+		// collected on the loop thread between its ticks - blocks until then (up to a tick) when called from another thread
+		std::string genMemoryReportJson();
+		bool writeMemoryReportJson(std::string const& jsonFilePath);
 		GuiAPI& accessGuiAPI(unsigned int guiIdx);
 		CameraAPI& accessCameraAPI();
 
@@ -53,10 +53,10 @@ JNIEXPORT void JNICALL Java_com_corium_corium3d_Corium3DActivity_nOnDestroy(JNIE
 JNIEXPORT void JNICALL Java_com_corium_corium3d_Corium3DView_nSurfaceCreated(JNIEnv* env, jobject obj, jobject surface) {
     if (surface != NULL) {
         window = ANativeWindow_fromSurface(env, surface);
-        ServiceLocator::getLogger().logd("Corium3DAndroidLink", "Got window %p", window);
+        LOGD("Corium3DAndroidLink", "Got window %p", window);
         corium3D->signalSurfaceCreated(window);
     } else {
-        ServiceLocator::getLogger().logd("Corium3DAndroidLink", "Releasing window");
+        LOGD("Corium3DAndroidLink", "Releasing window");
         ANativeWindow_release(window);
     }
 }
@@ -103,9 +103,9 @@ inline void extractAsset(AAssetManager* apkAssetManager, const char* assetName,
             AAsset_close(asset);
             pthread_mutex_unlock(&threadMutex);
 
-            ServiceLocator::getLogger().logd("Corium3DAndroidLink", "Asset extracted: %s", assetFullPath);
+            LOGD("Corium3DAndroidLink", "Asset extracted: %s", assetFullPath);
         } else {
-            ServiceLocator::getLogger().logd("Corium3DAndroidLink", "Asset not found: %s", assetFullPath);
+            LOGD("Corium3DAndroidLink", "Asset not found: %s", assetFullPath);
             return;
         }
     //}
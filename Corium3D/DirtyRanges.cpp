@@ -0,0 +1,41 @@
+#include "DirtyRanges.h"
+
+#include <algorithm>
+
+namespace Corium3DUtils {
+
+	void DirtyRanges::markDirty(unsigned int firstIdx, unsigned int elementsNr) {
+		if (elementsNr == 0)
+			return;
+
+		// consecutive marks of consecutive elements (a batch) are merged on the spot
+		if (!marks.empty()) {
+			Range& lastMark = marks.back();
+			if (firstIdx >= lastMark.firstIdx && firstIdx <= lastMark.firstIdx + lastMark.elementsNr) {
+				lastMark.elementsNr = std::max(lastMark.elementsNr, firstIdx + elementsNr - lastMark.firstIdx);
+				return;
+			}
+		}
+		marks.push_back({ firstIdx, elementsNr });
+	}
+
+	std::vector<DirtyRanges::Range> const& DirtyRanges::coalesce() {
+		ranges.clear();
+		std::sort(marks.begin(), marks.end(), [](Range const& mark1, Range const& mark2) { return mark1.firstIdx < mark2.firstIdx; });
+		for (Range const& mark : marks) {
+			if (!ranges.empty()) {
+				Range& lastRange = ranges.back();
+				unsigned int lastRangeEndIdx = lastRange.firstIdx + lastRange.elementsNr;
+				if (mark.firstIdx <= lastRangeEndIdx + maxGapSz) {
+					lastRange.elementsNr = std::max(lastRangeEndIdx, mark.firstIdx + mark.elementsNr) - lastRange.firstIdx;
+					continue;
+				}
+			}
+			ranges.push_back(mark);
+		}
+		marks.clear();
+
+		return ranges;
+	}
+
+} // namespace Corium3DUtils
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+
+namespace Corium3DUtils {
+
+	// Tracks the elements of a buffer that were changed since its last upload, and coalesces them into few contiguous
+	// ranges - an upload call per range instead of one per changed element. Ranges that are at most maxGapSz clean
+	// elements apart are merged, as reuploading a few clean elements is cheaper than another call.
+	class DirtyRanges {
+	public:
+		struct Range {
+			unsigned int firstIdx;
+			unsigned int elementsNr;
+		};
+
+		DirtyRanges(unsigned int _maxGapSz = 0) : maxGapSz(_maxGapSz) {}
+		void markDirty(unsigned int firstIdx, unsigned int elementsNr = 1);
+		// sorted, non overlapping and more than maxGapSz elements apart. clears the marks
+		std::vector<Range> const& coalesce();
+		bool isDirty() const { return !marks.empty(); }
+		void clear() { marks.clear(); }
+
+	private:
+		unsigned int maxGapSz;
+		std::vector<Range> marks;
+		std::vector<Range> ranges;
+	};
+
+} // namespace Corium3DUtils
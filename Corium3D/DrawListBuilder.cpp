@@ -0,0 +1,499 @@
+#include "DrawListBuilder.h"
+
+#include "Profiler.h"
+#include <glm/gtx/norm.hpp>
+#include <algorithm>
+#include <cstring>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+
+namespace Corium3D {
+
+	// the 2D contact manifolds are drawn on this plane
+	const float DEBUG_GEOMETRY_2D_Z = -7.0f;
+
+	const unsigned int AABB_EDGES_VERTICES_IDXS[24] = { 0, 1, 0, 3, 1, 2, 2, 3,
+														4, 5, 4, 7, 5, 6, 6, 7,
+														0, 4, 1, 5, 2, 6, 3, 7 };
+
+	DrawListBuilder::DrawListBuilder(std::vector<ModelDescView> const& modelDescs, unsigned int _staticModelsNr, unsigned int const* modelsInstancesNrsMaxima, Corium3DUtils::ThreadPool* _threadPool) :
+			modelsNr(modelDescs.size()), staticModelsNr(_staticModelsNr), modelsProgsIdxs(modelsNr), modelsFacesNrs(modelsNr), modelsMeshesNrs(modelsNr),
+			modelsLodsNrs(modelsNr), modelsLodsScreenSzsMaxima(modelsNr * MODEL_LODS_NR_MAX, FLT_MAX), modelsMeshesDrawsBaseIdxs(modelsNr + 1),
+			modelsInstancesBaseIdxs(modelsNr + 1), threadPool(_threadPool), modelsOccludersMeshes(modelsNr), occlusionCuller(_threadPool),
+			visibleInstancesLodsCursors(modelsNr * MODEL_LODS_NR_MAX) {
+		unsigned int processedVerticesNr = 0;
+		unsigned int processedIndicesNr = 0;
+		for (unsigned int modelIdx = 0; modelIdx < modelsNr; modelIdx++) {
+			ModelDescView const& modelDesc = modelDescs[modelIdx];
+			modelsProgsIdxs[modelIdx] = modelDesc.progIdx;
+			modelsFacesNrs[modelIdx] = modelDesc.facesNr;
+			modelsMeshesNrs[modelIdx] = modelDesc.meshesNr;
+			modelsLodsNrs[modelIdx] = 1 + modelDesc.lodsDescs.size();
+			modelsMeshesDrawsBaseIdxs[modelIdx] = meshesDraws.size();
+			unsigned int modelBaseVertex = processedVerticesNr;
+			for (unsigned int meshIdx = 0; meshIdx < modelDesc.meshesNr; meshIdx++) {
+				meshesDraws.push_back({ 3 * modelDesc.facesNrsPerMesh[meshIdx], processedIndicesNr, processedVerticesNr });
+				processedVerticesNr += modelDesc.verticesNrsPerMesh[meshIdx];
+				processedIndicesNr += 3 * modelDesc.facesNrsPerMesh[meshIdx];
+			}
+			for (unsigned int lodIdx = 1; lodIdx < modelsLodsNrs[modelIdx]; lodIdx++) {
+				modelsLodsScreenSzsMaxima[modelIdx * MODEL_LODS_NR_MAX + lodIdx] = modelDesc.lodsDescs[lodIdx - 1].screenSzMax;
+				for (unsigned int meshIdx = 0; meshIdx < modelDesc.meshesNr; meshIdx++) {
+					ModelDesc::SubmeshDesc const& lodSubmeshDesc = modelDesc.lodsSubmeshesDescs[(lodIdx - 1) * modelDesc.meshesNr + meshIdx];
+					meshesDraws.push_back({ lodSubmeshDesc.idxsNr, processedIndicesNr + lodSubmeshDesc.firstIdx, modelBaseVertex + lodSubmeshDesc.baseVertex });
+				}
+			}
+			processedIndicesNr += modelDesc.lodsIdxs.size();
+
+			modelsInstancesBaseIdxs[modelIdx + 1] = modelsInstancesBaseIdxs[modelIdx] + modelsInstancesNrsMaxima[modelIdx];
+			if (modelIdx < staticModelsNr)
+				staticInstancesNrMax += modelsInstancesNrsMaxima[modelIdx];
+		}
+		modelsMeshesDrawsBaseIdxs[modelsNr] = meshesDraws.size();
+		if (meshesDraws.size() > SORT_KEY_DRAWS_NR_MAX)
+			throw std::invalid_argument("DrawListBuilder: too many meshes' draws for the draws' sort keys.");
+		if (std::any_of(modelsProgsIdxs.begin(), modelsProgsIdxs.end(), [](unsigned int progIdx) { return progIdx >= SORT_KEY_PROGS_NR_MAX; }))
+			throw std::invalid_argument("DrawListBuilder: too many programs for the draws' sort keys.");
+	}
+
+	uint64_t DrawListBuilder::genDrawSortKey(DrawPass pass, unsigned int progIdx, float depth, unsigned int drawIdx) {
+		// a camera inside of the bounding sphere
+		depth = std::max(depth, 0.0f);
+		uint32_t depthBits;
+		memcpy(&depthBits, &depth, sizeof(depthBits));
+		return (uint64_t)pass << SORT_KEY_PASS_SHIFT | (uint64_t)progIdx << SORT_KEY_PROG_SHIFT | (uint64_t)(depthBits >> 16) << SORT_KEY_DEPTH_SHIFT | drawIdx;
+	}
+
+	// the model's meshes' indices are made relative to the model's vertices
+	void DrawListBuilder::setModelOccluder(unsigned int modelIdx, ModelDescView const& modelDesc, bool isOccluder) {
+		if (modelIdx >= staticModelsNr)
+			throw std::invalid_argument("DrawListBuilder::setModelOccluder: occluders have to be of static models.");
+
+		OccluderMesh& occluderMesh = modelsOccludersMeshes[modelIdx];
+		occluderMesh.vertices.clear();
+		occluderMesh.idxs.clear();
+		occluderMesh.adjacencies.clear();
+		occludersCandidates.erase(std::remove_if(occludersCandidates.begin(), occludersCandidates.end(),
+			[modelIdx](OccluderCandidate const& occluderCandidate) { return occluderCandidate.modelIdx == modelIdx; }), occludersCandidates.end());
+		if (!isOccluder)
+			return;
+
+		for (unsigned int vertexIdx = 0; vertexIdx < modelDesc.verticesNr; vertexIdx++)
+			occluderMesh.vertices.push_back(modelDesc.vertices[vertexIdx].pos);
+		unsigned int meshBaseVertex = 0;
+		unsigned int meshFirstIdx = 0;
+		for (unsigned int meshIdx = 0; meshIdx < modelDesc.meshesNr; meshIdx++) {
+			for (unsigned int idxIdx = 0; idxIdx < 3 * modelDesc.facesNrsPerMesh[meshIdx]; idxIdx++)
+				occluderMesh.idxs.push_back(meshBaseVertex + modelDesc.idxs[meshFirstIdx + idxIdx]);
+			meshBaseVertex += modelDesc.verticesNrsPerMesh[meshIdx];
+			meshFirstIdx += 3 * modelDesc.facesNrsPerMesh[meshIdx];
+		}
+		OcclusionCuller::genTrianglesAdjacencies(occluderMesh.vertices.data(), occluderMesh.idxs.data(), occluderMesh.idxs.size(), occluderMesh.adjacencies);
+	}
+
+	void DrawListBuilder::setModelInstancesNrMax(unsigned int modelIdx, unsigned int instancesNrMax) {
+		unsigned int instancesNrMaxPrev = modelsInstancesBaseIdxs[modelIdx + 1] - modelsInstancesBaseIdxs[modelIdx];
+		if (instancesNrMax <= instancesNrMaxPrev)
+			return;
+
+		unsigned int addedInstancesNr = instancesNrMax - instancesNrMaxPrev;
+		for (unsigned int followingModelIdx = modelIdx + 1; followingModelIdx <= modelsNr; followingModelIdx++)
+			modelsInstancesBaseIdxs[followingModelIdx] += addedInstancesNr;
+		if (modelIdx < staticModelsNr)
+			staticInstancesNrMax += addedInstancesNr;
+		for (ViewResults& viewResults : viewsResults) {
+			viewResults.visibleInstancesIdxs.resize(modelsInstancesBaseIdxs[modelsNr]);
+			viewResults.visibleMobileInstancesTransformats.resize(modelsInstancesBaseIdxs[modelsNr] - staticInstancesNrMax);
+		}
+	}
+
+	void DrawListBuilder::build(ViewFrustum const* frusta, unsigned int viewsNr, BVH& bvh, glm::mat4 const* staticInstancesTransformats, bool isDebugGeometryOn) {
+		PROFILE_ZONE("DrawListBuilder::build");
+		// views are added lazily - their buffers are kept from frame to frame
+		while (viewsResults.size() < viewsNr) {
+			viewsResults.emplace_back();
+			ViewResults& viewResults = viewsResults.back();
+			viewResults.visibleInstancesIdxs.resize(modelsInstancesBaseIdxs[modelsNr]);
+			viewResults.visibleInstancesNrs.resize(modelsNr);
+			viewResults.visibleInstancesLodsFirstIdxs.resize(modelsNr * MODEL_LODS_NR_MAX);
+			viewResults.visibleInstancesLodsNrs.resize(modelsNr * MODEL_LODS_NR_MAX);
+			viewResults.visibleInstancesLodsNearestDepths.resize(modelsNr * MODEL_LODS_NR_MAX);
+			viewResults.visibleMobileInstancesTransformats.resize(modelsInstancesBaseIdxs[modelsNr] - staticInstancesNrMax);
+			viewResults.drawList.reserve(meshesDraws.size());
+		}
+		debugLinesVertices.clear();
+		debugPointsVertices.clear();
+
+		rasterizeOccluders(frusta[OCCLUSION_VIEW_IDX], staticInstancesTransformats);
+		frustaCullers.clear();
+		viewsCameras.clear();
+		cullingJobsNr = 0;
+		for (unsigned int viewIdx = 0; viewIdx < viewsNr; viewIdx++) {
+			frustaCullers.emplace_back(frusta[viewIdx]);
+			float fovHalfTan = tanf(0.5f * frusta[viewIdx].fov);
+			viewsCameras.push_back({ frusta[viewIdx].cameraPos, frusta[viewIdx].cameraLookDirection, fovHalfTan * fovHalfTan });
+			viewsResults[viewIdx].stats = Stats();
+			addCullingJobs(viewIdx, bvh.getStaticNodes3DRoot(), false);
+			addCullingJobs(viewIdx, bvh.getMobileNodes3DRoot(), true);
+		}
+		viewsResults[OCCLUSION_VIEW_IDX].stats.occludersNr = occluders.size();
+		viewsResults[OCCLUSION_VIEW_IDX].stats.occludersTrianglesNr = isOcclusionCullingOn ? occlusionCuller.getRasterizedTrianglesNr() : 0;
+
+		// a job writes its own output and its view's coherency records of its sub tree's nodes only
+		if (threadPool)
+			threadPool->parallelFor(cullingJobsNr, [this](unsigned int jobIdx) { runCullingJob(cullingJobs[jobIdx]); });
+		else {
+			for (unsigned int jobIdx = 0; jobIdx < cullingJobsNr; jobIdx++)
+				runCullingJob(cullingJobs[jobIdx]);
+		}
+
+		for (unsigned int viewIdx = 0; viewIdx < viewsNr; viewIdx++)
+			mergeCullingJobs(viewIdx, isDebugGeometryOn && viewIdx == 0);
+		if (isDebugGeometryOn)
+			addDebugNodes2D(bvh.getMobileNodes2DRoot());
+	}
+
+	// the occluders instances' transformats are read anew - the ones that moved since the last frame are rasterized where
+	// they are now
+	void DrawListBuilder::rasterizeOccluders(ViewFrustum const& frustum, glm::mat4 const* staticInstancesTransformats) {
+		occluders.clear();
+		for (OccluderCandidate const& occluderCandidate : occludersCandidates) {
+			OccluderMesh const& occluderMesh = modelsOccludersMeshes[occluderCandidate.modelIdx];
+			occluders.push_back({ occluderMesh.vertices.data(), (unsigned int)occluderMesh.vertices.size(), occluderMesh.idxs.data(), (unsigned int)occluderMesh.idxs.size(),
+								  occluderMesh.adjacencies.data(), staticInstancesTransformats[modelsInstancesBaseIdxs[occluderCandidate.modelIdx] + occluderCandidate.instanceIdx] });
+		}
+		isOcclusionCullingOn = !occluders.empty();
+		if (isOcclusionCullingOn)
+			occlusionCuller.rasterizeOccluders(frustum.vpMat, occluders.data(), occluders.size());
+	}
+
+	// culls the tree's top levels, level by level, until the untested nodes are enough for CULLING_JOBS_NR_PER_TREE jobs.
+	// the frontier is kept in the tree's pre-order, so that the jobs' outputs concatenate into the single threaded order
+	void DrawListBuilder::addCullingJobs(unsigned int viewIdx, BVH::Node3D* root, bool isMobileTree) {
+		if (root == NULL)
+			return;
+
+		FrustumCuller const& frustumCuller = frustaCullers[viewIdx];
+		Stats& stats = viewsResults[viewIdx].stats;
+		frontier.clear();
+		frontier.push_back({ root, FrustumCuller::PLANES_NO_INSIDE_MASK });
+		bool isExpandable = true;
+		while (frontier.size() < CULLING_JOBS_NR_PER_TREE && isExpandable) {
+			isExpandable = false;
+			nextFrontier.clear();
+			for (PendingNode pendingNode : frontier) {
+				BVH::Node3D* node = pendingNode.node;
+				if (node->isLeaf()) {
+					nextFrontier.push_back(pendingNode);
+					continue;
+				}
+
+				stats.nodesVisitedNr++;
+				if (!frustumCuller.cullBoundingSphere(node->getBoundingSphere(), pendingNode.insideMask, node->lastRejectingPlanesIdxs[viewIdx], stats.planeTestsNr))
+					continue;
+				if (isViewOcclusionCulled(viewIdx) && occlusionCuller.isAABBHidden(node->getAABB())) {
+					stats.occludedNodesNr++;
+					continue;
+				}
+				nextFrontier.push_back({ static_cast<BVH::Node3D*>(node->getChild(0)), pendingNode.insideMask });
+				nextFrontier.push_back({ static_cast<BVH::Node3D*>(node->getChild(1)), pendingNode.insideMask });
+				isExpandable = true;
+			}
+			frontier.swap(nextFrontier);
+		}
+
+		if (cullingJobs.size() < cullingJobsNr + frontier.size())
+			cullingJobs.resize(cullingJobsNr + frontier.size());
+		for (PendingNode pendingNode : frontier) {
+			CullingJob& job = cullingJobs[cullingJobsNr++];
+			job.root = pendingNode;
+			job.viewIdx = viewIdx;
+			job.isMobileTree = isMobileTree;
+		}
+	}
+
+	void DrawListBuilder::runCullingJob(CullingJob& job) const {
+		FrustumCuller const& frustumCuller = frustaCullers[job.viewIdx];
+		job.visibleLeaves.clear();
+		job.nodesVisitedNr = 0;
+		job.planeTestsNr = 0;
+		job.occludedNodesNr = 0;
+		bool isOcclusionCulled = isViewOcclusionCulled(job.viewIdx);
+		job.nodesStack.clear();
+		job.nodesStack.push_back(job.root);
+		while (!job.nodesStack.empty()) {
+			BVH::Node3D* node = job.nodesStack.back().node;
+			unsigned int insideMask = job.nodesStack.back().insideMask;
+			job.nodesStack.pop_back();
+			job.nodesVisitedNr++;
+			if (!frustumCuller.cullBoundingSphere(node->getBoundingSphere(), insideMask, node->lastRejectingPlanesIdxs[job.viewIdx], job.planeTestsNr))
+				continue;
+			if (isOcclusionCulled && occlusionCuller.isAABBHidden(node->getAABB())) {
+				job.occludedNodesNr++;
+				continue;
+			}
+
+			if (node->isLeaf())
+				addVisibleLeaf(node, job);
+			// the sub tree is inside of the frustum, yet parts of it may still be hidden
+			else if (insideMask == FrustumCuller::PLANES_ALL_INSIDE_MASK && !isOcclusionCulled)
+				acceptSubTree(node, job);
+			else {
+				job.nodesStack.push_back({ static_cast<BVH::Node3D*>(node->getChild(1)), insideMask });
+				job.nodesStack.push_back({ static_cast<BVH::Node3D*>(node->getChild(0)), insideMask });
+			}
+		}
+	}
+
+	// stackless - the sub tree's pre-order ends at its root's escape node
+	void DrawListBuilder::acceptSubTree(BVH::Node3D* root, CullingJob& job) const {
+		BVH::Node<AABB3DRotatable>* subTreeEscapeNode = root->getEscapeNode();
+		BVH::Node<AABB3DRotatable>* it = root->getChild(0);
+		while (it != subTreeEscapeNode) {
+			job.nodesVisitedNr++;
+			if (it->isLeaf()) {
+				addVisibleLeaf(static_cast<BVH::Node3D*>(it), job);
+				it = it->getEscapeNode();
+			}
+			else
+				it = it->getChild(0);
+		}
+	}
+
+	inline void DrawListBuilder::addVisibleLeaf(BVH::Node3D* leaf, CullingJob& job) const {
+		BVH::DataNode3D* dataLeaf = static_cast<BVH::DataNode3D*>(leaf);
+		dataLeaf->lastLodsIdxs[job.viewIdx] = selectLod(dataLeaf, job.viewIdx);
+		job.visibleLeaves.push_back(leaf);
+	}
+
+	// the finest level whose switch size the instance's bounding sphere's projected size is under. the levels up to the
+	// one the instance was drawn in last switch LOD_HYSTERESIS under their switch sizes, so that instances around a switch
+	// size do not pop between the levels from frame to frame. the sizes are compared squared
+	unsigned char DrawListBuilder::selectLod(BVH::DataNode3D const* leaf, unsigned int viewIdx) const {
+		unsigned int modelIdx = leaf->getModelIdx();
+		unsigned int lodsNr = modelsLodsNrs[modelIdx];
+		if (lodsNr == 1)
+			return 0;
+
+		ViewCamera const& viewCamera = viewsCameras[viewIdx];
+		BoundingSphere const& boundingSphere = leaf->getBoundingSphere();
+		float radiusSq = boundingSphere.getRadius() * boundingSphere.getRadius();
+		float scaledDistSq = length2(boundingSphere.getCenter() - viewCamera.cameraPos) * viewCamera.fovHalfTanSq;
+		float const* lodsScreenSzsMaxima = &modelsLodsScreenSzsMaxima[modelIdx * MODEL_LODS_NR_MAX];
+		unsigned int lastLodIdx = leaf->lastLodsIdxs[viewIdx];
+		unsigned int lodIdx = 1;
+		for (; lodIdx < lodsNr; lodIdx++) {
+			float screenSzMax = lodIdx <= lastLodIdx ? (1.0f + LOD_HYSTERESIS) * lodsScreenSzsMaxima[lodIdx] : lodsScreenSzsMaxima[lodIdx];
+			if (radiusSq >= screenSzMax * screenSzMax * scaledDistSq)
+				break;
+		}
+
+		return lodIdx - 1;
+	}
+
+	// the visible instances are counted per (model, level) first, so that they are registered straight into their model's
+	// levels' ranges
+	void DrawListBuilder::mergeCullingJobs(unsigned int viewIdx, bool isDebugGeometryOn) {
+		ViewResults& viewResults = viewsResults[viewIdx];
+		if (viewIdx == OCCLUSION_VIEW_IDX)
+			occludersCandidates.clear();
+		std::fill(viewResults.visibleInstancesLodsNrs.begin(), viewResults.visibleInstancesLodsNrs.end(), 0);
+		std::fill(viewResults.visibleInstancesLodsNearestDepths.begin(), viewResults.visibleInstancesLodsNearestDepths.end(), FLT_MAX);
+		ViewCamera const& viewCamera = viewsCameras[viewIdx];
+		for (unsigned int jobIdx = 0; jobIdx < cullingJobsNr; jobIdx++) {
+			CullingJob const& job = cullingJobs[jobIdx];
+			if (job.viewIdx != viewIdx)
+				continue;
+
+			viewResults.stats.nodesVisitedNr += job.nodesVisitedNr;
+			viewResults.stats.planeTestsNr += job.planeTestsNr;
+			viewResults.stats.occludedNodesNr += job.occludedNodesNr;
+			for (BVH::Node3D* leaf : job.visibleLeaves) {
+				BVH::DataNode3D const* dataLeaf = static_cast<BVH::DataNode3D*>(leaf);
+				viewResults.visibleInstancesLodsNrs[dataLeaf->getModelIdx() * MODEL_LODS_NR_MAX + dataLeaf->lastLodsIdxs[viewIdx]]++;
+			}
+		}
+
+		for (unsigned int modelIdx = 0; modelIdx < modelsNr; modelIdx++) {
+			unsigned int visibleInstancesNr = 0;
+			for (unsigned int lodIdx = 0; lodIdx < MODEL_LODS_NR_MAX; lodIdx++) {
+				unsigned int modelLodIdx = modelIdx * MODEL_LODS_NR_MAX + lodIdx;
+				viewResults.visibleInstancesLodsFirstIdxs[modelLodIdx] = visibleInstancesLodsCursors[modelLodIdx] = visibleInstancesNr;
+				visibleInstancesNr += viewResults.visibleInstancesLodsNrs[modelLodIdx];
+				viewResults.stats.lodsVisibleInstancesNrs[lodIdx] += viewResults.visibleInstancesLodsNrs[modelLodIdx];
+			}
+			viewResults.visibleInstancesNrs[modelIdx] = visibleInstancesNr;
+			viewResults.stats.visibleInstancesNr += visibleInstancesNr;
+		}
+
+		for (unsigned int jobIdx = 0; jobIdx < cullingJobsNr; jobIdx++) {
+			CullingJob const& job = cullingJobs[jobIdx];
+			if (job.viewIdx != viewIdx)
+				continue;
+
+			for (BVH::Node3D* leaf : job.visibleLeaves) {
+				BVH::DataNode3D* dataLeaf = static_cast<BVH::DataNode3D*>(leaf);
+				unsigned int modelIdx = dataLeaf->getModelIdx();
+				unsigned int modelLodIdx = modelIdx * MODEL_LODS_NR_MAX + dataLeaf->lastLodsIdxs[viewIdx];
+				unsigned int visibleInstanceIdx = modelsInstancesBaseIdxs[modelIdx] + visibleInstancesLodsCursors[modelLodIdx]++;
+				BoundingSphere const& boundingSphere = dataLeaf->getBoundingSphere();
+				float depth = dot(boundingSphere.getCenter() - viewCamera.cameraPos, viewCamera.cameraLookDirection) - boundingSphere.getRadius();
+				viewResults.visibleInstancesLodsNearestDepths[modelLodIdx] = std::min(viewResults.visibleInstancesLodsNearestDepths[modelLodIdx], depth);
+				if (job.isMobileTree)
+					registerVisibleInstance(viewResults, static_cast<BVH::MobileGameLmntDataNode3D*>(leaf), visibleInstanceIdx);
+				else {
+					registerVisibleInstance(viewResults, dataLeaf, visibleInstanceIdx);
+					if (viewIdx == OCCLUSION_VIEW_IDX && !modelsOccludersMeshes[modelIdx].idxs.empty())
+						addOccluderCandidate(dataLeaf);
+				}
+				if (isDebugGeometryOn)
+					addDebugGeometry(leaf);
+			}
+		}
+		if (viewIdx == OCCLUSION_VIEW_IDX)
+			selectOccluders();
+		genDrawList(viewResults);
+	}
+
+	inline void DrawListBuilder::addOccluderCandidate(BVH::DataNode3D const* leaf) {
+		BoundingSphere const& boundingSphere = leaf->getBoundingSphere();
+		float radiusSq = boundingSphere.getRadius() * boundingSphere.getRadius();
+		float distSq = std::max(length2(boundingSphere.getCenter() - viewsCameras[OCCLUSION_VIEW_IDX].cameraPos), radiusSq);
+		occludersCandidates.push_back({ leaf->getModelIdx(), leaf->getInstanceIdx(), radiusSq / distSq });
+	}
+
+	// the OCCLUDERS_NR_MAX largest on screen. ties are broken by the instances' indices, so the selection does not depend
+	// on the BVH's layout
+	void DrawListBuilder::selectOccluders() {
+		auto isLarger = [](OccluderCandidate const& candidate1, OccluderCandidate const& candidate2) {
+			if (candidate1.screenSzSq != candidate2.screenSzSq)
+				return candidate1.screenSzSq > candidate2.screenSzSq;
+			return candidate1.modelIdx != candidate2.modelIdx ? candidate1.modelIdx < candidate2.modelIdx : candidate1.instanceIdx < candidate2.instanceIdx;
+		};
+		if (occludersCandidates.size() > OCCLUDERS_NR_MAX) {
+			std::partial_sort(occludersCandidates.begin(), occludersCandidates.begin() + OCCLUDERS_NR_MAX, occludersCandidates.end(), isLarger);
+			occludersCandidates.resize(OCCLUDERS_NR_MAX);
+		}
+	}
+
+	inline void DrawListBuilder::registerVisibleInstance(ViewResults& viewResults, BVH::DataNode3D* node, unsigned int visibleInstanceIdx) {
+		viewResults.visibleInstancesIdxs[visibleInstanceIdx] = node->getInstanceIdx();
+	}
+
+	inline void DrawListBuilder::registerVisibleInstance(ViewResults& viewResults, BVH::MobileGameLmntDataNode3D* node, unsigned int visibleInstanceIdx) {
+		viewResults.visibleInstancesIdxs[visibleInstanceIdx] = node->getInstanceIdx();
+		viewResults.visibleMobileInstancesTransformats[visibleInstanceIdx - staticInstancesNrMax] = node->getMobilityInterface().getTransformat();
+	}
+
+	// the draws are listed per (model, level, mesh) and then sorted by their keys - the draw's index is its key's lowest bits
+	void DrawListBuilder::genDrawList(ViewResults& viewResults) {
+		unsortedDrawList.clear();
+		drawsSortKeys.clear();
+		Stats& stats = viewResults.stats;
+		for (unsigned int modelIdx = 0; modelIdx < modelsNr; modelIdx++) {
+			if (!viewResults.visibleInstancesNrs[modelIdx])
+				continue;
+
+			stats.fullDetailTrianglesNr += viewResults.visibleInstancesNrs[modelIdx] * modelsFacesNrs[modelIdx];
+			unsigned int meshesNr = modelsMeshesNrs[modelIdx];
+			for (unsigned int lodIdx = 0; lodIdx < modelsLodsNrs[modelIdx]; lodIdx++) {
+				unsigned int modelLodIdx = modelIdx * MODEL_LODS_NR_MAX + lodIdx;
+				unsigned int lodVisibleInstancesNr = viewResults.visibleInstancesLodsNrs[modelLodIdx];
+				if (!lodVisibleInstancesNr)
+					continue;
+
+				unsigned int lodFirstInstance = viewResults.visibleInstancesLodsFirstIdxs[modelLodIdx];
+				float lodNearestDepth = viewResults.visibleInstancesLodsNearestDepths[modelLodIdx];
+				for (unsigned int meshIdx = 0; meshIdx < meshesNr; meshIdx++) {
+					MeshDraw const& meshDraw = meshesDraws[modelsMeshesDrawsBaseIdxs[modelIdx] + lodIdx * meshesNr + meshIdx];
+					// a mesh may collapse altogether at the coarser levels
+					if (!meshDraw.idxsNr)
+						continue;
+
+					drawsSortKeys.push_back(genDrawSortKey(OPAQUE_PASS, modelsProgsIdxs[modelIdx], lodNearestDepth, unsortedDrawList.size()));
+					unsortedDrawList.push_back({ modelsProgsIdxs[modelIdx], modelIdx, meshIdx, lodIdx, meshDraw.idxsNr, meshDraw.firstIdx, meshDraw.baseVertex,
+												 lodFirstInstance, lodVisibleInstancesNr, lodNearestDepth });
+					stats.trianglesNr += meshDraw.idxsNr / 3 * lodVisibleInstancesNr;
+				}
+			}
+		}
+
+		// the draws are free to be reordered - a model's instances data is uploaded once for all of its draws
+		Corium3DUtils::radixSort(drawsSortKeys, drawsSortScratch);
+		std::vector<Draw>& drawList = viewResults.drawList;
+		drawList.clear();
+		for (uint64_t sortKey : drawsSortKeys) {
+			Draw const& draw = unsortedDrawList[sortKey & (SORT_KEY_DRAWS_NR_MAX - 1)];
+			if (drawList.empty() || drawList.back().progIdx != draw.progIdx)
+				stats.stateChangesNr++;
+			drawList.push_back(draw);
+		}
+		stats.drawsNr = drawList.size();
+	}
+
+	void DrawListBuilder::addDebugGeometry(BVH::Node3D const* node) {
+		AABB3D const& aabb = node->getAABB();
+		glm::vec3 const& cubeMin = aabb.getMinVertex();
+		glm::vec3 const& cubeMax = aabb.getMaxVertex();
+		glm::vec3 cubeVertices[8] = { cubeMin,								 { cubeMax.x, cubeMin.y, cubeMin.z },
+									  { cubeMax.x, cubeMax.y, cubeMin.z }, { cubeMin.x, cubeMax.y, cubeMin.z },
+									  { cubeMin.x, cubeMin.y, cubeMax.z }, { cubeMax.x, cubeMin.y, cubeMax.z },
+									  cubeMax,								 { cubeMin.x, cubeMax.y, cubeMax.z } };
+		for (unsigned int vertexIdxIdx = 0; vertexIdxIdx < 24; vertexIdxIdx++)
+			debugLinesVertices.push_back(cubeVertices[AABB_EDGES_VERTICES_IDXS[vertexIdxIdx]]);
+
+		if (node->collisionData3D && node->collisionData3D->contactManifold.pointsNr > 0)
+			addDebugContactManifold(node->collisionData3D->contactManifold);
+		if (node->collisionData2D && node->collisionData2D->contactManifold.pointsNr > 0)
+			addDebugContactManifold(node->collisionData2D->contactManifold);
+	}
+
+	// a single contact point is drawn as a point, more as the polygon they span. the normal is drawn out of their centroid
+	void DrawListBuilder::addDebugContactManifold(CollisionVolume::ContactManifold const& contactManifold) {
+		unsigned int pointsNr = contactManifold.pointsNr;
+		glm::vec3 centroid(0.0f);
+		if (pointsNr == 1)
+			debugPointsVertices.push_back(contactManifold.points[0]);
+		for (unsigned int pIdx = 0; pIdx < pointsNr; pIdx++) {
+			if (pointsNr > 1) {
+				debugLinesVertices.push_back(contactManifold.points[pIdx]);
+				debugLinesVertices.push_back(contactManifold.points[(pIdx + 1) % pointsNr]);
+			}
+			centroid += contactManifold.points[pIdx];
+		}
+		centroid /= pointsNr;
+		debugLinesVertices.push_back(centroid);
+		debugLinesVertices.push_back(centroid + contactManifold.normal);
+	}
+
+	void DrawListBuilder::addDebugContactManifold(CollisionPerimeter::ContactManifold const& contactManifold) {
+		CollisionVolume::ContactManifold contactManifold3D;
+		contactManifold3D.normal = glm::vec3(contactManifold.normal, 0.0f);
+		contactManifold3D.pointsNr = contactManifold.pointsNr;
+		for (unsigned int pIdx = 0; pIdx < contactManifold.pointsNr; pIdx++)
+			contactManifold3D.points[pIdx] = glm::vec3(contactManifold.points[pIdx], DEBUG_GEOMETRY_2D_Z);
+		addDebugContactManifold(contactManifold3D);
+	}
+
+	// the 2D tree is not culled - every leaf's contact manifold is drawn
+	void DrawListBuilder::addDebugNodes2D(BVH::Node2D* root) {
+		if (root == NULL)
+			return;
+
+		BVH::Node2D* it = root;
+		while (it->getChild(0) != NULL)
+			it = it->getChild(0);
+		while (it != NULL) {
+			if (it->collisionData2D && it->collisionData2D->contactManifold.pointsNr > 0)
+				addDebugContactManifold(it->collisionData2D->contactManifold);
+
+			// get next sub tree
+			for (BVH::Node2D* parent = it->getParent(); parent != NULL && parent->getChild(1) == it; it = parent, parent = it->getParent());
+			if ((it = it->getParent()) != NULL) {
+				for (it = it->getChild(1); it->getChild(0) != NULL; it = it->getChild(0));
+			}
+		}
+	}
+
+} // namespace Corium3D
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "BVH.h"
+#include "FrustumCuller.h"
+#include "OcclusionCuller.h"
+#include "ThreadPool.h"
+#include "MappedAssets.h"
+#include "RadixSort.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Corium3D {
+
+	// The CPU stage of a frame, free of GL: culls the BVH's 3D trees against views' frusta into compact per view, per model
+	// lists of the visible instances, and lists the draws of the visible models' meshes grouped by program. Optionally
+	// gathers the debug geometry (the visible nodes' AABBs and the contact manifolds) as lines and points. The renderer's GL
+	// stage only consumes the results.
+	// The culling is split into jobs - the trees' top levels are culled on the calling thread down to a frontier of sub
+	// trees, and each (view, sub tree) is a job with an output of its own. The jobs' outputs are merged in the frontier's
+	// order, so the results are the same for any threads number.
+	// Each visible instance is drawn in one of its model's levels of detail, selected by its bounding sphere's projected
+	// size. A model's visible instances are listed level after level, and a draw is listed per (model, level, mesh).
+	// The first view's nodes are culled against occluders as well - before descending into them. The occluders are the
+	// instances of the designated (static) occluder models that were visible in the last frame, the largest on screen,
+	// rasterized on the CPU at their current transformats.
+	// A view's draw list is radix sorted by the draws' sort keys - its program's draws together, front to back.
+	// REMINDER: models are indexed as the renderer indexes them - static models first
+	class DrawListBuilder {
+	public:
+		struct Draw {
+			unsigned int progIdx;
+			unsigned int modelIdx;
+			unsigned int meshIdx;
+			unsigned int lodIdx;
+			unsigned int idxsNr;
+			// into the scene's indices buffer
+			unsigned int firstIdx;
+			// into the scene's vertices buffer
+			unsigned int baseVertex;
+			// into the model's visible instances
+			unsigned int firstInstance;
+			unsigned int instancesNr;
+			// the nearest of its instances' bounding spheres, along the view's look direction
+			float depth;
+		};
+
+		struct Stats {
+			// including the nodes of sub trees that are fully inside of the frustum, which are accepted untested
+			unsigned int nodesVisitedNr = 0;
+			unsigned int planeTestsNr = 0;
+			unsigned int visibleInstancesNr = 0;
+			unsigned int lodsVisibleInstancesNrs[MODEL_LODS_NR_MAX] = {};
+			unsigned int drawsNr = 0;
+			// program binds (a VAO per program) the draw list takes
+			unsigned int stateChangesNr = 0;
+			unsigned int trianglesNr = 0;
+			// had every visible instance been drawn in full detail
+			unsigned int fullDetailTrianglesNr = 0;
+			unsigned int occludersNr = 0;
+			unsigned int occludersTrianglesNr = 0;
+			// hidden behind the occluders - their sub trees are not visited
+			unsigned int occludedNodesNr = 0;
+		};
+
+		// a level switched to a coarser one is switched back only once the projected size is this share past the switch size
+		static constexpr float LOD_HYSTERESIS = 0.1f;
+
+		// per view and tree - more jobs balance the threads better, at the cost of culling more of the trees' top levels serially
+		static const unsigned int CULLING_JOBS_NR_PER_TREE = 32;
+
+		// a draw's sort key, most significant first: its pass (2 bits), program (10 bits), depth bucket (16 bits) and its
+		// index in the unsorted list (20 bits) - keys are unique, and the sort is stable. the draws of the one pass for now,
+		// the opaque one, are sorted front to back. the depth bucket is the upper half of the depth's float bits, which order
+		// as the depths do (the bucket's size grows with the depth)
+		enum DrawPass { OPAQUE_PASS };
+		static const unsigned int SORT_KEY_PASS_SHIFT = 62;
+		static const unsigned int SORT_KEY_PROG_SHIFT = 52;
+		static const unsigned int SORT_KEY_DEPTH_SHIFT = 36;
+		static const unsigned int SORT_KEY_PROGS_NR_MAX = 1 << 10;
+		static const unsigned int SORT_KEY_DRAWS_NR_MAX = 1 << 20;
+		static uint64_t genDrawSortKey(DrawPass pass, unsigned int progIdx, float depth, unsigned int drawIdx);
+
+		static const unsigned int OCCLUSION_VIEW_IDX = 0;
+		static const unsigned int OCCLUDERS_NR_MAX = 32;
+
+		// the models' meshes are laid out in the scene's buffers one after the other, in the models' order - a model's
+		// coarser levels' indices (lodsIdxs) follow its full detail ones.
+		// threadPool - the culling's jobs are run on it (NULL - on the calling thread)
+		DrawListBuilder(std::vector<ModelDescView> const& modelDescs, unsigned int staticModelsNr, unsigned int const* modelsInstancesNrsMaxima, Corium3DUtils::ThreadPool* threadPool = NULL);
+		DrawListBuilder(DrawListBuilder const&) = delete;
+		// the model's meshes are copied (in full detail - the coarser levels are not contained in them). meant for large, low
+		// poly models that hide much of the scene behind them - walls, buildings and terrain.
+		// REMINDER: of static models only
+		void setModelOccluder(unsigned int modelIdx, ModelDescView const& modelDesc, bool isOccluder);
+		// the following models' instances are shifted - staticInstancesTransformats passed to build() are to be laid out accordingly
+		void setModelInstancesNrMax(unsigned int modelIdx, unsigned int instancesNrMax);
+		// culls for up to BVH::Node3D::CULLING_VIEWS_NR_MAX views at once. the debug geometry is gathered for the first view.
+		// staticInstancesTransformats - the static models' instances', model after model (the occluders' are read)
+		void build(ViewFrustum const* frusta, unsigned int viewsNr, BVH& bvh, glm::mat4 const* staticInstancesTransformats, bool isDebugGeometryOn);
+		// ordered by the instances' levels of detail
+		unsigned int const* getVisibleInstancesIdxs(unsigned int viewIdx, unsigned int modelIdx) const { return &viewsResults[viewIdx].visibleInstancesIdxs[modelsInstancesBaseIdxs[modelIdx]]; }
+		unsigned int getVisibleInstancesNr(unsigned int viewIdx, unsigned int modelIdx) const { return viewsResults[viewIdx].visibleInstancesNrs[modelIdx]; }
+		// of mobile models only - ordered as getVisibleInstancesIdxs()
+		glm::mat4 const* getVisibleInstancesTransformats(unsigned int viewIdx, unsigned int modelIdx) const { return &viewsResults[viewIdx].visibleMobileInstancesTransformats[modelsInstancesBaseIdxs[modelIdx] - staticInstancesNrMax]; }
+		std::vector<Draw> const& getDrawList(unsigned int viewIdx) const { return viewsResults[viewIdx].drawList; }
+		// pairs of vertices
+		std::vector<glm::vec3> const& getDebugLinesVertices() const { return debugLinesVertices; }
+		std::vector<glm::vec3> const& getDebugPointsVertices() const { return debugPointsVertices; }
+		Stats const& getStats(unsigned int viewIdx) const { return viewsResults[viewIdx].stats; }
+
+	private:
+		struct MeshDraw {
+			unsigned int idxsNr;
+			unsigned int firstIdx;
+			unsigned int baseVertex;
+		};
+
+		unsigned int modelsNr;
+		unsigned int staticModelsNr;
+		unsigned int staticInstancesNrMax = 0;
+		std::vector<unsigned int> modelsProgsIdxs;
+		std::vector<unsigned int> modelsFacesNrs;
+		std::vector<unsigned int> modelsMeshesNrs;
+		std::vector<unsigned int> modelsLodsNrs;
+		// [modelIdx * MODEL_LODS_NR_MAX + lodIdx] - the full detail level's is unused
+		std::vector<float> modelsLodsScreenSzsMaxima;
+		// a model's mesh draws are laid out level after level: [modelsMeshesDrawsBaseIdxs[modelIdx] + lodIdx * meshesNr + meshIdx]
+		std::vector<unsigned int> modelsMeshesDrawsBaseIdxs;
+		std::vector<MeshDraw> meshesDraws;
+
+		std::vector<unsigned int> modelsInstancesBaseIdxs;
+		Corium3DUtils::ThreadPool* threadPool;
+
+		// empty for models that are not occluders
+		struct OccluderMesh {
+			std::vector<glm::vec3> vertices;
+			std::vector<unsigned int> idxs;
+			std::vector<unsigned int> adjacencies;
+		};
+		std::vector<OccluderMesh> modelsOccludersMeshes;
+		// the next frame's occluders - screenSzSq is the projected size the instance was selected by
+		struct OccluderCandidate {
+			unsigned int modelIdx;
+			unsigned int instanceIdx;
+			float screenSzSq;
+		};
+		std::vector<OccluderCandidate> occludersCandidates;
+		std::vector<OcclusionCuller::Occluder> occluders;
+		OcclusionCuller occlusionCuller;
+		bool isOcclusionCullingOn = false;
+
+		struct ViewResults {
+			std::vector<unsigned int> visibleInstancesIdxs;
+			std::vector<unsigned int> visibleInstancesNrs;
+			// [modelIdx * MODEL_LODS_NR_MAX + lodIdx], the first ones into the model's visible instances
+			std::vector<unsigned int> visibleInstancesLodsFirstIdxs;
+			std::vector<unsigned int> visibleInstancesLodsNrs;
+			std::vector<float> visibleInstancesLodsNearestDepths;
+			std::vector<glm::mat4> visibleMobileInstancesTransformats;
+			std::vector<Draw> drawList;
+			Stats stats;
+		};
+		std::vector<ViewResults> viewsResults;
+		std::vector<glm::vec3> debugLinesVertices;
+		std::vector<glm::vec3> debugPointsVertices;
+
+		// a node pending its test, with the mask of the planes its parent is fully inside of
+		struct PendingNode {
+			BVH::Node3D* node;
+			unsigned int insideMask;
+		};
+
+		// culls a sub tree for a view. its output is the sub tree's visible leaves in pre-order
+		struct CullingJob {
+			PendingNode root;
+			unsigned int viewIdx;
+			bool isMobileTree;
+			std::vector<BVH::Node3D*> visibleLeaves;
+			std::vector<PendingNode> nodesStack;
+			unsigned int nodesVisitedNr;
+			unsigned int planeTestsNr;
+			unsigned int occludedNodesNr;
+		};
+		std::vector<FrustumCuller> frustaCullers;
+		// the views' parameters for the levels of detail selection and the draws' depths
+		struct ViewCamera {
+			glm::vec3 cameraPos;
+			glm::vec3 cameraLookDirection;
+			// the projected size (a share of the viewport's height) is radius / (dist * tan(fov / 2))
+			float fovHalfTanSq;
+		};
+		std::vector<ViewCamera> viewsCameras;
+		std::vector<unsigned int> visibleInstancesLodsCursors;
+		std::vector<Draw> unsortedDrawList;
+		std::vector<uint64_t> drawsSortKeys;
+		std::vector<uint64_t> drawsSortScratch;
+		std::vector<CullingJob> cullingJobs;
+		unsigned int cullingJobsNr = 0;
+		std::vector<PendingNode> frontier;
+		std::vector<PendingNode> nextFrontier;
+
+		void rasterizeOccluders(ViewFrustum const& frustum, glm::mat4 const* staticInstancesTransformats);
+		bool isViewOcclusionCulled(unsigned int viewIdx) const { return viewIdx == OCCLUSION_VIEW_IDX && isOcclusionCullingOn; }
+		void addCullingJobs(unsigned int viewIdx, BVH::Node3D* root, bool isMobileTree);
+		void runCullingJob(CullingJob& job) const;
+		void acceptSubTree(BVH::Node3D* root, CullingJob& job) const;
+		void addVisibleLeaf(BVH::Node3D* leaf, CullingJob& job) const;
+		unsigned char selectLod(BVH::DataNode3D const* leaf, unsigned int viewIdx) const;
+		void mergeCullingJobs(unsigned int viewIdx, bool isDebugGeometryOn);
+		void addOccluderCandidate(BVH::DataNode3D const* leaf);
+		void selectOccluders();
+		void registerVisibleInstance(ViewResults& viewResults, BVH::DataNode3D* node, unsigned int visibleInstanceIdx);
+		void registerVisibleInstance(ViewResults& viewResults, BVH::MobileGameLmntDataNode3D* node, unsigned int visibleInstanceIdx);
+		void genDrawList(ViewResults& viewResults);
+		void addDebugGeometry(BVH::Node3D const* node);
+		void addDebugContactManifold(CollisionVolume::ContactManifold const& contactManifold);
+		void addDebugContactManifold(CollisionPerimeter::ContactManifold const& contactManifold);
+		void addDebugNodes2D(BVH::Node2D* root);
+	};
+
+} // namespace Corium3D
@@ -0,0 +1,51 @@
+#include "FrameRing.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Corium3DUtils {
+
+	FrameRing::FrameRing(unsigned int _regionsNr, size_t _regionSz, size_t _regionAlignment) :
+			regionsNr(_regionsNr), regionSz((_regionSz + _regionAlignment - 1) / _regionAlignment * _regionAlignment), regionAlignment(_regionAlignment),
+			regionsInFlight(_regionsNr, false), regionIdx(_regionsNr - 1) {
+		if (regionsNr == 0 || regionAlignment == 0 || (regionAlignment & (regionAlignment - 1)))
+			throw std::invalid_argument("FrameRing: regionsNr must be positive and regionAlignment a power of 2");
+	}
+
+	bool FrameRing::beginFrame() {
+		if (isFrameOpen)
+			endFrame();
+
+		unsigned int nextRegionIdx = getNextRegionIdx();
+		if (regionsInFlight[nextRegionIdx])
+			return false;
+
+		regionIdx = nextRegionIdx;
+		frameAllocatedSz = 0;
+		isFrameOpen = true;
+		return true;
+	}
+
+	size_t FrameRing::allocate(size_t sz, size_t alignment) {
+		if (!isFrameOpen || alignment > regionAlignment)
+			return ALLOCATION_FAILED;
+
+		// the regions' bases are aligned to regionAlignment - aligning within the region aligns within the buffer
+		size_t allocationOffset = (frameAllocatedSz + alignment - 1) & ~(alignment - 1);
+		if (allocationOffset > regionSz || sz > regionSz - allocationOffset)
+			return ALLOCATION_FAILED;
+
+		frameAllocatedSz = allocationOffset + sz;
+		frameAllocatedSzMax = std::max(frameAllocatedSzMax, frameAllocatedSz);
+		return regionIdx * regionSz + allocationOffset;
+	}
+
+	void FrameRing::endFrame() {
+		if (!isFrameOpen)
+			return;
+
+		regionsInFlight[regionIdx] = true;
+		isFrameOpen = false;
+	}
+
+} // namespace Corium3DUtils
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace Corium3DUtils {
+
+	// Bookkeeping of a buffer that is split into regionsNr frame regions and written by the CPU while the GPU reads the
+	// previous frames' regions. A frame's data is sub-allocated in its region by a bump pointer. A frame's region is in
+	// flight from the frame's end until it is retired (its fence was waited on) - it is not to be written before then.
+	// The offsets are from the buffer's start. The buffer itself (and the fences) are its user's.
+	class FrameRing {
+	public:
+		static const size_t ALLOCATION_FAILED = (size_t)-1;
+
+		// regionSz is rounded up to regionAlignment - the alignment the allocations are allowed to ask for, at most
+		FrameRing(unsigned int regionsNr, size_t regionSz, size_t regionAlignment = 1);
+		unsigned int getRegionsNr() const { return regionsNr; }
+		size_t getRegionSz() const { return regionSz; }
+		size_t getBufferSz() const { return regionsNr * regionSz; }
+
+		// the region the next frame is written to
+		unsigned int getNextRegionIdx() const { return (regionIdx + 1) % regionsNr; }
+		bool isRegionInFlight(unsigned int regionIdx) const { return regionsInFlight[regionIdx]; }
+		void retireRegion(unsigned int regionIdx) { regionsInFlight[regionIdx] = false; }
+		// returns false if the next region is still in flight
+		bool beginFrame();
+		// alignment is a power of 2. returns ALLOCATION_FAILED if the frame's region is out of space
+		size_t allocate(size_t sz, size_t alignment = 1);
+		// the frame's region is in flight once it ends
+		void endFrame();
+		// the open (or the last) frame's
+		unsigned int getRegionIdx() const { return regionIdx; }
+		size_t getRegionOffset() const { return regionIdx * regionSz; }
+		size_t getFrameAllocatedSz() const { return frameAllocatedSz; }
+		size_t getFrameAllocatedSzMax() const { return frameAllocatedSzMax; }
+
+	private:
+		unsigned int regionsNr;
+		size_t regionSz;
+		size_t regionAlignment;
+		std::vector<bool> regionsInFlight;
+		unsigned int regionIdx;
+		bool isFrameOpen = false;
+		size_t frameAllocatedSz = 0;
+		size_t frameAllocatedSzMax = 0;
+	};
+
+} // namespace Corium3DUtils
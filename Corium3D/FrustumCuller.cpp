@@ -0,0 +1,115 @@
+#include "FrustumCuller.h"
+
+#include <glm/gtx/norm.hpp>
+#include <cfloat>
+#include <cmath>
+
+#ifdef CORIUM3D_FRUSTUM_CULLER_SSE
+	#include <emmintrin.h>
+#endif
+
+namespace Corium3D {
+
+	inline unsigned int countPlanes(unsigned int planesMask) {
+		unsigned int planesNr = 0;
+		for (; planesMask; planesMask &= planesMask - 1)
+			planesNr++;
+		return planesNr;
+	}
+
+	inline unsigned char lowestPlaneIdx(unsigned int planesMask) {
+		unsigned char planeIdx = 0;
+		for (; !(planesMask & 1); planesMask >>= 1)
+			planeIdx++;
+		return planeIdx;
+	}
+
+	FrustumCuller::FrustumCuller(ViewFrustum const& _frustum) : frustum(_frustum) {
+		for (unsigned int planeIdx = 0; planeIdx < 4 * PLANES_GROUPS_NR; planeIdx++) {
+			if (planeIdx < ViewFrustum::PLANES_NR) {
+				ViewFrustum::Plane const& plane = frustum.planes[planeIdx];
+				planesNormalsXs[planeIdx] = plane.normal.x;
+				planesNormalsYs[planeIdx] = plane.normal.y;
+				planesNormalsZs[planeIdx] = plane.normal.z;
+				planesDs[planeIdx] = plane.d;
+			}
+			else {
+				planesNormalsXs[planeIdx] = planesNormalsYs[planeIdx] = planesNormalsZs[planeIdx] = 0.0f;
+				planesDs[planeIdx] = -FLT_MAX;
+			}
+		}
+	}
+
+	bool FrustumCuller::cullBoundingSphere(BoundingSphere const& boundingSphere, unsigned int& inOutInsideMask, unsigned char& inOutLastRejectingPlaneIdx, unsigned int& planeTestsNr) const {
+		if (inOutInsideMask == PLANES_ALL_INSIDE_MASK)
+			return true;
+
+		glm::vec3 const& sphereC = boundingSphere.getCenter();
+		float sphereR = boundingSphere.getRadius();
+		unsigned int lastRejectingPlaneMask = 1 << inOutLastRejectingPlaneIdx;
+		unsigned int insidePlanesMask = 0;
+		if (!(inOutInsideMask & lastRejectingPlaneMask)) {
+			planeTestsNr++;
+			float dist = frustum.planes[inOutLastRejectingPlaneIdx].signedDistFromPoint(sphereC);
+			if (dist > sphereR)
+				return false;
+			else if (dist < -sphereR)
+				insidePlanesMask |= lastRejectingPlaneMask;
+		}
+
+		unsigned int testedPlanesMask = PLANES_ALL_INSIDE_MASK & ~(inOutInsideMask | lastRejectingPlaneMask);
+		unsigned int outsidePlanesMask = 0;
+	#ifdef CORIUM3D_FRUSTUM_CULLER_SSE
+		__m128 cXs = _mm_set1_ps(sphereC.x);
+		__m128 cYs = _mm_set1_ps(sphereC.y);
+		__m128 cZs = _mm_set1_ps(sphereC.z);
+		__m128 rs = _mm_set1_ps(sphereR);
+		__m128 negRs = _mm_set1_ps(-sphereR);
+		for (unsigned int groupIdx = 0; groupIdx < PLANES_GROUPS_NR; groupIdx++) {
+			if (!((testedPlanesMask >> (4 * groupIdx)) & 0xF))
+				continue;
+
+			__m128 dists = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(planesNormalsXs + 4 * groupIdx), cXs), _mm_mul_ps(_mm_loadu_ps(planesNormalsYs + 4 * groupIdx), cYs)),
+									  _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(planesNormalsZs + 4 * groupIdx), cZs), _mm_loadu_ps(planesDs + 4 * groupIdx)));
+			outsidePlanesMask |= (unsigned int)_mm_movemask_ps(_mm_cmpgt_ps(dists, rs)) << (4 * groupIdx);
+			insidePlanesMask |= (unsigned int)_mm_movemask_ps(_mm_cmplt_ps(dists, negRs)) << (4 * groupIdx);
+		}
+	#else
+		for (unsigned int planeIdx = 0; planeIdx < ViewFrustum::PLANES_NR; planeIdx++) {
+			if (!(testedPlanesMask & (1 << planeIdx)))
+				continue;
+
+			float dist = planesNormalsXs[planeIdx] * sphereC.x + planesNormalsYs[planeIdx] * sphereC.y + planesNormalsZs[planeIdx] * sphereC.z + planesDs[planeIdx];
+			if (dist > sphereR)
+				outsidePlanesMask |= 1 << planeIdx;
+			else if (dist < -sphereR)
+				insidePlanesMask |= 1 << planeIdx;
+		}
+	#endif
+		// the planes were all tested at once - the ones already known to be passed are masked out of the results
+		planeTestsNr += countPlanes(testedPlanesMask);
+		outsidePlanesMask &= testedPlanesMask;
+		if (outsidePlanesMask) {
+			inOutLastRejectingPlaneIdx = lowestPlaneIdx(outsidePlanesMask);
+			return false;
+		}
+
+		inOutInsideMask |= insidePlanesMask & PLANES_ALL_INSIDE_MASK;
+		// the cone is tighter than the planes around the frustum's edges. a sphere inside of all of the planes is inside of it
+		return inOutInsideMask == PLANES_ALL_INSIDE_MASK || isInCone(sphereC, sphereR);
+	}
+
+	bool FrustumCuller::isInCone(glm::vec3 const& sphereC, float sphereR) const {
+		glm::vec3 u = frustum.cameraPos - sphereR*frustum.cameraLookDirection/frustum.fovSin;
+		glm::vec3 d = sphereC - u;
+		float e = dot(frustum.cameraLookDirection, d);
+		if (e > 0 && e*e >= length2(d)*cos(frustum.fov)) {
+			d = sphereC - frustum.cameraPos;
+			e = -dot(frustum.cameraLookDirection, d);
+			return !(e > 0 && e*e >= length2(d)*sin(frustum.fov) && length2(d) > sphereR * sphereR);
+		}
+		else
+			return false;
+	}
+
+} // namespace Corium3D
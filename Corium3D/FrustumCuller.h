@@ -0,0 +1,62 @@
+#pragma once
+
+#include "BoundingSphere.h"
+
+#include <glm/glm.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86_FP) && _M_IX86_FP >= 2
+	#define CORIUM3D_FRUSTUM_CULLER_SSE
+#endif
+
+namespace Corium3D {
+
+	// A view's culling volume - the frustum's planes, with their normals pointing out, and the cone enclosing the frustum
+	struct ViewFrustum {
+		struct Plane {
+			glm::vec3 normal;
+			float d;
+
+			void updateD(glm::vec3 const& newPointOnPlane) { d = -glm::dot(normal, newPointOnPlane); }
+			float signedDistFromPoint(glm::vec3 const& point) const { return glm::dot(normal, point) + d; }
+		};
+
+		enum PlaneIdx { NEAR_PLANE, FAR_PLANE, LEFT_PLANE, RIGHT_PLANE, TOP_PLANE, BOT_PLANE, PLANES_NR };
+
+		Plane planes[PLANES_NR];
+		glm::vec3 cameraPos;
+		glm::vec3 cameraLookDirection;
+		// vertical, the whole angle
+		float fov;
+		float fovSin;
+		// projection * view - the occluders are rasterized with it
+		glm::mat4 vpMat;
+	};
+
+	// Tests bounding spheres against all of a frustum's planes at once (SSE, where available) for hierarchical culling.
+	// A sphere's test yields the mask of the planes it is fully inside of - its BV descendants are inside of them as well, so
+	// they are not tested against them again, and a sphere inside of all of them is accepted along with its whole sub tree.
+	// A rejection records the rejecting plane, which is tested first on the sphere's next test (coherency across frames).
+	class FrustumCuller {
+	public:
+		static const unsigned int PLANES_NO_INSIDE_MASK = 0;
+		static const unsigned int PLANES_ALL_INSIDE_MASK = (1 << ViewFrustum::PLANES_NR) - 1;
+
+		FrustumCuller(ViewFrustum const& frustum);
+		// returns false if the sphere is outside of the frustum. else adds the planes the sphere is fully inside of to
+		// inOutInsideMask (the mask of its BV ancestor). inOutLastRejectingPlaneIdx is the sphere's coherency record
+		bool cullBoundingSphere(BoundingSphere const& boundingSphere, unsigned int& inOutInsideMask, unsigned char& inOutLastRejectingPlaneIdx, unsigned int& planeTestsNr) const;
+
+	private:
+		// 2 groups of 4 - the 2 padding planes have every point inside of them
+		static const unsigned int PLANES_GROUPS_NR = 2;
+
+		ViewFrustum frustum;
+		float planesNormalsXs[4 * PLANES_GROUPS_NR];
+		float planesNormalsYs[4 * PLANES_GROUPS_NR];
+		float planesNormalsZs[4 * PLANES_GROUPS_NR];
+		float planesDs[4 * PLANES_GROUPS_NR];
+
+		bool isInCone(glm::vec3 const& sphereC, float sphereR) const;
+	};
+
+} // namespace Corium3D
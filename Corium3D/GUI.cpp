@@ -133,6 +133,15 @@ namespace Corium3D {
 		delete[] atlases;
 	}
 
+	void GUI::reportMemory(Corium3DUtils::MemoryReport& memoryReport, std::string const& subsystem) const {
+		unsigned int controlsNrTotal = imgsControlsNr + txtControlsNr;
+		memoryReport.addGpuBuffer(subsystem, "controlsTex", TEXES_WIDTH * TEXES_HEIGHT * 4, controlsNrTotal);
+		memoryReport.addGpuBuffer(subsystem, "quadsBuffer", 12 * sizeof(float), quadsNrDemanded);
+		memoryReport.addGpuBuffer(subsystem, "uvsBuffer", 12 * sizeof(float), quadsNrDemanded);
+		memoryReport.addGpuBuffer(subsystem, "texIdxsBuffer", sizeof(int), controlsNrTotal);
+		memoryReport.addGpuBuffer(subsystem, "controlsIdxsBuffer", sizeof(unsigned int), quadsNrDemanded);
+	}
+
 	bool GUI::initOpenGlLmnts(unsigned int winWidth, unsigned int winHeight) {
 		glGenVertexArrays(2, vaos);
 		CHECK_GL_ERROR("glGenVertexArrays");
@@ -174,11 +183,11 @@ namespace Corium3D {
 		for (unsigned int atlasIdx = 0; atlasIdx < atlasesNr; atlasIdx++) {
 			unsigned int res = lodepng_decode_file(&texData, &texWidth, &texHeight, atlases[atlasIdx]->getAtlasPath().c_str(), LCT_RGBA, 8);
 			if (res) {
-				ServiceLocator::getLogger().loge("GUI", lodepng_error_text(res));
+				LOGE("GUI", "%s", lodepng_error_text(res));
 				return false;
 			}
 			else if (texWidth != TEXES_WIDTH || texHeight != TEXES_HEIGHT) {
-				ServiceLocator::getLogger().loge("GUI", "texture %s is of an invalid size.", atlases[atlasIdx]->getAtlasPath().c_str());
+				LOGE("GUI", "texture %s is of an invalid size.", atlases[atlasIdx]->getAtlasPath().c_str());
 				return false;
 			}
 			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, atlasIdx, TEXES_WIDTH, TEXES_HEIGHT, 1, GL_RGBA, GL_UNSIGNED_BYTE, texData);
@@ -7,6 +7,7 @@
 #include "OpenGL.h"
 #include "ImgsAtlas.h"
 #include "TransformsStructs.h"
+#include "MemoryReport.h"
 
 #include <vector>
 #include <string>
@@ -112,6 +113,7 @@ namespace Corium3D {
 			return *((TxtControl*)controls[imgsControlsNr + controlIdx]);
 		}
 
+		void reportMemory(Corium3DUtils::MemoryReport& memoryReport, std::string const& subsystem) const;
 		void show() { isActive = true; }
 		void hide() { isActive = false; }
 
@@ -0,0 +1,80 @@
+#include "GameLmntsStorage.h"
+
+namespace Corium3D {
+
+	GameLmntsStorage::GameLmntsStorage(unsigned int lmntsNrInitial) : handlesPool(lmntsNrInitial), handlesRecords(handlesPool.getCapacity()) {}
+
+	GameLmntsStorage::Handle GameLmntsStorage::add(unsigned int components, Row const& row) {
+#if DEBUG
+		if (components >= ARCHETYPES_NR)
+			throw std::invalid_argument("Invalid components flag.");
+#endif
+		Handle handle = handlesPool.acquire();
+		if (handlesRecords.size() < handlesPool.getCapacity())
+			handlesRecords.resize(handlesPool.getCapacity());
+
+		Archetype& archetype = archetypes[components];
+		handlesRecords[handle] = { components, archetype.getLmntsNr() };
+		archetype.transforms.push_back(row.transform);
+		archetype.transformDeltas.push_back(Transform3DUS());
+		archetype.transform2DRotDeltas.push_back(std::complex<float>(1.0f, 0.0f));
+		archetype.mobilityInterfaces.push_back(row.mobilityInterface);
+		archetype.collisionVolumes.push_back(row.collisionVolume);
+		archetype.collisionPerimeters.push_back(row.collisionPerimeter);
+		archetype.bvhDataNodes3D.push_back(row.bvhDataNode3D);
+		archetype.bvhDataNodes2D.push_back(row.bvhDataNode2D);
+		archetype.modelIdxs.push_back(row.modelIdx);
+		archetype.instanceIdxs.push_back(row.instanceIdx);
+		archetype.handles.push_back(handle);
+		if (archetype.lmntsNrMax < archetype.getLmntsNr())
+			archetype.lmntsNrMax = archetype.getLmntsNr();
+
+		return handle;
+	}
+
+	void GameLmntsStorage::remove(Handle handle) {
+		handlesPool.release(handle);
+		HandleRecord const& record = handlesRecords[handle];
+		Archetype& archetype = archetypes[record.components];
+		unsigned int rowIdx = record.rowIdx;
+		unsigned int lastRowIdx = archetype.getLmntsNr() - 1;
+		if (rowIdx != lastRowIdx) {
+			archetype.transforms[rowIdx] = archetype.transforms[lastRowIdx];
+			archetype.transformDeltas[rowIdx] = archetype.transformDeltas[lastRowIdx];
+			archetype.transform2DRotDeltas[rowIdx] = archetype.transform2DRotDeltas[lastRowIdx];
+			archetype.mobilityInterfaces[rowIdx] = archetype.mobilityInterfaces[lastRowIdx];
+			archetype.collisionVolumes[rowIdx] = archetype.collisionVolumes[lastRowIdx];
+			archetype.collisionPerimeters[rowIdx] = archetype.collisionPerimeters[lastRowIdx];
+			archetype.bvhDataNodes3D[rowIdx] = archetype.bvhDataNodes3D[lastRowIdx];
+			archetype.bvhDataNodes2D[rowIdx] = archetype.bvhDataNodes2D[lastRowIdx];
+			archetype.modelIdxs[rowIdx] = archetype.modelIdxs[lastRowIdx];
+			archetype.instanceIdxs[rowIdx] = archetype.instanceIdxs[lastRowIdx];
+			archetype.handles[rowIdx] = archetype.handles[lastRowIdx];
+			handlesRecords[archetype.handles[rowIdx]].rowIdx = rowIdx;
+		}
+
+		archetype.transforms.pop_back();
+		archetype.transformDeltas.pop_back();
+		archetype.transform2DRotDeltas.pop_back();
+		archetype.mobilityInterfaces.pop_back();
+		archetype.collisionVolumes.pop_back();
+		archetype.collisionPerimeters.pop_back();
+		archetype.bvhDataNodes3D.pop_back();
+		archetype.bvhDataNodes2D.pop_back();
+		archetype.modelIdxs.pop_back();
+		archetype.instanceIdxs.pop_back();
+		archetype.handles.pop_back();
+	}
+
+	void GameLmntsStorage::reportMemory(Corium3DUtils::MemoryReport& memoryReport) const {
+		const size_t rowSz = sizeof(Transform3D) + sizeof(Transform3DUS) + sizeof(std::complex<float>) + sizeof(PhysicsEngine::MobilityInterface*) + sizeof(CollisionVolume*) + sizeof(CollisionPerimeter*) +
+			sizeof(BVH::DataNode3D*) + sizeof(BVH::DataNode2D*) + 2 * sizeof(unsigned int) + sizeof(Handle);
+		for (unsigned int components = 0; components < ARCHETYPES_NR; components++) {
+			Archetype const& archetype = archetypes[components];
+			if (archetype.lmntsNrMax > 0)
+				memoryReport.addEntry("GameLmnts", std::string("archetype#") + std::to_string(components), rowSz, archetype.handles.capacity(), archetype.getLmntsNr(), archetype.lmntsNrMax);
+		}
+		memoryReport.addEntry("GameLmnts", "storageHandles", sizeof(HandleRecord), handlesRecords.size(), handlesPool.getAcquiredIdxsNr(), handlesPool.getAcquiredIdxsNrMax());
+	}
+
+} // namespace Corium3D
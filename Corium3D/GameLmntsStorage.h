@@ -0,0 +1,78 @@
+#pragma once
+
+#include "IdxPool.h"
+#include "PhysicsEngine.h"
+#include "CollisionPrimitives.h"
+#include "BVH.h"
+#include "MemoryReport.h"
+
+#include <complex>
+#include <vector>
+
+namespace Corium3D {
+
+	// Archetype storage of the game elements' per-tick data - every distinct components flag owns packed (SoA)
+	// columns that the systems iterate linearly. Removal swaps the archetype's last row into the removed one,
+	// so the columns stay dense, while handles stay valid until their own element is removed.
+	class GameLmntsStorage {
+	public:
+		typedef unsigned int Handle;
+
+		// components flags are Corium3DEngine::GameLmnt::Component combinations
+		static const unsigned int ARCHETYPES_NR = 8;
+
+		struct Row {
+			Transform3D transform;
+			PhysicsEngine::MobilityInterface* mobilityInterface = NULL;
+			CollisionVolume* collisionVolume = NULL;
+			CollisionPerimeter* collisionPerimeter = NULL;
+			// the mobile elements' nodes are BVH::MobileGameLmntDataNode3D/2D
+			BVH::DataNode3D* bvhDataNode3D = NULL;
+			BVH::DataNode2D* bvhDataNode2D = NULL;
+			unsigned int modelIdx = 0;
+			unsigned int instanceIdx = 0;
+		};
+
+		struct Archetype {
+			// by value - the mobile ones are written by the physics update and read by the BVH refit
+			std::vector<Transform3D> transforms;
+			std::vector<Transform3DUS> transformDeltas;
+			std::vector<std::complex<float>> transform2DRotDeltas;
+			std::vector<PhysicsEngine::MobilityInterface*> mobilityInterfaces;
+			std::vector<CollisionVolume*> collisionVolumes;
+			std::vector<CollisionPerimeter*> collisionPerimeters;
+			std::vector<BVH::DataNode3D*> bvhDataNodes3D;
+			std::vector<BVH::DataNode2D*> bvhDataNodes2D;
+			std::vector<unsigned int> modelIdxs;
+			std::vector<unsigned int> instanceIdxs;
+			std::vector<Handle> handles;
+			// high-water mark since construction
+			unsigned int lmntsNrMax = 0;
+
+			unsigned int getLmntsNr() const { return (unsigned int)handles.size(); }
+		};
+
+		GameLmntsStorage(unsigned int lmntsNrInitial);
+		GameLmntsStorage(GameLmntsStorage const&) = delete;
+		Handle add(unsigned int components, Row const& row);
+		void remove(Handle handle);
+		Archetype& accessArchetype(unsigned int components) { return archetypes[components]; }
+		Archetype const& accessArchetype(unsigned int components) const { return archetypes[components]; }
+		unsigned int getComponents(Handle handle) const { return handlesRecords[handle].components; }
+		// REMINDER: row indices change when other elements of the archetype are removed - don't keep them
+		unsigned int getRowIdx(Handle handle) const { return handlesRecords[handle].rowIdx; }
+		unsigned int getLmntsNr() const { return handlesPool.getAcquiredIdxsNr(); }
+		void reportMemory(Corium3DUtils::MemoryReport& memoryReport) const;
+
+	private:
+		struct HandleRecord {
+			unsigned int components;
+			unsigned int rowIdx;
+		};
+
+		Archetype archetypes[ARCHETYPES_NR];
+		Corium3DUtils::ChunkedIdxPool handlesPool;
+		std::vector<HandleRecord> handlesRecords;
+	};
+
+} // namespace Corium3D
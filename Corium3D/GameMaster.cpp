@@ -126,7 +126,7 @@ GameMaster::GameMaster(Corium3DEngine& _corium3Dengine) : corium3DEngine(_corium
 	Corium3DEngine::GameLmnt::ProximityHandlingMethods coloringCallbacksBuffer[] =
 		{ coloringCallbacks, coloringCallbacks, coloringCallbacks, coloringCallbacks };
 
-	ServiceLocator::getLogger().logd("GameMaster", "creating the primitives.");
+	LOGD("GameMaster", "creating the primitives.");
 	
 
 	//Scene C
@@ -1,5 +1,7 @@
 #include "IdxPool.h"
 
+#include <cstring>
+
 namespace Corium3DUtils {
 
 	IdxPool::IdxPool(unsigned int _poolSz) : poolSz(_poolSz) {
@@ -12,7 +14,7 @@ namespace Corium3DUtils {
 	}
 
 	IdxPool::IdxPool(IdxPool const& idxPool) : 
-		poolSz(idxPool.poolSz), availableIdx(idxPool.availableIdx), acquiredIdxsNr(idxPool.acquiredIdxsNr) {
+		poolSz(idxPool.poolSz), availableIdx(idxPool.availableIdx), acquiredIdxsNr(idxPool.acquiredIdxsNr), acquiredIdxsNrMax(idxPool.acquiredIdxsNrMax) {
 #if DEBUG
 		acquiredIdxsLogicalVec = new bool[idxPool.poolSz];
 		memcpy(acquiredIdxsLogicalVec, idxPool.acquiredIdxsLogicalVec, idxPool.poolSz * sizeof(bool));
@@ -38,6 +40,8 @@ namespace Corium3DUtils {
 		acquiredIdxsLogicalVec[returnedIdx] = true;
 #endif
 		acquiredIdxsNr++;
+		if (acquiredIdxsNrMax < acquiredIdxsNr)
+			acquiredIdxsNrMax = acquiredIdxsNr;
 		return returnedIdx;
 	}
 
@@ -56,4 +60,65 @@ namespace Corium3DUtils {
 #endif		
 	}
 
+	ChunkedIdxPool::ChunkedIdxPool(unsigned int initialSz, unsigned int chunkSz) : chunkSzLog2(0) {
+		if (chunkSz == 0)
+			throw std::invalid_argument("ChunkedIdxPool chunk size has to be positive.");
+		while ((1u << chunkSzLog2) < chunkSz)
+			chunkSzLog2++;
+		idxInChunkMask = (1u << chunkSzLog2) - 1;
+
+		while (capacity < initialSz)
+			addChunk();
+	}
+
+	ChunkedIdxPool::~ChunkedIdxPool() {
+		for (unsigned int* nextAvailableIdxs : nextAvailableIdxsChunks)
+			delete[] nextAvailableIdxs;
+#if DEBUG
+		for (bool* acquiredIdxsLogicalVec : acquiredIdxsLogicalVecsChunks)
+			delete[] acquiredIdxsLogicalVec;
+#endif
+	}
+
+	unsigned int ChunkedIdxPool::acquire() {
+		// REMINDER: when all indices are acquired availableIdx == capacity, which is exactly the new chunk's first index
+		if (acquiredIdxsNr == capacity)
+			addChunk();
+
+		unsigned int returnedIdx = availableIdx;
+		availableIdx = nextAvailableIdxsChunks[returnedIdx >> chunkSzLog2][returnedIdx & idxInChunkMask];
+#if DEBUG
+		acquiredIdxsLogicalVecsChunks[returnedIdx >> chunkSzLog2][returnedIdx & idxInChunkMask] = true;
+#endif
+		if (++acquiredIdxsNr > acquiredIdxsNrMax)
+			acquiredIdxsNrMax = acquiredIdxsNr;
+
+		return returnedIdx;
+	}
+
+	void ChunkedIdxPool::release(unsigned int idx) {
+#if DEBUG
+		if (idx >= capacity)
+			throw std::out_of_range("Index out of range");
+		if (!acquiredIdxsLogicalVecsChunks[idx >> chunkSzLog2][idx & idxInChunkMask])
+			throw std::invalid_argument("Index was not previously acquired.");
+		acquiredIdxsLogicalVecsChunks[idx >> chunkSzLog2][idx & idxInChunkMask] = false;
+#endif
+		nextAvailableIdxsChunks[idx >> chunkSzLog2][idx & idxInChunkMask] = availableIdx;
+		availableIdx = idx;
+		acquiredIdxsNr--;
+	}
+
+	void ChunkedIdxPool::addChunk() {
+		unsigned int chunkSz = idxInChunkMask + 1;
+		unsigned int* nextAvailableIdxs = new unsigned int[chunkSz];
+		for (unsigned int idxInChunk = 0; idxInChunk < chunkSz; idxInChunk++)
+			nextAvailableIdxs[idxInChunk] = capacity + idxInChunk + 1;
+		nextAvailableIdxsChunks.push_back(nextAvailableIdxs);
+#if DEBUG
+		acquiredIdxsLogicalVecsChunks.push_back(new bool[chunkSz]());
+#endif
+		capacity += chunkSz;
+	}
+
 } //namespace Corium3DUtils
\ No newline at end of file
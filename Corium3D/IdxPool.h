@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdexcept>
+#include <vector>
 
 namespace Corium3DUtils {
 	class IdxPool {
@@ -13,7 +14,10 @@ namespace Corium3DUtils {
 #if DEBUG
 		bool isAcquired(unsigned int idx) const { return acquiredIdxsLogicalVec[idx]; }
 #endif
-		unsigned int getAcquiredIdxsNr() { return acquiredIdxsNr; }
+		unsigned int getAcquiredIdxsNr() const { return acquiredIdxsNr; }
+		// high-water mark since construction
+		unsigned int getAcquiredIdxsNrMax() const { return acquiredIdxsNrMax; }
+		unsigned int getPoolSz() const { return poolSz; }
 
 	private:
 #if DEBUG
@@ -23,5 +27,44 @@ namespace Corium3DUtils {
 		unsigned int poolSz;
 		unsigned int availableIdx = 0;
 		unsigned int acquiredIdxsNr = 0;
+		unsigned int acquiredIdxsNrMax = 0;
+	};
+
+	// Grows by chunks of chunkSz indices instead of throwing when exhausted.
+	// Acquired indices stay valid until released and released indices are reused first.
+	class ChunkedIdxPool {
+	public:
+		static const unsigned int CHUNK_SZ_DEFAULT = 256;
+
+		// REMINDER: chunkSz is rounded up to a power of 2
+		ChunkedIdxPool(unsigned int initialSz, unsigned int chunkSz = CHUNK_SZ_DEFAULT);
+		ChunkedIdxPool(ChunkedIdxPool const& idxPool) = delete;
+		~ChunkedIdxPool();
+		unsigned int acquire();
+		void release(unsigned int idx);
+#if DEBUG
+		bool isAcquired(unsigned int idx) const { return acquiredIdxsLogicalVecsChunks[idx >> chunkSzLog2][idx & idxInChunkMask]; }
+#endif
+		unsigned int getAcquiredIdxsNr() const { return acquiredIdxsNr; }
+		// high-water mark since construction or the last reset
+		unsigned int getAcquiredIdxsNrMax() const { return acquiredIdxsNrMax; }
+		void resetAcquiredIdxsNrMax() { acquiredIdxsNrMax = acquiredIdxsNr; }
+		unsigned int getCapacity() const { return capacity; }
+		unsigned int getChunkSz() const { return idxInChunkMask + 1; }
+		unsigned int getChunksNr() const { return (unsigned int)nextAvailableIdxsChunks.size(); }
+
+	private:
+		unsigned int chunkSzLog2;
+		unsigned int idxInChunkMask;
+		std::vector<unsigned int*> nextAvailableIdxsChunks;
+#if DEBUG
+		std::vector<bool*> acquiredIdxsLogicalVecsChunks;
+#endif
+		unsigned int capacity = 0;
+		unsigned int availableIdx = 0;
+		unsigned int acquiredIdxsNr = 0;
+		unsigned int acquiredIdxsNrMax = 0;
+
+		void addChunk();
 	};
 }
\ No newline at end of file
@@ -12,7 +12,7 @@ namespace Corium3D {
 		unsigned int texWidth, texHeight;
 		unsigned res = lodepng_decode_file(&atlasData, &texWidth, &texHeight, atlasPath.c_str(), LCT_RGBA, 8);
 		if (res) {
-			ServiceLocator::getLogger().loge("ImgsAtlas", lodepng_error_text(res));
+			LOGE("ImgsAtlas", "%s", lodepng_error_text(res));
 			throw std::exception("lodepng failed.");
 		}
 		atlasAspectRatio = (float)texHeight / texWidth;
@@ -0,0 +1,22 @@
+#include "IndirectCommandsGenerator.h"
+
+namespace Corium3D {
+
+	unsigned int IndirectCommandsGenerator::generate(std::vector<DrawListBuilder::Draw> const& drawList, unsigned int const* modelsBaseInstances, Command* commandsOut) {
+		groups.clear();
+		unsigned int commandsNr = 0;
+		for (DrawListBuilder::Draw const& draw : drawList) {
+			unsigned int baseInstance = modelsBaseInstances[draw.modelIdx];
+			if (baseInstance == NO_BASE_INSTANCE || draw.instancesNr == 0)
+				continue;
+
+			if (groups.empty() || groups.back().progIdx != draw.progIdx)
+				groups.push_back({ draw.progIdx, commandsNr, 0 });
+			commandsOut[commandsNr++] = { draw.idxsNr, draw.instancesNr, draw.firstIdx, (int)draw.baseVertex, baseInstance + draw.firstInstance };
+			groups.back().commandsNr++;
+		}
+
+		return commandsNr;
+	}
+
+} // namespace Corium3D
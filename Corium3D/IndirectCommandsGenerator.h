@@ -0,0 +1,43 @@
+#pragma once
+
+#include "DrawListBuilder.h"
+
+#include <vector>
+
+namespace Corium3D {
+
+	// Turns a draw list into indirect draw commands, free of GL - a command per (model, level of detail, mesh) draw, and the commands grouped
+	// into runs of the same program, each submitted with a single multi draw indirect. The commands are laid out as
+	// glMultiDrawElementsIndirect reads them.
+	class IndirectCommandsGenerator {
+	public:
+		// DrawElementsIndirectCommand
+		struct Command {
+			unsigned int idxsNr;
+			unsigned int instancesNr;
+			unsigned int firstIdx;
+			int baseVertex;
+			unsigned int baseInstance;
+		};
+
+		struct CommandsGroup {
+			unsigned int progIdx;
+			unsigned int firstCommandIdx;
+			unsigned int commandsNr;
+		};
+
+		// a model's base instance for when its instances' data was not written - its draws are skipped
+		static const unsigned int NO_BASE_INSTANCE = (unsigned int)-1;
+
+		// modelsBaseInstances - the first of each model's instances' data records (a draw's instances start at its
+		// firstInstance past it). commandsOut has room for
+		// drawList.size() commands, at most. returns the commands' number
+		unsigned int generate(std::vector<DrawListBuilder::Draw> const& drawList, unsigned int const* modelsBaseInstances, Command* commandsOut);
+		// in the draw list's order
+		std::vector<CommandsGroup> const& getGroups() const { return groups; }
+
+	private:
+		std::vector<CommandsGroup> groups;
+	};
+
+} // namespace Corium3D
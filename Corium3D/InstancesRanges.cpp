@@ -0,0 +1,31 @@
+#include "InstancesRanges.h"
+
+#include <cstring>
+
+namespace Corium3D {
+
+	InstancesRanges::InstancesRanges(unsigned int const* modelsInstancesNrsMaxima, unsigned int _modelsNr) : modelsNr(_modelsNr),
+			instancesNrsMaxima(new unsigned int[_modelsNr]), baseIdxs(new unsigned int[_modelsNr]) {
+		memcpy(instancesNrsMaxima, modelsInstancesNrsMaxima, modelsNr * sizeof(unsigned int));
+		for (unsigned int modelIdx = 0; modelIdx < modelsNr; modelIdx++)
+			baseIdxs[modelIdx] = modelIdx ? baseIdxs[modelIdx - 1] + instancesNrsMaxima[modelIdx - 1] : 0;
+	}
+
+	InstancesRanges::~InstancesRanges() {
+		delete[] instancesNrsMaxima;
+		delete[] baseIdxs;
+	}
+
+	unsigned int InstancesRanges::grow(unsigned int modelIdx, unsigned int instancesNrMax) {
+		if (instancesNrMax <= instancesNrsMaxima[modelIdx])
+			return 0;
+
+		unsigned int addedInstancesNr = instancesNrMax - instancesNrsMaxima[modelIdx];
+		instancesNrsMaxima[modelIdx] = instancesNrMax;
+		for (unsigned int followingModelIdx = modelIdx + 1; followingModelIdx < modelsNr; followingModelIdx++)
+			baseIdxs[followingModelIdx] += addedInstancesNr;
+
+		return addedInstancesNr;
+	}
+
+} // namespace Corium3D
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <algorithm>
+
+namespace Corium3D {
+
+	// The models' instances' ranges in the instances' buffers - laid out model after model, each sized by the model's
+	// instances maximum. Growing a model's maximum shifts the following models' ranges, and the added instances are
+	// inserted at the end of the model's previous range.
+	class InstancesRanges {
+	public:
+		InstancesRanges(unsigned int const* modelsInstancesNrsMaxima, unsigned int modelsNr);
+		InstancesRanges(InstancesRanges const& instancesRanges) = delete;
+		~InstancesRanges();
+		unsigned int getBaseIdx(unsigned int modelIdx) const { return baseIdxs[modelIdx]; }
+		unsigned int getEndIdx(unsigned int modelIdx) const { return baseIdxs[modelIdx] + instancesNrsMaxima[modelIdx]; }
+		unsigned int getInstancesNrMax(unsigned int modelIdx) const { return instancesNrsMaxima[modelIdx]; }
+		unsigned int const* getInstancesNrsMaxima() const { return instancesNrsMaxima; }
+		// returns the number of instances added - none if instancesNrMax does not exceed the model's maximum
+		unsigned int grow(unsigned int modelIdx, unsigned int instancesNrMax);
+		// the maximum that an instance index beyond a model's maximum grows it to - doubled, so that the arrays sized by
+		// the maxima (and the renderer's buffers) are reallocated rarely
+		static unsigned int calcGrownInstancesNrMax(unsigned int instancesNrMax, unsigned int instanceIdx) { return std::max(2 * instancesNrMax, instanceIdx + 1); }
+
+	private:
+		unsigned int modelsNr;
+		unsigned int* instancesNrsMaxima;
+		unsigned int* baseIdxs;
+	};
+
+} // namespace Corium3D
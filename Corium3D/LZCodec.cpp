@@ -0,0 +1,160 @@
+#include "LZCodec.h"
+
+#include <cstring>
+
+namespace Corium3DUtils {
+
+	const unsigned int LZ_MATCH_LEN_MIN = 4;
+	const unsigned int LZ_OFFSET_MAX = 65535;
+	const unsigned int LZ_HASH_BITS = 14;
+	// the block's tail is always coded as literals, so that the match finder never reads past the source
+	const unsigned int LZ_TAIL_LITERALS_NR = 8;
+
+	inline uint32_t readU32(char const* src) {
+		uint32_t val;
+		memcpy(&val, src, sizeof(val));
+		return val;
+	}
+
+	inline uint32_t hashU32(uint32_t val) {
+		return (val * 2654435761u) >> (32 - LZ_HASH_BITS);
+	}
+
+	inline void writeLen(std::vector<char>& out, size_t len) {
+		while (len >= 255) {
+			out.push_back((char)255);
+			len -= 255;
+		}
+		out.push_back((char)len);
+	}
+
+	static void writeSequence(std::vector<char>& out, char const* literals, size_t literalsNr, size_t offset, size_t matchLen) {
+		size_t matchLenCode = matchLen ? matchLen - LZ_MATCH_LEN_MIN : 0;
+		out.push_back((char)(((literalsNr < 15 ? literalsNr : 15) << 4) | (matchLenCode < 15 ? matchLenCode : 15)));
+		if (literalsNr >= 15)
+			writeLen(out, literalsNr - 15);
+		out.insert(out.end(), literals, literals + literalsNr);
+		if (matchLen) {
+			out.push_back((char)(offset & 0xFF));
+			out.push_back((char)(offset >> 8));
+			if (matchLenCode >= 15)
+				writeLen(out, matchLenCode - 15);
+		}
+	}
+
+	size_t lzCompress(char const* src, size_t srcSz, std::vector<char>& outCompressed) {
+		size_t outStartSz = outCompressed.size();
+		std::vector<uint32_t> hashTable(1 << LZ_HASH_BITS, 0);
+		size_t literalsStartIdx = 0;
+		size_t idx = 1;
+		size_t matchableEndIdx = srcSz > LZ_TAIL_LITERALS_NR ? srcSz - LZ_TAIL_LITERALS_NR : 0;
+		while (idx < matchableEndIdx) {
+			uint32_t hash = hashU32(readU32(src + idx));
+			size_t candidateIdx = hashTable[hash];
+			hashTable[hash] = (uint32_t)idx;
+			if (idx - candidateIdx > LZ_OFFSET_MAX || readU32(src + candidateIdx) != readU32(src + idx)) {
+				idx++;
+				continue;
+			}
+
+			size_t matchLen = LZ_MATCH_LEN_MIN;
+			while (idx + matchLen < matchableEndIdx && src[candidateIdx + matchLen] == src[idx + matchLen])
+				matchLen++;
+			writeSequence(outCompressed, src + literalsStartIdx, idx - literalsStartIdx, idx - candidateIdx, matchLen);
+			idx += matchLen;
+			literalsStartIdx = idx;
+		}
+		writeSequence(outCompressed, src + literalsStartIdx, srcSz - literalsStartIdx, 0, 0);
+
+		return outCompressed.size() - outStartSz;
+	}
+
+	inline bool readLen(char const*& src, char const* srcEnd, size_t& len) {
+		unsigned char byte;
+		do {
+			if (src == srcEnd)
+				return false;
+			byte = (unsigned char)*src++;
+			len += byte;
+		} while (byte == 255);
+
+		return true;
+	}
+
+	bool lzDecompress(char const* src, size_t srcSz, char* dst, size_t dstSz) {
+		char const* srcEnd = src + srcSz;
+		char* dstStart = dst;
+		char* dstEnd = dst + dstSz;
+		while (src < srcEnd) {
+			unsigned char token = (unsigned char)*src++;
+			size_t literalsNr = token >> 4;
+			if (literalsNr == 15 && !readLen(src, srcEnd, literalsNr))
+				return false;
+			if ((size_t)(srcEnd - src) < literalsNr || (size_t)(dstEnd - dst) < literalsNr)
+				return false;
+			// dst may be NULL when there is nothing to write
+			if (literalsNr > 0)
+				memcpy(dst, src, literalsNr);
+			src += literalsNr;
+			dst += literalsNr;
+			// the last sequence has literals only
+			if (src == srcEnd)
+				break;
+
+			if (srcEnd - src < 2)
+				return false;
+			size_t offset = (unsigned char)src[0] | ((size_t)(unsigned char)src[1] << 8);
+			src += 2;
+			size_t matchLen = token & 0x0F;
+			if (matchLen == 15 && !readLen(src, srcEnd, matchLen))
+				return false;
+			matchLen += LZ_MATCH_LEN_MIN;
+			if (offset == 0 || (size_t)(dst - dstStart) < offset || (size_t)(dstEnd - dst) < matchLen)
+				return false;
+			// matches might overlap their own output - copied in chunks of at most offset bytes, which never overlap
+			while (matchLen > 0) {
+				size_t chunkSz = offset < matchLen ? offset : matchLen;
+				memcpy(dst, dst - offset, chunkSz);
+				dst += chunkSz;
+				matchLen -= chunkSz;
+			}
+		}
+
+		return dst == dstEnd;
+	}
+
+	// slicing-by-8 tables: crc32Tables[sliceIdx][byte] is the CRC of byte followed by sliceIdx zero bytes
+	static uint32_t crc32Tables[8][256];
+
+	static bool initCrc32Tables() {
+		for (uint32_t byte = 0; byte < 256; byte++) {
+			uint32_t crc = byte;
+			for (unsigned int bitIdx = 0; bitIdx < 8; bitIdx++)
+				crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+			crc32Tables[0][byte] = crc;
+		}
+		for (uint32_t byte = 0; byte < 256; byte++) {
+			for (unsigned int sliceIdx = 1; sliceIdx < 8; sliceIdx++)
+				crc32Tables[sliceIdx][byte] = (crc32Tables[sliceIdx - 1][byte] >> 8) ^ crc32Tables[0][crc32Tables[sliceIdx - 1][byte] & 0xFF];
+		}
+		return true;
+	}
+
+	uint32_t crc32(char const* data, size_t sz, uint32_t crc) {
+		static bool isCrc32TablesInit = initCrc32Tables();
+		(void)isCrc32TablesInit;
+		crc = ~crc;
+		size_t byteIdx = 0;
+		// REMINDER: assumes a little endian host
+		for (; byteIdx + 8 <= sz; byteIdx += 8) {
+			uint32_t low = readU32(data + byteIdx) ^ crc;
+			uint32_t high = readU32(data + byteIdx + 4);
+			crc = crc32Tables[7][low & 0xFF] ^ crc32Tables[6][(low >> 8) & 0xFF] ^ crc32Tables[5][(low >> 16) & 0xFF] ^ crc32Tables[4][low >> 24] ^
+				  crc32Tables[3][high & 0xFF] ^ crc32Tables[2][(high >> 8) & 0xFF] ^ crc32Tables[1][(high >> 16) & 0xFF] ^ crc32Tables[0][high >> 24];
+		}
+		for (; byteIdx < sz; byteIdx++)
+			crc = crc32Tables[0][(crc ^ (unsigned char)data[byteIdx]) & 0xFF] ^ (crc >> 8);
+		return ~crc;
+	}
+
+} // namespace Corium3DUtils
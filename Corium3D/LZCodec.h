@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace Corium3DUtils {
+
+	// Byte oriented LZ77 block codec (LZ4-like sequences: a token of literals and match lengths nibbles, the literals,
+	// a 2 bytes match offset). Every block is self-contained, so blocks decompress independently of one another.
+	// REMINDER: compressed blocks carry no sizes - the caller stores both the compressed and the raw ones
+
+	// appends the compressed block to outCompressed and returns its size
+	size_t lzCompress(char const* src, size_t srcSz, std::vector<char>& outCompressed);
+
+	// returns false if the block is malformed or does not decompress to exactly dstSz bytes
+	bool lzDecompress(char const* src, size_t srcSz, char* dst, size_t dstSz);
+
+	// CRC-32 (IEEE 802.3)
+	uint32_t crc32(char const* data, size_t sz, uint32_t crc = 0);
+
+} // namespace Corium3DUtils
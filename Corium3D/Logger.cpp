@@ -1,45 +1,538 @@
 #include "Logger.h"
+#include "RingBufferSPSC.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #if defined(__ANDROID__) || defined(ANDROID)
 	#include <android/log.h>
-#elif defined(_WIN32) || defined(__VC32__) && !defined(__CYGWIN__) && !defined(__SCITECH_SNAP__) /* Win32 and WinCE */
-	#include <stdio.h>
-	#include <stdarg.h>
 #endif
 
 namespace Corium3DUtils {
 
+	namespace {
+
+		const unsigned int RECORD_PAYLOAD_SZ = 232;
+		const unsigned int FORMATTED_ARG_SZ_MAX = 512;
+		const long long NS_PER_SEC = 1000000000LL;
+		const std::chrono::milliseconds WRITING_PERIOD(5);
+
+		enum ArgType : unsigned char { ARG_INT, ARG_LONG, ARG_LLONG, ARG_INTMAX, ARG_SIZE, ARG_PTRDIFF, ARG_DOUBLE, ARG_LDOUBLE, ARG_PTR, ARG_STR, ARG_UNSUPPORTED };
+
+		// logTag and logFmt are either kept as pointers (string literals) or copied to the payload's start.
+		// The rest of the payload holds the arguments as [ArgType][value] - strings as [ARG_STR][length][chars].
+		struct LogRecord {
+			long long timeNs;
+			const char* logTag;
+			const char* logFmt;
+			unsigned int suppressedMsgsNr;
+			unsigned short payloadSz;
+			unsigned char severity;
+			bool isTagAndFmtCopied;
+			bool isTruncated;
+			unsigned char payload[RECORD_PAYLOAD_SZ];
+		};
+
+		long long getCurrentTimeNs() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		class PayloadWriter {
+		public:
+			PayloadWriter(LogRecord& _record) : record(_record) { record.payloadSz = 0; record.isTruncated = false; }
+
+			template <class T>
+			bool write(ArgType argType, T val) {
+				if (record.payloadSz + 1 + sizeof(T) > RECORD_PAYLOAD_SZ)
+					return truncate();
+				record.payload[record.payloadSz++] = argType;
+				memcpy(record.payload + record.payloadSz, &val, sizeof(T));
+				record.payloadSz += sizeof(T);
+				return true;
+			}
+
+			bool writeStr(const char* str) {
+				if (!str)
+					str = "(null)";
+				if (record.payloadSz + 1 + sizeof(unsigned short) > RECORD_PAYLOAD_SZ)
+					return truncate();
+				size_t strLenMax = RECORD_PAYLOAD_SZ - record.payloadSz - 1 - sizeof(unsigned short);
+				const char* strEnd = (const char*)memchr(str, '\0', strLenMax);
+				unsigned short strLen = (unsigned short)(strEnd ? strEnd - str : strLenMax);
+				record.payload[record.payloadSz++] = ARG_STR;
+				memcpy(record.payload + record.payloadSz, &strLen, sizeof(unsigned short));
+				record.payloadSz += sizeof(unsigned short);
+				memcpy(record.payload + record.payloadSz, str, strLen);
+				record.payloadSz += strLen;
+				if (!strEnd)
+					record.isTruncated = true;
+				return strEnd != NULL;
+			}
+
+		private:
+			LogRecord& record;
+
+			bool truncate() {
+				record.isTruncated = true;
+				return false;
+			}
+		};
+
+		class PayloadReader {
+		public:
+			PayloadReader(LogRecord const& _record) : record(_record), payloadIdx(0) {}
+
+			bool hasNext() const { return payloadIdx < record.payloadSz; }
+			ArgType peekType() const { return (ArgType)record.payload[payloadIdx]; }
+
+			template <class T>
+			T read() {
+				T val;
+				memcpy(&val, record.payload + payloadIdx + 1, sizeof(T));
+				payloadIdx += 1 + sizeof(T);
+				return val;
+			}
+
+			std::string readStr() {
+				unsigned short strLen;
+				memcpy(&strLen, record.payload + payloadIdx + 1, sizeof(unsigned short));
+				const char* str = (const char*)record.payload + payloadIdx + 1 + sizeof(unsigned short);
+				payloadIdx += 1 + sizeof(unsigned short) + strLen;
+				return std::string(str, strLen);
+			}
+
+		private:
+			LogRecord const& record;
+			unsigned int payloadIdx;
+		};
+
+		// walks the conversion specifications of logFmt - calls onLiteral for the text between them and onSpec
+		// for every specification (its text, stars number, length modifier and conversion character)
+		template <class OnLiteral, class OnSpec>
+		void walkFmt(const char* logFmt, OnLiteral onLiteral, OnSpec onSpec) {
+			const char* fmtIt = logFmt;
+			while (*fmtIt) {
+				const char* literalStart = fmtIt;
+				while (*fmtIt && *fmtIt != '%')
+					fmtIt++;
+				if (fmtIt != literalStart)
+					onLiteral(literalStart, fmtIt - literalStart);
+				if (!*fmtIt)
+					break;
+
+				const char* specStart = fmtIt++;
+				if (*fmtIt == '%') {
+					onLiteral(fmtIt, 1);
+					fmtIt++;
+					continue;
+				}
+
+				unsigned int starsNr = 0;
+				while (*fmtIt && strchr("-+ #0'", *fmtIt))
+					fmtIt++;
+				if (*fmtIt == '*') {
+					starsNr++;
+					fmtIt++;
+				}
+				while (*fmtIt >= '0' && *fmtIt <= '9')
+					fmtIt++;
+				if (*fmtIt == '.') {
+					fmtIt++;
+					if (*fmtIt == '*') {
+						starsNr++;
+						fmtIt++;
+					}
+					while (*fmtIt >= '0' && *fmtIt <= '9')
+						fmtIt++;
+				}
+				char lengthMod[3] = { 0, 0, 0 };
+				for (unsigned int lengthModIdx = 0; lengthModIdx < 2 && *fmtIt && strchr("hljztL", *fmtIt); lengthModIdx++)
+					lengthMod[lengthModIdx] = *fmtIt++;
+				if (!*fmtIt)
+					break;
+
+				char conversion = *fmtIt++;
+				onSpec(specStart, fmtIt - specStart, starsNr, lengthMod, conversion);
+			}
+		}
+
+		ArgType getArgType(const char* lengthMod, char conversion) {
+			switch (conversion) {
+			case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+				if (!strcmp(lengthMod, "l")) return ARG_LONG;
+				else if (!strcmp(lengthMod, "ll")) return ARG_LLONG;
+				else if (!strcmp(lengthMod, "j")) return ARG_INTMAX;
+				else if (!strcmp(lengthMod, "z")) return ARG_SIZE;
+				else if (!strcmp(lengthMod, "t")) return ARG_PTRDIFF;
+				else return ARG_INT;
+			case 'c':
+				return ARG_INT;
+			case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+				return !strcmp(lengthMod, "L") ? ARG_LDOUBLE : ARG_DOUBLE;
+			case 's':
+				return lengthMod[0] ? ARG_UNSUPPORTED : ARG_STR;
+			case 'p':
+				return ARG_PTR;
+			default:
+				return ARG_UNSUPPORTED;
+			}
+		}
+
+		void packArgs(const char* logFmt, va_list argptr, PayloadWriter& payloadWriter) {
+			bool hasSpace = true;
+			walkFmt(logFmt, [](const char*, size_t) {}, [&](const char*, size_t, unsigned int starsNr, const char* lengthMod, char conversion) {
+				for (unsigned int starIdx = 0; starIdx < starsNr && hasSpace; starIdx++)
+					hasSpace = payloadWriter.write(ARG_INT, va_arg(argptr, int));
+				if (!hasSpace)
+					return;
+
+				switch (getArgType(lengthMod, conversion)) {
+				case ARG_INT: hasSpace = payloadWriter.write(ARG_INT, va_arg(argptr, int)); break;
+				case ARG_LONG: hasSpace = payloadWriter.write(ARG_LONG, va_arg(argptr, long)); break;
+				case ARG_LLONG: hasSpace = payloadWriter.write(ARG_LLONG, va_arg(argptr, long long)); break;
+				case ARG_INTMAX: hasSpace = payloadWriter.write(ARG_INTMAX, va_arg(argptr, intmax_t)); break;
+				case ARG_SIZE: hasSpace = payloadWriter.write(ARG_SIZE, va_arg(argptr, size_t)); break;
+				case ARG_PTRDIFF: hasSpace = payloadWriter.write(ARG_PTRDIFF, va_arg(argptr, ptrdiff_t)); break;
+				case ARG_DOUBLE: hasSpace = payloadWriter.write(ARG_DOUBLE, va_arg(argptr, double)); break;
+				case ARG_LDOUBLE: hasSpace = payloadWriter.write(ARG_LDOUBLE, va_arg(argptr, long double)); break;
+				case ARG_PTR: hasSpace = payloadWriter.write(ARG_PTR, va_arg(argptr, void*)); break;
+				case ARG_STR: hasSpace = payloadWriter.writeStr(va_arg(argptr, const char*)); break;
+				// wide strings and characters, %n - the argument is consumed and replaced by a placeholder
+				case ARG_UNSUPPORTED: va_arg(argptr, void*); hasSpace = payloadWriter.write(ARG_UNSUPPORTED, (unsigned char)0); break;
+				}
+			});
+		}
+
+		template <class T>
+		void appendFormatted(std::string& out, std::string const& spec, int const* stars, unsigned int starsNr, T val) {
+			char formattedArg[FORMATTED_ARG_SZ_MAX];
+			int formattedArgSz;
+			switch (starsNr) {
+			case 0: formattedArgSz = snprintf(formattedArg, FORMATTED_ARG_SZ_MAX, spec.c_str(), val); break;
+			case 1: formattedArgSz = snprintf(formattedArg, FORMATTED_ARG_SZ_MAX, spec.c_str(), stars[0], val); break;
+			default: formattedArgSz = snprintf(formattedArg, FORMATTED_ARG_SZ_MAX, spec.c_str(), stars[0], stars[1], val); break;
+			}
+			if (formattedArgSz > 0)
+				out.append(formattedArg, std::min((unsigned int)formattedArgSz, FORMATTED_ARG_SZ_MAX - 1));
+		}
+
+		void formatRecord(LogRecord const& record, std::string& tagOut, std::string& msgOut) {
+			PayloadReader payloadReader(record);
+			std::string fmtCopy;
+			const char* logFmt = record.logFmt;
+			if (record.isTagAndFmtCopied) {
+				tagOut = payloadReader.hasNext() ? payloadReader.readStr() : std::string();
+				fmtCopy = payloadReader.hasNext() ? payloadReader.readStr() : std::string();
+				logFmt = fmtCopy.c_str();
+			}
+			else
+				tagOut = record.logTag;
+
+			msgOut.clear();
+			bool isArgMissing = false;
+			walkFmt(logFmt, [&](const char* literal, size_t literalLen) {
+				if (!isArgMissing)
+					msgOut.append(literal, literalLen);
+			}, [&](const char* specStart, size_t specLen, unsigned int starsNr, const char*, char) {
+				if (isArgMissing)
+					return;
+				int stars[2];
+				for (unsigned int starIdx = 0; starIdx < starsNr; starIdx++) {
+					if (!payloadReader.hasNext()) {
+						isArgMissing = true;
+						return;
+					}
+					stars[starIdx] = payloadReader.read<int>();
+				}
+				if (!payloadReader.hasNext()) {
+					isArgMissing = true;
+					return;
+				}
+
+				std::string spec(specStart, specLen);
+				switch (payloadReader.peekType()) {
+				case ARG_INT: appendFormatted(msgOut, spec, stars, starsNr, payloadReader.read<int>()); break;
+				case ARG_LONG: appendFormatted(msgOut, spec, stars, starsNr, payloadReader.read<long>()); break;
+				case ARG_LLONG: appendFormatted(msgOut, spec, stars, starsNr, payloadReader.read<long long>()); break;
+				case ARG_INTMAX: appendFormatted(msgOut, spec, stars, starsNr, payloadReader.read<intmax_t>()); break;
+				case ARG_SIZE: appendFormatted(msgOut, spec, stars, starsNr, payloadReader.read<size_t>()); break;
+				case ARG_PTRDIFF: appendFormatted(msgOut, spec, stars, starsNr, payloadReader.read<ptrdiff_t>()); break;
+				case ARG_DOUBLE: appendFormatted(msgOut, spec, stars, starsNr, payloadReader.read<double>()); break;
+				case ARG_LDOUBLE: appendFormatted(msgOut, spec, stars, starsNr, payloadReader.read<long double>()); break;
+				case ARG_PTR: appendFormatted(msgOut, spec, stars, starsNr, payloadReader.read<void*>()); break;
+				case ARG_STR: appendFormatted(msgOut, spec, stars, starsNr, payloadReader.readStr().c_str()); break;
+				case ARG_UNSUPPORTED: payloadReader.read<unsigned char>(); msgOut.append("(?)"); break;
+				}
+			});
+
+			if (record.isTruncated)
+				msgOut.append(" [...]");
+			if (record.suppressedMsgsNr > 0)
+				msgOut.append(" [" + std::to_string(record.suppressedMsgsNr) + " similar messages suppressed]");
+		}
+
+		void writeMsg(Logger::Severity severity, const char* logTag, const char* msg) {
 #if defined(__ANDROID__) || defined(ANDROID)
-	#define logd_func(logTag, logFmt, argptr) __android_log_vprint(ANDROID_LOG_DEBUG, logTag, logFmt, argptr)
-	#define loge_func(logTag, logFmt, argptr) __android_log_vprint(ANDROID_LOG_ERROR, logTag, logFmt, argptr)
-	#define logi_func(logTag, logFmt, argptr) __android_log_vprint(ANDROID_LOG_INFO, logTag, logFmt, argptr)
-#elif defined(_WIN32) || defined(__VC32__) && !defined(__CYGWIN__) && !defined(__SCITECH_SNAP__) /* Win32 and WinCE */
-	#define logd_func(logTag, logFmt, argptr) printf("[DEBUG]"); printf(logTag); printf(">> "); vprintf(logFmt, argptr); printf("\n"); fflush(stdout);
-	#define loge_func(logTag, logFmt, argptr) printf("[ERROR]"); printf(logTag); printf(">> "); vprintf(logFmt, argptr); printf("\n"); fflush(stdout);
-	#define logi_func(logTag, logFmt, argptr) printf("[INFO]"); printf(logTag); printf(">> "); vprintf(logFmt, argptr); printf("\n"); fflush(stdout);
+			static const int androidLogPriorities[] = { ANDROID_LOG_DEBUG, ANDROID_LOG_INFO, ANDROID_LOG_ERROR };
+			__android_log_write(androidLogPriorities[severity], logTag, msg);
+#else
+			static const char* severitiesPrefixes[] = { "[DEBUG]", "[INFO]", "[ERROR]" };
+			printf("%s%s>> %s\n", severitiesPrefixes[severity], logTag, msg);
 #endif
+		}
 
-	Logger::Logger() {}
+		struct ThreadRecordsBuffer {
+			ThreadRecordsBuffer() : records(Logger::RECORDS_BUFFER_SZ_PER_THREAD) {}
+
+			RingBufferSPSC<LogRecord> records;
+		};
+		// allocated with plain new - C++14's does not honor extended alignments
+		static_assert(alignof(ThreadRecordsBuffer) <= alignof(max_align_t), "ThreadRecordsBuffer is over-aligned");
+
+	} // anonymous namespace
+
+	class Logger::LoggerImpl {
+	public:
+		LoggerImpl() {}
+		~LoggerImpl();
+		void pushRecord(LogRecord const& record);
+		void flush();
+		unsigned long long getDroppedMsgsNr();
+
+	private:
+		std::mutex threadsBuffersMutex;
+		// REMINDER: threads' buffers are only freed with the logger, so a buffer stays valid for its thread's lifetime
+		std::vector<ThreadRecordsBuffer*> threadsBuffers;
+		std::once_flag writingThreadStartFlag;
+		std::thread writingThread;
+		std::mutex writingMutex;
+		std::condition_variable writingCond;
+		std::condition_variable flushedCond;
+		bool isStopRequested = false;
+		unsigned long long flushRequestsNr = 0;
+		unsigned long long flushesNr = 0;
+		unsigned long long reportedDroppedMsgsNr = 0;
+		std::vector<LogRecord> drainedRecords;
+
+		ThreadRecordsBuffer* acquireThreadRecordsBuffer();
+		void writingLoop();
+		void writeRecords();
+	};
+
+	namespace {
+		struct ThreadRecordsBufferEntry {
+			void* owningLoggerImpl;
+			ThreadRecordsBuffer* recordsBuffer;
+		};
+		thread_local ThreadRecordsBufferEntry threadRecordsBufferEntry = { NULL, NULL };
+	} // anonymous namespace
+
+	Logger::LoggerImpl::~LoggerImpl() {
+		{
+			std::lock_guard<std::mutex> lock(writingMutex);
+			isStopRequested = true;
+		}
+		writingCond.notify_one();
+		flushedCond.notify_all();
+		if (writingThread.joinable())
+			writingThread.join();
+		writeRecords();
+
+		for (ThreadRecordsBuffer* recordsBuffer : threadsBuffers)
+			delete recordsBuffer;
+	}
+
+	void Logger::LoggerImpl::pushRecord(LogRecord const& record) {
+		ThreadRecordsBuffer* recordsBuffer = threadRecordsBufferEntry.owningLoggerImpl == this ? threadRecordsBufferEntry.recordsBuffer : acquireThreadRecordsBuffer();
+		recordsBuffer->records.push(record);
+		if (record.severity == SEVERITY_ERROR)
+			writingCond.notify_one();
+	}
+
+	void Logger::LoggerImpl::flush() {
+		std::unique_lock<std::mutex> lock(writingMutex);
+		if (!writingThread.joinable())
+			return;
+		unsigned long long flushRequestIdx = ++flushRequestsNr;
+		writingCond.notify_one();
+		flushedCond.wait(lock, [&]() { return flushesNr >= flushRequestIdx || isStopRequested; });
+	}
+
+	unsigned long long Logger::LoggerImpl::getDroppedMsgsNr() {
+		std::lock_guard<std::mutex> lock(threadsBuffersMutex);
+		unsigned long long droppedMsgsNr = 0;
+		for (ThreadRecordsBuffer* recordsBuffer : threadsBuffers)
+			droppedMsgsNr += recordsBuffer->records.getStats().droppedNr;
+
+		return droppedMsgsNr;
+	}
+
+	ThreadRecordsBuffer* Logger::LoggerImpl::acquireThreadRecordsBuffer() {
+		// the writing thread is started lazily so that no thread is spawned during static initialization
+		std::call_once(writingThreadStartFlag, [this]() {
+			std::lock_guard<std::mutex> lock(writingMutex);
+			writingThread = std::thread(&LoggerImpl::writingLoop, this);
+		});
+
+		ThreadRecordsBuffer* recordsBuffer = new ThreadRecordsBuffer();
+		{
+			std::lock_guard<std::mutex> lock(threadsBuffersMutex);
+			threadsBuffers.push_back(recordsBuffer);
+		}
+		threadRecordsBufferEntry = { this, recordsBuffer };
+		return recordsBuffer;
+	}
+
+	void Logger::LoggerImpl::writingLoop() {
+		std::unique_lock<std::mutex> lock(writingMutex);
+		while (!isStopRequested) {
+			writingCond.wait_for(lock, WRITING_PERIOD, [this]() { return isStopRequested || flushRequestsNr != flushesNr; });
+			unsigned long long servedFlushRequestsNr = flushRequestsNr;
+			lock.unlock();
+			writeRecords();
+			lock.lock();
+			flushesNr = servedFlushRequestsNr;
+			flushedCond.notify_all();
+		}
+	}
+
+	void Logger::LoggerImpl::writeRecords() {
+		{
+			std::lock_guard<std::mutex> lock(threadsBuffersMutex);
+			for (ThreadRecordsBuffer* recordsBuffer : threadsBuffers) {
+				unsigned int recordsNr = recordsBuffer->records.getAvailableNr();
+				LogRecord record;
+				for (unsigned int recordIdx = 0; recordIdx < recordsNr; recordIdx++) {
+					recordsBuffer->records.pop(record);
+					drainedRecords.push_back(record);
+				}
+			}
+		}
+
+		unsigned long long droppedMsgsNr = getDroppedMsgsNr();
+		if (drainedRecords.empty() && droppedMsgsNr == reportedDroppedMsgsNr)
+			return;
+
+		// records of different threads are interleaved by their logging time
+		std::stable_sort(drainedRecords.begin(), drainedRecords.end(), [](LogRecord const& record1, LogRecord const& record2) { return record1.timeNs < record2.timeNs; });
+		std::string logTag, msg;
+		for (LogRecord const& record : drainedRecords) {
+			formatRecord(record, logTag, msg);
+			writeMsg((Severity)record.severity, logTag.c_str(), msg.c_str());
+		}
+		drainedRecords.clear();
+
+		if (droppedMsgsNr != reportedDroppedMsgsNr) {
+			writeMsg(SEVERITY_ERROR, "Logger", (std::to_string(droppedMsgsNr - reportedDroppedMsgsNr) + " messages were dropped (logging buffer full).").c_str());
+			reportedDroppedMsgsNr = droppedMsgsNr;
+		}
+#if !defined(__ANDROID__) && !defined(ANDROID)
+		fflush(stdout);
+#endif
+	}
+
+	namespace {
+		void fillRecord(LogRecord& record, Logger::Severity severity, const char* logTag, const char* logFmt, bool isTagAndFmtCopied, unsigned int suppressedMsgsNr, va_list argptr) {
+			record.timeNs = getCurrentTimeNs();
+			record.severity = severity;
+			record.suppressedMsgsNr = suppressedMsgsNr;
+			record.isTagAndFmtCopied = isTagAndFmtCopied;
+			PayloadWriter payloadWriter(record);
+			if (isTagAndFmtCopied) {
+				record.logTag = record.logFmt = NULL;
+				if (!payloadWriter.writeStr(logTag) || !payloadWriter.writeStr(logFmt))
+					return;
+			}
+			else {
+				record.logTag = logTag;
+				record.logFmt = logFmt;
+			}
+			packArgs(logFmt, argptr, payloadWriter);
+		}
+	} // anonymous namespace
+
+	Logger::Logger() : loggerImpl(new LoggerImpl()), severityMin(SEVERITY_DEBUG), rateLimitedMsgsNr(0) {}
+
+	Logger::~Logger() {
+		delete loggerImpl;
+	}
 
 	void Logger::logd(const char* logTag, const char* logFmt, ...) const {
+		if (SEVERITY_DEBUG < severityMin.load(std::memory_order_relaxed))
+			return;
+		LogRecord record;
 		va_list argptr;
 		va_start(argptr, logFmt);
-		logd_func(logTag, logFmt, argptr);
+		fillRecord(record, SEVERITY_DEBUG, logTag, logFmt, true, 0, argptr);
 		va_end(argptr);
+		loggerImpl->pushRecord(record);
 	}
 
 	void Logger::loge(const char* logTag, const char* logFmt, ...) const {
+		if (SEVERITY_ERROR < severityMin.load(std::memory_order_relaxed))
+			return;
+		LogRecord record;
 		va_list argptr;
 		va_start(argptr, logFmt);
-		loge_func(logTag, logFmt, argptr);
+		fillRecord(record, SEVERITY_ERROR, logTag, logFmt, true, 0, argptr);
 		va_end(argptr);
+		loggerImpl->pushRecord(record);
 	}
 
 	void Logger::logi(const char* logTag, const char* logFmt, ...) const {
+		if (SEVERITY_INFO < severityMin.load(std::memory_order_relaxed))
+			return;
+		LogRecord record;
 		va_list argptr;
 		va_start(argptr, logFmt);
-		logi_func(logTag, logFmt, argptr);
+		fillRecord(record, SEVERITY_INFO, logTag, logFmt, true, 0, argptr);
 		va_end(argptr);
+		loggerImpl->pushRecord(record);
+	}
+
+	void Logger::logAtCallSite(CallSite& callSite, Severity severity, const char* logTag, const char* logFmt, ...) const {
+		if (severity < severityMin.load(std::memory_order_relaxed))
+			return;
+
+		// REMINDER: the window reset races benignly between threads - the limit is approximate
+		long long currTimeNs = getCurrentTimeNs();
+		if (currTimeNs - callSite.rateWindowStartNs.load(std::memory_order_relaxed) >= NS_PER_SEC) {
+			callSite.rateWindowStartNs.store(currTimeNs, std::memory_order_relaxed);
+			callSite.rateWindowMsgsNr.store(0, std::memory_order_relaxed);
+		}
+		if (callSite.rateWindowMsgsNr.fetch_add(1, std::memory_order_relaxed) >= CALL_SITE_MSGS_NR_PER_SEC_MAX) {
+			callSite.suppressedMsgsNr.fetch_add(1, std::memory_order_relaxed);
+			rateLimitedMsgsNr.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		LogRecord record;
+		va_list argptr;
+		va_start(argptr, logFmt);
+		fillRecord(record, severity, logTag, logFmt, false, callSite.suppressedMsgsNr.exchange(0, std::memory_order_relaxed), argptr);
+		va_end(argptr);
+		loggerImpl->pushRecord(record);
+	}
+
+	void Logger::setSeverityMin(Severity _severityMin) {
+		severityMin.store(_severityMin, std::memory_order_relaxed);
+	}
+
+	void Logger::flush() const {
+		loggerImpl->flush();
+	}
+
+	unsigned long long Logger::getDroppedMsgsNr() const {
+		return loggerImpl->getDroppedMsgsNr();
 	}
 
-} // namespace Corium3D
\ No newline at end of file
+} // namespace Corium3D
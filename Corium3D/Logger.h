@@ -4,19 +4,55 @@
 
 #pragma once
 
-// #define LOGD(logTag, ...) do {if (DEBUG) Logger::logd(logTag, __VA_ARGS__);} while (0)
-// #define LOGE(logTag, ...) do {Logger::loge(logTag, __VA_ARGS__);} while (0)
-// #define LOGI(logTag, ...) do {Logger::logi(logTag, __VA_ARGS__);} while (0)
+#include <atomic>
+
+// Call site logging macros - cheaper than the Logger methods: logFmt has to be a string literal so records keep
+// only its pointer, and every call site is rate limited to Logger::CALL_SITE_MSGS_NR_PER_SEC_MAX messages per second.
+// REMINDER: the using translation unit has to include ServiceLocator.h
+#define LOG_AT_CALL_SITE(severity, logTag, logFmt, ...) do { static Corium3DUtils::Logger::CallSite logCallSite; Corium3D::ServiceLocator::getLogger().logAtCallSite(logCallSite, severity, logTag, "" logFmt, ##__VA_ARGS__); } while (0)
+#define LOGD(logTag, logFmt, ...) LOG_AT_CALL_SITE(Corium3DUtils::Logger::SEVERITY_DEBUG, logTag, logFmt, ##__VA_ARGS__)
+#define LOGI(logTag, logFmt, ...) LOG_AT_CALL_SITE(Corium3DUtils::Logger::SEVERITY_INFO, logTag, logFmt, ##__VA_ARGS__)
+#define LOGE(logTag, logFmt, ...) LOG_AT_CALL_SITE(Corium3DUtils::Logger::SEVERITY_ERROR, logTag, logFmt, ##__VA_ARGS__)
 
 namespace Corium3DUtils {
 
+	// Asynchronous logger - callers pack the format and its arguments into a compact record on a lock-free
+	// per-thread ring, and a background thread formats and writes the records.
+	// Messages are dropped (and counted) when a thread's ring is full.
 	class Logger {
 	public:
+		enum Severity { SEVERITY_DEBUG, SEVERITY_INFO, SEVERITY_ERROR };
+
+		struct CallSite {
+			std::atomic<long long> rateWindowStartNs{ 0 };
+			std::atomic<unsigned int> rateWindowMsgsNr{ 0 };
+			std::atomic<unsigned int> suppressedMsgsNr{ 0 };
+		};
+
+		static const unsigned int CALL_SITE_MSGS_NR_PER_SEC_MAX = 32;
+		static const unsigned int RECORDS_BUFFER_SZ_PER_THREAD = 1024;
+
 		Logger();
+		Logger(Logger const&) = delete;
+		~Logger();
+		// logTag and logFmt may be transient - they are copied into the record
 		void logd(const char* logTag, const char* logFmt, ...) const;
 		void loge(const char* logTag, const char* logFmt, ...) const;
 		void logi(const char* logTag, const char* logFmt, ...) const;
+		// use through the LOGD/LOGI/LOGE macros
+		void logAtCallSite(CallSite& callSite, Severity severity, const char* logTag, const char* logFmt, ...) const;
+		void setSeverityMin(Severity severityMin);
+		Severity getSeverityMin() const { return (Severity)severityMin.load(std::memory_order_relaxed); }
+		// blocks until every message logged before the call is written
+		void flush() const;
+		unsigned long long getDroppedMsgsNr() const;
+		unsigned long long getRateLimitedMsgsNr() const { return rateLimitedMsgsNr.load(std::memory_order_relaxed); }
+
+	private:
+		class LoggerImpl;
+		LoggerImpl* loggerImpl;
+		std::atomic<int> severityMin;
+		mutable std::atomic<unsigned long long> rateLimitedMsgsNr;
 	};
 
 } // namespace Corium3D
-
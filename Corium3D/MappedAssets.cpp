@@ -0,0 +1,858 @@
+#include "MappedAssets.h"
+#include "LZCodec.h"
+
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <limits>
+#if defined(_WIN32) || defined(__VC32__) && !defined(__CYGWIN__) && !defined(__SCITECH_SNAP__) /* Win32 and WinCE */
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+using namespace Corium3DUtils;
+
+namespace Corium3D {
+
+	const size_t MAPPED_ASSETS_ALIGNMENT = 16;
+
+	// an array within the mapping
+	struct MappedArr {
+		uint64_t offset;
+		uint32_t sz;
+		uint32_t reserved;
+	};
+
+	struct MappedAssetsHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t modelsNr;
+		uint32_t scenesNr;
+		uint64_t modelsLocsOffset; // uint64_t[modelsNr] of MappedModelDesc offsets
+		uint64_t scenesLocsOffset; // uint64_t[scenesNr] of MappedSceneData offsets
+		uint64_t quantizedArrsOffset; // MappedQuantizedArr[quantizedArrsNr]
+		uint32_t quantizedArrsNr;
+		uint32_t reserved;
+	};
+
+	enum QuantizationType : uint32_t { VEC3_U16, QUAT_S16 };
+
+	// an array whose values' field (a vec3 or a quat at fieldOffset within every stride bytes) is zeroed in the image
+	// and stored quantized at srcOffset
+	struct MappedQuantizedArr {
+		uint64_t dstOffset;
+		uint64_t srcOffset;
+		uint32_t valsNr;
+		uint32_t stride;
+		uint32_t fieldOffset;
+		QuantizationType type;
+		glm::vec4 min;
+		glm::vec4 step;
+	};
+
+	struct CompressedAssetsHeader {
+		char magic[4];
+		uint32_t version;
+		uint64_t imageSz;
+		uint32_t blockSz;
+		uint32_t blocksNr;
+	};
+
+	// blocks follow the blocks table. a block whose size is its raw size is stored uncompressed
+	struct CompressedBlockDesc {
+		uint64_t offset;
+		uint32_t sz;
+		uint32_t checksum; // of the raw block
+	};
+
+	struct MappedAnimationKeys {
+		MappedArr keyFramesTimes;
+		MappedArr channelsNodesIdxs;
+		MappedArr scales;
+		MappedArr rots;
+		MappedArr translations;
+	};
+
+	struct MappedModelDesc {
+		MappedArr colladaPath;
+		MappedArr verticesNrsPerMesh;
+		MappedArr extraColorsNrsPerMesh;
+		MappedArr extraColorsBaseIdxsPerMesh;
+		MappedArr extraColors; // all the meshes' extra colors, flattened
+		MappedArr texesNrsPerMesh;
+		MappedArr facesNrsPerMesh;
+		MappedArr bonesNrsPerMesh;
+		MappedArr animationsDescs;
+		MappedArr vertices;
+		MappedArr idxs;
+		MappedArr submeshesDescs;
+		MappedArr lodsDescs;
+		MappedArr lodsIdxs;
+		MappedArr lodsSubmeshesDescs;
+		MappedArr meshesTransforms;
+		MappedArr bonesOffsets;
+		MappedArr transformatsHierarchy;
+		MappedArr transformatsHierarchyMeshesIdxs;
+		MappedArr animationsKeys; // MappedAnimationKeys[animationsNr]
+		uint32_t verticesNr;
+		uint32_t meshesNr;
+		uint32_t verticesColorsNrTotal;
+		uint32_t texesNr;
+		uint32_t facesNr;
+		uint32_t progIdx;
+		uint32_t bonesNr;
+		float boundingSphereRadius;
+		glm::vec3 boundingSphereCenter;
+		ColliderData colliderData;
+	};
+
+	struct MappedSceneModelData {
+		uint32_t modelIdx;
+		uint32_t isStatic;
+		uint32_t instancesNrMax;
+		uint32_t reserved;
+		MappedArr instancesTransformsInit;
+	};
+
+	struct MappedSceneData {
+		MappedArr sceneModelsData; // MappedSceneModelData[sceneModelsNr]
+		uint32_t staticModelsNr;
+		uint32_t collisionPrimitives3DInstancesNrsMaxima[CollisionPrimitive3DType::__PRIMITIVE3D_TYPES_NR__];
+		uint32_t collisionPrimitives2DInstancesNrsMaxima[CollisionPrimitive2DType::__PRIMITIVE2D_TYPES_NR__];
+	};
+
+	template <class T>
+	inline T const* mappedPtr(char const* base, uint64_t offset) {
+		return reinterpret_cast<T const*>(base + offset);
+	}
+
+	template <class T>
+	inline ArrView<T> mappedArrView(char const* base, MappedArr const& arr) {
+		return ArrView<T>(mappedPtr<T>(base, arr.offset), arr.sz);
+	}
+
+	// lays the image out: records are reserved first and patched once their arrays are appended
+	// (the image might reallocate as it grows, so no pointers into it are held)
+	class MappedAssetsImageWriter {
+	public:
+		MappedAssetsImageWriter(std::vector<char>& _image, AssetsCompressionParams const& _compressionParams) : image(_image), compressionParams(_compressionParams) {}
+
+		uint64_t reserve(size_t sz) {
+			uint64_t offset = (image.size() + MAPPED_ASSETS_ALIGNMENT - 1) & ~(uint64_t)(MAPPED_ASSETS_ALIGNMENT - 1);
+			image.resize(offset + sz, 0);
+			return offset;
+		}
+
+		template <class T>
+		void patch(uint64_t offset, T const& record) {
+			memcpy(&image[offset], &record, sizeof(T));
+		}
+
+		template <class T>
+		MappedArr append(T const* arr, unsigned int sz) {
+			MappedArr mappedArr = { reserve(sizeof(T) * sz), sz, 0 };
+			if (sz > 0)
+				memcpy(&image[mappedArr.offset], arr, sizeof(T) * sz);
+			return mappedArr;
+		}
+
+		template <class T>
+		MappedArr append(std::vector<T> const& vec) {
+			return append(vec.data(), vec.size());
+		}
+
+		template <class T>
+		MappedArr appendQuantized(std::vector<T> const& vec, size_t fieldOffset, QuantizationType type, float errorMax) {
+			MappedQuantizedArr quantizedArr = { 0, 0, (uint32_t)vec.size(), sizeof(T), (uint32_t)fieldOffset, type, glm::vec4(0.0f), glm::vec4(0.0f) };
+			unsigned int componentsNr = type == QuantizationType::VEC3_U16 ? 3 : 4;
+			if (vec.empty() || !calcQuantization(vec, quantizedArr, componentsNr, errorMax))
+				return append(vec);
+
+			MappedArr mappedArr = append(vec);
+			quantizedArr.dstOffset = mappedArr.offset;
+			std::vector<uint16_t> quantizedVals(componentsNr * vec.size());
+			for (unsigned int valIdx = 0; valIdx < vec.size(); valIdx++) {
+				char* field = &image[mappedArr.offset + valIdx * sizeof(T) + fieldOffset];
+				float components[4];
+				memcpy(components, field, componentsNr * sizeof(float));
+				for (unsigned int componentIdx = 0; componentIdx < componentsNr; componentIdx++) {
+					float quantizedVal = quantizedArr.step[componentIdx] > 0.0f ? (components[componentIdx] - quantizedArr.min[componentIdx]) / quantizedArr.step[componentIdx] : 0.0f;
+					quantizedVals[valIdx * componentsNr + componentIdx] = type == QuantizationType::VEC3_U16 ? (uint16_t)std::lround(quantizedVal) : (uint16_t)(int16_t)std::lround(quantizedVal);
+				}
+				// zeroed fields compress to next to nothing
+				memset(field, 0, componentsNr * sizeof(float));
+			}
+			quantizedArr.srcOffset = append(quantizedVals).offset;
+			quantizedArrs.push_back(quantizedArr);
+
+			return mappedArr;
+		}
+
+		std::vector<MappedQuantizedArr> const& getQuantizedArrs() const { return quantizedArrs; }
+		AssetsCompressionParams const& getCompressionParams() const { return compressionParams; }
+
+	private:
+		std::vector<char>& image;
+		AssetsCompressionParams compressionParams;
+		std::vector<MappedQuantizedArr> quantizedArrs;
+
+		template <class T>
+		static bool calcQuantization(std::vector<T> const& vec, MappedQuantizedArr& quantizedArr, unsigned int componentsNr, float errorMax) {
+			if (errorMax <= 0.0f)
+				return false;
+
+			if (quantizedArr.type == QuantizationType::QUAT_S16) {
+				// components are within [-1, 1]: min 0 and a step of 1/32767 map them onto [-32767, 32767]
+				quantizedArr.step = glm::vec4(1.0f / 32767.0f);
+				return 0.5f * quantizedArr.step.x <= errorMax;
+			}
+
+			glm::vec4 max(-std::numeric_limits<float>::max());
+			quantizedArr.min = glm::vec4(std::numeric_limits<float>::max());
+			for (T const& val : vec) {
+				float components[4];
+				memcpy(components, (char const*)&val + quantizedArr.fieldOffset, componentsNr * sizeof(float));
+				for (unsigned int componentIdx = 0; componentIdx < componentsNr; componentIdx++) {
+					quantizedArr.min[componentIdx] = std::min(quantizedArr.min[componentIdx], components[componentIdx]);
+					max[componentIdx] = std::max(max[componentIdx], components[componentIdx]);
+				}
+			}
+			for (unsigned int componentIdx = 0; componentIdx < componentsNr; componentIdx++) {
+				quantizedArr.step[componentIdx] = (max[componentIdx] - quantizedArr.min[componentIdx]) / 65535.0f;
+				if (0.5f * quantizedArr.step[componentIdx] > errorMax)
+					return false;
+			}
+
+			return true;
+		}
+	};
+
+	// the primitives' unions are copied through their active members only, so that the image's bytes depend on the
+	// collider's values alone (generating the same assets twice yields the same file)
+	static ColliderData canonicalizeColliderData(ColliderData const& colliderData) {
+		ColliderData canonicalColliderData;
+		memset((void*)&canonicalColliderData, 0, sizeof(canonicalColliderData));
+		canonicalColliderData.collisionPrimitive3DType = colliderData.collisionPrimitive3DType;
+		canonicalColliderData.aabb3DMinVertex = colliderData.aabb3DMinVertex;
+		canonicalColliderData.aabb3DMaxVertex = colliderData.aabb3DMaxVertex;
+		switch (colliderData.collisionPrimitive3DType) {
+		case CollisionPrimitive3DType::BOX:
+			canonicalColliderData.collisionPrimitive3dData.collisionBoxData = colliderData.collisionPrimitive3dData.collisionBoxData;
+			break;
+		case CollisionPrimitive3DType::SPHERE:
+			canonicalColliderData.collisionPrimitive3dData.collisionSphereData = colliderData.collisionPrimitive3dData.collisionSphereData;
+			break;
+		case CollisionPrimitive3DType::CAPSULE:
+			canonicalColliderData.collisionPrimitive3dData.collisionCapsuleData = colliderData.collisionPrimitive3dData.collisionCapsuleData;
+			break;
+		default:
+			break;
+		}
+
+		canonicalColliderData.collisionPrimitive2DType = colliderData.collisionPrimitive2DType;
+		canonicalColliderData.aabb2DMinVertex = colliderData.aabb2DMinVertex;
+		canonicalColliderData.aabb2DMaxVertex = colliderData.aabb2DMaxVertex;
+		switch (colliderData.collisionPrimitive2DType) {
+		case CollisionPrimitive2DType::RECT:
+			canonicalColliderData.collisionPrimitive2dData.collisionRectData = colliderData.collisionPrimitive2dData.collisionRectData;
+			break;
+		case CollisionPrimitive2DType::CIRCLE:
+			canonicalColliderData.collisionPrimitive2dData.collisionCircleData = colliderData.collisionPrimitive2dData.collisionCircleData;
+			break;
+		case CollisionPrimitive2DType::STADIUM:
+			canonicalColliderData.collisionPrimitive2dData.collisionStadiumData = colliderData.collisionPrimitive2dData.collisionStadiumData;
+			break;
+		default:
+			break;
+		}
+
+		return canonicalColliderData;
+	}
+
+	static uint64_t appendModelDesc(MappedAssetsImageWriter& imageWriter, ModelDesc const& modelDesc) {
+		uint64_t modelDescOffset = imageWriter.reserve(sizeof(MappedModelDesc));
+		MappedModelDesc mappedModelDesc = {};
+		mappedModelDesc.colladaPath = imageWriter.append(modelDesc.colladaPath.data(), modelDesc.colladaPath.size());
+		if (!modelDesc.colladaPath.empty()) {
+			mappedModelDesc.verticesNr = modelDesc.verticesNr;
+			mappedModelDesc.meshesNr = modelDesc.meshesNr;
+			mappedModelDesc.verticesNrsPerMesh = imageWriter.append(modelDesc.verticesNrsPerMesh);
+			mappedModelDesc.verticesColorsNrTotal = modelDesc.verticesColorsNrTotal;
+			mappedModelDesc.extraColorsNrsPerMesh = imageWriter.append(modelDesc.extraColorsNrsPerMesh);
+			std::vector<unsigned int> extraColorsBaseIdxsPerMesh(modelDesc.meshesNr);
+			std::vector<std::array<float, 4>> extraColors;
+			for (unsigned int meshIdx = 0; meshIdx < modelDesc.meshesNr; meshIdx++) {
+				extraColorsBaseIdxsPerMesh[meshIdx] = extraColors.size();
+				extraColors.insert(extraColors.end(), modelDesc.extraColors[meshIdx].begin(), modelDesc.extraColors[meshIdx].begin() + modelDesc.extraColorsNrsPerMesh[meshIdx]);
+			}
+			mappedModelDesc.extraColorsBaseIdxsPerMesh = imageWriter.append(extraColorsBaseIdxsPerMesh);
+			mappedModelDesc.extraColors = imageWriter.append(extraColors);
+			mappedModelDesc.texesNr = modelDesc.texesNr;
+			mappedModelDesc.texesNrsPerMesh = imageWriter.append(modelDesc.texesNrsPerMesh);
+			mappedModelDesc.facesNr = modelDesc.facesNr;
+			mappedModelDesc.facesNrsPerMesh = imageWriter.append(modelDesc.facesNrsPerMesh);
+			mappedModelDesc.progIdx = modelDesc.progIdx;
+			mappedModelDesc.bonesNr = modelDesc.bonesNr;
+			mappedModelDesc.bonesNrsPerMesh = imageWriter.append(modelDesc.bonesNrsPerMesh);
+			mappedModelDesc.animationsDescs = imageWriter.append(modelDesc.animationsDescs);
+
+			mappedModelDesc.vertices = imageWriter.appendQuantized(modelDesc.vertices, offsetof(ModelDesc::VertexData, pos), QuantizationType::VEC3_U16, imageWriter.getCompressionParams().positionsErrorMax);
+			mappedModelDesc.idxs = imageWriter.append(modelDesc.idxs);
+			mappedModelDesc.submeshesDescs = imageWriter.append(modelDesc.submeshesDescs);
+			mappedModelDesc.lodsDescs = imageWriter.append(modelDesc.lodsDescs);
+			mappedModelDesc.lodsIdxs = imageWriter.append(modelDesc.lodsIdxs);
+			mappedModelDesc.lodsSubmeshesDescs = imageWriter.append(modelDesc.lodsSubmeshesDescs);
+			mappedModelDesc.meshesTransforms = imageWriter.append(modelDesc.meshesTransforms);
+			mappedModelDesc.bonesOffsets = imageWriter.append(modelDesc.bonesOffsets);
+			mappedModelDesc.transformatsHierarchy = imageWriter.append(modelDesc.transformatsHierarchy);
+			mappedModelDesc.transformatsHierarchyMeshesIdxs = imageWriter.append(modelDesc.transformatsHierarchyMeshesIdxs);
+			std::vector<MappedAnimationKeys> mappedAnimationsKeys(modelDesc.animationsKeys.size());
+			for (unsigned int animationIdx = 0; animationIdx < modelDesc.animationsKeys.size(); animationIdx++) {
+				ModelDesc::AnimationKeys const& animationKeys = modelDesc.animationsKeys[animationIdx];
+				mappedAnimationsKeys[animationIdx].keyFramesTimes = imageWriter.append(animationKeys.keyFramesTimes);
+				mappedAnimationsKeys[animationIdx].channelsNodesIdxs = imageWriter.append(animationKeys.channelsNodesIdxs);
+				float keysErrorMax = imageWriter.getCompressionParams().animationKeysErrorMax;
+				mappedAnimationsKeys[animationIdx].scales = imageWriter.appendQuantized(animationKeys.scales, 0, QuantizationType::VEC3_U16, keysErrorMax);
+				mappedAnimationsKeys[animationIdx].rots = imageWriter.appendQuantized(animationKeys.rots, 0, QuantizationType::QUAT_S16, keysErrorMax);
+				mappedAnimationsKeys[animationIdx].translations = imageWriter.appendQuantized(animationKeys.translations, 0, QuantizationType::VEC3_U16, keysErrorMax);
+			}
+			mappedModelDesc.animationsKeys = imageWriter.append(mappedAnimationsKeys);
+		}
+
+		mappedModelDesc.boundingSphereCenter = modelDesc.boundingSphereCenter;
+		mappedModelDesc.boundingSphereRadius = modelDesc.boundingSphereRadius;
+		mappedModelDesc.colliderData = canonicalizeColliderData(modelDesc.colliderData);
+		imageWriter.patch(modelDescOffset, mappedModelDesc);
+
+		return modelDescOffset;
+	}
+
+	static uint64_t appendSceneData(MappedAssetsImageWriter& imageWriter, SceneData const& sceneData) {
+		uint64_t sceneDataOffset = imageWriter.reserve(sizeof(MappedSceneData));
+		std::vector<MappedSceneModelData> mappedSceneModelsData(sceneData.sceneModelsData.size());
+		for (unsigned int sceneModelIdx = 0; sceneModelIdx < sceneData.sceneModelsData.size(); sceneModelIdx++) {
+			SceneData::SceneModelData const& sceneModelData = sceneData.sceneModelsData[sceneModelIdx];
+			mappedSceneModelsData[sceneModelIdx].modelIdx = sceneModelData.modelIdx;
+			mappedSceneModelsData[sceneModelIdx].isStatic = sceneModelData.isStatic;
+			mappedSceneModelsData[sceneModelIdx].instancesNrMax = sceneModelData.instancesNrMax;
+			mappedSceneModelsData[sceneModelIdx].reserved = 0;
+			mappedSceneModelsData[sceneModelIdx].instancesTransformsInit = imageWriter.append(sceneModelData.instancesTransformsInit);
+		}
+
+		MappedSceneData mappedSceneData = {};
+		mappedSceneData.sceneModelsData = imageWriter.append(mappedSceneModelsData);
+		mappedSceneData.staticModelsNr = sceneData.staticModelsNr;
+		memcpy(mappedSceneData.collisionPrimitives3DInstancesNrsMaxima, sceneData.collisionPrimitives3DInstancesNrsMaxima.data(), sizeof(mappedSceneData.collisionPrimitives3DInstancesNrsMaxima));
+		memcpy(mappedSceneData.collisionPrimitives2DInstancesNrsMaxima, sceneData.collisionPrimitives2DInstancesNrsMaxima.data(), sizeof(mappedSceneData.collisionPrimitives2DInstancesNrsMaxima));
+		imageWriter.patch(sceneDataOffset, mappedSceneData);
+
+		return sceneDataOffset;
+	}
+
+	void genMappedAssetsImage(std::vector<ModelDesc const*> const& modelDescs, std::vector<SceneData const*> const& scenesData, std::vector<char>& outImage,
+							  AssetsCompressionParams const& compressionParams) {
+		outImage.clear();
+		MappedAssetsImageWriter imageWriter(outImage, compressionParams);
+		uint64_t headerOffset = imageWriter.reserve(sizeof(MappedAssetsHeader));
+		MappedAssetsHeader header = {};
+		memcpy(header.magic, MAPPED_ASSETS_MAGIC, sizeof(header.magic));
+		header.version = MAPPED_ASSETS_VERSION;
+		header.modelsNr = modelDescs.size();
+		header.scenesNr = scenesData.size();
+		header.modelsLocsOffset = imageWriter.reserve(sizeof(uint64_t) * header.modelsNr);
+		header.scenesLocsOffset = imageWriter.reserve(sizeof(uint64_t) * header.scenesNr);
+		imageWriter.patch(headerOffset, header);
+
+		for (unsigned int modelIdx = 0; modelIdx < header.modelsNr; ++modelIdx)
+			imageWriter.patch(header.modelsLocsOffset + modelIdx * sizeof(uint64_t), appendModelDesc(imageWriter, *modelDescs[modelIdx]));
+		for (unsigned int sceneIdx = 0; sceneIdx < header.scenesNr; ++sceneIdx)
+			imageWriter.patch(header.scenesLocsOffset + sceneIdx * sizeof(uint64_t), appendSceneData(imageWriter, *scenesData[sceneIdx]));
+
+		header.quantizedArrsNr = imageWriter.getQuantizedArrs().size();
+		header.quantizedArrsOffset = imageWriter.append(imageWriter.getQuantizedArrs()).offset;
+		imageWriter.patch(headerOffset, header);
+	}
+
+	static void writeCompressedImage(std::ofstream& assetsFile, std::vector<char> const& image, unsigned int blockSz) {
+		CompressedAssetsHeader header;
+		memcpy(header.magic, COMPRESSED_ASSETS_MAGIC, sizeof(header.magic));
+		header.version = MAPPED_ASSETS_VERSION;
+		header.imageSz = image.size();
+		header.blockSz = blockSz;
+		header.blocksNr = (uint32_t)((image.size() + blockSz - 1) / blockSz);
+
+		std::vector<CompressedBlockDesc> blocksDescs(header.blocksNr);
+		std::vector<char> blocks;
+		uint64_t blocksOffset = sizeof(CompressedAssetsHeader) + header.blocksNr * sizeof(CompressedBlockDesc);
+		for (unsigned int blockIdx = 0; blockIdx < header.blocksNr; blockIdx++) {
+			char const* rawBlock = image.data() + (size_t)blockIdx * blockSz;
+			size_t rawBlockSz = std::min<size_t>(blockSz, image.size() - (size_t)blockIdx * blockSz);
+			size_t blockOffset = blocks.size();
+			size_t compressedBlockSz = lzCompress(rawBlock, rawBlockSz, blocks);
+			// incompressible blocks are stored as they are
+			if (compressedBlockSz >= rawBlockSz) {
+				blocks.resize(blockOffset);
+				blocks.insert(blocks.end(), rawBlock, rawBlock + rawBlockSz);
+				compressedBlockSz = rawBlockSz;
+			}
+			blocksDescs[blockIdx].offset = blocksOffset + blockOffset;
+			blocksDescs[blockIdx].sz = (uint32_t)compressedBlockSz;
+			blocksDescs[blockIdx].checksum = crc32(rawBlock, rawBlockSz);
+		}
+
+		assetsFile.write((char const*)&header, sizeof(header));
+		assetsFile.write((char const*)blocksDescs.data(), blocksDescs.size() * sizeof(CompressedBlockDesc));
+		assetsFile.write(blocks.data(), blocks.size());
+	}
+
+	void writeMappedAssetsFile(std::string const& assetsFileFullPath, std::vector<ModelDesc const*> const& modelDescs, std::vector<SceneData const*> const& scenesData,
+							   AssetsCompressionParams const& compressionParams) {
+		std::vector<char> image;
+		genMappedAssetsImage(modelDescs, scenesData, image, compressionParams);
+
+		std::ofstream assetsFile(assetsFileFullPath, std::ios::binary);
+#ifdef DEBUG
+		if (!assetsFile.is_open())
+			throw std::ios_base::failure(assetsFileFullPath + " failed to open.");
+#endif
+		if (compressionParams.isCompressed)
+			writeCompressedImage(assetsFile, image, compressionParams.blockSz);
+		else
+			assetsFile.write(image.data(), image.size());
+		assetsFile.close();
+	}
+
+	bool isMappedAssetsFile(std::string const& assetsFileFullPath) {
+		std::ifstream assetsFile(assetsFileFullPath, std::ios::binary);
+		char magic[sizeof(MAPPED_ASSETS_MAGIC)];
+		return assetsFile.read(magic, sizeof(magic)) &&
+			(memcmp(magic, MAPPED_ASSETS_MAGIC, sizeof(magic)) == 0 || memcmp(magic, COMPRESSED_ASSETS_MAGIC, sizeof(magic)) == 0);
+	}
+
+	MappedAssets::MappedAssets(std::string const& assetsFileFullPath) {
+		bool isMappedLayout = isMappedAssetsFile(assetsFileFullPath);
+		// the stream format reader would only read garbage out of a mapped layout file
+		if (isMappedLayout && !map(assetsFileFullPath))
+			throw std::ios_base::failure(assetsFileFullPath + " failed to map.");
+
+		if (!isMappedLayout) {
+			std::vector<ModelDesc> modelDescs;
+			std::vector<SceneData> scenesData;
+			readAssetsFile(assetsFileFullPath, modelDescs, scenesData);
+			std::vector<ModelDesc const*> modelDescsPtrs(modelDescs.size());
+			for (unsigned int modelIdx = 0; modelIdx < modelDescs.size(); ++modelIdx) {
+				if (!modelDescs[modelIdx].colladaPath.empty() && modelDescs[modelIdx].vertices.empty())
+					throw std::ios_base::failure(assetsFileFullPath + " holds models whose data was not baked - regenerate it with the assets generator.");
+				modelDescsPtrs[modelIdx] = &modelDescs[modelIdx];
+			}
+			std::vector<SceneData const*> scenesDataPtrs(scenesData.size());
+			for (unsigned int sceneIdx = 0; sceneIdx < scenesData.size(); ++sceneIdx)
+				scenesDataPtrs[sceneIdx] = &scenesData[sceneIdx];
+			genMappedAssetsImage(modelDescsPtrs, scenesDataPtrs, image);
+			base = image.data();
+		}
+		else if (memcmp(base, COMPRESSED_ASSETS_MAGIC, sizeof(COMPRESSED_ASSETS_MAGIC)) == 0)
+			decompress(assetsFileFullPath);
+
+		if ((isMapped() ? mappingSz : image.size()) < sizeof(MappedAssetsHeader) || mappedPtr<MappedAssetsHeader>(base, 0)->version != MAPPED_ASSETS_VERSION) {
+			if (isMapped())
+				unmap();
+			throw std::ios_base::failure(assetsFileFullPath + " is of an unsupported version.");
+		}
+		if (!isLayoutInBounds()) {
+			if (isMapped())
+				unmap();
+			throw std::ios_base::failure(assetsFileFullPath + " is corrupt (arrays out of bounds).");
+		}
+		if (mappedPtr<MappedAssetsHeader>(base, 0)->quantizedArrsNr > 0)
+			dequantize();
+	}
+
+	template <class T>
+	inline bool isArrInBounds(uint64_t offset, uint64_t elemsNr, size_t imageSz) {
+		return offset % MAPPED_ASSETS_ALIGNMENT == 0 && offset <= imageSz && elemsNr * sizeof(T) <= imageSz - offset;
+	}
+
+	template <class T>
+	inline bool isArrInBounds(MappedArr const& arr, size_t imageSz) {
+		return isArrInBounds<T>(arr.offset, arr.sz, imageSz);
+	}
+
+	// every offset and size read off the image is checked once here, so that the views and dequantize() need not
+	bool MappedAssets::isLayoutInBounds() const {
+		size_t imageSz = getSz();
+		MappedAssetsHeader const* header = mappedPtr<MappedAssetsHeader>(base, 0);
+		if (!isArrInBounds<uint64_t>(header->modelsLocsOffset, header->modelsNr, imageSz) || !isArrInBounds<uint64_t>(header->scenesLocsOffset, header->scenesNr, imageSz) ||
+			!isArrInBounds<MappedQuantizedArr>(header->quantizedArrsOffset, header->quantizedArrsNr, imageSz))
+			return false;
+
+		uint64_t const* modelsLocs = mappedPtr<uint64_t>(base, header->modelsLocsOffset);
+		for (unsigned int modelIdx = 0; modelIdx < header->modelsNr; modelIdx++) {
+			if (!isArrInBounds<MappedModelDesc>(modelsLocs[modelIdx], 1, imageSz))
+				return false;
+			MappedModelDesc const* modelDesc = mappedPtr<MappedModelDesc>(base, modelsLocs[modelIdx]);
+			if (!isArrInBounds<char>(modelDesc->colladaPath, imageSz) || !isArrInBounds<unsigned int>(modelDesc->verticesNrsPerMesh, imageSz) ||
+				!isArrInBounds<unsigned int>(modelDesc->extraColorsNrsPerMesh, imageSz) || !isArrInBounds<unsigned int>(modelDesc->extraColorsBaseIdxsPerMesh, imageSz) ||
+				!isArrInBounds<std::array<float, 4>>(modelDesc->extraColors, imageSz) || !isArrInBounds<unsigned int>(modelDesc->texesNrsPerMesh, imageSz) ||
+				!isArrInBounds<unsigned int>(modelDesc->facesNrsPerMesh, imageSz) || !isArrInBounds<unsigned int>(modelDesc->bonesNrsPerMesh, imageSz) ||
+				!isArrInBounds<ModelDesc::AnimationDesc>(modelDesc->animationsDescs, imageSz) || !isArrInBounds<ModelDesc::VertexData>(modelDesc->vertices, imageSz) ||
+				!isArrInBounds<unsigned int>(modelDesc->idxs, imageSz) || !isArrInBounds<ModelDesc::SubmeshDesc>(modelDesc->submeshesDescs, imageSz) ||
+				!isArrInBounds<ModelDesc::LodDesc>(modelDesc->lodsDescs, imageSz) || !isArrInBounds<unsigned int>(modelDesc->lodsIdxs, imageSz) ||
+				!isArrInBounds<ModelDesc::SubmeshDesc>(modelDesc->lodsSubmeshesDescs, imageSz) || !isArrInBounds<glm::mat4>(modelDesc->meshesTransforms, imageSz) ||
+				!isArrInBounds<glm::mat4>(modelDesc->bonesOffsets, imageSz) || !isArrInBounds<ModelDesc::TransformatsHierarchyNodeDesc>(modelDesc->transformatsHierarchy, imageSz) ||
+				!isArrInBounds<unsigned int>(modelDesc->transformatsHierarchyMeshesIdxs, imageSz) || !isArrInBounds<MappedAnimationKeys>(modelDesc->animationsKeys, imageSz))
+				return false;
+
+			// the meshes' extra colors are sub-views of the flattened colors
+			if (modelDesc->extraColorsBaseIdxsPerMesh.sz != modelDesc->extraColorsNrsPerMesh.sz)
+				return false;
+			unsigned int const* extraColorsBaseIdxsPerMesh = mappedPtr<unsigned int>(base, modelDesc->extraColorsBaseIdxsPerMesh.offset);
+			unsigned int const* extraColorsNrsPerMesh = mappedPtr<unsigned int>(base, modelDesc->extraColorsNrsPerMesh.offset);
+			for (unsigned int meshIdx = 0; meshIdx < modelDesc->extraColorsNrsPerMesh.sz; meshIdx++) {
+				if ((uint64_t)extraColorsBaseIdxsPerMesh[meshIdx] + extraColorsNrsPerMesh[meshIdx] > modelDesc->extraColors.sz)
+					return false;
+			}
+
+			MappedAnimationKeys const* animationsKeys = mappedPtr<MappedAnimationKeys>(base, modelDesc->animationsKeys.offset);
+			for (unsigned int animationIdx = 0; animationIdx < modelDesc->animationsKeys.sz; animationIdx++) {
+				MappedAnimationKeys const& animationKeys = animationsKeys[animationIdx];
+				if (!isArrInBounds<double>(animationKeys.keyFramesTimes, imageSz) || !isArrInBounds<unsigned int>(animationKeys.channelsNodesIdxs, imageSz) ||
+					!isArrInBounds<glm::vec3>(animationKeys.scales, imageSz) || !isArrInBounds<glm::quat>(animationKeys.rots, imageSz) ||
+					!isArrInBounds<glm::vec3>(animationKeys.translations, imageSz))
+					return false;
+			}
+		}
+
+		uint64_t const* scenesLocs = mappedPtr<uint64_t>(base, header->scenesLocsOffset);
+		for (unsigned int sceneIdx = 0; sceneIdx < header->scenesNr; sceneIdx++) {
+			if (!isArrInBounds<MappedSceneData>(scenesLocs[sceneIdx], 1, imageSz))
+				return false;
+			MappedSceneData const* sceneData = mappedPtr<MappedSceneData>(base, scenesLocs[sceneIdx]);
+			if (!isArrInBounds<MappedSceneModelData>(sceneData->sceneModelsData, imageSz))
+				return false;
+			MappedSceneModelData const* sceneModelsData = mappedPtr<MappedSceneModelData>(base, sceneData->sceneModelsData.offset);
+			for (unsigned int sceneModelIdx = 0; sceneModelIdx < sceneData->sceneModelsData.sz; sceneModelIdx++) {
+				if (sceneModelsData[sceneModelIdx].modelIdx >= header->modelsNr || !isArrInBounds<Transform3D>(sceneModelsData[sceneModelIdx].instancesTransformsInit, imageSz))
+					return false;
+			}
+		}
+
+		MappedQuantizedArr const* quantizedArrs = mappedPtr<MappedQuantizedArr>(base, header->quantizedArrsOffset);
+		for (unsigned int quantizedArrIdx = 0; quantizedArrIdx < header->quantizedArrsNr; quantizedArrIdx++) {
+			MappedQuantizedArr const& quantizedArr = quantizedArrs[quantizedArrIdx];
+			if (quantizedArr.type != QuantizationType::VEC3_U16 && quantizedArr.type != QuantizationType::QUAT_S16)
+				return false;
+			size_t fieldSz = quantizedArr.type == QuantizationType::VEC3_U16 ? sizeof(glm::vec3) : sizeof(glm::quat);
+			unsigned int componentsNr = quantizedArr.type == QuantizationType::VEC3_U16 ? 3 : 4;
+			if ((uint64_t)quantizedArr.fieldOffset + fieldSz > quantizedArr.stride || !isArrInBounds<char>(quantizedArr.dstOffset, (uint64_t)quantizedArr.valsNr * quantizedArr.stride, imageSz) ||
+				!isArrInBounds<uint16_t>(quantizedArr.srcOffset, (uint64_t)quantizedArr.valsNr * componentsNr, imageSz))
+				return false;
+		}
+
+		return true;
+	}
+
+	void MappedAssets::decompress(std::string const& assetsFileFullPath) {
+		// the header and the blocks table are checked against the mapping before anything is read through them
+		if (mappingSz < sizeof(CompressedAssetsHeader)) {
+			unmap();
+			throw std::ios_base::failure(assetsFileFullPath + " is corrupt (truncated header).");
+		}
+		CompressedAssetsHeader const* header = mappedPtr<CompressedAssetsHeader>(base, 0);
+		if (memcmp(header->magic, COMPRESSED_ASSETS_MAGIC, sizeof(header->magic)) != 0 || header->version != MAPPED_ASSETS_VERSION) {
+			unmap();
+			throw std::ios_base::failure(assetsFileFullPath + " is of an unsupported version.");
+		}
+		if (header->blockSz == 0 || header->blocksNr != (header->imageSz + header->blockSz - 1) / header->blockSz ||
+			header->blocksNr > (mappingSz - sizeof(CompressedAssetsHeader)) / sizeof(CompressedBlockDesc)) {
+			unmap();
+			throw std::ios_base::failure(assetsFileFullPath + " is corrupt (blocks table out of bounds).");
+		}
+		CompressedBlockDesc const* blocksDescs = mappedPtr<CompressedBlockDesc>(base, sizeof(CompressedAssetsHeader));
+		uint64_t blocksOffset = sizeof(CompressedAssetsHeader) + (uint64_t)header->blocksNr * sizeof(CompressedBlockDesc);
+		for (unsigned int blockIdx = 0; blockIdx < header->blocksNr; blockIdx++) {
+			CompressedBlockDesc const& blockDesc = blocksDescs[blockIdx];
+			uint64_t rawBlockSz = std::min<uint64_t>(header->blockSz, header->imageSz - (uint64_t)blockIdx * header->blockSz);
+			if (blockDesc.offset < blocksOffset || blockDesc.offset > mappingSz || blockDesc.sz > mappingSz - blockDesc.offset || blockDesc.sz > rawBlockSz) {
+				unmap();
+				throw std::ios_base::failure(assetsFileFullPath + " is corrupt (block out of bounds).");
+			}
+		}
+		image.resize(header->imageSz);
+
+		// blocks are handed out to the workers one at a time
+		std::atomic<unsigned int> nextBlockIdx{ 0 };
+		std::atomic<bool> isCorrupt{ false };
+		auto decompressBlocks = [&]() {
+			for (unsigned int blockIdx = nextBlockIdx++; blockIdx < header->blocksNr; blockIdx = nextBlockIdx++) {
+				CompressedBlockDesc const& blockDesc = blocksDescs[blockIdx];
+				char* rawBlock = &image[(size_t)blockIdx * header->blockSz];
+				size_t rawBlockSz = std::min<size_t>(header->blockSz, header->imageSz - (size_t)blockIdx * header->blockSz);
+				if (blockDesc.sz == rawBlockSz)
+					memcpy(rawBlock, base + blockDesc.offset, rawBlockSz);
+				else if (!lzDecompress(base + blockDesc.offset, blockDesc.sz, rawBlock, rawBlockSz))
+					isCorrupt = true;
+				if (crc32(rawBlock, rawBlockSz) != blockDesc.checksum)
+					isCorrupt = true;
+			}
+		};
+		unsigned int workersNr = std::min(std::max(std::thread::hardware_concurrency(), 1u), header->blocksNr);
+		std::vector<std::thread> workers;
+		for (unsigned int workerIdx = 1; workerIdx < workersNr; workerIdx++)
+			workers.emplace_back(decompressBlocks);
+		decompressBlocks();
+		for (std::thread& worker : workers)
+			worker.join();
+
+		unmap();
+		base = image.data();
+		if (isCorrupt)
+			throw std::ios_base::failure(assetsFileFullPath + " is corrupt (block checksum mismatch).");
+	}
+
+	void MappedAssets::dequantize() {
+		if (isMapped()) {
+			image.assign(base, base + mappingSz);
+			unmap();
+			base = image.data();
+		}
+
+		MappedAssetsHeader const* header = mappedPtr<MappedAssetsHeader>(base, 0);
+		MappedQuantizedArr const* quantizedArrs = mappedPtr<MappedQuantizedArr>(base, header->quantizedArrsOffset);
+		for (unsigned int quantizedArrIdx = 0; quantizedArrIdx < header->quantizedArrsNr; quantizedArrIdx++) {
+			MappedQuantizedArr const& quantizedArr = quantizedArrs[quantizedArrIdx];
+			uint16_t const* quantizedVals = mappedPtr<uint16_t>(base, quantizedArr.srcOffset);
+			char* dst = &image[quantizedArr.dstOffset + quantizedArr.fieldOffset];
+			for (unsigned int valIdx = 0; valIdx < quantizedArr.valsNr; valIdx++, dst += quantizedArr.stride) {
+				if (quantizedArr.type == QuantizationType::VEC3_U16) {
+					glm::vec3 val = glm::vec3(quantizedArr.min) + glm::vec3(quantizedArr.step) * glm::vec3(quantizedVals[0], quantizedVals[1], quantizedVals[2]);
+					memcpy(dst, &val, sizeof(val));
+					quantizedVals += 3;
+				}
+				else {
+					glm::quat val = glm::normalize(glm::quat((int16_t)quantizedVals[3], (int16_t)quantizedVals[0], (int16_t)quantizedVals[1], (int16_t)quantizedVals[2]));
+					memcpy(dst, &val, sizeof(val));
+					quantizedVals += 4;
+				}
+			}
+		}
+	}
+
+	MappedAssets::~MappedAssets() {
+		if (isMapped())
+			unmap();
+	}
+
+#if defined(_WIN32) || defined(__VC32__) && !defined(__CYGWIN__) && !defined(__SCITECH_SNAP__) /* Win32 and WinCE */
+	bool MappedAssets::map(std::string const& assetsFileFullPath) {
+		HANDLE file = CreateFileA(assetsFileFullPath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+		LARGE_INTEGER fileSz;
+		HANDLE mapping = GetFileSizeEx(file, &fileSz) ? CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+		void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+		if (!view) {
+			if (mapping)
+				CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+
+		fileHandle = file;
+		mappingHandle = mapping;
+		base = (char const*)view;
+		mappingSz = (size_t)fileSz.QuadPart;
+		return true;
+	}
+
+	void MappedAssets::unmap() {
+		UnmapViewOfFile(base);
+		CloseHandle((HANDLE)mappingHandle);
+		CloseHandle((HANDLE)fileHandle);
+		base = NULL;
+		mappingSz = 0;
+	}
+#else
+	bool MappedAssets::map(std::string const& assetsFileFullPath) {
+		int fd = open(assetsFileFullPath.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+		struct stat fileStat;
+		void* view = fstat(fd, &fileStat) == 0 && fileStat.st_size > 0 ? mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+		// the mapping holds its own reference to the file
+		close(fd);
+		if (view == MAP_FAILED)
+			return false;
+
+		base = (char const*)view;
+		mappingSz = fileStat.st_size;
+		return true;
+	}
+
+	void MappedAssets::unmap() {
+		munmap((void*)base, mappingSz);
+		base = NULL;
+		mappingSz = 0;
+	}
+#endif
+
+	unsigned int MappedAssets::getModelsNr() const {
+		return mappedPtr<MappedAssetsHeader>(base, 0)->modelsNr;
+	}
+
+	unsigned int MappedAssets::getScenesNr() const {
+		return mappedPtr<MappedAssetsHeader>(base, 0)->scenesNr;
+	}
+
+	ModelDescView MappedAssets::getModelDesc(unsigned int modelIdx) const {
+		MappedAssetsHeader const* header = mappedPtr<MappedAssetsHeader>(base, 0);
+#if DEBUG
+		if (modelIdx >= header->modelsNr)
+			throw std::out_of_range("Invalid model index.");
+#endif
+		MappedModelDesc const* mappedModelDesc = mappedPtr<MappedModelDesc>(base, mappedPtr<uint64_t>(base, header->modelsLocsOffset)[modelIdx]);
+		ModelDescView modelDesc;
+		modelDesc.colladaPath = mappedArrView<char>(base, mappedModelDesc->colladaPath);
+		modelDesc.verticesNr = mappedModelDesc->verticesNr;
+		modelDesc.meshesNr = mappedModelDesc->meshesNr;
+		modelDesc.verticesNrsPerMesh = mappedArrView<unsigned int>(base, mappedModelDesc->verticesNrsPerMesh);
+		modelDesc.verticesColorsNrTotal = mappedModelDesc->verticesColorsNrTotal;
+		modelDesc.extraColorsNrsPerMesh = mappedArrView<unsigned int>(base, mappedModelDesc->extraColorsNrsPerMesh);
+		modelDesc.extraColors.baseIdxsPerMesh = mappedArrView<unsigned int>(base, mappedModelDesc->extraColorsBaseIdxsPerMesh);
+		modelDesc.extraColors.nrsPerMesh = modelDesc.extraColorsNrsPerMesh;
+		modelDesc.extraColors.colors = mappedArrView<std::array<float, 4>>(base, mappedModelDesc->extraColors);
+		modelDesc.texesNr = mappedModelDesc->texesNr;
+		modelDesc.texesNrsPerMesh = mappedArrView<unsigned int>(base, mappedModelDesc->texesNrsPerMesh);
+		modelDesc.facesNr = mappedModelDesc->facesNr;
+		modelDesc.facesNrsPerMesh = mappedArrView<unsigned int>(base, mappedModelDesc->facesNrsPerMesh);
+		modelDesc.progIdx = mappedModelDesc->progIdx;
+		modelDesc.bonesNr = mappedModelDesc->bonesNr;
+		modelDesc.bonesNrsPerMesh = mappedArrView<unsigned int>(base, mappedModelDesc->bonesNrsPerMesh);
+		modelDesc.animationsDescs = mappedArrView<ModelDesc::AnimationDesc>(base, mappedModelDesc->animationsDescs);
+
+		modelDesc.vertices = mappedArrView<ModelDesc::VertexData>(base, mappedModelDesc->vertices);
+		modelDesc.idxs = mappedArrView<unsigned int>(base, mappedModelDesc->idxs);
+		modelDesc.submeshesDescs = mappedArrView<ModelDesc::SubmeshDesc>(base, mappedModelDesc->submeshesDescs);
+		modelDesc.lodsDescs = mappedArrView<ModelDesc::LodDesc>(base, mappedModelDesc->lodsDescs);
+		modelDesc.lodsIdxs = mappedArrView<unsigned int>(base, mappedModelDesc->lodsIdxs);
+		modelDesc.lodsSubmeshesDescs = mappedArrView<ModelDesc::SubmeshDesc>(base, mappedModelDesc->lodsSubmeshesDescs);
+		modelDesc.meshesTransforms = mappedArrView<glm::mat4>(base, mappedModelDesc->meshesTransforms);
+		modelDesc.bonesOffsets = mappedArrView<glm::mat4>(base, mappedModelDesc->bonesOffsets);
+		modelDesc.transformatsHierarchy = mappedArrView<ModelDesc::TransformatsHierarchyNodeDesc>(base, mappedModelDesc->transformatsHierarchy);
+		modelDesc.transformatsHierarchyMeshesIdxs = mappedArrView<unsigned int>(base, mappedModelDesc->transformatsHierarchyMeshesIdxs);
+		modelDesc.animationsKeys = ModelDescView::AnimationsKeysView(base, mappedPtr<MappedAnimationKeys>(base, mappedModelDesc->animationsKeys.offset), mappedModelDesc->animationsKeys.sz);
+
+		modelDesc.boundingSphereCenter = mappedModelDesc->boundingSphereCenter;
+		modelDesc.boundingSphereRadius = mappedModelDesc->boundingSphereRadius;
+		modelDesc.colliderData = mappedModelDesc->colliderData;
+
+		return modelDesc;
+	}
+
+	SceneDataView MappedAssets::getSceneData(unsigned int sceneIdx) const {
+		MappedAssetsHeader const* header = mappedPtr<MappedAssetsHeader>(base, 0);
+#if DEBUG
+		if (sceneIdx >= header->scenesNr)
+			throw std::out_of_range("Invalid scene index.");
+#endif
+		MappedSceneData const* mappedSceneData = mappedPtr<MappedSceneData>(base, mappedPtr<uint64_t>(base, header->scenesLocsOffset)[sceneIdx]);
+		SceneDataView sceneData;
+		sceneData.staticModelsNr = mappedSceneData->staticModelsNr;
+		sceneData.sceneModelsData = SceneDataView::SceneModelsDataView(base, mappedPtr<MappedSceneModelData>(base, mappedSceneData->sceneModelsData.offset), mappedSceneData->sceneModelsData.sz);
+		memcpy(sceneData.collisionPrimitives3DInstancesNrsMaxima.data(), mappedSceneData->collisionPrimitives3DInstancesNrsMaxima, sizeof(mappedSceneData->collisionPrimitives3DInstancesNrsMaxima));
+		memcpy(sceneData.collisionPrimitives2DInstancesNrsMaxima.data(), mappedSceneData->collisionPrimitives2DInstancesNrsMaxima, sizeof(mappedSceneData->collisionPrimitives2DInstancesNrsMaxima));
+
+		return sceneData;
+	}
+
+	void MappedAssets::getSceneAssets(unsigned int sceneIdx, SceneDataView& outSceneData, std::vector<ModelDescView>& outModelDescs, std::vector<unsigned int>& outModelSceneModelIdxsMap) const {
+		outSceneData = getSceneData(sceneIdx);
+		unsigned int sceneModelsNr = outSceneData.sceneModelsData.size();
+		outModelDescs.resize(sceneModelsNr);
+		outModelSceneModelIdxsMap.resize(getModelsNr());
+
+		unsigned int staticModelIdx = 0;
+		unsigned int mobileModelIdx = 0;
+		for (unsigned int sceneModelIdx = 0; sceneModelIdx < sceneModelsNr; ++sceneModelIdx) {
+			SceneDataView::SceneModelDataView sceneModelData = outSceneData.sceneModelsData[sceneModelIdx];
+			unsigned int modelIdxMapped = sceneModelData.isStatic ? staticModelIdx++ : sceneModelsNr - 1 - mobileModelIdx++;
+			outModelSceneModelIdxsMap[sceneModelData.modelIdx] = modelIdxMapped;
+			outModelDescs[modelIdxMapped] = getModelDesc(sceneModelData.modelIdx);
+		}
+	}
+
+	ModelDescView::AnimationKeysView ModelDescView::AnimationsKeysView::operator[](unsigned int animationIdx) const {
+		MappedAnimationKeys const& mappedAnimationKeys = animationsKeys[animationIdx];
+		return { mappedArrView<double>(mappingBase, mappedAnimationKeys.keyFramesTimes),
+				 mappedArrView<unsigned int>(mappingBase, mappedAnimationKeys.channelsNodesIdxs),
+				 mappedArrView<glm::vec3>(mappingBase, mappedAnimationKeys.scales),
+				 mappedArrView<glm::quat>(mappingBase, mappedAnimationKeys.rots),
+				 mappedArrView<glm::vec3>(mappingBase, mappedAnimationKeys.translations) };
+	}
+
+	void copyModelDesc(ModelDescView const& modelDescView, ModelDesc& outModelDesc) {
+		outModelDesc.colladaPath.assign(modelDescView.colladaPath.begin(), modelDescView.colladaPath.end());
+		outModelDesc.verticesNr = modelDescView.verticesNr;
+		outModelDesc.meshesNr = modelDescView.meshesNr;
+		outModelDesc.verticesNrsPerMesh.assign(modelDescView.verticesNrsPerMesh.begin(), modelDescView.verticesNrsPerMesh.end());
+		outModelDesc.verticesColorsNrTotal = modelDescView.verticesColorsNrTotal;
+		outModelDesc.extraColorsNrsPerMesh.assign(modelDescView.extraColorsNrsPerMesh.begin(), modelDescView.extraColorsNrsPerMesh.end());
+		outModelDesc.extraColors.resize(modelDescView.extraColorsNrsPerMesh.size());
+		for (unsigned int meshIdx = 0; meshIdx < modelDescView.extraColorsNrsPerMesh.size(); meshIdx++) {
+			ArrView<std::array<float, 4>> meshExtraColors = modelDescView.extraColors[meshIdx];
+			outModelDesc.extraColors[meshIdx].assign(meshExtraColors.begin(), meshExtraColors.end());
+		}
+		outModelDesc.texesNr = modelDescView.texesNr;
+		outModelDesc.texesNrsPerMesh.assign(modelDescView.texesNrsPerMesh.begin(), modelDescView.texesNrsPerMesh.end());
+		outModelDesc.facesNr = modelDescView.facesNr;
+		outModelDesc.facesNrsPerMesh.assign(modelDescView.facesNrsPerMesh.begin(), modelDescView.facesNrsPerMesh.end());
+		outModelDesc.progIdx = modelDescView.progIdx;
+		outModelDesc.bonesNr = modelDescView.bonesNr;
+		outModelDesc.bonesNrsPerMesh.assign(modelDescView.bonesNrsPerMesh.begin(), modelDescView.bonesNrsPerMesh.end());
+		outModelDesc.animationsDescs.assign(modelDescView.animationsDescs.begin(), modelDescView.animationsDescs.end());
+
+		outModelDesc.vertices.assign(modelDescView.vertices.begin(), modelDescView.vertices.end());
+		outModelDesc.idxs.assign(modelDescView.idxs.begin(), modelDescView.idxs.end());
+		outModelDesc.submeshesDescs.assign(modelDescView.submeshesDescs.begin(), modelDescView.submeshesDescs.end());
+		outModelDesc.lodsDescs.assign(modelDescView.lodsDescs.begin(), modelDescView.lodsDescs.end());
+		outModelDesc.lodsIdxs.assign(modelDescView.lodsIdxs.begin(), modelDescView.lodsIdxs.end());
+		outModelDesc.lodsSubmeshesDescs.assign(modelDescView.lodsSubmeshesDescs.begin(), modelDescView.lodsSubmeshesDescs.end());
+		outModelDesc.meshesTransforms.assign(modelDescView.meshesTransforms.begin(), modelDescView.meshesTransforms.end());
+		outModelDesc.bonesOffsets.assign(modelDescView.bonesOffsets.begin(), modelDescView.bonesOffsets.end());
+		outModelDesc.transformatsHierarchy.assign(modelDescView.transformatsHierarchy.begin(), modelDescView.transformatsHierarchy.end());
+		outModelDesc.transformatsHierarchyMeshesIdxs.assign(modelDescView.transformatsHierarchyMeshesIdxs.begin(), modelDescView.transformatsHierarchyMeshesIdxs.end());
+		outModelDesc.animationsKeys.resize(modelDescView.animationsKeys.size());
+		for (unsigned int animationIdx = 0; animationIdx < modelDescView.animationsKeys.size(); animationIdx++) {
+			ModelDescView::AnimationKeysView animationKeysView = modelDescView.animationsKeys[animationIdx];
+			ModelDesc::AnimationKeys& animationKeys = outModelDesc.animationsKeys[animationIdx];
+			animationKeys.keyFramesTimes.assign(animationKeysView.keyFramesTimes.begin(), animationKeysView.keyFramesTimes.end());
+			animationKeys.channelsNodesIdxs.assign(animationKeysView.channelsNodesIdxs.begin(), animationKeysView.channelsNodesIdxs.end());
+			animationKeys.scales.assign(animationKeysView.scales.begin(), animationKeysView.scales.end());
+			animationKeys.rots.assign(animationKeysView.rots.begin(), animationKeysView.rots.end());
+			animationKeys.translations.assign(animationKeysView.translations.begin(), animationKeysView.translations.end());
+		}
+
+		outModelDesc.boundingSphereCenter = modelDescView.boundingSphereCenter;
+		outModelDesc.boundingSphereRadius = modelDescView.boundingSphereRadius;
+		outModelDesc.colliderData = modelDescView.colliderData;
+	}
+
+	SceneDataView::SceneModelDataView SceneDataView::SceneModelsDataView::operator[](unsigned int sceneModelIdx) const {
+		MappedSceneModelData const& mappedSceneModelData = sceneModelsData[sceneModelIdx];
+		return { mappedSceneModelData.modelIdx, mappedSceneModelData.isStatic != 0, mappedSceneModelData.instancesNrMax,
+				 mappedArrView<Transform3D>(mappingBase, mappedSceneModelData.instancesTransformsInit) };
+	}
+
+} // namespace Corium3D
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "AssetsOps.h"
+
+#include <string>
+#include <vector>
+#include <array>
+
+namespace Corium3D {
+
+	// Assets file version laid out for memory mapping - a header, offsets tables of the models and the scenes, and fixed size
+	// records whose arrays are referenced by 16 bytes aligned file offsets. Nothing is parsed on load: the views below point
+	// straight into the mapping.
+	const char MAPPED_ASSETS_MAGIC[4] = { 'C', '3', 'D', 'M' };
+	// the mapped layout split to independently compressed blocks (see AssetsCompressionParams)
+	const char COMPRESSED_ASSETS_MAGIC[4] = { 'C', '3', 'D', 'Z' };
+	const unsigned int MAPPED_ASSETS_VERSION = 3;
+
+	struct AssetsCompressionParams {
+		bool isCompressed = false;
+		unsigned int blockSz = 1 << 18;
+		// vertices positions and animations scales and translations are stored as 16 bits per component, over their arrays'
+		// ranges, and rotations as 16 bits per quaternion component. an array is quantized only if its maximal error
+		// (half a quantization step, in the values' units) is within the bound. 0 - no quantization
+		float positionsErrorMax = 0.0f;
+		float animationKeysErrorMax = 0.0f;
+	};
+
+	template <class T>
+	class ArrView {
+	public:
+		ArrView() {}
+		ArrView(T const* _arr, unsigned int _sz) : arr(_arr), sz(_sz) {}
+		T const& operator[](unsigned int idx) const { return arr[idx]; }
+		T const* data() const { return arr; }
+		T const* begin() const { return arr; }
+		T const* end() const { return arr + sz; }
+		unsigned int size() const { return sz; }
+		bool empty() const { return sz == 0; }
+
+	private:
+		T const* arr = NULL;
+		unsigned int sz = 0;
+	};
+
+	struct MappedAnimationKeys;
+	struct MappedSceneModelData;
+
+	// ModelDesc's counterpart - same fields, but the collections are views into the mapping
+	struct ModelDescView {
+		struct ExtraColorsView {
+			ArrView<unsigned int> baseIdxsPerMesh;
+			ArrView<unsigned int> nrsPerMesh;
+			ArrView<std::array<float, 4>> colors;
+
+			ArrView<std::array<float, 4>> operator[](unsigned int meshIdx) const { return ArrView<std::array<float, 4>>(colors.data() + baseIdxsPerMesh[meshIdx], nrsPerMesh[meshIdx]); }
+		};
+
+		struct AnimationKeysView {
+			ArrView<double> keyFramesTimes;
+			ArrView<unsigned int> channelsNodesIdxs;
+			ArrView<glm::vec3> scales;
+			ArrView<glm::quat> rots;
+			ArrView<glm::vec3> translations;
+		};
+
+		class AnimationsKeysView {
+		public:
+			AnimationsKeysView() {}
+			AnimationsKeysView(char const* _mappingBase, MappedAnimationKeys const* _animationsKeys, unsigned int _animationsNr) : mappingBase(_mappingBase), animationsKeys(_animationsKeys), animationsNr(_animationsNr) {}
+			AnimationKeysView operator[](unsigned int animationIdx) const;
+			unsigned int size() const { return animationsNr; }
+
+		private:
+			char const* mappingBase = NULL;
+			MappedAnimationKeys const* animationsKeys = NULL;
+			unsigned int animationsNr = 0;
+		};
+
+		ArrView<char> colladaPath;
+		unsigned int verticesNr;
+		unsigned int meshesNr;
+		ArrView<unsigned int> verticesNrsPerMesh;
+		unsigned int verticesColorsNrTotal;
+		ArrView<unsigned int> extraColorsNrsPerMesh;
+		ExtraColorsView extraColors;
+		unsigned int texesNr;
+		ArrView<unsigned int> texesNrsPerMesh;
+		unsigned int facesNr;
+		ArrView<unsigned int> facesNrsPerMesh;
+		unsigned int progIdx;
+		unsigned int bonesNr;
+		ArrView<unsigned int> bonesNrsPerMesh;
+		ArrView<ModelDesc::AnimationDesc> animationsDescs;
+
+		ArrView<ModelDesc::VertexData> vertices;
+		ArrView<unsigned int> idxs;
+		ArrView<ModelDesc::SubmeshDesc> submeshesDescs;
+		ArrView<ModelDesc::LodDesc> lodsDescs;
+		ArrView<unsigned int> lodsIdxs;
+		ArrView<ModelDesc::SubmeshDesc> lodsSubmeshesDescs;
+		ArrView<glm::mat4> meshesTransforms;
+		ArrView<glm::mat4> bonesOffsets;
+		ArrView<ModelDesc::TransformatsHierarchyNodeDesc> transformatsHierarchy;
+		ArrView<unsigned int> transformatsHierarchyMeshesIdxs;
+		AnimationsKeysView animationsKeys;
+
+		glm::vec3 boundingSphereCenter;
+		float boundingSphereRadius;
+
+		ColliderData colliderData;
+	};
+
+	// SceneData's counterpart
+	struct SceneDataView {
+		struct SceneModelDataView {
+			unsigned int modelIdx;
+			bool isStatic;
+			unsigned int instancesNrMax;
+			ArrView<Transform3D> instancesTransformsInit;
+		};
+
+		class SceneModelsDataView {
+		public:
+			SceneModelsDataView() {}
+			SceneModelsDataView(char const* _mappingBase, MappedSceneModelData const* _sceneModelsData, unsigned int _sceneModelsNr) : mappingBase(_mappingBase), sceneModelsData(_sceneModelsData), sceneModelsNr(_sceneModelsNr) {}
+			SceneModelDataView operator[](unsigned int sceneModelIdx) const;
+			unsigned int size() const { return sceneModelsNr; }
+
+		private:
+			char const* mappingBase = NULL;
+			MappedSceneModelData const* sceneModelsData = NULL;
+			unsigned int sceneModelsNr = 0;
+		};
+
+		unsigned int staticModelsNr;
+		SceneModelsDataView sceneModelsData;
+		std::array<unsigned int, CollisionPrimitive3DType::__PRIMITIVE3D_TYPES_NR__> collisionPrimitives3DInstancesNrsMaxima{};
+		std::array<unsigned int, CollisionPrimitive2DType::__PRIMITIVE2D_TYPES_NR__> collisionPrimitives2DInstancesNrsMaxima{};
+	};
+
+	// An assets file mapped to memory. Files of the stream format (writeAssetsFile) are read out once and laid out in
+	// memory the same way, so the views work alike for both. Compressed or quantized files are decompressed (on as many
+	// threads as there are cores) and dequantized into memory owned by the MappedAssets.
+	// REMINDER: the views are valid only as long as their MappedAssets lives
+	class MappedAssets {
+	public:
+		MappedAssets(std::string const& assetsFileFullPath);
+		MappedAssets(MappedAssets const&) = delete;
+		~MappedAssets();
+		unsigned int getModelsNr() const;
+		unsigned int getScenesNr() const;
+		ModelDescView getModelDesc(unsigned int modelIdx) const;
+		SceneDataView getSceneData(unsigned int sceneIdx) const;
+		// readSceneAssets()'s counterpart: the scene's models are ordered statics first, mobiles last
+		void getSceneAssets(unsigned int sceneIdx, SceneDataView& outSceneData, std::vector<ModelDescView>& outModelDescs, std::vector<unsigned int>& outModelSceneModelIdxsMap) const;
+		bool isMapped() const { return mappingSz > 0; }
+		size_t getSz() const { return isMapped() ? mappingSz : image.size(); }
+
+	private:
+		char const* base = NULL;
+		size_t mappingSz = 0;
+		std::vector<char> image;
+	#if defined(_WIN32) || defined(__VC32__) && !defined(__CYGWIN__) && !defined(__SCITECH_SNAP__)
+		void* fileHandle = NULL;
+		void* mappingHandle = NULL;
+	#endif
+
+		bool map(std::string const& assetsFileFullPath);
+		void unmap();
+		void decompress(std::string const& assetsFileFullPath);
+		void dequantize();
+		bool isLayoutInBounds() const;
+	};
+
+	bool isMappedAssetsFile(std::string const& assetsFileFullPath);
+
+	// a view's deep copy - genMappedAssetsImage() of the copy reproduces the view's model as is
+	void copyModelDesc(ModelDescView const& modelDescView, ModelDesc& outModelDesc);
+
+	void genMappedAssetsImage(std::vector<ModelDesc const*> const& modelDescs, std::vector<SceneData const*> const& scenesData, std::vector<char>& outImage,
+							  AssetsCompressionParams const& compressionParams = AssetsCompressionParams());
+
+	void writeMappedAssetsFile(std::string const& assetsFileFullPath, std::vector<ModelDesc const*> const& modelDescs, std::vector<SceneData const*> const& scenesData,
+							   AssetsCompressionParams const& compressionParams = AssetsCompressionParams());
+
+} // namespace Corium3D
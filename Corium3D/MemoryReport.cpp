@@ -0,0 +1,102 @@
+#include "MemoryReport.h"
+
+#include <sstream>
+
+namespace Corium3DUtils {
+
+	static void writeJsonStr(std::ostream& outStream, std::string const& str) {
+		outStream << '"';
+		for (char c : str) {
+			if (c == '"' || c == '\\')
+				outStream << '\\';
+			outStream << c;
+		}
+		outStream << '"';
+	}
+
+	void MemoryReport::addEntry(std::string const& subsystem, std::string const& name, size_t unitSz, size_t capacity, size_t usedNr, size_t usedNrMax) {
+		entries.push_back({ subsystem, name, false, unitSz, capacity, usedNr, usedNrMax });
+	}
+
+	void MemoryReport::addGpuBuffer(std::string const& subsystem, std::string const& name, size_t unitSz, size_t capacity) {
+		entries.push_back({ subsystem, name, true, unitSz, capacity, capacity, capacity });
+	}
+
+	size_t MemoryReport::getReservedBytesNr() const {
+		size_t reservedBytesNr = 0;
+		for (Entry const& entry : entries)
+			reservedBytesNr += entry.getReservedBytesNr();
+
+		return reservedBytesNr;
+	}
+
+	size_t MemoryReport::getReservedBytesNr(std::string const& subsystem) const {
+		size_t reservedBytesNr = 0;
+		for (Entry const& entry : entries) {
+			if (entry.subsystem == subsystem)
+				reservedBytesNr += entry.getReservedBytesNr();
+		}
+
+		return reservedBytesNr;
+	}
+
+	size_t MemoryReport::getUsedBytesNrMax(std::string const& subsystem) const {
+		size_t usedBytesNrMax = 0;
+		for (Entry const& entry : entries) {
+			if (entry.subsystem == subsystem)
+				usedBytesNrMax += entry.getUsedBytesNrMax();
+		}
+
+		return usedBytesNrMax;
+	}
+
+	void MemoryReport::writeJson(std::ostream& outStream) const {
+		std::vector<std::string> subsystems;
+		for (Entry const& entry : entries) {
+			bool isListed = false;
+			for (std::string const& subsystem : subsystems)
+				isListed |= subsystem == entry.subsystem;
+			if (!isListed)
+				subsystems.push_back(entry.subsystem);
+		}
+
+		size_t cpuReservedBytesNr = 0, gpuReservedBytesNr = 0;
+		for (Entry const& entry : entries)
+			(entry.isGpu ? gpuReservedBytesNr : cpuReservedBytesNr) += entry.getReservedBytesNr();
+
+		outStream << "{\n\t\"cpuReservedBytes\": " << cpuReservedBytesNr << ",\n\t\"gpuReservedBytes\": " << gpuReservedBytesNr << ",\n\t\"subsystems\": [";
+		for (unsigned int subsystemIdx = 0; subsystemIdx < subsystems.size(); subsystemIdx++) {
+			std::string const& subsystem = subsystems[subsystemIdx];
+			size_t usedBytesNr = 0;
+			for (Entry const& entry : entries) {
+				if (entry.subsystem == subsystem)
+					usedBytesNr += entry.getUsedBytesNr();
+			}
+
+			outStream << (subsystemIdx > 0 ? ",\n" : "\n") << "\t\t{\n\t\t\t\"name\": ";
+			writeJsonStr(outStream, subsystem);
+			outStream << ",\n\t\t\t\"reservedBytes\": " << getReservedBytesNr(subsystem) << ", \"usedBytes\": " << usedBytesNr << ", \"usedBytesMax\": " << getUsedBytesNrMax(subsystem) << ",\n\t\t\t\"entries\": [";
+			bool isFirstEntry = true;
+			for (Entry const& entry : entries) {
+				if (entry.subsystem != subsystem)
+					continue;
+
+				outStream << (isFirstEntry ? "\n" : ",\n") << "\t\t\t\t{ \"name\": ";
+				writeJsonStr(outStream, entry.name);
+				outStream << ", \"gpu\": " << (entry.isGpu ? "true" : "false") << ", \"unitBytes\": " << entry.unitSz <<
+					", \"capacity\": " << entry.capacity << ", \"used\": " << entry.usedNr << ", \"usedMax\": " << entry.usedNrMax <<
+					", \"reservedBytes\": " << entry.getReservedBytesNr() << ", \"usedBytes\": " << entry.getUsedBytesNr() << ", \"usedBytesMax\": " << entry.getUsedBytesNrMax() << " }";
+				isFirstEntry = false;
+			}
+			outStream << "\n\t\t\t]\n\t\t}";
+		}
+		outStream << "\n\t]\n}\n";
+	}
+
+	std::string MemoryReport::toJson() const {
+		std::ostringstream jsonStream;
+		writeJson(jsonStream);
+		return jsonStream.str();
+	}
+
+} // namespace Corium3DUtils
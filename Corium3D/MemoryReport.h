@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace Corium3DUtils {
+
+	// Memory budget snapshot - every subsystem adds an entry per pool or buffer it sized, with its capacity,
+	// current and high-water usage (in units of unitSz bytes). GPU buffers' sizes are the ones tracked on the CPU side.
+	class MemoryReport {
+	public:
+		struct Entry {
+			std::string subsystem;
+			std::string name;
+			bool isGpu;
+			size_t unitSz;
+			size_t capacity;
+			size_t usedNr;
+			size_t usedNrMax;
+
+			size_t getReservedBytesNr() const { return unitSz * capacity; }
+			size_t getUsedBytesNr() const { return unitSz * usedNr; }
+			size_t getUsedBytesNrMax() const { return unitSz * usedNrMax; }
+		};
+
+		void addEntry(std::string const& subsystem, std::string const& name, size_t unitSz, size_t capacity, size_t usedNr, size_t usedNrMax);
+		// REMINDER: the GPU can't be asked how much of a buffer is in use - GPU buffers are reported fully used
+		void addGpuBuffer(std::string const& subsystem, std::string const& name, size_t unitSz, size_t capacity);
+		// TPool is a ChunkedObjPool or a ChunkedObjPoolIteratable
+		template <class TPool>
+		void addPool(std::string const& subsystem, std::string const& name, TPool const& pool);
+		std::vector<Entry> const& getEntries() const { return entries; }
+		size_t getReservedBytesNr() const;
+		size_t getReservedBytesNr(std::string const& subsystem) const;
+		size_t getUsedBytesNrMax(std::string const& subsystem) const;
+		// entries grouped by subsystem, in the order the subsystems were first added
+		void writeJson(std::ostream& outStream) const;
+		std::string toJson() const;
+
+	private:
+		std::vector<Entry> entries;
+	};
+
+	template <class TPool>
+	void MemoryReport::addPool(std::string const& subsystem, std::string const& name, TPool const& pool) {
+		size_t capacity = pool.getCapacity();
+		size_t unitSz = capacity > 0 ? pool.getReservedBytesNr() / capacity : 0;
+		addEntry(subsystem, name, unitSz, capacity, pool.getAcquiredObjsNr(), pool.getAcquiredObjsNrMax());
+	}
+
+} // namespace Corium3DUtils
@@ -0,0 +1,394 @@
+#include "OcclusionCuller.h"
+
+#include "Profiler.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <map>
+#include <tuple>
+
+#ifdef CORIUM3D_OCCLUSION_CULLER_SSE
+	#include <emmintrin.h>
+#endif
+
+namespace Corium3D {
+
+	// twice a triangle's area, in square pixels. a smaller one covers no pixel whole
+	const float TRIANGLE_DOUBLE_AREA_MIN = 1.0f;
+	const float CLIP_W_MIN = 1e-6f;
+
+	OcclusionCuller::OcclusionCuller(Corium3DUtils::ThreadPool* _threadPool) : threadPool(_threadPool) {
+		unsigned int pyramidSz = 0;
+		for (unsigned int levelIdx = 0; levelIdx < LEVELS_NR; levelIdx++) {
+			levelsBaseIdxs[levelIdx] = pyramidSz;
+			pyramidSz += (DEPTH_BUFFER_WIDTH >> levelIdx) * std::max(DEPTH_BUFFER_HEIGHT >> levelIdx, 1u);
+		}
+		depthPyramid.assign(pyramidSz, 1.0f);
+	}
+
+	void OcclusionCuller::genTrianglesAdjacencies(glm::vec3 const* vertices, unsigned int const* idxs, unsigned int idxsNr, std::vector<unsigned int>& outAdjacencies) {
+		std::map<std::tuple<float, float, float>, unsigned int> positionsIds;
+		std::vector<unsigned int> idxsPositionsIds(idxsNr);
+		for (unsigned int idxIdx = 0; idxIdx < idxsNr; idxIdx++) {
+			glm::vec3 const& vertex = vertices[idxs[idxIdx]];
+			idxsPositionsIds[idxIdx] = positionsIds.emplace(std::make_tuple(vertex.x, vertex.y, vertex.z), positionsIds.size()).first->second;
+		}
+
+		// the triangles' edges (3 * triangleIdx + edgeIdx) of each edge, by its positions
+		struct EdgeTrianglesEdges {
+			unsigned int trianglesEdges[2];
+			unsigned int trianglesNr;
+		};
+		std::map<std::pair<unsigned int, unsigned int>, EdgeTrianglesEdges> edgesTrianglesEdges;
+		unsigned int trianglesNr = idxsNr / 3;
+		outAdjacencies.assign(3 * trianglesNr, NO_ADJACENT_TRIANGLE);
+		for (unsigned int triangleEdgeIdx = 0; triangleEdgeIdx < 3 * trianglesNr; triangleEdgeIdx++) {
+			unsigned int edgeStartId = idxsPositionsIds[triangleEdgeIdx];
+			unsigned int edgeEndId = idxsPositionsIds[triangleEdgeIdx - triangleEdgeIdx % 3 + (triangleEdgeIdx + 1) % 3];
+			if (edgeStartId == edgeEndId)
+				continue;
+
+			EdgeTrianglesEdges& edgeTrianglesEdges = edgesTrianglesEdges[std::make_pair(std::min(edgeStartId, edgeEndId), std::max(edgeStartId, edgeEndId))];
+			if (edgeTrianglesEdges.trianglesNr < 2)
+				edgeTrianglesEdges.trianglesEdges[edgeTrianglesEdges.trianglesNr] = triangleEdgeIdx;
+			if (++edgeTrianglesEdges.trianglesNr == 2) {
+				outAdjacencies[edgeTrianglesEdges.trianglesEdges[0]] = triangleEdgeIdx / 3;
+				outAdjacencies[triangleEdgeIdx] = edgeTrianglesEdges.trianglesEdges[0] / 3;
+			}
+			else if (edgeTrianglesEdges.trianglesNr == 3)
+				outAdjacencies[edgeTrianglesEdges.trianglesEdges[0]] = outAdjacencies[edgeTrianglesEdges.trianglesEdges[1]] = NO_ADJACENT_TRIANGLE;
+		}
+	}
+
+	void OcclusionCuller::rasterizeOccluders(glm::mat4 const& _vpMat, Occluder const* _occluders, unsigned int _occludersNr) {
+		PROFILE_ZONE("OcclusionCuller::rasterizeOccluders");
+		vpMat = _vpMat;
+		occluders = _occluders;
+		occludersNr = _occludersNr;
+		if (occludersClipVertices.size() < occludersNr) {
+			occludersClipVertices.resize(occludersNr);
+			occludersTrianglesFacings.resize(occludersNr);
+			occludersTriangles.resize(occludersNr);
+		}
+
+		if (threadPool) {
+			threadPool->parallelFor(occludersNr, [this](unsigned int occluderIdx) { setupOccluderTriangles(occluderIdx); });
+			threadPool->parallelFor(BANDS_NR, [this](unsigned int bandIdx) { rasterizeBand(bandIdx); });
+		}
+		else {
+			for (unsigned int occluderIdx = 0; occluderIdx < occludersNr; occluderIdx++)
+				setupOccluderTriangles(occluderIdx);
+			for (unsigned int bandIdx = 0; bandIdx < BANDS_NR; bandIdx++)
+				rasterizeBand(bandIdx);
+		}
+		for (unsigned int levelIdx = BAND_LEVELS_NR; levelIdx < LEVELS_NR; levelIdx++)
+			buildLevelRows(levelIdx, 0, std::max(DEPTH_BUFFER_HEIGHT >> levelIdx, 1u));
+
+		rasterizedTrianglesNr = 0;
+		for (unsigned int occluderIdx = 0; occluderIdx < occludersNr; occluderIdx++)
+			rasterizedTrianglesNr += occludersTriangles[occluderIdx].size();
+		occluders = NULL;
+	}
+
+	// the AABB's corners are projected, 4 at a time. the depth over a box is nearest at one of its corners
+	bool OcclusionCuller::isAABBHidden(AABB3D const& aabb) const {
+		glm::vec3 minVertex = aabb.getMinVertex();
+		glm::vec3 maxVertex = aabb.getMaxVertex();
+		const float halfWidth = 0.5f * DEPTH_BUFFER_WIDTH;
+		const float halfHeight = 0.5f * DEPTH_BUFFER_HEIGHT;
+		float minX, maxX, minY, maxY, nearestDepth;
+	#ifdef CORIUM3D_OCCLUSION_CULLER_SSE
+		__m128 xs = _mm_setr_ps(minVertex.x, maxVertex.x, minVertex.x, maxVertex.x);
+		__m128 ys = _mm_setr_ps(minVertex.y, minVertex.y, maxVertex.y, maxVertex.y);
+		__m128 minXs = _mm_set1_ps(FLT_MAX), minYs = minXs, depths = minXs;
+		__m128 maxXs = _mm_set1_ps(-FLT_MAX), maxYs = maxXs;
+		__m128 clipWMin = _mm_set1_ps(CLIP_W_MIN);
+		__m128 zero = _mm_setzero_ps();
+		__m128 half = _mm_set1_ps(0.5f);
+		for (unsigned int zIdx = 0; zIdx < 2; zIdx++) {
+			__m128 zs = _mm_set1_ps(zIdx ? maxVertex.z : minVertex.z);
+			__m128 clipCoords[4];
+			for (unsigned int coordIdx = 0; coordIdx < 4; coordIdx++) {
+				clipCoords[coordIdx] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(vpMat[0][coordIdx]), xs), _mm_mul_ps(_mm_set1_ps(vpMat[1][coordIdx]), ys)),
+												  _mm_add_ps(_mm_mul_ps(_mm_set1_ps(vpMat[2][coordIdx]), zs), _mm_set1_ps(vpMat[3][coordIdx])));
+			}
+			__m128 behindNearMask = _mm_or_ps(_mm_cmplt_ps(clipCoords[3], clipWMin), _mm_cmplt_ps(_mm_add_ps(clipCoords[2], clipCoords[3]), zero));
+			if (_mm_movemask_ps(behindNearMask))
+				return false;
+
+			__m128 invWs = _mm_div_ps(_mm_set1_ps(1.0f), clipCoords[3]);
+			__m128 screenXs = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(clipCoords[0], invWs), _mm_set1_ps(halfWidth)), _mm_set1_ps(halfWidth));
+			__m128 screenYs = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(clipCoords[1], invWs), _mm_set1_ps(halfHeight)), _mm_set1_ps(halfHeight));
+			minXs = _mm_min_ps(minXs, screenXs);
+			maxXs = _mm_max_ps(maxXs, screenXs);
+			minYs = _mm_min_ps(minYs, screenYs);
+			maxYs = _mm_max_ps(maxYs, screenYs);
+			depths = _mm_min_ps(depths, _mm_add_ps(_mm_mul_ps(_mm_mul_ps(clipCoords[2], invWs), half), half));
+		}
+		float lanes[5][4];
+		_mm_storeu_ps(lanes[0], minXs);
+		_mm_storeu_ps(lanes[1], maxXs);
+		_mm_storeu_ps(lanes[2], minYs);
+		_mm_storeu_ps(lanes[3], maxYs);
+		_mm_storeu_ps(lanes[4], depths);
+		minX = std::min(std::min(lanes[0][0], lanes[0][1]), std::min(lanes[0][2], lanes[0][3]));
+		maxX = std::max(std::max(lanes[1][0], lanes[1][1]), std::max(lanes[1][2], lanes[1][3]));
+		minY = std::min(std::min(lanes[2][0], lanes[2][1]), std::min(lanes[2][2], lanes[2][3]));
+		maxY = std::max(std::max(lanes[3][0], lanes[3][1]), std::max(lanes[3][2], lanes[3][3]));
+		nearestDepth = std::min(std::min(lanes[4][0], lanes[4][1]), std::min(lanes[4][2], lanes[4][3]));
+	#else
+		minX = minY = nearestDepth = FLT_MAX;
+		maxX = maxY = -FLT_MAX;
+		for (unsigned int cornerIdx = 0; cornerIdx < 8; cornerIdx++) {
+			glm::vec4 corner(cornerIdx & 1 ? maxVertex.x : minVertex.x, cornerIdx & 2 ? maxVertex.y : minVertex.y, cornerIdx & 4 ? maxVertex.z : minVertex.z, 1.0f);
+			glm::vec4 clipCorner = vpMat * corner;
+			if (clipCorner.w < CLIP_W_MIN || clipCorner.z + clipCorner.w < 0.0f)
+				return false;
+
+			float invW = 1.0f / clipCorner.w;
+			float screenX = clipCorner.x * invW * halfWidth + halfWidth;
+			float screenY = clipCorner.y * invW * halfHeight + halfHeight;
+			minX = std::min(minX, screenX);
+			maxX = std::max(maxX, screenX);
+			minY = std::min(minY, screenY);
+			maxY = std::max(maxY, screenY);
+			nearestDepth = std::min(nearestDepth, 0.5f * clipCorner.z * invW + 0.5f);
+		}
+	#endif
+		// out of the buffer altogether - it is the frustum culling's to reject
+		if (maxX < 0.0f || maxY < 0.0f || minX >= DEPTH_BUFFER_WIDTH || minY >= DEPTH_BUFFER_HEIGHT)
+			return false;
+
+		unsigned int pixelsXsMin = (unsigned int)std::max(minX, 0.0f);
+		unsigned int pixelsXsMax = (unsigned int)std::min(maxX, DEPTH_BUFFER_WIDTH - 1.0f);
+		unsigned int pixelsYsMin = (unsigned int)std::max(minY, 0.0f);
+		unsigned int pixelsYsMax = (unsigned int)std::min(maxY, DEPTH_BUFFER_HEIGHT - 1.0f);
+		unsigned int levelIdx = 0;
+		while ((pixelsXsMax >> levelIdx) - (pixelsXsMin >> levelIdx) > 1 || (pixelsYsMax >> levelIdx) - (pixelsYsMin >> levelIdx) > 1)
+			levelIdx++;
+
+		float const* level = getDepthPyramidLevel(levelIdx);
+		unsigned int levelWidth = DEPTH_BUFFER_WIDTH >> levelIdx;
+		float farthestDepth = 0.0f;
+		for (unsigned int texelY = pixelsYsMin >> levelIdx; texelY <= pixelsYsMax >> levelIdx; texelY++) {
+			for (unsigned int texelX = pixelsXsMin >> levelIdx; texelX <= pixelsXsMax >> levelIdx; texelX++)
+				farthestDepth = std::max(farthestDepth, level[texelY * levelWidth + texelX]);
+		}
+
+		return nearestDepth > farthestDepth;
+	}
+
+	// a triangle's facing is its clip space vertices' (x, y, w) determinant's sign - its screen winding where it is in sight
+	void OcclusionCuller::setupOccluderTriangles(unsigned int occluderIdx) {
+		Occluder const& occluder = occluders[occluderIdx];
+		std::vector<glm::vec4>& clipVertices = occludersClipVertices[occluderIdx];
+		std::vector<bool>& trianglesFacings = occludersTrianglesFacings[occluderIdx];
+		std::vector<ScreenTriangle>& triangles = occludersTriangles[occluderIdx];
+		glm::mat4 mvpMat = vpMat * occluder.transformat;
+		clipVertices.resize(occluder.verticesNr);
+		for (unsigned int vertexIdx = 0; vertexIdx < occluder.verticesNr; vertexIdx++)
+			clipVertices[vertexIdx] = mvpMat * glm::vec4(occluder.vertices[vertexIdx], 1.0f);
+
+		unsigned int trianglesNr = occluder.idxsNr / 3;
+		if (occluder.adjacencies) {
+			trianglesFacings.resize(trianglesNr);
+			for (unsigned int triangleIdx = 0; triangleIdx < trianglesNr; triangleIdx++) {
+				unsigned int const* triangleIdxs = occluder.idxs + 3 * triangleIdx;
+				glm::vec4 const& v0 = clipVertices[triangleIdxs[0]];
+				glm::vec4 const& v1 = clipVertices[triangleIdxs[1]];
+				glm::vec4 const& v2 = clipVertices[triangleIdxs[2]];
+				trianglesFacings[triangleIdx] = glm::determinant(glm::mat3(v0.x, v0.y, v0.w, v1.x, v1.y, v1.w, v2.x, v2.y, v2.w)) > 0.0f;
+			}
+		}
+
+		triangles.clear();
+		for (unsigned int triangleIdx = 0; triangleIdx < trianglesNr; triangleIdx++) {
+			unsigned int const* triangleIdxs = occluder.idxs + 3 * triangleIdx;
+			glm::vec4 triangleClipVertices[3] = { clipVertices[triangleIdxs[0]], clipVertices[triangleIdxs[1]], clipVertices[triangleIdxs[2]] };
+			unsigned int innerEdgesMask = 0;
+			if (occluder.adjacencies) {
+				for (unsigned int edgeIdx = 0; edgeIdx < 3; edgeIdx++) {
+					unsigned int adjacentTriangleIdx = occluder.adjacencies[3 * triangleIdx + edgeIdx];
+					if (adjacentTriangleIdx != NO_ADJACENT_TRIANGLE && trianglesFacings[adjacentTriangleIdx] == trianglesFacings[triangleIdx])
+						innerEdgesMask |= 1 << edgeIdx;
+				}
+			}
+			addScreenTriangle(triangleClipVertices, innerEdgesMask, triangles);
+		}
+	}
+
+	// triangles with all of their vertices outside of the same side plane are dropped. the rest are clipped against the
+	// near plane only (z >= -w) - into up to 2 triangles. the clipping's edges are silhouettes, the split's diagonal is not
+	void OcclusionCuller::addScreenTriangle(glm::vec4 const* clipVertices, unsigned int innerEdgesMask, std::vector<ScreenTriangle>& triangles) const {
+		unsigned int outsideMasks[3];
+		for (unsigned int vertexIdx = 0; vertexIdx < 3; vertexIdx++) {
+			glm::vec4 const& v = clipVertices[vertexIdx];
+			outsideMasks[vertexIdx] = (v.x > v.w) | (v.x < -v.w) << 1 | (v.y > v.w) << 2 | (v.y < -v.w) << 3;
+		}
+		if (outsideMasks[0] & outsideMasks[1] & outsideMasks[2])
+			return;
+
+		// polygonInnerEdgesMask's bit i - the polygon's edge out of vertex i
+		glm::vec4 polygon[4];
+		unsigned int polygonVerticesNr = 0;
+		unsigned int polygonInnerEdgesMask = 0;
+		for (unsigned int vertexIdx = 0; vertexIdx < 3; vertexIdx++) {
+			glm::vec4 const& v = clipVertices[vertexIdx];
+			glm::vec4 const& nextV = clipVertices[(vertexIdx + 1) % 3];
+			unsigned int innerEdgeBit = (innerEdgesMask >> vertexIdx) & 1;
+			float dist = v.z + v.w;
+			float nextDist = nextV.z + nextV.w;
+			if (dist >= 0.0f) {
+				polygonInnerEdgesMask |= innerEdgeBit << polygonVerticesNr;
+				polygon[polygonVerticesNr++] = v;
+			}
+			if ((dist >= 0.0f) != (nextDist >= 0.0f)) {
+				// the edge leaving the near plane's intersection runs along it if the triangle's edge goes behind it
+				if (nextDist >= 0.0f)
+					polygonInnerEdgesMask |= innerEdgeBit << polygonVerticesNr;
+				polygon[polygonVerticesNr++] = v + (nextV - v) * (dist / (dist - nextDist));
+			}
+		}
+		if (polygonVerticesNr < 3)
+			return;
+
+		glm::vec3 screenVertices[4];
+		for (unsigned int vertexIdx = 0; vertexIdx < polygonVerticesNr; vertexIdx++) {
+			glm::vec4 const& v = polygon[vertexIdx];
+			if (v.w < CLIP_W_MIN)
+				return;
+
+			float invW = 1.0f / v.w;
+			screenVertices[vertexIdx] = glm::vec3((0.5f * v.x * invW + 0.5f) * DEPTH_BUFFER_WIDTH, (0.5f * v.y * invW + 0.5f) * DEPTH_BUFFER_HEIGHT, 0.5f * v.z * invW + 0.5f);
+		}
+		if (polygonVerticesNr == 3)
+			triangles.push_back({ { screenVertices[0], screenVertices[1], screenVertices[2] }, polygonInnerEdgesMask });
+		else {
+			triangles.push_back({ { screenVertices[0], screenVertices[1], screenVertices[2] }, (polygonInnerEdgesMask & 0x3) | 0x4 });
+			triangles.push_back({ { screenVertices[0], screenVertices[2], screenVertices[3] }, 0x1 | (polygonInnerEdgesMask >> 1 & 0x6) });
+		}
+	}
+
+	void OcclusionCuller::rasterizeBand(unsigned int bandIdx) {
+		unsigned int bandRowsStartIdx = bandIdx * BAND_HEIGHT;
+		unsigned int bandRowsEndIdx = bandRowsStartIdx + BAND_HEIGHT;
+		std::fill(depthPyramid.begin() + bandRowsStartIdx * DEPTH_BUFFER_WIDTH, depthPyramid.begin() + bandRowsEndIdx * DEPTH_BUFFER_WIDTH, 1.0f);
+		for (unsigned int occluderIdx = 0; occluderIdx < occludersNr; occluderIdx++) {
+			for (ScreenTriangle const& triangle : occludersTriangles[occluderIdx])
+				rasterizeTriangle(triangle, bandRowsStartIdx, bandRowsEndIdx);
+		}
+
+		for (unsigned int levelIdx = 1; levelIdx < BAND_LEVELS_NR; levelIdx++)
+			buildLevelRows(levelIdx, bandRowsStartIdx >> levelIdx, bandRowsEndIdx >> levelIdx);
+	}
+
+	// a pixel is covered whole if its center is inside of every silhouette edge by at least the edge function's extent over
+	// half a pixel (and of the inner ones at all). it is written the triangle's depth at its center pushed back by the
+	// depth's extent over half a pixel
+	void OcclusionCuller::rasterizeTriangle(ScreenTriangle const& triangle, unsigned int bandRowsStartIdx, unsigned int bandRowsEndIdx) {
+		glm::vec3 v0 = triangle.vertices[0];
+		glm::vec3 v1 = triangle.vertices[1];
+		glm::vec3 v2 = triangle.vertices[2];
+		unsigned int innerEdgesMask = triangle.innerEdgesMask;
+		float minY = std::max(floorf(std::min(std::min(v0.y, v1.y), v2.y)), (float)bandRowsStartIdx);
+		float maxY = std::min(floorf(std::max(std::max(v0.y, v1.y), v2.y)), bandRowsEndIdx - 1.0f);
+		float minX = std::max(floorf(std::min(std::min(v0.x, v1.x), v2.x)), 0.0f);
+		float maxX = std::min(floorf(std::max(std::max(v0.x, v1.x), v2.x)), DEPTH_BUFFER_WIDTH - 1.0f);
+		if (minY > maxY || minX > maxX)
+			return;
+
+		float doubleArea = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+		if (fabsf(doubleArea) < TRIANGLE_DOUBLE_AREA_MIN)
+			return;
+		// counter clockwise - occluders are rasterized two sided
+		if (doubleArea < 0.0f) {
+			std::swap(v1, v2);
+			doubleArea = -doubleArea;
+			// the edges are v0v2, v2v1 and v1v0 now
+			innerEdgesMask = (innerEdgesMask & 0x2) | (innerEdgesMask >> 2 & 0x1) | (innerEdgesMask << 2 & 0x4);
+		}
+
+		// edge functions: edgesAs[i] * x + edgesBs[i] * y + edgesCs[i] >= 0 - the pixel at (x, y) is inside of edge i whole
+		glm::vec3 const* edgesVertices[4] = { &v0, &v1, &v2, &v0 };
+		float edgesAs[3], edgesBs[3], edgesCs[3];
+		for (unsigned int edgeIdx = 0; edgeIdx < 3; edgeIdx++) {
+			glm::vec3 const& a = *edgesVertices[edgeIdx];
+			glm::vec3 const& b = *edgesVertices[edgeIdx + 1];
+			edgesAs[edgeIdx] = a.y - b.y;
+			edgesBs[edgeIdx] = b.x - a.x;
+			edgesCs[edgeIdx] = -(edgesAs[edgeIdx] * a.x + edgesBs[edgeIdx] * a.y);
+			if (!(innerEdgesMask & (1 << edgeIdx)))
+				edgesCs[edgeIdx] -= 0.5f * (fabsf(edgesAs[edgeIdx]) + fabsf(edgesBs[edgeIdx]));
+		}
+		float depthDx = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / doubleArea;
+		float depthDy = ((v2.z - v0.z) * (v1.x - v0.x) - (v1.z - v0.z) * (v2.x - v0.x)) / doubleArea;
+		float depthC = v0.z - depthDx * v0.x - depthDy * v0.y + 0.5f * (fabsf(depthDx) + fabsf(depthDy));
+
+		// whole groups of 4 - the buffer's width is a multiple of 4
+		unsigned int groupsXsMin = (unsigned int)minX & ~3u;
+		unsigned int groupsXsMax = (unsigned int)maxX;
+	#ifdef CORIUM3D_OCCLUSION_CULLER_SSE
+		__m128 pixelsCentersOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		__m128 zero = _mm_setzero_ps();
+		__m128 edgesAsVecs[3], edgesBsVecs[3], edgesCsVecs[3];
+		for (unsigned int edgeIdx = 0; edgeIdx < 3; edgeIdx++) {
+			edgesAsVecs[edgeIdx] = _mm_set1_ps(edgesAs[edgeIdx]);
+			edgesBsVecs[edgeIdx] = _mm_set1_ps(edgesBs[edgeIdx]);
+			edgesCsVecs[edgeIdx] = _mm_set1_ps(edgesCs[edgeIdx]);
+		}
+		__m128 depthDxs = _mm_set1_ps(depthDx);
+		for (unsigned int y = (unsigned int)minY; y <= (unsigned int)maxY; y++) {
+			float* row = &depthPyramid[y * DEPTH_BUFFER_WIDTH];
+			__m128 centersYs = _mm_set1_ps(y + 0.5f);
+			__m128 edgesRowsCs[3];
+			for (unsigned int edgeIdx = 0; edgeIdx < 3; edgeIdx++)
+				edgesRowsCs[edgeIdx] = _mm_add_ps(_mm_mul_ps(edgesBsVecs[edgeIdx], centersYs), edgesCsVecs[edgeIdx]);
+			__m128 depthsRowC = _mm_set1_ps(depthDy * (y + 0.5f) + depthC);
+			for (unsigned int x = groupsXsMin; x <= groupsXsMax; x += 4) {
+				__m128 centersXs = _mm_add_ps(_mm_set1_ps((float)x), pixelsCentersOffsets);
+				__m128 coveredMask = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgesAsVecs[0], centersXs), edgesRowsCs[0]), zero);
+				coveredMask = _mm_and_ps(coveredMask, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgesAsVecs[1], centersXs), edgesRowsCs[1]), zero));
+				coveredMask = _mm_and_ps(coveredMask, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgesAsVecs[2], centersXs), edgesRowsCs[2]), zero));
+				if (!_mm_movemask_ps(coveredMask))
+					continue;
+
+				__m128 depths = _mm_add_ps(_mm_mul_ps(depthDxs, centersXs), depthsRowC);
+				__m128 oldDepths = _mm_loadu_ps(row + x);
+				__m128 newDepths = _mm_min_ps(oldDepths, depths);
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(coveredMask, newDepths), _mm_andnot_ps(coveredMask, oldDepths)));
+			}
+		}
+	#else
+		for (unsigned int y = (unsigned int)minY; y <= (unsigned int)maxY; y++) {
+			float* row = &depthPyramid[y * DEPTH_BUFFER_WIDTH];
+			float centerY = y + 0.5f;
+			for (unsigned int x = groupsXsMin; x < groupsXsMax + 4 && x < DEPTH_BUFFER_WIDTH; x++) {
+				float centerX = x + 0.5f;
+				if (edgesAs[0] * centerX + edgesBs[0] * centerY + edgesCs[0] < 0.0f ||
+					edgesAs[1] * centerX + edgesBs[1] * centerY + edgesCs[1] < 0.0f ||
+					edgesAs[2] * centerX + edgesBs[2] * centerY + edgesCs[2] < 0.0f)
+					continue;
+
+				row[x] = std::min(row[x], depthDx * centerX + depthDy * centerY + depthC);
+			}
+		}
+	#endif
+	}
+
+	// each texel is the farthest of the ones under it. a level of a single row takes the farthest of the 2 under it
+	void OcclusionCuller::buildLevelRows(unsigned int levelIdx, unsigned int rowsStartIdx, unsigned int rowsEndIdx) {
+		float const* srcLevel = &depthPyramid[levelsBaseIdxs[levelIdx - 1]];
+		float* level = &depthPyramid[levelsBaseIdxs[levelIdx]];
+		unsigned int srcLevelWidth = DEPTH_BUFFER_WIDTH >> (levelIdx - 1);
+		unsigned int srcLevelHeight = std::max(DEPTH_BUFFER_HEIGHT >> (levelIdx - 1), 1u);
+		unsigned int levelWidth = DEPTH_BUFFER_WIDTH >> levelIdx;
+		for (unsigned int y = rowsStartIdx; y < rowsEndIdx; y++) {
+			float const* srcRow0 = srcLevel + 2 * y * srcLevelWidth;
+			float const* srcRow1 = srcLevel + std::min(2 * y + 1, srcLevelHeight - 1) * srcLevelWidth;
+			float* row = level + y * levelWidth;
+			for (unsigned int x = 0; x < levelWidth; x++)
+				row[x] = std::max(std::max(srcRow0[2 * x], srcRow0[2 * x + 1]), std::max(srcRow1[2 * x], srcRow1[2 * x + 1]));
+		}
+	}
+
+} // namespace Corium3D
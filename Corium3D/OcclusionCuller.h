@@ -0,0 +1,93 @@
+#pragma once
+
+#include "AABB.h"
+#include "ThreadPool.h"
+
+#include <glm/glm.hpp>
+#include <climits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86_FP) && _M_IX86_FP >= 2
+	#define CORIUM3D_OCCLUSION_CULLER_SSE
+#endif
+
+namespace Corium3D {
+
+	// Software occlusion culling: occluders' triangles are rasterized on the CPU into a low resolution depth buffer - in
+	// horizontal bands, a job per band, 4 pixels at a time (SSE, where available) - and a depth pyramid is built over it,
+	// each texel the farthest of the 2x2 texels under it. An AABB is hidden if its nearest depth is behind the farthest
+	// depth under its projected rect, read at the pyramid's level where the rect spans at most 2x2 texels.
+	// The rasterization is conservative along the occluders' silhouettes - a pixel on a triangle's silhouette edge is written
+	// only if the triangle covers all of it - so that an AABB is not reported hidden while a part of it is in sight around
+	// them. Across an edge the triangle shares with a neighbour facing the same way (a crease, or a quad's diagonal) the
+	// pixel goes to the triangle covering its center, or the edge would crack. A pixel is written its triangle's farthest
+	// depth over it.
+	// Depths are the normalized device coordinates' z mapped to [0, 1] (1 - the far plane). Rows go bottom up.
+	class OcclusionCuller {
+	public:
+		struct Occluder {
+			glm::vec3 const* vertices;
+			unsigned int verticesNr;
+			// triangles
+			unsigned int const* idxs;
+			unsigned int idxsNr;
+			// per triangle edge - the neighbour triangle across it (genTrianglesAdjacencies). NULL - every edge is a silhouette
+			unsigned int const* adjacencies;
+			glm::mat4 transformat;
+		};
+
+		static const unsigned int NO_ADJACENT_TRIANGLE = UINT_MAX;
+
+		static const unsigned int DEPTH_BUFFER_WIDTH = 256;
+		static const unsigned int DEPTH_BUFFER_HEIGHT = 128;
+		// a band's levels of the pyramid are built by its job, the ones above them once all of the bands are done
+		static const unsigned int BAND_HEIGHT = 8;
+		static const unsigned int BANDS_NR = DEPTH_BUFFER_HEIGHT / BAND_HEIGHT;
+		static const unsigned int BAND_LEVELS_NR = 4;
+		// down to 2x1
+		static const unsigned int LEVELS_NR = 8;
+
+		// threadPool - the occluders' transformations and the bands are run on it (NULL - on the calling thread)
+		OcclusionCuller(Corium3DUtils::ThreadPool* threadPool = NULL);
+		OcclusionCuller(OcclusionCuller const&) = delete;
+		// triangles' edges (v0v1, v1v2, v2v0) are matched by their vertices' positions. an edge of more than 2 triangles
+		// is left as a silhouette
+		static void genTrianglesAdjacencies(glm::vec3 const* vertices, unsigned int const* idxs, unsigned int idxsNr, std::vector<unsigned int>& outAdjacencies);
+		// clears the depth buffer, rasterizes the occluders into it and builds the pyramid over it
+		void rasterizeOccluders(glm::mat4 const& vpMat, Occluder const* occluders, unsigned int occludersNr);
+		// an AABB crossing the near plane is never hidden
+		bool isAABBHidden(AABB3D const& aabb) const;
+		// of the last rasterizeOccluders - clipped triangles included, the ones out of sight or edge on not
+		unsigned int getRasterizedTrianglesNr() const { return rasterizedTrianglesNr; }
+		// (DEPTH_BUFFER_WIDTH >> levelIdx) x max(DEPTH_BUFFER_HEIGHT >> levelIdx, 1) depths. level 0 is the depth buffer
+		float const* getDepthPyramidLevel(unsigned int levelIdx) const { return &depthPyramid[levelsBaseIdxs[levelIdx]]; }
+
+	private:
+		// x and y in pixels, z the depth
+		struct ScreenTriangle {
+			glm::vec3 vertices[3];
+			// bit per edge (v0v1, v1v2, v2v0) - the ones rasterized by their pixels' centers
+			unsigned int innerEdgesMask;
+		};
+
+		Corium3DUtils::ThreadPool* threadPool;
+		glm::mat4 vpMat;
+		Occluder const* occluders = NULL;
+		// per occluder - written by its own job
+		std::vector<std::vector<glm::vec4>> occludersClipVertices;
+		std::vector<std::vector<bool>> occludersTrianglesFacings;
+		std::vector<std::vector<ScreenTriangle>> occludersTriangles;
+		unsigned int occludersNr = 0;
+		unsigned int rasterizedTrianglesNr = 0;
+		// the levels one after the other
+		std::vector<float> depthPyramid;
+		unsigned int levelsBaseIdxs[LEVELS_NR];
+
+		void setupOccluderTriangles(unsigned int occluderIdx);
+		void addScreenTriangle(glm::vec4 const* clipVertices, unsigned int innerEdgesMask, std::vector<ScreenTriangle>& triangles) const;
+		void rasterizeBand(unsigned int bandIdx);
+		void rasterizeTriangle(ScreenTriangle const& triangle, unsigned int bandRowsStartIdx, unsigned int bandRowsEndIdx);
+		void buildLevelRows(unsigned int levelIdx, unsigned int rowsStartIdx, unsigned int rowsEndIdx);
+	};
+
+} // namespace Corium3D
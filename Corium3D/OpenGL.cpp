@@ -40,7 +40,7 @@ namespace Corium3D {
             if (infoLogLen > 0) {
                 GLchar* infoLog = new GLchar[infoLogLen];
                 glGetShaderInfoLog(shaderObj, infoLogLen, NULL, infoLog);
-                ServiceLocator::getLogger().loge("createGlProg", "Could not compile shader. compiler says:\n%s\n", infoLog);
+                LOGE("createGlProg", "Could not compile shader. compiler says:\n%s\n", infoLog);
                 delete infoLog;
             }
             glDeleteShader(shaderObj);
@@ -64,7 +64,7 @@ namespace Corium3D {
             if (infoLogLen) {
                 GLchar* infoLog = new GLchar[infoLogLen];
                 glGetProgramInfoLog(prog, infoLogLen, NULL, infoLog);
-                ServiceLocator::getLogger().loge("Could not link program:\n%s\n", infoLog);
+                LOGE("createGlProg", "Could not link program:\n%s\n", infoLog);
                 delete infoLog;
             }
 
@@ -42,15 +42,15 @@ namespace Corium3D {
 
 	inline void glErrorCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam) {
 		if (type == GL_DEBUG_TYPE_ERROR)
-			ServiceLocator::getLogger().loge("GL", "type: 0x%x | severity: 0x%x | message: %s", type, severity, message);
+			LOGE("GL", "type: 0x%x | severity: 0x%x | message: %s", type, severity, message);
 		else
-			ServiceLocator::getLogger().logi("GL", "type: 0x%x | severity: 0x%x | message: %s", type, severity, message);
+			LOGI("GL", "type: 0x%x | severity: 0x%x | message: %s", type, severity, message);
 	}
 
 	inline bool checkGlError(const char* funcName) {
 		GLint err = glGetError();
 		if (err != GL_NO_ERROR) {
-			ServiceLocator::getLogger().loge("Corium3DOpenGL", "GL error after %s(): 0x%08x\n", funcName, err);
+			LOGE("Corium3DOpenGL", "GL error after %s(): 0x%08x\n", funcName, err);
 			return true;
 		}
 		return false;
@@ -61,19 +61,19 @@ namespace Corium3D {
 		if (framebufferStatus != GL_FRAMEBUFFER_COMPLETE) {
 			switch (framebufferStatus) {
 			case GL_FRAMEBUFFER_UNDEFINED:
-				ServiceLocator::getLogger().loge("Corium3DOpenGL", "Default framebuffer is bound, but is undefined.");
+				LOGE("Corium3DOpenGL", "Default framebuffer is bound, but is undefined.");
 			case GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT:
-				ServiceLocator::getLogger().loge("Corium3DOpenGL", "Necessary attachment is uninitialized.");
+				LOGE("Corium3DOpenGL", "Necessary attachment is uninitialized.");
 			case GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT:
-				ServiceLocator::getLogger().loge("Corium3DOpenGL", "No image is attached to the framebuffer.");
+				LOGE("Corium3DOpenGL", "No image is attached to the framebuffer.");
 			case GL_FRAMEBUFFER_INCOMPLETE_DRAW_BUFFER:
-				ServiceLocator::getLogger().loge("Corium3DOpenGL", "Every drawing buffer has an attachment.");
+				LOGE("Corium3DOpenGL", "Every drawing buffer has an attachment.");
 			case GL_FRAMEBUFFER_INCOMPLETE_READ_BUFFER:
-				ServiceLocator::getLogger().loge("Corium3DOpenGL", "An attachment exists for reading.");
+				LOGE("Corium3DOpenGL", "An attachment exists for reading.");
 			case GL_FRAMEBUFFER_UNSUPPORTED:
-				ServiceLocator::getLogger().loge("Corium3DOpenGL", "Combination of images are incompatible by implementation requierments.");
+				LOGE("Corium3DOpenGL", "Combination of images are incompatible by implementation requierments.");
 			case GL_FRAMEBUFFER_INCOMPLETE_MULTISAMPLE:
-				ServiceLocator::getLogger().loge("Corium3DOpenGL", "Number of samples for all images do not match.");
+				LOGE("Corium3DOpenGL", "Number of samples for all images do not match.");
 			}
 
 			return false;
@@ -61,7 +61,7 @@ bool OpenGlTxtGen::initOpenGlLmnts() {
     unsigned int texWidth, texHeight;
     unsigned res = lodepng_decode_file(&txtAtlasData, &texWidth, &texHeight, txtAtlasPath.c_str(), LCT_RGBA, 8);
     if (res) {
-        ServiceLocator::getLogger().loge("OpenGlTxtGen", lodepng_error_text(res));
+        LOGE("OpenGlTxtGen", "%s", lodepng_error_text(res));
         return false;
     }
     atlasCellWidth = (float)texWidth/atlasHorizonCellsNr;
@@ -245,7 +245,7 @@ inline bool OpenGlTxtGen::TxtGraphicsComponent::setupOpenGlLmnts(float* vertices
 bool OpenGlTxtGen::TxtGraphicsComponent::initOpenGlLmnts() {
 #if DEBUG
     if (!txtGen->isInited) {
-        ServiceLocator::getLogger().loge("TxtGraphicsComponentImpl", "Tried to initOpenGlLmnts while TxtGen was not inited.");
+        LOGE("TxtGraphicsComponentImpl", "Tried to initOpenGlLmnts while TxtGen was not inited.");
         return false;
     }
 #endif
@@ -313,7 +313,7 @@ OpenGlTxtGen::NumericalTxtGraphicsComponent::NumericalTxtGraphicsComponent(OpenG
 bool OpenGlTxtGen::NumericalTxtGraphicsComponent::initOpenGlLmnts() {
 #if DEBUG
     if (!txtGen->isInited) {
-        ServiceLocator::getLogger().loge("NumericalTxtGraphicsComponentImpl", "Tried to initOpenGlLmnts while TxtGen was not initiated.");
+        LOGE("NumericalTxtGraphicsComponentImpl", "Tried to initOpenGlLmnts while TxtGen was not initiated.");
         return false;
     }
 #endif
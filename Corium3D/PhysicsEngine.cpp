@@ -1,5 +1,7 @@
 #include "PhysicsEngine.h"
 
+#include "Profiler.h"
+
 using namespace Corium3DUtils;
 
 namespace Corium3D {
@@ -28,14 +30,26 @@ namespace Corium3D {
 	}
 
 	void PhysicsEngine::update(float time) {
+		PROFILE_ZONE("PhysicsEngine::update");
 		for (mobilityInterfacesIt.reset(); mobilityInterfacesIt.hasNext(); mobilityInterfacesIt.next().update(time));
 	}
 
 	void PhysicsEngine::update() {
+		PROFILE_ZONE("PhysicsEngine::update");
 		for (mobilityInterfacesIt.reset(); mobilityInterfacesIt.hasNext(); mobilityInterfacesIt.next().update());
 	}
 
-	//REMINDER: depending on having at least one listener
+	void PhysicsEngine::update(MobilityInterface* const* mobilityInterfaces, Transform3D* transforms, Transform3DUS* transformDeltas, std::complex<float>* transform2DRotDeltas, unsigned int lmntsNr) {
+		PROFILE_ZONE("PhysicsEngine::update");
+		for (unsigned int lmntIdx = 0; lmntIdx < lmntsNr; lmntIdx++) {
+			MobilityInterface& mobilityInterface = *mobilityInterfaces[lmntIdx];
+			mobilityInterface.update();
+			transforms[lmntIdx] = mobilityInterface.transform;
+			transformDeltas[lmntIdx] = mobilityInterface.transformDeltaPerUpdate;
+			transform2DRotDeltas[lmntIdx] = mobilityInterface.transform2DRotDeltaPerUpdate;
+		}
+	}
+
 	PhysicsEngine::MobilityInterface::MobilityInterface(Transform3D const& initTransform,
 		OnMovementMadeCallback3D* _listeners3D, unsigned int _listeners3DNr,
 		std::complex<float> initTransform2DRot,
@@ -71,7 +85,6 @@ namespace Corium3D {
 			listeners2D = NULL;
 	}
 
-	//REMINDER: depending on having at least one listener
 	PhysicsEngine::MobilityInterface::~MobilityInterface() {
 		delete[] listeners3D;
 		if (listeners2DNr > 0)
@@ -1,7 +1,8 @@
 #pragma once
 
-#include "ObjPool.h"
+#include "ChunkedObjPool.h"
 #include "TransformsStructs.h"
+#include "MemoryReport.h"
 #include <glm/glm.hpp>
 #include <glm/gtx/transform.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -31,17 +32,20 @@ namespace Corium3D {
 		void removeMobileGameLmnt(MobilityInterface* removedMobilityInterface);
 		void update(float time);
 		void update();
+		// updates the given elements and writes their transforms and the deltas applied out by value, into the caller's packed arrays
+		void update(MobilityInterface* const* mobilityInterfaces, Transform3D* transforms, Transform3DUS* transformDeltas, std::complex<float>* transform2DRotDeltas, unsigned int lmntsNr);
+		void reportMemory(Corium3DUtils::MemoryReport& memoryReport) const { memoryReport.addPool("PhysicsEngine", "mobilityInterfaces", mobilityInterfacesPool); }
 
 	private:
-		Corium3DUtils::ObjPoolIteratable<MobilityInterface> mobilityInterfacesPool;
-		Corium3DUtils::ObjPoolIteratable<MobilityInterface>::ObjPoolIt mobilityInterfacesIt;
+		Corium3DUtils::ChunkedObjPoolIteratable<MobilityInterface> mobilityInterfacesPool;
+		Corium3DUtils::ChunkedObjPoolIteratable<MobilityInterface>::ObjPoolIt mobilityInterfacesIt;
 		float secsPerUpdate;
 	};
 
 	class PhysicsEngine::MobilityInterface {
 	public:
 		friend class PhysicsEngine;
-		friend class Corium3DUtils::ObjPoolIteratable<MobilityInterface>;
+		friend class Corium3DUtils::ChunkedObjPoolIteratable<MobilityInterface>;
 
 		void translate(glm::vec3 const& translate) { transform.translate += translate; }
 		void scale(float scaleFactor) { transform.scale *= scaleFactor; }
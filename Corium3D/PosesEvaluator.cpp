@@ -0,0 +1,289 @@
+#include "PosesEvaluator.h"
+
+#include "Profiler.h"
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtx/transform.hpp>
+#include <algorithm>
+#include <cfloat>
+
+#ifdef CORIUM3D_POSES_EVALUATOR_SSE
+	#include <emmintrin.h>
+#endif
+
+namespace Corium3D {
+
+#ifdef CORIUM3D_POSES_EVALUATOR_SSE
+	// a selects where mask is set, b elsewhere
+	inline __m128 select(__m128 mask, __m128 a, __m128 b) {
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+
+	// x in [0, 1]. Abramowitz & Stegun 4.4.46 - the error is below 2e-8
+	inline __m128 acos01(__m128 x) {
+		__m128 poly = _mm_set1_ps(-0.0012624911f);
+		poly = _mm_add_ps(_mm_mul_ps(poly, x), _mm_set1_ps(0.0066700901f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, x), _mm_set1_ps(-0.0170881256f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, x), _mm_set1_ps(0.0308918810f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, x), _mm_set1_ps(-0.0501743046f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, x), _mm_set1_ps(0.0889789874f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, x), _mm_set1_ps(-0.2145988016f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, x), _mm_set1_ps(1.5707963050f));
+		return _mm_mul_ps(_mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(1.0f), x), _mm_setzero_ps())), poly);
+	}
+
+	// x in [0, pi/2] - the slerp's angles never leave it. Taylor series up to x^11 - the error is below 6e-8
+	inline __m128 sinQuarterTurn(__m128 x) {
+		__m128 xSq = _mm_mul_ps(x, x);
+		__m128 poly = _mm_set1_ps(-1.0f / 39916800.0f);
+		poly = _mm_add_ps(_mm_mul_ps(poly, xSq), _mm_set1_ps(1.0f / 362880.0f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, xSq), _mm_set1_ps(-1.0f / 5040.0f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, xSq), _mm_set1_ps(1.0f / 120.0f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, xSq), _mm_set1_ps(-1.0f / 6.0f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, xSq), _mm_set1_ps(1.0f));
+		return _mm_mul_ps(poly, x);
+	}
+
+	inline void storeColumns(__m128 xs, __m128 ys, __m128 zs, __m128 ws, glm::mat4* mats, unsigned int colIdx) {
+		_MM_TRANSPOSE4_PS(xs, ys, zs, ws);
+		_mm_storeu_ps(&mats[0][colIdx][0], xs);
+		_mm_storeu_ps(&mats[1][colIdx][0], ys);
+		_mm_storeu_ps(&mats[2][colIdx][0], zs);
+		_mm_storeu_ps(&mats[3][colIdx][0], ws);
+	}
+#endif
+
+	// out = a * b. out is not to alias a
+	inline void mulMats(glm::mat4 const& a, glm::mat4 const& b, glm::mat4& out) {
+	#ifdef CORIUM3D_POSES_EVALUATOR_SSE
+		__m128 aCols[4] = { _mm_loadu_ps(&a[0][0]), _mm_loadu_ps(&a[1][0]), _mm_loadu_ps(&a[2][0]), _mm_loadu_ps(&a[3][0]) };
+		for (unsigned int colIdx = 0; colIdx < 4; colIdx++) {
+			glm::vec4 bCol = b[colIdx];
+			__m128 col = _mm_add_ps(_mm_add_ps(_mm_mul_ps(aCols[0], _mm_set1_ps(bCol[0])), _mm_mul_ps(aCols[1], _mm_set1_ps(bCol[1]))),
+									_mm_add_ps(_mm_mul_ps(aCols[2], _mm_set1_ps(bCol[2])), _mm_mul_ps(aCols[3], _mm_set1_ps(bCol[3]))));
+			_mm_storeu_ps(&out[colIdx][0], col);
+		}
+	#else
+		out = a * b;
+	#endif
+	}
+
+	ModelAnimations::ModelAnimations(ModelDescView const& modelDesc) :
+			bonesOffsets(modelDesc.bonesOffsets.begin(), modelDesc.bonesOffsets.end()) {
+		// a node's parent is the nearest node before it with children left to place
+		unsigned int nodesNr = modelDesc.transformatsHierarchy.size();
+		nodesParentsIdxs.resize(nodesNr);
+		nodesTransformats.resize(nodesNr);
+		nodesBonesIdxs.resize(nodesNr);
+		std::vector<unsigned int> parentsStack;
+		std::vector<unsigned int> childrenLeftNrsStack;
+		for (unsigned int nodeIdx = 0; nodeIdx < nodesNr; nodeIdx++) {
+			ModelDesc::TransformatsHierarchyNodeDesc const& nodeDesc = modelDesc.transformatsHierarchy[nodeIdx];
+			if (nodeIdx > 0) {
+				while (childrenLeftNrsStack.back() == 0) {
+					parentsStack.pop_back();
+					childrenLeftNrsStack.pop_back();
+				}
+				nodesParentsIdxs[nodeIdx] = parentsStack.back();
+				childrenLeftNrsStack.back()--;
+			}
+			else
+				nodesParentsIdxs[nodeIdx] = NO_PARENT;
+			parentsStack.push_back(nodeIdx);
+			childrenLeftNrsStack.push_back(nodeDesc.childrenNr);
+
+			nodesTransformats[nodeIdx] = nodeDesc.transformat;
+			nodesBonesIdxs[nodeIdx] = nodeDesc.boneIdx;
+		}
+
+		animations.resize(modelDesc.animationsDescs.size());
+		for (unsigned int animationIdx = 0; animationIdx < animations.size(); animationIdx++) {
+			ModelDesc::AnimationDesc const& animationDesc = modelDesc.animationsDescs[animationIdx];
+			ModelDescView::AnimationKeysView animationKeys = modelDesc.animationsKeys[animationIdx];
+			Animation& animation = animations[animationIdx];
+			animation.dur = animationDesc.dur;
+			animation.ticksPerSecond = animationDesc.ticksPerSecond;
+			animation.nodesNr = std::min(animationDesc.transformatsHierarchyNodesNr, nodesNr);
+			animation.channelsNr = animationDesc.channelsNr;
+			animation.channelsNrPadded = (animation.channelsNr + 3) & ~3u;
+			animation.keyFramesNr = animationDesc.keyFramesNr;
+			animation.keyFramesTimes.assign(animationKeys.keyFramesTimes.begin(), animationKeys.keyFramesTimes.begin() + animation.keyFramesNr);
+
+			// the channels are sorted by their nodes' indices
+			animation.nodesChannelsIdxs.resize(animation.nodesNr);
+			unsigned int channelIdx = 0;
+			for (unsigned int nodeIdx = 0; nodeIdx < animation.nodesNr; nodeIdx++) {
+				if (channelIdx < animation.channelsNr && animationKeys.channelsNodesIdxs[channelIdx] == nodeIdx)
+					animation.nodesChannelsIdxs[nodeIdx] = channelIdx++;
+				else
+					animation.nodesChannelsIdxs[nodeIdx] = NO_CHANNEL;
+			}
+
+			unsigned int keyFramesNr = animation.keyFramesNr;
+			unsigned int channelsNrPadded = animation.channelsNrPadded;
+			animation.keys.resize(keyFramesNr * KEY_COMPONENTS_NR * channelsNrPadded);
+			for (unsigned int keyFrameIdx = 0; keyFrameIdx < keyFramesNr; keyFrameIdx++) {
+				float* keyFrameKeys = &animation.keys[keyFrameIdx * KEY_COMPONENTS_NR * channelsNrPadded];
+				for (unsigned int channelIdx = 0; channelIdx < channelsNrPadded; channelIdx++) {
+					glm::vec3 scale(1.0f);
+					glm::quat rot(1.0f, 0.0f, 0.0f, 0.0f);
+					glm::vec3 translation(0.0f);
+					if (channelIdx < animation.channelsNr) {
+						scale = animationKeys.scales[channelIdx * keyFramesNr + keyFrameIdx];
+						rot = animationKeys.rots[channelIdx * keyFramesNr + keyFrameIdx];
+						translation = animationKeys.translations[channelIdx * keyFramesNr + keyFrameIdx];
+					}
+					keyFrameKeys[SCALE_X * channelsNrPadded + channelIdx] = scale.x;
+					keyFrameKeys[SCALE_Y * channelsNrPadded + channelIdx] = scale.y;
+					keyFrameKeys[SCALE_Z * channelsNrPadded + channelIdx] = scale.z;
+					keyFrameKeys[ROT_X * channelsNrPadded + channelIdx] = rot.x;
+					keyFrameKeys[ROT_Y * channelsNrPadded + channelIdx] = rot.y;
+					keyFrameKeys[ROT_Z * channelsNrPadded + channelIdx] = rot.z;
+					keyFrameKeys[ROT_W * channelsNrPadded + channelIdx] = rot.w;
+					keyFrameKeys[TRANSLATION_X * channelsNrPadded + channelIdx] = translation.x;
+					keyFrameKeys[TRANSLATION_Y * channelsNrPadded + channelIdx] = translation.y;
+					keyFrameKeys[TRANSLATION_Z * channelsNrPadded + channelIdx] = translation.z;
+				}
+			}
+
+			poseScratchSz = std::max(poseScratchSz, channelsNrPadded + animation.nodesNr);
+		}
+	}
+
+	float ModelAnimations::locateKeyFrames(unsigned int animationIdx, double animationTime, unsigned int& inOutEndKeyFrameIdx) const {
+		Animation const& animation = animations[animationIdx];
+		double const* keyFramesTimes = animation.keyFramesTimes.data();
+		// the animation wrapped around (or was restarted) since the last search
+		if (animationTime <= keyFramesTimes[inOutEndKeyFrameIdx - 1])
+			inOutEndKeyFrameIdx = 1;
+		while (inOutEndKeyFrameIdx < animation.keyFramesNr - 1 && keyFramesTimes[inOutEndKeyFrameIdx] < animationTime)
+			inOutEndKeyFrameIdx++;
+
+		return (float)((animationTime - keyFramesTimes[inOutEndKeyFrameIdx - 1]) / (keyFramesTimes[inOutEndKeyFrameIdx] - keyFramesTimes[inOutEndKeyFrameIdx - 1]));
+	}
+
+	// scratch: the channels' local transformats, then the nodes' global ones
+	void ModelAnimations::evalPose(PoseQuery const& query, glm::mat4* scratch) const {
+		Animation const& animation = animations[query.animationIdx];
+		glm::mat4* channelsTransformats = scratch;
+		glm::mat4* nodesGlobalTransformats = scratch + animation.channelsNrPadded;
+		interpolateChannels(animation, query.endKeyFrameIdx, query.interpolationFactor, channelsTransformats);
+
+		for (unsigned int nodeIdx = 0; nodeIdx < animation.nodesNr; nodeIdx++) {
+			unsigned int channelIdx = animation.nodesChannelsIdxs[nodeIdx];
+			glm::mat4 const& localTransformat = channelIdx != NO_CHANNEL ? channelsTransformats[channelIdx] : nodesTransformats[nodeIdx];
+			unsigned int parentIdx = nodesParentsIdxs[nodeIdx];
+			if (parentIdx != NO_PARENT)
+				mulMats(nodesGlobalTransformats[parentIdx], localTransformat, nodesGlobalTransformats[nodeIdx]);
+			else
+				nodesGlobalTransformats[nodeIdx] = localTransformat;
+
+			unsigned int boneIdx = nodesBonesIdxs[nodeIdx];
+			if (boneIdx != UINT_MAX)
+				mulMats(nodesGlobalTransformats[nodeIdx], bonesOffsets[boneIdx], query.bonesTransformats[boneIdx]);
+		}
+	}
+
+	// a channel's local transformat is translate(translation) * mat4_cast(rot) * scale(scale)
+	void ModelAnimations::interpolateChannels(Animation const& animation, unsigned int endKeyFrameIdx, float interpolationFactor, glm::mat4* outChannelsTransformats) const {
+		unsigned int channelsNrPadded = animation.channelsNrPadded;
+		float const* startKeys = &animation.keys[(endKeyFrameIdx - 1) * KEY_COMPONENTS_NR * channelsNrPadded];
+		float const* endKeys = startKeys + KEY_COMPONENTS_NR * channelsNrPadded;
+	#ifdef CORIUM3D_POSES_EVALUATOR_SSE
+		__m128 endWeights = _mm_set1_ps(interpolationFactor);
+		__m128 startWeights = _mm_set1_ps(1.0f - interpolationFactor);
+		__m128 ones = _mm_set1_ps(1.0f);
+		__m128 twos = _mm_set1_ps(2.0f);
+		__m128 zeros = _mm_setzero_ps();
+		__m128 signBits = _mm_set1_ps(-0.0f);
+		for (unsigned int channelIdx = 0; channelIdx < animation.channelsNr; channelIdx += 4) {
+			__m128 startComponents[KEY_COMPONENTS_NR];
+			__m128 endComponents[KEY_COMPONENTS_NR];
+			for (unsigned int component = 0; component < KEY_COMPONENTS_NR; component++) {
+				startComponents[component] = _mm_loadu_ps(startKeys + component * channelsNrPadded + channelIdx);
+				endComponents[component] = _mm_loadu_ps(endKeys + component * channelsNrPadded + channelIdx);
+			}
+			// the rotations' lerps are replaced by their slerps below
+			__m128 lerped[KEY_COMPONENTS_NR];
+			for (unsigned int component = 0; component < KEY_COMPONENTS_NR; component++)
+				lerped[component] = _mm_add_ps(_mm_mul_ps(startComponents[component], startWeights), _mm_mul_ps(endComponents[component], endWeights));
+
+			// slerp the short way around - the end rotations are negated where they are more than a half turn away
+			__m128 cosThetas = _mm_add_ps(_mm_add_ps(_mm_mul_ps(startComponents[ROT_X], endComponents[ROT_X]), _mm_mul_ps(startComponents[ROT_Y], endComponents[ROT_Y])),
+										  _mm_add_ps(_mm_mul_ps(startComponents[ROT_Z], endComponents[ROT_Z]), _mm_mul_ps(startComponents[ROT_W], endComponents[ROT_W])));
+			__m128 negations = _mm_and_ps(_mm_cmplt_ps(cosThetas, zeros), signBits);
+			cosThetas = _mm_xor_ps(cosThetas, negations);
+			// nearly equal rotations are lerped, or sin(theta) would near 0
+			__m128 lerpMask = _mm_cmpgt_ps(cosThetas, _mm_set1_ps(1.0f - FLT_EPSILON));
+			__m128 thetas = acos01(_mm_min_ps(cosThetas, ones));
+			__m128 sinThetas = sinQuarterTurn(thetas);
+			__m128 startRotsWeights = select(lerpMask, startWeights, _mm_div_ps(sinQuarterTurn(_mm_mul_ps(startWeights, thetas)), sinThetas));
+			__m128 endRotsWeights = _mm_xor_ps(select(lerpMask, endWeights, _mm_div_ps(sinQuarterTurn(_mm_mul_ps(endWeights, thetas)), sinThetas)), negations);
+			for (unsigned int component = ROT_X; component <= ROT_W; component++)
+				lerped[component] = _mm_add_ps(_mm_mul_ps(startComponents[component], startRotsWeights), _mm_mul_ps(endComponents[component], endRotsWeights));
+
+			// glm's mat3_cast, the columns scaled
+			__m128 xs = lerped[ROT_X], ys = lerped[ROT_Y], zs = lerped[ROT_Z], ws = lerped[ROT_W];
+			__m128 xxs = _mm_mul_ps(xs, xs), yys = _mm_mul_ps(ys, ys), zzs = _mm_mul_ps(zs, zs);
+			__m128 xys = _mm_mul_ps(xs, ys), xzs = _mm_mul_ps(xs, zs), yzs = _mm_mul_ps(ys, zs);
+			__m128 wxs = _mm_mul_ps(ws, xs), wys = _mm_mul_ps(ws, ys), wzs = _mm_mul_ps(ws, zs);
+			glm::mat4* channelsTransformats = outChannelsTransformats + channelIdx;
+			storeColumns(_mm_mul_ps(_mm_sub_ps(ones, _mm_mul_ps(twos, _mm_add_ps(yys, zzs))), lerped[SCALE_X]),
+						 _mm_mul_ps(_mm_mul_ps(twos, _mm_add_ps(xys, wzs)), lerped[SCALE_X]),
+						 _mm_mul_ps(_mm_mul_ps(twos, _mm_sub_ps(xzs, wys)), lerped[SCALE_X]),
+						 zeros, channelsTransformats, 0);
+			storeColumns(_mm_mul_ps(_mm_mul_ps(twos, _mm_sub_ps(xys, wzs)), lerped[SCALE_Y]),
+						 _mm_mul_ps(_mm_sub_ps(ones, _mm_mul_ps(twos, _mm_add_ps(xxs, zzs))), lerped[SCALE_Y]),
+						 _mm_mul_ps(_mm_mul_ps(twos, _mm_add_ps(yzs, wxs)), lerped[SCALE_Y]),
+						 zeros, channelsTransformats, 1);
+			storeColumns(_mm_mul_ps(_mm_mul_ps(twos, _mm_add_ps(xzs, wys)), lerped[SCALE_Z]),
+						 _mm_mul_ps(_mm_mul_ps(twos, _mm_sub_ps(yzs, wxs)), lerped[SCALE_Z]),
+						 _mm_mul_ps(_mm_sub_ps(ones, _mm_mul_ps(twos, _mm_add_ps(xxs, yys))), lerped[SCALE_Z]),
+						 zeros, channelsTransformats, 2);
+			storeColumns(lerped[TRANSLATION_X], lerped[TRANSLATION_Y], lerped[TRANSLATION_Z], ones, channelsTransformats, 3);
+		}
+	#else
+		for (unsigned int channelIdx = 0; channelIdx < animation.channelsNr; channelIdx++) {
+			glm::vec3 startScale(startKeys[SCALE_X * channelsNrPadded + channelIdx], startKeys[SCALE_Y * channelsNrPadded + channelIdx], startKeys[SCALE_Z * channelsNrPadded + channelIdx]);
+			glm::vec3 endScale(endKeys[SCALE_X * channelsNrPadded + channelIdx], endKeys[SCALE_Y * channelsNrPadded + channelIdx], endKeys[SCALE_Z * channelsNrPadded + channelIdx]);
+			glm::quat startRot(startKeys[ROT_W * channelsNrPadded + channelIdx], startKeys[ROT_X * channelsNrPadded + channelIdx], startKeys[ROT_Y * channelsNrPadded + channelIdx], startKeys[ROT_Z * channelsNrPadded + channelIdx]);
+			glm::quat endRot(endKeys[ROT_W * channelsNrPadded + channelIdx], endKeys[ROT_X * channelsNrPadded + channelIdx], endKeys[ROT_Y * channelsNrPadded + channelIdx], endKeys[ROT_Z * channelsNrPadded + channelIdx]);
+			glm::vec3 startTranslation(startKeys[TRANSLATION_X * channelsNrPadded + channelIdx], startKeys[TRANSLATION_Y * channelsNrPadded + channelIdx], startKeys[TRANSLATION_Z * channelsNrPadded + channelIdx]);
+			glm::vec3 endTranslation(endKeys[TRANSLATION_X * channelsNrPadded + channelIdx], endKeys[TRANSLATION_Y * channelsNrPadded + channelIdx], endKeys[TRANSLATION_Z * channelsNrPadded + channelIdx]);
+			glm::vec3 scale = startScale * (1 - interpolationFactor) + endScale * interpolationFactor;
+			glm::quat rot = glm::slerp(startRot, endRot, interpolationFactor);
+			glm::vec3 translation = startTranslation * (1 - interpolationFactor) + endTranslation * interpolationFactor;
+			outChannelsTransformats[channelIdx] = glm::translate(translation) * glm::mat4_cast(rot) * glm::scale(scale);
+		}
+	#endif
+	}
+
+	PosesEvaluator::PosesEvaluator(Corium3DUtils::ThreadPool* _threadPool) : threadPool(_threadPool) {}
+
+	void PosesEvaluator::evalPoses(Pose const* _poses, unsigned int _posesNr) {
+		PROFILE_ZONE("PosesEvaluator::evalPoses");
+		poses = _poses;
+		posesNr = _posesNr;
+		unsigned int jobsNr = (posesNr + POSES_NR_PER_JOB - 1) / POSES_NR_PER_JOB;
+		if (jobsScratches.size() < jobsNr)
+			jobsScratches.resize(jobsNr);
+
+		if (threadPool && jobsNr > 1)
+			threadPool->parallelFor(jobsNr, [this](unsigned int jobIdx) { runJob(jobIdx); });
+		else {
+			for (unsigned int jobIdx = 0; jobIdx < jobsNr; jobIdx++)
+				runJob(jobIdx);
+		}
+	}
+
+	void PosesEvaluator::runJob(unsigned int jobIdx) {
+		std::vector<glm::mat4>& scratch = jobsScratches[jobIdx];
+		unsigned int posesEndIdx = std::min(posesNr, (jobIdx + 1) * POSES_NR_PER_JOB);
+		for (unsigned int poseIdx = jobIdx * POSES_NR_PER_JOB; poseIdx < posesEndIdx; poseIdx++) {
+			Pose const& pose = poses[poseIdx];
+			if (scratch.size() < pose.modelAnimations->getPoseScratchSz())
+				scratch.resize(pose.modelAnimations->getPoseScratchSz());
+			pose.modelAnimations->evalPose(pose.query, scratch.data());
+		}
+	}
+
+} // namespace Corium3D
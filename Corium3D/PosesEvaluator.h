@@ -0,0 +1,105 @@
+#pragma once
+
+#include "MappedAssets.h"
+#include "ThreadPool.h"
+
+#include <glm/glm.hpp>
+#include <climits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86_FP) && _M_IX86_FP >= 2
+	#define CORIUM3D_POSES_EVALUATOR_SSE
+#endif
+
+namespace Corium3D {
+
+	// A model's animations laid out for evaluating its instances' poses in bulk. A key frame's channels' keys are stored
+	// side by side per component (SoA), so that 4 channels are interpolated at once (SSE, where available) - their scales
+	// and translations lerped, their rotations slerped - and the transformats hierarchy is flattened into its nodes' parents'
+	// indices: in the hierarchy's pre-order a node's parent precedes it, so the global transformats are composed in a single
+	// pass over the nodes, without a traversal stack.
+	class ModelAnimations {
+	public:
+		// an instance's pose - its animation at a point between 2 of its key frames
+		struct PoseQuery {
+			unsigned int animationIdx;
+			unsigned int endKeyFrameIdx;
+			// between the key frame preceding endKeyFrameIdx (0) and it (1)
+			float interpolationFactor;
+			// bonesNr matrices
+			glm::mat4* bonesTransformats;
+		};
+
+		static const unsigned int NO_PARENT = UINT_MAX;
+		static const unsigned int NO_CHANNEL = UINT_MAX;
+
+		ModelAnimations(ModelDescView const& modelDesc);
+		ModelAnimations(ModelAnimations const&) = delete;
+		unsigned int getAnimationsNr() const { return animations.size(); }
+		unsigned int getBonesNr() const { return bonesOffsets.size(); }
+		double getAnimationDur(unsigned int animationIdx) const { return animations[animationIdx].dur; }
+		unsigned int getAnimationTicksPerSecond(unsigned int animationIdx) const { return animations[animationIdx].ticksPerSecond; }
+		// animationTime is in ticks, within the animation's duration. inOutEndKeyFrameIdx is the instance's last one - the
+		// search goes on from it (from the start, once the animation wrapped around). returns the interpolation factor
+		float locateKeyFrames(unsigned int animationIdx, double animationTime, unsigned int& inOutEndKeyFrameIdx) const;
+		// the matrices the evaluation of the model's poses needs for scratch
+		unsigned int getPoseScratchSz() const { return poseScratchSz; }
+		void evalPose(PoseQuery const& query, glm::mat4* scratch) const;
+
+	private:
+		enum KeyComponent { SCALE_X, SCALE_Y, SCALE_Z, ROT_X, ROT_Y, ROT_Z, ROT_W, TRANSLATION_X, TRANSLATION_Y, TRANSLATION_Z, KEY_COMPONENTS_NR };
+
+		struct Animation {
+			double dur;
+			unsigned int ticksPerSecond;
+			unsigned int nodesNr;
+			unsigned int channelsNr;
+			// channelsNr rounded up to a multiple of 4 - the padding channels hold identity keys
+			unsigned int channelsNrPadded;
+			unsigned int keyFramesNr;
+			std::vector<double> keyFramesTimes;
+			// [(keyFrameIdx * KEY_COMPONENTS_NR + component) * channelsNrPadded + channelIdx] - a key frame's keys are contiguous
+			std::vector<float> keys;
+			// per node
+			std::vector<unsigned int> nodesChannelsIdxs;
+		};
+
+		std::vector<glm::mat4> bonesOffsets;
+		// per node of the transformats hierarchy, in its pre-order
+		std::vector<unsigned int> nodesParentsIdxs;
+		std::vector<glm::mat4> nodesTransformats;
+		std::vector<unsigned int> nodesBonesIdxs;
+		std::vector<Animation> animations;
+		unsigned int poseScratchSz = 0;
+
+		// the channels' local transformats, 4 channels at a time
+		void interpolateChannels(Animation const& animation, unsigned int endKeyFrameIdx, float interpolationFactor, glm::mat4* outChannelsTransformats) const;
+	};
+
+	// Evaluates a frame's poses - of the animated instances of all of the models at once - in jobs of a few instances each,
+	// run in parallel. Each pose is written to its own palette, so the palettes can share a single contiguous allocation.
+	class PosesEvaluator {
+	public:
+		struct Pose {
+			ModelAnimations const* modelAnimations;
+			ModelAnimations::PoseQuery query;
+		};
+
+		static const unsigned int POSES_NR_PER_JOB = 8;
+
+		// threadPool - the jobs are run on it (NULL - on the calling thread)
+		PosesEvaluator(Corium3DUtils::ThreadPool* threadPool = NULL);
+		PosesEvaluator(PosesEvaluator const&) = delete;
+		void evalPoses(Pose const* poses, unsigned int posesNr);
+
+	private:
+		Corium3DUtils::ThreadPool* threadPool;
+		Pose const* poses = NULL;
+		unsigned int posesNr = 0;
+		// per job
+		std::vector<std::vector<glm::mat4>> jobsScratches;
+
+		void runJob(unsigned int jobIdx);
+	};
+
+} // namespace Corium3D
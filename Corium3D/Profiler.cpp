@@ -0,0 +1,221 @@
+#include "Profiler.h"
+
+#ifdef PROFILING
+
+#include "RingBufferSPSC.h"
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+namespace Corium3DUtils {
+
+	namespace {
+
+		struct ZoneEvent {
+			const char* zoneName;
+			long long startNs;
+			long long endNs;
+		};
+
+		struct CapturedEvent {
+			ZoneEvent zoneEvent;
+			unsigned int threadIdx;
+		};
+
+		struct ThreadEventsBuffer {
+			ThreadEventsBuffer(unsigned int _threadIdx) : threadIdx(_threadIdx), events(Profiler::EVENTS_BUFFER_SZ_PER_THREAD) {}
+
+			unsigned int threadIdx;
+			RingBufferSPSC<ZoneEvent> events;
+		};
+		// allocated with plain new - C++14's does not honor extended alignments
+		static_assert(alignof(ThreadEventsBuffer) <= alignof(std::max_align_t), "ThreadEventsBuffer is over-aligned");
+
+		struct ZoneHistory {
+			long long frameDurNsAccum = 0;
+			unsigned int frameCallsNrAccum = 0;
+			long long durationsNs[Profiler::FRAMES_HISTORY_SZ];
+			unsigned int callsNrs[Profiler::FRAMES_HISTORY_SZ];
+			unsigned int nextHistoryIdx = 0;
+			unsigned int historyNr = 0;
+		};
+
+		// REMINDER: threads' buffers are never freed, so a buffer stays valid for its thread's lifetime
+		std::mutex threadsBuffersMutex;
+		std::vector<ThreadEventsBuffer*> threadsBuffers;
+		thread_local ThreadEventsBuffer* threadEventsBuffer = NULL;
+
+		// accessed from the loop thread (endFrame) only, apart from getters that are expected on that thread too
+		std::unordered_map<const char*, ZoneHistory> zonesHistories;
+		long long frameStartNs = 0;
+		bool isCapturing = false;
+		std::vector<CapturedEvent> capturedEvents;
+		std::vector<long long> capturedFramesEndsNs;
+
+		ThreadEventsBuffer* acquireThreadEventsBuffer() {
+			std::lock_guard<std::mutex> lock(threadsBuffersMutex);
+			threadEventsBuffer = new ThreadEventsBuffer((unsigned int)threadsBuffers.size());
+			threadsBuffers.push_back(threadEventsBuffer);
+			return threadEventsBuffer;
+		}
+
+		void writeJsonStr(std::ofstream& file, const char* str) {
+			file << '"';
+			for (const char* c = str; *c; c++) {
+				if (*c == '"' || *c == '\\')
+					file << '\\';
+				file << *c;
+			}
+			file << '"';
+		}
+
+	} // anonymous namespace
+
+	Profiler::ScopedZone::ScopedZone(const char* _zoneName) : zoneName(_zoneName), startNs(getCurrentTimeNs()) {}
+
+	Profiler::ScopedZone::~ScopedZone() {
+		recordZone(zoneName, startNs, getCurrentTimeNs());
+	}
+
+	void Profiler::recordZone(const char* zoneName, long long startNs, long long endNs) {
+		ThreadEventsBuffer* eventsBuffer = threadEventsBuffer ? threadEventsBuffer : acquireThreadEventsBuffer();
+		eventsBuffer->events.push({ zoneName, startNs, endNs });
+	}
+
+	long long Profiler::getCurrentTimeNs() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void Profiler::endFrame() {
+		long long frameEndNs = getCurrentTimeNs();
+		{
+			std::lock_guard<std::mutex> lock(threadsBuffersMutex);
+			for (ThreadEventsBuffer* eventsBuffer : threadsBuffers) {
+				unsigned int eventsNr = eventsBuffer->events.getAvailableNr();
+				ZoneEvent zoneEvent;
+				for (unsigned int eventIdx = 0; eventIdx < eventsNr; eventIdx++) {
+					eventsBuffer->events.pop(zoneEvent);
+					ZoneHistory& zoneHistory = zonesHistories[zoneEvent.zoneName];
+					zoneHistory.frameDurNsAccum += zoneEvent.endNs - zoneEvent.startNs;
+					zoneHistory.frameCallsNrAccum++;
+					if (isCapturing && capturedEvents.size() < CAPTURED_EVENTS_NR_MAX)
+						capturedEvents.push_back({ zoneEvent, eventsBuffer->threadIdx });
+				}
+			}
+		}
+
+		if (frameStartNs > 0) {
+			ZoneHistory& frameHistory = zonesHistories["Frame"];
+			frameHistory.frameDurNsAccum = frameEndNs - frameStartNs;
+			frameHistory.frameCallsNrAccum = 1;
+		}
+		frameStartNs = frameEndNs;
+		if (isCapturing)
+			capturedFramesEndsNs.push_back(frameEndNs);
+
+		for (auto& zoneHistoryEntry : zonesHistories) {
+			ZoneHistory& zoneHistory = zoneHistoryEntry.second;
+			if (zoneHistory.frameCallsNrAccum == 0)
+				continue;
+
+			zoneHistory.durationsNs[zoneHistory.nextHistoryIdx] = zoneHistory.frameDurNsAccum;
+			zoneHistory.callsNrs[zoneHistory.nextHistoryIdx] = zoneHistory.frameCallsNrAccum;
+			zoneHistory.nextHistoryIdx = (zoneHistory.nextHistoryIdx + 1) % FRAMES_HISTORY_SZ;
+			if (zoneHistory.historyNr < FRAMES_HISTORY_SZ)
+				zoneHistory.historyNr++;
+			zoneHistory.frameDurNsAccum = 0;
+			zoneHistory.frameCallsNrAccum = 0;
+		}
+	}
+
+	std::vector<Profiler::ZoneReport> Profiler::getZonesReports() {
+		std::vector<ZoneReport> zonesReports;
+		zonesReports.reserve(zonesHistories.size());
+		long long durationsNsSorted[FRAMES_HISTORY_SZ];
+		for (auto const& zoneHistoryEntry : zonesHistories) {
+			ZoneHistory const& zoneHistory = zoneHistoryEntry.second;
+			if (zoneHistory.historyNr == 0)
+				continue;
+
+			long long durationsNsSum = 0;
+			unsigned long long callsNrSum = 0;
+			for (unsigned int historyIdx = 0; historyIdx < zoneHistory.historyNr; historyIdx++) {
+				durationsNsSorted[historyIdx] = zoneHistory.durationsNs[historyIdx];
+				durationsNsSum += zoneHistory.durationsNs[historyIdx];
+				callsNrSum += zoneHistory.callsNrs[historyIdx];
+			}
+			std::sort(durationsNsSorted, durationsNsSorted + zoneHistory.historyNr);
+			unsigned int p99Idx = (unsigned int)std::ceil(0.99 * zoneHistory.historyNr) - 1;
+
+			zonesReports.push_back({ zoneHistoryEntry.first,
+									 durationsNsSorted[0] * 1e-6,
+									 (double)durationsNsSum / zoneHistory.historyNr * 1e-6,
+									 durationsNsSorted[zoneHistory.historyNr - 1] * 1e-6,
+									 durationsNsSorted[p99Idx] * 1e-6,
+									 (double)callsNrSum / zoneHistory.historyNr,
+									 zoneHistory.historyNr });
+		}
+
+		std::sort(zonesReports.begin(), zonesReports.end(), [](ZoneReport const& report1, ZoneReport const& report2) { return report1.avgMs > report2.avgMs; });
+		return zonesReports;
+	}
+
+	unsigned long long Profiler::getDroppedEventsNr() {
+		std::lock_guard<std::mutex> lock(threadsBuffersMutex);
+		unsigned long long droppedEventsNr = 0;
+		for (ThreadEventsBuffer* eventsBuffer : threadsBuffers)
+			droppedEventsNr += eventsBuffer->events.getStats().droppedNr;
+
+		return droppedEventsNr;
+	}
+
+	void Profiler::startCapture() {
+		capturedEvents.clear();
+		capturedFramesEndsNs.clear();
+		isCapturing = true;
+	}
+
+	void Profiler::stopCapture() {
+		isCapturing = false;
+	}
+
+	// Chrome trace event format - complete ("X") events per zone and global instant ("i") events per frame end
+	bool Profiler::writeChromeTrace(std::string const& fullPath) {
+		std::ofstream file(fullPath, std::ios::out | std::ios::trunc);
+		if (!file.is_open())
+			return false;
+
+		long long timeBaseNs = capturedEvents.empty() ? 0 : capturedEvents[0].zoneEvent.startNs;
+		for (CapturedEvent const& capturedEvent : capturedEvents)
+			timeBaseNs = std::min(timeBaseNs, capturedEvent.zoneEvent.startNs);
+
+		file << std::fixed << std::setprecision(3);
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		bool isFirst = true;
+		for (CapturedEvent const& capturedEvent : capturedEvents) {
+			file << (isFirst ? "\n" : ",\n") << "{\"name\":";
+			writeJsonStr(file, capturedEvent.zoneEvent.zoneName);
+			file << ",\"cat\":\"Corium3D\",\"ph\":\"X\",\"pid\":1,\"tid\":" << capturedEvent.threadIdx
+				 << ",\"ts\":" << (capturedEvent.zoneEvent.startNs - timeBaseNs) / 1000.0
+				 << ",\"dur\":" << (capturedEvent.zoneEvent.endNs - capturedEvent.zoneEvent.startNs) / 1000.0 << "}";
+			isFirst = false;
+		}
+		for (long long frameEndNs : capturedFramesEndsNs) {
+			if (frameEndNs < timeBaseNs)
+				continue;
+			file << (isFirst ? "\n" : ",\n") << "{\"name\":\"Frame\",\"cat\":\"Corium3D\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":" << (frameEndNs - timeBaseNs) / 1000.0 << "}";
+			isFirst = false;
+		}
+		file << "\n]}\n";
+
+		return file.good();
+	}
+
+} // namespace Corium3DUtils
+
+#endif // PROFILING
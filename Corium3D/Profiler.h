@@ -0,0 +1,71 @@
+//
+// Frame profiler - scoped zones recorded into per-thread lock-free buffers,
+// aggregated once per frame and exportable as a Chrome trace (chrome://tracing).
+// Compiled in only when PROFILING is defined, otherwise the macros expand to nothing.
+//
+
+#pragma once
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef PROFILING
+	// REMINDER: zoneName has to be a string literal (events keep the pointer)
+	#define PROFILE_ZONE(zoneName) Corium3DUtils::Profiler::ScopedZone PROFILE_CONCAT(profileZone, __LINE__)(zoneName)
+	#define PROFILE_FRAME_END() Corium3DUtils::Profiler::endFrame()
+#else
+	#define PROFILE_ZONE(zoneName)
+	#define PROFILE_FRAME_END()
+#endif
+
+#ifdef PROFILING
+
+#include <string>
+#include <vector>
+
+namespace Corium3DUtils {
+
+	class Profiler {
+	public:
+		struct ZoneReport {
+			const char* zoneName;
+			// per frame durations over the last FRAMES_HISTORY_SZ frames the zone showed up in
+			double minMs;
+			double avgMs;
+			double maxMs;
+			double p99Ms;
+			double callsNrPerFrameAvg;
+			unsigned int framesNr;
+		};
+
+		class ScopedZone {
+		public:
+			ScopedZone(const char* _zoneName);
+			ScopedZone(ScopedZone const&) = delete;
+			~ScopedZone();
+
+		private:
+			const char* zoneName;
+			long long startNs;
+		};
+
+		static const unsigned int FRAMES_HISTORY_SZ = 128;
+		static const unsigned int EVENTS_BUFFER_SZ_PER_THREAD = 16384;
+		static const unsigned int CAPTURED_EVENTS_NR_MAX = 1 << 20;
+
+		// to be called once per frame from the loop thread - drains all threads' buffers and aggregates
+		static void endFrame();
+		static std::vector<ZoneReport> getZonesReports();
+		static unsigned long long getDroppedEventsNr();
+		static void startCapture();
+		static void stopCapture();
+		static bool writeChromeTrace(std::string const& fullPath);
+		static long long getCurrentTimeNs();
+
+	private:
+		static void recordZone(const char* zoneName, long long startNs, long long endNs);
+	};
+
+} // namespace Corium3DUtils
+
+#endif // PROFILING
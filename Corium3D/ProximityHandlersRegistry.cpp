@@ -0,0 +1,107 @@
+#include "ProximityHandlersRegistry.h"
+
+namespace Corium3D {
+
+	const unsigned int ProximityHandlersRegistry::COLLISION_LAYERS_ALL;
+
+	ProximityHandlersRegistry::ProximityHandlersRegistry(unsigned int _modelsNr) : modelsNr(_modelsNr),
+		modelsPairsOverridingInstancesNrs(modelsNr * modelsNr, 0),
+		modelsCollisionLayers(modelsNr, COLLISION_LAYERS_ALL),
+		modelsCollisionLayersMasks(modelsNr, COLLISION_LAYERS_ALL),
+		testedModelsPairs(modelsNr * modelsNr + 1, 0) {}
+
+	void ProximityHandlersRegistry::setModelsPairHandlers(unsigned int modelIdx, unsigned int otherModelIdx, ProximityHandlingMethods const& handlers) {
+#if DEBUG
+		if (modelIdx >= modelsNr || otherModelIdx >= modelsNr)
+			throw std::out_of_range("Model index out of range");
+#endif
+		if (isEmpty(handlers))
+			modelsPairsHandlers.erase(genKey(modelIdx, otherModelIdx));
+		else
+			modelsPairsHandlers[genKey(modelIdx, otherModelIdx)] = handlers;
+		updateTestedModelsPair(modelIdx, otherModelIdx);
+	}
+
+	void ProximityHandlersRegistry::setInstanceHandlers(unsigned int modelIdx, unsigned int instanceIdx, unsigned int otherModelIdx, ProximityHandlingMethods const& handlers) {
+#if DEBUG
+		if (modelIdx >= modelsNr || otherModelIdx >= modelsNr)
+			throw std::out_of_range("Model index out of range");
+#endif
+		unsigned long long instanceKey = genKey(modelIdx, instanceIdx);
+		InstanceHandlers& instanceHandlers = instancesHandlers[instanceKey];
+		for (auto handlersIt = instanceHandlers.begin(); handlersIt != instanceHandlers.end(); handlersIt++) {
+			if (handlersIt->first == otherModelIdx) {
+				if (isEmpty(handlers)) {
+					instanceHandlers.erase(handlersIt);
+					modelsPairsOverridingInstancesNrs[modelIdx * modelsNr + otherModelIdx]--;
+					if (instanceHandlers.empty())
+						instancesHandlers.erase(instanceKey);
+					updateTestedModelsPair(modelIdx, otherModelIdx);
+				}
+				else
+					handlersIt->second = handlers;
+
+				return;
+			}
+		}
+
+		if (isEmpty(handlers)) {
+			if (instanceHandlers.empty())
+				instancesHandlers.erase(instanceKey);
+			return;
+		}
+		instanceHandlers.push_back({ otherModelIdx, handlers });
+		modelsPairsOverridingInstancesNrs[modelIdx * modelsNr + otherModelIdx]++;
+		updateTestedModelsPair(modelIdx, otherModelIdx);
+	}
+
+	void ProximityHandlersRegistry::clearInstanceHandlers(unsigned int modelIdx, unsigned int instanceIdx) {
+		auto instanceHandlersIt = instancesHandlers.find(genKey(modelIdx, instanceIdx));
+		if (instanceHandlersIt == instancesHandlers.end())
+			return;
+
+		InstanceHandlers instanceHandlers = std::move(instanceHandlersIt->second);
+		instancesHandlers.erase(instanceHandlersIt);
+		for (auto const& otherModelHandlers : instanceHandlers) {
+			modelsPairsOverridingInstancesNrs[modelIdx * modelsNr + otherModelHandlers.first]--;
+			updateTestedModelsPair(modelIdx, otherModelHandlers.first);
+		}
+	}
+
+	void ProximityHandlersRegistry::setModelCollisionLayers(unsigned int modelIdx, unsigned int layers, unsigned int layersMask) {
+#if DEBUG
+		if (modelIdx >= modelsNr)
+			throw std::out_of_range("Model index out of range");
+#endif
+		modelsCollisionLayers[modelIdx] = layers;
+		modelsCollisionLayersMasks[modelIdx] = layersMask;
+		for (unsigned int otherModelIdx = 0; otherModelIdx < modelsNr; otherModelIdx++)
+			updateTestedModelsPair(modelIdx, otherModelIdx);
+	}
+
+	ProximityHandlersRegistry::ProximityHandlingMethods const* ProximityHandlersRegistry::find(unsigned int modelIdx, unsigned int instanceIdx, unsigned int otherModelIdx) const {
+		if (modelsPairsOverridingInstancesNrs[modelIdx * modelsNr + otherModelIdx] > 0) {
+			auto instanceHandlersIt = instancesHandlers.find(genKey(modelIdx, instanceIdx));
+			if (instanceHandlersIt != instancesHandlers.end()) {
+				for (auto const& otherModelHandlers : instanceHandlersIt->second) {
+					if (otherModelHandlers.first == otherModelIdx)
+						return &otherModelHandlers.second;
+				}
+			}
+		}
+
+		auto modelsPairHandlersIt = modelsPairsHandlers.find(genKey(modelIdx, otherModelIdx));
+		return modelsPairHandlersIt != modelsPairsHandlers.end() ? &modelsPairHandlersIt->second : NULL;
+	}
+
+	bool ProximityHandlersRegistry::hasHandlers(unsigned int modelIdx, unsigned int otherModelIdx) const {
+		return modelsPairsOverridingInstancesNrs[modelIdx * modelsNr + otherModelIdx] > 0 || modelsPairsHandlers.count(genKey(modelIdx, otherModelIdx)) > 0;
+	}
+
+	void ProximityHandlersRegistry::updateTestedModelsPair(unsigned int modelIdx1, unsigned int modelIdx2) {
+		bool doLayersMatch = (modelsCollisionLayers[modelIdx1] & modelsCollisionLayersMasks[modelIdx2]) && (modelsCollisionLayers[modelIdx2] & modelsCollisionLayersMasks[modelIdx1]);
+		unsigned char isTested = doLayersMatch && (hasHandlers(modelIdx1, modelIdx2) || hasHandlers(modelIdx2, modelIdx1));
+		testedModelsPairs[modelIdx1 * modelsNr + modelIdx2] = testedModelsPairs[modelIdx2 * modelsNr + modelIdx1] = isTested;
+	}
+
+} // namespace Corium3D
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Corium3D.h"
+#include <unordered_map>
+#include <vector>
+#include <utility>
+
+namespace Corium3D {
+
+	// Sparse registry of the game elements' collision and detachment handlers.
+	// Handlers are kept per models pair, optionally overridden per instance, and only registered pairs take space.
+	// It also maintains a dense modelsNr x modelsNr matrix of the models pairs that have to be tested at all -
+	// a pair is tested when the models' collision layers match and at least one side has a handler for the other.
+	class ProximityHandlersRegistry {
+	public:
+		typedef Corium3DEngine::GameLmnt::ProximityHandlingMethods ProximityHandlingMethods;
+
+		static const unsigned int COLLISION_LAYERS_ALL = 0xFFFFFFFF;
+
+		ProximityHandlersRegistry(unsigned int modelsNr);
+		ProximityHandlersRegistry(ProximityHandlersRegistry const&) = delete;
+		void setModelsPairHandlers(unsigned int modelIdx, unsigned int otherModelIdx, ProximityHandlingMethods const& handlers);
+		void setInstanceHandlers(unsigned int modelIdx, unsigned int instanceIdx, unsigned int otherModelIdx, ProximityHandlingMethods const& handlers);
+		void clearInstanceHandlers(unsigned int modelIdx, unsigned int instanceIdx);
+		// the models collide only if (layers1 & layersMask2) && (layers2 & layersMask1)
+		void setModelCollisionLayers(unsigned int modelIdx, unsigned int layers, unsigned int layersMask);
+		// the instance's override if it has one, the models pair's handlers otherwise (NULL when there are neither)
+		ProximityHandlingMethods const* find(unsigned int modelIdx, unsigned int instanceIdx, unsigned int otherModelIdx) const;
+		unsigned char const* getTestedModelsPairs() const { return &testedModelsPairs[0]; }
+		unsigned int getModelsNr() const { return modelsNr; }
+
+	private:
+		typedef std::vector<std::pair<unsigned int, ProximityHandlingMethods>> InstanceHandlers;
+
+		const unsigned int modelsNr;
+		std::unordered_map<unsigned long long, ProximityHandlingMethods> modelsPairsHandlers;
+		// keyed by the instance - holds (otherModelIdx, handlers) records
+		std::unordered_map<unsigned long long, InstanceHandlers> instancesHandlers;
+		// per ordered models pair - the number of instances of the first model that override handlers for the second
+		std::vector<unsigned int> modelsPairsOverridingInstancesNrs;
+		std::vector<unsigned int> modelsCollisionLayers;
+		std::vector<unsigned int> modelsCollisionLayersMasks;
+		std::vector<unsigned char> testedModelsPairs;
+
+		static unsigned long long genKey(unsigned int idx1, unsigned int idx2) { return ((unsigned long long)idx1 << 32) | idx2; }
+		static bool isEmpty(ProximityHandlingMethods const& handlers) { return !handlers.collisionCallback && !handlers.detachmentCallback; }
+		bool hasHandlers(unsigned int modelIdx, unsigned int otherModelIdx) const;
+		void updateTestedModelsPair(unsigned int modelIdx1, unsigned int modelIdx2);
+	};
+
+} // namespace Corium3D
@@ -0,0 +1,40 @@
+#include "RadixSort.h"
+
+#include <cstring>
+
+namespace Corium3DUtils {
+
+	const unsigned int KEY_BYTES_NR = sizeof(uint64_t);
+	const unsigned int BYTE_VALS_NR = 256;
+
+	void radixSort(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch) {
+		size_t keysNr = keys.size();
+		if (keysNr < 2)
+			return;
+
+		unsigned int bytesHistograms[KEY_BYTES_NR][BYTE_VALS_NR];
+		memset(bytesHistograms, 0, sizeof(bytesHistograms));
+		for (uint64_t key : keys) {
+			for (unsigned int byteIdx = 0; byteIdx < KEY_BYTES_NR; byteIdx++)
+				bytesHistograms[byteIdx][(key >> (8 * byteIdx)) & 0xFF]++;
+		}
+
+		scratch.resize(keysNr);
+		for (unsigned int byteIdx = 0; byteIdx < KEY_BYTES_NR; byteIdx++) {
+			unsigned int* histogram = bytesHistograms[byteIdx];
+			if (histogram[(keys[0] >> (8 * byteIdx)) & 0xFF] == keysNr)
+				continue;
+
+			unsigned int bucketsOffsets[BYTE_VALS_NR];
+			unsigned int offset = 0;
+			for (unsigned int byteVal = 0; byteVal < BYTE_VALS_NR; byteVal++) {
+				bucketsOffsets[byteVal] = offset;
+				offset += histogram[byteVal];
+			}
+			for (uint64_t key : keys)
+				scratch[bucketsOffsets[(key >> (8 * byteIdx)) & 0xFF]++] = key;
+			keys.swap(scratch);
+		}
+	}
+
+} // namespace Corium3DUtils
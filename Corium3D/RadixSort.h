@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Corium3DUtils {
+
+	// Stable LSD radix sort of 64 bits keys, ascending, a byte per pass. The bytes' histograms are counted in a single read
+	// of the keys, and the passes over bytes that all of the keys share are skipped - keys packing a few narrow fields
+	// sort in a few passes. scratch is resized to the keys' number
+	void radixSort(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch);
+
+} // namespace Corium3DUtils
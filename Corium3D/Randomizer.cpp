@@ -3,8 +3,8 @@
 
 namespace Corium3DUtils {
 
-	Randomizer::Randomizer(Timer timer) {
-		srand(timer.getCurrentTime());
+	Randomizer::Randomizer(Timer const& timer) {
+		srand((unsigned int)timer.getCurrentTimeNs());
 	}
 
 	int Randomizer::randI(unsigned int rangeMax) {
@@ -6,7 +6,7 @@ namespace Corium3DUtils {
 
 	class Randomizer {
 	public:
-		Randomizer(Timer timer);
+		Randomizer(Timer const& timer);
 		int randI(unsigned int rangeMax);
 		int randI(unsigned int rangeMin, unsigned int rangeMax);
 		float randF(float rangeMax);
@@ -7,12 +7,12 @@
 #include "ServiceLocator.h"
 #include "AssetsOps.h"
 #include "Timer.h"
+#include "Profiler.h"
 #include <glm/gtx/rotate_vector.hpp>
 #include <glm/gtx/norm.hpp>
-#include <assimp/scene.h>
-#include <assimp/Importer.hpp>
-#include <assimp/postprocess.h>
 #include <limits.h>
+#include <cstddef>
+#include <algorithm>
 #include <string>
 #include <fstream>
 
@@ -31,6 +31,7 @@ namespace Corium3D {
 	using std::to_string;
 
 	const GLchar* INSTANCE_DATA_IDX_ATTRIB_NAME = "aInstanceDataIdx";
+	const GLchar* BONES_TRANSFORMS_BASE_IDX_ATTRIB_NAME = "aBonesTransformsBaseIdx";
 	const GLchar* VERTEX_POS_ATTRIB_NAME = "aPos";
 	const GLchar* VIEW_PROJECTION_MAT_UNIFORM_NAME = "uVpMat";
 	const GLchar* VERTEX_BONES_IDS_ATTRIB_NAME = "aBonesIDs";
@@ -106,8 +107,9 @@ namespace Corium3D {
 		EGLConfig config = NULL;	
 
 	#elif defined(_WIN32) || defined(__VC32__) || defined(_WIN64) || defined(__VC64__) && !defined(__CYGWIN__) && !defined(__SCITECH_SNAP__)
+		// 4.4 - persistently mapped buffers (the frame ring)
 		const int contextAttribs[7] = { WGL_CONTEXT_MAJOR_VERSION_ARB, 4,
-			WGL_CONTEXT_MINOR_VERSION_ARB, 3,
+			WGL_CONTEXT_MINOR_VERSION_ARB, 4,
 			WGL_CONTEXT_FLAGS_ARB, WGL_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB,
 			0 };
 
@@ -118,149 +120,39 @@ namespace Corium3D {
 	#endif
 	};
 
+	// an animated model's animations and the pool of its instances' animators
 	class Renderer::ModelAnimator {
 	public:
 		friend InstanceAnimator;
-		ModelAnimator(aiScene const* scene, GLuint _bonesTransformatsBuffer, unsigned int _bonesTransformatsBufferModelBaseIdx, unsigned int _bonesNr, glm::mat4* _meshesTransformsBuffer, unsigned int instancesNrMax);
+		ModelAnimator(ModelDescView const& modelDesc, unsigned int instancesNrMax);
 		~ModelAnimator();	
 		InstanceAnimator* acquireInstance(unsigned int instanceIdx);
 		void releaseInstance(InstanceAnimator* instanceAnimator);
 
 	private:
-		struct Animation {	
-			struct TransformatsHierarchyNode {
-				//TODO: Find out if there is use for this in case the node is animated
-				glm::mat4 transformat;			
-				bool isNodeAnimated;
-				unsigned int meshesNr;
-				unsigned int* meshesIdxs;
-				unsigned int boneIdx;
-				unsigned int childrenNr;
-				TransformatsHierarchyNode** children;
-				TransformatsHierarchyNode* parent;
-			};
-
-			// root is at index 0
-			TransformatsHierarchyNode* TransformatsHierarchyBuffer;		
-			unsigned int nodesNr;
-			unsigned int treeDepthMax;
-			double dur;
-			unsigned int ticksPerSecond;
-			unsigned int channelsNr;
-			unsigned int keyFramesNr;
-			double* keyFramesTimes;
-			glm::vec3** scales;
-			glm::quat** rots;
-			glm::vec3** translations;
-		};
-		
-		GLuint bonesTransformatsBuffer;
-		unsigned int bonesTransformatsBufferModelBaseIdx;
-		ObjPool<InstanceAnimator>* instanceAnimatorsPool;
-		unsigned int bonesNr;
-		glm::mat4* meshesTransformsBuffer;
-		glm::mat4* bonesOffsets;
-		unsigned int animationsNr;
-		Animation* animations;
-	
-		Animation::TransformatsHierarchyNode genTransformatHierarchyNode(aiNode* node, const aiScene* scene, unsigned int animationIdx, unsigned int nodeToChannelIdxMapping);
+		ChunkedObjPool<InstanceAnimator>* instanceAnimatorsPool;
+		ModelAnimations animations;
 	 };
 
 	class Renderer::InstanceAnimator {
 	public:
-		friend ObjPool<InstanceAnimator>;
+		friend ChunkedObjPool<InstanceAnimator>;
 		friend ModelAnimator;
 
 		void start(unsigned int animationIdx);
-		void updateRendererBuffer();
+		// the instance's pose at currTime, to be evaluated by the frame's PosesEvaluator. bonesTransformsPtr is the instance's
+		// palette's place in the frame ring. NULL - the model has no bones, and its meshes' transformats are written instead
+		PosesEvaluator::Pose genPose(double currTime, glm::mat4* bonesTransformsPtr);
 
 	private:
 		ModelAnimator const& modelAnimator;
-		unsigned int bonesTransformatsBufferInstanceBaseIdx;
 
-		ModelAnimator::Animation& animation;
+		unsigned int animationIdx;
 		float activeAnimationStartTime;
 		unsigned int endKeyFrameIdxCache;
-		unsigned int* childrenIdxsStack;
-		glm::mat4* transformatsStack;
 		unsigned int instanceIdx;
 
 		InstanceAnimator(ModelAnimator& modelAnimator, unsigned int instanceIdx);
-		~InstanceAnimator();
-	};
-
-	class Renderer::VisibleNodesIt3D {
-	public:
-		VisibleNodesIt3D(Renderer const& _renderer) : renderer(_renderer) {}
-	
-		void init(BVH::Node<AABB3DRotatable>* root) {
-			if (root != NULL && renderer.isBoundingSphereVisible(static_cast<BVH::Node3D*>(root)->getBoundingSphere())) {
-				it = root;
-				findNextVisibleLeaf();
-			}		
-		}
-
-		BVH::Node<AABB3DRotatable>* getNext() {
-			BVH::Node<AABB3DRotatable>* retNode = it;		
-			it = it->getEscapeNode();			
-			findNextVisibleLeaf();
-		
-			return retNode;
-		}
-																		
-		bool isDone() { return it == NULL; }
-
-	private:
-		Renderer const& renderer;
-		BVH::Node<AABB3DRotatable>* it = NULL;
-
-		void findNextVisibleLeaf() {
-			while (it != NULL) {
-				if (it->isLeaf()) {
-					if (renderer.isBoundingSphereVisible(static_cast<BVH::Node3D*>(it)->getBoundingSphere()))
-						break;
-					else
-						it = it->getEscapeNode();
-				}
-				else {
-					if (renderer.isBoundingSphereVisible(static_cast<BVH::Node3D*>(it)->getBoundingSphere()))
-						it = it->getChild(0);
-					else
-						it = it->getEscapeNode();
-				}			
-			}		
-		}
-	};
-
-	class Renderer::NodesIt2D {
-	public:
-		NodesIt2D(Renderer const& _renderer) : renderer(_renderer) {}
-	
-		void init(BVH::Node<AABB2DRotatable>* root) {
-			if (root != NULL) {
-				for (it = root; it->getChild(0) != NULL; it = it->getChild(0));
-			}
-		}
-
-		BVH::Node<AABB2DRotatable>* getNext() {
-			BVH::Node<AABB2DRotatable>* retNode = it;
-			// get next sub tree
-			for (BVH::Node<AABB2DRotatable>* parent = it->getParent();
-				parent != NULL && parent->getChild(1) == it;
-				it = parent, parent = it->getParent());
-
-			if ((it = it->getParent()) != NULL) {			
-				for (it = it->getChild(1); it->getChild(0) != NULL; it = it->getChild(0));
-			}
-
-			return retNode;
-		}
-
-		bool isDone() { return it == NULL; }
-
-	private:
-		Renderer const& renderer;
-		BVH::Node<AABB2DRotatable>* it = NULL;	
 	};
 
 	inline void cpyCStrsToStrs(string* strsArr, const char** cStrsArr, unsigned int cStrsNr) {
@@ -276,25 +168,27 @@ namespace Corium3D {
 		cpyCStrsToStrs(fragShadersFullPaths, _fragShadersFullPaths, shadersNr);	
 		
 		vaos = new GLuint[shadersNr];		
+		instanceDataIdxAttribLocs = new GLuint[shadersNr];
+		bonesTransformsBaseIdxAttribLocs = new GLuint[shadersNr];
 		progs = new GLuint[shadersNr];
 		vertexShaders = new GLuint[shadersNr];
 		fragShaders = new GLuint[shadersNr];		
 
 		openGlContext = new OpenGlContext();	
-		visibleNodesIt3D = new VisibleNodesIt3D(*this);
-		nodesIt2D = new NodesIt2D(*this);	
+		cullingThreadPool = new Corium3DUtils::ThreadPool();
 	}
 
 	Renderer::~Renderer() {    	
 		unloadScene();
 
-		delete nodesIt2D;
-		delete visibleNodesIt3D;	
+		delete cullingThreadPool;
 		delete openGlContext;				
 
 		delete[] fragShaders;
 		delete[] vertexShaders;
 		delete[] progs;
+		delete[] bonesTransformsBaseIdxAttribLocs;
+		delete[] instanceDataIdxAttribLocs;
 		delete[] vaos;
 			
 		delete[] vertexShadersFullPaths;
@@ -312,7 +206,7 @@ namespace Corium3D {
 	}
 
 	bool Renderer::surfaceSzChanged(unsigned int _winWidth, unsigned int _winHeight) {
-		ServiceLocator::getLogger().logd("Renderer", "surfaceChanged called.");
+		LOGD("Renderer", "surfaceChanged called.");
 		winWidth = _winWidth;
 		winHeight= _winHeight;
 		glViewport(0, 0, winWidth, winHeight);    			
@@ -336,60 +230,45 @@ namespace Corium3D {
 		return true;
 	}
 
-	void Renderer::loadScene(std::vector<ModelDesc>&& modelDescs, unsigned int staticModelDescsNr, unsigned int mobileModelDescsNr, unsigned int* _modelsInstancesNrsMaxima, BVH& _bvh) {		
+	void Renderer::loadScene(std::vector<ModelDescView>&& modelDescs, unsigned int staticModelDescsNr, unsigned int mobileModelDescsNr, unsigned int* _modelsInstancesNrsMaxima, BVH& _bvh) {		
 		unloadScene();
 
-		modelDescsBuffer = modelDescs;
+		modelDescsBuffer = std::move(modelDescs);
 		staticModelsNr = staticModelDescsNr;
 		mobileModelsNr = mobileModelDescsNr;
 		modelsNrTotal = staticModelsNr + mobileModelsNr;
-		this->modelsInstancesNrsMaxima = new unsigned int[modelsNrTotal];
-		memcpy(modelsInstancesNrsMaxima, _modelsInstancesNrsMaxima, modelsNrTotal * sizeof(unsigned int));		
+		instancesRanges = new InstancesRanges(_modelsInstancesNrsMaxima, modelsNrTotal);
 
-		instancesBaseIdxsPerModel = new unsigned int[modelsNrTotal];
 		verticesColorsBaseIdxs = new unsigned int**[modelsNrTotal];
 		modelsAnimators = new ModelAnimator*[modelsNrTotal];
 		instancesAnimators = new InstanceAnimator**[modelsNrTotal];
 		verticesNrTotal = 0;
-		instancesNrsMaximaMax = 0;
 		staticInstancesNrMax = 0;
-		bonesInstancedNrMax = 0;
+		meshesNrTotal = 0;
 		facesNrTotal = 0;
+		lodsIdxsNrTotal = 0;
 		verticesColorsNrTotal = 0;
 		for (unsigned int modelIdx = 0; modelIdx < modelsNrTotal; modelIdx++) {
 			verticesNrTotal += modelDescsBuffer[modelIdx].verticesNr;
-			unsigned int modelInstancesNrMax = modelsInstancesNrsMaxima[modelIdx];
-			if (modelInstancesNrMax > instancesNrsMaximaMax)
-				instancesNrsMaximaMax = modelInstancesNrMax;
+			meshesNrTotal += modelDescsBuffer[modelIdx].meshesNr * (1 + modelDescsBuffer[modelIdx].lodsDescs.size());
+			unsigned int modelInstancesNrMax = instancesRanges->getInstancesNrMax(modelIdx);
 			if (modelIdx < staticModelsNr)
 				staticInstancesNrMax += modelInstancesNrMax;
-			bonesInstancedNrMax += modelDescsBuffer[modelIdx].bonesNr * modelInstancesNrMax;
 			facesNrTotal += modelDescsBuffer[modelIdx].facesNr;
+			lodsIdxsNrTotal += modelDescsBuffer[modelIdx].lodsIdxs.size();
 			modelsAnimators[modelIdx] = NULL;
-			instancesAnimators[modelIdx] = new InstanceAnimator*[modelInstancesNrMax];
-			for (unsigned int instanceIdx = 0; instanceIdx < modelInstancesNrMax; instanceIdx++)
-				instancesAnimators[modelIdx][instanceIdx] = NULL;
+			instancesAnimators[modelIdx] = new InstanceAnimator*[modelInstancesNrMax]();
 			verticesColorsNrTotal += modelDescsBuffer[modelIdx].verticesColorsNrTotal;
 			verticesColorsBaseIdxs[modelIdx] = new unsigned int* [modelDescsBuffer[modelIdx].meshesNr];
 			for (unsigned int meshIdx = 0; meshIdx < modelDescsBuffer[modelIdx].meshesNr; meshIdx++)
 				verticesColorsBaseIdxs[modelIdx][meshIdx] = new unsigned int[modelDescsBuffer[modelIdx].extraColorsNrsPerMesh[meshIdx]]();
 		}
 
-		visibleStaticModelsInstancesIdxs = new unsigned int*[staticModelsNr];
-		visibleStaticModelsInstancesNrs = new unsigned int[staticModelsNr]();
-		for (unsigned int modelIdx = 0; modelIdx < staticModelsNr; modelIdx++) {
-			unsigned int staticModelInstancesNrMax = modelsInstancesNrsMaxima[modelIdx];
-			visibleStaticModelsInstancesIdxs[modelIdx] = new unsigned int[staticModelInstancesNrMax]();
-		}
-
-		mobileModelsTransformatsBuffers = new glm::mat4*[mobileModelsNr];
-		visibleMobileModelsInstancesIdxs = new unsigned int*[mobileModelsNr]();
-		visibleMobileModelsInstancesNrs = new unsigned int[mobileModelsNr]();
-		for (unsigned int modelIdx = 0; modelIdx < mobileModelsNr; modelIdx++) {
-			unsigned int mobileModelInstancesNrMax = modelsInstancesNrsMaxima[staticModelsNr + modelIdx];
-			mobileModelsTransformatsBuffers[modelIdx] = new glm::mat4[mobileModelInstancesNrMax];
-			visibleMobileModelsInstancesIdxs[modelIdx] = new unsigned int[mobileModelInstancesNrMax]();
-		}
+		drawListBuilder = new DrawListBuilder(modelDescsBuffer, staticModelsNr, instancesRanges->getInstancesNrsMaxima(), cullingThreadPool);
+		posesEvaluator = new PosesEvaluator(cullingThreadPool);
+		staticTransformatsShadow.assign(staticInstancesNrMax, glm::mat4(1.0f));
+		selectedVerticesColorsIdxsShadow.assign(staticInstancesNrMax, 0);
+		frameModelsBaseInstances.resize(modelsNrTotal);
 
 		refreshViewMat();
 		
@@ -409,18 +288,15 @@ namespace Corium3D {
 	
 		bvh = NULL;
 
-		for (unsigned int modelIdx = 0; modelIdx < mobileModelsNr; modelIdx++) {		
-			delete[] mobileModelsTransformatsBuffers[modelIdx];
-			delete[] visibleMobileModelsInstancesIdxs[modelIdx];
-		}
-		delete[] mobileModelsTransformatsBuffers;
-		delete[] visibleMobileModelsInstancesIdxs;
-		delete[] visibleMobileModelsInstancesNrs;
-	
-		for (unsigned int modelIdx = 0; modelIdx < staticModelsNr; modelIdx++)		
-			delete[] visibleStaticModelsInstancesIdxs[modelIdx];	
-		delete[] visibleStaticModelsInstancesIdxs;
-		delete[] visibleStaticModelsInstancesNrs;
+		delete drawListBuilder;
+		drawListBuilder = NULL;
+		delete posesEvaluator;
+		posesEvaluator = NULL;
+		framePoses.clear();
+		staticTransformatsShadow.clear();
+		staticTransformatsDirtyRanges.clear();
+		selectedVerticesColorsIdxsShadow.clear();
+		frameModelsBaseInstances.clear();
 
 		for (unsigned int modelIdx = 0; modelIdx < modelsNrTotal; modelIdx++) {		
 			delete[] instancesAnimators[modelIdx];				
@@ -430,13 +306,14 @@ namespace Corium3D {
 		}	
 		delete[] verticesColorsBaseIdxs;	
 		delete[] instancesAnimators;
-		delete[] instancesBaseIdxsPerModel;
 		delete[] modelsAnimators;
 
-		delete[] modelsInstancesNrsMaxima;
+		delete instancesRanges;
+		instancesRanges = NULL;
 
 		isSceneLoaded = false;
 		needReloadGlBuffers = false;	
+		needReloadInstancesBuffers = false;
 	}
 
 	void Renderer::translateCamera(glm::vec3 const& translation) {	
@@ -512,14 +389,45 @@ namespace Corium3D {
 	}
 
 	void Renderer::setStaticModelInstanceTransform(unsigned int modelIdx, unsigned int instanceIdx, glm::mat4 const& transformat) {
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, mvpMatsBuffer);
-		glBufferSubData(GL_SHADER_STORAGE_BUFFER, (instancesBaseIdxsPerModel[modelIdx] + instanceIdx) * sizeof(glm::mat4), sizeof(glm::mat4), &transformat);	
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		unsigned int staticInstanceIdx = instancesRanges->getBaseIdx(modelIdx) + instanceIdx;
+		staticTransformatsShadow[staticInstanceIdx] = transformat;
+		staticTransformatsDirtyRanges.markDirty(staticInstanceIdx);
+	}
+
+	// the following models' instances are shifted in the instances' buffers - the static ones' data is moved along in the shadows
+	void Renderer::setModelInstancesNrMax(unsigned int modelIdx, unsigned int instancesNrMax) {
+		unsigned int instancesNrMaxPrev = instancesRanges->getInstancesNrMax(modelIdx);
+		unsigned int modelInstancesEndIdxPrev = instancesRanges->getEndIdx(modelIdx);
+		unsigned int addedInstancesNr = instancesRanges->grow(modelIdx, instancesNrMax);
+		if (addedInstancesNr == 0)
+			return;
+
+		InstanceAnimator** modelInstancesAnimators = new InstanceAnimator*[instancesNrMax]();
+		memcpy(modelInstancesAnimators, instancesAnimators[modelIdx], instancesNrMaxPrev * sizeof(InstanceAnimator*));
+		delete[] instancesAnimators[modelIdx];
+		instancesAnimators[modelIdx] = modelInstancesAnimators;
+
+		if (modelIdx < staticModelsNr) {
+			staticInstancesNrMax += addedInstancesNr;
+			staticTransformatsShadow.insert(staticTransformatsShadow.begin() + modelInstancesEndIdxPrev, addedInstancesNr, glm::mat4(1.0f));
+			selectedVerticesColorsIdxsShadow.insert(selectedVerticesColorsIdxsShadow.begin() + modelInstancesEndIdxPrev, addedInstancesNr, 0);
+		}
+		drawListBuilder->setModelInstancesNrMax(modelIdx, instancesNrMax);
+		needReloadInstancesBuffers = true;
+	}
+
+	void Renderer::setModelOccluder(unsigned int modelIdx, bool isOccluder) {
+		drawListBuilder->setModelOccluder(modelIdx, modelDescsBuffer[modelIdx], isOccluder);
 	}
 
 	void Renderer::changeModelInstanceColorsArr(unsigned int modelIdx, unsigned int instanceIdx, unsigned int meshIdx, unsigned int colorsArrIdx) {		
+		if (modelIdx < staticModelsNr)
+			selectedVerticesColorsIdxsShadow[instancesRanges->getBaseIdx(modelIdx) + instanceIdx] = verticesColorsBaseIdxs[modelIdx][meshIdx][colorsArrIdx];
+		// uploaded out of the shadow along with the resized buffer
+		if (needReloadInstancesBuffers)
+			return;
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, selectedVerticesColorsIdxsBuffer);
-		glBufferSubData(GL_SHADER_STORAGE_BUFFER, (instancesBaseIdxsPerModel[modelIdx] + instanceIdx) * sizeof(unsigned int), sizeof(unsigned int), &(verticesColorsBaseIdxs[modelIdx][meshIdx][colorsArrIdx]));	
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, (instancesRanges->getBaseIdx(modelIdx) + instanceIdx) * sizeof(unsigned int), sizeof(unsigned int), &(verticesColorsBaseIdxs[modelIdx][meshIdx][colorsArrIdx]));	
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 	}
 
@@ -536,354 +444,242 @@ namespace Corium3D {
 	}
 
 	bool Renderer::render(double lag) {	
+		PROFILE_ZONE("Renderer::render");
+		bool isDebugGeometryOnFrame = isDebugGeometryOn.load(std::memory_order_relaxed);
+		if (needReloadInstancesBuffers && !loadInstancesBuffers())
+			return false;
+		uploadDirtyStaticTransformats();
+		ViewFrustum mainViewFrustum = getViewFrustum();
+		drawListBuilder->build(&mainViewFrustum, 1, *bvh, staticTransformatsShadow.data(), isDebugGeometryOnFrame);
+
+		waitForFrameRingRegion();
+		frameRing->beginFrame();
+		writeFrameInstancesData();
+
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		
-		//DEBUG RENDERING
-		glUseProgram(debugProg);
-		CHECK_GL_ERROR("glUseProgram");
-		glBindVertexArray(debugVAO);
-		CHECK_GL_ERROR("glBindVertexArray");
-		glBindBuffer(GL_ARRAY_BUFFER, debugVertexBuffer);	
-		CHECK_GL_ERROR("glBindBuffer");	
-		glUniformMatrix4fv(debugVpMatUniformLoc, 1, GL_FALSE, (float*)&(vpMat));
-		CHECK_GL_ERROR("glUniformMatrix4fv");
-		glm::vec3 debugBuffer3D[100];
-		glm::vec2 debugBuffer2D[100];
-		std::string visibles("");
-		visibleNodesIt3D->init(bvh->getStaticNodes3DRoot());		
-		while (!visibleNodesIt3D->isDone()) {
-			// register leaf's model instance
-			BVH::DataNode3D* node = static_cast<BVH::DataNode3D*>(visibleNodesIt3D->getNext());
-			visibles += std::string("(") + std::string(std::to_string(node->getModelIdx())) + std::string(", ") + std::string(std::to_string(node->getInstanceIdx())) + std::string(")");
-			unsigned int modelIdx = node->getModelIdx();
-			unsigned int instanceIdx = node->getInstanceIdx();		
-			InstanceAnimator* instanceAnimator = instancesAnimators[modelIdx][instanceIdx];
-			if (instanceAnimator)
-				instanceAnimator->updateRendererBuffer();
-			visibleStaticModelsInstancesIdxs[modelIdx][visibleStaticModelsInstancesNrs[modelIdx]++] = instanceIdx;
-		
+		if (isDebugGeometryOnFrame)
+			renderDebugGeometry();
 
-			AABB3D const& aabb = node->getAABB();
-			glm::vec3 cubeMin = aabb.getMinVertex();
-			glm::vec3 cubeMax = aabb.getMaxVertex();
-			debugBuffer3D[0] = cubeMin;							  debugBuffer3D[1] = { cubeMax.x, cubeMin.y, cubeMin.z };
-			debugBuffer3D[2] = { cubeMax.x, cubeMax.y, cubeMin.z }; debugBuffer3D[3] = { cubeMin.x, cubeMax.y, cubeMin.z };
-			debugBuffer3D[4] = { cubeMin.x, cubeMin.y, cubeMax.z }; debugBuffer3D[5] = { cubeMax.x, cubeMin.y, cubeMax.z };
-			debugBuffer3D[6] = cubeMax;							  debugBuffer3D[7] = { cubeMin.x, cubeMax.y, cubeMax.z };
-			glBufferSubData(GL_ARRAY_BUFFER, 0, 8 * sizeof(glm::vec3), (void*)debugBuffer3D);
-			CHECK_GL_ERROR("glBufferSubData");
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, debugIndicesBuffer);
-			CHECK_GL_ERROR("glBindBuffer");
-			glDrawElements(GL_LINES, 24, GL_UNSIGNED_INT, (void*)0);
-			CHECK_GL_ERROR("glDrawElements");
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-			if (node->collisionData3D && node->collisionData3D->contactManifold.pointsNr > 0) {
-				CollisionVolume::ContactManifold& contactManifold = node->collisionData3D->contactManifold;
-				if (contactManifold.pointsNr == 1) {
-					debugBuffer3D[0] = contactManifold.points[0];
-					glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::vec3), (void*)debugBuffer3D);
-					CHECK_GL_ERROR("glBufferSubData");
-					glDrawArrays(GL_POINTS, 0, 1);
-					CHECK_GL_ERROR("glDrawArrays");
-				}
-				else {
-					//unsigned int pointsNr = min(contactManifold.pointsNr, 4u);
-					unsigned int pointsNr = contactManifold.pointsNr;
-					for (unsigned int pIdx = 0; pIdx < pointsNr - 1; pIdx++) {
-						debugBuffer3D[2 * pIdx] = contactManifold.points[pIdx];
-						debugBuffer3D[2 * pIdx + 1] = contactManifold.points[pIdx + 1];
-					}
-					debugBuffer3D[2 * pointsNr - 2] = debugBuffer3D[2 * pointsNr - 3];
-					debugBuffer3D[2 * pointsNr - 1] = debugBuffer3D[0];
-					glBufferSubData(GL_ARRAY_BUFFER, 0, 2 * pointsNr * sizeof(glm::vec3), (void*)debugBuffer3D);
-					CHECK_GL_ERROR("glBufferSubData");
-					glDrawArrays(GL_LINES, 0, 2 * contactManifold.pointsNr);
-					CHECK_GL_ERROR("glDrawArrays");
-
-					vec3 centroid;
-					for (unsigned int pIdx = 0; pIdx < pointsNr; pIdx++)
-						centroid += contactManifold.points[pIdx];
-					centroid /= pointsNr;
-					debugBuffer3D[0] = centroid;
-					debugBuffer3D[1] = centroid + contactManifold.normal;
-					glBufferSubData(GL_ARRAY_BUFFER, 0, 2 * sizeof(glm::vec3), (void*)debugBuffer3D);
-					CHECK_GL_ERROR("glBufferSubData");
-					glDrawArrays(GL_LINES, 0, 2);
-					CHECK_GL_ERROR("glDrawArrays");
-				}
-			}
-			if (node->collisionData2D && node->collisionData2D->contactManifold.pointsNr > 0) {
-				CollisionPerimeter::ContactManifold& contactManifold = node->collisionData2D->contactManifold;
-				if (contactManifold.pointsNr == 1) {
-					debugBuffer2D[0] = contactManifold.points[0];
-					glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::vec2), (void*)debugBuffer2D);
-					CHECK_GL_ERROR("glBufferSubData");
-					glDrawArrays(GL_POINTS, 0, 1);
-					CHECK_GL_ERROR("glDrawArrays");
-				}
-				else {
-					//unsigned int pointsNr = min(contactManifold.pointsNr, 4u);
-					unsigned int pointsNr = contactManifold.pointsNr;
-					for (unsigned int pIdx = 0; pIdx < pointsNr - 1; pIdx++) {
-						debugBuffer2D[2 * pIdx] = contactManifold.points[pIdx];
-						debugBuffer2D[2 * pIdx + 1] = contactManifold.points[pIdx + 1];
-					}
-					debugBuffer2D[2 * pointsNr - 2] = debugBuffer2D[2 * pointsNr - 3];
-					debugBuffer2D[2 * pointsNr - 1] = debugBuffer2D[0];
-					glBufferSubData(GL_ARRAY_BUFFER, 0, 2 * pointsNr * sizeof(glm::vec2), (void*)debugBuffer2D);
-					CHECK_GL_ERROR("glBufferSubData");
-					glDrawArrays(GL_LINES, 0, 2 * contactManifold.pointsNr);
-					CHECK_GL_ERROR("glDrawArrays");
-
-					vec2 centroid;
-					for (unsigned int pIdx = 0; pIdx < pointsNr; pIdx++)
-						centroid += contactManifold.points[pIdx];
-					centroid /= pointsNr;
-					debugBuffer2D[0] = centroid;
-					debugBuffer2D[1] = centroid + contactManifold.normal;
-					glBufferSubData(GL_ARRAY_BUFFER, 0, 2 * sizeof(glm::vec2), (void*)debugBuffer2D);
-					CHECK_GL_ERROR("glBufferSubData");
-					glDrawArrays(GL_LINES, 0, 2);
-					CHECK_GL_ERROR("glDrawArrays");
-				}
-			}
-		}		
+		if (!submitFrameDraws())
+			return false;
+		// the frame's region is written again once the GPU is done reading it
+		frameRingFences[frameRing->getRegionIdx()] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		CHECK_GL_ERROR("glFenceSync");
+		frameRing->endFrame();
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);	
+		glBindVertexArray(0);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glUseProgram(0);
+			
+		if (++framesCount == framesNrForFpsUpdate) {
+			double currRenderTime = ServiceLocator::getTimer().getCurrentTime();
+			fpsDisplay.setTxt( (unsigned int)(framesNrForFpsUpdate / (currRenderTime - prevRenderTime)) );
+			prevRenderTime = currRenderTime;
+			framesCount = 0;
+#if DEBUG
+			DrawListBuilder::Stats const& drawListStats = drawListBuilder->getStats(MAIN_VIEW_IDX);
+			LOGD("Renderer", "triangles per frame: %u (%u in full detail), visible instances per level of detail: %u/%u/%u/%u.",
+				drawListStats.trianglesNr, drawListStats.fullDetailTrianglesNr, drawListStats.lodsVisibleInstancesNrs[0], drawListStats.lodsVisibleInstancesNrs[1],
+				drawListStats.lodsVisibleInstancesNrs[2], drawListStats.lodsVisibleInstancesNrs[3]);
+			LOGD("Renderer", "occluders: %u (%u triangles), occluded nodes: %u.", drawListStats.occludersNr, drawListStats.occludersTrianglesNr, drawListStats.occludedNodesNr);
+			LOGD("Renderer", "draws: %u, state changes: %u.", drawListStats.drawsNr, drawListStats.stateChangesNr);
+#endif
+		}	
+		//gui.render();
 
-		
-		visibleNodesIt3D->init(bvh->getMobileNodes3DRoot());
-		while (!visibleNodesIt3D->isDone()) {
-			// register leaf's model instance
-			BVH::MobileGameLmntDataNode3D* node = static_cast<BVH::MobileGameLmntDataNode3D*>(visibleNodesIt3D->getNext());
-			visibles += std::string("(") + std::string(std::to_string(node->getModelIdx())) + std::string(", ") + std::string(std::to_string(node->getInstanceIdx())) + std::string(")");
-			unsigned int mobileModelIdx = node->getModelIdx() - staticModelsNr;		
-			InstanceAnimator* instanceAnimator = instancesAnimators[node->getModelIdx()][node->getInstanceIdx()];
-			if (instanceAnimator) {
-				instanceAnimator->updateRendererBuffer();
-				CHECK_GL_ERROR("updateRendererBuffer");
-			}
-			visibleMobileModelsInstancesIdxs[mobileModelIdx][visibleMobileModelsInstancesNrs[mobileModelIdx]] = node->getInstanceIdx();	
-			mobileModelsTransformatsBuffers[mobileModelIdx][visibleMobileModelsInstancesNrs[mobileModelIdx]] = node->getMobilityInterface().getTransformat();
-			visibleMobileModelsInstancesNrs[mobileModelIdx]++;
-		
-			const AABB3D aabb = node->getAABB();
-			glm::vec3 cubeMin = aabb.getMinVertex();
-			glm::vec3 cubeMax = aabb.getMaxVertex();
-			debugBuffer3D[0] = cubeMin;							   debugBuffer3D[1] = { cubeMax.x, cubeMin.y, cubeMin.z };
-			debugBuffer3D[2] = { cubeMax.x, cubeMax.y, cubeMin.z }; debugBuffer3D[3] = { cubeMin.x, cubeMax.y, cubeMin.z };
-			debugBuffer3D[4] = { cubeMin.x, cubeMin.y, cubeMax.z }; debugBuffer3D[5] = { cubeMax.x, cubeMin.y, cubeMax.z };
-			debugBuffer3D[6] = cubeMax;							   debugBuffer3D[7] = { cubeMin.x, cubeMax.y, cubeMax.z };
-			glBufferSubData(GL_ARRAY_BUFFER, 0, 8 * sizeof(glm::vec3), (void*)debugBuffer3D);
-			CHECK_GL_ERROR("glBufferSubData");
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, debugIndicesBuffer);
-			CHECK_GL_ERROR("glBindBuffer");
-			glDrawElements(GL_LINES, 24, GL_UNSIGNED_INT, (void*)0);
-			CHECK_GL_ERROR("glDrawElements");
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-			CHECK_GL_ERROR("glBindBuffer");
-			if (node->collisionData3D && node->collisionData3D->contactManifold.pointsNr > 0) {
-				CollisionVolume::ContactManifold& contactManifold = node->collisionData3D->contactManifold;
-				if (contactManifold.pointsNr == 1) {				
-					debugBuffer3D[0] = contactManifold.points[0];
-					//debugBuffer3D[1] = contactManifold.points[1];
-					//debugBuffer3D[2] = contactManifold.points[2];
-					//debugBuffer3D[3] = contactManifold.points[3];
-					//debugBuffer3D[4] = contactManifold.points[4];
-					glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::vec3), (void*)debugBuffer3D);
-					CHECK_GL_ERROR("glBufferSubData");
-					glDrawArrays(GL_POINTS, 0, 1);
-					CHECK_GL_ERROR("glDrawArrays");
-					debugBuffer3D[1] = debugBuffer3D[0] + contactManifold.normal;
-					glBufferSubData(GL_ARRAY_BUFFER, 0, 2*sizeof(glm::vec3), (void*)debugBuffer3D);
-					CHECK_GL_ERROR("glBufferSubData");
-					glDrawArrays(GL_LINES, 0, 2);
-					CHECK_GL_ERROR("glDrawArrays");
-				}
-				else if (contactManifold.pointsNr > 1) {
-					//unsigned int pointsNr = min(contactManifold.pointsNr, 4u);
-					unsigned int pointsNr = contactManifold.pointsNr;
-					for (unsigned int pIdx = 0; pIdx < pointsNr - 1; pIdx++) {
-						debugBuffer3D[2 * pIdx] = contactManifold.points[pIdx];
-						debugBuffer3D[2 * pIdx + 1] = contactManifold.points[pIdx + 1];
-					}
-					debugBuffer3D[2 * pointsNr - 2] = debugBuffer3D[2 * pointsNr - 3];
-					debugBuffer3D[2 * pointsNr - 1] = debugBuffer3D[0];
-					glBufferSubData(GL_ARRAY_BUFFER, 0, 2 * pointsNr * sizeof(glm::vec3), (void*)debugBuffer3D);
-					CHECK_GL_ERROR("glBufferSubData");
-					glDrawArrays(GL_LINES, 0, 2 * pointsNr);
-					CHECK_GL_ERROR("glDrawArrays");
-
-					vec3 centroid;
-					for (unsigned int pIdx = 0; pIdx < pointsNr; pIdx++)
-						centroid += contactManifold.points[pIdx];
-					centroid /= pointsNr;
-					debugBuffer3D[0] = centroid;
-					debugBuffer3D[1] = centroid + contactManifold.normal;
-					glBufferSubData(GL_ARRAY_BUFFER, 0, 2 * sizeof(glm::vec3), (void*)debugBuffer3D);
-					CHECK_GL_ERROR("glBufferSubData");
-					glDrawArrays(GL_LINES, 0, 2);
-					CHECK_GL_ERROR("glDrawArrays");
-				}
-			}		
+		PROFILE_ZONE("Renderer::swapBuffers");
+		return openGlContext->swapBuffers();    
+	}
+
+	void Renderer::waitForFrameRingRegion() {
+		unsigned int regionIdx = frameRing->getNextRegionIdx();
+		if (!frameRing->isRegionInFlight(regionIdx))
+			return;
+
+		PROFILE_ZONE("Renderer::waitForFrameRingRegion");
+		// a frame that was cut short by an error has no fence
+		if (GLsync& fence = frameRingFences[regionIdx]) {
+			GLenum waitResult = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+			while (waitResult == GL_TIMEOUT_EXPIRED)
+				waitResult = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FRAME_RING_FENCE_WAIT_TIMEOUT);
+			if (waitResult == GL_WAIT_FAILED)
+				LOGE("Renderer", "glClientWaitSync failed on frame ring region %u.", regionIdx);
+			glDeleteSync(fence);
+			fence = NULL;
 		}
-		//visiblesDisplay.setTxt(visibles);
+		frameRing->retireRegion(regionIdx);
+	}
 
-		glBindBuffer(GL_ARRAY_BUFFER, debugVertexBuffer);
-		nodesIt2D->init(bvh->getMobileNodes2DRoot());
-		while (!nodesIt2D->isDone()) {		
-			BVH::MobileGameLmntDataNode2D* node = static_cast<BVH::MobileGameLmntDataNode2D*>(nodesIt2D->getNext());		
-			if (node->collisionData2D && node->collisionData2D->contactManifold.pointsNr > 0) {
-				CollisionPerimeter::ContactManifold& contactManifold = node->collisionData2D->contactManifold;
-				if (contactManifold.pointsNr == 1) {
-					debugBuffer3D[0] = { contactManifold.points[0], -7.0f };
-					//debugBuffer3D[1] = contactManifold.points[1];
-					//debugBuffer3D[2] = contactManifold.points[2];
-					//debugBuffer3D[3] = contactManifold.points[3];
-					//debugBuffer3D[4] = contactManifold.points[4];
-					glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::vec3), (void*)debugBuffer3D);
-					CHECK_GL_ERROR("glBufferSubData");
-					glDrawArrays(GL_POINTS, 0, 1);
-					CHECK_GL_ERROR("glDrawArrays");
-					debugBuffer3D[1] = debugBuffer3D[0] + glm::vec3(contactManifold.normal, 0.0f);
-					glBufferSubData(GL_ARRAY_BUFFER, 0, 2 * sizeof(glm::vec3), (void*)debugBuffer3D);
-					CHECK_GL_ERROR("glBufferSubData");
-					glDrawArrays(GL_LINES, 0, 2);
-					CHECK_GL_ERROR("glDrawArrays");
-				}
-				else if (contactManifold.pointsNr > 1) {
-					//unsigned int pointsNr = min(contactManifold.pointsNr, 4u);
-					unsigned int pointsNr = contactManifold.pointsNr;
-					for (unsigned int pIdx = 0; pIdx < pointsNr - 1; pIdx++) {
-						debugBuffer3D[2 * pIdx] = { contactManifold.points[pIdx].x, contactManifold.points[pIdx].y, -7.0f };
-						debugBuffer3D[2 * pIdx + 1] = { contactManifold.points[pIdx + 1].x, contactManifold.points[pIdx + 1].y, -7.0f };
-					}
-					debugBuffer3D[2 * pointsNr - 2] = debugBuffer3D[2 * pointsNr - 3];
-					debugBuffer3D[2 * pointsNr - 1] = debugBuffer3D[0];
-					glBufferSubData(GL_ARRAY_BUFFER, 0, 2 * pointsNr * sizeof(glm::vec3), (void*)debugBuffer3D);
-					CHECK_GL_ERROR("glBufferSubData");
-					glDrawArrays(GL_LINES, 0, 2 * pointsNr);
-					CHECK_GL_ERROR("glDrawArrays");
-
-					vec3 centroid;
-					for (unsigned int pIdx = 0; pIdx < pointsNr; pIdx++)
-						centroid += glm::vec3(contactManifold.points[pIdx], -7.0f);
-					centroid /= pointsNr;
-					debugBuffer3D[0] = centroid;
-					debugBuffer3D[1] = centroid + glm::vec3(contactManifold.normal, 0.0f);
-					glBufferSubData(GL_ARRAY_BUFFER, 0, 2 * sizeof(glm::vec3), (void*)debugBuffer3D);
-					CHECK_GL_ERROR("glBufferSubData");
-					glDrawArrays(GL_LINES, 0, 2);
-					CHECK_GL_ERROR("glDrawArrays");
-				}
+	// the visible instances' data is written in place into the frame's region - no maps, no uploads. static instances'
+	// transformats are kept in mvpMatsBuffer - only their indices are written. mobile ones' are written along. the bones
+	// palettes of all of the models' visible animated instances share a single allocation, and their poses are evaluated
+	// straight into it at once, in parallel. the frame's matrices are all addressed from the region's start, so a single
+	// binding serves all of the frame's draws
+	void Renderer::writeFrameInstancesData() {
+		PROFILE_ZONE("Renderer::writeFrameInstancesData");
+		size_t regionOffset = frameRing->getRegionOffset();
+		// the instances that are not animated share an identity palette (the bind pose) at the palettes' allocation's start
+		unsigned int restPaletteBonesNr = 0;
+		unsigned int palettesBonesNr = 0;
+		for (unsigned int modelIdx = 0; modelIdx < modelsNrTotal; modelIdx++) {
+			unsigned int bonesNr = modelDescsBuffer[modelIdx].bonesNr;
+			unsigned int visibleInstancesNr = drawListBuilder->getVisibleInstancesNr(MAIN_VIEW_IDX, modelIdx);
+			if (bonesNr == 0 || visibleInstancesNr == 0)
+				continue;
+
+			unsigned int const* visibleInstancesIdxs = drawListBuilder->getVisibleInstancesIdxs(MAIN_VIEW_IDX, modelIdx);
+			unsigned int animatedInstancesNr = 0;
+			for (unsigned int visibleInstanceIdxIdx = 0; visibleInstanceIdxIdx < visibleInstancesNr; visibleInstanceIdxIdx++) {
+				if (instancesAnimators[modelIdx][visibleInstancesIdxs[visibleInstanceIdxIdx]])
+					animatedInstancesNr++;
 			}
+			palettesBonesNr += animatedInstancesNr * bonesNr;
+			if (animatedInstancesNr < visibleInstancesNr)
+				restPaletteBonesNr = std::max(restPaletteBonesNr, bonesNr);
 		}
-			
-		//STATIC MODELS RENDERING
-		unsigned int processedVerticesNr = 0;
-		unsigned int processedIndicesNr = 0;
-		for (unsigned int modelIdx = 0; modelIdx < staticModelsNr; modelIdx++) {		
-			glBindVertexArray(vaos[modelDescsBuffer[modelIdx].progIdx]);
-			glUseProgram(progs[modelDescsBuffer[modelIdx].progIdx]);				
-			//TODO: upload to relevent shaders only on vpMat updates (will involve getting a vpMatAttribLoc for each shader)
-			glUniformMatrix4fv(vpMatAttribLoc, 1, GL_FALSE, (float*)&(vpMat));
-			CHECK_GL_ERROR("glUniformMatrix4fv");
+		glm::mat4* bonesTransformsPtr = NULL;
+		unsigned int bonesTransformsBaseIdx = 0;
+		if (restPaletteBonesNr + palettesBonesNr) {
+			size_t bonesTransformsOffset = frameRing->allocate(sizeof(glm::mat4) * (restPaletteBonesNr + palettesBonesNr), sizeof(glm::mat4));
+			if (bonesTransformsOffset != Corium3DUtils::FrameRing::ALLOCATION_FAILED) {
+				bonesTransformsPtr = (glm::mat4*)(frameRingBufferPtr + bonesTransformsOffset);
+				bonesTransformsBaseIdx = (bonesTransformsOffset - regionOffset) / sizeof(glm::mat4);
+				std::fill(bonesTransformsPtr, bonesTransformsPtr + restPaletteBonesNr, glm::mat4(1.0f));
+			}
+		}
+		unsigned int processedBonesTransformsNr = restPaletteBonesNr;
+		framePoses.clear();
+		double currTime = ServiceLocator::getTimer().getCurrentTime();
 
-			unsigned int visibleInstancesNr = visibleStaticModelsInstancesNrs[modelIdx];
-			visibleStaticModelsInstancesNrs[modelIdx] = 0;
-			if (visibleInstancesNr) {											
-				glBindBuffer(GL_ARRAY_BUFFER, instanceDataIdxsBuffer);
-				unsigned int* instanceDataIdxsBufferPtr = (unsigned int*)glMapBufferRange(GL_ARRAY_BUFFER, 0, sizeof(unsigned int) * visibleInstancesNr, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
-				CHECK_GL_ERROR("glMapBufferRange");				
+		for (unsigned int modelIdx = 0; modelIdx < modelsNrTotal; modelIdx++) {
+			frameModelsBaseInstances[modelIdx] = IndirectCommandsGenerator::NO_BASE_INSTANCE;
+			unsigned int visibleInstancesNr = drawListBuilder->getVisibleInstancesNr(MAIN_VIEW_IDX, modelIdx);
+			if (visibleInstancesNr == 0)
+				continue;
+			unsigned int bonesNr = modelDescsBuffer[modelIdx].bonesNr;
+			// the palettes' allocation failed
+			if (bonesNr && !bonesTransformsPtr)
+				continue;
+
+			// the region is sized for the worst case in createFrameRing - a failed allocation leaves the model undrawn
+			unsigned int const* visibleInstancesIdxs = drawListBuilder->getVisibleInstancesIdxs(MAIN_VIEW_IDX, modelIdx);
+			size_t recordsOffset = frameRing->allocate(sizeof(InstanceDataRecord) * visibleInstancesNr, sizeof(InstanceDataRecord));
+			if (recordsOffset == Corium3DUtils::FrameRing::ALLOCATION_FAILED)
+				continue;
+			InstanceDataRecord* recordsPtr = (InstanceDataRecord*)(frameRingBufferPtr + recordsOffset);
+			if (modelIdx < staticModelsNr) {
 				for (unsigned int visibleInstanceIdxIdx = 0; visibleInstanceIdxIdx < visibleInstancesNr; visibleInstanceIdxIdx++)
-					instanceDataIdxsBufferPtr[visibleInstanceIdxIdx] = visibleStaticModelsInstancesIdxs[modelIdx][visibleInstanceIdxIdx] + instancesBaseIdxsPerModel[modelIdx];
-				glUnmapBuffer(GL_ARRAY_BUFFER);
-				
-				// REMINDER: doesnt work in opengl es 3
-				for (unsigned int meshIdx = 0; meshIdx < modelDescsBuffer[modelIdx].meshesNr; meshIdx++) {										
-					glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indicesBuffer);
-					glDrawElementsInstancedBaseVertex(GL_TRIANGLES, 3 * modelDescsBuffer[modelIdx].facesNrsPerMesh[meshIdx], GL_UNSIGNED_INT,
-						(GLvoid*)(processedIndicesNr * sizeof(unsigned int)), visibleInstancesNr, processedVerticesNr);
-					
-					CHECK_GL_ERROR("glDrawElementsInstancedBaseVertex");
-					processedVerticesNr += modelDescsBuffer[modelIdx].verticesNrsPerMesh[meshIdx];
-					processedIndicesNr += 3 * modelDescsBuffer[modelIdx].facesNrsPerMesh[meshIdx];
+					recordsPtr[visibleInstanceIdxIdx].transformatIdx = visibleInstancesIdxs[visibleInstanceIdxIdx] + instancesRanges->getBaseIdx(modelIdx);
+			}
+			else {
+				size_t transformatsOffset = frameRing->allocate(sizeof(glm::mat4) * visibleInstancesNr, sizeof(glm::mat4));
+				if (transformatsOffset == Corium3DUtils::FrameRing::ALLOCATION_FAILED)
+					continue;
+				memcpy(frameRingBufferPtr + transformatsOffset, drawListBuilder->getVisibleInstancesTransformats(MAIN_VIEW_IDX, modelIdx), sizeof(glm::mat4) * visibleInstancesNr);
+				unsigned int transformatsBaseIdx = (transformatsOffset - regionOffset) / sizeof(glm::mat4);
+				for (unsigned int visibleInstanceIdxIdx = 0; visibleInstanceIdxIdx < visibleInstancesNr; visibleInstanceIdxIdx++)
+					recordsPtr[visibleInstanceIdxIdx].transformatIdx = FRAME_TRANSFORMAT_FLAG | (transformatsBaseIdx + visibleInstanceIdxIdx);
+			}
+
+			if (bonesNr) {
+				for (unsigned int visibleInstanceIdxIdx = 0; visibleInstanceIdxIdx < visibleInstancesNr; visibleInstanceIdxIdx++) {
+					if (InstanceAnimator* instanceAnimator = instancesAnimators[modelIdx][visibleInstancesIdxs[visibleInstanceIdxIdx]]) {
+						framePoses.push_back(instanceAnimator->genPose(currTime, bonesTransformsPtr + processedBonesTransformsNr));
+						recordsPtr[visibleInstanceIdxIdx].bonesTransformsBaseIdx = bonesTransformsBaseIdx + processedBonesTransformsNr;
+						processedBonesTransformsNr += bonesNr;
+					}
+					else
+						recordsPtr[visibleInstanceIdxIdx].bonesTransformsBaseIdx = bonesTransformsBaseIdx;
 				}
 			}
 			else {
-				processedVerticesNr += modelDescsBuffer[modelIdx].verticesNr;
-				processedIndicesNr += 3 * modelDescsBuffer[modelIdx].facesNr;
-			}	
+				for (unsigned int visibleInstanceIdxIdx = 0; visibleInstanceIdxIdx < visibleInstancesNr; visibleInstanceIdxIdx++)
+					recordsPtr[visibleInstanceIdxIdx].bonesTransformsBaseIdx = 0;
+			}
+
+			frameModelsBaseInstances[modelIdx] = recordsOffset / sizeof(InstanceDataRecord);
 		}
-	
-		//MOBILE MODELS RENDERING
-		unsigned int modelIdxOverall = staticModelsNr;
-		for (unsigned int mobileModelIdx = 0; mobileModelIdx < mobileModelsNr; mobileModelIdx++) {		
-			glBindVertexArray(vaos[modelDescsBuffer[modelIdxOverall].progIdx]);
-			glUseProgram(progs[modelDescsBuffer[modelIdxOverall].progIdx]);		
+
+		posesEvaluator->evalPoses(framePoses.data(), framePoses.size());
+	}
+
+	// the draw list's (model, mesh) draws as indirect commands in the frame's region - a multi draw per program
+	bool Renderer::submitFrameDraws() {
+		PROFILE_ZONE("Renderer::submitFrameDraws");
+		std::vector<DrawListBuilder::Draw> const& drawList = drawListBuilder->getDrawList(MAIN_VIEW_IDX);
+		if (drawList.empty())
+			return true;
+		size_t commandsOffset = frameRing->allocate(sizeof(IndirectCommandsGenerator::Command) * drawList.size(), sizeof(unsigned int));
+		if (commandsOffset == Corium3DUtils::FrameRing::ALLOCATION_FAILED)
+			return true;
+		indirectCommandsGenerator.generate(drawList, frameModelsBaseInstances.data(), (IndirectCommandsGenerator::Command*)(frameRingBufferPtr + commandsOffset));
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, mvpMatsBuffer);
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 6, frameRingBuffer, frameRing->getRegionOffset(), frameRing->getRegionSz());
+		CHECK_GL_ERROR("glBindBufferRange");
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, frameRingBuffer);
+		for (IndirectCommandsGenerator::CommandsGroup const& group : indirectCommandsGenerator.getGroups()) {
+			glBindVertexArray(vaos[group.progIdx]);
+			glUseProgram(progs[group.progIdx]);
 			//TODO: upload to relevent shaders only on vpMat updates (will involve getting a vpMatAttribLoc for each shader)
 			glUniformMatrix4fv(vpMatAttribLoc, 1, GL_FALSE, (float*)&(vpMat));
 			CHECK_GL_ERROR("glUniformMatrix4fv");
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indicesBuffer);
+			// REMINDER: doesnt work in opengl es 3
+			// the instances' records are sourced from the frame ring through each command's base instance
+			glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (GLvoid*)(commandsOffset + group.firstCommandIdx * sizeof(IndirectCommandsGenerator::Command)), group.commandsNr, 0);
+			CHECK_GL_ERROR("glMultiDrawElementsIndirect");
+		}
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 
-			unsigned int visibleInstancesNr = visibleMobileModelsInstancesNrs[mobileModelIdx];
-			visibleMobileModelsInstancesNrs[mobileModelIdx] = 0;
-			if (visibleInstancesNr) {							
-				glBindBuffer(GL_ARRAY_BUFFER, instanceDataIdxsBuffer);
-				unsigned int* instanceDataIdxsBufferPtr = (unsigned int*)glMapBufferRange(GL_ARRAY_BUFFER, 0, sizeof(unsigned int) * visibleInstancesNr, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
-				CHECK_GL_ERROR("glMapBufferRange");
-				glBindBuffer(GL_SHADER_STORAGE_BUFFER, mvpMatsBuffer);
-				glm::mat4* mvpMatsBufferPtr = (glm::mat4*)glMapBufferRange(GL_SHADER_STORAGE_BUFFER, sizeof(glm::mat4) * staticInstancesNrMax, sizeof(glm::mat4) * modelsInstancesNrsMaxima[modelIdxOverall], GL_MAP_WRITE_BIT);
-				CHECK_GL_ERROR("glMapBufferRange");
-				for (unsigned int visibleInstanceIdxIdx = 0; visibleInstanceIdxIdx < visibleInstancesNr; visibleInstanceIdxIdx++) {	
-					unsigned int modelInstanceIdx = visibleMobileModelsInstancesIdxs[mobileModelIdx][visibleInstanceIdxIdx];
-					instanceDataIdxsBufferPtr[visibleInstanceIdxIdx] = staticInstancesNrMax + modelInstanceIdx;
-					mvpMatsBufferPtr[modelInstanceIdx] = mobileModelsTransformatsBuffers[mobileModelIdx][visibleInstanceIdxIdx];
-				}
-				glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-				CHECK_GL_ERROR("glUnmapBuffer");
-				glUnmapBuffer(GL_ARRAY_BUFFER);
-				CHECK_GL_ERROR("glUnmapBuffer");				
-
-				//glBindBuffer(GL_SHADER_STORAGE_BUFFER, bonesTransformsBuffers[descIdx]);
-				//glm::mat4* bonesTransformsPtr = (glm::mat4*)glMapBufferRange(GL_SHADER_STORAGE_BUFFER, sizeof(glm::mat4) * instancesBaseIdxsPerDescPerModel[descIdx][modelIdx], sizeof(glm::mat4) * modelsDescsBuffer[descIdx].bonesNrs[modelIdx] * modelsDescsBuffer[descIdx].instancesNrsMaxima[modelIdx], GL_MAP_WRITE_BIT);
-				//CHECK_GL_ERROR("glMapBufferRange");
-				//for (unsigned int visibleInstanceIdxIdx = 0; visibleInstanceIdxIdx < visibleInstancesNr; visibleInstanceIdxIdx++)
-				//	bonesTransformsPtr[instanceDataIdxsBufferPtr[visibleInstanceIdxIdx]] = identity;
-				//glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-				//CHECK_GL_ERROR("glUnmapBuffer");
-
-				for (unsigned int meshIdx = 0; meshIdx < modelDescsBuffer[modelIdxOverall].meshesNr; meshIdx++) {
-					//glUniformMatrix4fv(meshTransformUniformLoc, 1, GL_FALSE, (float*)&(meshesTransformsBuffer[meshIdx]));					
-					//CHECK_GL_ERROR("glUniformMatrix4fv");
-					//glUniform1ui(baseVertexUniformLoc, processedVerticesNr);
-					glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indicesBuffer);
-					glDrawElementsInstancedBaseVertex(GL_TRIANGLES, 3 * modelDescsBuffer[modelIdxOverall].facesNrsPerMesh[meshIdx], GL_UNSIGNED_INT,
-						(GLvoid*)(processedIndicesNr * sizeof(unsigned int)), visibleInstancesNr, processedVerticesNr);
-					CHECK_GL_ERROR("glDrawElementsInstancedBaseVertex");	
-					processedVerticesNr += modelDescsBuffer[modelIdxOverall].verticesNrsPerMesh[meshIdx];
-					processedIndicesNr += 3 * modelDescsBuffer[modelIdxOverall].facesNrsPerMesh[meshIdx];
-				}
-			}
-			else {
-				processedVerticesNr += modelDescsBuffer[modelIdxOverall].verticesNr;
-				processedIndicesNr += 3 * modelDescsBuffer[modelIdxOverall].facesNr;
-			}
+		return true;
+	}
 
-			modelIdxOverall++;		
+	void Renderer::uploadDirtyStaticTransformats() {
+		if (!staticTransformatsDirtyRanges.isDirty())
+			return;
+
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, mvpMatsBuffer);
+		for (Corium3DUtils::DirtyRanges::Range const& range : staticTransformatsDirtyRanges.coalesce()) {
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, range.firstIdx * sizeof(glm::mat4), range.elementsNr * sizeof(glm::mat4), &staticTransformatsShadow[range.firstIdx]);
+			CHECK_GL_ERROR("glBufferSubData");
 		}
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);	
-		glBindVertexArray(0);
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glUseProgram(0);
-			
-		if (++framesCount == framesNrForFpsUpdate) {
-			double currRenderTime = ServiceLocator::getTimer().getCurrentTime();
-			fpsDisplay.setTxt( (unsigned int)(framesNrForFpsUpdate / (currRenderTime - prevRenderTime)) );
-			prevRenderTime = currRenderTime;
-			framesCount = 0;
-		}	
-		//gui.render();
+	}
 
-		return openGlContext->swapBuffers();    
+	// all of the frame's debug geometry in a single upload - lines first, points past them
+	void Renderer::renderDebugGeometry() {
+		std::vector<glm::vec3> const& linesVertices = drawListBuilder->getDebugLinesVertices();
+		std::vector<glm::vec3> const& pointsVertices = drawListBuilder->getDebugPointsVertices();
+		unsigned int linesVerticesNr = linesVertices.size();
+		unsigned int pointsVerticesNr = pointsVertices.size();
+		if (linesVerticesNr + pointsVerticesNr == 0)
+			return;
+
+		glUseProgram(debugProg);
+		CHECK_GL_ERROR("glUseProgram");
+		glBindVertexArray(debugVAO);
+		CHECK_GL_ERROR("glBindVertexArray");
+		glBindBuffer(GL_ARRAY_BUFFER, debugVertexBuffer);
+		CHECK_GL_ERROR("glBindBuffer");
+		glUniformMatrix4fv(debugVpMatUniformLoc, 1, GL_FALSE, (float*)&(vpMat));
+		CHECK_GL_ERROR("glUniformMatrix4fv");
+		if (linesVerticesNr + pointsVerticesNr > debugVerticesCapacity) {
+			debugVerticesCapacity = 2 * (linesVerticesNr + pointsVerticesNr);
+			glBufferData(GL_ARRAY_BUFFER, debugVerticesCapacity * sizeof(glm::vec3), NULL, GL_DYNAMIC_DRAW);
+			CHECK_GL_ERROR("glBufferData");
+		}
+		if (linesVerticesNr)
+			glBufferSubData(GL_ARRAY_BUFFER, 0, linesVerticesNr * sizeof(glm::vec3), linesVertices.data());
+		if (pointsVerticesNr)
+			glBufferSubData(GL_ARRAY_BUFFER, linesVerticesNr * sizeof(glm::vec3), pointsVerticesNr * sizeof(glm::vec3), pointsVertices.data());
+		CHECK_GL_ERROR("glBufferSubData");
+		glDrawArrays(GL_LINES, 0, linesVerticesNr);
+		glDrawArrays(GL_POINTS, linesVerticesNr, pointsVerticesNr);
+		CHECK_GL_ERROR("glDrawArrays");
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
 	}
 
 	inline void Renderer::refreshProjMat() {	
@@ -930,13 +726,7 @@ namespace Corium3D {
 		//ServiceLocator::getLogger().logd("renderer", "-------------------------------------------");
 	}
 
-	struct VertexData {
-		aiVector3D pos;	
-		unsigned int bonesIDs[BONES_NR_PER_VERTEX_MAX]; 
-		float bonesWeights[BONES_NR_PER_VERTEX_MAX] = { 0 }; 
-		//aiVector3D normal;
-		//aiVector2D uvs;
-	};
+	typedef ModelDesc::VertexData VertexData;
 
 	inline unsigned int arrDotArr(unsigned int* arr1, unsigned int* arr2, unsigned int arrsLen) {
 		unsigned int res = 0;
@@ -946,33 +736,8 @@ namespace Corium3D {
 		return res;
 	}
 
-	inline glm::mat4 assimp2glm(aiMatrix4x4 const& mat) {
-		return glm::mat4(mat.a1, mat.b1, mat.c1, mat.d1, mat.a2, mat.b2, mat.c2, mat.d2, mat.a3, mat.b3, mat.c3, mat.d3, mat.a4, mat.b4, mat.c4, mat.d4);
-	}
-
-	inline glm::quat assimp2glm(aiQuaternion const& quat) {
-		return glm::quat(quat.w, quat.x, quat.y, quat.z);
-	}
-
-	inline glm::vec3 assimp2glm(aiVector3D const& vec) {
-		return glm::vec3(vec.x, vec.y, vec.z);
-	}
-
-	void loadMeshesTransformsArrRecurse(aiScene const* scene, glm::mat4* meshesTransformsArr, aiNode const* node, glm::mat4 const& parentTransform) {
-		glm::mat4 nodeTransform = parentTransform * assimp2glm(node->mTransformation);
-		for (unsigned int meshIdx = 0; meshIdx < node->mNumMeshes; meshIdx++)
-			meshesTransformsArr[node->mMeshes[meshIdx]] = nodeTransform;
-
-		for (unsigned int childIdx = 0; childIdx < node->mNumChildren; childIdx++)
-			loadMeshesTransformsArrRecurse(scene, meshesTransformsArr, node->mChildren[childIdx], nodeTransform);
-	}
-
-	void loadMeshesTransformsArr(aiScene const* scene, glm::mat4* meshesTransformsArr) {
-		loadMeshesTransformsArrRecurse(scene, meshesTransformsArr, scene->mRootNode, assimp2glm(scene->mRootNode->mTransformation));
-	}
-
 	bool Renderer::initOpenGlLmnts() {
-		ServiceLocator::getLogger().logd("Renderer", "initializing gl components.");
+		LOGD("Renderer", "initializing gl components.");
 	#if DEBUG
 		glEnable(GL_DEBUG_OUTPUT);
 		glDebugMessageCallback(glErrorCallback, NULL);
@@ -986,16 +751,10 @@ namespace Corium3D {
 		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		glPointSize(5.0f);
 
-		glGenBuffers(1, &instanceDataIdxsBuffer);
-		CHECK_GL_ERROR("glGenBuffers");
 		glGenBuffers(1, &vertexBuffer);
 		CHECK_GL_ERROR("glGenBuffers");
 		glGenBuffers(1, &mvpMatsBuffer);
 		CHECK_GL_ERROR("glGenBuffers");
-		glGenBuffers(1, &bonesTransformsBaseIdxsBuffer);
-		CHECK_GL_ERROR("glGenBuffers");
-		glGenBuffers(1, &bonesTransformsBuffer);
-		CHECK_GL_ERROR("glGenBuffers");
 		glGenBuffers(1, &selectedVerticesColorsIdxsBuffer);
 		CHECK_GL_ERROR("glGenBuffers");
 		glGenBuffers(1, &verticesColorsBuffer);
@@ -1012,7 +771,8 @@ namespace Corium3D {
 			if (!createGlProg(vertexShaderCode.c_str(), fragShaderCode.c_str(), &progs[shaderIdx], &vertexShaders[shaderIdx], &fragShaders[shaderIdx]))
 				return false;	
 
-			GLuint instanceDataIdxAttribLoc = glGetAttribLocation(progs[shaderIdx], INSTANCE_DATA_IDX_ATTRIB_NAME);
+			instanceDataIdxAttribLocs[shaderIdx] = glGetAttribLocation(progs[shaderIdx], INSTANCE_DATA_IDX_ATTRIB_NAME);
+			bonesTransformsBaseIdxAttribLocs[shaderIdx] = glGetAttribLocation(progs[shaderIdx], BONES_TRANSFORMS_BASE_IDX_ATTRIB_NAME);
 			GLuint vertexPosAttribLoc = glGetAttribLocation(progs[shaderIdx], VERTEX_POS_ATTRIB_NAME);
 			vpMatAttribLoc = glGetUniformLocation(progs[shaderIdx], VIEW_PROJECTION_MAT_UNIFORM_NAME);
 			//GLuint vertexBonesIdxsAttribLoc = glGetAttribLocation(progs[descIdx], VERTEX_BONES_IDS_ATTRIB_NAME);
@@ -1025,13 +785,18 @@ namespace Corium3D {
 
 			glBindVertexArray(vaos[shaderIdx]);
 			CHECK_GL_ERROR("glBindVertexArray");
-			glBindBuffer(GL_ARRAY_BUFFER, instanceDataIdxsBuffer);
-			glVertexAttribIPointer(instanceDataIdxAttribLoc, 1, GL_UNSIGNED_INT, 0, (void*)0);
-			CHECK_GL_ERROR("glVertexAttribPointer");
-			glEnableVertexAttribArray(instanceDataIdxAttribLoc);
+			// sourced from the frame ring - pointed at it once it is created (per scene)
+			glEnableVertexAttribArray(instanceDataIdxAttribLocs[shaderIdx]);
 			CHECK_GL_ERROR("glEnableVertexAttribArray");
-			glVertexAttribDivisor(instanceDataIdxAttribLoc, 1);
+			glVertexAttribDivisor(instanceDataIdxAttribLocs[shaderIdx], 1);
 			CHECK_GL_ERROR("glVertexAttribDivisor");
+			// boneless shaders have none
+			if (bonesTransformsBaseIdxAttribLocs[shaderIdx] != (GLuint)-1) {
+				glEnableVertexAttribArray(bonesTransformsBaseIdxAttribLocs[shaderIdx]);
+				CHECK_GL_ERROR("glEnableVertexAttribArray");
+				glVertexAttribDivisor(bonesTransformsBaseIdxAttribLocs[shaderIdx], 1);
+				CHECK_GL_ERROR("glVertexAttribDivisor");
+			}
 
 			glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
 			glVertexAttribPointer(vertexPosAttribLoc, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)0);
@@ -1039,11 +804,11 @@ namespace Corium3D {
 			CHECK_GL_ERROR("glVertexAttribPointer");
 			glEnableVertexAttribArray(vertexPosAttribLoc);
 			CHECK_GL_ERROR("glEnableVertexAttribArray");
-			//glVertexAttribIPointer(vertexBonesIdxsAttribLoc, BONES_NR_PER_VERTEX_MAX, GL_UNSIGNED_INT, sizeof(VertexData), (void*)sizeof(aiVector3D));
+			//glVertexAttribIPointer(vertexBonesIdxsAttribLoc, BONES_NR_PER_VERTEX_MAX, GL_UNSIGNED_INT, sizeof(VertexData), (void*)sizeof(glm::vec3));
 			//CHECK_GL_ERROR("glVertexAttribPointer");
 			//glEnableVertexAttribArray(vertexBonesIdxsAttribLoc);
 			//CHECK_GL_ERROR("glEnableVertexAttribArray");
-			//glVertexAttribPointer(vertexBonesWeightsAttribLoc, BONES_NR_PER_VERTEX_MAX, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)(sizeof(aiVector3D) + BONES_NR_PER_VERTEX_MAX*sizeof(unsigned int)));
+			//glVertexAttribPointer(vertexBonesWeightsAttribLoc, BONES_NR_PER_VERTEX_MAX, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)(sizeof(glm::vec3) + BONES_NR_PER_VERTEX_MAX*sizeof(unsigned int)));
 			//CHECK_GL_ERROR("glVertexAttribPointer");
 			//glEnableVertexAttribArray(vertexBonesWeightsAttribLoc);
 			//CHECK_GL_ERROR("glEnableVertexAttribArray");		
@@ -1085,20 +850,14 @@ namespace Corium3D {
 		glGenVertexArrays(1, &debugVAO);
 		glGenBuffers(1, &debugVertexBuffer);
 		glGenBuffers(1, &debugVpMatBuffer);
-		glGenBuffers(1, &debugIndicesBuffer);
 
-		unsigned int cubeVertexIndices[24] = { 0, 1, 0, 3, 1, 2, 2, 3,
-											   4, 5, 4, 7, 5, 6, 6, 7,
-											   0, 4, 1, 5, 2, 6, 3, 7 };
+		debugVerticesCapacity = DEBUG_VERTICES_NR_INIT;
 		glBindBuffer(GL_ARRAY_BUFFER, debugVertexBuffer);
-		glBufferData(GL_ARRAY_BUFFER, 1000 * sizeof(glm::vec3), NULL, GL_DYNAMIC_DRAW);
+		glBufferData(GL_ARRAY_BUFFER, debugVerticesCapacity * sizeof(glm::vec3), NULL, GL_DYNAMIC_DRAW);
 		CHECK_GL_ERROR("glBufferData");
 		glBindBuffer(GL_ARRAY_BUFFER, debugVpMatBuffer);
 		glBufferData(GL_ARRAY_BUFFER, sizeof(glm::mat4), NULL, GL_DYNAMIC_DRAW);
 		CHECK_GL_ERROR("glBufferData");
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, debugIndicesBuffer);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, 24 * sizeof(unsigned int), cubeVertexIndices, GL_STATIC_DRAW);
-		CHECK_GL_ERROR("glBufferData");
 
 		if (!createGlProg(debugVertexShaderCode, debugFragShaderCode, &debugProg, &debugVertexShader, &debugFragShader))
 			return false;
@@ -1110,242 +869,86 @@ namespace Corium3D {
 		glEnableVertexAttribArray(vertexAttribLoc);
 		debugVpMatUniformLoc = glGetUniformLocation(debugProg, "uVpMat");
 		glBindVertexArray(0);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 
 		return true;
 	}
 
+	void Renderer::reportMemory(MemoryReport& memoryReport) const {
+		if (!isSceneLoaded)
+			return;
+
+		if (frameRing)
+			memoryReport.addGpuBuffer("Renderer", "frameRingBuffer", frameRing->getRegionSz(), frameRing->getRegionsNr());
+		memoryReport.addGpuBuffer("Renderer", "vertexBuffer", sizeof(VertexData), verticesNrTotal);
+		memoryReport.addGpuBuffer("Renderer", "mvpMatsBuffer", sizeof(glm::mat4), staticInstancesNrMax);
+		memoryReport.addGpuBuffer("Renderer", "selectedVerticesColorsIdxsBuffer", sizeof(unsigned int), staticInstancesNrMax);
+		memoryReport.addGpuBuffer("Renderer", "verticesColorsBuffer", 4 * sizeof(float), verticesColorsNrTotal);
+		memoryReport.addGpuBuffer("Renderer", "indicesBuffer", sizeof(unsigned int), 3 * facesNrTotal + lodsIdxsNrTotal);
+		memoryReport.addGpuBuffer("Renderer", "debugVertexBuffer", sizeof(glm::vec3), debugVerticesCapacity);
+	}
+
 	bool Renderer::loadOpenGlBuffers() {			
-		glBindBuffer(GL_ARRAY_BUFFER, instanceDataIdxsBuffer);
-		glBufferData(GL_ARRAY_BUFFER, instancesNrsMaximaMax * sizeof(unsigned int), NULL, GL_DYNAMIC_DRAW);
-		CHECK_GL_ERROR("glBufferData");
+		if (!loadInstancesBuffers())
+			return false;
 		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
 		glBufferData(GL_ARRAY_BUFFER, verticesNrTotal * sizeof(VertexData), NULL, GL_STATIC_DRAW);
 		CHECK_GL_ERROR("glBufferData");			
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, mvpMatsBuffer);
-		glBufferData(GL_SHADER_STORAGE_BUFFER, (staticInstancesNrMax + instancesNrsMaximaMax) * sizeof(glm::mat4), NULL, GL_DYNAMIC_DRAW);
-		CHECK_GL_ERROR("glBufferData");
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, bonesTransformsBaseIdxsBuffer);
-		glBufferData(GL_SHADER_STORAGE_BUFFER, instancesNrsMaximaMax * sizeof(unsigned int), NULL, GL_STATIC_DRAW);
-		CHECK_GL_ERROR("glBufferData");		
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, bonesTransformsBuffer);
-		glBufferData(GL_SHADER_STORAGE_BUFFER, bonesInstancedNrMax * sizeof(glm::mat4), NULL, GL_DYNAMIC_DRAW);
-		CHECK_GL_ERROR("glBufferData");
-		//glBindBuffer(GL_SHADER_STORAGE_BUFFER, selectedVerticesColorsIdxsBuffer);
-		//glBufferData(GL_SHADER_STORAGE_BUFFER, instancesNrMax * sizeof(unsigned int), NULL, GL_DYNAMIC_DRAW);
-		// TODO: Fix the damn vertices colors handling
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, selectedVerticesColorsIdxsBuffer);
-		glBufferData(GL_SHADER_STORAGE_BUFFER, staticInstancesNrMax * sizeof(unsigned int), NULL, GL_DYNAMIC_DRAW);
-		CHECK_GL_ERROR("glBufferData");
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, verticesColorsBuffer);
 		glBufferData(GL_SHADER_STORAGE_BUFFER, verticesColorsNrTotal * 4 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
 		CHECK_GL_ERROR("glBufferData");
 		glBindBuffer(GL_ARRAY_BUFFER, indicesBuffer);
-		glBufferData(GL_ARRAY_BUFFER, facesNrTotal * 3 * sizeof(unsigned int), NULL, GL_STATIC_DRAW);
+		glBufferData(GL_ARRAY_BUFFER, (facesNrTotal * 3 + lodsIdxsNrTotal) * sizeof(unsigned int), NULL, GL_STATIC_DRAW);
 		CHECK_GL_ERROR("glBufferData");
 
-		// load colladas to the buffers
+		// upload the models' baked data to the buffers
 		unsigned int processedVerticesNr = 0;
-		unsigned int processedInstancedBonesNr = 0;
-		unsigned int processedInstancesNr = 0;
 		unsigned int processedVerticesColorsNr = 0;
 		unsigned int processedIndicesNr = 0;			
 		for (unsigned int modelIdx = 0; modelIdx < modelsNrTotal; modelIdx++) {
-			Assimp::Importer* importer = new Assimp::Importer();
-			// reminder : the importer object keeps ownership of the scene data and will destroy it upon destruction
-			const aiScene *scene = importer->ReadFile(modelDescsBuffer[modelIdx].colladaPath, aiProcessPreset_TargetRealtime_Quality | aiProcess_JoinIdenticalVertices);
-			if (!scene) {
-				std::string errorString = importer->GetErrorString();
-				ServiceLocator::getLogger().loge("loadOpenGlBuffers", "Scene import failed: %s", errorString.c_str());
+			ModelDescView const& modelDesc = modelDescsBuffer[modelIdx];
+			if (modelDesc.colladaPath.empty() || !modelDesc.meshesNr) {
+				LOGE("loadOpenGlBuffers", "model #%u has no meshes !", modelIdx);
 				return false;
 			}
-			else
-				ServiceLocator::getLogger().logd("Renderer", "Scene import succeeded.");
-
-			if (scene->HasMeshes()) {
-				// TODO: remove meshesTransformsBuffer from class scope and leave it in this scope.
-				//		 these two will be relevant for unanimated scenes only.				
-				meshesTransformsBuffer = new glm::mat4[scene->mNumMeshes]();		
-				loadMeshesTransformsArr(scene, meshesTransformsBuffer);
-				unsigned int processedModelBonesNr = 0;
-				for (unsigned int meshIdx = 0; meshIdx < scene->mNumMeshes; meshIdx++) {
-					const aiMesh *mesh = scene->mMeshes[meshIdx];
-					if (!mesh->HasPositions() || !mesh->HasFaces()) {
-						std::string lmntIdxsPrefix(std::string("model #") + std::to_string(modelIdx) + std::string(": Mesh #") + std::to_string(meshIdx));
-						if (!mesh->HasPositions())
-							ServiceLocator::getLogger().loge("initOpenGlLmnts", (lmntIdxsPrefix + std::string(" has no positions !")).c_str());
-						else if (!mesh->HasFaces())
-							ServiceLocator::getLogger().loge("initOpenGlLmnts", (lmntIdxsPrefix + std::string(" has no faces !")).c_str());
-
-						delete importer;
-						return false;
-					}
 
-					// load vertex data				
-					VertexData* verticesData = new VertexData[mesh->mNumVertices];
-					if (scene->HasAnimations()) {
-						for (unsigned int vertexIdx = 0; vertexIdx < mesh->mNumVertices; vertexIdx++) {
-							verticesData[vertexIdx].pos = mesh->mVertices[vertexIdx];
-							//verticesData[vertexIdx].normal = sceneFirstMesh->mNormals[vertexIdx];
-							//verticesData[vertexIdx].uvs = sceneFirstMesh->mTextureCoords[0][vertexIdx];			
-						}
-					}
-					else {
-						//TODO: update the vertices data with the mesh transform
-						for (unsigned int vertexIdx = 0; vertexIdx < mesh->mNumVertices; vertexIdx++) {
-							verticesData[vertexIdx].pos = mesh->mVertices[vertexIdx];
-							//verticesData[vertexIdx].normal = sceneFirstMesh->mNormals[vertexIdx];
-							//verticesData[vertexIdx].uvs = sceneFirstMesh->mTextureCoords[0][vertexIdx];			
-						}
-					}
-																						
-					if (mesh->mNumBones) {
-						unsigned int* verticesProcessedWeightsNrs = new unsigned int[mesh->mNumVertices]();
-						for (unsigned int boneIdx = 0; boneIdx < mesh->mNumBones; boneIdx++) {
-							aiBone* bone = mesh->mBones[boneIdx];
-							for (unsigned int vertexIdx = 0; vertexIdx < bone->mNumWeights; vertexIdx++) {
-								unsigned int vertexID = bone->mWeights[vertexIdx].mVertexId;
-								float vertexWeight = bone->mWeights[vertexIdx].mWeight;
-								unsigned int vertexProcessedWeightsNr = verticesProcessedWeightsNrs[vertexID];
-								verticesData[vertexID].bonesIDs[vertexProcessedWeightsNr] = processedModelBonesNr;
-								verticesData[vertexID].bonesWeights[vertexProcessedWeightsNr] = vertexWeight;
-								verticesProcessedWeightsNrs[vertexID]++;
-							}
-							processedModelBonesNr++;
-						}
-						delete[] verticesProcessedWeightsNrs;
-					}
-					glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-					CHECK_GL_ERROR("glBindBuffer");
-					glBufferSubData(GL_ARRAY_BUFFER, sizeof(VertexData) * processedVerticesNr,
-						sizeof(VertexData) * mesh->mNumVertices, verticesData);
-					CHECK_GL_ERROR("glBufferSubData");
-					delete[] verticesData;
-					processedVerticesNr += mesh->mNumVertices;
-
-					// load colors
-					/* possibly iterate over indices 0 through AI_MAX_NUMBER_OF_COLOR_SETS
-					unsigned int verticesNr = sceneFirstMesh->mNumVertices;
-					float *vertexColorsArr = new float[verticesNr * 4];
-					for (int vertexIdx = 0; vertexIdx < verticesNr; vertexIdx++) {
-					vertexColorsArr[vertexIdx*4] = sceneFirstMesh->mColors[0][vertexIdx].r;
-					vertexColorsArr[vertexIdx*4 + 1] = sceneFirstMesh->mColors[0][vertexIdx].g;
-					vertexColorsArr[vertexIdx*4 + 2] = sceneFirstMesh->mColors[0][vertexIdx].b;
-					vertexColorsArr[vertexIdx*4 + 3] = sceneFirstMesh->mColors[0][vertexIdx].a;
-					} */
-					
-					// load faces
-					unsigned int facesNr = mesh->mNumFaces;
-					unsigned int *vertexIndicesArr = new unsigned int[facesNr * 3];
-					unsigned int vertexIdxIdx = 0;
-					for (unsigned int faceIdx = 0; faceIdx < facesNr; faceIdx++) {
-						// read a face from assimp's mesh and copy it into faceArr
-						const aiFace *face = &mesh->mFaces[faceIdx];
-						memcpy(&vertexIndicesArr[vertexIdxIdx], face->mIndices, 3 * sizeof(unsigned int));
-						vertexIdxIdx += 3;
-					}
+			glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+			CHECK_GL_ERROR("glBindBuffer");
+			glBufferSubData(GL_ARRAY_BUFFER, sizeof(VertexData) * processedVerticesNr, sizeof(VertexData) * modelDesc.verticesNr, modelDesc.vertices.data());
+			CHECK_GL_ERROR("glBufferSubData");
+			processedVerticesNr += modelDesc.verticesNr;
 
-					glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indicesBuffer);
-					CHECK_GL_ERROR("glBindBuffer");
-					glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * processedIndicesNr,
-						sizeof(unsigned int) * facesNr * 3, vertexIndicesArr);
-					CHECK_GL_ERROR("glBufferSubData");
-					delete[] vertexIndicesArr;
-					processedIndicesNr += facesNr * 3;
-
-					/*
-					unsigned int* initVerticesColorsIdx = new unsigned int[modelsInstancesNrsMaxima[modelIdx]];
-					for (unsigned int instanceIdx = 0; instanceIdx < modelsInstancesNrsMaxima[modelIdx]; instanceIdx++)
-						initVerticesColorsIdx[instanceIdx] = processedVerticesColorsNr;
-					glBindBuffer(GL_SHADER_STORAGE_BUFFER, selectedVerticesColorsIdxsBuffer);
-					CHECK_GL_ERROR("glBindBuffer");
-					glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(unsigned int) * processedInstancesNr,
-						sizeof(unsigned int) * modelsInstancesNrsMaxima[modelIdx], initVerticesColorsIdx);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indicesBuffer);
+			CHECK_GL_ERROR("glBindBuffer");
+			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * processedIndicesNr, sizeof(unsigned int) * 3 * modelDesc.facesNr, modelDesc.idxs.data());
+			CHECK_GL_ERROR("glBufferSubData");
+			processedIndicesNr += 3 * modelDesc.facesNr;
+			// the coarser levels of detail's indices follow the model's full detail ones (see DrawListBuilder)
+			if (!modelDesc.lodsIdxs.empty()) {
+				glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * processedIndicesNr, sizeof(unsigned int) * modelDesc.lodsIdxs.size(), modelDesc.lodsIdxs.data());
+				CHECK_GL_ERROR("glBufferSubData");
+				processedIndicesNr += modelDesc.lodsIdxs.size();
+			}
+
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, verticesColorsBuffer);
+			CHECK_GL_ERROR("glBindBuffer");
+			for (unsigned int meshIdx = 0; meshIdx < modelDesc.meshesNr; meshIdx++) {
+				unsigned int meshVerticesNr = modelDesc.verticesNrsPerMesh[meshIdx];
+				for (unsigned int colorsArrIdx = 0; colorsArrIdx < modelDesc.extraColorsNrsPerMesh[meshIdx]; colorsArrIdx++) {
+					glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(float) * 4 * (processedVerticesColorsNr + (colorsArrIdx + 1)*meshVerticesNr),
+						sizeof(float) * 4 * meshVerticesNr, &modelDesc.extraColors[meshIdx][colorsArrIdx][0]);
 					CHECK_GL_ERROR("glBufferSubData");
-					delete[] initVerticesColorsIdx;
-					*/
-					/*
-					glBindBuffer(GL_SHADER_STORAGE_BUFFER, verticesColorsBuffer);
-					CHECK_GL_ERROR("glBindBuffer");
-					if (mesh->mColors[0]) {
-						glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(float) * 4 * processedVerticesColorsNr,
-							sizeof(float) * 4 * mesh->mNumVertices, mesh->mColors[0]);
-						CHECK_GL_ERROR("glBufferSubData");
-					}
-					*/
-					for (unsigned int colorsArrIdx = 0; colorsArrIdx < modelDescsBuffer[modelIdx].extraColorsNrsPerMesh[meshIdx]; colorsArrIdx++) {
-						glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(float) * 4 * (processedVerticesColorsNr + (colorsArrIdx + 1)*mesh->mNumVertices),
-							sizeof(float) * 4 * mesh->mNumVertices, &modelDescsBuffer[modelIdx].extraColors[meshIdx][colorsArrIdx][0]);
-						CHECK_GL_ERROR("glBufferSubData");
-					}
-					
-					for (unsigned int verticesColorIdx = 0; verticesColorIdx < modelDescsBuffer[modelIdx].extraColorsNrsPerMesh[meshIdx] + 1; verticesColorIdx++)
-						verticesColorsBaseIdxs[modelIdx][meshIdx][verticesColorIdx] = processedVerticesColorsNr + verticesColorIdx*mesh->mNumVertices;
-					processedVerticesColorsNr += (modelDescsBuffer[modelIdx].extraColorsNrsPerMesh[meshIdx] + 1) * mesh->mNumVertices;
-
-					// buffer for vertex texture coordinates
-					// ***ASSUMPTION*** -- handle only one texture for each mesh
-					/*if (mesh->HasTextureCoords(0)) {
-					float *texCoords = new float[2 * mesh->mNumVertices];
-					for (unsigned int texCoordsIdx = 0; texCoordsIdx < mesh->mNumVertices; ++texCoordsIdx) {
-					texCoords[texCoordsIdx * 2] = mesh->mTextureCoords[0][texCoordsIdx].x;
-					texCoords[texCoordsIdx * 2 + 1] = mesh->mTextureCoords[0][texCoordsIdx].y;
-					}
-					glGenBuffers(1, &buffer);
-					glBindBuffer(GL_ARRAY_BUFFER, buffer);
-					glBufferData(GL_ARRAY_BUFFER,
-					sizeof(float) * 2 * mesh->mNumVertices, texCoords,
-					GL_STATIC_DRAW);
-					meshes[meshIdx].textureCoordBuffer = buffer;
-					delete[] texCoords;
-
-					// unbind buffers
-					glBindBuffer(GL_ARRAY_BUFFER, 0);
-					glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-					glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-					// copy texture index (= texture name in GL) for the mesh from textureNameMap
-					aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
-					aiString texPath;    //contains filename of texture
-					if (AI_SUCCESS == material->GetTexture(aiTextureType_DIFFUSE, 0, &texPath)) {
-					unsigned int textureId = textureNameMap[texturePath.data];
-					newMeshInfo.textureIndex = textureId;
-					} else {
-					newMeshInfo.textureIndex = 0;
-					}
-					}*/
-					glBindBuffer(GL_ARRAY_BUFFER, 0);					
-					glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 				}
-								
-				if (scene->HasAnimations())
-					modelsAnimators[modelIdx] = new ModelAnimator(scene, bonesTransformsBuffer, processedInstancedBonesNr, modelDescsBuffer[modelIdx].bonesNr, meshesTransformsBuffer, modelsInstancesNrsMaxima[modelIdx]);
-					
-				if (unsigned int modelBonesNr = modelDescsBuffer[modelIdx].bonesNr) {
-					unsigned int* bonesTransformsBaseIdxs = new unsigned int[modelsInstancesNrsMaxima[modelIdx]]();
-					for (unsigned int instanceIdx = 0; instanceIdx < modelsInstancesNrsMaxima[modelIdx]; instanceIdx++)
-						bonesTransformsBaseIdxs[instanceIdx] = processedInstancedBonesNr + modelBonesNr*instanceIdx;
-					glBindBuffer(GL_SHADER_STORAGE_BUFFER, bonesTransformsBaseIdxsBuffer);
-					CHECK_GL_ERROR("glBindBuffer");
-					glBufferSubData(GL_SHADER_STORAGE_BUFFER, processedInstancedBonesNr * sizeof(unsigned int),
-						modelsInstancesNrsMaxima[modelIdx] * sizeof(unsigned int), bonesTransformsBaseIdxs);
-					CHECK_GL_ERROR("glBufferSubData");
-					delete[] bonesTransformsBaseIdxs;
-
-					processedInstancedBonesNr += modelBonesNr * modelsInstancesNrsMaxima[modelIdx];
-				}												
-			}
-			else {
-				ServiceLocator::getLogger().loge("initOpenGlLmnts", "The scene has no meshes !");
-				delete importer;
-				return false;
+				
+				for (unsigned int verticesColorIdx = 0; verticesColorIdx < modelDesc.extraColorsNrsPerMesh[meshIdx] + 1; verticesColorIdx++)
+					verticesColorsBaseIdxs[modelIdx][meshIdx][verticesColorIdx] = processedVerticesColorsNr + verticesColorIdx*meshVerticesNr;
+				processedVerticesColorsNr += (modelDesc.extraColorsNrsPerMesh[meshIdx] + 1) * meshVerticesNr;
 			}
-
-			instancesBaseIdxsPerModel[modelIdx] = processedInstancesNr;
-			processedInstancesNr += modelsInstancesNrsMaxima[modelIdx];
-
-			delete importer;																	
+			glBindBuffer(GL_ARRAY_BUFFER, 0);					
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+							
+			if (!modelDesc.animationsDescs.empty())
+				modelsAnimators[modelIdx] = new ModelAnimator(modelDesc, instancesRanges->getInstancesNrMax(modelIdx));
 		}
 					
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
@@ -1359,28 +962,80 @@ namespace Corium3D {
 		return true;
 	}
 
-	unsigned int currFrame = 0;
-	inline glm::mat4 calcKeyframeTransformat(aiNodeAnim* node) {
-		unsigned int frameIdx;
-		if (currFrame < node->mNumPositionKeys)
-			frameIdx = currFrame;
-		else
-			frameIdx = node->mNumPositionKeys - 1;
-		glm::mat4 translate = glm::translate(assimp2glm(node->mPositionKeys[frameIdx].mValue));
-	
-		if (currFrame < node->mNumRotationKeys)
-			frameIdx = currFrame;
-		else
-			frameIdx = node->mNumRotationKeys - 1;
-		glm::mat4 rot = glm::mat4_cast(assimp2glm(node->mRotationKeys[frameIdx].mValue));
+	// the buffers sized by the models' instances maxima
+	bool Renderer::loadInstancesBuffers() {
+		if (!createFrameRing())
+			return false;
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, mvpMatsBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, staticInstancesNrMax * sizeof(glm::mat4), NULL, GL_DYNAMIC_DRAW);
+		CHECK_GL_ERROR("glBufferData");
+		// a new buffer (a scene load, a recreated context or grown maxima) - the static transformats are restored out of their shadow
+		staticTransformatsDirtyRanges.markDirty(0, staticInstancesNrMax);
+		// TODO: Fix the damn vertices colors handling
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, selectedVerticesColorsIdxsBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, staticInstancesNrMax * sizeof(unsigned int), selectedVerticesColorsIdxsShadow.data(), GL_DYNAMIC_DRAW);
+		CHECK_GL_ERROR("glBufferData");
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		needReloadInstancesBuffers = false;
 
-		if (currFrame < node->mNumScalingKeys)
-			frameIdx = currFrame;
-		else
-			frameIdx = node->mNumScalingKeys - 1;
-		glm::mat4 scale = glm::scale(assimp2glm(node->mScalingKeys[frameIdx].mValue));
+		return true;
+	}
+
+	// a region holds a frame's worst case - every instance visible and animated - plus an alignment padding per allocation
+	bool Renderer::createFrameRing() {
+		destroyFrameRing();
+
+		// a region is bound as a whole for the frame's draws
+		GLint ssboOffsetAlignment;
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &ssboOffsetAlignment);
+		size_t regionAlignment = std::max((size_t)ssboOffsetAlignment, sizeof(glm::mat4));
+		size_t regionSz = meshesNrTotal * sizeof(IndirectCommandsGenerator::Command) + sizeof(unsigned int);
+		for (unsigned int modelIdx = 0; modelIdx < modelsNrTotal; modelIdx++) {
+			size_t modelInstancesNrMax = instancesRanges->getInstancesNrMax(modelIdx);
+			regionSz += modelInstancesNrMax * sizeof(InstanceDataRecord) + sizeof(InstanceDataRecord);
+			if (modelIdx >= staticModelsNr)
+				regionSz += modelInstancesNrMax * sizeof(glm::mat4) + sizeof(glm::mat4);
+			if (unsigned int bonesNr = modelDescsBuffer[modelIdx].bonesNr)
+				regionSz += (modelInstancesNrMax + 1) * bonesNr * sizeof(glm::mat4) + sizeof(glm::mat4);
+		}
+		frameRing = new Corium3DUtils::FrameRing(FRAME_RING_REGIONS_NR, std::max(regionSz, regionAlignment), regionAlignment);
+
+		// REMINDER: doesnt work in opengl es 3 (EXT_buffer_storage)
+		glGenBuffers(1, &frameRingBuffer);
+		CHECK_GL_ERROR("glGenBuffers");
+		glBindBuffer(GL_ARRAY_BUFFER, frameRingBuffer);
+		glBufferStorage(GL_ARRAY_BUFFER, frameRing->getBufferSz(), NULL, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+		CHECK_GL_ERROR("glBufferStorage");
+		frameRingBufferPtr = (char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, frameRing->getBufferSz(), GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+		CHECK_GL_ERROR("glMapBufferRange");
+		for (unsigned int shaderIdx = 0; shaderIdx < shadersNr; shaderIdx++) {
+			glBindVertexArray(vaos[shaderIdx]);
+			glVertexAttribIPointer(instanceDataIdxAttribLocs[shaderIdx], 1, GL_UNSIGNED_INT, sizeof(InstanceDataRecord), (void*)offsetof(InstanceDataRecord, transformatIdx));
+			CHECK_GL_ERROR("glVertexAttribIPointer");
+			if (bonesTransformsBaseIdxAttribLocs[shaderIdx] != (GLuint)-1) {
+				glVertexAttribIPointer(bonesTransformsBaseIdxAttribLocs[shaderIdx], 1, GL_UNSIGNED_INT, sizeof(InstanceDataRecord), (void*)offsetof(InstanceDataRecord, bonesTransformsBaseIdx));
+				CHECK_GL_ERROR("glVertexAttribIPointer");
+			}
+		}
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-		return translate * rot * scale;
+		return true;
+	}
+
+	// the buffer is unmapped along with its deletion
+	void Renderer::destroyFrameRing() {
+		for (unsigned int regionIdx = 0; regionIdx < FRAME_RING_REGIONS_NR; regionIdx++) {
+			if (frameRingFences[regionIdx]) {
+				glDeleteSync(frameRingFences[regionIdx]);
+				frameRingFences[regionIdx] = NULL;
+			}
+		}
+		glDeleteBuffers(1, &frameRingBuffer);
+		frameRingBuffer = 0;
+		frameRingBufferPtr = NULL;
+		delete frameRing;
+		frameRing = NULL;
 	}
 
 	void Renderer::destroyOpenGlLmnts() {
@@ -1399,44 +1054,28 @@ namespace Corium3D {
 		glDeleteProgram(debugProg);
 		glDeleteBuffers(1, &debugVertexBuffer);
 		glDeleteBuffers(1, &debugVpMatBuffer);
-		glDeleteBuffers(1, &debugIndicesBuffer);
 		glDeleteBuffers(1, &verticesColorsBuffer);
 		glDeleteBuffers(1, &selectedVerticesColorsIdxsBuffer);
-		glDeleteBuffers(1, &bonesTransformsBuffer);
-		glDeleteBuffers(1, &bonesTransformsBaseIdxsBuffer);
 		glDeleteBuffers(1, &mvpMatsBuffer);
 		glDeleteBuffers(1, &vertexBuffer);
-		glDeleteBuffers(1, &instanceDataIdxsBuffer);
+		destroyFrameRing();
 		glDeleteVertexArrays(shadersNr, vaos);
-		delete[] meshesTransformsBuffer;
 	}
 
-	bool Renderer::isBoundingSphereVisible(BoundingSphere const& boundingSphere) const {
-		//return true;
-		glm::vec3 const& sphereC = boundingSphere.getCenter();
-		float sphereR = boundingSphere.getRadius();
-		if (frustumFarPlane.signedDistFromPoint(sphereC) > sphereR)
-			return false;
-
-		// cone to sphere test
-		glm::vec3 u = cameraPos - boundingSphere.getRadius()*cameraLookDirection/fovSin;
-		glm::vec3 d = sphereC - u;	
-		float e = dot(cameraLookDirection, d);
-		if ( e > 0 && e*e >= length2(d)*cos(fov)) {
-			d = sphereC - cameraPos;
-			e = -dot(cameraLookDirection, d);
-			if (e > 0 && e*e >= length2(d)*sin(fov) && length2(d) > sphereR * sphereR)
-				return false;
-		}
-		else 
-			return false;	
-
-		// frustum to sphere test
-		return frustumNearPlane.signedDistFromPoint(sphereC) <= sphereR &&
-			   frustumLeftPlane.signedDistFromPoint(sphereC) <= sphereR &&
-			   frustumRightPlane.signedDistFromPoint(sphereC) <= sphereR &&
-			   frustumTopPlane.signedDistFromPoint(sphereC) <= sphereR &&
-			   frustumBotPlane.signedDistFromPoint(sphereC) <= sphereR;
+	ViewFrustum Renderer::getViewFrustum() const {
+		ViewFrustum frustum;
+		frustum.planes[ViewFrustum::NEAR_PLANE] = frustumNearPlane;
+		frustum.planes[ViewFrustum::FAR_PLANE] = frustumFarPlane;
+		frustum.planes[ViewFrustum::LEFT_PLANE] = frustumLeftPlane;
+		frustum.planes[ViewFrustum::RIGHT_PLANE] = frustumRightPlane;
+		frustum.planes[ViewFrustum::TOP_PLANE] = frustumTopPlane;
+		frustum.planes[ViewFrustum::BOT_PLANE] = frustumBotPlane;
+		frustum.cameraPos = cameraPos;
+		frustum.cameraLookDirection = cameraLookDirection;
+		frustum.fov = fov;
+		frustum.fovSin = fovSin;
+		frustum.vpMat = vpMat;
+		return frustum;
 	}
 
 	Renderer::InstanceAnimationInterface::InstanceAnimationInterface(InstanceAnimator* _instanceAnimator, unsigned int _modelIdx, unsigned int _instanceIdx) :
@@ -1456,30 +1095,30 @@ namespace Corium3D {
 		EGLint format;
 
 		if ((_display = eglGetDisplay(EGL_DEFAULT_DISPLAY)) == EGL_NO_DISPLAY) {
-			ServiceLocator::getLogger().loge("Renderer", "eglGetDisplay() returned error 0x%08x", eglGetError());
+			LOGE("Renderer", "eglGetDisplay() returned error 0x%08x", eglGetError());
 			return false;
 		}
 		EGLint majorVersion, minorVersion;
 		if (!eglInitialize(_display, &majorVersion, &minorVersion)) {
-			ServiceLocator::getLogger().loge("Renderer", "eglInitialize() returned error 0x%08x", eglGetError());
+			LOGE("Renderer", "eglInitialize() returned error 0x%08x", eglGetError());
 			return false;
 		}
 
 		if (!eglChooseConfig(_display, eglAattribs, &_config, 1, &configsNr)) {
-			ServiceLocator::getLogger().loge("Renderer", "eglChooseConfig() returned error 0x%08x", eglGetError());
+			LOGE("Renderer", "eglChooseConfig() returned error 0x%08x", eglGetError());
 			destroy();
 			return false;
 		}
 
 		if (!eglGetConfigAttrib(_display, _config, EGL_NATIVE_VISUAL_ID, &format)) {
-			ServiceLocator::getLogger().loge("Renderer", "eglGetConfigAttrib() returned error 0x%08x", eglGetError());
+			LOGE("Renderer", "eglGetConfigAttrib() returned error 0x%08x", eglGetError());
 			destroy();
 			return false;
 		}
 		ANativeWindow_setBuffersGeometry(_window, 0, 0, format);
 
 		if ((_context = eglCreateContext(_display, _config, EGL_NO_CONTEXT, contextAttribList)) == EGL_NO_CONTEXT) {
-			ServiceLocator::getLogger().loge("Renderer", "eglCreateContext() returned error 0x%08x", eglGetError());
+			LOGE("Renderer", "eglCreateContext() returned error 0x%08x", eglGetError());
 			destroy();
 			return false;
 		}
@@ -1490,13 +1129,13 @@ namespace Corium3D {
 		}
 
 		if ((_surface = eglCreateWindowSurface(display, config, window, NULL)) == EGL_NO_SURFACE) {
-			ServiceLocator::getLogger().loge("Renderer", "eglCreateWindowSurface() returned error 0x%08x", eglGetError());
+			LOGE("Renderer", "eglCreateWindowSurface() returned error 0x%08x", eglGetError());
 			destroy();
 			return false;
 		}
 
 		if (!eglMakeCurrent(display, _surface, _surface, context)) {
-			ServiceLocator::getLogger().loge("Renderer", "eglMakeCurrent() returned error 0x%08x", eglGetError());
+			LOGE("Renderer", "eglMakeCurrent() returned error 0x%08x", eglGetError());
 			destroy();
 			return false;
 		}
@@ -1522,7 +1161,7 @@ namespace Corium3D {
 
 	bool Renderer::OpenGlContext::swapBuffers() {
 		if (!eglSwapBuffers(display, surface)) {
-			ServiceLocator::getLogger().loge("Renderer", "eglSwapBuffers() returned error %d", eglGetError());
+			LOGE("Renderer", "eglSwapBuffers() returned error %d", eglGetError());
 			return false;
 		else
 			return true;
@@ -1566,7 +1205,7 @@ namespace Corium3D {
 		int glVersion[2];
 		glGetIntegerv(GL_MAJOR_VERSION, &glVersion[0]);
 		glGetIntegerv(GL_MINOR_VERSION, &glVersion[1]);
-		ServiceLocator::getLogger().logd("OpenGlContext", "OpenGL version created: %d.%d", glVersion[0], glVersion[1]);
+		LOGD("OpenGlContext", "OpenGL version created: %d.%d", glVersion[0], glVersion[1]);
 
 		return true;
 	}
@@ -1583,310 +1222,14 @@ namespace Corium3D {
 
 	#endif
 
-	struct NodesCount {
-		unsigned int nodesNr = 1;
-		unsigned int treeDepthMax = 0;
-	};
-
-	// REMINDER: accumulating childrens' number onto nodesCount.nodesNr, and not the node itself (that is why nodesNr starts from 1 -> counts the root)
-	void genNodesCountRecurse(aiNode* node, NodesCount& nodesCount, unsigned int depth) {
-		nodesCount.treeDepthMax = depth > nodesCount.treeDepthMax ? depth : nodesCount.treeDepthMax;
-		if (node->mNumChildren) {
-			nodesCount.nodesNr += node->mNumChildren;
-			for (unsigned int childIdx = 0; childIdx < node->mNumChildren; childIdx++)
-				genNodesCountRecurse(node->mChildren[childIdx], nodesCount, depth + 1);
-		}
-	}
-
-	NodesCount genNodesCount(aiNode* root) {
-		NodesCount nodesCount;
-
-		genNodesCountRecurse(root, nodesCount, 0);
-		return nodesCount;
-	}
-
-	unsigned int mapNodesToChannelsIdxsRecurse(aiNode* node, unsigned int nodeIdx, const aiAnimation* animation, unsigned int* nodesToChannelsIdxsMap) {
-		if (!node)
-			return 0;
-
-		unsigned int channelIdx = 0;
-		while (channelIdx < animation->mNumChannels && animation->mChannels[channelIdx]->mNodeName != node->mName)
-			channelIdx++;
-		nodesToChannelsIdxsMap[nodeIdx] = channelIdx;
-		unsigned int processedSubtreeNodesNr = 0;
-		for (unsigned int childIdx = 0; childIdx < node->mNumChildren; childIdx++)
-			processedSubtreeNodesNr += mapNodesToChannelsIdxsRecurse(node->mChildren[childIdx], processedSubtreeNodesNr + nodeIdx + 1, animation, nodesToChannelsIdxsMap);
-
-		return processedSubtreeNodesNr + 1;
-	}
-
-	void mapNodesToChannelsIdxs(aiNode* root, const aiAnimation* animation, unsigned int* nodesToChannelsIdxsMap) {
-		mapNodesToChannelsIdxsRecurse(root, 0, animation, nodesToChannelsIdxsMap);
-	}
-
-	Renderer::ModelAnimator::ModelAnimator(aiScene const* scene, GLuint _bonesTransformatsBuffer, unsigned int _bonesTransformatsBufferModelBaseIdx,
-										   unsigned int _bonesNr, glm::mat4* _meshesTransformsBuffer, unsigned int instancesNrMax) {
-		bonesTransformatsBuffer = _bonesTransformatsBuffer;
-		bonesTransformatsBufferModelBaseIdx = _bonesTransformatsBufferModelBaseIdx;
-		bonesNr = _bonesNr;
-		meshesTransformsBuffer = _meshesTransformsBuffer;
-		instanceAnimatorsPool = new ObjPool<InstanceAnimator>(instancesNrMax);	
-		// REMINDER: Supposed to be bonesNrOverall (over all meshes)
-		bonesOffsets = new glm::mat4[bonesNr]; 
-		unsigned int boneIdxOverall = 0;
-		for (unsigned meshIdx = 0; meshIdx < scene->mNumMeshes; meshIdx++) {
-			for (unsigned int boneIdx = 0; boneIdx < scene->mMeshes[meshIdx]->mNumBones; boneIdx++) {
-				bonesOffsets[boneIdxOverall] = assimp2glm(scene->mMeshes[meshIdx]->mBones[boneIdx]->mOffsetMatrix);			
-				boneIdxOverall++;
-			}
-		}
-	
-		animationsNr = scene->mNumAnimations;
-		// TODO: Calculate the following data statically and move it to an AnimationDesc from which it will be copied here
-		animations = new Animation[animationsNr];
-		for (unsigned int animationIdx = 0; animationIdx < animationsNr; animationIdx++) {
-			aiAnimation const* animation = scene->mAnimations[animationIdx];
-			animations[animationIdx].dur = animation->mDuration;
-			animations[animationIdx].ticksPerSecond = animation->mTicksPerSecond;
-		
-			aiNode* nodesIt = scene->mRootNode;
-			NodesCount nodesCount = genNodesCount(nodesIt);	
-			animations[animationIdx].nodesNr = nodesCount.nodesNr;
-			animations[animationIdx].treeDepthMax = nodesCount.treeDepthMax;
-			unsigned int* nodesToChannelsIdxsMap = new unsigned int[nodesCount.nodesNr];
-			mapNodesToChannelsIdxs(nodesIt, animation, nodesToChannelsIdxsMap);
-			animations[animationIdx].TransformatsHierarchyBuffer = new Animation::TransformatsHierarchyNode[nodesCount.nodesNr];		
-			unsigned int* childrenIdxsStack = new unsigned int[nodesCount.treeDepthMax]();
-			Animation::TransformatsHierarchyNode** transformatsHierarchyNodesStack = new Animation::TransformatsHierarchyNode*[nodesCount.treeDepthMax + 1];
-			unsigned int depth = 0;
-			unsigned int nodesCounter = 0;
-			animations[animationIdx].channelsNr = 0;
-			while (1) {
-				// REMINDER: Depends on having at least 2 bones in the hierarchy
-				while (nodesIt->mNumChildren) {
-					animations[animationIdx].TransformatsHierarchyBuffer[nodesCounter] = genTransformatHierarchyNode(nodesIt, scene, animationIdx, nodesToChannelsIdxsMap[nodesCounter]);
-					transformatsHierarchyNodesStack[depth] = &animations[animationIdx].TransformatsHierarchyBuffer[nodesCounter++];								
-					nodesIt = nodesIt->mChildren[childrenIdxsStack[depth]];
-					childrenIdxsStack[depth]++;	
-					depth++;
-				}
-				animations[animationIdx].TransformatsHierarchyBuffer[nodesCounter] = genTransformatHierarchyNode(nodesIt, scene, animationIdx, nodesToChannelsIdxsMap[nodesCounter]);
-				transformatsHierarchyNodesStack[depth] = &animations[animationIdx].TransformatsHierarchyBuffer[nodesCounter++];						
-
-				// REMINDER: Depends on having at least 2 bones in the hierarchy
-				while (nodesIt->mParent && childrenIdxsStack[depth - 1] == nodesIt->mParent->mNumChildren) {
-					nodesIt = nodesIt->mParent;
-					transformatsHierarchyNodesStack[depth - 1]->children[childrenIdxsStack[depth - 1] - 1] = transformatsHierarchyNodesStack[depth];
-					transformatsHierarchyNodesStack[depth]->parent = transformatsHierarchyNodesStack[depth - 1];
-					depth--;
-					childrenIdxsStack[depth] = 0;
-				}
-
-				if (nodesIt->mParent) {
-					transformatsHierarchyNodesStack[depth - 1]->children[childrenIdxsStack[depth - 1] - 1] = transformatsHierarchyNodesStack[depth];
-					transformatsHierarchyNodesStack[depth]->parent = transformatsHierarchyNodesStack[depth - 1];
-					nodesIt = nodesIt->mParent->mChildren[childrenIdxsStack[depth - 1]];
-					childrenIdxsStack[depth - 1]++;				
-				}
-				else {
-					transformatsHierarchyNodesStack[depth]->parent = NULL;
-					break;
-				}
-			}
-			delete[] transformatsHierarchyNodesStack;
-			delete[] childrenIdxsStack;		
-						
-			//if (animations[animationIdx].channelsNr) {
-				unsigned int assimpChannelsNr = animation->mNumChannels;
-				unsigned int keyFramesNrByAssimpFormat = 0;
-				for (unsigned int channelIdx = 0; channelIdx < assimpChannelsNr; channelIdx++) {
-					keyFramesNrByAssimpFormat += animation->mChannels[channelIdx]->mNumScalingKeys;
-					keyFramesNrByAssimpFormat += animation->mChannels[channelIdx]->mNumRotationKeys;
-					keyFramesNrByAssimpFormat += animation->mChannels[channelIdx]->mNumPositionKeys;
-				}
-				double* keyFramesTimesBuffer = new double[keyFramesNrByAssimpFormat];
-				animations[animationIdx].keyFramesNr = 0;
-				unsigned int* scalingKeysIts = new unsigned int[assimpChannelsNr]();
-				unsigned int* rotKeysIts = new unsigned int[assimpChannelsNr]();
-				unsigned int* translationKeysIts = new unsigned int[assimpChannelsNr]();
-				unsigned int keyFrameIdxByAssimpFormatIt = 0;
-				while (keyFrameIdxByAssimpFormatIt < keyFramesNrByAssimpFormat) {
-					double minTime = std::numeric_limits<double>::max();
-					for (unsigned int channelIdx = 0; channelIdx < assimpChannelsNr; channelIdx++) {
-						aiNodeAnim* channel = animation->mChannels[channelIdx];
-						double scalingKeyTime = scalingKeysIts[channelIdx] < channel->mNumScalingKeys ? channel->mScalingKeys[scalingKeysIts[channelIdx]].mTime : std::numeric_limits<double>::max();
-						double rotKeyTime = rotKeysIts[channelIdx] < channel->mNumRotationKeys ? channel->mRotationKeys[rotKeysIts[channelIdx]].mTime : std::numeric_limits<double>::max();
-						double translationKeyTime = translationKeysIts[channelIdx] < channel->mNumPositionKeys ? channel->mPositionKeys[translationKeysIts[channelIdx]].mTime : std::numeric_limits<double>::max();
-						if (scalingKeyTime < minTime)
-							minTime = scalingKeyTime;
-						if (rotKeyTime < minTime)
-							minTime = rotKeyTime;
-						if (translationKeyTime < minTime)
-							minTime = translationKeyTime;
-					}
-					keyFramesTimesBuffer[animations[animationIdx].keyFramesNr++] = minTime;
-
-					for (unsigned int channelIdx = 0; channelIdx < assimpChannelsNr; channelIdx++) {
-						aiNodeAnim* channel = animation->mChannels[channelIdx];
-						if (scalingKeysIts[channelIdx] < channel->mNumScalingKeys && channel->mScalingKeys[scalingKeysIts[channelIdx]].mTime == minTime) {
-							keyFrameIdxByAssimpFormatIt++;
-							scalingKeysIts[channelIdx]++;
-						}
-						if (rotKeysIts[channelIdx] < channel->mNumRotationKeys && channel->mRotationKeys[rotKeysIts[channelIdx]].mTime == minTime) {
-							keyFrameIdxByAssimpFormatIt++;
-							rotKeysIts[channelIdx]++;
-						}
-						if (translationKeysIts[channelIdx] < channel->mNumPositionKeys && channel->mPositionKeys[translationKeysIts[channelIdx]].mTime == minTime) {
-							keyFrameIdxByAssimpFormatIt++;
-							translationKeysIts[channelIdx]++;
-						}
-					}
-				}
-				delete[] scalingKeysIts;
-				delete[] rotKeysIts;
-				delete[] translationKeysIts;
-			
-			
-				if (keyFramesTimesBuffer[0] == 0) {
-					animations[animationIdx].keyFramesTimes = new double[animations[animationIdx].keyFramesNr];
-					memcpy(animations[animationIdx].keyFramesTimes, keyFramesTimesBuffer, animations[animationIdx].keyFramesNr * sizeof(double));
-				}
-				else {
-					animations[animationIdx].keyFramesTimes = new double[animations[animationIdx].keyFramesNr + 1];
-					animations[animationIdx].keyFramesTimes[0] = 0.0;
-					memcpy(animations[animationIdx].keyFramesTimes + 1, keyFramesTimesBuffer, animations[animationIdx].keyFramesNr * sizeof(double));
-				}
-
-				animations[animationIdx].keyFramesNr++;
-				delete[] keyFramesTimesBuffer;
-				unsigned int keyFramesNr = animations[animationIdx].keyFramesNr;
-
-				unsigned int channelsNr = animations[animationIdx].channelsNr;
-				animations[animationIdx].scales = new glm::vec3*[channelsNr];
-				animations[animationIdx].rots = new glm::quat*[channelsNr];
-				animations[animationIdx].translations = new glm::vec3*[channelsNr];
-				unsigned int nodeIdx = 0;
-				for (unsigned int channelIdx = 0; channelIdx < channelsNr; channelIdx++) {
-					while (!animations[animationIdx].TransformatsHierarchyBuffer[nodeIdx].isNodeAnimated)
-						nodeIdx++;
-					aiNodeAnim* channel = animation->mChannels[nodesToChannelsIdxsMap[nodeIdx++]];
-					animations[animationIdx].scales[channelIdx] = new glm::vec3[keyFramesNr];
-					animations[animationIdx].rots[channelIdx] = new glm::quat[keyFramesNr];
-					animations[animationIdx].translations[channelIdx] = new glm::vec3[keyFramesNr];
-					unsigned int channelScaleKeyFrameIdx = 0;
-					unsigned int channelRotKeyFrameIdx = 0;
-					unsigned int channelPosKeyFrameIdx = 0;
-					for (unsigned int keyFrameIdx = 0; keyFrameIdx < keyFramesNr; keyFrameIdx++) {
-						if (channelScaleKeyFrameIdx < channel->mNumScalingKeys) {
-							if (channel->mScalingKeys[channelScaleKeyFrameIdx].mTime < animations[animationIdx].keyFramesTimes[keyFrameIdx]) {
-								aiVectorKey& startKey = channel->mScalingKeys[channelScaleKeyFrameIdx - 1];
-								aiVectorKey& endKey = channel->mScalingKeys[channelScaleKeyFrameIdx];
-								animations[animationIdx].scales[channelIdx][keyFrameIdx] =
-									(assimp2glm(endKey.mValue) - assimp2glm(startKey.mValue)) * (float)((animations[animationIdx].keyFramesTimes[keyFrameIdx] - startKey.mTime) / (endKey.mTime - startKey.mTime));
-							}
-							else if (channel->mScalingKeys[channelScaleKeyFrameIdx].mTime == animations[animationIdx].keyFramesTimes[keyFrameIdx])
-								animations[animationIdx].scales[channelIdx][keyFrameIdx] = assimp2glm(channel->mScalingKeys[channelScaleKeyFrameIdx++].mValue);
-							else // channel->mScalingKeys[channelScaleKeyFrameIdx].mTime > (animations[animationIdx].keyFramesTimes[keyFrameIdx] == 0))
-								animations[animationIdx].scales[channelIdx][keyFrameIdx] = assimp2glm(channel->mScalingKeys[0].mValue);
-						}
-						else
-							animations[animationIdx].scales[channelIdx][keyFrameIdx] = assimp2glm(channel->mScalingKeys[channelScaleKeyFrameIdx - 1].mValue);
-
-						if (channelRotKeyFrameIdx < channel->mNumRotationKeys) {
-							if (channel->mRotationKeys[channelRotKeyFrameIdx].mTime < animations[animationIdx].keyFramesTimes[keyFrameIdx]) {
-								aiQuatKey& startKey = channel->mRotationKeys[channelRotKeyFrameIdx - 1];
-								aiQuatKey& endKey = channel->mRotationKeys[channelRotKeyFrameIdx];
-								animations[animationIdx].rots[channelIdx][keyFrameIdx] =
-									glm::slerp(assimp2glm(startKey.mValue), assimp2glm(endKey.mValue), (float)((animations[animationIdx].keyFramesTimes[keyFrameIdx] - startKey.mTime) / (endKey.mTime - startKey.mTime)));
-							}
-							else if (channel->mRotationKeys[channelRotKeyFrameIdx].mTime == animations[animationIdx].keyFramesTimes[keyFrameIdx])
-								animations[animationIdx].rots[channelIdx][keyFrameIdx] = assimp2glm(channel->mRotationKeys[channelRotKeyFrameIdx++].mValue);
-							else // channel->mRotationKeys[channelRotKeyFrameIdx].mTime > (animations[animationIdx].keyFramesTimes[keyFrameIdx] == 0))
-								animations[animationIdx].rots[channelIdx][keyFrameIdx] = assimp2glm(channel->mRotationKeys[0].mValue);
-						}
-						else
-							animations[animationIdx].rots[channelIdx][keyFrameIdx] = assimp2glm(channel->mRotationKeys[channelRotKeyFrameIdx - 1].mValue);
-
-						if (channelPosKeyFrameIdx < channel->mNumPositionKeys) {
-							if (channel->mPositionKeys[channelPosKeyFrameIdx].mTime < animations[animationIdx].keyFramesTimes[keyFrameIdx]) {
-								aiVectorKey& startKey = channel->mPositionKeys[channelScaleKeyFrameIdx - 1];
-								aiVectorKey& endKey = channel->mPositionKeys[channelScaleKeyFrameIdx];
-								animations[animationIdx].scales[channelIdx][keyFrameIdx] =
-									(assimp2glm(endKey.mValue) - assimp2glm(startKey.mValue)) * (float)((animations[animationIdx].keyFramesTimes[keyFrameIdx] - startKey.mTime) / (endKey.mTime - startKey.mTime));
-							}
-							else if (channel->mPositionKeys[channelPosKeyFrameIdx].mTime == animations[animationIdx].keyFramesTimes[keyFrameIdx])
-								animations[animationIdx].translations[channelIdx][keyFrameIdx] = assimp2glm(channel->mPositionKeys[channelPosKeyFrameIdx++].mValue);
-							else // channel->mPositionKeys[channelPosKeyFrameIdx].mTime > (animations[animationIdx].keyFramesTimes[keyFrameIdx] == 0))
-								animations[animationIdx].translations[channelIdx][keyFrameIdx] = assimp2glm(channel->mPositionKeys[0].mValue);
-						}
-						else
-							animations[animationIdx].translations[channelIdx][keyFrameIdx] = assimp2glm(channel->mPositionKeys[channelPosKeyFrameIdx - 1].mValue);
-					}
-				}
-			//}		
-		}
-	}
+	Renderer::ModelAnimator::ModelAnimator(ModelDescView const& modelDesc, unsigned int instancesNrMax) :
+			instanceAnimatorsPool(new ChunkedObjPool<InstanceAnimator>(instancesNrMax)),
+			animations(modelDesc) {}
 
 	Renderer::ModelAnimator::~ModelAnimator() {
-		for (unsigned int animationIdx = 0; animationIdx < animationsNr; animationIdx++) {
-			Animation& animation = animations[animationIdx];				
-			for (unsigned int channelIdx = 0; channelIdx < animation.channelsNr; channelIdx++) {
-				delete[] animation.scales[channelIdx];
-				delete[] animation.rots[channelIdx];
-				delete[] animation.translations[channelIdx];
-			}
-			delete[] animation.scales;
-			delete[] animation.rots;
-			delete[] animation.translations;
-			for (unsigned int nodeIdx = 0; nodeIdx < animation.nodesNr; nodeIdx++) {
-				if (animation.TransformatsHierarchyBuffer[nodeIdx].meshesNr)
-					delete[] animation.TransformatsHierarchyBuffer[nodeIdx].meshesIdxs;
-			}
-			delete[] animation.TransformatsHierarchyBuffer;
-			delete[] animation.keyFramesTimes;
-		}
-		delete[] animations;
-		delete[] bonesOffsets;
 		delete instanceAnimatorsPool;
 	}
 
-	Renderer::ModelAnimator::Animation::TransformatsHierarchyNode Renderer::ModelAnimator::genTransformatHierarchyNode(aiNode* node, const aiScene* scene, unsigned int animationIdx, unsigned int nodeToChannelIdxMapping) {
-		Animation::TransformatsHierarchyNode transformatsHierarchyNode;
-		transformatsHierarchyNode.transformat = assimp2glm(node->mTransformation);
-		transformatsHierarchyNode.childrenNr = node->mNumChildren;
-		transformatsHierarchyNode.children = new Animation::TransformatsHierarchyNode*[node->mNumChildren];
-		if (nodeToChannelIdxMapping < scene->mAnimations[animationIdx]->mNumChannels) {
-			aiNodeAnim* channel = scene->mAnimations[animationIdx]->mChannels[nodeToChannelIdxMapping];
-			transformatsHierarchyNode.isNodeAnimated = true; // channel->mNumScalingKeys > 1 || channel->mNumRotationKeys > 1 || channel->mNumPositionKeys > 1;
-			if (transformatsHierarchyNode.isNodeAnimated)
-				animations[animationIdx].channelsNr++;		
-		}
-		else
-			transformatsHierarchyNode.isNodeAnimated = false;			
-	
-		if (node->mNumMeshes) {
-			transformatsHierarchyNode.meshesNr = node->mNumMeshes;
-			transformatsHierarchyNode.meshesIdxs = new unsigned int[node->mNumMeshes];
-			memcpy(transformatsHierarchyNode.meshesIdxs, node->mMeshes, node->mNumMeshes * sizeof(unsigned int));		
-		}
-		else {
-			transformatsHierarchyNode.meshesNr = 0;
-			unsigned int boneIdxOverall = 0;
-			for (unsigned meshIdx = 0; meshIdx < scene->mNumMeshes; meshIdx++) {
-				for (unsigned int boneIdx = 0; boneIdx < scene->mMeshes[meshIdx]->mNumBones; boneIdx++) {
-					if (scene->mMeshes[meshIdx]->mBones[boneIdx]->mName == node->mName) {					
-						transformatsHierarchyNode.boneIdx = boneIdxOverall;
-						return transformatsHierarchyNode;
-					}
-					boneIdxOverall++;
-				}
-			}
-		}
-			
-		transformatsHierarchyNode.boneIdx = std::numeric_limits<unsigned int>::max();
-		return transformatsHierarchyNode;
-	}
-
 	Renderer::InstanceAnimator* Renderer::ModelAnimator::acquireInstance(unsigned int instanceIdx) {
 		return instanceAnimatorsPool->acquire(*this, instanceIdx);
 	}
@@ -1897,127 +1240,36 @@ namespace Corium3D {
 
 	Renderer::InstanceAnimator::InstanceAnimator(ModelAnimator& modelAnimator, unsigned int _instanceIdx) :
 			modelAnimator(modelAnimator), 
-			bonesTransformatsBufferInstanceBaseIdx(modelAnimator.bonesTransformatsBufferModelBaseIdx + _instanceIdx *modelAnimator.bonesNr),
-			animation(modelAnimator.animations[0]), 
+			animationIdx(0), 
 			activeAnimationStartTime(ServiceLocator::getTimer().getCurrentTime()),
 			endKeyFrameIdxCache(1),
-			childrenIdxsStack(new unsigned int[animation.treeDepthMax]()),
-			transformatsStack(new glm::mat4[animation.treeDepthMax + 2]()),
 			instanceIdx(_instanceIdx) {}
 
-	Renderer::InstanceAnimator::~InstanceAnimator() {
-		delete[] childrenIdxsStack;
-		delete[] transformatsStack;
-	}
-
-	void Renderer::InstanceAnimator::start(unsigned int animationIdx) {
-		animation = modelAnimator.animations[animationIdx];
+	void Renderer::InstanceAnimator::start(unsigned int _animationIdx) {
+		animationIdx = _animationIdx;
 		activeAnimationStartTime = (float)ServiceLocator::getTimer().getCurrentTime();	
 		endKeyFrameIdxCache = 1;
 	}
 
-	/*
-		glm::mat4 inverseBindTransform = assimp2glm(scene->mRootNode->mTransformation); //glm::inverse(
-		aiMesh* sceneFirstMesh = scene->mMeshes[0];
-		glm::mat4 armature = assimp2glm(scene->mRootNode->mChildren[0]->mTransformation);
-		currFrame = (currFrame + 1) % 3;
-
-		glm::mat4 base = armature * calcKeyframeTransformat(scene->mAnimations[0]->mChannels[0]);
-		bonesTransformsPtr[0] = inverseBindTransform * base * assimp2glm(sceneFirstMesh->mBones[0]->mOffsetMatrix);
-		glm::mat4 second = base * calcKeyframeTransformat(scene->mAnimations[0]->mChannels[1]);
-		bonesTransformsPtr[1] = inverseBindTransform * second * assimp2glm(sceneFirstMesh->mBones[1]->mOffsetMatrix);
-		glm::mat4 third = second * calcKeyframeTransformat(scene->mAnimations[0]->mChannels[2]);
-		bonesTransformsPtr[2] = inverseBindTransform * third * assimp2glm(sceneFirstMesh->mBones[2]->mOffsetMatrix);
-		glm::mat4 fourth = third * calcKeyframeTransformat(scene->mAnimations[0]->mChannels[3]);
-		bonesTransformsPtr[3] = inverseBindTransform * fourth * assimp2glm(sceneFirstMesh->mBones[3]->mOffsetMatrix);
-
-
-		glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-		delete importer;
-	*/
-
 	// derived from: ( ((1-t)^3)*(0,0) + 3*((1-t)^2)*t*(0.25,0) + 3*(1-t)*(t^2)*(0.75,1) + (t^3)*(1,1) ).y
 	inline float bezierify(float t) {	
 		return t*t*(3 - 2*t);
 	}
 
-	void Renderer::InstanceAnimator::updateRendererBuffer() {
-		glm::mat4* bonesTransformsPtr = NULL;
-		if (modelAnimator.bonesNr) {
-			glBindBuffer(GL_SHADER_STORAGE_BUFFER, modelAnimator.bonesTransformatsBuffer);
-			bonesTransformsPtr = (glm::mat4*)glMapBufferRange(GL_SHADER_STORAGE_BUFFER, sizeof(glm::mat4) * bonesTransformatsBufferInstanceBaseIdx, sizeof(glm::mat4) * modelAnimator.bonesNr, GL_MAP_WRITE_BIT);
-		}
-
-		double currAnimationTime = fmod(ServiceLocator::getTimer().getCurrentTime() - activeAnimationStartTime, animation.dur) * animation.ticksPerSecond;	
-		if (currAnimationTime < animation.keyFramesTimes[1])
-			endKeyFrameIdxCache = 1;
-		while (animation.keyFramesTimes[endKeyFrameIdxCache] < currAnimationTime)	
-			endKeyFrameIdxCache++;	
-		
-		float interpolationFactor = (currAnimationTime - animation.keyFramesTimes[endKeyFrameIdxCache - 1]) / (animation.keyFramesTimes[endKeyFrameIdxCache] - animation.keyFramesTimes[endKeyFrameIdxCache - 1]);
+	PosesEvaluator::Pose Renderer::InstanceAnimator::genPose(double currTime, glm::mat4* bonesTransformsPtr) {
+		ModelAnimations const& animations = modelAnimator.animations;
+		double currAnimationTime = fmod(currTime - activeAnimationStartTime, animations.getAnimationDur(animationIdx)) * animations.getAnimationTicksPerSecond(animationIdx);
+		float interpolationFactor = animations.locateKeyFrames(animationIdx, currAnimationTime, endKeyFrameIdxCache);
 		if (instanceIdx == 0)
 			interpolationFactor = bezierify(interpolationFactor);
-		
-		ModelAnimator::Animation::TransformatsHierarchyNode* nodesIt = animation.TransformatsHierarchyBuffer;
-		unsigned int channelIt = 0;	
-		unsigned int depth = 0;		
-		while (1) {
-			while (1) {
-				if (nodesIt->isNodeAnimated) {
-					glm::vec3 scale = animation.scales[channelIt][endKeyFrameIdxCache - 1] * (1 - interpolationFactor) + animation.scales[channelIt][endKeyFrameIdxCache] * interpolationFactor;
-					glm::quat rot = glm::slerp(animation.rots[channelIt][endKeyFrameIdxCache - 1], animation.rots[channelIt][endKeyFrameIdxCache], interpolationFactor);
-					glm::vec3 translation = animation.translations[channelIt][endKeyFrameIdxCache - 1] * (1 - interpolationFactor) + animation.translations[channelIt][endKeyFrameIdxCache] * interpolationFactor;				
-					transformatsStack[depth + 1] = transformatsStack[depth] * glm::translate(translation) * glm::mat4_cast(rot) * glm::scale(scale);												
-					channelIt++;
-				
-					if (nodesIt->boneIdx != std::numeric_limits<unsigned int>::max())
-						bonesTransformsPtr[nodesIt->boneIdx] = transformatsStack[depth + 1] * modelAnimator.bonesOffsets[nodesIt->boneIdx];				
-				}
-				else
-					transformatsStack[depth + 1] = transformatsStack[depth] * nodesIt->transformat;				
-			
-				if (nodesIt->boneIdx == std::numeric_limits<unsigned int>::max() && nodesIt->meshesNr) {
-					for (unsigned int meshIdx = 0; meshIdx < nodesIt->meshesNr; meshIdx++)
-						modelAnimator.meshesTransformsBuffer[nodesIt->meshesIdxs[meshIdx]] = transformatsStack[depth + 1];
-				}			 
-
-				if (childrenIdxsStack[depth] < nodesIt->childrenNr) {
-					nodesIt = nodesIt->children[childrenIdxsStack[depth]];
-					childrenIdxsStack[depth]++;
-					depth++;
-				}
-				else
-					break;
-			}	
-
-			do {
-				nodesIt = nodesIt->parent;
-				childrenIdxsStack[depth] = 0;
-				depth--;			
-			} while (nodesIt && childrenIdxsStack[depth] == nodesIt->childrenNr);
-
-			if (nodesIt) {
-				nodesIt = nodesIt->children[childrenIdxsStack[depth]];
-				childrenIdxsStack[depth]++;
-				depth++;
-			}
-			else
-				break;
-		}
-
-		//for (unsigned int depthIdx = 0; depthIdx < animation.treeDepthMax; depthIdx++)
-		//	childrenIdxsStack[depthIdx] = 0;
-
-		if (modelAnimator.bonesNr)
-			glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-	}
-
-	inline void Renderer::Plane::updateD(glm::vec3 const& newPointOnPlane) {
-		d = -glm::dot(normal, newPointOnPlane);
-	}
 
-	inline float Renderer::Plane::signedDistFromPoint(glm::vec3 const& point) const {
-		return glm::dot(normal, point) + d;
+		PosesEvaluator::Pose pose;
+		pose.modelAnimations = &animations;
+		pose.query.animationIdx = animationIdx;
+		pose.query.endKeyFrameIdx = endKeyFrameIdxCache;
+		pose.query.interpolationFactor = interpolationFactor;
+		pose.query.bonesTransformats = bonesTransformsPtr;
+		return pose;
 	}
 
 } // namespace Corium3D
@@ -5,14 +5,23 @@
 #pragma once
 
 #include "SystemDefs.h"
-#include "ObjPool.h"
+#include "ChunkedObjPool.h"
 #include "BoundingSphere.h"
 #include "AABB.h"
 #include "BVH.h"
+#include "DrawListBuilder.h"
+#include "InstancesRanges.h"
+#include "PosesEvaluator.h"
+#include "DirtyRanges.h"
+#include "FrameRing.h"
+#include "IndirectCommandsGenerator.h"
 #include "OpenGL.h"
 #include "GUI.h"
 #include "AssetsOps.h"
+#include "MappedAssets.h"
+#include "MemoryReport.h"
 #include <glm/glm.hpp>
+#include <atomic>
 #include <math.h>
 
 namespace Corium3D {
@@ -25,7 +34,6 @@ namespace Corium3D {
 	const int DEPTH_SZ = 8;
 	const int STENCIL_SZ = 8;
 
-	const unsigned int BONES_NR_PER_VERTEX_MAX = 4;
 
 	constexpr GLfloat BKG_COLOR_R = 100.0f / 256;
 	constexpr GLfloat BKG_COLOR_G = 149.0f / 256;
@@ -41,6 +49,14 @@ namespace Corium3D {
 	const glm::vec3 CAMERA_LOOK_DIRECTION_INIT(0.0f, 0.0f, -1.0f);
 
 	const unsigned int FRAMES_NR_FOR_FPS_UPDATE = 20;
+	// the debug geometry buffer's initial capacity - it grows to fit the frame's geometry
+	const unsigned int DEBUG_VERTICES_NR_INIT = 1000;
+	// clean transformats between dirty ones that are reuploaded along rather than split into another upload
+	const unsigned int STATIC_TRANSFORMATS_UPLOAD_GAP_MAX = 16;
+	// the frames the CPU may write ahead of the GPU - the frame ring's regions
+	const unsigned int FRAME_RING_REGIONS_NR = 3;
+	// nanoseconds. a frame ring region's fence is waited on in slices of it
+	const GLuint64 FRAME_RING_FENCE_WAIT_TIMEOUT = 1000000;
 
 	class Renderer {
 	public:
@@ -55,7 +71,7 @@ namespace Corium3D {
 		bool init(Corium3DEngineNativeWindowType window);
 		void destroy();
 		bool surfaceSzChanged(unsigned int width, unsigned int height);
-		void loadScene(std::vector<ModelDesc>&& modelDescs, unsigned int staticModelDescsNr, unsigned int mobileModelDescsNr, unsigned int* modelsInstancesNrsMaxima, BVH& bvh);
+		void loadScene(std::vector<ModelDescView>&& modelDescs, unsigned int staticModelDescsNr, unsigned int mobileModelDescsNr, unsigned int* modelsInstancesNrsMaxima, BVH& bvh);
 		void unloadScene();
 		void translateCamera(glm::vec3 const& translation);
 		void resetCameraPivot();
@@ -76,37 +92,47 @@ namespace Corium3D {
 		unsigned int getWinHeight() const { return winHeight; }
 
 		// REMINDER: modelIdx relates to indexing according to order given to Renderer with static models first
+		// the transformats are uploaded on the next render() - the ones set since the last one are coalesced into as few
+		// uploads as possible, so there is no need for setting them in batches
 		void setStaticModelInstanceTransform(unsigned int modelIdx, unsigned int instanceIdx, glm::mat4 const& transformat);
+		// for the model's instances indices to go up to instancesNrMax - 1. the instances' buffers are resized on the next render()
+		void setModelInstancesNrMax(unsigned int modelIdx, unsigned int instancesNrMax);
+		// the model's instances hide what is behind them from the camera. of static models only
+		void setModelOccluder(unsigned int modelIdx, bool isOccluder);
 		// TODO: Adopt into Material implementation	
 		void changeModelInstanceColorsArr(unsigned int modelIdx, unsigned int instanceIdx, unsigned int meshIdx, unsigned int colorsArrIdx);
 		InstanceAnimationInterface* activateAnimation(unsigned int modelIdx, unsigned int instanceIdx);
 		void deactivateAnimation(InstanceAnimationInterface* instanceAnimatorAPI);
 
 		bool render(double lag);
+		// the visible nodes' AABBs and the contact manifolds, drawn as lines and points over the scene
+		void setDebugGeometryRendering(bool isOn) { isDebugGeometryOn.store(isOn, std::memory_order_relaxed); }
+		// the last frame's
+		DrawListBuilder::Stats getDrawListStats() const { return drawListBuilder ? drawListBuilder->getStats(MAIN_VIEW_IDX) : DrawListBuilder::Stats(); }
+		// the GL buffers' sizes are the ones the renderer requested - reported once a scene is loaded
+		void reportMemory(Corium3DUtils::MemoryReport& memoryReport) const;
 
 	private:
 		class OpenGlContext;
-		class VisibleNodesIt3D;
-		class NodesIt2D;
 		class ModelAnimator;
 		class InstanceAnimator;
 
-		struct Plane {
-			glm::vec3 normal;
-			float d;
-
-			void updateD(glm::vec3 const& newPointOnPlane);
-			float signedDistFromPoint(glm::vec3 const& point) const;
-		};
+		typedef ViewFrustum::Plane Plane;
 
 		OpenGlContext* openGlContext;
-		VisibleNodesIt3D* visibleNodesIt3D;
-		NodesIt2D* nodesIt2D;
+		// the camera's - the only view rendered for now
+		static const unsigned int MAIN_VIEW_IDX = 0;
+		DrawListBuilder* drawListBuilder = NULL;
+		Corium3DUtils::ThreadPool* cullingThreadPool;
+		// the animated instances' poses are evaluated on cullingThreadPool as well
+		PosesEvaluator* posesEvaluator = NULL;
+		std::atomic<bool> isDebugGeometryOn{ false };
 
 		unsigned int winWidth = 0;
 		unsigned int winHeight = 0;
 		bool needReinitGlLmnts = true;
 		bool needReloadGlBuffers = false;
+		bool needReloadInstancesBuffers = false;
 		bool isSceneLoaded = false;
 
 		BVH* bvh = NULL;
@@ -121,33 +147,54 @@ namespace Corium3D {
 		std::string* vertexShadersFullPaths;
 		std::string* fragShadersFullPaths;
 		unsigned int shadersNr;
-		std::vector<ModelDesc> modelDescsBuffer;
+		std::vector<ModelDescView> modelDescsBuffer; // views into the loaded scene's MappedAssets - valid until the scene is unloaded
 		unsigned int staticModelsNr;
 		unsigned int mobileModelsNr;
 		unsigned int modelsNrTotal;		
-		unsigned int* modelsInstancesNrsMaxima;		
+		InstancesRanges* instancesRanges = NULL;
 		unsigned int verticesNrTotal;
-		unsigned int instancesNrsMaximaMax;
 		unsigned int staticInstancesNrMax;
-		unsigned int bonesInstancedNrMax;
 		unsigned int facesNrTotal;
+		unsigned int lodsIdxsNrTotal;
 		unsigned int verticesColorsNrTotal;
 		unsigned int*** verticesColorsBaseIdxs;
 
-		unsigned int* instancesBaseIdxsPerModel;
-
 		std::string* vertexShaderCodesBuffer;
 		std::string* fragShaderCodesBuffer;
 
-		GLuint instanceDataIdxsBuffer;
+		// a visible instance's per instance attributes. transformatIdx is into mvpMatsBuffer, or into the frame's region
+		// (in mat4s) when FRAME_TRANSFORMAT_FLAG is set. bonesTransformsBaseIdx is into the frame's region (in mat4s)
+		struct InstanceDataRecord {
+			unsigned int transformatIdx;
+			unsigned int bonesTransformsBaseIdx;
+		};
+		static const unsigned int FRAME_TRANSFORMAT_FLAG = 0x80000000;
+
+		// the frames' dynamic data - the visible instances' data records, the mobile ones' transformats, the bones palettes
+		// and the indirect draw commands. persistently mapped and written in place, a region per frame in flight
+		GLuint frameRingBuffer = 0;
+		char* frameRingBufferPtr = NULL;
+		Corium3DUtils::FrameRing* frameRing = NULL;
+		GLsync frameRingFences[FRAME_RING_REGIONS_NR] = {};
+		// the first of each model's records this frame, in records (NO_BASE_INSTANCE - none were written)
+		std::vector<unsigned int> frameModelsBaseInstances;
+		// the frame's visible animated instances' poses, of the models with bones
+		std::vector<PosesEvaluator::Pose> framePoses;
+		IndirectCommandsGenerator indirectCommandsGenerator;
+		// of all the models' levels of detail
+		unsigned int meshesNrTotal;
 		GLuint vertexBuffer;
+		// the static instances' transformats. the mobile ones' are written into the frame ring
 		GLuint mvpMatsBuffer;
-		GLuint bonesTransformsBaseIdxsBuffer;
-		GLuint bonesTransformsBuffer;
+		std::vector<glm::mat4> staticTransformatsShadow;
+		Corium3DUtils::DirtyRanges staticTransformatsDirtyRanges{ STATIC_TRANSFORMATS_UPLOAD_GAP_MAX };
 		GLuint selectedVerticesColorsIdxsBuffer;
+		std::vector<unsigned int> selectedVerticesColorsIdxsShadow;
 		GLuint verticesColorsBuffer;
 		GLuint indicesBuffer;
 		GLuint* vaos;
+		GLuint* instanceDataIdxAttribLocs;
+		GLuint* bonesTransformsBaseIdxAttribLocs;
 		GLuint* progs;
 		GLuint* vertexShaders;
 		GLuint* fragShaders;
@@ -158,20 +205,12 @@ namespace Corium3D {
 		//GLuint* texSamplerUnifLocs;
 		GLuint vpMatAttribLoc;
 		GLuint meshTransformUniformLoc;
-		glm::mat4* meshesTransformsBuffer;
 
 		//<<TUNABLE SECTION>>
 		//(*) Implementation for few sphoradic colors updates chosen among many per vertex colors arrays
 		//TODO: Rename all of this (?)
 		//unsigned int** instanceColorsIdxs;
 
-		unsigned int** visibleStaticModelsInstancesIdxs;
-		unsigned int* visibleStaticModelsInstancesNrs;
-
-		glm::mat4** mobileModelsTransformatsBuffers;
-		unsigned int** visibleMobileModelsInstancesIdxs;
-		unsigned int* visibleMobileModelsInstancesNrs;
-
 		ModelAnimator** modelsAnimators;
 		InstanceAnimator*** instancesAnimators;
 
@@ -211,8 +250,8 @@ namespace Corium3D {
 		////////////////////////////
 		GLuint debugVAO;
 		GLuint debugVertexBuffer;
+		unsigned int debugVerticesCapacity;
 		GLuint debugVpMatBuffer;
-		GLuint debugIndicesBuffer;
 		GLuint debugProg;
 		GLuint debugVertexShader;
 		GLuint debugFragShader;
@@ -227,8 +266,16 @@ namespace Corium3D {
 		void updateFrustumSidePlanesNormals();
 		bool initOpenGlLmnts();
 		bool loadOpenGlBuffers();
+		bool loadInstancesBuffers();
 		void destroyOpenGlLmnts();
-		bool isBoundingSphereVisible(BoundingSphere const& boundingSphere) const;
+		ViewFrustum getViewFrustum() const;
+		bool createFrameRing();
+		void destroyFrameRing();
+		void waitForFrameRingRegion();
+		void writeFrameInstancesData();
+		bool submitFrameDraws();
+		void renderDebugGeometry();
+		void uploadDirtyStaticTransformats();
 	};
 
 	class Renderer::InstanceAnimationInterface {
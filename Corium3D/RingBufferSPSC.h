@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <stdexcept>
+
+namespace Corium3DUtils {
+
+	// REMINDER: Safe for exactly one producer thread and one consumer thread.
+	//			 Capacity is rounded up to a power of 2.
+	template <class T>
+	class RingBufferSPSC {
+	public:
+		struct Stats {
+			unsigned long long pushedNr;
+			unsigned long long droppedNr;
+			unsigned int occupancyMax;
+		};
+
+		RingBufferSPSC(unsigned int capacity);
+		RingBufferSPSC(RingBufferSPSC const&) = delete;
+		~RingBufferSPSC();
+		// producer side - returns false (and counts the drop) when the buffer is full
+		bool push(T const& lmnt);
+		// consumer side
+		bool pop(T& lmntOut);
+		// consumer side - the number of elements that can be popped right now.
+		// Elements pushed after this call are not included, which lets the consumer drain in batches.
+		unsigned int getAvailableNr() const;
+		unsigned int getCapacity() const { return capacity; }
+		Stats getStats() const;
+		void resetStats();
+
+	private:
+		// keeps the producer's and consumer's indices on separate cache lines. padded rather than aligned - an over-aligned
+		// member would over-align the buffer's holders, which C++14's new does not honor
+		static const unsigned int CACHE_LINE_SZ = 64;
+
+		const unsigned int capacity;
+		const unsigned int idxMask;
+		T* lmnts;
+
+		char writeIdxPadding[CACHE_LINE_SZ];
+		std::atomic<unsigned int> writeIdx;
+		std::atomic<unsigned long long> pushedNr;
+		std::atomic<unsigned long long> droppedNr;
+		std::atomic<unsigned int> occupancyMax;
+		char readIdxPadding[CACHE_LINE_SZ];
+		std::atomic<unsigned int> readIdx;
+		char tailPadding[CACHE_LINE_SZ];
+
+		static unsigned int roundUpToPow2(unsigned int val);
+	};
+
+	template <class T>
+	RingBufferSPSC<T>::RingBufferSPSC(unsigned int _capacity) :
+		capacity(roundUpToPow2(_capacity)), idxMask(capacity - 1), lmnts(new T[capacity]),
+		writeIdx(0), pushedNr(0), droppedNr(0), occupancyMax(0), readIdx(0) {}
+
+	template <class T>
+	RingBufferSPSC<T>::~RingBufferSPSC() {
+		delete[] lmnts;
+	}
+
+	template <class T>
+	bool RingBufferSPSC<T>::push(T const& lmnt) {
+		unsigned int currWriteIdx = writeIdx.load(std::memory_order_relaxed);
+		unsigned int occupancy = currWriteIdx - readIdx.load(std::memory_order_acquire);
+		if (occupancy == capacity) {
+			droppedNr.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		lmnts[currWriteIdx & idxMask] = lmnt;
+		writeIdx.store(currWriteIdx + 1, std::memory_order_release);
+		pushedNr.fetch_add(1, std::memory_order_relaxed);
+		if (occupancy + 1 > occupancyMax.load(std::memory_order_relaxed))
+			occupancyMax.store(occupancy + 1, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	template <class T>
+	bool RingBufferSPSC<T>::pop(T& lmntOut) {
+		unsigned int currReadIdx = readIdx.load(std::memory_order_relaxed);
+		if (currReadIdx == writeIdx.load(std::memory_order_acquire))
+			return false;
+
+		lmntOut = lmnts[currReadIdx & idxMask];
+		readIdx.store(currReadIdx + 1, std::memory_order_release);
+		return true;
+	}
+
+	template <class T>
+	unsigned int RingBufferSPSC<T>::getAvailableNr() const {
+		return writeIdx.load(std::memory_order_acquire) - readIdx.load(std::memory_order_relaxed);
+	}
+
+	template <class T>
+	typename RingBufferSPSC<T>::Stats RingBufferSPSC<T>::getStats() const {
+		return { pushedNr.load(std::memory_order_relaxed), droppedNr.load(std::memory_order_relaxed), occupancyMax.load(std::memory_order_relaxed) };
+	}
+
+	template <class T>
+	void RingBufferSPSC<T>::resetStats() {
+		pushedNr.store(0, std::memory_order_relaxed);
+		droppedNr.store(0, std::memory_order_relaxed);
+		occupancyMax.store(0, std::memory_order_relaxed);
+	}
+
+	template <class T>
+	unsigned int RingBufferSPSC<T>::roundUpToPow2(unsigned int val) {
+		if (val == 0)
+			throw std::invalid_argument("RingBufferSPSC capacity has to be positive.");
+
+		unsigned int pow2 = 1;
+		while (pow2 < val)
+			pow2 <<= 1;
+
+		return pow2;
+	}
+
+} // namespace Corium3DUtils
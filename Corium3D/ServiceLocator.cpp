@@ -5,7 +5,7 @@ using namespace Corium3DUtils;
 namespace Corium3D {
 
 	Logger ServiceLocator::logger = Logger();
-	Timer ServiceLocator::timer = Timer();
+	Timer ServiceLocator::timer;
 	Randomizer ServiceLocator::randomizer = Randomizer(ServiceLocator::timer);
 
 } // namespace Corium3D
@@ -0,0 +1,88 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace Corium3DUtils {
+
+	ThreadPool::ThreadPool(unsigned int threadsNr) : nextTaskIdx(0) {
+		if (threadsNr == 0)
+			threadsNr = std::max(std::thread::hardware_concurrency(), 1u);
+		for (unsigned int workerIdx = 0; workerIdx + 1 < threadsNr; workerIdx++)
+			workers.emplace_back(&ThreadPool::work, this);
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			isShuttingDown = true;
+		}
+		jobPostedCond.notify_all();
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+
+	void ThreadPool::parallelFor(unsigned int _tasksNr, std::function<void(unsigned int taskIdx)> const& _task) {
+		if (_tasksNr == 0)
+			return;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			// workers that woke up to the previous job only after it was done are still to leave it
+			jobDoneCond.wait(lock, [this]() { return busyWorkersNr == 0; });
+			task = &_task;
+			tasksNr = _tasksNr;
+			nextTaskIdx = 0;
+			thrownTaskIdx = _tasksNr;
+			thrownException = NULL;
+			jobGeneration++;
+		}
+		jobPostedCond.notify_all();
+
+		runTasks();
+
+		std::exception_ptr exception;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			jobDoneCond.wait(lock, [this]() { return busyWorkersNr == 0; });
+			exception = thrownException;
+			thrownException = NULL;
+		}
+		if (exception)
+			std::rethrow_exception(exception);
+	}
+
+	void ThreadPool::work() {
+		unsigned int doneJobGeneration = 0;
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			jobPostedCond.wait(lock, [this, doneJobGeneration]() { return isShuttingDown || jobGeneration != doneJobGeneration; });
+			if (isShuttingDown)
+				return;
+
+			doneJobGeneration = jobGeneration;
+			busyWorkersNr++;
+			lock.unlock();
+			runTasks();
+			lock.lock();
+			if (--busyWorkersNr == 0)
+				jobDoneCond.notify_all();
+		}
+	}
+
+	void ThreadPool::runTasks() {
+		// REMINDER: nextTaskIdx is reset only while no worker is busy, so a worker late to a done job never gets to its task
+		for (unsigned int taskIdx = nextTaskIdx++; taskIdx < tasksNr; taskIdx = nextTaskIdx++) {
+			try {
+				(*task)(taskIdx);
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> lock(mutex);
+				if (taskIdx < thrownTaskIdx) {
+					thrownTaskIdx = taskIdx;
+					thrownException = std::current_exception();
+				}
+			}
+		}
+	}
+
+} // namespace Corium3DUtils
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Corium3DUtils {
+
+	// A fixed set of worker threads running index ranged jobs. The calling thread takes part in the work and parallelFor()
+	// returns only once every task has run, so tasks may reference the caller's stack.
+	// REMINDER: One parallelFor() at a time - it is not reentrant and not to be called from several threads at once.
+	class ThreadPool {
+	public:
+		// threadsNr counts the caller in. 0 - as many as there are hardware threads
+		ThreadPool(unsigned int threadsNr = 0);
+		ThreadPool(ThreadPool const&) = delete;
+		~ThreadPool();
+		// runs task(taskIdx) for every taskIdx in [0, tasksNr), in no particular order. If tasks throw, the exception of the
+		// lowest throwing taskIdx is rethrown after all of the tasks ran, so the outcome does not depend on the scheduling.
+		void parallelFor(unsigned int tasksNr, std::function<void(unsigned int taskIdx)> const& task);
+		// the caller included
+		unsigned int getThreadsNr() const { return workers.size() + 1; }
+
+	private:
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable jobPostedCond;
+		std::condition_variable jobDoneCond;
+		bool isShuttingDown = false;
+		unsigned int jobGeneration = 0;
+		unsigned int busyWorkersNr = 0;
+
+		std::function<void(unsigned int)> const* task = NULL;
+		unsigned int tasksNr = 0;
+		std::atomic<unsigned int> nextTaskIdx;
+		unsigned int thrownTaskIdx = 0;
+		std::exception_ptr thrownException;
+
+		void work();
+		void runTasks();
+	};
+
+} // namespace Corium3DUtils
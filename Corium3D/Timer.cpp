@@ -1,24 +1,68 @@
 #include "Timer.h"
+#include <thread>
+#include <chrono>
 
-#if defined(__ANDROID__) || defined(ANDROID)
-	#include <Time.h>
-#elif defined(_WIN32) || defined(__VC32__) && !defined(__CYGWIN__) && !defined(__SCITECH_SNAP__) /* Win32 and WinCE */
+#if defined(_WIN32) || defined(__VC32__) && !defined(__CYGWIN__) && !defined(__SCITECH_SNAP__) /* Win32 and WinCE */
 	#include <Windows.h>
+#else /* Android, Linux and other POSIX systems */
+	#include <time.h>
 #endif
 
 namespace Corium3DUtils {
 
-	Timer::Timer() {}
+	Timer::Timer() : isFakeClock(false), fakeTimeNs(0) {}
 
-#if defined(__ANDROID__) || defined(ANDROID)
+	double Timer::getCurrentTime() const {
+		return (double)getCurrentTimeNs() / NS_PER_SEC;
+	}
 
-	long long Timer::getCurrentTime(void) const {
-		struct timespec res;
-		clock_gettime(CLOCK_REALTIME, &res);
-		return res.tv_sec + res.tv_nsec / 1000000000;
+	long long Timer::getCurrentTimeNs() const {
+		if (isFakeClock.load(std::memory_order_acquire))
+			return fakeTimeNs.load(std::memory_order_acquire);
+		else
+			return getSystemTimeNs();
+	}
+
+	void Timer::sleepUntil(long long timeNs) const {
+		if (isFakeClock.load(std::memory_order_acquire)) {
+			long long currFakeTimeNs = fakeTimeNs.load(std::memory_order_relaxed);
+			while (currFakeTimeNs < timeNs && !fakeTimeNs.compare_exchange_weak(currFakeTimeNs, timeNs, std::memory_order_acq_rel));
+			return;
+		}
+
+		long long remainingNs = timeNs - getSystemTimeNs();
+		if (remainingNs > SLEEP_SPIN_MARGIN_NS)
+			std::this_thread::sleep_for(std::chrono::nanoseconds(remainingNs - SLEEP_SPIN_MARGIN_NS));
+		while (getSystemTimeNs() < timeNs)
+			std::this_thread::yield();
 	}
 
-#elif defined(_WIN32) || defined(__VC32__) && !defined(__CYGWIN__) && !defined(__SCITECH_SNAP__) /* Win32 and WinCE */
+	void Timer::enableFakeClock(long long startTimeNs) {
+		fakeTimeNs.store(startTimeNs, std::memory_order_release);
+		isFakeClock.store(true, std::memory_order_release);
+	}
+
+	void Timer::disableFakeClock() {
+		isFakeClock.store(false, std::memory_order_release);
+	}
+
+	void Timer::advanceFakeClock(long long deltaNs) {
+		fakeTimeNs.fetch_add(deltaNs, std::memory_order_acq_rel);
+	}
+
+	UpdatesPacer::UpdatesPacer(Timer const& _timer, long long _nsPerUpdate) : timer(_timer), nsPerUpdate(_nsPerUpdate), frameStartNs(_timer.getCurrentTimeNs()) {}
+
+	unsigned int UpdatesPacer::beginFrame() {
+		long long currentNs = timer.getCurrentTimeNs();
+		lagNs += currentNs - frameStartNs;
+		frameStartNs = currentNs;
+		unsigned int updatesNr = (unsigned int)(lagNs / nsPerUpdate);
+		lagNs -= updatesNr * nsPerUpdate;
+
+		return updatesNr;
+	}
+
+#if defined(_WIN32) || defined(__VC32__) && !defined(__CYGWIN__) && !defined(__SCITECH_SNAP__) /* Win32 and WinCE */
 
 	inline long long initPerformanceFreq() {
 		LARGE_INTEGER performanceFreq;
@@ -26,14 +70,22 @@ namespace Corium3DUtils {
 		return performanceFreq.QuadPart;
 	}
 
-	// returns time in seconds
-	double Timer::getCurrentTime(void) const {
+	long long Timer::getSystemTimeNs() const {
 		static const long long performanceFreq(initPerformanceFreq());
 		LARGE_INTEGER time;
 		QueryPerformanceCounter(&time);
-		return (double)time.QuadPart / performanceFreq;
+		// split to whole seconds and remainder so that the multiplication can't overflow
+		return (time.QuadPart / performanceFreq) * NS_PER_SEC + (time.QuadPart % performanceFreq) * NS_PER_SEC / performanceFreq;
+	}
+
+#else
+
+	long long Timer::getSystemTimeNs() const {
+		struct timespec res;
+		clock_gettime(CLOCK_MONOTONIC, &res);
+		return (long long)res.tv_sec * NS_PER_SEC + res.tv_nsec;
 	}
 
 #endif
 
-} // namespace Corium3DUtils
\ No newline at end of file
+} // namespace Corium3DUtils
@@ -4,12 +4,57 @@
 
 #pragma once
 
+#include <atomic>
+
 namespace Corium3DUtils {
 
+	// Monotonic clock with nanosecond resolution.
+	// In fake clock mode time only moves through advanceFakeClock/sleepUntil, which makes runs deterministic.
 	class Timer {
 	public:
+		static const long long NS_PER_SEC = 1000000000LL;
+
 		Timer();
+		Timer(Timer const&) = delete;
+		// returns time in seconds
 		double getCurrentTime() const;
+		long long getCurrentTimeNs() const;
+		// blocks the calling thread until getCurrentTimeNs() >= timeNs (returns immediately when timeNs already passed)
+		void sleepUntil(long long timeNs) const;
+		void enableFakeClock(long long startTimeNs = 0);
+		void disableFakeClock();
+		void advanceFakeClock(long long deltaNs);
+		bool isFakeClockEnabled() const { return isFakeClock.load(std::memory_order_acquire); }
+
+	private:
+		// sleeping is coarse (~1ms on most kernels, up to ~15ms on Windows) - the last stretch before the deadline is yield-spun
+		static const long long SLEEP_SPIN_MARGIN_NS = 2000000LL;
+
+		std::atomic<bool> isFakeClock;
+		// REMINDER: mutable so that sleepUntil can stay const in fake clock mode
+		mutable std::atomic<long long> fakeTimeNs;
+
+		long long getSystemTimeNs() const;
+	};
+
+	// Paces a loop of fixed step updates: the time passed since the last frame is accumulated and consumed in whole steps -
+	// the frame's updates - and the remainder is the lag the frame's render interpolates over.
+	class UpdatesPacer {
+	public:
+		UpdatesPacer(Timer const& timer, long long nsPerUpdate);
+		// returns the number of updates due this frame
+		unsigned int beginFrame();
+		long long getLagNs() const { return lagNs; }
+		// the time at which the frame after this one has an update due
+		long long getNextUpdateTimeNs() const { return frameStartNs + nsPerUpdate - lagNs; }
+		// instead of spinning through frames without updates
+		void sleepUntilNextUpdate() const { timer.sleepUntil(getNextUpdateTimeNs()); }
+
+	private:
+		Timer const& timer;
+		const long long nsPerUpdate;
+		long long frameStartNs;
+		long long lagNs = 0;
 	};
 
 } // namespace Corium3DUtils
@@ -0,0 +1,239 @@
+// Generates an assets file out of a manifest, without the editor - for batch builds.
+// Standalone (no CLR) - builds on Linux against a system assimp:
+//   g++ -std=c++14 -O2 -I../externals/Include AssetsBuilder.cpp ModelImporter.cpp ModelsCache.cpp ModelBaker.cpp ../Corium3D/AssetsOps.cpp ../Corium3D/MappedAssets.cpp ../Corium3D/LZCodec.cpp ../Corium3D/ThreadPool.cpp ../Corium3D/BoundingSphere.cpp ../Corium3D/AABB.cpp -lassimp -lpthread -o assetsBuilder
+// usage: assetsBuilder <manifest> <assets file> [-j <threads nr>] [-c <cache folder>] [-z] [-qp <positions error max>] [-qk <animation keys error max>]
+//   -j  - models import threads (default: as many as there are hardware threads)
+//   -c  - reuse the models whose sources did not change since they were cached in the folder (see ModelsCache), and cache
+//         the rest. The assets file is relinked out of the cached and the re-imported models, byte identical to a clean build.
+//   -z  - block compress the assets file; -qp/-qk - quantize within the given error bounds (see AssetsCompressionParams)
+//
+// The manifest has a directive per line, '#' starting a comment. Paths are relative to the working directory.
+//   model <source file> [prog <prog idx>] [collider <sphere|box|capsule>]
+//     - a model, indexed by its order among the models. The collider is fit to the model's bounding volumes.
+//   scene
+//     - starts a scene, indexed by its order among the scenes
+//   sceneModel <model idx> <static|mobile> <instances nr max>
+//     - adds a model to the last scene
+//   instance <tx ty tz> <sx sy sz> <qw qx qy qz>
+//     - adds an initial instance to the last scene model
+
+#include "ModelImporter.h"
+#include "ModelsCache.h"
+#include "../Corium3D/MappedAssets.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace Corium3D;
+
+namespace {
+
+	struct ModelManifest {
+		std::string sourcePath;
+		unsigned int progIdx = 0;
+		CollisionPrimitive3DType collisionPrimitive3DType = CollisionPrimitive3DType::NO_3D_COLLIDER;
+	};
+
+	struct AssetsManifest {
+		std::vector<ModelManifest> models;
+		std::vector<SceneData> scenes;
+	};
+
+	void parseManifest(std::string const& manifestPath, AssetsManifest& outManifest) {
+		std::ifstream manifestFile(manifestPath);
+		if (!manifestFile.is_open())
+			throw std::runtime_error(manifestPath + " failed to open.");
+
+		std::string line;
+		for (unsigned int lineNr = 1; std::getline(manifestFile, line); lineNr++) {
+			line = line.substr(0, line.find('#'));
+			std::istringstream lineStream(line);
+			std::string directive;
+			if (!(lineStream >> directive))
+				continue;
+
+			std::string const where = manifestPath + ":" + std::to_string(lineNr) + ": ";
+			if (directive == "model") {
+				ModelManifest model;
+				if (!(lineStream >> model.sourcePath))
+					throw std::runtime_error(where + "model's source file is missing");
+				std::string option;
+				while (lineStream >> option) {
+					std::string val;
+					if (!(lineStream >> val))
+						throw std::runtime_error(where + option + "'s value is missing");
+					if (option == "prog")
+						model.progIdx = std::stoul(val);
+					else if (option == "collider" && val == "sphere")
+						model.collisionPrimitive3DType = CollisionPrimitive3DType::SPHERE;
+					else if (option == "collider" && val == "box")
+						model.collisionPrimitive3DType = CollisionPrimitive3DType::BOX;
+					else if (option == "collider" && val == "capsule")
+						model.collisionPrimitive3DType = CollisionPrimitive3DType::CAPSULE;
+					else
+						throw std::runtime_error(where + "unknown model option " + option + " " + val);
+				}
+				outManifest.models.push_back(model);
+			}
+			else if (directive == "scene") {
+				outManifest.scenes.push_back(SceneData{});
+			}
+			else if (directive == "sceneModel") {
+				if (outManifest.scenes.empty())
+					throw std::runtime_error(where + "sceneModel outside of a scene");
+				SceneData::SceneModelData sceneModelData;
+				std::string staticness;
+				if (!(lineStream >> sceneModelData.modelIdx >> staticness >> sceneModelData.instancesNrMax) || (staticness != "static" && staticness != "mobile"))
+					throw std::runtime_error(where + "expected sceneModel <model idx> <static|mobile> <instances nr max>");
+				if (sceneModelData.modelIdx >= outManifest.models.size())
+					throw std::runtime_error(where + "model #" + std::to_string(sceneModelData.modelIdx) + " is not declared (yet)");
+				sceneModelData.isStatic = staticness == "static";
+				outManifest.scenes.back().sceneModelsData.push_back(sceneModelData);
+			}
+			else if (directive == "instance") {
+				if (outManifest.scenes.empty() || outManifest.scenes.back().sceneModelsData.empty())
+					throw std::runtime_error(where + "instance outside of a scene model");
+				Transform3D transform;
+				if (!(lineStream >> transform.translate.x >> transform.translate.y >> transform.translate.z >>
+									transform.scale.x >> transform.scale.y >> transform.scale.z >>
+									transform.rot.w >> transform.rot.x >> transform.rot.y >> transform.rot.z))
+					throw std::runtime_error(where + "expected instance <tx ty tz> <sx sy sz> <qw qx qy qz>");
+				outManifest.scenes.back().sceneModelsData.back().instancesTransformsInit.push_back(transform);
+			}
+			else
+				throw std::runtime_error(where + "unknown directive " + directive);
+		}
+	}
+
+	// AssetsGen::ModelAssetGen::assignCollision*()'s counterparts, with the editor's default fits
+	void assignCollider(ImportedModel const& importedModel, CollisionPrimitive3DType collisionPrimitive3DType, ColliderData& outColliderData) {
+		outColliderData.collisionPrimitive3DType = collisionPrimitive3DType;
+		switch (collisionPrimitive3DType) {
+		case CollisionPrimitive3DType::BOX: {
+			glm::vec3 center = 0.5f * (importedModel.aabbMinVertex + importedModel.aabbMaxVertex);
+			glm::vec3 scale = 0.5f * (importedModel.aabbMaxVertex - importedModel.aabbMinVertex);
+			outColliderData.collisionPrimitive3dData.collisionBoxData = { center, scale };
+			outColliderData.aabb3DMinVertex = center - scale;
+			outColliderData.aabb3DMaxVertex = center + scale;
+			break;
+		}
+		case CollisionPrimitive3DType::SPHERE: {
+			glm::vec3 const& center = importedModel.modelDesc->boundingSphereCenter;
+			float radius = importedModel.modelDesc->boundingSphereRadius;
+			outColliderData.collisionPrimitive3dData.collisionSphereData = { center, radius };
+			outColliderData.aabb3DMinVertex = center - radius;
+			outColliderData.aabb3DMaxVertex = center + radius;
+			break;
+		}
+		case CollisionPrimitive3DType::CAPSULE: {
+			ImportedModel::BoundingCapsule const& capsule = importedModel.boundingCapsule;
+			float axisLen = capsule.height > 2.0f * capsule.radius ? capsule.height - 2.0f * capsule.radius : 0.0f;
+			glm::vec3 center1 = capsule.center - 0.5f * axisLen * capsule.axisVec;
+			glm::vec3 axisVec = axisLen * capsule.axisVec;
+			outColliderData.collisionPrimitive3dData.collisionCapsuleData = { center1, axisVec, capsule.radius };
+			outColliderData.aabb3DMinVertex = center1 - capsule.radius;
+			outColliderData.aabb3DMaxVertex = center1 + axisVec + capsule.radius;
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	// AssetsGen::SceneAssetGen::getAssetsFileReadySceneData()'s counterpart
+	void finalizeSceneData(std::vector<ModelDesc const*> const& modelDescs, SceneData& sceneData) {
+		sceneData.staticModelsNr = 0;
+		sceneData.collisionPrimitives3DInstancesNrsMaxima.fill(0);
+		sceneData.collisionPrimitives2DInstancesNrsMaxima.fill(0);
+		for (SceneData::SceneModelData const& sceneModelData : sceneData.sceneModelsData) {
+			if (sceneModelData.isStatic)
+				sceneData.staticModelsNr++;
+
+			ColliderData const& colliderData = modelDescs[sceneModelData.modelIdx]->colliderData;
+			if (colliderData.collisionPrimitive3DType != CollisionPrimitive3DType::NO_3D_COLLIDER)
+				sceneData.collisionPrimitives3DInstancesNrsMaxima[colliderData.collisionPrimitive3DType] += sceneModelData.instancesNrMax;
+			if (colliderData.collisionPrimitive2DType != CollisionPrimitive2DType::NO_2D_COLLIDER)
+				sceneData.collisionPrimitives2DInstancesNrsMaxima[colliderData.collisionPrimitive2DType] += sceneModelData.instancesNrMax;
+		}
+	}
+
+	double msSince(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		printf("usage: %s <manifest> <assets file> [-j <threads nr>] [-c <cache folder>] [-z] [-qp <positions error max>] [-qk <animation keys error max>]\n", argv[0]);
+		return 1;
+	}
+
+	unsigned int threadsNr = 0;
+	std::unique_ptr<ModelsCache> cache;
+	AssetsCompressionParams compressionParams;
+	for (int argIdx = 3; argIdx < argc; argIdx++) {
+		if (strcmp(argv[argIdx], "-z") == 0)
+			compressionParams.isCompressed = true;
+		else if (strcmp(argv[argIdx], "-j") == 0 && argIdx + 1 < argc)
+			threadsNr = atoi(argv[++argIdx]);
+		else if (strcmp(argv[argIdx], "-c") == 0 && argIdx + 1 < argc)
+			cache.reset(new ModelsCache(argv[++argIdx]));
+		else if (strcmp(argv[argIdx], "-qp") == 0 && argIdx + 1 < argc)
+			compressionParams.positionsErrorMax = (float)atof(argv[++argIdx]);
+		else if (strcmp(argv[argIdx], "-qk") == 0 && argIdx + 1 < argc)
+			compressionParams.animationKeysErrorMax = (float)atof(argv[++argIdx]);
+		else {
+			printf("unknown option %s\n", argv[argIdx]);
+			return 1;
+		}
+	}
+
+	try {
+		AssetsManifest manifest;
+		parseManifest(argv[1], manifest);
+
+		auto start = std::chrono::steady_clock::now();
+		std::vector<std::string> modelsPaths;
+		for (ModelManifest const& model : manifest.models)
+			modelsPaths.push_back(model.sourcePath);
+		std::vector<ImportedModel> importedModels;
+		importModels(modelsPaths, importedModels, threadsNr, cache.get());
+		printf("imported %zu models in %.1fms\n", importedModels.size(), msSince(start));
+		if (cache) {
+			ModelsCache::Report cacheReport = cache->getReport();
+			for (ModelsCache::Report::ModelReport const& modelReport : cacheReport.modelsReports)
+				printf("  %-6s %s%s%s\n", modelReport.isHit ? "hit" : "miss", modelReport.modelPath.c_str(), modelReport.isHit ? "" : " - ", modelReport.missReason.c_str());
+			printf("cache: %u hits, %u misses\n", cacheReport.hitsNr, cacheReport.missesNr);
+		}
+
+		std::vector<ModelDesc const*> modelDescs(manifest.models.size());
+		for (unsigned int modelIdx = 0; modelIdx < manifest.models.size(); modelIdx++) {
+			ModelDesc& modelDesc = *importedModels[modelIdx].modelDesc;
+			modelDesc.progIdx = manifest.models[modelIdx].progIdx;
+			assignCollider(importedModels[modelIdx], manifest.models[modelIdx].collisionPrimitive3DType, modelDesc.colliderData);
+			modelDescs[modelIdx] = &modelDesc;
+		}
+
+		std::vector<SceneData const*> scenesData(manifest.scenes.size());
+		for (unsigned int sceneIdx = 0; sceneIdx < manifest.scenes.size(); sceneIdx++) {
+			finalizeSceneData(modelDescs, manifest.scenes[sceneIdx]);
+			scenesData[sceneIdx] = &manifest.scenes[sceneIdx];
+		}
+
+		start = std::chrono::steady_clock::now();
+		writeMappedAssetsFile(argv[2], modelDescs, scenesData, compressionParams);
+		printf("wrote %s in %.1fms\n", argv[2], msSince(start));
+	}
+	catch (std::exception const& error) {
+		printf("%s\n", error.what());
+		return 1;
+	}
+
+	return 0;
+}
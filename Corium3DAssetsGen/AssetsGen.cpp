@@ -1,13 +1,13 @@
 #include "AssetsGen.h"
 
 #include "../Corium3D/AssetsOps.h"
+#include "../Corium3D/MappedAssets.h"
 #include "../Corium3D/BoundingSphere.h"
 #include "../Corium3D/AABB.h"
 #include "../Corium3D/ServiceLocator.h"
 #include "Marshalers.h"
+#include "ModelImporter.h"
 
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
 #include <GLTFSDK/Deserialize.h>
 #include <GLTFSDK/GLBResourceReader.h>
 #include <filesystem>
@@ -40,30 +40,13 @@ namespace Corium3D {
 		std::shared_ptr<std::stringstream> m_stream;
 	};
 
-	void genNodesCountRecurse(aiNode* node, unsigned int depth, unsigned int& treeDepthMaxOut, unsigned int& nodesNrOut) {
-		treeDepthMaxOut = depth > treeDepthMaxOut ? depth : treeDepthMaxOut;
-		if (node->mNumChildren) {
-			nodesNrOut += node->mNumChildren;
-			for (unsigned int childIdx = 0; childIdx < node->mNumChildren; childIdx++)
-				genNodesCountRecurse(node->mChildren[childIdx], depth + 1, treeDepthMaxOut, nodesNrOut);
-		}
-	}
-
 	AssetsGen::ModelAssetGen::ModelAssetGen(System::String^ modelPath)
 	{		
-		modelDesc = new ModelDesc;
 		if (modelPath != System::String::Empty) {
-			modelDesc->colladaPath = systemStringToAnsiString(modelPath);
-			modelDesc->verticesNr = 0;
-			modelDesc->verticesColorsNrTotal = 0;
-			modelDesc->texesNr = 0;
-			modelDesc->bonesNr = 0;
-			modelDesc->facesNr = 0;
-			modelDesc->progIdx = 0;
-
+			std::string modelPathAnsi = systemStringToAnsiString(modelPath);
 			if (System::IO::Path::GetExtension(modelPath) == gcnew System::String(".glb"))
 			{
-				std::shared_ptr<std::ifstream> glbStream = std::make_shared<std::ifstream>(modelDesc->colladaPath, std::ios::binary);
+				std::shared_ptr<std::ifstream> glbStream = std::make_shared<std::ifstream>(modelPathAnsi, std::ios::binary);
 
 				GLBResourceReader reader(std::make_unique<InStream>(), glbStream);
 
@@ -89,359 +72,87 @@ namespace Corium3D {
 				}
 			}
 
-			importer = new Assimp::Importer();
-			//importer->SetPropertyFloat("PP_GSN_MAX_SMOOTHING_ANGLE", 120);
-			aiScene const* scene = importer->ReadFile(modelDesc->colladaPath, aiProcessPreset_TargetRealtime_Fast);
-			if (!scene) {
-				std::string errorString = importer->GetErrorString();
-				OutputDebugStringA((std::string("Failed to import \"") + modelDesc->colladaPath + std::string("\": ") + errorString).c_str());
+			ImportedModel importedModel;
+			try {
+				importModel(modelPathAnsi, importedModel);
+			}
+			catch (std::runtime_error const& error) {
+				OutputDebugStringA(error.what());
 				throw std::exception();
 			}
-			else
-				OutputDebugStringA((std::string("Imported \"") + modelDesc->colladaPath + std::string("\"\n")).c_str());
+			OutputDebugStringA((std::string("Imported \"") + modelPathAnsi + std::string("\"\n")).c_str());
+			adoptImportedModel(importedModel);
+		}
+		else {
+			modelDesc = new ModelDesc;
+			managedImportedData = nullptr;
+			modelDesc->colliderData.collisionPrimitive3DType = CollisionPrimitive3DType::NO_3D_COLLIDER;
+			modelDesc->colliderData.collisionPrimitive2DType = CollisionPrimitive2DType::NO_2D_COLLIDER;
+		}
+	}
 
-			if (!scene->HasMeshes()) {
-				OutputDebugStringA(std::string("The scene has no meshes !").c_str());
-				delete importer;
-				throw std::exception();
+	AssetsGen::ModelAssetGen::ModelAssetGen(ImportedModel& importedModel)
+	{
+		adoptImportedModel(importedModel);
+	}
+
+	void AssetsGen::ModelAssetGen::adoptImportedModel(ImportedModel& importedModel)
+	{
+		importer = importedModel.importer.release();
+		modelDesc = importedModel.modelDesc.release();
+		// NULL for models loaded from the cache - the geometry is read off the baked arrays then, and only the normals are
+		// missing (the preview's meshes generate their own)
+		aiScene const* scene = importer ? importer->GetScene() : NULL;
+
+		managedImportedData = gcnew ManagedImportedData;
+		managedImportedData->meshesGeometries = gcnew array<MeshGeometry3D^>(modelDesc->meshesNr);
+		managedImportedData->meshesVertices = gcnew array<array<Point3D>^>(modelDesc->meshesNr);
+		managedImportedData->meshesVertexIndices = gcnew array<array<unsigned short>^>(modelDesc->meshesNr);
+		for (unsigned int meshIdx = 0; meshIdx < modelDesc->meshesNr; meshIdx++) {
+			ModelDesc::SubmeshDesc const& submeshDesc = modelDesc->submeshesDescs[meshIdx];
+			ModelDesc::VertexData const* meshVertices = &modelDesc->vertices[submeshDesc.baseVertex];
+			managedImportedData->meshesGeometries[meshIdx] = gcnew MeshGeometry3D();
+			managedImportedData->meshesVertices[meshIdx] = gcnew array<Point3D>(submeshDesc.verticesNr);
+			for (unsigned int vertexIdx = 0; vertexIdx < submeshDesc.verticesNr; vertexIdx++) {
+				glm::vec3 const& vertex = meshVertices[vertexIdx].pos;
+				managedImportedData->meshesVertices[meshIdx][vertexIdx] = Point3D(vertex.x, vertex.y, vertex.z);
+				managedImportedData->meshesGeometries[meshIdx]->Positions->Add(Point3D(vertex.x, vertex.y, vertex.z));
 			}
 
-			modelDesc->meshesNr = scene->mNumMeshes;
-			modelDesc->verticesNrsPerMesh = std::vector<unsigned int>(scene->mNumMeshes);
-			modelDesc->texesNrsPerMesh = std::vector<unsigned int>(scene->mNumMeshes);
-			modelDesc->bonesNrsPerMesh = std::vector<unsigned int>(scene->mNumMeshes);
-			modelDesc->facesNrsPerMesh = std::vector<unsigned int>(scene->mNumMeshes);
-			modelDesc->extraColorsNrsPerMesh = std::vector<unsigned int>(scene->mNumMeshes);
-			modelDesc->extraColors = std::vector<std::vector<std::array<float, 4>>>(scene->mNumMeshes);
-
-			unsigned int vertexIdxOverall = 0;
-			managedImportedData = gcnew ManagedImportedData;
-			managedImportedData->meshesGeometries = gcnew array<MeshGeometry3D^>(scene->mNumMeshes);
-			managedImportedData->meshesVertices = gcnew array<array<Point3D>^>(scene->mNumMeshes);
-			managedImportedData->meshesVertexIndices = gcnew array<array<unsigned short>^>(scene->mNumMeshes);
-			for (unsigned int meshIdx = 0; meshIdx < scene->mNumMeshes; meshIdx++) {
+			if (scene && scene->mMeshes[meshIdx]->HasNormals()) {
 				const aiMesh* mesh = scene->mMeshes[meshIdx];
-				if (!mesh->HasPositions() || !mesh->HasFaces()) {
-					if (!mesh->HasPositions())
-						OutputDebugStringA(std::string("The mesh has no positions !").c_str());
-					else if (!mesh->HasFaces())
-						OutputDebugStringA(std::string("The mesh has no faces !").c_str());
-
-					delete importer;
-					throw std::exception();
-				}
-
-				modelDesc->verticesNrsPerMesh[meshIdx] += mesh->mNumVertices;
-				modelDesc->verticesNr += mesh->mNumVertices;
-				managedImportedData->meshesGeometries[meshIdx] = gcnew MeshGeometry3D();
-				managedImportedData->meshesVertices[meshIdx] = gcnew array<Point3D>(mesh->mNumVertices);
+				managedImportedData->meshesGeometries[meshIdx]->Normals = gcnew Vector3DCollection(mesh->mNumVertices);
 				for (unsigned int vertexIdx = 0; vertexIdx < mesh->mNumVertices; vertexIdx++) {
-					aiVector3D vertex = mesh->mVertices[vertexIdx];
-					managedImportedData->meshesVertices[meshIdx][vertexIdx] = Point3D(vertex.x, vertex.y, vertex.z);
-					managedImportedData->meshesGeometries[meshIdx]->Positions->Add(Point3D(vertex.x, vertex.y, vertex.z));
+					aiVector3D normal = mesh->mNormals[vertexIdx];
+					managedImportedData->meshesGeometries[meshIdx]->Normals->Add(Vector3D(normal.x, normal.y, normal.z));
 				}
-
-				if (mesh->HasNormals()) {
-					managedImportedData->meshesGeometries[meshIdx]->Normals = gcnew Vector3DCollection(modelDesc->verticesNr);
-					for (unsigned int vertexIdx = 0; vertexIdx < mesh->mNumVertices; vertexIdx++) {
-						aiVector3D normal = mesh->mNormals[vertexIdx];
-						managedImportedData->meshesGeometries[meshIdx]->Normals->Add(Vector3D(normal.x, normal.y, normal.z));
-					}
-				}
-
-				modelDesc->facesNrsPerMesh[meshIdx] = mesh->mNumFaces;
-				modelDesc->facesNr += mesh->mNumFaces;
-				managedImportedData->meshesVertexIndices[meshIdx] = gcnew array<unsigned short>(modelDesc->facesNr * 3);
-				for (unsigned int faceIdx = 0; faceIdx < mesh->mNumFaces; faceIdx++) {
-					unsigned int* indices = mesh->mFaces[faceIdx].mIndices;
-					managedImportedData->meshesGeometries[meshIdx]->TriangleIndices->Add(indices[0]);
-					managedImportedData->meshesGeometries[meshIdx]->TriangleIndices->Add(indices[1]);
-					managedImportedData->meshesGeometries[meshIdx]->TriangleIndices->Add(indices[2]);
-					managedImportedData->meshesVertexIndices[meshIdx][faceIdx * 3] = indices[0];
-					managedImportedData->meshesVertexIndices[meshIdx][faceIdx * 3 + 1] = indices[1];
-					managedImportedData->meshesVertexIndices[meshIdx][faceIdx * 3 + 2] = indices[2];
-				}
-
-				modelDesc->progIdx = 0;
-
-				modelDesc->bonesNrsPerMesh[meshIdx] = mesh->mNumBones;
-				modelDesc->bonesNr += mesh->mNumBones;
 			}
 
-			unsigned int animationsNr = 0;
-			modelDesc->animationsDescs = std::vector<ModelDesc::AnimationDesc>(animationsNr);
-			if (modelDesc->animationsDescs.size() > 0) {
-				/*
-				for (unsigned int animationIdx = 0; animationIdx < modelDesc->animationsNr; animationIdx++) {
-					aiAnimation const* animation = scene->mAnimations[animationIdx];
-					animations[animationIdx].dur = animation->mDuration;
-					animations[animationIdx].ticksPerSecond = animation->mTicksPerSecond;
-
-					aiNode* nodesIt = scene->mRootNode;
-					genNodesCountRecurse(scene->mRootNode, NodesCount & nodesCount, 0);
-					NodesCount nodesCount = genNodesCount(nodesIt);
-					animations[animationIdx].nodesNr = nodesCount.nodesNr;
-					animations[animationIdx].treeDepthMax = nodesCount.treeDepthMax;
-					unsigned int* nodesToChannelsIdxsMap = new unsigned int[nodesCount.nodesNr];
-					mapNodesToChannelsIdxs(nodesIt, animation, nodesToChannelsIdxsMap);
-					animations[animationIdx].TransformatsHierarchyBuffer = new Animation::TransformatsHierarchyNode[nodesCount.nodesNr];
-					unsigned int* childrenIdxsStack = new unsigned int[nodesCount.treeDepthMax]();
-					Animation::TransformatsHierarchyNode** transformatsHierarchyNodesStack = new Animation::TransformatsHierarchyNode * [nodesCount.treeDepthMax + 1];
-					unsigned int depth = 0;
-					unsigned int nodesCounter = 0;
-					animations[animationIdx].channelsNr = 0;
-					while (1) {
-						// REMINDER: Depends on having at least 2 bones in the hierarchy
-						while (nodesIt->mNumChildren) {
-							animations[animationIdx].TransformatsHierarchyBuffer[nodesCounter] = genTransformatHierarchyNode(nodesIt, scene, animationIdx, nodesToChannelsIdxsMap[nodesCounter]);
-							transformatsHierarchyNodesStack[depth] = &animations[animationIdx].TransformatsHierarchyBuffer[nodesCounter++];
-							nodesIt = nodesIt->mChildren[childrenIdxsStack[depth]];
-							childrenIdxsStack[depth]++;
-							depth++;
-						}
-						animations[animationIdx].TransformatsHierarchyBuffer[nodesCounter] = genTransformatHierarchyNode(nodesIt, scene, animationIdx, nodesToChannelsIdxsMap[nodesCounter]);
-						transformatsHierarchyNodesStack[depth] = &animations[animationIdx].TransformatsHierarchyBuffer[nodesCounter++];
-
-						// REMINDER: Depends on having at least 2 bones in the hierarchy
-						while (nodesIt->mParent && childrenIdxsStack[depth - 1] == nodesIt->mParent->mNumChildren) {
-							nodesIt = nodesIt->mParent;
-							transformatsHierarchyNodesStack[depth - 1]->children[childrenIdxsStack[depth - 1] - 1] = transformatsHierarchyNodesStack[depth];
-							transformatsHierarchyNodesStack[depth]->parent = transformatsHierarchyNodesStack[depth - 1];
-							depth--;
-							childrenIdxsStack[depth] = 0;
-						}
-
-						if (nodesIt->mParent) {
-							transformatsHierarchyNodesStack[depth - 1]->children[childrenIdxsStack[depth - 1] - 1] = transformatsHierarchyNodesStack[depth];
-							transformatsHierarchyNodesStack[depth]->parent = transformatsHierarchyNodesStack[depth - 1];
-							nodesIt = nodesIt->mParent->mChildren[childrenIdxsStack[depth - 1]];
-							childrenIdxsStack[depth - 1]++;
-						}
-						else {
-							transformatsHierarchyNodesStack[depth]->parent = NULL;
-							break;
-						}
-					}
-					delete[] transformatsHierarchyNodesStack;
-					delete[] childrenIdxsStack;
-
-					//if (animations[animationIdx].channelsNr) {
-					unsigned int assimpChannelsNr = animation->mNumChannels;
-					unsigned int keyFramesNrByAssimpFormat = 0;
-					for (unsigned int channelIdx = 0; channelIdx < assimpChannelsNr; channelIdx++) {
-						keyFramesNrByAssimpFormat += animation->mChannels[channelIdx]->mNumScalingKeys;
-						keyFramesNrByAssimpFormat += animation->mChannels[channelIdx]->mNumRotationKeys;
-						keyFramesNrByAssimpFormat += animation->mChannels[channelIdx]->mNumPositionKeys;
-					}
-					double* keyFramesTimesBuffer = new double[keyFramesNrByAssimpFormat];
-					animations[animationIdx].keyFramesNr = 0;
-					unsigned int* scalingKeysIts = new unsigned int[assimpChannelsNr]();
-					unsigned int* rotKeysIts = new unsigned int[assimpChannelsNr]();
-					unsigned int* translationKeysIts = new unsigned int[assimpChannelsNr]();
-					unsigned int keyFrameIdxByAssimpFormatIt = 0;
-					while (keyFrameIdxByAssimpFormatIt < keyFramesNrByAssimpFormat) {
-						double minTime = std::numeric_limits<double>::max();
-						for (unsigned int channelIdx = 0; channelIdx < assimpChannelsNr; channelIdx++) {
-							aiNodeAnim* channel = animation->mChannels[channelIdx];
-							double scalingKeyTime = scalingKeysIts[channelIdx] < channel->mNumScalingKeys ? channel->mScalingKeys[scalingKeysIts[channelIdx]].mTime : std::numeric_limits<double>::max();
-							double rotKeyTime = rotKeysIts[channelIdx] < channel->mNumRotationKeys ? channel->mRotationKeys[rotKeysIts[channelIdx]].mTime : std::numeric_limits<double>::max();
-							double translationKeyTime = translationKeysIts[channelIdx] < channel->mNumPositionKeys ? channel->mPositionKeys[translationKeysIts[channelIdx]].mTime : std::numeric_limits<double>::max();
-							if (scalingKeyTime < minTime)
-								minTime = scalingKeyTime;
-							if (rotKeyTime < minTime)
-								minTime = rotKeyTime;
-							if (translationKeyTime < minTime)
-								minTime = translationKeyTime;
-						}
-						keyFramesTimesBuffer[animations[animationIdx].keyFramesNr++] = minTime;
-
-						for (unsigned int channelIdx = 0; channelIdx < assimpChannelsNr; channelIdx++) {
-							aiNodeAnim* channel = animation->mChannels[channelIdx];
-							if (scalingKeysIts[channelIdx] < channel->mNumScalingKeys && channel->mScalingKeys[scalingKeysIts[channelIdx]].mTime == minTime) {
-								keyFrameIdxByAssimpFormatIt++;
-								scalingKeysIts[channelIdx]++;
-							}
-							if (rotKeysIts[channelIdx] < channel->mNumRotationKeys && channel->mRotationKeys[rotKeysIts[channelIdx]].mTime == minTime) {
-								keyFrameIdxByAssimpFormatIt++;
-								rotKeysIts[channelIdx]++;
-							}
-							if (translationKeysIts[channelIdx] < channel->mNumPositionKeys && channel->mPositionKeys[translationKeysIts[channelIdx]].mTime == minTime) {
-								keyFrameIdxByAssimpFormatIt++;
-								translationKeysIts[channelIdx]++;
-							}
-						}
-					}
-					delete[] scalingKeysIts;
-					delete[] rotKeysIts;
-					delete[] translationKeysIts;
-
-
-					if (keyFramesTimesBuffer[0] == 0) {
-						animations[animationIdx].keyFramesTimes = new double[animations[animationIdx].keyFramesNr];
-						memcpy(animations[animationIdx].keyFramesTimes, keyFramesTimesBuffer, animations[animationIdx].keyFramesNr * sizeof(double));
-					}
-					else {
-						animations[animationIdx].keyFramesTimes = new double[animations[animationIdx].keyFramesNr + 1];
-						animations[animationIdx].keyFramesTimes[0] = 0.0;
-						memcpy(animations[animationIdx].keyFramesTimes + 1, keyFramesTimesBuffer, animations[animationIdx].keyFramesNr * sizeof(double));
-					}
-
-					animations[animationIdx].keyFramesNr++;
-					delete[] keyFramesTimesBuffer;
-					unsigned int keyFramesNr = animations[animationIdx].keyFramesNr;
-
-					unsigned int channelsNr = animations[animationIdx].channelsNr;
-					animations[animationIdx].scales = new glm::vec3 * [channelsNr];
-					animations[animationIdx].rots = new glm::quat * [channelsNr];
-					animations[animationIdx].translations = new glm::vec3 * [channelsNr];
-					unsigned int nodeIdx = 0;
-					for (unsigned int channelIdx = 0; channelIdx < channelsNr; channelIdx++) {
-						while (!animations[animationIdx].TransformatsHierarchyBuffer[nodeIdx].isNodeAnimated)
-							nodeIdx++;
-						aiNodeAnim* channel = animation->mChannels[nodesToChannelsIdxsMap[nodeIdx++]];
-						animations[animationIdx].scales[channelIdx] = new glm::vec3[keyFramesNr];
-						animations[animationIdx].rots[channelIdx] = new glm::quat[keyFramesNr];
-						animations[animationIdx].translations[channelIdx] = new glm::vec3[keyFramesNr];
-						unsigned int channelScaleKeyFrameIdx = 0;
-						unsigned int channelRotKeyFrameIdx = 0;
-						unsigned int channelPosKeyFrameIdx = 0;
-						for (unsigned int keyFrameIdx = 0; keyFrameIdx < keyFramesNr; keyFrameIdx++) {
-							if (channelScaleKeyFrameIdx < channel->mNumScalingKeys) {
-								if (channel->mScalingKeys[channelScaleKeyFrameIdx].mTime < animations[animationIdx].keyFramesTimes[keyFrameIdx]) {
-									aiVectorKey& startKey = channel->mScalingKeys[channelScaleKeyFrameIdx - 1];
-									aiVectorKey& endKey = channel->mScalingKeys[channelScaleKeyFrameIdx];
-									animations[animationIdx].scales[channelIdx][keyFrameIdx] =
-										(assimp2glm(endKey.mValue) - assimp2glm(startKey.mValue)) * (float)((animations[animationIdx].keyFramesTimes[keyFrameIdx] - startKey.mTime) / (endKey.mTime - startKey.mTime));
-								}
-								else if (channel->mScalingKeys[channelScaleKeyFrameIdx].mTime == animations[animationIdx].keyFramesTimes[keyFrameIdx])
-									animations[animationIdx].scales[channelIdx][keyFrameIdx] = assimp2glm(channel->mScalingKeys[channelScaleKeyFrameIdx++].mValue);
-								else // channel->mScalingKeys[channelScaleKeyFrameIdx].mTime > (animations[animationIdx].keyFramesTimes[keyFrameIdx] == 0))
-									animations[animationIdx].scales[channelIdx][keyFrameIdx] = assimp2glm(channel->mScalingKeys[0].mValue);
-							}
-							else
-								animations[animationIdx].scales[channelIdx][keyFrameIdx] = assimp2glm(channel->mScalingKeys[channelScaleKeyFrameIdx - 1].mValue);
-
-							if (channelRotKeyFrameIdx < channel->mNumRotationKeys) {
-								if (channel->mRotationKeys[channelRotKeyFrameIdx].mTime < animations[animationIdx].keyFramesTimes[keyFrameIdx]) {
-									aiQuatKey& startKey = channel->mRotationKeys[channelRotKeyFrameIdx - 1];
-									aiQuatKey& endKey = channel->mRotationKeys[channelRotKeyFrameIdx];
-									animations[animationIdx].rots[channelIdx][keyFrameIdx] =
-										glm::slerp(assimp2glm(startKey.mValue), assimp2glm(endKey.mValue), (float)((animations[animationIdx].keyFramesTimes[keyFrameIdx] - startKey.mTime) / (endKey.mTime - startKey.mTime)));
-								}
-								else if (channel->mRotationKeys[channelRotKeyFrameIdx].mTime == animations[animationIdx].keyFramesTimes[keyFrameIdx])
-									animations[animationIdx].rots[channelIdx][keyFrameIdx] = assimp2glm(channel->mRotationKeys[channelRotKeyFrameIdx++].mValue);
-								else // channel->mRotationKeys[channelRotKeyFrameIdx].mTime > (animations[animationIdx].keyFramesTimes[keyFrameIdx] == 0))
-									animations[animationIdx].rots[channelIdx][keyFrameIdx] = assimp2glm(channel->mRotationKeys[0].mValue);
-							}
-							else
-								animations[animationIdx].rots[channelIdx][keyFrameIdx] = assimp2glm(channel->mRotationKeys[channelRotKeyFrameIdx - 1].mValue);
-
-							if (channelPosKeyFrameIdx < channel->mNumPositionKeys) {
-								if (channel->mPositionKeys[channelPosKeyFrameIdx].mTime < animations[animationIdx].keyFramesTimes[keyFrameIdx]) {
-									aiVectorKey& startKey = channel->mPositionKeys[channelScaleKeyFrameIdx - 1];
-									aiVectorKey& endKey = channel->mPositionKeys[channelScaleKeyFrameIdx];
-									animations[animationIdx].scales[channelIdx][keyFrameIdx] =
-										(assimp2glm(endKey.mValue) - assimp2glm(startKey.mValue)) * (float)((animations[animationIdx].keyFramesTimes[keyFrameIdx] - startKey.mTime) / (endKey.mTime - startKey.mTime));
-								}
-								else if (channel->mPositionKeys[channelPosKeyFrameIdx].mTime == animations[animationIdx].keyFramesTimes[keyFrameIdx])
-									animations[animationIdx].translations[channelIdx][keyFrameIdx] = assimp2glm(channel->mPositionKeys[channelPosKeyFrameIdx++].mValue);
-								else // channel->mPositionKeys[channelPosKeyFrameIdx].mTime > (animations[animationIdx].keyFramesTimes[keyFrameIdx] == 0))
-									animations[animationIdx].translations[channelIdx][keyFrameIdx] = assimp2glm(channel->mPositionKeys[0].mValue);
-							}
-							else
-								animations[animationIdx].translations[channelIdx][keyFrameIdx] = assimp2glm(channel->mPositionKeys[channelPosKeyFrameIdx - 1].mValue);
-						}
-					}
-					//}
-
-				}
-				*/
+			unsigned int const* meshIdxs = &modelDesc->idxs[submeshDesc.firstIdx];
+			managedImportedData->meshesVertexIndices[meshIdx] = gcnew array<unsigned short>(submeshDesc.idxsNr);
+			for (unsigned int idxIdx = 0; idxIdx < submeshDesc.idxsNr; idxIdx++) {
+				managedImportedData->meshesGeometries[meshIdx]->TriangleIndices->Add(meshIdxs[idxIdx]);
+				managedImportedData->meshesVertexIndices[meshIdx][idxIdx] = meshIdxs[idxIdx];
 			}
-			else
-				modelDesc->animationsDescs.resize(0);
-			// modelDesc->animationsDescs.shrink_to_fit();
+		}
 
-			glm::vec3* vec3Arr = new glm::vec3[modelDesc->verticesNr];
-			for (unsigned int meshIdx = 0; meshIdx < scene->mNumMeshes; meshIdx++) {
-				aiMesh* mesh = scene->mMeshes[meshIdx];
-				for (unsigned int vertexIdx = 0; vertexIdx < mesh->mNumVertices; vertexIdx++) {
-					aiVector3D vertex = mesh->mVertices[vertexIdx];
-					vec3Arr[vertexIdxOverall++] = { vertex.x, vertex.y, vertex.z };
-				}
-			}
+		managedImportedData->boundingSphereCenter = Point3D(modelDesc->boundingSphereCenter.x, modelDesc->boundingSphereCenter.y, modelDesc->boundingSphereCenter.z);
+		managedImportedData->boundingSphereRadius = modelDesc->boundingSphereRadius;
 
-			BoundingSphere bs = BoundingSphere::calcBoundingSphereEfficient(vec3Arr, modelDesc->verticesNr);
-			modelDesc->boundingSphereCenter = bs.getCenter();			
-			modelDesc->boundingSphereRadius = bs.getRadius();			
-			managedImportedData->boundingSphereCenter = Point3D(modelDesc->boundingSphereCenter.x, modelDesc->boundingSphereCenter.y, modelDesc->boundingSphereCenter.z);
-			managedImportedData->boundingSphereRadius = modelDesc->boundingSphereRadius;
-
-			AABB3D aabb3D = AABB3D::calcAABB(vec3Arr, modelDesc->verticesNr);
-			glm::vec3 aabb3dMinVertex = aabb3D.getMinVertex();
-			glm::vec3 aabb3dMaxVertex = aabb3D.getMaxVertex();
-			managedImportedData->boundingBoxCenter = Point3D(0.5 * (aabb3dMinVertex.x + aabb3dMaxVertex.z),
-															 0.5 * (aabb3dMinVertex.y + aabb3dMaxVertex.y),
-															 0.5 * (aabb3dMinVertex.z + aabb3dMaxVertex.z));
-			managedImportedData->boundingBoxScale = Point3D(0.5 * (aabb3dMaxVertex.x - aabb3dMinVertex.z),
-															0.5 * (aabb3dMaxVertex.y - aabb3dMinVertex.y),
-															0.5 * (aabb3dMaxVertex.z - aabb3dMinVertex.z));
-
-			float verticesSpreadX = aabb3dMaxVertex.x - aabb3dMinVertex.x;
-			float verticesSpreadY = aabb3dMaxVertex.y - aabb3dMinVertex.y;
-			float verticesSpreadZ = aabb3dMaxVertex.z - aabb3dMinVertex.z;
-			managedImportedData->boundingCapsuleAxisVec = Vector3D(0, 0, 0);
-			if (verticesSpreadX > verticesSpreadY) {
-				if (verticesSpreadX > verticesSpreadZ) {
-					if (verticesSpreadZ > verticesSpreadY) {
-						// largest: X, 2nd: Z						
-						managedImportedData->boundingCapsuleAxisVec.X = 1;
-						managedImportedData->boundingCapsuleHeight = verticesSpreadX;
-						managedImportedData->boundingCapsuleRadius = 0.5 * verticesSpreadZ;
-					}
-					else {
-						// largest: X, 2nd: Y
-						managedImportedData->boundingCapsuleAxisVec.X = 1;
-						managedImportedData->boundingCapsuleHeight = verticesSpreadX;
-						managedImportedData->boundingCapsuleRadius = 0.5 * verticesSpreadY;
-					}
-				}
-				else {
-					// largest: Z, 2nd: X
-					managedImportedData->boundingCapsuleAxisVec.Z = 1;
-					managedImportedData->boundingCapsuleHeight = verticesSpreadZ;
-					managedImportedData->boundingCapsuleRadius = 0.5 * verticesSpreadX;
-				}
-			}
-			else if (verticesSpreadY > verticesSpreadZ) {
-				if (verticesSpreadX > verticesSpreadZ) {
-					// largest: Y, 2nd: X
-					managedImportedData->boundingCapsuleAxisVec.Y = 1;
-					managedImportedData->boundingCapsuleHeight = verticesSpreadY;
-					managedImportedData->boundingCapsuleRadius = 0.5 * verticesSpreadX;
-				}
-				else { // largest: Y, 2nd: Z
-					managedImportedData->boundingCapsuleAxisVec.Y = 1;
-					managedImportedData->boundingCapsuleHeight = verticesSpreadY;
-					managedImportedData->boundingCapsuleRadius = 0.5 * verticesSpreadZ;
-				}
-			}
-			else {
-				// largest: Z, 2nd: Y
-				managedImportedData->boundingCapsuleAxisVec.Z = 1;
-				managedImportedData->boundingCapsuleHeight = verticesSpreadZ;
-				managedImportedData->boundingCapsuleRadius = 0.5 * verticesSpreadY;
-			}
-			managedImportedData->boundingCapsuleCenter = Point3D(0.5 * (aabb3dMinVertex.x + aabb3dMaxVertex.x),
-															 	 0.5 * (aabb3dMinVertex.y + aabb3dMaxVertex.y),
-															 	 0.5 * (aabb3dMinVertex.z + aabb3dMaxVertex.z));
+		glm::vec3 const& aabb3dMinVertex = importedModel.aabbMinVertex;
+		glm::vec3 const& aabb3dMaxVertex = importedModel.aabbMaxVertex;
+		managedImportedData->boundingBoxCenter = Point3D(0.5 * (aabb3dMinVertex.x + aabb3dMaxVertex.z),
+														 0.5 * (aabb3dMinVertex.y + aabb3dMaxVertex.y),
+														 0.5 * (aabb3dMinVertex.z + aabb3dMaxVertex.z));
+		managedImportedData->boundingBoxScale = Point3D(0.5 * (aabb3dMaxVertex.x - aabb3dMinVertex.z),
+														0.5 * (aabb3dMaxVertex.y - aabb3dMinVertex.y),
+														0.5 * (aabb3dMaxVertex.z - aabb3dMinVertex.z));
 
-			delete[] vec3Arr;
-		}
-		else 					
-			managedImportedData = nullptr;
-									
-		modelDesc->colliderData.collisionPrimitive3DType = CollisionPrimitive3DType::NO_3D_COLLIDER;
-		modelDesc->colliderData.collisionPrimitive2DType = CollisionPrimitive2DType::NO_2D_COLLIDER;		
+		ImportedModel::BoundingCapsule const& boundingCapsule = importedModel.boundingCapsule;
+		managedImportedData->boundingCapsuleCenter = Point3D(boundingCapsule.center.x, boundingCapsule.center.y, boundingCapsule.center.z);
+		managedImportedData->boundingCapsuleAxisVec = Vector3D(boundingCapsule.axisVec.x, boundingCapsule.axisVec.y, boundingCapsule.axisVec.z);
+		managedImportedData->boundingCapsuleHeight = boundingCapsule.height;
+		managedImportedData->boundingCapsuleRadius = boundingCapsule.radius;
 	}
 
 	AssetsGen::ModelAssetGen::~ModelAssetGen()
@@ -477,7 +188,7 @@ namespace Corium3D {
 				}
 			}
 
-			modelDesc->verticesColorsNrTotal += (modelDesc->extraColorsNrsPerMesh[meshIdx] + 1) * importer->GetScene()->mMeshes[meshIdx]->mNumVertices;
+			modelDesc->verticesColorsNrTotal += (modelDesc->extraColorsNrsPerMesh[meshIdx] + 1) * modelDesc->verticesNrsPerMesh[meshIdx];
 		}
 	}
 
@@ -575,6 +286,32 @@ namespace Corium3D {
 		return modelAssetGen;
 	}
 
+	array<AssetsGen::IModelAssetGen^>^ AssetsGen::createModelAssetGens(array<System::String^>^ modelsPaths)
+	{
+		std::vector<std::string> modelsPathsAnsi(modelsPaths->Length);
+		for (unsigned int modelIdx = 0; modelIdx < modelsPaths->Length; modelIdx++)
+			modelsPathsAnsi[modelIdx] = systemStringToAnsiString(modelsPaths[modelIdx]);
+
+		std::vector<ImportedModel> importedModels;
+		try {
+			importModels(modelsPathsAnsi, importedModels);
+		}
+		catch (std::runtime_error const& error) {
+			OutputDebugStringA(error.what());
+			throw std::exception();
+		}
+
+		// the WPF geometries are created on the calling thread, in the paths' order
+		array<IModelAssetGen^>^ modelAssetGensCreated = gcnew array<IModelAssetGen^>(modelsPaths->Length);
+		for (unsigned int modelIdx = 0; modelIdx < modelsPaths->Length; modelIdx++) {
+			ModelAssetGen^ modelAssetGen = gcnew ModelAssetGen(importedModels[modelIdx]);
+			modelAssetGens->Add(modelAssetGen);
+			modelAssetGensCreated[modelIdx] = modelAssetGen;
+		}
+
+		return modelAssetGensCreated;
+	}
+
 	AssetsGen::ISceneAssetGen^ AssetsGen::createSceneAssetGen()
 	{
 		sceneAssetGens->Add(gcnew SceneAssetGen());
@@ -582,6 +319,20 @@ namespace Corium3D {
 	}
 
 	void AssetsGen::generateAssets(System::String^ fullFilePath)
+	{
+		writeAssets(fullFilePath, AssetsCompressionParams());
+	}
+
+	void AssetsGen::generateAssets(System::String^ fullFilePath, float positionsErrorMax, float animationKeysErrorMax)
+	{
+		AssetsCompressionParams compressionParams;
+		compressionParams.isCompressed = true;
+		compressionParams.positionsErrorMax = positionsErrorMax;
+		compressionParams.animationKeysErrorMax = animationKeysErrorMax;
+		writeAssets(fullFilePath, compressionParams);
+	}
+
+	void AssetsGen::writeAssets(System::String^ fullFilePath, AssetsCompressionParams const& compressionParams)
 	{
 		std::vector<ModelDesc const*> modelDescs(AssetsGen::modelAssetGens->Count);			
 		for (unsigned int modelIdx = 0; modelIdx < AssetsGen::modelAssetGens->Count; ++modelIdx)
@@ -591,7 +342,7 @@ namespace Corium3D {
 		for (unsigned int sceneIdx = 0; sceneIdx < AssetsGen::sceneAssetGens->Count; ++sceneIdx)
 			scenesData[sceneIdx] = sceneAssetGens[sceneIdx]->getAssetsFileReadySceneData();
 		
-		writeAssetsFile(std::string(systemStringToAnsiString(fullFilePath)), modelDescs, scenesData);
+		writeMappedAssetsFile(std::string(systemStringToAnsiString(fullFilePath)), modelDescs, scenesData, compressionParams);
 	}
 
 	AssetsGen::SceneAssetGen::SceneModelData::SceneModelInstanceData::SceneModelInstanceData(SceneModelData^ _sceneModelData, Media3D::Vector3D^ translationInit, Media3D::Vector3D^ scaleInit, Media3D::Quaternion^ rotInit) :
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../Corium3D/AssetsOps.h"
+#include "../Corium3D/MappedAssets.h"
+#include "ModelImporter.h"
 
 #include <assimp/Importer.hpp>
 #include <vector>
@@ -62,8 +64,12 @@ namespace Corium3D {
 		};
 
 		static IModelAssetGen^ createModelAssetGen(System::String^ modelPath);		
+		// imports the models in parallel - the returned generators are in modelsPaths' order
+		static array<IModelAssetGen^>^ createModelAssetGens(array<System::String^>^ modelsPaths);
 		static ISceneAssetGen^ createSceneAssetGen();
 		static void generateAssets(System::String^ outputFolder);
+		// block compressed, and quantized where the errors bounds allow it (0 - not quantized)
+		static void generateAssets(System::String^ outputFolder, float positionsErrorMax, float animationKeysErrorMax);
 
 	private:
 		ref class ModelAssetGen : IModelAssetGen {
@@ -86,6 +92,8 @@ namespace Corium3D {
 			}
 
 			ModelAssetGen(System::String^ modelPath);
+			// takes over importedModel's importer (NULL for models loaded from the cache) and ModelDesc
+			ModelAssetGen(ImportedModel& importedModel);
 			~ModelAssetGen();
 			!ModelAssetGen();			
 			virtual void assignExtraColors(array<array<array<float>^>^>^ extraColors) = IModelAssetGen::assignExtraColors;
@@ -102,9 +110,12 @@ namespace Corium3D {
 
 		private:						
 			ManagedImportedData^ managedImportedData;
+			// NULL for models loaded from the cache - read the model's data off modelDesc
 			Assimp::Importer* importer;
 			ModelDesc* modelDesc;
 			unsigned int modelIdx;
+
+			void adoptImportedModel(ImportedModel& importedModel);
 			bool isDisposed = false;
 		};
 
@@ -167,5 +178,7 @@ namespace Corium3D {
 
 		static Collections::List<ModelAssetGen^>^ modelAssetGens = gcnew Collections::List<ModelAssetGen^>();
 		static Collections::List<SceneAssetGen^>^ sceneAssetGens = gcnew Collections::List<SceneAssetGen^>();
+
+		static void writeAssets(System::String^ fullFilePath, AssetsCompressionParams const& compressionParams);
 	};
 }
\ No newline at end of file
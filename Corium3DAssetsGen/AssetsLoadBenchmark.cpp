@@ -0,0 +1,232 @@
+// Compares loading a scene through the stream reader (readSceneAssets) and through a mapped assets file (MappedAssets),
+// plain, block compressed and quantized, over a large synthetic assets file written in all of the formats.
+// Standalone (no CLR) - builds on Linux:
+//   g++ -std=c++14 -O2 -I../externals/Include AssetsLoadBenchmark.cpp ../Corium3D/AssetsOps.cpp ../Corium3D/MappedAssets.cpp ../Corium3D/LZCodec.cpp -lpthread -o assetsLoadBenchmark
+// usage: assetsLoadBenchmark [<models nr> [<vertices nr per model>]]
+
+#include "../Corium3D/AssetsOps.h"
+#include "../Corium3D/MappedAssets.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+static size_t allocsNr = 0;
+
+void* operator new(size_t sz) {
+	allocsNr++;
+	if (void* ptr = malloc(sz))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	free(ptr);
+}
+
+using namespace Corium3D;
+
+namespace {
+
+	const unsigned int MESHES_NR = 8;
+	const unsigned int ANIMATIONS_NR = 2;
+	const unsigned int CHANNELS_NR = 32;
+	const unsigned int KEY_FRAMES_NR = 120;
+	const unsigned int INSTANCES_NR_PER_MODEL = 16;
+	const unsigned int RUNS_NR = 5;
+
+	void genModelDesc(unsigned int verticesNr, ModelDesc& outModelDesc) {
+		unsigned int meshVerticesNr = verticesNr / MESHES_NR;
+		outModelDesc.colladaPath = "synthetic.dae";
+		outModelDesc.verticesNr = meshVerticesNr * MESHES_NR;
+		outModelDesc.meshesNr = MESHES_NR;
+		outModelDesc.verticesNrsPerMesh.assign(MESHES_NR, meshVerticesNr);
+		outModelDesc.verticesColorsNrTotal = outModelDesc.verticesNr;
+		outModelDesc.extraColorsNrsPerMesh.assign(MESHES_NR, 0);
+		outModelDesc.extraColors.resize(MESHES_NR);
+		outModelDesc.texesNr = 0;
+		outModelDesc.texesNrsPerMesh.assign(MESHES_NR, 0);
+		outModelDesc.facesNr = outModelDesc.verticesNr;
+		outModelDesc.facesNrsPerMesh.assign(MESHES_NR, meshVerticesNr);
+		outModelDesc.progIdx = 0;
+		outModelDesc.bonesNr = CHANNELS_NR;
+		outModelDesc.bonesNrsPerMesh.assign(MESHES_NR, CHANNELS_NR / MESHES_NR);
+
+		outModelDesc.vertices.resize(outModelDesc.verticesNr);
+		for (unsigned int vertexIdx = 0; vertexIdx < outModelDesc.verticesNr; vertexIdx++)
+			outModelDesc.vertices[vertexIdx] = { glm::vec3((float)vertexIdx), { vertexIdx % CHANNELS_NR, 0, 0, 0 }, { 1.0f, 0.0f, 0.0f, 0.0f } };
+		outModelDesc.idxs.resize(3 * outModelDesc.facesNr);
+		for (unsigned int idxIdx = 0; idxIdx < outModelDesc.idxs.size(); idxIdx++)
+			outModelDesc.idxs[idxIdx] = idxIdx % meshVerticesNr;
+		outModelDesc.submeshesDescs.resize(MESHES_NR);
+		for (unsigned int meshIdx = 0; meshIdx < MESHES_NR; meshIdx++)
+			outModelDesc.submeshesDescs[meshIdx] = { meshIdx * meshVerticesNr, meshVerticesNr, 3 * meshIdx * meshVerticesNr, 3 * meshVerticesNr };
+		outModelDesc.meshesTransforms.assign(MESHES_NR, glm::mat4(1.0f));
+		outModelDesc.bonesOffsets.assign(CHANNELS_NR, glm::mat4(1.0f));
+
+		// a root holding the meshes and a chain of bones under it
+		outModelDesc.transformatsHierarchy.resize(CHANNELS_NR + 1);
+		outModelDesc.transformatsHierarchy[0] = { glm::mat4(1.0f), 1, std::numeric_limits<unsigned int>::max(), 0, MESHES_NR };
+		for (unsigned int boneIdx = 0; boneIdx < CHANNELS_NR; boneIdx++)
+			outModelDesc.transformatsHierarchy[boneIdx + 1] = { glm::mat4(1.0f), boneIdx + 1 < CHANNELS_NR ? 1u : 0u, boneIdx, MESHES_NR, 0 };
+		outModelDesc.transformatsHierarchyMeshesIdxs.resize(MESHES_NR);
+		for (unsigned int meshIdx = 0; meshIdx < MESHES_NR; meshIdx++)
+			outModelDesc.transformatsHierarchyMeshesIdxs[meshIdx] = meshIdx;
+
+		outModelDesc.animationsDescs.assign(ANIMATIONS_NR, { KEY_FRAMES_NR, CHANNELS_NR, MESHES_NR, CHANNELS_NR, CHANNELS_NR + 1, CHANNELS_NR, 1.0, (double)KEY_FRAMES_NR });
+		outModelDesc.animationsKeys.resize(ANIMATIONS_NR);
+		for (ModelDesc::AnimationKeys& animationKeys : outModelDesc.animationsKeys) {
+			for (unsigned int keyFrameIdx = 0; keyFrameIdx < KEY_FRAMES_NR; keyFrameIdx++)
+				animationKeys.keyFramesTimes.push_back(keyFrameIdx);
+			for (unsigned int channelIdx = 0; channelIdx < CHANNELS_NR; channelIdx++)
+				animationKeys.channelsNodesIdxs.push_back(channelIdx + 1);
+			animationKeys.scales.assign(CHANNELS_NR * KEY_FRAMES_NR, glm::vec3(1.0f));
+			animationKeys.rots.assign(CHANNELS_NR * KEY_FRAMES_NR, glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+			animationKeys.translations.assign(CHANNELS_NR * KEY_FRAMES_NR, glm::vec3(0.0f));
+		}
+
+		outModelDesc.boundingSphereCenter = glm::vec3(0.0f);
+		outModelDesc.boundingSphereRadius = 1.0f;
+		outModelDesc.colliderData.collisionPrimitive3DType = CollisionPrimitive3DType::NO_3D_COLLIDER;
+		outModelDesc.colliderData.collisionPrimitive2DType = CollisionPrimitive2DType::NO_2D_COLLIDER;
+	}
+
+	void genSceneData(unsigned int modelsNr, SceneData& outSceneData) {
+		outSceneData.staticModelsNr = modelsNr / 2;
+		outSceneData.sceneModelsData.resize(modelsNr);
+		for (unsigned int modelIdx = 0; modelIdx < modelsNr; modelIdx++) {
+			SceneData::SceneModelData& sceneModelData = outSceneData.sceneModelsData[modelIdx];
+			sceneModelData.modelIdx = modelIdx;
+			sceneModelData.isStatic = modelIdx < outSceneData.staticModelsNr;
+			sceneModelData.instancesNrMax = INSTANCES_NR_PER_MODEL;
+			sceneModelData.instancesTransformsInit.assign(INSTANCES_NR_PER_MODEL, { glm::vec3(0.0f), glm::vec3(1.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f) });
+		}
+	}
+
+	// touches the data the renderer uploads, so that both paths pay for faulting it in
+	template <class TModelDesc>
+	float sumVertices(std::vector<TModelDesc> const& modelDescs) {
+		float sum = 0.0f;
+		for (TModelDesc const& modelDesc : modelDescs) {
+			for (unsigned int vertexIdx = 0; vertexIdx < modelDesc.verticesNr; vertexIdx += 16)
+				sum += modelDesc.vertices[vertexIdx].pos.x;
+		}
+		return sum;
+	}
+
+	struct Measurement {
+		double loadMs;
+		double touchMs;
+		size_t allocsNr;
+	};
+
+	struct AssetsFileDesc {
+		char const* name;
+		char const* path;
+		AssetsCompressionParams compressionParams;
+	};
+
+	template <class TLoad>
+	Measurement measure(TLoad load) {
+		Measurement best = { 1e9, 1e9, 0 };
+		for (unsigned int runIdx = 0; runIdx < RUNS_NR; runIdx++) {
+			Measurement measurement = load();
+			if (measurement.loadMs + measurement.touchMs < best.loadMs + best.touchMs)
+				best = measurement;
+		}
+		return best;
+	}
+
+	double msSince(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	long fileSz(char const* path) {
+		FILE* file = fopen(path, "rb");
+		if (!file)
+			return -1;
+		fseek(file, 0, SEEK_END);
+		long sz = ftell(file);
+		fclose(file);
+		return sz;
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned int modelsNr = argc > 1 ? atoi(argv[1]) : 64;
+	unsigned int verticesNrPerModel = argc > 2 ? atoi(argv[2]) : 65536;
+
+	std::vector<ModelDesc> modelDescs(modelsNr);
+	std::vector<ModelDesc const*> modelDescsPtrs(modelsNr);
+	for (unsigned int modelIdx = 0; modelIdx < modelsNr; modelIdx++) {
+		genModelDesc(verticesNrPerModel, modelDescs[modelIdx]);
+		modelDescsPtrs[modelIdx] = &modelDescs[modelIdx];
+	}
+	SceneData sceneData;
+	genSceneData(modelsNr, sceneData);
+	std::vector<SceneData const*> scenesDataPtrs(1, &sceneData);
+	std::vector<AssetsFileDesc> mappedFilesDescs(4);
+	mappedFilesDescs[0] = { "mapped", "benchmark.mapped.assets", AssetsCompressionParams() };
+	mappedFilesDescs[1] = { "lz", "benchmark.lz.assets", AssetsCompressionParams() };
+	mappedFilesDescs[1].compressionParams.isCompressed = true;
+	mappedFilesDescs[2] = { "quantized", "benchmark.quantized.assets", AssetsCompressionParams() };
+	mappedFilesDescs[2].compressionParams.positionsErrorMax = 0.5f * verticesNrPerModel / 65535.0f;
+	mappedFilesDescs[2].compressionParams.animationKeysErrorMax = 0.001f;
+	mappedFilesDescs[3] = { "lz+quant", "benchmark.lz.quantized.assets", mappedFilesDescs[2].compressionParams };
+	mappedFilesDescs[3].compressionParams.isCompressed = true;
+
+	writeAssetsFile("benchmark.stream.assets", modelDescsPtrs, scenesDataPtrs);
+	for (AssetsFileDesc const& mappedFileDesc : mappedFilesDescs)
+		writeMappedAssetsFile(mappedFileDesc.path, modelDescsPtrs, scenesDataPtrs, mappedFileDesc.compressionParams);
+	modelDescs.clear();
+
+	float checksum = 0.0f;
+	Measurement streamMeasurement = measure([&checksum]() {
+		Measurement measurement;
+		size_t allocsNrStart = allocsNr;
+		auto start = std::chrono::steady_clock::now();
+		SceneData sceneData;
+		std::vector<ModelDesc> modelDescs;
+		std::vector<unsigned int> modelSceneModelIdxsMap;
+		readSceneAssets("benchmark.stream.assets", 0, sceneData, modelDescs, modelSceneModelIdxsMap);
+		measurement.loadMs = msSince(start);
+		measurement.allocsNr = allocsNr - allocsNrStart;
+		start = std::chrono::steady_clock::now();
+		checksum += sumVertices(modelDescs);
+		measurement.touchMs = msSince(start);
+		return measurement;
+	});
+
+	std::vector<Measurement> mappedMeasurements;
+	for (AssetsFileDesc const& mappedFileDesc : mappedFilesDescs) mappedMeasurements.push_back(measure([&checksum, &mappedFileDesc]() {
+		Measurement measurement;
+		size_t allocsNrStart = allocsNr;
+		auto start = std::chrono::steady_clock::now();
+		MappedAssets assets(mappedFileDesc.path);
+		SceneDataView sceneData;
+		std::vector<ModelDescView> modelDescs;
+		std::vector<unsigned int> modelSceneModelIdxsMap;
+		assets.getSceneAssets(0, sceneData, modelDescs, modelSceneModelIdxsMap);
+		measurement.loadMs = msSince(start);
+		measurement.allocsNr = allocsNr - allocsNrStart;
+		start = std::chrono::steady_clock::now();
+		checksum += sumVertices(modelDescs);
+		measurement.touchMs = msSince(start);
+		return measurement;
+	}));
+
+	printf("%u models x %u vertices (best of %u runs, checksum %g)\n", modelsNr, verticesNrPerModel, RUNS_NR, checksum);
+	printf("%-10s %12s %12s %12s %12s\n", "reader", "load [ms]", "touch [ms]", "allocations", "size [KB]");
+	printf("%-10s %12.2f %12.2f %12zu %12ld\n", "stream", streamMeasurement.loadMs, streamMeasurement.touchMs, streamMeasurement.allocsNr, fileSz("benchmark.stream.assets") / 1024);
+	for (unsigned int fileIdx = 0; fileIdx < mappedFilesDescs.size(); fileIdx++) {
+		Measurement const& measurement = mappedMeasurements[fileIdx];
+		printf("%-10s %12.2f %12.2f %12zu %12ld\n", mappedFilesDescs[fileIdx].name, measurement.loadMs, measurement.touchMs, measurement.allocsNr, fileSz(mappedFilesDescs[fileIdx].path) / 1024);
+	}
+
+	remove("benchmark.stream.assets");
+	for (AssetsFileDesc const& mappedFileDesc : mappedFilesDescs)
+		remove(mappedFileDesc.path);
+	return 0;
+}
@@ -0,0 +1,282 @@
+// Validates the models data baked into an assets file against the models' source files.
+// Standalone (no CLR) - builds on Linux against a system assimp:
+//   g++ -std=c++14 -O2 -I../externals/Include AssetsValidator.cpp ../Corium3D/AssetsOps.cpp ../Corium3D/MappedAssets.cpp ../Corium3D/LZCodec.cpp -lassimp -lpthread -o assetsValidator
+// usage: assetsValidator <assets file> [<models folder>]
+//   when a models folder is given, the sources are looked up in it by their file names instead of by their baked paths.
+
+#include "ModelBaker.h"
+#include "../Corium3D/MappedAssets.h"
+
+#include <assimp/Importer.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+using namespace Corium3D;
+
+namespace {
+
+	const float EPSILON = 1e-5f;
+
+	class ModelValidator {
+	public:
+		ModelValidator(unsigned int _modelIdx) : modelIdx(_modelIdx) {}
+
+		void check(bool cond, char const* what, unsigned int lmntIdx) {
+			if (!cond) {
+				if (mismatchesNr < MISMATCHES_REPORTED_NR_MAX)
+					printf("model #%u: %s mismatch at #%u\n", modelIdx, what, lmntIdx);
+				mismatchesNr++;
+			}
+		}
+
+		unsigned int getMismatchesNr() const { return mismatchesNr; }
+
+	private:
+		static const unsigned int MISMATCHES_REPORTED_NR_MAX = 16;
+		unsigned int modelIdx;
+		unsigned int mismatchesNr = 0;
+	};
+
+	bool areEqual(glm::vec3 const& vec1, glm::vec3 const& vec2) {
+		return std::abs(vec1.x - vec2.x) < EPSILON && std::abs(vec1.y - vec2.y) < EPSILON && std::abs(vec1.z - vec2.z) < EPSILON;
+	}
+
+	bool areEqual(glm::quat const& quat1, glm::quat const& quat2) {
+		// q and -q are the same rotation
+		return std::abs(std::abs(glm::dot(quat1, quat2)) - 1.0f) < EPSILON;
+	}
+
+	bool areEqual(glm::mat4 const& mat1, glm::mat4 const& mat2) {
+		for (unsigned int colIdx = 0; colIdx < 4; colIdx++) {
+			for (unsigned int rowIdx = 0; rowIdx < 4; rowIdx++) {
+				if (std::abs(mat1[colIdx][rowIdx] - mat2[colIdx][rowIdx]) >= EPSILON)
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	void collectNodesPreOrder(aiNode const* node, std::vector<aiNode const*>& nodesOut) {
+		nodesOut.push_back(node);
+		for (unsigned int childIdx = 0; childIdx < node->mNumChildren; childIdx++)
+			collectNodesPreOrder(node->mChildren[childIdx], nodesOut);
+	}
+
+	template <class TKey>
+	bool hasBakedKey(ModelDescView::AnimationKeysView const& animationKeys, ArrView<glm::vec3> const& bakedKeys, unsigned int channelIdx, TKey const& key) {
+		unsigned int keyFramesNr = animationKeys.keyFramesTimes.size();
+		auto keyFrameTimeIt = std::lower_bound(animationKeys.keyFramesTimes.begin(), animationKeys.keyFramesTimes.end(), key.mTime);
+		return keyFrameTimeIt != animationKeys.keyFramesTimes.end() && *keyFrameTimeIt == key.mTime &&
+			areEqual(bakedKeys[channelIdx * keyFramesNr + (keyFrameTimeIt - animationKeys.keyFramesTimes.begin())], assimp2glm(key.mValue));
+	}
+
+	bool hasBakedKey(ModelDescView::AnimationKeysView const& animationKeys, unsigned int channelIdx, aiQuatKey const& key) {
+		unsigned int keyFramesNr = animationKeys.keyFramesTimes.size();
+		auto keyFrameTimeIt = std::lower_bound(animationKeys.keyFramesTimes.begin(), animationKeys.keyFramesTimes.end(), key.mTime);
+		return keyFrameTimeIt != animationKeys.keyFramesTimes.end() && *keyFrameTimeIt == key.mTime &&
+			areEqual(animationKeys.rots[channelIdx * keyFramesNr + (keyFrameTimeIt - animationKeys.keyFramesTimes.begin())], assimp2glm(key.mValue));
+	}
+
+	void validateMeshes(aiScene const* scene, ModelDescView const& modelDesc, ModelValidator& validator) {
+		unsigned int verticesNr = 0, facesNr = 0, bonesNr = 0;
+		for (unsigned int meshIdx = 0; meshIdx < scene->mNumMeshes; meshIdx++) {
+			aiMesh const* mesh = scene->mMeshes[meshIdx];
+			ModelDesc::SubmeshDesc const& submeshDesc = modelDesc.submeshesDescs[meshIdx];
+			validator.check(submeshDesc.baseVertex == verticesNr && submeshDesc.verticesNr == mesh->mNumVertices, "submesh vertices range", meshIdx);
+			validator.check(submeshDesc.firstIdx == 3 * facesNr && submeshDesc.idxsNr == 3 * mesh->mNumFaces, "submesh indices range", meshIdx);
+			validator.check(modelDesc.verticesNrsPerMesh[meshIdx] == mesh->mNumVertices && modelDesc.facesNrsPerMesh[meshIdx] == mesh->mNumFaces, "mesh counts", meshIdx);
+			if (submeshDesc.baseVertex + mesh->mNumVertices > modelDesc.verticesNr || submeshDesc.firstIdx + 3 * mesh->mNumFaces > 3 * modelDesc.facesNr)
+				return;
+
+			ModelDesc::VertexData const* meshVertices = &modelDesc.vertices[submeshDesc.baseVertex];
+			for (unsigned int vertexIdx = 0; vertexIdx < mesh->mNumVertices; vertexIdx++)
+				validator.check(areEqual(meshVertices[vertexIdx].pos, assimp2glm(mesh->mVertices[vertexIdx])), "vertex position", verticesNr + vertexIdx);
+
+			for (unsigned int faceIdx = 0; faceIdx < mesh->mNumFaces; faceIdx++) {
+				aiFace const& face = mesh->mFaces[faceIdx];
+				unsigned int const* bakedFace = &modelDesc.idxs[submeshDesc.firstIdx + 3 * faceIdx];
+				validator.check(face.mNumIndices == 3 && std::equal(face.mIndices, face.mIndices + 3, bakedFace), "face", facesNr + faceIdx);
+			}
+
+			std::vector<unsigned int> verticesWeightsNrs(mesh->mNumVertices, 0);
+			for (unsigned int boneIdx = 0; boneIdx < mesh->mNumBones; boneIdx++) {
+				for (unsigned int weightIdx = 0; weightIdx < mesh->mBones[boneIdx]->mNumWeights; weightIdx++)
+					verticesWeightsNrs[mesh->mBones[boneIdx]->mWeights[weightIdx].mVertexId]++;
+			}
+			for (unsigned int boneIdx = 0; boneIdx < mesh->mNumBones; boneIdx++) {
+				aiBone const* bone = mesh->mBones[boneIdx];
+				validator.check(areEqual(modelDesc.bonesOffsets[bonesNr + boneIdx], assimp2glm(bone->mOffsetMatrix)), "bone offset", bonesNr + boneIdx);
+				for (unsigned int weightIdx = 0; weightIdx < bone->mNumWeights; weightIdx++) {
+					unsigned int vertexID = bone->mWeights[weightIdx].mVertexId;
+					// vertices with more weights than a vertex holds lose their least significant ones
+					if (verticesWeightsNrs[vertexID] > BONES_NR_PER_VERTEX_MAX)
+						continue;
+
+					ModelDesc::VertexData const& vertex = meshVertices[vertexID];
+					bool isFound = false;
+					for (unsigned int slotIdx = 0; slotIdx < BONES_NR_PER_VERTEX_MAX; slotIdx++)
+						isFound |= vertex.bonesIDs[slotIdx] == bonesNr + boneIdx && std::abs(vertex.bonesWeights[slotIdx] - bone->mWeights[weightIdx].mWeight) < EPSILON;
+					validator.check(isFound, "bone weight of vertex", verticesNr + vertexID);
+				}
+			}
+
+			verticesNr += mesh->mNumVertices;
+			facesNr += mesh->mNumFaces;
+			bonesNr += mesh->mNumBones;
+		}
+	}
+
+	// the levels are not compared against a source - only their consistency with the full detail meshes is checked
+	void validateLods(ModelDescView const& modelDesc, ModelValidator& validator) {
+		unsigned int lodsNr = modelDesc.lodsDescs.size();
+		validator.check(lodsNr < MODEL_LODS_NR_MAX && modelDesc.lodsSubmeshesDescs.size() == lodsNr * modelDesc.meshesNr, "levels of detail number", 0);
+		if (modelDesc.lodsSubmeshesDescs.size() != lodsNr * modelDesc.meshesNr)
+			return;
+
+		for (unsigned int lodIdx = 0; lodIdx < lodsNr; lodIdx++) {
+			ModelDesc::LodDesc const& lodDesc = modelDesc.lodsDescs[lodIdx];
+			unsigned int finerLodFacesNr = lodIdx == 0 ? modelDesc.facesNr : modelDesc.lodsDescs[lodIdx - 1].facesNr;
+			validator.check(lodDesc.facesNr < finerLodFacesNr, "level of detail faces number", lodIdx);
+			validator.check(lodIdx == 0 || lodDesc.screenSzMax <= modelDesc.lodsDescs[lodIdx - 1].screenSzMax, "level of detail screen size", lodIdx);
+			unsigned int lodIdxsNr = 0;
+			for (unsigned int meshIdx = 0; meshIdx < modelDesc.meshesNr; meshIdx++) {
+				ModelDesc::SubmeshDesc const& submeshDesc = modelDesc.submeshesDescs[meshIdx];
+				ModelDesc::SubmeshDesc const& lodSubmeshDesc = modelDesc.lodsSubmeshesDescs[lodIdx * modelDesc.meshesNr + meshIdx];
+				validator.check(lodSubmeshDesc.baseVertex == submeshDesc.baseVertex && lodSubmeshDesc.verticesNr == submeshDesc.verticesNr, "level of detail submesh vertices range", lodIdx);
+				validator.check(lodSubmeshDesc.idxsNr % 3 == 0 && lodSubmeshDesc.firstIdx + lodSubmeshDesc.idxsNr <= modelDesc.lodsIdxs.size(), "level of detail submesh indices range", lodIdx);
+				if (lodSubmeshDesc.firstIdx + lodSubmeshDesc.idxsNr > modelDesc.lodsIdxs.size())
+					continue;
+
+				for (unsigned int idxIdx = lodSubmeshDesc.firstIdx; idxIdx < lodSubmeshDesc.firstIdx + lodSubmeshDesc.idxsNr; idxIdx++)
+					validator.check(modelDesc.lodsIdxs[idxIdx] < submeshDesc.verticesNr, "level of detail index", idxIdx);
+				lodIdxsNr += lodSubmeshDesc.idxsNr;
+			}
+			validator.check(lodIdxsNr == 3 * lodDesc.facesNr, "level of detail indices number", lodIdx);
+		}
+	}
+
+	void validateHierarchy(aiScene const* scene, ModelDescView const& modelDesc, std::vector<aiNode const*> const& nodes, ModelValidator& validator) {
+		validator.check(modelDesc.transformatsHierarchy.size() == nodes.size(), "hierarchy nodes number", 0);
+		if (modelDesc.transformatsHierarchy.size() != nodes.size())
+			return;
+
+		for (unsigned int nodeIdx = 0; nodeIdx < nodes.size(); nodeIdx++) {
+			ModelDesc::TransformatsHierarchyNodeDesc const& nodeDesc = modelDesc.transformatsHierarchy[nodeIdx];
+			aiNode const* node = nodes[nodeIdx];
+			validator.check(areEqual(nodeDesc.transformat, assimp2glm(node->mTransformation)), "hierarchy node transformat", nodeIdx);
+			validator.check(nodeDesc.childrenNr == node->mNumChildren && nodeDesc.meshesNr == node->mNumMeshes, "hierarchy node structure", nodeIdx);
+			if (nodeDesc.meshesNr == node->mNumMeshes && nodeDesc.meshesIdxsBaseIdx + node->mNumMeshes <= modelDesc.transformatsHierarchyMeshesIdxs.size())
+				validator.check(std::equal(node->mMeshes, node->mMeshes + node->mNumMeshes, &modelDesc.transformatsHierarchyMeshesIdxs[nodeDesc.meshesIdxsBaseIdx]), "hierarchy node meshes", nodeIdx);
+			if (nodeDesc.boneIdx != std::numeric_limits<unsigned int>::max()) {
+				unsigned int boneIdxOverall = nodeDesc.boneIdx;
+				unsigned int meshIdx = 0;
+				while (meshIdx < scene->mNumMeshes && boneIdxOverall >= scene->mMeshes[meshIdx]->mNumBones)
+					boneIdxOverall -= scene->mMeshes[meshIdx++]->mNumBones;
+				validator.check(meshIdx < scene->mNumMeshes && scene->mMeshes[meshIdx]->mBones[boneIdxOverall]->mName == node->mName, "hierarchy node bone", nodeIdx);
+			}
+		}
+	}
+
+	void validateAnimations(aiScene const* scene, ModelDescView const& modelDesc, std::vector<aiNode const*> const& nodes, ModelValidator& validator) {
+		validator.check(modelDesc.animationsDescs.size() == scene->mNumAnimations, "animations number", 0);
+		if (modelDesc.animationsDescs.size() != scene->mNumAnimations)
+			return;
+
+		for (unsigned int animationIdx = 0; animationIdx < scene->mNumAnimations; animationIdx++) {
+			aiAnimation const* animation = scene->mAnimations[animationIdx];
+			ModelDesc::AnimationDesc const& animationDesc = modelDesc.animationsDescs[animationIdx];
+			ModelDescView::AnimationKeysView animationKeys = modelDesc.animationsKeys[animationIdx];
+			validator.check(animationDesc.dur == animation->mDuration && animationDesc.ticksPerSecond == animation->mTicksPerSecond, "animation timing", animationIdx);
+			validator.check(std::is_sorted(animationKeys.keyFramesTimes.begin(), animationKeys.keyFramesTimes.end()), "animation key frames order", animationIdx);
+			// every source key has to land on a key frame of its channel
+			for (unsigned int channelIdx = 0; channelIdx < animationDesc.channelsNr; channelIdx++) {
+				aiNodeAnim const* channel = NULL;
+				for (unsigned int sourceChannelIdx = 0; sourceChannelIdx < animation->mNumChannels; sourceChannelIdx++) {
+					if (animation->mChannels[sourceChannelIdx]->mNodeName == nodes[animationKeys.channelsNodesIdxs[channelIdx]]->mName)
+						channel = animation->mChannels[sourceChannelIdx];
+				}
+				validator.check(channel != NULL, "animation channel node", channelIdx);
+				if (!channel)
+					continue;
+
+				for (unsigned int keyIdx = 0; keyIdx < channel->mNumScalingKeys; keyIdx++)
+					validator.check(hasBakedKey(animationKeys, animationKeys.scales, channelIdx, channel->mScalingKeys[keyIdx]), "animation scaling key", keyIdx);
+				for (unsigned int keyIdx = 0; keyIdx < channel->mNumRotationKeys; keyIdx++)
+					validator.check(hasBakedKey(animationKeys, channelIdx, channel->mRotationKeys[keyIdx]), "animation rotation key", keyIdx);
+				for (unsigned int keyIdx = 0; keyIdx < channel->mNumPositionKeys; keyIdx++)
+					validator.check(hasBakedKey(animationKeys, animationKeys.translations, channelIdx, channel->mPositionKeys[keyIdx]), "animation translation key", keyIdx);
+			}
+		}
+	}
+
+	// returns the mismatches number, or UINT_MAX when the source could not be imported
+	unsigned int validateModel(unsigned int modelIdx, ModelDescView const& modelDesc, std::string const& sourcePath) {
+		Assimp::Importer importer;
+		aiScene const* scene = importer.ReadFile(sourcePath, MODEL_IMPORT_FLAGS);
+		if (!scene) {
+			printf("model #%u: failed to import \"%s\": %s\n", modelIdx, sourcePath.c_str(), importer.GetErrorString());
+			return std::numeric_limits<unsigned int>::max();
+		}
+
+		ModelValidator validator(modelIdx);
+		validator.check(modelDesc.meshesNr == scene->mNumMeshes, "meshes number", 0);
+		validator.check(modelDesc.vertices.size() == modelDesc.verticesNr && modelDesc.idxs.size() == 3 * modelDesc.facesNr, "baked buffers sizes", 0);
+		if (validator.getMismatchesNr() > 0)
+			return validator.getMismatchesNr();
+
+		validateMeshes(scene, modelDesc, validator);
+		validateLods(modelDesc, validator);
+		std::vector<aiNode const*> nodes;
+		collectNodesPreOrder(scene->mRootNode, nodes);
+		validateHierarchy(scene, modelDesc, nodes, validator);
+		validateAnimations(scene, modelDesc, nodes, validator);
+
+		return validator.getMismatchesNr();
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		printf("usage: %s <assets file> [<models folder>]\n", argv[0]);
+		return 2;
+	}
+
+	if (!std::ifstream(argv[1], std::ios::binary).is_open()) {
+		printf("failed to open \"%s\"\n", argv[1]);
+		return 2;
+	}
+
+	MappedAssets assets(argv[1]);
+	unsigned int modelsNr = assets.getModelsNr();
+	unsigned int invalidModelsNr = 0;
+	for (unsigned int modelIdx = 0; modelIdx < modelsNr; modelIdx++) {
+		ModelDescView modelDesc = assets.getModelDesc(modelIdx);
+		std::string colladaPath(modelDesc.colladaPath.begin(), modelDesc.colladaPath.end());
+		if (colladaPath.empty())
+			continue;
+
+		std::string sourcePath = colladaPath;
+		if (argc > 2) {
+			size_t fileNameIdx = colladaPath.find_last_of("/\\");
+			sourcePath = std::string(argv[2]) + "/" + (fileNameIdx == std::string::npos ? colladaPath : colladaPath.substr(fileNameIdx + 1));
+		}
+
+		unsigned int mismatchesNr = validateModel(modelIdx, modelDesc, sourcePath);
+		if (mismatchesNr == 0)
+			printf("model #%u: \"%s\" ok (%u vertices, %u faces, %u levels of detail, %u bones, %u animations)\n", modelIdx, sourcePath.c_str(),
+				modelDesc.verticesNr, modelDesc.facesNr, modelDesc.lodsDescs.size() + 1, modelDesc.bonesNr, modelDesc.animationsDescs.size());
+		else {
+			if (mismatchesNr != std::numeric_limits<unsigned int>::max())
+				printf("model #%u: %u mismatches\n", modelIdx, mismatchesNr);
+			invalidModelsNr++;
+		}
+	}
+
+	printf("%u of %u models failed validation\n", invalidModelsNr, modelsNr);
+	return invalidModelsNr > 0 ? 1 : 0;
+}
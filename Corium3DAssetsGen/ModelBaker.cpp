@@ -0,0 +1,301 @@
+#include "ModelBaker.h"
+
+#include <glm/gtx/norm.hpp>
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <unordered_map>
+
+namespace Corium3D {
+
+	// cells along the model's largest extent of the first coarser level's grid - halved level by level
+	const unsigned int LOD_GRID_CELLS_NR_MAX = 64;
+	// a level is kept only if it has at most this share of its finer level's faces
+	const float LOD_FACES_RATIO_MAX = 0.75f;
+
+	static void bakeMeshes(aiScene const* scene, ModelDesc& outModelDesc) {
+		outModelDesc.vertices.assign(outModelDesc.verticesNr, ModelDesc::VertexData{});
+		outModelDesc.idxs.resize(3 * outModelDesc.facesNr);
+		outModelDesc.submeshesDescs.resize(scene->mNumMeshes);
+		outModelDesc.bonesOffsets.resize(outModelDesc.bonesNr);
+		unsigned int processedVerticesNr = 0;
+		unsigned int processedIdxsNr = 0;
+		unsigned int processedBonesNr = 0;
+		std::vector<unsigned int> verticesProcessedWeightsNrs;
+		for (unsigned int meshIdx = 0; meshIdx < scene->mNumMeshes; meshIdx++) {
+			aiMesh const* mesh = scene->mMeshes[meshIdx];
+			ModelDesc::VertexData* meshVertices = &outModelDesc.vertices[processedVerticesNr];
+			for (unsigned int vertexIdx = 0; vertexIdx < mesh->mNumVertices; vertexIdx++)
+				meshVertices[vertexIdx].pos = assimp2glm(mesh->mVertices[vertexIdx]);
+
+			verticesProcessedWeightsNrs.assign(mesh->mNumVertices, 0);
+			for (unsigned int boneIdx = 0; boneIdx < mesh->mNumBones; boneIdx++) {
+				aiBone const* bone = mesh->mBones[boneIdx];
+				for (unsigned int weightIdx = 0; weightIdx < bone->mNumWeights; weightIdx++) {
+					unsigned int vertexID = bone->mWeights[weightIdx].mVertexId;
+					unsigned int& vertexProcessedWeightsNr = verticesProcessedWeightsNrs[vertexID];
+					// REMINDER: LimitBoneWeights sorts the weights descending - the dropped ones are the least significant
+					if (vertexProcessedWeightsNr < BONES_NR_PER_VERTEX_MAX) {
+						meshVertices[vertexID].bonesIDs[vertexProcessedWeightsNr] = processedBonesNr;
+						meshVertices[vertexID].bonesWeights[vertexProcessedWeightsNr] = bone->mWeights[weightIdx].mWeight;
+						vertexProcessedWeightsNr++;
+					}
+				}
+				outModelDesc.bonesOffsets[processedBonesNr++] = assimp2glm(bone->mOffsetMatrix);
+			}
+
+			// the faces are triangulated (aiProcess_Triangulate)
+			for (unsigned int faceIdx = 0; faceIdx < mesh->mNumFaces; faceIdx++)
+				std::copy(mesh->mFaces[faceIdx].mIndices, mesh->mFaces[faceIdx].mIndices + 3, &outModelDesc.idxs[processedIdxsNr + 3 * faceIdx]);
+
+			outModelDesc.submeshesDescs[meshIdx] = { processedVerticesNr, mesh->mNumVertices, processedIdxsNr, 3 * mesh->mNumFaces };
+			processedVerticesNr += mesh->mNumVertices;
+			processedIdxsNr += 3 * mesh->mNumFaces;
+		}
+	}
+
+	static unsigned int findBoneIdx(aiScene const* scene, aiString const& nodeName) {
+		unsigned int boneIdxOverall = 0;
+		for (unsigned int meshIdx = 0; meshIdx < scene->mNumMeshes; meshIdx++) {
+			for (unsigned int boneIdx = 0; boneIdx < scene->mMeshes[meshIdx]->mNumBones; boneIdx++) {
+				if (scene->mMeshes[meshIdx]->mBones[boneIdx]->mName == nodeName)
+					return boneIdxOverall;
+				boneIdxOverall++;
+			}
+		}
+
+		return std::numeric_limits<unsigned int>::max();
+	}
+
+	static void bakeTransformatsHierarchyRecurse(aiScene const* scene, aiNode const* node, glm::mat4 const& parentTransform, unsigned int depth,
+												 std::vector<aiNode const*>& nodesOut, unsigned int& depthMaxOut, ModelDesc& outModelDesc) {
+		glm::mat4 nodeTransform = parentTransform * assimp2glm(node->mTransformation);
+		for (unsigned int meshIdx = 0; meshIdx < node->mNumMeshes; meshIdx++)
+			outModelDesc.meshesTransforms[node->mMeshes[meshIdx]] = nodeTransform;
+
+		ModelDesc::TransformatsHierarchyNodeDesc nodeDesc;
+		nodeDesc.transformat = assimp2glm(node->mTransformation);
+		nodeDesc.childrenNr = node->mNumChildren;
+		// nodes that hold meshes are never treated as bones
+		nodeDesc.boneIdx = node->mNumMeshes ? std::numeric_limits<unsigned int>::max() : findBoneIdx(scene, node->mName);
+		nodeDesc.meshesIdxsBaseIdx = outModelDesc.transformatsHierarchyMeshesIdxs.size();
+		nodeDesc.meshesNr = node->mNumMeshes;
+		outModelDesc.transformatsHierarchyMeshesIdxs.insert(outModelDesc.transformatsHierarchyMeshesIdxs.end(), node->mMeshes, node->mMeshes + node->mNumMeshes);
+		outModelDesc.transformatsHierarchy.push_back(nodeDesc);
+		nodesOut.push_back(node);
+		if (depth > depthMaxOut)
+			depthMaxOut = depth;
+
+		for (unsigned int childIdx = 0; childIdx < node->mNumChildren; childIdx++)
+			bakeTransformatsHierarchyRecurse(scene, node->mChildren[childIdx], nodeTransform, depth + 1, nodesOut, depthMaxOut, outModelDesc);
+	}
+
+	template <class TKey, class TVal>
+	static TVal sampleKeys(TKey const* keys, unsigned int keysNr, double time, TVal(*interpolate)(TVal const&, TVal const&, float)) {
+		if (time <= keys[0].mTime)
+			return assimp2glm(keys[0].mValue);
+		if (time >= keys[keysNr - 1].mTime)
+			return assimp2glm(keys[keysNr - 1].mValue);
+
+		unsigned int endKeyIdx = 1;
+		while (keys[endKeyIdx].mTime < time)
+			endKeyIdx++;
+		TKey const& startKey = keys[endKeyIdx - 1];
+		TKey const& endKey = keys[endKeyIdx];
+		return interpolate(assimp2glm(startKey.mValue), assimp2glm(endKey.mValue), (float)((time - startKey.mTime) / (endKey.mTime - startKey.mTime)));
+	}
+
+	static glm::vec3 lerpVec3(glm::vec3 const& start, glm::vec3 const& end, float factor) {
+		return glm::mix(start, end, factor);
+	}
+
+	static glm::quat slerpQuat(glm::quat const& start, glm::quat const& end, float factor) {
+		return glm::slerp(start, end, factor);
+	}
+
+	static void bakeAnimation(aiAnimation const* animation, std::vector<aiNode const*> const& nodes, unsigned int depthMax,
+							  ModelDesc::AnimationDesc& outAnimationDesc, ModelDesc::AnimationKeys& outAnimationKeys, ModelDesc const& modelDesc) {
+		// channels follow the hierarchy's pre-order, as the instances animators walk it
+		std::vector<aiNodeAnim const*> channels;
+		for (unsigned int nodeIdx = 0; nodeIdx < nodes.size(); nodeIdx++) {
+			for (unsigned int channelIdx = 0; channelIdx < animation->mNumChannels; channelIdx++) {
+				if (animation->mChannels[channelIdx]->mNodeName == nodes[nodeIdx]->mName) {
+					channels.push_back(animation->mChannels[channelIdx]);
+					outAnimationKeys.channelsNodesIdxs.push_back(nodeIdx);
+					break;
+				}
+			}
+		}
+
+		// key frames are the union of all the channels' keys times
+		std::vector<double>& keyFramesTimes = outAnimationKeys.keyFramesTimes;
+		keyFramesTimes.push_back(0.0);
+		for (unsigned int channelIdx = 0; channelIdx < animation->mNumChannels; channelIdx++) {
+			aiNodeAnim const* channel = animation->mChannels[channelIdx];
+			for (unsigned int keyIdx = 0; keyIdx < channel->mNumScalingKeys; keyIdx++)
+				keyFramesTimes.push_back(channel->mScalingKeys[keyIdx].mTime);
+			for (unsigned int keyIdx = 0; keyIdx < channel->mNumRotationKeys; keyIdx++)
+				keyFramesTimes.push_back(channel->mRotationKeys[keyIdx].mTime);
+			for (unsigned int keyIdx = 0; keyIdx < channel->mNumPositionKeys; keyIdx++)
+				keyFramesTimes.push_back(channel->mPositionKeys[keyIdx].mTime);
+		}
+		std::sort(keyFramesTimes.begin(), keyFramesTimes.end());
+		keyFramesTimes.erase(std::unique(keyFramesTimes.begin(), keyFramesTimes.end()), keyFramesTimes.end());
+
+		unsigned int keyFramesNr = keyFramesTimes.size();
+		unsigned int channelsNr = channels.size();
+		outAnimationKeys.scales.resize(channelsNr * keyFramesNr);
+		outAnimationKeys.rots.resize(channelsNr * keyFramesNr);
+		outAnimationKeys.translations.resize(channelsNr * keyFramesNr);
+		for (unsigned int channelIdx = 0; channelIdx < channelsNr; channelIdx++) {
+			aiNodeAnim const* channel = channels[channelIdx];
+			for (unsigned int keyFrameIdx = 0; keyFrameIdx < keyFramesNr; keyFrameIdx++) {
+				unsigned int keyIdx = channelIdx * keyFramesNr + keyFrameIdx;
+				outAnimationKeys.scales[keyIdx] = sampleKeys(channel->mScalingKeys, channel->mNumScalingKeys, keyFramesTimes[keyFrameIdx], lerpVec3);
+				outAnimationKeys.rots[keyIdx] = sampleKeys(channel->mRotationKeys, channel->mNumRotationKeys, keyFramesTimes[keyFrameIdx], slerpQuat);
+				outAnimationKeys.translations[keyIdx] = sampleKeys(channel->mPositionKeys, channel->mNumPositionKeys, keyFramesTimes[keyFrameIdx], lerpVec3);
+			}
+		}
+
+		outAnimationDesc.keyFramesNr = keyFramesNr;
+		outAnimationDesc.channelsNr = channelsNr;
+		outAnimationDesc.transformatsHierarchyNodesMeshesNrs = modelDesc.transformatsHierarchyMeshesIdxs.size();
+		outAnimationDesc.transformatsHierarchyNodesChildrenNr = nodes.size() - 1;
+		outAnimationDesc.transformatsHierarchyNodesNr = nodes.size();
+		outAnimationDesc.transformatsHierarchyDepthMax = depthMax;
+		outAnimationDesc.dur = animation->mDuration;
+		outAnimationDesc.ticksPerSecond = animation->mTicksPerSecond;
+	}
+
+	// maps each of the mesh's vertices to its cell's representative - the cell's vertex closest to the cell's vertices'
+	// centroid. returns the largest distance of a vertex from its representative
+	static float clusterMeshVertices(ModelDesc::VertexData const* vertices, unsigned int verticesNr, glm::vec3 const& gridMin, float cellSz, std::vector<unsigned int>& outVerticesReps) {
+		struct Cluster {
+			glm::vec3 centroid;
+			unsigned int verticesNr;
+			unsigned int repIdx;
+			float repDistSq;
+		};
+		std::unordered_map<uint64_t, unsigned int> cellsClustersIdxs;
+		std::vector<Cluster> clusters;
+		std::vector<unsigned int> verticesClustersIdxs(verticesNr);
+		for (unsigned int vertexIdx = 0; vertexIdx < verticesNr; vertexIdx++) {
+			glm::uvec3 cell((vertices[vertexIdx].pos - gridMin) / cellSz);
+			uint64_t cellKey = (uint64_t)cell.x | (uint64_t)cell.y << 21 | (uint64_t)cell.z << 42;
+			auto cellIt = cellsClustersIdxs.emplace(cellKey, clusters.size());
+			if (cellIt.second)
+				clusters.push_back({ glm::vec3(0.0f), 0, 0, FLT_MAX });
+			Cluster& cluster = clusters[cellIt.first->second];
+			cluster.centroid += vertices[vertexIdx].pos;
+			cluster.verticesNr++;
+			verticesClustersIdxs[vertexIdx] = cellIt.first->second;
+		}
+		for (Cluster& cluster : clusters)
+			cluster.centroid /= (float)cluster.verticesNr;
+		for (unsigned int vertexIdx = 0; vertexIdx < verticesNr; vertexIdx++) {
+			Cluster& cluster = clusters[verticesClustersIdxs[vertexIdx]];
+			float distSq = glm::length2(vertices[vertexIdx].pos - cluster.centroid);
+			if (distSq < cluster.repDistSq) {
+				cluster.repDistSq = distSq;
+				cluster.repIdx = vertexIdx;
+			}
+		}
+
+		outVerticesReps.resize(verticesNr);
+		float displacementMax = 0.0f;
+		for (unsigned int vertexIdx = 0; vertexIdx < verticesNr; vertexIdx++) {
+			unsigned int repIdx = clusters[verticesClustersIdxs[vertexIdx]].repIdx;
+			outVerticesReps[vertexIdx] = repIdx;
+			displacementMax = std::max(displacementMax, glm::distance(vertices[vertexIdx].pos, vertices[repIdx].pos));
+		}
+
+		return displacementMax;
+	}
+
+	// appends the mesh's faces over the vertices' representatives, less the degenerate and the duplicate ones
+	static void collapseMeshFaces(unsigned int const* idxs, unsigned int facesNr, std::vector<unsigned int> const& verticesReps, std::vector<unsigned int>& outIdxs) {
+		std::set<std::array<unsigned int, 3>> faces;
+		for (unsigned int faceIdx = 0; faceIdx < facesNr; faceIdx++) {
+			std::array<unsigned int, 3> face = { verticesReps[idxs[3 * faceIdx]], verticesReps[idxs[3 * faceIdx + 1]], verticesReps[idxs[3 * faceIdx + 2]] };
+			if (face[0] == face[1] || face[1] == face[2] || face[2] == face[0])
+				continue;
+
+			// duplicates are matched rotated to their smallest index first, which keeps their winding
+			std::rotate(face.begin(), std::min_element(face.begin(), face.end()), face.end());
+			if (faces.insert(face).second)
+				outIdxs.insert(outIdxs.end(), face.begin(), face.end());
+		}
+	}
+
+	void bakeLods(ModelDesc& outModelDesc) {
+		outModelDesc.lodsDescs.clear();
+		outModelDesc.lodsIdxs.clear();
+		outModelDesc.lodsSubmeshesDescs.clear();
+		if (outModelDesc.verticesNr == 0 || outModelDesc.boundingSphereRadius <= 0.0f)
+			return;
+
+		glm::vec3 gridMin(FLT_MAX);
+		glm::vec3 gridMax(-FLT_MAX);
+		for (ModelDesc::VertexData const& vertex : outModelDesc.vertices) {
+			gridMin = glm::min(gridMin, vertex.pos);
+			gridMax = glm::max(gridMax, vertex.pos);
+		}
+		float extentMax = std::max(gridMax.x - gridMin.x, std::max(gridMax.y - gridMin.y, gridMax.z - gridMin.z));
+		if (extentMax <= 0.0f)
+			return;
+
+		// the grids share their origin, so a coarser grid's cells are unions of the finer grids' ones
+		std::vector<unsigned int> verticesReps;
+		std::vector<unsigned int> levelIdxs;
+		std::vector<ModelDesc::SubmeshDesc> levelSubmeshesDescs(outModelDesc.meshesNr);
+		unsigned int finerLevelFacesNr = outModelDesc.facesNr;
+		for (unsigned int cellsNr = LOD_GRID_CELLS_NR_MAX; cellsNr > 0 && outModelDesc.lodsDescs.size() < MODEL_LODS_NR_MAX - 1; cellsNr >>= 1) {
+			float cellSz = extentMax / cellsNr;
+			float displacementMax = 0.0f;
+			levelIdxs.clear();
+			for (unsigned int meshIdx = 0; meshIdx < outModelDesc.meshesNr; meshIdx++) {
+				ModelDesc::SubmeshDesc const& submeshDesc = outModelDesc.submeshesDescs[meshIdx];
+				displacementMax = std::max(displacementMax, clusterMeshVertices(&outModelDesc.vertices[submeshDesc.baseVertex], submeshDesc.verticesNr, gridMin, cellSz, verticesReps));
+				unsigned int meshFirstIdx = levelIdxs.size();
+				collapseMeshFaces(&outModelDesc.idxs[submeshDesc.firstIdx], submeshDesc.idxsNr / 3, verticesReps, levelIdxs);
+				levelSubmeshesDescs[meshIdx] = { submeshDesc.baseVertex, submeshDesc.verticesNr, (unsigned int)outModelDesc.lodsIdxs.size() + meshFirstIdx, (unsigned int)levelIdxs.size() - meshFirstIdx };
+			}
+
+			unsigned int levelFacesNr = levelIdxs.size() / 3;
+			if (levelFacesNr == 0)
+				break;
+			else if (levelFacesNr > LOD_FACES_RATIO_MAX * finerLevelFacesNr)
+				continue;
+
+			// the displacement projects to its share of the bounding sphere's projected diameter. coincident vertices
+			// collapse with no displacement at all
+			float screenSzMax = displacementMax > 0.0f ? LOD_SCREEN_ERROR_MAX * 2.0f * outModelDesc.boundingSphereRadius / displacementMax : FLT_MAX;
+			if (!outModelDesc.lodsDescs.empty())
+				screenSzMax = std::min(screenSzMax, outModelDesc.lodsDescs.back().screenSzMax);
+			outModelDesc.lodsDescs.push_back({ screenSzMax, levelFacesNr });
+			outModelDesc.lodsIdxs.insert(outModelDesc.lodsIdxs.end(), levelIdxs.begin(), levelIdxs.end());
+			outModelDesc.lodsSubmeshesDescs.insert(outModelDesc.lodsSubmeshesDescs.end(), levelSubmeshesDescs.begin(), levelSubmeshesDescs.end());
+			finerLevelFacesNr = levelFacesNr;
+		}
+	}
+
+	void bakeModelData(aiScene const* scene, ModelDesc& outModelDesc) {
+		bakeMeshes(scene, outModelDesc);
+
+		outModelDesc.meshesTransforms.resize(scene->mNumMeshes);
+		outModelDesc.transformatsHierarchy.clear();
+		outModelDesc.transformatsHierarchyMeshesIdxs.clear();
+		std::vector<aiNode const*> nodes;
+		unsigned int depthMax = 0;
+		bakeTransformatsHierarchyRecurse(scene, scene->mRootNode, glm::mat4(1.0f), 0, nodes, depthMax, outModelDesc);
+
+		outModelDesc.animationsDescs.resize(scene->mNumAnimations);
+		outModelDesc.animationsKeys.assign(scene->mNumAnimations, ModelDesc::AnimationKeys());
+		for (unsigned int animationIdx = 0; animationIdx < scene->mNumAnimations; animationIdx++)
+			bakeAnimation(scene->mAnimations[animationIdx], nodes, depthMax, outModelDesc.animationsDescs[animationIdx], outModelDesc.animationsKeys[animationIdx], outModelDesc);
+	}
+
+} // namespace Corium3D
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../Corium3D/AssetsOps.h"
+
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+namespace Corium3D {
+
+	// the import post-processing the baked data is generated with (LimitBoneWeights keeps the vertices within BONES_NR_PER_VERTEX_MAX)
+	const unsigned int MODEL_IMPORT_FLAGS = aiProcessPreset_TargetRealtime_Quality | aiProcess_JoinIdenticalVertices;
+
+	inline glm::mat4 assimp2glm(aiMatrix4x4 const& mat) {
+		return glm::mat4(mat.a1, mat.b1, mat.c1, mat.d1, mat.a2, mat.b2, mat.c2, mat.d2, mat.a3, mat.b3, mat.c3, mat.d3, mat.a4, mat.b4, mat.c4, mat.d4);
+	}
+
+	inline glm::quat assimp2glm(aiQuaternion const& quat) {
+		return glm::quat(quat.w, quat.x, quat.y, quat.z);
+	}
+
+	inline glm::vec3 assimp2glm(aiVector3D const& vec) {
+		return glm::vec3(vec.x, vec.y, vec.z);
+	}
+
+	// Bakes the scene's meshes, skeleton and animations into outModelDesc's baked buffers, in the layout the renderer uploads as is.
+	// The counts (verticesNr, facesNr, bonesNr, meshesNr) are expected to be filled from the same scene.
+	void bakeModelData(aiScene const* scene, ModelDesc& outModelDesc);
+
+	// the displacement of a level of detail's vertices allowed on screen - a share of the viewport's height
+	const float LOD_SCREEN_ERROR_MAX = 0.002f;
+
+	// Simplifies the baked meshes into the coarser levels of detail (ModelDesc::lodsDescs) by vertices clustering over grids
+	// that coarsen level by level: each cell's vertices collapse into the one closest to their centroid, so the levels
+	// reuse the model's vertices (and their bones weights) and only add indices. A level is kept only while it sheds enough
+	// of its finer level's faces. Its screen size is where its vertices' displacement projects to LOD_SCREEN_ERROR_MAX.
+	// The baked meshes and boundingSphereRadius are expected to be filled.
+	void bakeLods(ModelDesc& outModelDesc);
+
+} // namespace Corium3D
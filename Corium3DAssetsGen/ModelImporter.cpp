@@ -0,0 +1,211 @@
+#include "ModelImporter.h"
+#include "ModelBaker.h"
+#include "ModelsCache.h"
+
+#include "../Corium3D/BoundingSphere.h"
+#include "../Corium3D/AABB.h"
+#include "../Corium3D/ThreadPool.h"
+
+#include <assimp/IOSystem.hpp>
+#include <assimp/IOStream.hpp>
+#include <cstdio>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace Corium3DUtils;
+
+namespace Corium3D {
+
+	class FileIOStream : public Assimp::IOStream {
+	public:
+		FileIOStream(FILE* _file) : file(_file) {}
+		~FileIOStream() { fclose(file); }
+		size_t Read(void* buffer, size_t sz, size_t count) override { return fread(buffer, sz, count, file); }
+		size_t Write(const void* buffer, size_t sz, size_t count) override { return fwrite(buffer, sz, count, file); }
+		aiReturn Seek(size_t offset, aiOrigin origin) override {
+			int whence = origin == aiOrigin_SET ? SEEK_SET : origin == aiOrigin_CUR ? SEEK_CUR : SEEK_END;
+			return fseek(file, (long)offset, whence) == 0 ? aiReturn_SUCCESS : aiReturn_FAILURE;
+		}
+		size_t Tell() const override { return ftell(file); }
+		size_t FileSize() const override {
+			long pos = ftell(file);
+			fseek(file, 0, SEEK_END);
+			long sz = ftell(file);
+			fseek(file, pos, SEEK_SET);
+			return sz;
+		}
+		void Flush() override { fflush(file); }
+
+	private:
+		FILE* file;
+	};
+
+	// plain files access that records the paths of the files opened for reading
+	class RecordingIOSystem : public Assimp::IOSystem {
+	public:
+		RecordingIOSystem(std::vector<std::string>& _openedPaths) : openedPaths(_openedPaths) {}
+
+		bool Exists(const char* path) const override {
+			FILE* file = fopen(path, "rb");
+			if (!file)
+				return false;
+			fclose(file);
+			return true;
+		}
+
+		char getOsSeparator() const override {
+		#if defined(_WIN32) || defined(__VC32__) && !defined(__CYGWIN__) && !defined(__SCITECH_SNAP__) /* Win32 and WinCE */
+			return '\\';
+		#else
+			return '/';
+		#endif
+		}
+
+		Assimp::IOStream* Open(const char* path, const char* mode) override {
+			FILE* file = fopen(path, mode);
+			if (!file)
+				return NULL;
+			if (mode[0] == 'r' && std::find(openedPaths.begin(), openedPaths.end(), path) == openedPaths.end())
+				openedPaths.push_back(path);
+			return new FileIOStream(file);
+		}
+
+		void Close(Assimp::IOStream* stream) override { delete stream; }
+
+	private:
+		std::vector<std::string>& openedPaths;
+	};
+
+	static ImportedModel::BoundingCapsule calcBoundingCapsule(glm::vec3 const& aabbMinVertex, glm::vec3 const& aabbMaxVertex) {
+		ImportedModel::BoundingCapsule boundingCapsule;
+		boundingCapsule.center = 0.5f * (aabbMinVertex + aabbMaxVertex);
+		boundingCapsule.axisVec = glm::vec3(0.0f);
+
+		float verticesSpreadX = aabbMaxVertex.x - aabbMinVertex.x;
+		float verticesSpreadY = aabbMaxVertex.y - aabbMinVertex.y;
+		float verticesSpreadZ = aabbMaxVertex.z - aabbMinVertex.z;
+		if (verticesSpreadX > verticesSpreadY) {
+			if (verticesSpreadX > verticesSpreadZ) {
+				if (verticesSpreadZ > verticesSpreadY) {
+					// largest: X, 2nd: Z
+					boundingCapsule.axisVec.x = 1;
+					boundingCapsule.height = verticesSpreadX;
+					boundingCapsule.radius = 0.5f * verticesSpreadZ;
+				}
+				else {
+					// largest: X, 2nd: Y
+					boundingCapsule.axisVec.x = 1;
+					boundingCapsule.height = verticesSpreadX;
+					boundingCapsule.radius = 0.5f * verticesSpreadY;
+				}
+			}
+			else {
+				// largest: Z, 2nd: X
+				boundingCapsule.axisVec.z = 1;
+				boundingCapsule.height = verticesSpreadZ;
+				boundingCapsule.radius = 0.5f * verticesSpreadX;
+			}
+		}
+		else if (verticesSpreadY > verticesSpreadZ) {
+			if (verticesSpreadX > verticesSpreadZ) {
+				// largest: Y, 2nd: X
+				boundingCapsule.axisVec.y = 1;
+				boundingCapsule.height = verticesSpreadY;
+				boundingCapsule.radius = 0.5f * verticesSpreadX;
+			}
+			else { // largest: Y, 2nd: Z
+				boundingCapsule.axisVec.y = 1;
+				boundingCapsule.height = verticesSpreadY;
+				boundingCapsule.radius = 0.5f * verticesSpreadZ;
+			}
+		}
+		else {
+			// largest: Z, 2nd: Y
+			boundingCapsule.axisVec.z = 1;
+			boundingCapsule.height = verticesSpreadZ;
+			boundingCapsule.radius = 0.5f * verticesSpreadY;
+		}
+
+		return boundingCapsule;
+	}
+
+	void importModel(std::string const& modelPath, ImportedModel& outImportedModel) {
+		outImportedModel.modelDesc.reset(new ModelDesc);
+		ModelDesc& modelDesc = *outImportedModel.modelDesc;
+		modelDesc.colladaPath = modelPath;
+		modelDesc.verticesNr = 0;
+		modelDesc.verticesColorsNrTotal = 0;
+		modelDesc.texesNr = 0;
+		modelDesc.bonesNr = 0;
+		modelDesc.facesNr = 0;
+		modelDesc.progIdx = 0;
+
+		outImportedModel.importer.reset(new Assimp::Importer());
+		outImportedModel.sourcesPaths.assign(1, modelPath);
+		// REMINDER: the importer owns its IO handler
+		outImportedModel.importer->SetIOHandler(new RecordingIOSystem(outImportedModel.sourcesPaths));
+		//importer->SetPropertyFloat("PP_GSN_MAX_SMOOTHING_ANGLE", 120);
+		aiScene const* scene = outImportedModel.importer->ReadFile(modelPath, MODEL_IMPORT_FLAGS);
+		if (!scene)
+			throw std::runtime_error("Failed to import \"" + modelPath + "\": " + outImportedModel.importer->GetErrorString());
+		if (!scene->HasMeshes())
+			throw std::runtime_error("\"" + modelPath + "\" has no meshes !");
+
+		modelDesc.meshesNr = scene->mNumMeshes;
+		modelDesc.verticesNrsPerMesh = std::vector<unsigned int>(scene->mNumMeshes);
+		modelDesc.texesNrsPerMesh = std::vector<unsigned int>(scene->mNumMeshes);
+		modelDesc.bonesNrsPerMesh = std::vector<unsigned int>(scene->mNumMeshes);
+		modelDesc.facesNrsPerMesh = std::vector<unsigned int>(scene->mNumMeshes);
+		modelDesc.extraColorsNrsPerMesh = std::vector<unsigned int>(scene->mNumMeshes);
+		modelDesc.extraColors = std::vector<std::vector<std::array<float, 4>>>(scene->mNumMeshes);
+		for (unsigned int meshIdx = 0; meshIdx < scene->mNumMeshes; meshIdx++) {
+			const aiMesh* mesh = scene->mMeshes[meshIdx];
+			if (!mesh->HasPositions())
+				throw std::runtime_error("\"" + modelPath + "\": a mesh has no positions !");
+			else if (!mesh->HasFaces())
+				throw std::runtime_error("\"" + modelPath + "\": a mesh has no faces !");
+
+			modelDesc.verticesNrsPerMesh[meshIdx] += mesh->mNumVertices;
+			modelDesc.verticesNr += mesh->mNumVertices;
+			modelDesc.facesNrsPerMesh[meshIdx] = mesh->mNumFaces;
+			modelDesc.facesNr += mesh->mNumFaces;
+			modelDesc.bonesNrsPerMesh[meshIdx] = mesh->mNumBones;
+			modelDesc.bonesNr += mesh->mNumBones;
+		}
+
+		bakeModelData(scene, modelDesc);
+
+		std::vector<glm::vec3> vertices(modelDesc.verticesNr);
+		for (unsigned int vertexIdx = 0; vertexIdx < modelDesc.verticesNr; vertexIdx++)
+			vertices[vertexIdx] = modelDesc.vertices[vertexIdx].pos;
+
+		BoundingSphere bs = BoundingSphere::calcBoundingSphereEfficient(vertices.data(), modelDesc.verticesNr);
+		modelDesc.boundingSphereCenter = bs.getCenter();
+		modelDesc.boundingSphereRadius = bs.getRadius();
+		bakeLods(modelDesc);
+
+		AABB3D aabb3D = AABB3D::calcAABB(vertices.data(), modelDesc.verticesNr);
+		outImportedModel.aabbMinVertex = aabb3D.getMinVertex();
+		outImportedModel.aabbMaxVertex = aabb3D.getMaxVertex();
+		outImportedModel.boundingCapsule = calcBoundingCapsule(outImportedModel.aabbMinVertex, outImportedModel.aabbMaxVertex);
+
+		modelDesc.colliderData.collisionPrimitive3DType = CollisionPrimitive3DType::NO_3D_COLLIDER;
+		modelDesc.colliderData.collisionPrimitive2DType = CollisionPrimitive2DType::NO_2D_COLLIDER;
+	}
+
+	void importModels(std::vector<std::string> const& modelsPaths, std::vector<ImportedModel>& outImportedModels, unsigned int threadsNr, ModelsCache* cache) {
+		outImportedModels.clear();
+		outImportedModels.resize(modelsPaths.size());
+		// REMINDER: every import has its own Assimp::Importer - assimp is thread safe only across importers
+		ThreadPool threadPool(threadsNr);
+		threadPool.parallelFor(modelsPaths.size(), [&modelsPaths, &outImportedModels, cache](unsigned int modelIdx) {
+			if (cache && cache->load(modelsPaths[modelIdx], outImportedModels[modelIdx]))
+				return;
+
+			importModel(modelsPaths[modelIdx], outImportedModels[modelIdx]);
+			if (cache)
+				cache->store(outImportedModels[modelIdx]);
+		});
+	}
+
+} // namespace Corium3D
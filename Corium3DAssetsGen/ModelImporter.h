@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../Corium3D/AssetsOps.h"
+
+#include <assimp/Importer.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Corium3D {
+
+	// The per-model part of the assets generation, free of the CLR so that it runs on any platform and on any thread:
+	// the import, the baking (see bakeModelData) and the model's bounding volumes.
+	struct ImportedModel {
+		struct BoundingCapsule {
+			glm::vec3 center;
+			// along the vertices' largest spread
+			glm::vec3 axisVec;
+			float height;
+			// half the vertices' 2nd largest spread
+			float radius;
+		};
+
+		// keeps the imported scene alive. NULL for models loaded from the cache - modelDesc holds everything baked off it
+		std::unique_ptr<Assimp::Importer> importer;
+		std::unique_ptr<ModelDesc> modelDesc;
+		glm::vec3 aabbMinVertex;
+		glm::vec3 aabbMaxVertex;
+		BoundingCapsule boundingCapsule;
+		// every file the import read, the model's file first
+		std::vector<std::string> sourcesPaths;
+	};
+
+	class ModelsCache;
+
+	// throws std::runtime_error describing the failure if the model cannot be imported
+	void importModel(std::string const& modelPath, ImportedModel& outImportedModel);
+
+	// imports the models on threadsNr threads (0 - as many as there are hardware threads). outImportedModels[modelIdx]
+	// is modelsPaths[modelIdx]'s, whatever the order the imports finish in. If imports fail, the error of the first
+	// failing model (in modelsPaths' order) is thrown after all of them ran.
+	// With a cache, models whose sources are unchanged are loaded from it instead (with no importer), and the imported
+	// ones are stored to it.
+	void importModels(std::vector<std::string> const& modelsPaths, std::vector<ImportedModel>& outImportedModels, unsigned int threadsNr = 0, ModelsCache* cache = NULL);
+
+} // namespace Corium3D
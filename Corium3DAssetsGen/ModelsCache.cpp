@@ -0,0 +1,205 @@
+#include "ModelsCache.h"
+#include "ModelBaker.h"
+
+#include "../Corium3D/MappedAssets.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(_WIN32) || defined(__VC32__) && !defined(__CYGWIN__) && !defined(__SCITECH_SNAP__) /* Win32 and WinCE */
+	#include <direct.h>
+#else
+	#include <sys/stat.h>
+#endif
+
+namespace Corium3D {
+
+	const char MODELS_CACHE_ENTRY_MAGIC[4] = { 'C', '3', 'D', 'C' };
+	const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+	const uint64_t FNV_PRIME = 1099511628211ull;
+
+	struct ModelsCacheEntryHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t depsNr;
+		uint32_t reserved;
+		glm::vec3 aabbMinVertex;
+		glm::vec3 aabbMaxVertex;
+		ImportedModel::BoundingCapsule boundingCapsule;
+	};
+
+	static uint64_t hashBytes(void const* bytes, size_t sz, uint64_t hash) {
+		for (size_t byteIdx = 0; byteIdx < sz; byteIdx++)
+			hash = (hash ^ ((unsigned char const*)bytes)[byteIdx]) * FNV_PRIME;
+		return hash;
+	}
+
+	bool hashFile(std::string const& path, uint64_t& outHash, uint64_t seed) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open())
+			return false;
+
+		char buffer[1 << 16];
+		outHash = seed;
+		while (file) {
+			file.read(buffer, sizeof(buffer));
+			outHash = hashBytes(buffer, (size_t)file.gcount(), outHash);
+		}
+		return true;
+	}
+
+	// the generation parameters, the model's path and its file's content. returns false if the file cannot be read
+	static bool calcEntryKey(std::string const& modelPath, uint64_t& outKey) {
+		uint32_t params[] = { ModelsCache::MODELS_CACHE_VERSION, MODEL_IMPORT_FLAGS, MAPPED_ASSETS_VERSION };
+		uint64_t seed = hashBytes(params, sizeof(params), FNV_OFFSET_BASIS);
+		seed = hashBytes(modelPath.c_str(), modelPath.size() + 1, seed);
+		return hashFile(modelPath, outKey, seed);
+	}
+
+	static void createFolder(std::string const& folderPath) {
+	#if defined(_WIN32) || defined(__VC32__) && !defined(__CYGWIN__) && !defined(__SCITECH_SNAP__) /* Win32 and WinCE */
+		_mkdir(folderPath.c_str());
+	#else
+		mkdir(folderPath.c_str(), 0755);
+	#endif
+	}
+
+	// replaces dstPath, if it exists, with srcPath
+	static void renameFile(std::string const& srcPath, std::string const& dstPath) {
+		// rename() does not replace an existing file on Windows
+		remove(dstPath.c_str());
+		if (rename(srcPath.c_str(), dstPath.c_str()) != 0)
+			throw std::runtime_error(srcPath + " failed to rename to " + dstPath + ".");
+	}
+
+	bool ModelsCache::load(std::string const& modelPath, ImportedModel& outImportedModel) {
+		uint64_t key;
+		if (!calcEntryKey(modelPath, key)) {
+			reportModel(modelPath, false, modelPath + " missing");
+			return false;
+		}
+
+		std::string entryPath = getEntryPath(key);
+		std::ifstream depsFile(entryPath + ".deps", std::ios::binary);
+		ModelsCacheEntryHeader header;
+		if (!depsFile.is_open() || !depsFile.read((char*)&header, sizeof(header)) ||
+			memcmp(header.magic, MODELS_CACHE_ENTRY_MAGIC, sizeof(header.magic)) != 0 || header.version != MODELS_CACHE_VERSION) {
+			reportModel(modelPath, false, "new");
+			return false;
+		}
+
+		std::vector<std::string> sourcesPaths(1, modelPath);
+		for (unsigned int depIdx = 0; depIdx < header.depsNr; depIdx++) {
+			uint32_t depPathLen;
+			uint64_t depHash;
+			depsFile.read((char*)&depPathLen, sizeof(depPathLen));
+			std::string depPath(depPathLen, '\0');
+			depsFile.read(&depPath[0], depPathLen);
+			depsFile.read((char*)&depHash, sizeof(depHash));
+			if (!depsFile) {
+				reportModel(modelPath, false, "new");
+				return false;
+			}
+
+			uint64_t depHashCurrent;
+			if (!hashFile(depPath, depHashCurrent, FNV_OFFSET_BASIS)) {
+				reportModel(modelPath, false, depPath + " missing");
+				return false;
+			}
+			if (depHashCurrent != depHash) {
+				reportModel(modelPath, false, depPath + " changed");
+				return false;
+			}
+			sourcesPaths.push_back(depPath);
+		}
+
+		try {
+			MappedAssets modelAssets(entryPath + ".assets");
+			outImportedModel.modelDesc.reset(new ModelDesc);
+			copyModelDesc(modelAssets.getModelDesc(0), *outImportedModel.modelDesc);
+		}
+		catch (std::exception const&) {
+			reportModel(modelPath, false, "new");
+			return false;
+		}
+		outImportedModel.importer.reset();
+		outImportedModel.aabbMinVertex = header.aabbMinVertex;
+		outImportedModel.aabbMaxVertex = header.aabbMaxVertex;
+		outImportedModel.boundingCapsule = header.boundingCapsule;
+		outImportedModel.sourcesPaths = sourcesPaths;
+		reportModel(modelPath, true, std::string());
+
+		return true;
+	}
+
+	void ModelsCache::store(ImportedModel const& importedModel) {
+		uint64_t key;
+		if (!calcEntryKey(importedModel.sourcesPaths[0], key))
+			return;
+
+		createFolder(folderPath);
+		std::string entryPath = getEntryPath(key);
+		// an entry being rewritten is a miss until it is complete again - its deps file goes first and comes back last
+		remove((entryPath + ".deps").c_str());
+		std::vector<ModelDesc const*> modelDescs(1, importedModel.modelDesc.get());
+		writeMappedAssetsFile(entryPath + ".assets.tmp", modelDescs, std::vector<SceneData const*>());
+		renameFile(entryPath + ".assets.tmp", entryPath + ".assets");
+
+		ModelsCacheEntryHeader header;
+		memset((void*)&header, 0, sizeof(header));
+		memcpy(header.magic, MODELS_CACHE_ENTRY_MAGIC, sizeof(header.magic));
+		header.version = MODELS_CACHE_VERSION;
+		header.depsNr = importedModel.sourcesPaths.size() - 1;
+		header.aabbMinVertex = importedModel.aabbMinVertex;
+		header.aabbMaxVertex = importedModel.aabbMaxVertex;
+		header.boundingCapsule = importedModel.boundingCapsule;
+		std::string deps((char const*)&header, sizeof(header));
+		for (unsigned int sourceIdx = 1; sourceIdx < importedModel.sourcesPaths.size(); sourceIdx++) {
+			std::string const& depPath = importedModel.sourcesPaths[sourceIdx];
+			uint64_t depHash;
+			if (!hashFile(depPath, depHash, FNV_OFFSET_BASIS))
+				return;
+			uint32_t depPathLen = depPath.size();
+			deps.append((char const*)&depPathLen, sizeof(depPathLen));
+			deps.append(depPath);
+			deps.append((char const*)&depHash, sizeof(depHash));
+		}
+
+		std::ofstream depsFile(entryPath + ".deps.tmp", std::ios::binary);
+		if (!depsFile.is_open())
+			throw std::runtime_error(entryPath + ".deps.tmp failed to open.");
+		depsFile.write(deps.data(), deps.size());
+		depsFile.close();
+		if (!depsFile)
+			throw std::runtime_error(entryPath + ".deps.tmp failed to write.");
+		renameFile(entryPath + ".deps.tmp", entryPath + ".deps");
+	}
+
+	ModelsCache::Report ModelsCache::getReport() const {
+		std::lock_guard<std::mutex> lock(reportMutex);
+		// the models are loaded concurrently - sorted so that the report does not depend on the scheduling
+		Report sortedReport = report;
+		std::stable_sort(sortedReport.modelsReports.begin(), sortedReport.modelsReports.end(),
+			[](Report::ModelReport const& modelReport1, Report::ModelReport const& modelReport2) { return modelReport1.modelPath < modelReport2.modelPath; });
+		return sortedReport;
+	}
+
+	std::string ModelsCache::getEntryPath(uint64_t key) const {
+		char keyHex[17];
+		snprintf(keyHex, sizeof(keyHex), "%016llx", (unsigned long long)key);
+		return folderPath + "/" + keyHex;
+	}
+
+	void ModelsCache::reportModel(std::string const& modelPath, bool isHit, std::string const& missReason) {
+		std::lock_guard<std::mutex> lock(reportMutex);
+		if (isHit)
+			report.hitsNr++;
+		else
+			report.missesNr++;
+		report.modelsReports.push_back({ modelPath, isHit, missReason });
+	}
+
+} // namespace Corium3D
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "ModelImporter.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Corium3D {
+
+	// Content addressed cache of importModel()'s outputs (the baked ModelDesc and the bounding volumes), so that regenerating
+	// the assets re-imports only the models whose sources changed. An entry is keyed by the hash of the model's path, its
+	// file's content and the generation parameters (the import flags and MODELS_CACHE_VERSION), and records the hashes of
+	// the rest of the files the import read - it is reused only if all of them are unchanged.
+	// An entry is two files in the cache folder: <key>.deps (the bounding volumes and the sources' hashes) and <key>.assets
+	// (a mapped assets file holding the model alone, which reproduces its ModelDesc exactly). Both are written to temporary
+	// files and renamed into place, the deps file last, so that an interrupted store leaves a miss and never a partial hit.
+	// REMINDER: load() and store() are safe to call from several threads at once
+	class ModelsCache {
+	public:
+		// bump whenever the import or the baking produce different outputs out of the same sources
+		static const uint32_t MODELS_CACHE_VERSION = 1;
+
+		struct Report {
+			struct ModelReport {
+				std::string modelPath;
+				bool isHit;
+				// of a miss: "new", "<path> changed" or "<path> missing"
+				std::string missReason;
+			};
+
+			unsigned int hitsNr = 0;
+			unsigned int missesNr = 0;
+			// by the models' paths
+			std::vector<ModelReport> modelsReports;
+		};
+
+		ModelsCache(std::string const& _folderPath) : folderPath(_folderPath) {}
+		// returns false (a miss) if there is no up to date entry for the model
+		bool load(std::string const& modelPath, ImportedModel& outImportedModel);
+		void store(ImportedModel const& importedModel);
+		Report getReport() const;
+
+	private:
+		std::string folderPath;
+		mutable std::mutex reportMutex;
+		Report report;
+
+		std::string getEntryPath(uint64_t key) const;
+		void reportModel(std::string const& modelPath, bool isHit, std::string const& missReason);
+	};
+
+	// FNV-1a 64 of the file's content. returns false if the file cannot be read
+	bool hashFile(std::string const& path, uint64_t& outHash, uint64_t seed);
+
+} // namespace Corium3D
@@ -60,9 +60,9 @@ namespace Corium3DGI
             XElement avatarsPathsNode = root.Elements().Where(e => e.Attribute("Primitive").Value == primitiveName).FirstOrDefault();            
             avatars3D = new Model3DCollection();
             dxModelIDs = new List<uint>();                
-            foreach (XElement modelPathLmnt in avatarsPathsNode.Descendants().Where(e => e.Name == "Model"))
+            string[] modelsPaths = avatarsPathsNode.Descendants().Where(e => e.Name == "Model").Select(e => e.Value).ToArray();
+            foreach (AssetsGen.IModelAssetGen modelAssetGen in AssetsGen.createModelAssetGens(modelsPaths))
             {
-                AssetsGen.IModelAssetGen modelAssetGen = AssetsGen.createModelAssetGen(modelPathLmnt.Value);
                 avatars3D.Add(new GeometryModel3D(modelAssetGen.ManagedImportedDataRef.meshesGeometries[0],
                                                   new DiffuseMaterial(new SolidColorBrush(primitiveColor))));
                 modelAssetGen.Dispose();
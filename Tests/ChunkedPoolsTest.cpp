@@ -0,0 +1,185 @@
+// Tests ChunkedIdxPool, ChunkedObjPool and ChunkedObjPoolIteratable: growth by whole chunks when exhausted, released
+// indices reused before new ones (last released first), the high-water mark, and over random acquires and releases that
+// acquired indices are unique and below the capacity and that acquired objects keep their addresses and values as the
+// pools grow, and that the iteratable pool iterates exactly its acquired objects.
+// Standalone - builds on Linux:
+//   g++ -std=c++14 -O2 -DDEBUG=1 -I../Corium3D ChunkedPoolsTest.cpp ../Corium3D/IdxPool.cpp -o chunkedPoolsTest
+// usage: chunkedPoolsTest [<operations nr>]
+
+#include "Tests.h"
+#include "ChunkedObjPool.h"
+
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using namespace Corium3DUtils;
+
+namespace {
+
+	struct PooledObj {
+		unsigned int val;
+		unsigned int valCopy;
+
+		PooledObj(unsigned int _val) : val(_val), valCopy(_val) {}
+	};
+
+	void testChunkedIdxPool() {
+		// rounded up to 4
+		ChunkedIdxPool idxPool(5, 3);
+		CHECK(idxPool.getChunkSz() == 4);
+		CHECK(idxPool.getChunksNr() == 2);
+		CHECK(idxPool.getCapacity() == 8);
+		for (unsigned int idx = 0; idx < 8; idx++)
+			CHECK(idxPool.acquire() == idx);
+		CHECK(idxPool.getChunksNr() == 2);
+		// exhausted - grows by a chunk
+		CHECK(idxPool.acquire() == 8);
+		CHECK(idxPool.getChunksNr() == 3);
+		CHECK(idxPool.getCapacity() == 12);
+		CHECK(idxPool.getAcquiredIdxsNr() == 9);
+
+		// the last released index is reused first, and the fresh ones after the released ones
+		idxPool.release(2);
+		idxPool.release(6);
+		CHECK(idxPool.getAcquiredIdxsNr() == 7);
+		CHECK(idxPool.acquire() == 6);
+		CHECK(idxPool.acquire() == 2);
+		CHECK(idxPool.acquire() == 9);
+		CHECK(idxPool.getAcquiredIdxsNrMax() == 10);
+		idxPool.release(9);
+		idxPool.resetAcquiredIdxsNrMax();
+		CHECK(idxPool.getAcquiredIdxsNrMax() == 9);
+
+		bool hasThrown = false;
+		try {
+			idxPool.release(9);
+		}
+		catch (std::invalid_argument&) {
+			hasThrown = true;
+		}
+		CHECK(hasThrown);
+		hasThrown = false;
+		try {
+			ChunkedIdxPool zeroChunkIdxPool(4, 0);
+		}
+		catch (std::invalid_argument&) {
+			hasThrown = true;
+		}
+		CHECK(hasThrown);
+	}
+
+	void testChunkedObjPools() {
+		ChunkedObjPool<PooledObj> objPool(2, 2);
+		PooledObj* obj0 = objPool.acquire(10);
+		PooledObj* obj1 = objPool.acquire(11);
+		PooledObj* obj2 = objPool.acquire(12);
+		CHECK(objPool.getChunksNr() == 2);
+		CHECK(objPool.getCapacity() == 4);
+		// grown without relocating the acquired objects
+		CHECK(obj0->val == 10 && obj1->val == 11 && obj2->val == 12);
+		objPool.release(obj1);
+		CHECK(objPool.acquire(13) == obj1);
+		CHECK(obj1->val == 13);
+		CHECK(objPool.getAcquiredObjsNr() == 3);
+		CHECK(objPool.getReservedBytesNr() >= 4 * sizeof(PooledObj));
+
+		ChunkedObjPoolIteratable<PooledObj> objPoolIteratable(1, 2);
+		PooledObj* objs[5];
+		for (unsigned int objIdx = 0; objIdx < 5; objIdx++)
+			objs[objIdx] = objPoolIteratable.acquire(objIdx);
+		CHECK(objPoolIteratable.getChunksNr() == 3);
+		for (unsigned int objIdx = 0; objIdx < 5; objIdx++)
+			CHECK(objPoolIteratable.getObjIdxInPool(objs[objIdx]) == objIdx);
+		objPoolIteratable.release(objs[3]);
+		CHECK(objPoolIteratable.acquire(7) == objs[3]);
+		CHECK(objPoolIteratable.getObjIdxInPool(objs[3]) == 3);
+
+		// removes the odd objects while iterating
+		std::multiset<unsigned int> iteratedVals;
+		ChunkedObjPoolIteratable<PooledObj>::ObjPoolIt it(objPoolIteratable);
+		while (it.hasNext()) {
+			PooledObj& obj = it.next();
+			iteratedVals.insert(obj.val);
+			if (obj.val % 2)
+				it.removeCurr();
+		}
+		CHECK(iteratedVals == std::multiset<unsigned int>({ 0, 1, 2, 4, 7 }));
+		CHECK(objPoolIteratable.getAcquiredObjsNr() == 3);
+		iteratedVals.clear();
+		it.reset();
+		while (it.hasNext())
+			iteratedVals.insert(it.next().val);
+		CHECK(iteratedVals == std::multiset<unsigned int>({ 0, 2, 4 }));
+	}
+
+	void testRandomOperations(unsigned int operationsNr) {
+		std::mt19937 rng(9);
+		ChunkedIdxPool idxPool(10, 16);
+		ChunkedObjPoolIteratable<PooledObj> objPool(10, 16);
+		std::vector<unsigned int> acquiredIdxs;
+		std::vector<PooledObj*> acquiredObjs;
+		std::vector<bool> isIdxAcquired;
+		unsigned int errsNr = 0;
+		unsigned int reusedIdxsNr = 0;
+		unsigned int nextVal = 0;
+		for (unsigned int operationIdx = 0; operationIdx < operationsNr; operationIdx++) {
+			// biased to acquiring, so that the pools grow through several chunks
+			if (acquiredIdxs.empty() || rng() % 5 < 3) {
+				unsigned int idx = idxPool.acquire();
+				if (idx >= idxPool.getCapacity() || (idx < isIdxAcquired.size() && isIdxAcquired[idx]))
+					errsNr++;
+				if (idx < isIdxAcquired.size())
+					reusedIdxsNr++;
+				else
+					isIdxAcquired.resize(idx + 1, false);
+				isIdxAcquired[idx] = true;
+				acquiredIdxs.push_back(idx);
+				acquiredObjs.push_back(objPool.acquire(nextVal++));
+			}
+			else {
+				unsigned int releasedIdxIdx = rng() % acquiredIdxs.size();
+				isIdxAcquired[acquiredIdxs[releasedIdxIdx]] = false;
+				idxPool.release(acquiredIdxs[releasedIdxIdx]);
+				acquiredIdxs[releasedIdxIdx] = acquiredIdxs.back();
+				acquiredIdxs.pop_back();
+				objPool.release(acquiredObjs[releasedIdxIdx]);
+				acquiredObjs[releasedIdxIdx] = acquiredObjs.back();
+				acquiredObjs.pop_back();
+			}
+		}
+		if (idxPool.getAcquiredIdxsNr() != acquiredIdxs.size() || objPool.getAcquiredObjsNr() != acquiredObjs.size())
+			errsNr++;
+		// the capacity grows by no more than a chunk over the high-water mark
+		if (idxPool.getCapacity() >= idxPool.getAcquiredIdxsNrMax() + 2 * idxPool.getChunkSz())
+			errsNr++;
+		std::multiset<unsigned int> acquiredVals;
+		for (PooledObj* obj : acquiredObjs) {
+			if (obj->val != obj->valCopy)
+				errsNr++;
+			acquiredVals.insert(obj->val);
+		}
+		std::multiset<unsigned int> iteratedVals;
+		ChunkedObjPoolIteratable<PooledObj>::ObjPoolIt it(objPool);
+		while (it.hasNext())
+			iteratedVals.insert(it.next().val);
+		if (iteratedVals != acquiredVals)
+			errsNr++;
+		CHECK(errsNr == 0);
+		CHECK(reusedIdxsNr > 0);
+		CHECK(idxPool.getChunksNr() > 2);
+		printf("%u random operations: %u chunks, %u reused indices, %u errors\n", operationsNr, idxPool.getChunksNr(), reusedIdxsNr, errsNr);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned int operationsNr = argc > 1 ? strtoul(argv[1], NULL, 10) : 20000;
+	testChunkedIdxPool();
+	testChunkedObjPools();
+	testRandomOperations(operationsNr);
+
+	return Corium3DTests::reportResults("ChunkedPoolsTest");
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "FrustumCuller.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+
+// The culling tests' views - built as the renderer builds its camera's frustum - and the reference visibility test.
+namespace Corium3DTests {
+
+	const float FRUSTUM_NEAR = 0.1f;
+	const float FRUSTUM_FAR = 100.0f;
+
+	// a camera at cameraPos, looking along -z rotated by yaw about the y axis. fov is vertical
+	inline Corium3D::ViewFrustum genViewFrustum(glm::vec3 const& cameraPos, float yaw, float fov, float aspectRatio) {
+		using Corium3D::ViewFrustum;
+		ViewFrustum frustum;
+		glm::vec3 cameraLookDirection(sinf(yaw), 0.0f, -cosf(yaw));
+		glm::vec3 cameraUp(0.0f, 1.0f, 0.0f);
+		glm::vec3 cameraRight = glm::normalize(glm::cross(cameraLookDirection, cameraUp));
+		frustum.cameraPos = cameraPos;
+		frustum.cameraLookDirection = cameraLookDirection;
+		frustum.fov = fov;
+		frustum.fovSin = sinf(fov);
+
+		float vertQuartFovSin = sinf(0.25f * fov);
+		float vertQuartFovCos = cosf(0.25f * fov);
+		float horizonQuartFov = atanf(vertQuartFovSin / vertQuartFovCos * aspectRatio);
+		float horizonQuartFovSin = sinf(horizonQuartFov);
+		float horizonQuartFovCos = cosf(horizonQuartFov);
+		frustum.planes[ViewFrustum::TOP_PLANE].normal = glm::quat(vertQuartFovCos, vertQuartFovSin * cameraRight) * cameraUp;
+		frustum.planes[ViewFrustum::BOT_PLANE].normal = glm::quat(vertQuartFovCos, vertQuartFovSin * -cameraRight) * -cameraUp;
+		frustum.planes[ViewFrustum::LEFT_PLANE].normal = glm::quat(horizonQuartFovCos, horizonQuartFovSin * cameraUp) * -cameraRight;
+		frustum.planes[ViewFrustum::RIGHT_PLANE].normal = glm::quat(horizonQuartFovCos, horizonQuartFovSin * -cameraUp) * cameraRight;
+		frustum.planes[ViewFrustum::NEAR_PLANE].normal = -cameraLookDirection;
+		frustum.planes[ViewFrustum::FAR_PLANE].normal = cameraLookDirection;
+		for (unsigned int planeIdx = ViewFrustum::LEFT_PLANE; planeIdx < ViewFrustum::PLANES_NR; planeIdx++)
+			frustum.planes[planeIdx].updateD(cameraPos);
+		frustum.planes[ViewFrustum::NEAR_PLANE].updateD(cameraPos + FRUSTUM_NEAR * cameraLookDirection);
+		frustum.planes[ViewFrustum::FAR_PLANE].updateD(cameraPos + FRUSTUM_FAR * cameraLookDirection);
+		frustum.vpMat = glm::perspective(fov, aspectRatio, FRUSTUM_NEAR, FRUSTUM_FAR) * glm::lookAt(cameraPos, cameraPos + cameraLookDirection, cameraUp);
+
+		return frustum;
+	}
+
+	// a sphere outside of any of the frustum's planes is culled, and a sphere inside of all of them is not. a sphere that
+	// straddles planes is tested as the renderer tested each sphere before the culling was split from it - against the
+	// frustum's cone, then against each of its planes
+	inline bool isSphereVisibleRef(Corium3D::ViewFrustum const& frustum, glm::vec3 const& sphereC, float sphereR) {
+		bool isInsideAllPlanes = true;
+		for (unsigned int planeIdx = 0; planeIdx < Corium3D::ViewFrustum::PLANES_NR; planeIdx++) {
+			float dist = frustum.planes[planeIdx].signedDistFromPoint(sphereC);
+			if (dist > sphereR)
+				return false;
+			isInsideAllPlanes = isInsideAllPlanes && dist < -sphereR;
+		}
+		if (isInsideAllPlanes)
+			return true;
+
+		glm::vec3 u = frustum.cameraPos - sphereR * frustum.cameraLookDirection / frustum.fovSin;
+		glm::vec3 d = sphereC - u;
+		float e = glm::dot(frustum.cameraLookDirection, d);
+		if (!(e > 0 && e * e >= glm::dot(d, d) * cos(frustum.fov)))
+			return false;
+		d = sphereC - frustum.cameraPos;
+		e = -glm::dot(frustum.cameraLookDirection, d);
+		return !(e > 0 && e * e >= glm::dot(d, d) * sin(frustum.fov) && glm::dot(d, d) > sphereR * sphereR);
+	}
+
+} // namespace Corium3DTests
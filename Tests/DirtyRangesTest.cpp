@@ -0,0 +1,102 @@
+// Tests DirtyRanges: the coalesced ranges of a fixed set of marks, and over random marks that every marked element is
+// covered, that the ranges are sorted, start and end at marked elements and are more than the maximal gap apart, and that
+// no clean run within a range is longer than the maximal gap.
+// Standalone - builds on Linux:
+//   g++ -std=c++14 -O2 -I../Corium3D DirtyRangesTest.cpp ../Corium3D/DirtyRanges.cpp -o dirtyRangesTest
+// usage: dirtyRangesTest [<iterations nr>]
+
+#include "Tests.h"
+#include "DirtyRanges.h"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace Corium3DUtils;
+
+namespace {
+
+	void testFixedMarks() {
+		DirtyRanges dirtyRanges(2);
+		CHECK(!dirtyRanges.isDirty());
+		dirtyRanges.markDirty(10);
+		dirtyRanges.markDirty(11);
+		dirtyRanges.markDirty(12);
+		dirtyRanges.markDirty(3);
+		dirtyRanges.markDirty(15);
+		dirtyRanges.markDirty(30, 5);
+		dirtyRanges.markDirty(31);
+		dirtyRanges.markDirty(0);
+		dirtyRanges.markDirty(50, 0);
+		CHECK(dirtyRanges.isDirty());
+
+		std::vector<DirtyRanges::Range> const& ranges = dirtyRanges.coalesce();
+		CHECK(ranges.size() == 3);
+		if (ranges.size() == 3) {
+			CHECK(ranges[0].firstIdx == 0 && ranges[0].elementsNr == 4);
+			CHECK(ranges[1].firstIdx == 10 && ranges[1].elementsNr == 6);
+			CHECK(ranges[2].firstIdx == 30 && ranges[2].elementsNr == 5);
+		}
+		// the marks are cleared
+		CHECK(!dirtyRanges.isDirty());
+		CHECK(dirtyRanges.coalesce().empty());
+
+		dirtyRanges.markDirty(7);
+		dirtyRanges.clear();
+		CHECK(!dirtyRanges.isDirty());
+	}
+
+	void testRandomMarks(unsigned int iterationsNr) {
+		const unsigned int ELEMENTS_NR = 200;
+		std::mt19937 rng(3);
+		unsigned int uncoveredNr = 0;
+		unsigned int wrongRangesNr = 0;
+		for (unsigned int iterationIdx = 0; iterationIdx < iterationsNr; iterationIdx++) {
+			unsigned int maxGapSz = rng() % 4;
+			DirtyRanges dirtyRanges(maxGapSz);
+			std::vector<bool> marked(ELEMENTS_NR, false);
+			unsigned int marksNr = rng() % 30;
+			for (unsigned int markIdx = 0; markIdx < marksNr; markIdx++) {
+				unsigned int firstIdx = rng() % (ELEMENTS_NR - 10);
+				unsigned int elementsNr = 1 + rng() % 5;
+				dirtyRanges.markDirty(firstIdx, elementsNr);
+				for (unsigned int elementIdx = firstIdx; elementIdx < firstIdx + elementsNr; elementIdx++)
+					marked[elementIdx] = true;
+			}
+
+			std::vector<DirtyRanges::Range> const& ranges = dirtyRanges.coalesce();
+			std::vector<bool> covered(ELEMENTS_NR, false);
+			for (unsigned int rangeIdx = 0; rangeIdx < ranges.size(); rangeIdx++) {
+				DirtyRanges::Range const& range = ranges[rangeIdx];
+				unsigned int endIdx = range.firstIdx + range.elementsNr;
+				if (range.elementsNr == 0 || !marked[range.firstIdx] || !marked[endIdx - 1])
+					wrongRangesNr++;
+				if (rangeIdx > 0 && range.firstIdx <= ranges[rangeIdx - 1].firstIdx + ranges[rangeIdx - 1].elementsNr + maxGapSz)
+					wrongRangesNr++;
+				unsigned int cleanRunSz = 0;
+				for (unsigned int elementIdx = range.firstIdx; elementIdx < endIdx; elementIdx++) {
+					covered[elementIdx] = true;
+					cleanRunSz = marked[elementIdx] ? 0 : cleanRunSz + 1;
+					if (cleanRunSz > maxGapSz)
+						wrongRangesNr++;
+				}
+			}
+			for (unsigned int elementIdx = 0; elementIdx < ELEMENTS_NR; elementIdx++) {
+				if (marked[elementIdx] && !covered[elementIdx])
+					uncoveredNr++;
+			}
+		}
+		CHECK(uncoveredNr == 0);
+		CHECK(wrongRangesNr == 0);
+		printf("%u random iterations: %u uncovered elements, %u wrong ranges\n", iterationsNr, uncoveredNr, wrongRangesNr);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned int iterationsNr = argc > 1 ? strtoul(argv[1], NULL, 10) : 20000;
+	testFixedMarks();
+	testRandomMarks(iterationsNr);
+
+	return Corium3DTests::reportResults("DirtyRangesTest");
+}
@@ -0,0 +1,456 @@
+// Tests DrawListBuilder headlessly, over a BVH of random static instances of 2 models and mobile instances of a third:
+// each view's visible instances are the ones a naive traversal of the BVH's trees finds (testing every node from scratch),
+// the mobile ones listed along with their mobility interfaces' transformats, the draw lists cover the visible models'
+// meshes with their instances, grouped by program and sorted front to back within it, the visible instances' lists (in
+// their order), the transformats and the draw lists are the same element for element for any threads number, and
+// instances past a model's grown maximum are culled and listed along with the rest. Then over models with coarser levels
+// of detail: the instances' levels selected by their projected sizes, the selection's hysteresis band, the visible
+// instances listed level after level with a draw per (model, level, mesh) over its level's range of them, and the
+// triangles' stats.
+// Standalone - builds on Linux:
+//   g++ -std=c++17 -O2 -DDEBUG=1 -D_USE_MATH_DEFINES -fpermissive -include cstring -Wno-psabi -I../Corium3D -I../externals/Include
+//       DrawListBuilderTest.cpp ../Corium3D/DrawListBuilder.cpp ../Corium3D/FrustumCuller.cpp ../Corium3D/OcclusionCuller.cpp
+//       ../Corium3D/RadixSort.cpp ../Corium3D/ThreadPool.cpp ../Corium3D/BVH.cpp ../Corium3D/PhysicsEngine.cpp
+//       ../Corium3D/CollisionPrimitives.cpp ../Corium3D/AABB.cpp ../Corium3D/BoundingSphere.cpp ../Corium3D/MemoryReport.cpp
+//       ../Corium3D/IdxPool.cpp -lpthread -o drawListBuilderTest
+// usage: drawListBuilderTest [<instances nr>]
+
+#include "Tests.h"
+#include "CullingTests.h"
+#include "DrawListBuilder.h"
+#include "BVH.h"
+#include "CollisionPrimitives.h"
+#include "PhysicsEngine.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace Corium3D;
+using namespace Corium3DTests;
+
+namespace {
+
+	const unsigned int MODELS_NR = 3;
+	const unsigned int STATIC_MODELS_NR = 2;
+	const unsigned int MOBILE_MODEL_IDX = 2;
+	const unsigned int VIEWS_NR = 4;
+	const float INSTANCE_RADIUS = 1.7f;
+	const float FOV = 1.2f;
+	const float ASPECT_RATIO = 16.0f / 9.0f;
+	// inserted by the tests past the scene's random instances
+	const unsigned int INSERTED_INSTANCES_NR_MAX = 64;
+
+	typedef std::set<std::pair<unsigned int, unsigned int>> InstancesSet;
+
+	// model 0 - a mesh drawn with program 1. model 1 - 2 meshes drawn with program 0. model 2 (mobile) - a mesh drawn with
+	// program 1
+	struct TestModels {
+		unsigned int model0VerticesNrs[1] = { 3 };
+		unsigned int model0FacesNrs[1] = { 10 };
+		unsigned int model1VerticesNrs[2] = { 4, 6 };
+		unsigned int model1FacesNrs[2] = { 7, 8 };
+		unsigned int model2VerticesNrs[1] = { 5 };
+		unsigned int model2FacesNrs[1] = { 4 };
+		std::vector<ModelDescView> modelDescs;
+
+		TestModels() : modelDescs(MODELS_NR) {
+			modelDescs[0].meshesNr = 1;
+			modelDescs[0].progIdx = 1;
+			modelDescs[0].facesNr = 10;
+			modelDescs[0].verticesNrsPerMesh = ArrView<unsigned int>(model0VerticesNrs, 1);
+			modelDescs[0].facesNrsPerMesh = ArrView<unsigned int>(model0FacesNrs, 1);
+			modelDescs[1].meshesNr = 2;
+			modelDescs[1].progIdx = 0;
+			modelDescs[1].facesNr = 15;
+			modelDescs[1].verticesNrsPerMesh = ArrView<unsigned int>(model1VerticesNrs, 2);
+			modelDescs[1].facesNrsPerMesh = ArrView<unsigned int>(model1FacesNrs, 2);
+			modelDescs[2].meshesNr = 1;
+			modelDescs[2].progIdx = 1;
+			modelDescs[2].facesNr = 4;
+			modelDescs[2].verticesNrsPerMesh = ArrView<unsigned int>(model2VerticesNrs, 1);
+			modelDescs[2].facesNrsPerMesh = ArrView<unsigned int>(model2FacesNrs, 1);
+		}
+	};
+
+	// model 0 - 2 meshes with 2 coarser levels, the second mesh collapsed altogether at the coarsest. model 1 - a mesh with
+	// no coarser levels, laid out past model 0's levels' indices
+	struct LodsTestModels {
+		static const unsigned int LOD_MODEL_LODS_NR = 3;
+		unsigned int model0VerticesNrs[2] = { 8, 6 };
+		unsigned int model0FacesNrs[2] = { 12, 4 };
+		ModelDesc::LodDesc model0LodsDescs[2] = { { 0.2f, 8 }, { 0.05f, 2 } };
+		// [lodIdx * meshesNr + meshIdx]
+		ModelDesc::SubmeshDesc model0LodsSubmeshesDescs[4] = { { 0, 8, 0, 18 }, { 8, 6, 18, 6 }, { 0, 8, 24, 6 }, { 8, 6, 30, 0 } };
+		unsigned int model0LodsIdxs[30] = {};
+		unsigned int model1VerticesNrs[1] = { 3 };
+		unsigned int model1FacesNrs[1] = { 5 };
+		std::vector<ModelDescView> modelDescs;
+
+		LodsTestModels() : modelDescs(2) {
+			modelDescs[0].meshesNr = 2;
+			modelDescs[0].progIdx = 0;
+			modelDescs[0].facesNr = 16;
+			modelDescs[0].verticesNrsPerMesh = ArrView<unsigned int>(model0VerticesNrs, 2);
+			modelDescs[0].facesNrsPerMesh = ArrView<unsigned int>(model0FacesNrs, 2);
+			modelDescs[0].lodsDescs = ArrView<ModelDesc::LodDesc>(model0LodsDescs, 2);
+			modelDescs[0].lodsSubmeshesDescs = ArrView<ModelDesc::SubmeshDesc>(model0LodsSubmeshesDescs, 4);
+			modelDescs[0].lodsIdxs = ArrView<unsigned int>(model0LodsIdxs, 30);
+			modelDescs[1].meshesNr = 1;
+			modelDescs[1].progIdx = 0;
+			modelDescs[1].facesNr = 5;
+			modelDescs[1].verticesNrsPerMesh = ArrView<unsigned int>(model1VerticesNrs, 1);
+			modelDescs[1].facesNrsPerMesh = ArrView<unsigned int>(model1FacesNrs, 1);
+		}
+	};
+
+	class TestScene {
+	public:
+		// the static instances are of the static models in turns
+		TestScene(unsigned int instancesNr, unsigned int mobileInstancesNr) :
+				collisionPrimitivesFactory(collisionVolumesNrsMaxima(instancesNr + mobileInstancesNr + INSERTED_INSTANCES_NR_MAX), collisionPerimetersNrsMaxima),
+				physicsEngine(mobileInstancesNr + 1, 1.0f / 60.0f),
+				bvh(2 * instancesNr + INSERTED_INSTANCES_NR_MAX, 2 * mobileInstancesNr + 10, 1, 1, 2 * instancesNr, 2 * instancesNr) {
+			std::mt19937 rng(1);
+			std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+			for (unsigned int instanceIdx = 0; instanceIdx < instancesNr; instanceIdx++)
+				insert(instanceIdx % STATIC_MODELS_NR, instanceIdx / STATIC_MODELS_NR, glm::vec3(100.0f * unit(rng), 10.0f * unit(rng), 100.0f * unit(rng)));
+			for (unsigned int instanceIdx = 0; instanceIdx < mobileInstancesNr; instanceIdx++)
+				insertMobile(instanceIdx, glm::vec3(100.0f * unit(rng), 10.0f * unit(rng), 100.0f * unit(rng)));
+		}
+
+		void insert(unsigned int modelIdx, unsigned int instanceIdx, glm::vec3 const& center) {
+			bvh.insert(AABB3DRotatable(center - 1.0f, center + 1.0f), BoundingSphere(center, INSTANCE_RADIUS), modelIdx, instanceIdx,
+					   *collisionPrimitivesFactory.genCollisionSphere(glm::vec3(0.0f), 1.0f));
+		}
+
+		// an instance of the mobile model, turned by its index - the transformats are told apart
+		void insertMobile(unsigned int instanceIdx, glm::vec3 const& center) {
+			Transform3D transform;
+			transform.translate = center;
+			transform.rot = glm::angleAxis(0.01f * instanceIdx, glm::vec3(0.0f, 1.0f, 0.0f));
+			PhysicsEngine::MobilityInterface* mobilityInterface = physicsEngine.addMobileGameLmnt(transform, NULL, 0);
+			bvh.insert(AABB3DRotatable(center - 1.0f, center + 1.0f), BoundingSphere(center, INSTANCE_RADIUS), MOBILE_MODEL_IDX, instanceIdx,
+					   *collisionPrimitivesFactory.genCollisionSphere(glm::vec3(0.0f), 1.0f), *mobilityInterface);
+			if (mobileInstancesTransformats.size() <= instanceIdx)
+				mobileInstancesTransformats.resize(instanceIdx + 1);
+			mobileInstancesTransformats[instanceIdx] = mobilityInterface->getTransformat();
+		}
+
+		BVH& accessBVH() { return bvh; }
+		glm::mat4 const& getMobileInstanceTransformat(unsigned int instanceIdx) const { return mobileInstancesTransformats[instanceIdx]; }
+
+		// a naive traversal of the BVH's static and mobile trees, testing every node it visits from scratch
+		InstancesSet findVisibleInstances(ViewFrustum const& frustum) const {
+			InstancesSet visibleInstances;
+			std::vector<BVH::Node3D*> nodesStack;
+			if (bvh.getStaticNodes3DRoot())
+				nodesStack.push_back(bvh.getStaticNodes3DRoot());
+			if (bvh.getMobileNodes3DRoot())
+				nodesStack.push_back(bvh.getMobileNodes3DRoot());
+			while (!nodesStack.empty()) {
+				BVH::Node3D* node = nodesStack.back();
+				nodesStack.pop_back();
+				BoundingSphere const& boundingSphere = node->getBoundingSphere();
+				if (!isSphereVisibleRef(frustum, boundingSphere.getCenter(), boundingSphere.getRadius()))
+					continue;
+				if (node->isLeaf()) {
+					BVH::DataNode3D* dataNode = static_cast<BVH::DataNode3D*>(node);
+					visibleInstances.insert({ dataNode->getModelIdx(), dataNode->getInstanceIdx() });
+				}
+				else {
+					nodesStack.push_back(static_cast<BVH::Node3D*>(node->getChild(0)));
+					nodesStack.push_back(static_cast<BVH::Node3D*>(node->getChild(1)));
+				}
+			}
+			return visibleInstances;
+		}
+
+	private:
+		unsigned int collisionPerimetersNrsMaxima[3] = { 1, 1, 1 };
+		unsigned int collisionVolumesNrsMaximaArr[3];
+		CollisionPrimitivesFactory collisionPrimitivesFactory;
+		PhysicsEngine physicsEngine;
+		BVH bvh;
+		std::vector<glm::mat4> mobileInstancesTransformats;
+
+		unsigned int* collisionVolumesNrsMaxima(unsigned int instancesNr) {
+			collisionVolumesNrsMaximaArr[0] = collisionVolumesNrsMaximaArr[1] = collisionVolumesNrsMaximaArr[2] = 2 * instancesNr;
+			return collisionVolumesNrsMaximaArr;
+		}
+	};
+
+	InstancesSet listVisibleInstances(DrawListBuilder const& drawListBuilder, unsigned int viewIdx, unsigned int modelsNr = MODELS_NR) {
+		InstancesSet visibleInstances;
+		for (unsigned int modelIdx = 0; modelIdx < modelsNr; modelIdx++) {
+			unsigned int const* visibleInstancesIdxs = drawListBuilder.getVisibleInstancesIdxs(viewIdx, modelIdx);
+			for (unsigned int visibleInstanceIdx = 0; visibleInstanceIdx < drawListBuilder.getVisibleInstancesNr(viewIdx, modelIdx); visibleInstanceIdx++)
+				visibleInstances.insert({ modelIdx, visibleInstancesIdxs[visibleInstanceIdx] });
+		}
+		return visibleInstances;
+	}
+
+	// the mobile model's instances are listed along with their transformats
+	void checkMobileInstancesTransformats(DrawListBuilder const& drawListBuilder, unsigned int viewIdx, TestScene const& scene) {
+		unsigned int const* visibleInstancesIdxs = drawListBuilder.getVisibleInstancesIdxs(viewIdx, MOBILE_MODEL_IDX);
+		glm::mat4 const* visibleInstancesTransformats = drawListBuilder.getVisibleInstancesTransformats(viewIdx, MOBILE_MODEL_IDX);
+		unsigned int misplacedTransformatsNr = 0;
+		for (unsigned int visibleInstanceIdx = 0; visibleInstanceIdx < drawListBuilder.getVisibleInstancesNr(viewIdx, MOBILE_MODEL_IDX); visibleInstanceIdx++) {
+			if (visibleInstancesTransformats[visibleInstanceIdx] != scene.getMobileInstanceTransformat(visibleInstancesIdxs[visibleInstanceIdx]))
+				misplacedTransformatsNr++;
+		}
+		CHECK(misplacedTransformatsNr == 0);
+	}
+
+	// the meshes are laid out model after model: model 0's mesh, then model 1's 2 meshes, then model 2's mesh
+	void checkDrawList(DrawListBuilder const& drawListBuilder, unsigned int viewIdx, TestModels const& models) {
+		std::vector<DrawListBuilder::Draw> const& drawList = drawListBuilder.getDrawList(viewIdx);
+		const unsigned int meshesFirstIdxs[MODELS_NR][2] = { { 0, 0 }, { 30, 51 }, { 75, 0 } };
+		const unsigned int meshesBaseVertices[MODELS_NR][2] = { { 0, 0 }, { 3, 7 }, { 13, 0 } };
+		unsigned int modelsDrawnInstancesNrs[MODELS_NR][2] = {};
+		std::set<unsigned int> finishedProgs;
+		unsigned int stateChangesNr = 0;
+		for (unsigned int drawIdx = 0; drawIdx < drawList.size(); drawIdx++) {
+			DrawListBuilder::Draw const& draw = drawList[drawIdx];
+			ModelDescView const& modelDesc = models.modelDescs[draw.modelIdx];
+			CHECK(draw.progIdx == modelDesc.progIdx);
+			CHECK(draw.lodIdx == 0);
+			CHECK(draw.idxsNr == 3 * modelDesc.facesNrsPerMesh[draw.meshIdx]);
+			CHECK(draw.firstIdx == meshesFirstIdxs[draw.modelIdx][draw.meshIdx]);
+			CHECK(draw.baseVertex == meshesBaseVertices[draw.modelIdx][draw.meshIdx]);
+			CHECK(draw.firstInstance == 0);
+			modelsDrawnInstancesNrs[draw.modelIdx][draw.meshIdx] += draw.instancesNr;
+			// a program's draws are contiguous, and sorted front to back
+			if (drawIdx == 0 || drawList[drawIdx - 1].progIdx != draw.progIdx) {
+				stateChangesNr++;
+				if (drawIdx > 0) {
+					CHECK(finishedProgs.count(draw.progIdx) == 0);
+					finishedProgs.insert(drawList[drawIdx - 1].progIdx);
+				}
+			}
+			else
+				CHECK(DrawListBuilder::genDrawSortKey(DrawListBuilder::OPAQUE_PASS, 0, drawList[drawIdx - 1].depth, 0) <=
+					  DrawListBuilder::genDrawSortKey(DrawListBuilder::OPAQUE_PASS, 0, draw.depth, 0));
+		}
+		for (unsigned int modelIdx = 0; modelIdx < MODELS_NR; modelIdx++) {
+			for (unsigned int meshIdx = 0; meshIdx < models.modelDescs[modelIdx].meshesNr; meshIdx++)
+				CHECK(modelsDrawnInstancesNrs[modelIdx][meshIdx] == drawListBuilder.getVisibleInstancesNr(viewIdx, modelIdx));
+		}
+		CHECK(drawListBuilder.getStats(viewIdx).drawsNr == drawList.size());
+		CHECK(drawListBuilder.getStats(viewIdx).stateChangesNr == stateChangesNr);
+	}
+
+	void genViewsFrusta(ViewFrustum* outFrusta) {
+		for (unsigned int viewIdx = 0; viewIdx < VIEWS_NR; viewIdx++)
+			outFrusta[viewIdx] = genViewFrustum(glm::vec3(20.0f * viewIdx, 0.0f, 0.0f), 0.3f + 1.5f * viewIdx, FOV, ASPECT_RATIO);
+	}
+
+	// a view's results as listed, in their order
+	struct ViewResults {
+		std::vector<std::vector<unsigned int>> modelsVisibleInstancesIdxs;
+		std::vector<glm::mat4> visibleMobileInstancesTransformats;
+		std::vector<DrawListBuilder::Draw> drawList;
+	};
+
+	ViewResults copyViewResults(DrawListBuilder const& drawListBuilder, unsigned int viewIdx) {
+		ViewResults viewResults;
+		for (unsigned int modelIdx = 0; modelIdx < MODELS_NR; modelIdx++) {
+			unsigned int const* visibleInstancesIdxs = drawListBuilder.getVisibleInstancesIdxs(viewIdx, modelIdx);
+			viewResults.modelsVisibleInstancesIdxs.emplace_back(visibleInstancesIdxs, visibleInstancesIdxs + drawListBuilder.getVisibleInstancesNr(viewIdx, modelIdx));
+		}
+		glm::mat4 const* visibleInstancesTransformats = drawListBuilder.getVisibleInstancesTransformats(viewIdx, MOBILE_MODEL_IDX);
+		viewResults.visibleMobileInstancesTransformats.assign(visibleInstancesTransformats, visibleInstancesTransformats + drawListBuilder.getVisibleInstancesNr(viewIdx, MOBILE_MODEL_IDX));
+		viewResults.drawList = drawListBuilder.getDrawList(viewIdx);
+		return viewResults;
+	}
+
+	bool areDrawsEqual(DrawListBuilder::Draw const& draw1, DrawListBuilder::Draw const& draw2) {
+		return draw1.progIdx == draw2.progIdx && draw1.modelIdx == draw2.modelIdx && draw1.meshIdx == draw2.meshIdx && draw1.lodIdx == draw2.lodIdx &&
+			   draw1.idxsNr == draw2.idxsNr && draw1.firstIdx == draw2.firstIdx && draw1.baseVertex == draw2.baseVertex &&
+			   draw1.firstInstance == draw2.firstInstance && draw1.instancesNr == draw2.instancesNr && draw1.depth == draw2.depth;
+	}
+
+	bool areViewResultsEqual(ViewResults const& viewResults1, ViewResults const& viewResults2) {
+		return viewResults1.modelsVisibleInstancesIdxs == viewResults2.modelsVisibleInstancesIdxs &&
+			   viewResults1.visibleMobileInstancesTransformats == viewResults2.visibleMobileInstancesTransformats &&
+			   viewResults1.drawList.size() == viewResults2.drawList.size() &&
+			   std::equal(viewResults1.drawList.begin(), viewResults1.drawList.end(), viewResults2.drawList.begin(), areDrawsEqual);
+	}
+
+	void testCulling(unsigned int instancesNr) {
+		TestModels models;
+		unsigned int mobileInstancesNr = instancesNr / 10;
+		TestScene scene(instancesNr, mobileInstancesNr);
+		ViewFrustum frusta[VIEWS_NR];
+		genViewsFrusta(frusta);
+		unsigned int modelsInstancesNrsMaxima[MODELS_NR] = { instancesNr / STATIC_MODELS_NR + 1, instancesNr / STATIC_MODELS_NR + 1, mobileInstancesNr };
+
+		std::vector<ViewResults> singleThreadedResults;
+		for (unsigned int threadsNr : { 0u, 1u, 2u, 4u }) {
+			Corium3DUtils::ThreadPool* threadPool = threadsNr ? new Corium3DUtils::ThreadPool(threadsNr) : NULL;
+			DrawListBuilder drawListBuilder(models.modelDescs, STATIC_MODELS_NR, modelsInstancesNrsMaxima, threadPool);
+			// the second build runs on the buffers and the coherency records of the first
+			for (unsigned int buildIdx = 0; buildIdx < 2; buildIdx++)
+				drawListBuilder.build(frusta, VIEWS_NR, scene.accessBVH(), NULL, false);
+
+			for (unsigned int viewIdx = 0; viewIdx < VIEWS_NR; viewIdx++) {
+				InstancesSet visibleInstances = listVisibleInstances(drawListBuilder, viewIdx);
+				CHECK(visibleInstances == scene.findVisibleInstances(frusta[viewIdx]));
+				CHECK(drawListBuilder.getStats(viewIdx).visibleInstancesNr == visibleInstances.size());
+				checkMobileInstancesTransformats(drawListBuilder, viewIdx, scene);
+				checkDrawList(drawListBuilder, viewIdx, models);
+				if (threadsNr == 0) {
+					singleThreadedResults.push_back(copyViewResults(drawListBuilder, viewIdx));
+					printf("view %u: %zu visible (%u mobile), %u nodes visited, %u plane tests, %u draws\n", viewIdx, visibleInstances.size(),
+						   drawListBuilder.getVisibleInstancesNr(viewIdx, MOBILE_MODEL_IDX), drawListBuilder.getStats(viewIdx).nodesVisitedNr,
+						   drawListBuilder.getStats(viewIdx).planeTestsNr, drawListBuilder.getStats(viewIdx).drawsNr);
+				}
+				else
+					CHECK(areViewResultsEqual(copyViewResults(drawListBuilder, viewIdx), singleThreadedResults[viewIdx]));
+			}
+			delete threadPool;
+		}
+		CHECK(singleThreadedResults[0].visibleMobileInstancesTransformats.size() > 0);
+	}
+
+	void testGrownInstancesNrMax() {
+		TestModels models;
+		TestScene scene(200, 100);
+		unsigned int modelsInstancesNrsMaxima[MODELS_NR] = { 100, 100, 100 };
+		DrawListBuilder drawListBuilder(models.modelDescs, STATIC_MODELS_NR, modelsInstancesNrsMaxima);
+		ViewFrustum frustum = genViewFrustum(glm::vec3(0.0f), 0.0f, FOV, ASPECT_RATIO);
+		drawListBuilder.build(&frustum, 1, scene.accessBVH(), NULL, false);
+
+		// in front of the camera. the mobile instances are shifted past the grown model's
+		drawListBuilder.setModelInstancesNrMax(0, 110);
+		for (unsigned int addedInstanceIdx = 0; addedInstanceIdx < 10; addedInstanceIdx++)
+			scene.insert(0, 100 + addedInstanceIdx, glm::vec3(2.0f * addedInstanceIdx - 9.0f, 0.0f, -20.0f));
+		drawListBuilder.build(&frustum, 1, scene.accessBVH(), NULL, false);
+		InstancesSet visibleInstances = listVisibleInstances(drawListBuilder, 0);
+		CHECK(visibleInstances == scene.findVisibleInstances(frustum));
+		for (unsigned int addedInstanceIdx = 0; addedInstanceIdx < 10; addedInstanceIdx++)
+			CHECK(visibleInstances.count({ 0, 100 + addedInstanceIdx }) == 1);
+		checkMobileInstancesTransformats(drawListBuilder, 0, scene);
+		checkDrawList(drawListBuilder, 0, models);
+	}
+
+	// the distance the instances' bounding spheres project to the share of the viewport's height from
+	float calcCameraDist(float screenSz) {
+		return INSTANCE_RADIUS / (screenSz * tanf(0.5f * FOV));
+	}
+
+	// instances of model 0 along the look direction, clear of the levels' switch sizes and their hysteresis bands
+	void testLodsSelection() {
+		LodsTestModels models;
+		// model 0's levels' faces and its meshes' draws' (indices nr, first index, base vertex) - the levels' indices follow
+		// the full detail ones, the levels' vertices are model 0's
+		const unsigned int LODS_FACES_NRS[LodsTestModels::LOD_MODEL_LODS_NR] = { 16, 8, 2 };
+		const unsigned int MESHES_DRAWS[LodsTestModels::LOD_MODEL_LODS_NR][2][3] = { { { 36, 0, 0 }, { 12, 36, 8 } },
+																					  { { 18, 48, 0 }, { 6, 66, 8 } },
+																					  { { 6, 72, 0 }, { 0, 0, 0 } } };
+		const float SCREEN_SZS[] = { 0.6f, 0.3f, 0.15f, 0.1f, 0.03f, 0.4f, 0.04f, 0.12f, 0.35f };
+		const unsigned int EXPECTED_LODS_IDXS[] = { 0, 0, 1, 1, 2, 0, 2, 1, 0 };
+		const unsigned int INSTANCES_NR = sizeof(SCREEN_SZS) / sizeof(float);
+		const unsigned int MODEL1_INSTANCES_NR = 3;
+		TestScene scene(0, 0);
+		for (unsigned int instanceIdx = 0; instanceIdx < INSTANCES_NR; instanceIdx++)
+			scene.insert(0, instanceIdx, glm::vec3(0.0f, 0.0f, -calcCameraDist(SCREEN_SZS[instanceIdx])));
+		for (unsigned int instanceIdx = 0; instanceIdx < MODEL1_INSTANCES_NR; instanceIdx++)
+			scene.insert(1, instanceIdx, glm::vec3(3.0f, 0.0f, -10.0f - 10.0f * instanceIdx));
+		unsigned int modelsInstancesNrsMaxima[2] = { 16, 16 };
+		DrawListBuilder drawListBuilder(models.modelDescs, 2, modelsInstancesNrsMaxima);
+		ViewFrustum frustum = genViewFrustum(glm::vec3(0.0f), 0.0f, FOV, ASPECT_RATIO);
+		drawListBuilder.build(&frustum, 1, scene.accessBVH(), NULL, false);
+		CHECK(listVisibleInstances(drawListBuilder, 0, 2) == scene.findVisibleInstances(frustum));
+		CHECK(drawListBuilder.getVisibleInstancesNr(0, 0) == INSTANCES_NR && drawListBuilder.getVisibleInstancesNr(0, 1) == MODEL1_INSTANCES_NR);
+
+		unsigned int lodsInstancesNrs[LodsTestModels::LOD_MODEL_LODS_NR] = {};
+		for (unsigned int instanceIdx = 0; instanceIdx < INSTANCES_NR; instanceIdx++)
+			lodsInstancesNrs[EXPECTED_LODS_IDXS[instanceIdx]]++;
+		unsigned int lodsFirstInstances[LodsTestModels::LOD_MODEL_LODS_NR] = { 0, lodsInstancesNrs[0], lodsInstancesNrs[0] + lodsInstancesNrs[1] };
+		// listed level after level
+		unsigned int const* visibleInstancesIdxs = drawListBuilder.getVisibleInstancesIdxs(0, 0);
+		unsigned int misplacedInstancesNr = 0;
+		for (unsigned int visibleInstanceIdx = 0; visibleInstanceIdx < drawListBuilder.getVisibleInstancesNr(0, 0); visibleInstanceIdx++) {
+			unsigned int lodIdx = EXPECTED_LODS_IDXS[visibleInstancesIdxs[visibleInstanceIdx]];
+			if (visibleInstanceIdx < lodsFirstInstances[lodIdx] || visibleInstanceIdx >= lodsFirstInstances[lodIdx] + lodsInstancesNrs[lodIdx])
+				misplacedInstancesNr++;
+		}
+		CHECK(misplacedInstancesNr == 0);
+
+		DrawListBuilder::Stats const& stats = drawListBuilder.getStats(0);
+		CHECK(stats.lodsVisibleInstancesNrs[0] == lodsInstancesNrs[0] + MODEL1_INSTANCES_NR);
+		CHECK(stats.lodsVisibleInstancesNrs[1] == lodsInstancesNrs[1] && stats.lodsVisibleInstancesNrs[2] == lodsInstancesNrs[2]);
+		unsigned int lodModelDrawsNr = 0;
+		for (DrawListBuilder::Draw const& draw : drawListBuilder.getDrawList(0)) {
+			if (draw.modelIdx == 1) {
+				CHECK(draw.lodIdx == 0 && draw.idxsNr == 15 && draw.firstIdx == 78 && draw.baseVertex == 14);
+				CHECK(draw.firstInstance == 0 && draw.instancesNr == MODEL1_INSTANCES_NR);
+				continue;
+			}
+
+			lodModelDrawsNr++;
+			if (!CHECK(draw.lodIdx < LodsTestModels::LOD_MODEL_LODS_NR && draw.meshIdx < 2))
+				continue;
+			unsigned int const* meshDraw = MESHES_DRAWS[draw.lodIdx][draw.meshIdx];
+			CHECK(draw.idxsNr == meshDraw[0] && draw.firstIdx == meshDraw[1] && draw.baseVertex == meshDraw[2]);
+			CHECK(draw.firstInstance == lodsFirstInstances[draw.lodIdx] && draw.instancesNr == lodsInstancesNrs[draw.lodIdx]);
+		}
+		// the second mesh is collapsed at the coarsest level
+		CHECK(lodModelDrawsNr == 5);
+
+		unsigned int trianglesNr = 5 * MODEL1_INSTANCES_NR;
+		for (unsigned int lodIdx = 0; lodIdx < LodsTestModels::LOD_MODEL_LODS_NR; lodIdx++)
+			trianglesNr += LODS_FACES_NRS[lodIdx] * lodsInstancesNrs[lodIdx];
+		CHECK(stats.trianglesNr == trianglesNr);
+		CHECK(stats.fullDetailTrianglesNr == 16 * INSTANCES_NR + 5 * MODEL1_INSTANCES_NR);
+		printf("levels of detail: %u/%u/%u visible instances, %u of %u triangles\n", stats.lodsVisibleInstancesNrs[0], stats.lodsVisibleInstancesNrs[1],
+			   stats.lodsVisibleInstancesNrs[2], stats.trianglesNr, stats.fullDetailTrianglesNr);
+	}
+
+	// the level the view's only visible instance is drawn in
+	unsigned int findDrawnLodIdx(DrawListBuilder const& drawListBuilder, unsigned int viewIdx) {
+		for (unsigned int lodIdx = 0; lodIdx < MODEL_LODS_NR_MAX; lodIdx++) {
+			if (drawListBuilder.getStats(viewIdx).lodsVisibleInstancesNrs[lodIdx])
+				return lodIdx;
+		}
+		return MODEL_LODS_NR_MAX;
+	}
+
+	// the camera moves along an instance's switch sizes - back to a finer level only LOD_HYSTERESIS past the switch size.
+	// a second view keeps still just within a switch size's band, and has a selection of its own
+	void testLodsHysteresis() {
+		LodsTestModels models;
+		TestScene scene(0, 0);
+		scene.insert(0, 0, glm::vec3(0.0f));
+		unsigned int modelsInstancesNrsMaxima[2] = { 1, 1 };
+		DrawListBuilder drawListBuilder(models.modelDescs, 2, modelsInstancesNrsMaxima);
+		const float SCREEN_SZS[] = { 0.3f, 0.19f, 0.21f, 0.23f, 0.21f, 0.19f, 0.04f, 0.054f, 0.057f, 0.21f, 0.25f };
+		const unsigned int EXPECTED_LODS_IDXS[] = { 0, 1, 1, 0, 0, 1, 2, 2, 1, 1, 0 };
+		ViewFrustum frusta[2];
+		frusta[1] = genViewFrustum(glm::vec3(0.0f, 0.0f, calcCameraDist(0.21f)), 0.0f, FOV, ASPECT_RATIO);
+		unsigned int misselectedLodsNr = 0;
+		for (unsigned int stepIdx = 0; stepIdx < sizeof(SCREEN_SZS) / sizeof(float); stepIdx++) {
+			frusta[0] = genViewFrustum(glm::vec3(0.0f, 0.0f, calcCameraDist(SCREEN_SZS[stepIdx])), 0.0f, FOV, ASPECT_RATIO);
+			drawListBuilder.build(frusta, 2, scene.accessBVH(), NULL, false);
+			if (findDrawnLodIdx(drawListBuilder, 0) != EXPECTED_LODS_IDXS[stepIdx] || findDrawnLodIdx(drawListBuilder, 1) != 0)
+				misselectedLodsNr++;
+		}
+		CHECK(misselectedLodsNr == 0);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned int instancesNr = argc > 1 ? strtoul(argv[1], NULL, 10) : 20000;
+	testCulling(instancesNr);
+	testGrownInstancesNrMax();
+	testLodsSelection();
+	testLodsHysteresis();
+
+	return Corium3DTests::reportResults("DrawListBuilderTest");
+}
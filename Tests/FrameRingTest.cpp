@@ -0,0 +1,123 @@
+// Tests FrameRing: the regions' sizes, the sub-allocations' offsets and alignment, the frames' regions rotation and that
+// a region in flight is not begun before it is retired, and over random frames that a frame's allocations are aligned,
+// never overlap, never leave the frame's region and fail only when the region is out of space.
+// Standalone - builds on Linux:
+//   g++ -std=c++14 -O2 -I../Corium3D FrameRingTest.cpp ../Corium3D/FrameRing.cpp -o frameRingTest
+// usage: frameRingTest [<frames nr>]
+
+#include "Tests.h"
+#include "FrameRing.h"
+
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+
+using namespace Corium3DUtils;
+
+namespace {
+
+	void testFrames() {
+		FrameRing frameRing(3, 1000, 256);
+		CHECK(frameRing.getRegionsNr() == 3);
+		CHECK(frameRing.getRegionSz() == 1024);
+		CHECK(frameRing.getBufferSz() == 3072);
+		// no frame is open
+		CHECK(frameRing.allocate(4) == FrameRing::ALLOCATION_FAILED);
+		CHECK(frameRing.getNextRegionIdx() == 0);
+
+		CHECK(frameRing.beginFrame());
+		CHECK(frameRing.getRegionIdx() == 0);
+		CHECK(frameRing.allocate(10) == 0);
+		CHECK(frameRing.allocate(4, 4) == 12);
+		CHECK(frameRing.allocate(1, 256) == 256);
+		// aligned beyond the regions' alignment
+		CHECK(frameRing.allocate(1, 512) == FrameRing::ALLOCATION_FAILED);
+		CHECK(frameRing.allocate(767) == 257);
+		CHECK(frameRing.allocate(1) == FrameRing::ALLOCATION_FAILED);
+		CHECK(frameRing.getFrameAllocatedSz() == 1024);
+		frameRing.endFrame();
+		CHECK(frameRing.isRegionInFlight(0));
+
+		CHECK(frameRing.beginFrame());
+		CHECK(frameRing.getRegionIdx() == 1);
+		CHECK(frameRing.getRegionOffset() == 1024);
+		CHECK(frameRing.allocate(1) == 1024);
+		// beginning a frame ends the open one
+		CHECK(frameRing.beginFrame());
+		CHECK(frameRing.getRegionIdx() == 2);
+		CHECK(frameRing.isRegionInFlight(1));
+		CHECK(frameRing.allocate(1) == 2048);
+		CHECK(frameRing.getNextRegionIdx() == 0);
+		// region 0 is still in flight
+		CHECK(!frameRing.beginFrame());
+		CHECK(frameRing.isRegionInFlight(2));
+		CHECK(frameRing.allocate(1) == FrameRing::ALLOCATION_FAILED);
+
+		frameRing.retireRegion(0);
+		CHECK(frameRing.beginFrame());
+		CHECK(frameRing.getRegionIdx() == 0);
+		CHECK(frameRing.getFrameAllocatedSz() == 0);
+		CHECK(frameRing.allocate(8) == 0);
+		CHECK(frameRing.getFrameAllocatedSzMax() == 1024);
+
+		bool hasThrown = false;
+		try {
+			FrameRing badAlignmentFrameRing(2, 100, 3);
+		}
+		catch (std::invalid_argument&) {
+			hasThrown = true;
+		}
+		CHECK(hasThrown);
+	}
+
+	void testRandomFrames(unsigned int framesNr) {
+		std::mt19937 rng(5);
+		FrameRing frameRing(4, 5000, 64);
+		unsigned int errsNr = 0;
+		unsigned int failedAllocationsNr = 0;
+		for (unsigned int frameIdx = 0; frameIdx < framesNr; frameIdx++) {
+			unsigned int nextRegionIdx = frameRing.getNextRegionIdx();
+			if (frameRing.isRegionInFlight(nextRegionIdx))
+				frameRing.retireRegion(nextRegionIdx);
+			if (!frameRing.beginFrame()) {
+				errsNr++;
+				continue;
+			}
+
+			size_t regionOffset = frameRing.getRegionOffset();
+			size_t regionEnd = regionOffset + frameRing.getRegionSz();
+			size_t allocatedEnd = regionOffset;
+			for (unsigned int allocationIdx = 0; allocationIdx < 20; allocationIdx++) {
+				size_t sz = rng() % 800;
+				size_t alignment = (size_t)1 << (rng() % 7);
+				size_t allocationOffset = frameRing.allocate(sz, alignment);
+				size_t alignedEnd = (allocatedEnd + alignment - 1) & ~(alignment - 1);
+				if (allocationOffset == FrameRing::ALLOCATION_FAILED) {
+					failedAllocationsNr++;
+					if (alignedEnd + sz <= regionEnd)
+						errsNr++;
+					continue;
+				}
+
+				if (allocationOffset < allocatedEnd || allocationOffset % alignment || allocationOffset + sz > regionEnd)
+					errsNr++;
+				allocatedEnd = allocationOffset + sz;
+			}
+			frameRing.endFrame();
+		}
+		CHECK(errsNr == 0);
+		// the regions do run out of space
+		CHECK(failedAllocationsNr > 0);
+		CHECK(frameRing.getFrameAllocatedSzMax() <= frameRing.getRegionSz());
+		printf("%u random frames: %u failed allocations, %u errors\n", framesNr, failedAllocationsNr, errsNr);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned int framesNr = argc > 1 ? strtoul(argv[1], NULL, 10) : 2000;
+	testFrames();
+	testRandomFrames(framesNr);
+
+	return Corium3DTests::reportResults("FrameRingTest");
+}
@@ -0,0 +1,116 @@
+// Tests FrustumCuller against the per sphere reference test, over random spheres and views: the results are
+// the same, the inside masks are of planes the spheres are fully inside of, a sphere tested with its BV ancestor's mask
+// gets the result of a test from scratch, and the coherency record only changes which plane is tested first.
+// Standalone - builds on Linux:
+//   g++ -std=c++14 -O2 -D_USE_MATH_DEFINES -I../Corium3D -I../externals/Include FrustumCullerTest.cpp ../Corium3D/FrustumCuller.cpp
+//       ../Corium3D/BoundingSphere.cpp -o frustumCullerTest
+// usage: frustumCullerTest [<spheres nr>]
+
+#include "Tests.h"
+#include "CullingTests.h"
+#include "FrustumCuller.h"
+
+#include <cstdlib>
+#include <random>
+
+using namespace Corium3D;
+using namespace Corium3DTests;
+
+namespace {
+
+	void testAgainstRef(unsigned int spheresNr) {
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<float> coord(-60.0f, 60.0f);
+		std::uniform_real_distribution<float> radius(0.01f, 8.0f);
+		std::uniform_real_distribution<float> angle(0.0f, 2.0f * (float)M_PI);
+		std::uniform_real_distribution<float> fov(0.3f, 2.0f);
+		unsigned int mismatchesNr = 0;
+		unsigned int visiblesNr = 0;
+		unsigned int wrongInsideMasksNr = 0;
+		for (unsigned int viewIdx = 0; viewIdx < 16; viewIdx++) {
+			ViewFrustum frustum = genViewFrustum(glm::vec3(coord(rng), 0.1f * coord(rng), coord(rng)), angle(rng), fov(rng), viewIdx % 2 ? 16.0f / 9.0f : 1.0f);
+			FrustumCuller frustumCuller(frustum);
+			for (unsigned int sphereIdx = 0; sphereIdx < spheresNr; sphereIdx++) {
+				glm::vec3 sphereC(coord(rng), 0.2f * coord(rng), coord(rng));
+				float sphereR = radius(rng);
+				unsigned int insideMask = FrustumCuller::PLANES_NO_INSIDE_MASK;
+				unsigned char lastRejectingPlaneIdx = 0;
+				unsigned int planeTestsNr = 0;
+				bool isVisible = frustumCuller.cullBoundingSphere(BoundingSphere(sphereC, sphereR), insideMask, lastRejectingPlaneIdx, planeTestsNr);
+				if (isVisible != isSphereVisibleRef(frustum, sphereC, sphereR))
+					mismatchesNr++;
+				visiblesNr += isVisible;
+				for (unsigned int planeIdx = 0; planeIdx < ViewFrustum::PLANES_NR; planeIdx++) {
+					if ((insideMask & (1 << planeIdx)) && frustum.planes[planeIdx].signedDistFromPoint(sphereC) >= -sphereR)
+						wrongInsideMasksNr++;
+				}
+				if (!isVisible && insideMask == FrustumCuller::PLANES_NO_INSIDE_MASK && lastRejectingPlaneIdx < ViewFrustum::PLANES_NR &&
+					frustum.planes[lastRejectingPlaneIdx].signedDistFromPoint(sphereC) > sphereR) {
+					// the rejecting plane is tested first on the next test, which rejects the sphere at once
+					unsigned int retestPlaneTestsNr = 0;
+					unsigned int retestInsideMask = FrustumCuller::PLANES_NO_INSIDE_MASK;
+					CHECK(!frustumCuller.cullBoundingSphere(BoundingSphere(sphereC, sphereR), retestInsideMask, lastRejectingPlaneIdx, retestPlaneTestsNr));
+					CHECK(retestPlaneTestsNr == 1);
+				}
+			}
+		}
+		CHECK(mismatchesNr == 0);
+		CHECK(wrongInsideMasksNr == 0);
+		// the views are not all empty or all full
+		CHECK(visiblesNr > 0 && visiblesNr < 16 * spheresNr);
+		printf("%u spheres x 16 views: %u visible, %u mismatches\n", spheresNr, visiblesNr, mismatchesNr);
+	}
+
+	void testHierarchical() {
+		std::mt19937 rng(2);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		ViewFrustum frustum = genViewFrustum(glm::vec3(0.0f), 0.3f, 1.2f, 16.0f / 9.0f);
+		FrustumCuller frustumCuller(frustum);
+		unsigned int mismatchesNr = 0;
+		unsigned int savedPlaneTestsNr = 0;
+		for (unsigned int parentIdx = 0; parentIdx < 2000; parentIdx++) {
+			glm::vec3 parentC(60.0f * unit(rng), 10.0f * unit(rng), -50.0f + 60.0f * unit(rng));
+			float parentR = 4.0f + 4.0f * unit(rng);
+			unsigned int parentInsideMask = FrustumCuller::PLANES_NO_INSIDE_MASK;
+			unsigned char parentLastRejectingPlaneIdx = 0;
+			unsigned int parentPlaneTestsNr = 0;
+			if (!frustumCuller.cullBoundingSphere(BoundingSphere(parentC, parentR), parentInsideMask, parentLastRejectingPlaneIdx, parentPlaneTestsNr))
+				continue;
+
+			// children enclosed by the parent
+			for (unsigned int childIdx = 0; childIdx < 4; childIdx++) {
+				float childR = parentR * (0.1f + 0.4f * (unit(rng) + 1.0f));
+				glm::vec3 childC = parentC + (parentR - childR) * 0.99f * glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(1e-3f));
+				unsigned int insideMask = parentInsideMask;
+				unsigned char lastRejectingPlaneIdx = 0;
+				unsigned int planeTestsNr = 0;
+				bool isVisible = frustumCuller.cullBoundingSphere(BoundingSphere(childC, childR), insideMask, lastRejectingPlaneIdx, planeTestsNr);
+				unsigned int scratchInsideMask = FrustumCuller::PLANES_NO_INSIDE_MASK;
+				unsigned int scratchPlaneTestsNr = 0;
+				bool isVisibleFromScratch = frustumCuller.cullBoundingSphere(BoundingSphere(childC, childR), scratchInsideMask, lastRejectingPlaneIdx, scratchPlaneTestsNr);
+				if (isVisible != isVisibleFromScratch || (isVisible && (insideMask & parentInsideMask) != parentInsideMask))
+					mismatchesNr++;
+				savedPlaneTestsNr += scratchPlaneTestsNr - planeTestsNr;
+			}
+		}
+		CHECK(mismatchesNr == 0);
+		// the ancestors' masks spare tests
+		CHECK(savedPlaneTestsNr > 0);
+
+		// a sphere inside of all of the planes is accepted untested
+		unsigned int insideMask = FrustumCuller::PLANES_ALL_INSIDE_MASK;
+		unsigned char lastRejectingPlaneIdx = 0;
+		unsigned int planeTestsNr = 0;
+		CHECK(frustumCuller.cullBoundingSphere(BoundingSphere(glm::vec3(0.0f, 0.0f, 1000.0f), 1.0f), insideMask, lastRejectingPlaneIdx, planeTestsNr));
+		CHECK(planeTestsNr == 0);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned int spheresNr = argc > 1 ? strtoul(argv[1], NULL, 10) : 20000;
+	testAgainstRef(spheresNr);
+	testHierarchical();
+
+	return Corium3DTests::reportResults("FrustumCullerTest");
+}
@@ -0,0 +1,127 @@
+// Tests GameLmntsStorage over random adds and removes of elements of random archetypes: the handles' rows keep their
+// elements' data in every column as removals swap the archetypes' last rows in, and the columns stay dense. Then updates
+// the mobile archetypes through PhysicsEngine's columns update and checks that the transforms and deltas columns hold the
+// mobility interfaces' transforms and per update deltas, in the rows of their elements.
+// Standalone - builds on Linux:
+//   g++ -std=c++17 -O2 -fpermissive -include cstring -DDEBUG=1 -D_USE_MATH_DEFINES -I../Corium3D -I../externals/Include
+//       GameLmntsStorageTest.cpp ../Corium3D/GameLmntsStorage.cpp ../Corium3D/PhysicsEngine.cpp ../Corium3D/IdxPool.cpp
+//       ../Corium3D/MemoryReport.cpp -o gameLmntsStorageTest
+// usage: gameLmntsStorageTest [<operations nr>]
+
+#include "Tests.h"
+#include "GameLmntsStorage.h"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace Corium3D;
+
+namespace {
+
+	// Corium3DEngine::GameLmnt::Component::Mobility
+	const unsigned int MOBILITY = 4;
+	const float SECS_PER_UPDATE = 1.0f / 60.0f;
+
+	struct AddedLmnt {
+		GameLmntsStorage::Handle handle;
+		unsigned int components;
+		GameLmntsStorage::Row row;
+	};
+
+	bool isRowKept(GameLmntsStorage& storage, AddedLmnt const& lmnt) {
+		if (storage.getComponents(lmnt.handle) != lmnt.components)
+			return false;
+		GameLmntsStorage::Archetype const& archetype = storage.accessArchetype(lmnt.components);
+		unsigned int rowIdx = storage.getRowIdx(lmnt.handle);
+		return rowIdx < archetype.getLmntsNr() && archetype.handles[rowIdx] == lmnt.handle && archetype.mobilityInterfaces[rowIdx] == lmnt.row.mobilityInterface &&
+			archetype.modelIdxs[rowIdx] == lmnt.row.modelIdx && archetype.instanceIdxs[rowIdx] == lmnt.row.instanceIdx;
+	}
+
+	void testRandomOperations(unsigned int operationsNr) {
+		std::mt19937 rng(13);
+		GameLmntsStorage storage(16);
+		PhysicsEngine physicsEngine(16, SECS_PER_UPDATE);
+		std::vector<AddedLmnt> lmnts;
+		unsigned int errsNr = 0;
+		for (unsigned int operationIdx = 0; operationIdx < operationsNr; operationIdx++) {
+			if (lmnts.empty() || rng() % 5 < 3) {
+				AddedLmnt lmnt;
+				lmnt.components = rng() % GameLmntsStorage::ARCHETYPES_NR;
+				lmnt.row.transform.translate = glm::vec3((float)(rng() % 100), 0.0f, 0.0f);
+				lmnt.row.modelIdx = rng() % 10;
+				lmnt.row.instanceIdx = operationIdx;
+				if (lmnt.components & MOBILITY) {
+					lmnt.row.mobilityInterface = physicsEngine.addMobileGameLmnt(lmnt.row.transform, NULL, 0);
+					lmnt.row.mobilityInterface->setLinVel(glm::vec3(0.0f, (float)(rng() % 10), 0.0f));
+					lmnt.row.mobilityInterface->setAngVel((float)(rng() % 90), glm::vec3(0.0f, 1.0f, 0.0f));
+				}
+				lmnt.handle = storage.add(lmnt.components, lmnt.row);
+				GameLmntsStorage::Archetype const& archetype = storage.accessArchetype(lmnt.components);
+				unsigned int rowIdx = storage.getRowIdx(lmnt.handle);
+				if (archetype.transforms[rowIdx].translate != lmnt.row.transform.translate || archetype.transformDeltas[rowIdx].translate != glm::vec3(0.0f))
+					errsNr++;
+				lmnts.push_back(lmnt);
+			}
+			else {
+				unsigned int removedLmntIdx = rng() % lmnts.size();
+				if (lmnts[removedLmntIdx].row.mobilityInterface)
+					physicsEngine.removeMobileGameLmnt(lmnts[removedLmntIdx].row.mobilityInterface);
+				storage.remove(lmnts[removedLmntIdx].handle);
+				lmnts[removedLmntIdx] = lmnts.back();
+				lmnts.pop_back();
+			}
+			if (operationIdx % 64 == 0) {
+				for (AddedLmnt const& lmnt : lmnts) {
+					if (!isRowKept(storage, lmnt))
+						errsNr++;
+				}
+			}
+		}
+
+		unsigned int lmntsNr = 0;
+		for (unsigned int components = 0; components < GameLmntsStorage::ARCHETYPES_NR; components++) {
+			GameLmntsStorage::Archetype& archetype = storage.accessArchetype(components);
+			lmntsNr += archetype.getLmntsNr();
+			if (archetype.transforms.size() != archetype.getLmntsNr() || archetype.transformDeltas.size() != archetype.getLmntsNr() ||
+				archetype.transform2DRotDeltas.size() != archetype.getLmntsNr() || archetype.bvhDataNodes3D.size() != archetype.getLmntsNr())
+				errsNr++;
+			if (components & MOBILITY)
+				physicsEngine.update(archetype.mobilityInterfaces.data(), archetype.transforms.data(), archetype.transformDeltas.data(), archetype.transform2DRotDeltas.data(), archetype.getLmntsNr());
+		}
+		if (lmntsNr != lmnts.size() || storage.getLmntsNr() != lmnts.size())
+			errsNr++;
+
+		// the columns hold the interfaces' transforms after the update, and the deltas applied by it
+		unsigned int updatedLmntsNr = 0;
+		for (AddedLmnt const& lmnt : lmnts) {
+			GameLmntsStorage::Archetype const& archetype = storage.accessArchetype(lmnt.components);
+			unsigned int rowIdx = storage.getRowIdx(lmnt.handle);
+			Transform3D const& transform = archetype.transforms[rowIdx];
+			Transform3DUS const& transformDelta = archetype.transformDeltas[rowIdx];
+			if (!(lmnt.components & MOBILITY)) {
+				if (transform.translate != lmnt.row.transform.translate || transformDelta.translate != glm::vec3(0.0f))
+					errsNr++;
+				continue;
+			}
+
+			PhysicsEngine::MobilityInterface const* mobilityInterface = lmnt.row.mobilityInterface;
+			glm::vec3 expectedTranslateDelta = mobilityInterface->getLinVel() * SECS_PER_UPDATE;
+			if (transform.translate != mobilityInterface->getTranslate() || transform.rot != mobilityInterface->getRot() ||
+				glm::length(transformDelta.translate - expectedTranslateDelta) > 1e-5f || glm::length(transform.translate - lmnt.row.transform.translate - expectedTranslateDelta) > 1e-4f)
+				errsNr++;
+			updatedLmntsNr++;
+		}
+		CHECK(errsNr == 0);
+		CHECK(updatedLmntsNr > 0);
+		printf("%u random operations: %u elements, %u updated by the columns, %u errors\n", operationsNr, lmntsNr, updatedLmntsNr, errsNr);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned int operationsNr = argc > 1 ? strtoul(argv[1], NULL, 10) : 5000;
+	testRandomOperations(operationsNr);
+
+	return Corium3DTests::reportResults("GameLmntsStorageTest");
+}
@@ -0,0 +1,124 @@
+// Tests IndirectCommandsGenerator over random draw lists: a command per draw of a model with written instances' data,
+// in the draw list's order and with the draw's indices, vertices and instances, and the commands grouped into the runs
+// of the same program that cover them all.
+// Standalone - builds on Linux:
+//   g++ -std=c++14 -O2 -D_USE_MATH_DEFINES -I../Corium3D -I../externals/Include IndirectCommandsGeneratorTest.cpp
+//       ../Corium3D/IndirectCommandsGenerator.cpp -o indirectCommandsGeneratorTest
+// usage: indirectCommandsGeneratorTest [<draw lists nr>]
+
+#include "Tests.h"
+#include "IndirectCommandsGenerator.h"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace Corium3D;
+
+namespace {
+
+	// glMultiDrawElementsIndirect reads the commands tightly packed
+	static_assert(sizeof(IndirectCommandsGenerator::Command) == 5 * sizeof(unsigned int), "DrawElementsIndirectCommand layout");
+
+	bool isDrawSkipped(DrawListBuilder::Draw const& draw, std::vector<unsigned int> const& modelsBaseInstances) {
+		return modelsBaseInstances[draw.modelIdx] == IndirectCommandsGenerator::NO_BASE_INSTANCE || draw.instancesNr == 0;
+	}
+
+	void testFixedDrawList() {
+		std::vector<unsigned int> modelsBaseInstances = { 0, IndirectCommandsGenerator::NO_BASE_INSTANCE, 7 };
+		std::vector<DrawListBuilder::Draw> drawList = {
+			{ 1, 0, 0, 0, 30, 0, 0, 0, 2 },
+			{ 1, 1, 0, 0, 21, 30, 3, 0, 4 },
+			{ 0, 2, 0, 0, 12, 51, 7, 0, 1 },
+			{ 0, 2, 1, 0, 6, 63, 9, 1, 3 },
+			{ 0, 0, 0, 1, 9, 69, 11, 2, 0 }
+		};
+		std::vector<IndirectCommandsGenerator::Command> commands(drawList.size());
+		IndirectCommandsGenerator generator;
+		CHECK(generator.generate(drawList, modelsBaseInstances.data(), commands.data()) == 3);
+		CHECK(commands[0].idxsNr == 30 && commands[0].instancesNr == 2 && commands[0].firstIdx == 0 && commands[0].baseVertex == 0 && commands[0].baseInstance == 0);
+		CHECK(commands[1].idxsNr == 12 && commands[1].instancesNr == 1 && commands[1].firstIdx == 51 && commands[1].baseVertex == 7 && commands[1].baseInstance == 7);
+		CHECK(commands[2].idxsNr == 6 && commands[2].instancesNr == 3 && commands[2].firstIdx == 63 && commands[2].baseVertex == 9 && commands[2].baseInstance == 8);
+		std::vector<IndirectCommandsGenerator::CommandsGroup> const& groups = generator.getGroups();
+		CHECK(groups.size() == 2);
+		if (groups.size() == 2) {
+			CHECK(groups[0].progIdx == 1 && groups[0].firstCommandIdx == 0 && groups[0].commandsNr == 1);
+			CHECK(groups[1].progIdx == 0 && groups[1].firstCommandIdx == 1 && groups[1].commandsNr == 2);
+		}
+
+		// the groups are regenerated
+		CHECK(generator.generate(std::vector<DrawListBuilder::Draw>(), modelsBaseInstances.data(), commands.data()) == 0);
+		CHECK(generator.getGroups().empty());
+	}
+
+	void testRandomDrawLists(unsigned int drawListsNr) {
+		const unsigned int MODELS_NR = 10;
+		const unsigned int PROGS_NR = 4;
+		std::mt19937 rng(3);
+		unsigned int errsNr = 0;
+		unsigned int commandsNrTotal = 0;
+		IndirectCommandsGenerator generator;
+		for (unsigned int drawListIdx = 0; drawListIdx < drawListsNr; drawListIdx++) {
+			std::vector<unsigned int> modelsBaseInstances(MODELS_NR);
+			for (unsigned int& baseInstance : modelsBaseInstances)
+				baseInstance = rng() % 4 == 0 ? IndirectCommandsGenerator::NO_BASE_INSTANCE : rng() % 1000;
+			std::vector<DrawListBuilder::Draw> drawList(rng() % 40);
+			unsigned int progIdx = 0;
+			for (DrawListBuilder::Draw& draw : drawList) {
+				if (rng() % 3 == 0)
+					progIdx = rng() % PROGS_NR;
+				draw = { progIdx, (unsigned int)(rng() % MODELS_NR), (unsigned int)(rng() % 3), (unsigned int)(rng() % 2), (unsigned int)(rng() % 300),
+					(unsigned int)(rng() % 1000), (unsigned int)(rng() % 500), (unsigned int)(rng() % 50), (unsigned int)(rng() % 3) };
+			}
+
+			std::vector<IndirectCommandsGenerator::Command> commands(drawList.size());
+			unsigned int commandsNr = generator.generate(drawList, modelsBaseInstances.data(), commands.data());
+			commandsNrTotal += commandsNr;
+			std::vector<IndirectCommandsGenerator::CommandsGroup> const& groups = generator.getGroups();
+			unsigned int commandIdx = 0;
+			unsigned int groupIdx = 0;
+			for (DrawListBuilder::Draw const& draw : drawList) {
+				if (isDrawSkipped(draw, modelsBaseInstances))
+					continue;
+				if (commandIdx == commandsNr) {
+					errsNr++;
+					break;
+				}
+
+				IndirectCommandsGenerator::Command const& command = commands[commandIdx];
+				if (command.idxsNr != draw.idxsNr || command.instancesNr != draw.instancesNr || command.firstIdx != draw.firstIdx ||
+					command.baseVertex != (int)draw.baseVertex || command.baseInstance != modelsBaseInstances[draw.modelIdx] + draw.firstInstance)
+					errsNr++;
+				while (groupIdx < groups.size() && commandIdx >= groups[groupIdx].firstCommandIdx + groups[groupIdx].commandsNr)
+					groupIdx++;
+				if (groupIdx == groups.size() || groups[groupIdx].progIdx != draw.progIdx)
+					errsNr++;
+				commandIdx++;
+			}
+			if (commandIdx != commandsNr)
+				errsNr++;
+
+			// the groups are non empty, contiguous and of different programs than their predecessors
+			unsigned int groupedCommandsNr = 0;
+			for (unsigned int idx = 0; idx < groups.size(); idx++) {
+				if (groups[idx].firstCommandIdx != groupedCommandsNr || groups[idx].commandsNr == 0 || (idx > 0 && groups[idx].progIdx == groups[idx - 1].progIdx))
+					errsNr++;
+				groupedCommandsNr += groups[idx].commandsNr;
+			}
+			if (groupedCommandsNr != commandsNr)
+				errsNr++;
+		}
+		CHECK(errsNr == 0);
+		CHECK(commandsNrTotal > 0);
+		printf("%u random draw lists: %u commands, %u errors\n", drawListsNr, commandsNrTotal, errsNr);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned int drawListsNr = argc > 1 ? strtoul(argv[1], NULL, 10) : 2000;
+	testFixedDrawList();
+	testRandomDrawLists(drawListsNr);
+
+	return Corium3DTests::reportResults("IndirectCommandsGeneratorTest");
+}
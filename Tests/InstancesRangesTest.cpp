@@ -0,0 +1,139 @@
+// Tests InstancesRanges: the models' ranges laid out model after model, growing a model's maximum shifting the following
+// models' ranges only, and the grown maximum doubling. Then spawns and destroys random instances as the engine does -
+// growing a model whose instances pool hands out an index beyond its maximum, and inserting the added instances into a
+// static instances' shadow as the renderer does - and checks that every instance's data stays at its model's base index
+// plus its instance index.
+// Standalone - builds on Linux:
+//   g++ -std=c++14 -O2 -DDEBUG=1 -I../Corium3D InstancesRangesTest.cpp ../Corium3D/InstancesRanges.cpp ../Corium3D/IdxPool.cpp
+//       -o instancesRangesTest
+// usage: instancesRangesTest [<spawns nr>]
+
+#include "Tests.h"
+#include "InstancesRanges.h"
+#include "IdxPool.h"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace Corium3D;
+using namespace Corium3DUtils;
+
+namespace {
+
+	void testRanges() {
+		unsigned int modelsInstancesNrsMaxima[4] = { 3, 0, 5, 2 };
+		InstancesRanges instancesRanges(modelsInstancesNrsMaxima, 4);
+		CHECK(instancesRanges.getBaseIdx(0) == 0 && instancesRanges.getBaseIdx(1) == 3 && instancesRanges.getBaseIdx(2) == 3 && instancesRanges.getBaseIdx(3) == 8);
+		CHECK(instancesRanges.getEndIdx(3) == 10);
+
+		CHECK(instancesRanges.grow(1, 4) == 4);
+		CHECK(instancesRanges.getBaseIdx(0) == 0 && instancesRanges.getBaseIdx(1) == 3 && instancesRanges.getBaseIdx(2) == 7 && instancesRanges.getBaseIdx(3) == 12);
+		CHECK(instancesRanges.getInstancesNrMax(1) == 4);
+		// not beyond the maximum
+		CHECK(instancesRanges.grow(2, 5) == 0);
+		CHECK(instancesRanges.grow(2, 1) == 0);
+		CHECK(instancesRanges.getBaseIdx(3) == 12);
+		// the last model shifts nothing
+		CHECK(instancesRanges.grow(3, 6) == 4);
+		CHECK(instancesRanges.getEndIdx(3) == 18);
+		CHECK(instancesRanges.getInstancesNrsMaxima()[3] == 6);
+
+		CHECK(InstancesRanges::calcGrownInstancesNrMax(100, 100) == 200);
+		CHECK(InstancesRanges::calcGrownInstancesNrMax(0, 0) == 1);
+		CHECK(InstancesRanges::calcGrownInstancesNrMax(4, 20) == 21);
+	}
+
+	unsigned int genInstanceData(unsigned int modelIdx, unsigned int instanceIdx) {
+		return modelIdx * 100000 + instanceIdx + 1;
+	}
+
+	void testRandomSpawns(unsigned int spawnsNr) {
+		const unsigned int MODELS_NR = 5;
+		const unsigned int STATIC_MODELS_NR = 3;
+		unsigned int modelsInstancesNrsMaxima[MODELS_NR] = { 2, 0, 7, 1, 3 };
+		std::mt19937 rng(11);
+		InstancesRanges instancesRanges(modelsInstancesNrsMaxima, MODELS_NR);
+		std::vector<ChunkedIdxPool*> modelsInstancesIdxPools;
+		std::vector<std::vector<unsigned int>> modelsInstancesIdxs(MODELS_NR);
+		unsigned int staticInstancesNrMax = 0;
+		for (unsigned int modelIdx = 0; modelIdx < MODELS_NR; modelIdx++) {
+			modelsInstancesIdxPools.push_back(new ChunkedIdxPool(modelsInstancesNrsMaxima[modelIdx]));
+			if (modelIdx < STATIC_MODELS_NR)
+				staticInstancesNrMax += modelsInstancesNrsMaxima[modelIdx];
+		}
+		std::vector<unsigned int> staticInstancesShadow(staticInstancesNrMax, 0);
+
+		unsigned int grownModelsNr = 0;
+		for (unsigned int spawnIdx = 0; spawnIdx < spawnsNr; spawnIdx++) {
+			unsigned int modelIdx = rng() % MODELS_NR;
+			std::vector<unsigned int>& modelInstancesIdxs = modelsInstancesIdxs[modelIdx];
+			if (!modelInstancesIdxs.empty() && rng() % 3 == 0) {
+				unsigned int destroyedIdxIdx = rng() % modelInstancesIdxs.size();
+				unsigned int instanceIdx = modelInstancesIdxs[destroyedIdxIdx];
+				modelsInstancesIdxPools[modelIdx]->release(instanceIdx);
+				if (modelIdx < STATIC_MODELS_NR)
+					staticInstancesShadow[instancesRanges.getBaseIdx(modelIdx) + instanceIdx] = 0;
+				modelInstancesIdxs[destroyedIdxIdx] = modelInstancesIdxs.back();
+				modelInstancesIdxs.pop_back();
+				continue;
+			}
+
+			// mirrors Corium3DEngineImpl::growModelInstances and Renderer::setModelInstancesNrMax
+			unsigned int instanceIdx = modelsInstancesIdxPools[modelIdx]->acquire();
+			if (instanceIdx >= instancesRanges.getInstancesNrMax(modelIdx)) {
+				unsigned int instancesNrMax = InstancesRanges::calcGrownInstancesNrMax(instancesRanges.getInstancesNrMax(modelIdx), instanceIdx);
+				unsigned int modelInstancesEndIdxPrev = instancesRanges.getEndIdx(modelIdx);
+				unsigned int addedInstancesNr = instancesRanges.grow(modelIdx, instancesNrMax);
+				CHECK(addedInstancesNr > 0);
+				if (modelIdx < STATIC_MODELS_NR) {
+					staticInstancesNrMax += addedInstancesNr;
+					staticInstancesShadow.insert(staticInstancesShadow.begin() + modelInstancesEndIdxPrev, addedInstancesNr, 0);
+				}
+				grownModelsNr++;
+			}
+			if (modelIdx < STATIC_MODELS_NR)
+				staticInstancesShadow[instancesRanges.getBaseIdx(modelIdx) + instanceIdx] = genInstanceData(modelIdx, instanceIdx);
+			modelInstancesIdxs.push_back(instanceIdx);
+		}
+
+		unsigned int errsNr = 0;
+		if (staticInstancesShadow.size() != staticInstancesNrMax || staticInstancesNrMax != instancesRanges.getBaseIdx(STATIC_MODELS_NR))
+			errsNr++;
+		for (unsigned int modelIdx = 0; modelIdx < MODELS_NR; modelIdx++) {
+			if (modelIdx > 0 && instancesRanges.getBaseIdx(modelIdx) != instancesRanges.getEndIdx(modelIdx - 1))
+				errsNr++;
+			for (unsigned int instanceIdx : modelsInstancesIdxs[modelIdx]) {
+				if (instanceIdx >= instancesRanges.getInstancesNrMax(modelIdx))
+					errsNr++;
+				else if (modelIdx < STATIC_MODELS_NR && staticInstancesShadow[instancesRanges.getBaseIdx(modelIdx) + instanceIdx] != genInstanceData(modelIdx, instanceIdx))
+					errsNr++;
+			}
+		}
+		// only the live instances' data is in the shadow
+		unsigned int liveStaticInstancesNr = 0;
+		for (unsigned int modelIdx = 0; modelIdx < STATIC_MODELS_NR; modelIdx++)
+			liveStaticInstancesNr += (unsigned int)modelsInstancesIdxs[modelIdx].size();
+		unsigned int writtenShadowEntriesNr = 0;
+		for (unsigned int data : staticInstancesShadow)
+			writtenShadowEntriesNr += data != 0;
+		if (writtenShadowEntriesNr != liveStaticInstancesNr)
+			errsNr++;
+
+		CHECK(errsNr == 0);
+		// including the model with no instances to begin with
+		CHECK(grownModelsNr >= MODELS_NR);
+		printf("%u random spawns: %u growths, %u static instances maximum, %u errors\n", spawnsNr, grownModelsNr, staticInstancesNrMax, errsNr);
+		for (ChunkedIdxPool* instancesIdxPool : modelsInstancesIdxPools)
+			delete instancesIdxPool;
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned int spawnsNr = argc > 1 ? strtoul(argv[1], NULL, 10) : 5000;
+	testRanges();
+	testRandomSpawns(spawnsNr);
+
+	return Corium3DTests::reportResults("InstancesRangesTest");
+}
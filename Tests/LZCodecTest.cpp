@@ -0,0 +1,243 @@
+// Tests LZCodec: CRC-32 against its check values and piecewise, compress/decompress round trips over data of varied
+// compressibility (empty, tiny, runs, repeats at offsets up to the maximal one, random) appended to non empty outputs,
+// and that malformed blocks - truncated, decompressed to a wrong size, matches before the block's start, random byte
+// flips - are refused or stay within the destination. Then round trips a compressed, multi block mapped assets file
+// through MappedAssets, and checks that a flipped byte in a block fails the blocks' checksums.
+// Standalone - builds on Linux:
+//   g++ -std=c++17 -O2 -DDEBUG=1 -D_USE_MATH_DEFINES -fpermissive -include cstring -I../Corium3D -I../externals/Include
+//       LZCodecTest.cpp ../Corium3D/LZCodec.cpp ../Corium3D/MappedAssets.cpp ../Corium3D/AssetsOps.cpp -lpthread -o lzCodecTest
+// usage: lzCodecTest [<random blocks nr>]
+
+#include "Tests.h"
+#include "LZCodec.h"
+#include "MappedAssets.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Corium3D;
+using namespace Corium3DUtils;
+
+namespace {
+
+	const char* const ASSETS_FILE_NAME = "lzCodecTest.assets";
+	const char* const UNCOMPRESSED_ASSETS_FILE_NAME = "lzCodecTestUncompressed.assets";
+	// CompressedAssetsHeader
+	const size_t COMPRESSED_HEADER_SZ = 24;
+
+	// the compressed size, or 0 if the round trip failed
+	size_t roundTrip(std::vector<char> const& src) {
+		std::vector<char> compressed = { 'x', 'y' };
+		size_t compressedSz = lzCompress(src.data(), src.size(), compressed);
+		if (compressed.size() != compressedSz + 2 || compressed[0] != 'x' || compressed[1] != 'y')
+			return 0;
+		std::vector<char> decompressed(src.size());
+		if (!lzDecompress(compressed.data() + 2, compressedSz, decompressed.data(), decompressed.size()) || decompressed != src)
+			return 0;
+		return compressedSz;
+	}
+
+	void testCrc32() {
+		char const* checkStr = "123456789";
+		CHECK(crc32(checkStr, 9) == 0xCBF43926u);
+		CHECK(crc32(NULL, 0) == 0);
+		std::string str = "The quick brown fox jumps over the lazy dog";
+		CHECK(crc32(str.data(), str.size()) == 0x414FA339u);
+		// piecewise, across the 8 bytes slices' boundaries
+		for (size_t splitIdx = 0; splitIdx <= str.size(); splitIdx++)
+			CHECK(crc32(str.data() + splitIdx, str.size() - splitIdx, crc32(str.data(), splitIdx)) == 0x414FA339u);
+	}
+
+	void testRoundTrips(unsigned int randomBlocksNr) {
+		CHECK(roundTrip(std::vector<char>()) == 1);
+		CHECK(roundTrip(std::vector<char>(1, 'a')) > 0);
+		CHECK(roundTrip(std::vector<char>(13, 'a')) > 0);
+		std::vector<char> zeros(100000, 0);
+		size_t zerosCompressedSz = roundTrip(zeros);
+		CHECK(zerosCompressedSz > 0 && zerosCompressedSz < 1000);
+
+		std::mt19937 rng(17);
+		std::vector<char> randomBytes(70000);
+		for (char& byte : randomBytes)
+			byte = (char)rng();
+		size_t randomCompressedSz = roundTrip(randomBytes);
+		// incompressible - grows by no more than the literals' lengths
+		CHECK(randomCompressedSz > 0 && randomCompressedSz < randomBytes.size() + randomBytes.size() / 200 + 16);
+
+		// a random run repeated at the maximal offset and just beyond it
+		for (size_t offset : { (size_t)65535, (size_t)65536 }) {
+			std::vector<char> repeated(randomBytes.begin(), randomBytes.begin() + offset);
+			repeated.insert(repeated.end(), randomBytes.begin(), randomBytes.begin() + 1000);
+			CHECK(roundTrip(repeated) > 0);
+		}
+
+		unsigned int failedRoundTripsNr = 0;
+		size_t srcSzTotal = 0;
+		size_t compressedSzTotal = 0;
+		for (unsigned int blockIdx = 0; blockIdx < randomBlocksNr; blockIdx++) {
+			// short words from a small alphabet, with random repeats
+			std::vector<char> block;
+			size_t blockSz = rng() % 20000;
+			while (block.size() < blockSz) {
+				if (block.size() > 16 && rng() % 4 == 0) {
+					size_t copyStartIdx = rng() % block.size();
+					size_t copyLen = std::min<size_t>(rng() % 300, block.size() - copyStartIdx);
+					std::vector<char> copied(block.begin() + copyStartIdx, block.begin() + copyStartIdx + copyLen);
+					block.insert(block.end(), copied.begin(), copied.end());
+				}
+				else
+					block.push_back((char)('a' + rng() % (1 + blockIdx % 20)));
+			}
+			size_t compressedSz = roundTrip(block);
+			if (compressedSz == 0)
+				failedRoundTripsNr++;
+			srcSzTotal += block.size();
+			compressedSzTotal += compressedSz;
+		}
+		CHECK(failedRoundTripsNr == 0);
+		CHECK(compressedSzTotal < srcSzTotal);
+		printf("%u random blocks: %zu bytes compressed to %zu, %u failed round trips\n", randomBlocksNr, srcSzTotal, compressedSzTotal, failedRoundTripsNr);
+	}
+
+	void testMalformedBlocks() {
+		std::string str = "abcdabcdabcdabcdabcdabcdabcdabcdabcd - abcdabcd";
+		std::vector<char> compressed;
+		lzCompress(str.data(), str.size(), compressed);
+		std::vector<char> decompressed(str.size() + 1);
+		CHECK(lzDecompress(compressed.data(), compressed.size(), decompressed.data(), str.size()));
+		CHECK(!lzDecompress(compressed.data(), compressed.size(), decompressed.data(), str.size() + 1));
+		CHECK(!lzDecompress(compressed.data(), compressed.size(), decompressed.data(), str.size() - 1));
+		for (size_t truncatedSz = 1; truncatedSz < compressed.size(); truncatedSz++)
+			CHECK(!lzDecompress(compressed.data(), truncatedSz, decompressed.data(), str.size()));
+
+		// a literal and a match 2 bytes back
+		char matchBeforeStart[] = { 0x10, 'a', 0x02, 0x00 };
+		CHECK(!lzDecompress(matchBeforeStart, sizeof(matchBeforeStart), decompressed.data(), 5));
+		char zeroOffset[] = { 0x10, 'a', 0x00, 0x00 };
+		CHECK(!lzDecompress(zeroOffset, sizeof(zeroOffset), decompressed.data(), 5));
+		char literalsLenPastEnd[] = { (char)0xF0, (char)255 };
+		CHECK(!lzDecompress(literalsLenPastEnd, sizeof(literalsLenPastEnd), decompressed.data(), decompressed.size()));
+
+		// flipped bytes never write past the destination (its guard bytes are intact)
+		std::mt19937 rng(19);
+		std::vector<char> src(5000);
+		for (size_t byteIdx = 0; byteIdx < src.size(); byteIdx++)
+			src[byteIdx] = (char)('a' + (byteIdx * 7 + rng() % 3) % 11);
+		compressed.clear();
+		lzCompress(src.data(), src.size(), compressed);
+		const size_t GUARD_SZ = 64;
+		unsigned int guardsOverwrittenNr = 0;
+		unsigned int acceptedCorruptionsNr = 0;
+		for (unsigned int flipIdx = 0; flipIdx < 2000; flipIdx++) {
+			std::vector<char> corrupt = compressed;
+			corrupt[rng() % corrupt.size()] ^= (char)(1 + rng() % 255);
+			std::vector<char> dst(src.size() + GUARD_SZ, 'G');
+			if (lzDecompress(corrupt.data(), corrupt.size(), dst.data(), src.size()) && !std::equal(src.begin(), src.end(), dst.begin()))
+				acceptedCorruptionsNr++;
+			for (size_t guardIdx = src.size(); guardIdx < dst.size(); guardIdx++) {
+				if (dst[guardIdx] != 'G') {
+					guardsOverwrittenNr++;
+					break;
+				}
+			}
+		}
+		CHECK(guardsOverwrittenNr == 0);
+		// these are what the blocks' checksums are for
+		printf("2000 flipped bytes: %u decompressed to wrong data\n", acceptedCorruptionsNr);
+	}
+
+	ModelDesc genModelDesc(unsigned int verticesNr) {
+		ModelDesc modelDesc;
+		modelDesc.colladaPath = "lzCodecTest.dae";
+		modelDesc.verticesNr = verticesNr;
+		modelDesc.meshesNr = 1;
+		modelDesc.verticesNrsPerMesh = { verticesNr };
+		modelDesc.extraColorsNrsPerMesh = { 0 };
+		modelDesc.extraColors.resize(1);
+		modelDesc.texesNrsPerMesh = { 0 };
+		modelDesc.facesNr = verticesNr / 3;
+		modelDesc.facesNrsPerMesh = { modelDesc.facesNr };
+		modelDesc.bonesNrsPerMesh = { 0 };
+		modelDesc.vertices.resize(verticesNr, ModelDesc::VertexData());
+		for (unsigned int vertexIdx = 0; vertexIdx < verticesNr; vertexIdx++) {
+			modelDesc.vertices[vertexIdx].pos = glm::vec3(std::cos(0.01f * vertexIdx), std::sin(0.01f * vertexIdx), 0.001f * vertexIdx);
+			modelDesc.idxs.push_back(verticesNr - 1 - vertexIdx);
+		}
+		modelDesc.submeshesDescs = { { 0, verticesNr, 0, verticesNr } };
+		modelDesc.meshesTransforms = { glm::mat4(1.0f) };
+		return modelDesc;
+	}
+
+	void testCompressedMappedAssets() {
+		std::vector<ModelDesc> modelDescs = { genModelDesc(3000), genModelDesc(9000) };
+		SceneData sceneData;
+		sceneData.staticModelsNr = 2;
+		sceneData.sceneModelsData = { { 0, true, 5, { Transform3D() } }, { 1, true, 7, { Transform3D() } } };
+		AssetsCompressionParams compressionParams;
+		compressionParams.isCompressed = true;
+		compressionParams.blockSz = 4096;
+		writeMappedAssetsFile(ASSETS_FILE_NAME, { &modelDescs[0], &modelDescs[1] }, { &sceneData }, compressionParams);
+		writeMappedAssetsFile(UNCOMPRESSED_ASSETS_FILE_NAME, { &modelDescs[0], &modelDescs[1] }, { &sceneData });
+
+		std::ifstream compressedFile(ASSETS_FILE_NAME, std::ios::binary);
+		std::vector<char> compressedBytes((std::istreambuf_iterator<char>(compressedFile)), std::istreambuf_iterator<char>());
+		compressedFile.close();
+		{
+			MappedAssets compressedAssets(ASSETS_FILE_NAME);
+			MappedAssets uncompressedAssets(UNCOMPRESSED_ASSETS_FILE_NAME);
+			// decompressed into memory, to the uncompressed layout's size
+			CHECK(!compressedAssets.isMapped() && uncompressedAssets.isMapped());
+			CHECK(compressedAssets.getSz() == uncompressedAssets.getSz());
+			CHECK(compressedBytes.size() < uncompressedAssets.getSz());
+			CHECK(compressedAssets.getModelsNr() == 2 && compressedAssets.getScenesNr() == 1);
+			for (unsigned int modelIdx = 0; modelIdx < 2; modelIdx++) {
+				ModelDescView modelDesc = compressedAssets.getModelDesc(modelIdx);
+				CHECK(modelDesc.vertices.size() == modelDescs[modelIdx].vertices.size());
+				CHECK(modelDesc.idxs.size() == modelDescs[modelIdx].idxs.size() && std::equal(modelDesc.idxs.begin(), modelDesc.idxs.end(), modelDescs[modelIdx].idxs.begin()));
+				bool areVerticesEqual = true;
+				for (unsigned int vertexIdx = 0; vertexIdx < modelDesc.vertices.size(); vertexIdx++)
+					areVerticesEqual &= modelDesc.vertices[vertexIdx].pos == modelDescs[modelIdx].vertices[vertexIdx].pos;
+				CHECK(areVerticesEqual);
+			}
+			CHECK(compressedAssets.getSceneData(0).sceneModelsData[1].instancesNrMax == 7);
+		}
+
+		// a flipped byte within the last block's data
+		std::vector<char> corruptBytes = compressedBytes;
+		CHECK(corruptBytes.size() > COMPRESSED_HEADER_SZ + 16);
+		corruptBytes[corruptBytes.size() - 3] ^= 0x5A;
+		std::ofstream corruptFile(ASSETS_FILE_NAME, std::ios::binary);
+		corruptFile.write(corruptBytes.data(), corruptBytes.size());
+		corruptFile.close();
+		bool hasThrown = false;
+		try {
+			MappedAssets corruptAssets(ASSETS_FILE_NAME);
+		}
+		catch (std::ios_base::failure&) {
+			hasThrown = true;
+		}
+		CHECK(hasThrown);
+
+		remove(ASSETS_FILE_NAME);
+		remove(UNCOMPRESSED_ASSETS_FILE_NAME);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned int randomBlocksNr = argc > 1 ? strtoul(argv[1], NULL, 10) : 300;
+	testCrc32();
+	testRoundTrips(randomBlocksNr);
+	testMalformedBlocks();
+	testCompressedMappedAssets();
+
+	return Corium3DTests::reportResults("LZCodecTest");
+}
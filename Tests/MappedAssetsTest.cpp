@@ -0,0 +1,172 @@
+// Tests MappedAssets over a written mapped assets file (with quantized positions): the models and the scene read back
+// through the views as written, and every corruption of the file's offsets and sizes - the locations tables, a model's
+// and a scene's records, an array's offset, size and alignment, a scene model's index, a quantized array and a truncated
+// file - is refused on open instead of being read through.
+// Standalone - builds on Linux:
+//   g++ -std=c++17 -O2 -DDEBUG=1 -D_USE_MATH_DEFINES -fpermissive -include cstring -I../Corium3D -I../externals/Include
+//       MappedAssetsTest.cpp ../Corium3D/MappedAssets.cpp ../Corium3D/AssetsOps.cpp ../Corium3D/LZCodec.cpp -lpthread
+//       -o mappedAssetsTest
+// usage: mappedAssetsTest
+
+#include "Tests.h"
+#include "MappedAssets.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <vector>
+
+using namespace Corium3D;
+
+namespace {
+
+	const char* const ASSETS_FILE_NAME = "mappedAssetsTest.assets";
+	const char* const CORRUPT_ASSETS_FILE_NAME = "mappedAssetsTestCorrupt.assets";
+	// MappedAssetsHeader's and the records' layouts
+	const size_t MODELS_LOCS_OFFSET_OFFSET = 16;
+	const size_t SCENES_LOCS_OFFSET_OFFSET = 24;
+	const size_t QUANTIZED_ARRS_OFFSET_OFFSET = 32;
+	const size_t QUANTIZED_ARRS_NR_OFFSET = 40;
+	const size_t MAPPED_ARR_SZ = 16;
+	const unsigned int VERTICES_MAPPED_ARR_IDX = 9;
+	const unsigned int EXTRA_COLORS_BASE_IDXS_MAPPED_ARR_IDX = 3;
+	const size_t SCENE_MODEL_DATA_SZ = 32;
+	const size_t QUANTIZED_ARR_SRC_OFFSET_OFFSET = 8;
+
+	ModelDesc genModelDesc(unsigned int verticesNr, float scale) {
+		ModelDesc modelDesc;
+		modelDesc.colladaPath = "mappedAssetsTest.dae";
+		modelDesc.verticesNr = verticesNr;
+		modelDesc.meshesNr = 1;
+		modelDesc.verticesNrsPerMesh = { verticesNr };
+		modelDesc.extraColorsNrsPerMesh = { 2 };
+		modelDesc.extraColors = { { { { 1.0f, 0.0f, 0.0f, 1.0f } }, { { 0.0f, 1.0f, 0.0f, 1.0f } } } };
+		modelDesc.texesNrsPerMesh = { 0 };
+		modelDesc.facesNr = verticesNr / 3;
+		modelDesc.facesNrsPerMesh = { modelDesc.facesNr };
+		modelDesc.bonesNrsPerMesh = { 0 };
+		modelDesc.vertices.resize(verticesNr, ModelDesc::VertexData());
+		for (unsigned int vertexIdx = 0; vertexIdx < verticesNr; vertexIdx++) {
+			modelDesc.vertices[vertexIdx].pos = scale * glm::vec3((float)(vertexIdx % 7), (float)(vertexIdx % 5), -(float)vertexIdx);
+			modelDesc.idxs.push_back(vertexIdx);
+		}
+		modelDesc.submeshesDescs = { { 0, verticesNr, 0, verticesNr } };
+		modelDesc.meshesTransforms = { glm::mat4(1.0f) };
+		return modelDesc;
+	}
+
+	std::vector<char> readFile(char const* fileName) {
+		std::ifstream file(fileName, std::ios::binary);
+		return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	void writeFile(char const* fileName, std::vector<char> const& bytes, size_t sz) {
+		std::ofstream file(fileName, std::ios::binary);
+		file.write(bytes.data(), sz);
+	}
+
+	template <class T>
+	T readVal(std::vector<char> const& bytes, size_t offset) {
+		T val;
+		memcpy(&val, &bytes[offset], sizeof(T));
+		return val;
+	}
+
+	template <class T>
+	std::vector<char> patchVal(std::vector<char> bytes, size_t offset, T val) {
+		memcpy(&bytes[offset], &val, sizeof(T));
+		return bytes;
+	}
+
+	bool isRefused(std::vector<char> const& bytes, size_t sz) {
+		writeFile(CORRUPT_ASSETS_FILE_NAME, bytes, sz);
+		try {
+			MappedAssets mappedAssets(CORRUPT_ASSETS_FILE_NAME);
+		}
+		catch (std::ios_base::failure&) {
+			return true;
+		}
+		return false;
+	}
+
+	bool isRefused(std::vector<char> const& bytes) {
+		return isRefused(bytes, bytes.size());
+	}
+
+	void testRoundTrip(std::vector<ModelDesc> const& modelDescs, SceneData const& sceneData) {
+		MappedAssets mappedAssets(ASSETS_FILE_NAME);
+		CHECK(mappedAssets.getModelsNr() == modelDescs.size());
+		CHECK(mappedAssets.getScenesNr() == 1);
+		for (unsigned int modelIdx = 0; modelIdx < mappedAssets.getModelsNr() && modelIdx < modelDescs.size(); modelIdx++) {
+			ModelDescView modelDesc = mappedAssets.getModelDesc(modelIdx);
+			CHECK(modelDesc.vertices.size() == modelDescs[modelIdx].vertices.size());
+			CHECK(std::equal(modelDesc.idxs.begin(), modelDesc.idxs.end(), modelDescs[modelIdx].idxs.begin()));
+			float positionsErrorMax = 0.0f;
+			for (unsigned int vertexIdx = 0; vertexIdx < modelDesc.vertices.size() && vertexIdx < modelDescs[modelIdx].vertices.size(); vertexIdx++)
+				positionsErrorMax = std::max(positionsErrorMax, glm::length(modelDesc.vertices[vertexIdx].pos - modelDescs[modelIdx].vertices[vertexIdx].pos));
+			CHECK(positionsErrorMax < 0.01f);
+			CHECK(modelDesc.extraColors[0].size() == 2 && modelDesc.extraColors[0][1][1] == 1.0f);
+		}
+
+		SceneDataView sceneDataView = mappedAssets.getSceneData(0);
+		CHECK(sceneDataView.staticModelsNr == sceneData.staticModelsNr);
+		CHECK(sceneDataView.sceneModelsData.size() == sceneData.sceneModelsData.size());
+		if (sceneDataView.sceneModelsData.size() == 2) {
+			SceneDataView::SceneModelDataView sceneModelData = sceneDataView.sceneModelsData[1];
+			CHECK(sceneModelData.modelIdx == 1 && !sceneModelData.isStatic && sceneModelData.instancesNrMax == 4);
+			CHECK(sceneModelData.instancesTransformsInit.size() == 2 && sceneModelData.instancesTransformsInit[1].translate == glm::vec3(3.0f, 0.0f, 0.0f));
+		}
+	}
+
+	void testCorruptions() {
+		std::vector<char> bytes = readFile(ASSETS_FILE_NAME);
+		CHECK(!isRefused(bytes));
+		uint64_t modelsLocsOffset = readVal<uint64_t>(bytes, MODELS_LOCS_OFFSET_OFFSET);
+		uint64_t modelOffset = readVal<uint64_t>(bytes, modelsLocsOffset);
+		uint64_t sceneOffset = readVal<uint64_t>(bytes, readVal<uint64_t>(bytes, SCENES_LOCS_OFFSET_OFFSET));
+		uint64_t sceneModelsDataOffset = readVal<uint64_t>(bytes, sceneOffset);
+		uint64_t verticesArrOffset = modelOffset + VERTICES_MAPPED_ARR_IDX * MAPPED_ARR_SZ;
+		uint64_t quantizedArrsOffset = readVal<uint64_t>(bytes, QUANTIZED_ARRS_OFFSET_OFFSET);
+		// the first model's positions are quantized
+		CHECK(readVal<uint32_t>(bytes, QUANTIZED_ARRS_NR_OFFSET) == 1);
+
+		CHECK(isRefused(patchVal<uint64_t>(bytes, MODELS_LOCS_OFFSET_OFFSET, bytes.size())));
+		CHECK(isRefused(patchVal<uint64_t>(bytes, SCENES_LOCS_OFFSET_OFFSET, ~0ull)));
+		CHECK(isRefused(patchVal<uint64_t>(bytes, modelsLocsOffset, bytes.size() - 16)));
+		CHECK(isRefused(patchVal<uint64_t>(bytes, verticesArrOffset, 1ull << 40)));
+		CHECK(isRefused(patchVal<uint32_t>(bytes, verticesArrOffset + sizeof(uint64_t), 0x7FFFFFFF)));
+		CHECK(isRefused(patchVal<uint64_t>(bytes, verticesArrOffset, readVal<uint64_t>(bytes, verticesArrOffset) + 4)));
+		// the first mesh's extra colors pointed past the model's colors
+		uint64_t extraColorsBaseIdxsOffset = readVal<uint64_t>(bytes, modelOffset + EXTRA_COLORS_BASE_IDXS_MAPPED_ARR_IDX * MAPPED_ARR_SZ);
+		CHECK(isRefused(patchVal<uint32_t>(bytes, extraColorsBaseIdxsOffset, 1)));
+		// the scene's second model's index
+		CHECK(isRefused(patchVal<uint32_t>(bytes, sceneModelsDataOffset + SCENE_MODEL_DATA_SZ, 99)));
+		CHECK(isRefused(patchVal<uint64_t>(bytes, quantizedArrsOffset + QUANTIZED_ARR_SRC_OFFSET_OFFSET, bytes.size())));
+		CHECK(isRefused(bytes, bytes.size() / 2));
+		CHECK(isRefused(bytes, 40));
+		remove(CORRUPT_ASSETS_FILE_NAME);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	std::vector<ModelDesc> modelDescs = { genModelDesc(30, 1.0f), genModelDesc(300, 10.0f) };
+	SceneData sceneData;
+	sceneData.staticModelsNr = 1;
+	sceneData.sceneModelsData = { { 0, true, 8, { Transform3D() } }, { 1, false, 4, { Transform3D(), Transform3D() } } };
+	sceneData.sceneModelsData[1].instancesTransformsInit[1].translate = glm::vec3(3.0f, 0.0f, 0.0f);
+	AssetsCompressionParams compressionParams;
+	compressionParams.positionsErrorMax = 0.01f;
+	writeMappedAssetsFile(ASSETS_FILE_NAME, { &modelDescs[0], &modelDescs[1] }, { &sceneData }, compressionParams);
+
+	testRoundTrip(modelDescs, sceneData);
+	testCorruptions();
+	remove(ASSETS_FILE_NAME);
+
+	return Corium3DTests::reportResults("MappedAssetsTest");
+}
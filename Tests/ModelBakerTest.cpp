@@ -0,0 +1,196 @@
+// Tests bakeLods' vertices clustering over a model of 2 spheres' meshes: the levels are at most MODEL_LODS_NR_MAX - 1,
+// each sheds enough of its finer level's faces, their screen sizes descend, their submeshes keep the meshes' vertices
+// ranges and lay their indices out level after level and mesh after mesh, and their faces are over the meshes' own
+// vertices, none degenerate or duplicate, wound as the full detail ones (outwards), and within the levels' displacement
+// of the full detail surface. Then that baking is deterministic and replaces the previous levels, and that models with
+// nothing to simplify get no levels.
+// Standalone - builds on Linux (assimp is not linked - bakeLods reads no assimp scene):
+//   g++ -std=c++14 -O2 -DDEBUG=1 -D_USE_MATH_DEFINES -I../Corium3D -I../externals/Include ModelBakerTest.cpp
+//       ../Corium3DAssetsGen/ModelBaker.cpp -o modelBakerTest
+// usage: modelBakerTest [<sphere rings nr>]
+
+#include "Tests.h"
+#include "../Corium3DAssetsGen/ModelBaker.h"
+
+#include <glm/gtx/norm.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+using namespace Corium3D;
+
+namespace {
+
+	// ModelBaker.cpp's LOD_FACES_RATIO_MAX
+	const float LOD_FACES_RATIO_MAX = 0.75f;
+
+	// a UV sphere over shared vertices, wound counterclockwise seen from outside
+	void addSphereMesh(glm::vec3 const& center, float radius, unsigned int ringsNr, ModelDesc& outModelDesc) {
+		unsigned int segmentsNr = 2 * ringsNr;
+		unsigned int baseVertex = outModelDesc.vertices.size();
+		unsigned int firstIdx = outModelDesc.idxs.size();
+		for (unsigned int ringIdx = 0; ringIdx <= ringsNr; ringIdx++) {
+			float polarAngle = (float)M_PI * ringIdx / ringsNr;
+			for (unsigned int segmentIdx = 0; segmentIdx < segmentsNr; segmentIdx++) {
+				float azimuth = 2.0f * (float)M_PI * segmentIdx / segmentsNr;
+				ModelDesc::VertexData vertex = {};
+				vertex.pos = center + radius * glm::vec3(sinf(polarAngle) * cosf(azimuth), cosf(polarAngle), sinf(polarAngle) * sinf(azimuth));
+				outModelDesc.vertices.push_back(vertex);
+			}
+		}
+		for (unsigned int ringIdx = 0; ringIdx < ringsNr; ringIdx++) {
+			for (unsigned int segmentIdx = 0; segmentIdx < segmentsNr; segmentIdx++) {
+				unsigned int topLeft = ringIdx * segmentsNr + segmentIdx;
+				unsigned int topRight = ringIdx * segmentsNr + (segmentIdx + 1) % segmentsNr;
+				unsigned int botLeft = topLeft + segmentsNr;
+				unsigned int botRight = topRight + segmentsNr;
+				if (ringIdx > 0)
+					outModelDesc.idxs.insert(outModelDesc.idxs.end(), { topLeft, topRight, botLeft });
+				if (ringIdx < ringsNr - 1)
+					outModelDesc.idxs.insert(outModelDesc.idxs.end(), { topRight, botRight, botLeft });
+			}
+		}
+
+		unsigned int verticesNr = outModelDesc.vertices.size() - baseVertex;
+		unsigned int idxsNr = outModelDesc.idxs.size() - firstIdx;
+		outModelDesc.meshesNr++;
+		outModelDesc.verticesNr += verticesNr;
+		outModelDesc.facesNr += idxsNr / 3;
+		outModelDesc.verticesNrsPerMesh.push_back(verticesNr);
+		outModelDesc.facesNrsPerMesh.push_back(idxsNr / 3);
+		outModelDesc.submeshesDescs.push_back({ baseVertex, verticesNr, firstIdx, idxsNr });
+	}
+
+	ModelDesc genSpheresModelDesc(unsigned int ringsNr) {
+		ModelDesc modelDesc;
+		modelDesc.verticesNr = 0;
+		modelDesc.facesNr = 0;
+		modelDesc.meshesNr = 0;
+		addSphereMesh(glm::vec3(0.0f), 1.0f, ringsNr, modelDesc);
+		addSphereMesh(glm::vec3(1.5f, 0.0f, 0.0f), 0.3f, ringsNr / 2, modelDesc);
+		modelDesc.boundingSphereRadius = 1.8f;
+		return modelDesc;
+	}
+
+	void testSpheresLods(unsigned int ringsNr) {
+		ModelDesc modelDesc = genSpheresModelDesc(ringsNr);
+		bakeLods(modelDesc);
+		unsigned int lodsNr = modelDesc.lodsDescs.size();
+		CHECK(lodsNr > 0 && lodsNr <= MODEL_LODS_NR_MAX - 1);
+		CHECK(modelDesc.lodsSubmeshesDescs.size() == lodsNr * modelDesc.meshesNr);
+		if (modelDesc.lodsSubmeshesDescs.size() != lodsNr * modelDesc.meshesNr)
+			return;
+
+		const glm::vec3 meshesCenters[2] = { glm::vec3(0.0f), glm::vec3(1.5f, 0.0f, 0.0f) };
+		unsigned int errsNr = 0;
+		unsigned int facesNr = 0;
+		unsigned int inwardFacesNr = 0;
+		unsigned int processedIdxsNr = 0;
+		float displacementMax = 0.0f;
+		for (unsigned int lodIdx = 0; lodIdx < lodsNr; lodIdx++) {
+			ModelDesc::LodDesc const& lodDesc = modelDesc.lodsDescs[lodIdx];
+			unsigned int finerLodFacesNr = lodIdx ? modelDesc.lodsDescs[lodIdx - 1].facesNr : modelDesc.facesNr;
+			float finerLodScreenSzMax = lodIdx ? modelDesc.lodsDescs[lodIdx - 1].screenSzMax : INFINITY;
+			if (lodDesc.facesNr == 0 || lodDesc.facesNr > LOD_FACES_RATIO_MAX * finerLodFacesNr || !(lodDesc.screenSzMax > 0.0f) || lodDesc.screenSzMax > finerLodScreenSzMax)
+				errsNr++;
+			// the vertices' displacement the level's screen size stands for
+			float lodDisplacementMax = LOD_SCREEN_ERROR_MAX * 2.0f * modelDesc.boundingSphereRadius / lodDesc.screenSzMax;
+
+			unsigned int lodFacesNr = 0;
+			for (unsigned int meshIdx = 0; meshIdx < modelDesc.meshesNr; meshIdx++) {
+				ModelDesc::SubmeshDesc const& submeshDesc = modelDesc.submeshesDescs[meshIdx];
+				ModelDesc::SubmeshDesc const& lodSubmeshDesc = modelDesc.lodsSubmeshesDescs[lodIdx * modelDesc.meshesNr + meshIdx];
+				if (lodSubmeshDesc.baseVertex != submeshDesc.baseVertex || lodSubmeshDesc.verticesNr != submeshDesc.verticesNr ||
+					lodSubmeshDesc.firstIdx != processedIdxsNr || lodSubmeshDesc.idxsNr % 3 != 0 || lodSubmeshDesc.firstIdx + lodSubmeshDesc.idxsNr > modelDesc.lodsIdxs.size()) {
+					errsNr++;
+					continue;
+				}
+				processedIdxsNr += lodSubmeshDesc.idxsNr;
+				lodFacesNr += lodSubmeshDesc.idxsNr / 3;
+
+				std::set<std::array<unsigned int, 3>> faces;
+				std::set<unsigned int> lodVerticesIdxs;
+				ModelDesc::VertexData const* meshVertices = &modelDesc.vertices[submeshDesc.baseVertex];
+				for (unsigned int idxIdx = lodSubmeshDesc.firstIdx; idxIdx < lodSubmeshDesc.firstIdx + lodSubmeshDesc.idxsNr; idxIdx += 3) {
+					std::array<unsigned int, 3> face = { modelDesc.lodsIdxs[idxIdx], modelDesc.lodsIdxs[idxIdx + 1], modelDesc.lodsIdxs[idxIdx + 2] };
+					if (face[0] >= submeshDesc.verticesNr || face[1] >= submeshDesc.verticesNr || face[2] >= submeshDesc.verticesNr ||
+						face[0] == face[1] || face[1] == face[2] || face[2] == face[0]) {
+						errsNr++;
+						continue;
+					}
+					lodVerticesIdxs.insert(face.begin(), face.end());
+					glm::vec3 normal = glm::cross(meshVertices[face[1]].pos - meshVertices[face[0]].pos, meshVertices[face[2]].pos - meshVertices[face[0]].pos);
+					glm::vec3 centroid = (meshVertices[face[0]].pos + meshVertices[face[1]].pos + meshVertices[face[2]].pos) / 3.0f;
+					if (glm::dot(normal, centroid - meshesCenters[meshIdx]) <= 0.0f)
+						inwardFacesNr++;
+					facesNr++;
+					std::rotate(face.begin(), std::min_element(face.begin(), face.end()), face.end());
+					if (!faces.insert(face).second)
+						errsNr++;
+				}
+
+				// every full detail vertex is within the level's displacement of the level's vertices
+				for (unsigned int vertexIdx = 0; vertexIdx < submeshDesc.verticesNr && !lodVerticesIdxs.empty(); vertexIdx++) {
+					float distSqMin = INFINITY;
+					for (unsigned int lodVertexIdx : lodVerticesIdxs)
+						distSqMin = std::min(distSqMin, glm::distance2(meshVertices[vertexIdx].pos, meshVertices[lodVertexIdx].pos));
+					displacementMax = std::max(displacementMax, sqrtf(distSqMin) / lodDisplacementMax);
+				}
+			}
+			if (lodFacesNr != lodDesc.facesNr)
+				errsNr++;
+		}
+		if (processedIdxsNr != modelDesc.lodsIdxs.size())
+			errsNr++;
+		CHECK(errsNr == 0);
+		// the clustered faces keep their winding - but for a few slivers
+		CHECK(inwardFacesNr <= facesNr / 20);
+		// the nearest of the level's vertices is at most the vertex's representative
+		CHECK(displacementMax <= 1.0f + 1e-4f);
+		printf("%u faces: %u levels of", modelDesc.facesNr, lodsNr);
+		for (ModelDesc::LodDesc const& lodDesc : modelDesc.lodsDescs)
+			printf(" %u faces (under %.3f)", lodDesc.facesNr, lodDesc.screenSzMax);
+		printf(", %u of %u faces inward, %u errors\n", inwardFacesNr, facesNr, errsNr);
+
+		// rebaked identically over the previous levels
+		std::vector<ModelDesc::LodDesc> lodsDescs = modelDesc.lodsDescs;
+		std::vector<unsigned int> lodsIdxs = modelDesc.lodsIdxs;
+		bakeLods(modelDesc);
+		CHECK(modelDesc.lodsDescs.size() == lodsDescs.size() && modelDesc.lodsIdxs == lodsIdxs);
+		for (unsigned int lodIdx = 0; lodIdx < lodsNr && lodIdx < modelDesc.lodsDescs.size(); lodIdx++)
+			CHECK(modelDesc.lodsDescs[lodIdx].facesNr == lodsDescs[lodIdx].facesNr && modelDesc.lodsDescs[lodIdx].screenSzMax == lodsDescs[lodIdx].screenSzMax);
+	}
+
+	void testUnsimplifiable() {
+		ModelDesc modelDesc = genSpheresModelDesc(8);
+		modelDesc.boundingSphereRadius = 0.0f;
+		bakeLods(modelDesc);
+		CHECK(modelDesc.lodsDescs.empty() && modelDesc.lodsIdxs.empty() && modelDesc.lodsSubmeshesDescs.empty());
+
+		// a triangle does not shed faces until it collapses altogether
+		ModelDesc triangleModelDesc;
+		triangleModelDesc.verticesNr = 3;
+		triangleModelDesc.facesNr = 1;
+		triangleModelDesc.meshesNr = 1;
+		triangleModelDesc.vertices.resize(3, ModelDesc::VertexData());
+		triangleModelDesc.vertices[1].pos = glm::vec3(1.0f, 0.0f, 0.0f);
+		triangleModelDesc.vertices[2].pos = glm::vec3(0.0f, 1.0f, 0.0f);
+		triangleModelDesc.idxs = { 0, 1, 2 };
+		triangleModelDesc.submeshesDescs = { { 0, 3, 0, 3 } };
+		triangleModelDesc.boundingSphereRadius = 1.0f;
+		bakeLods(triangleModelDesc);
+		CHECK(triangleModelDesc.lodsDescs.empty() && triangleModelDesc.lodsIdxs.empty());
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned int ringsNr = argc > 1 ? strtoul(argv[1], NULL, 10) : 48;
+	testSpheresLods(ringsNr);
+	testUnsimplifiable();
+
+	return Corium3DTests::reportResults("ModelBakerTest");
+}
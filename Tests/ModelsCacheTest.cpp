@@ -0,0 +1,183 @@
+// Tests ModelsCache over a stored model with a dependency: a miss before the store and a hit after it (from another
+// cache over the same folder too) reproducing the model byte for byte, misses as the dependency changes or goes missing
+// and as the model's file changes, and that an interrupted store - a truncated assets file, a deps file not yet renamed
+// into place - is a miss rather than a hit on partial data, until a store completes the entry again.
+// Standalone - builds on Linux (assimp is not linked - the cache's models have no importers):
+//   g++ -std=c++17 -O2 -DDEBUG=1 -D_USE_MATH_DEFINES -fpermissive -include cstring -I../Corium3D -I../externals/Include
+//       ModelsCacheTest.cpp ../Corium3DAssetsGen/ModelsCache.cpp ../Corium3D/MappedAssets.cpp ../Corium3D/AssetsOps.cpp
+//       ../Corium3D/LZCodec.cpp -lpthread -o modelsCacheTest
+// usage: modelsCacheTest
+
+#include "Tests.h"
+#include "../Corium3DAssetsGen/ModelsCache.h"
+#include "MappedAssets.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace Corium3D;
+
+// ModelsCache only ever resets the importers
+Assimp::Importer::~Importer() {}
+
+namespace {
+
+	const char* const CACHE_FOLDER_PATH = "modelsCacheTestCache";
+	const char* const MODEL_PATH = "modelsCacheTest.dae";
+	const char* const DEP_PATH = "modelsCacheTest.png";
+	const char* const ASSETS_FILE_NAME = "modelsCacheTest.assets";
+	const char* const LOADED_ASSETS_FILE_NAME = "modelsCacheTestLoaded.assets";
+
+	std::vector<char> readFile(char const* fileName) {
+		std::ifstream file(fileName, std::ios::binary);
+		return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	void writeFile(std::string const& fileName, std::string const& content) {
+		std::ofstream file(fileName, std::ios::binary);
+		file.write(content.data(), content.size());
+	}
+
+	void genImportedModel(ImportedModel& outImportedModel) {
+		ModelDesc* modelDesc = new ModelDesc;
+		const unsigned int VERTICES_NR = 300;
+		modelDesc->colladaPath = MODEL_PATH;
+		modelDesc->verticesNr = VERTICES_NR;
+		modelDesc->meshesNr = 1;
+		modelDesc->verticesNrsPerMesh = { VERTICES_NR };
+		modelDesc->extraColorsNrsPerMesh = { 1 };
+		modelDesc->extraColors = { { { { 0.5f, 0.25f, 1.0f, 1.0f } } } };
+		modelDesc->texesNrsPerMesh = { 0 };
+		modelDesc->facesNr = VERTICES_NR / 3;
+		modelDesc->facesNrsPerMesh = { modelDesc->facesNr };
+		modelDesc->bonesNrsPerMesh = { 0 };
+		modelDesc->vertices.resize(VERTICES_NR, ModelDesc::VertexData());
+		for (unsigned int vertexIdx = 0; vertexIdx < VERTICES_NR; vertexIdx++) {
+			modelDesc->vertices[vertexIdx].pos = glm::vec3((float)(vertexIdx % 11), 0.5f * (float)(vertexIdx % 3), -0.25f * (float)vertexIdx);
+			modelDesc->idxs.push_back((vertexIdx * 7) % VERTICES_NR);
+		}
+		modelDesc->submeshesDescs = { { 0, VERTICES_NR, 0, VERTICES_NR } };
+		modelDesc->meshesTransforms = { glm::mat4(1.0f) };
+
+		outImportedModel.modelDesc.reset(modelDesc);
+		outImportedModel.aabbMinVertex = glm::vec3(0.0f, 0.0f, -75.0f);
+		outImportedModel.aabbMaxVertex = glm::vec3(10.0f, 1.0f, 0.0f);
+		outImportedModel.boundingCapsule = { glm::vec3(5.0f, 0.5f, -37.5f), glm::vec3(0.0f, 0.0f, 1.0f), 75.0f, 5.0f };
+		outImportedModel.sourcesPaths = { MODEL_PATH, DEP_PATH };
+	}
+
+	// the entry's path without the extension (the folder holds a single entry)
+	std::string findEntryPath() {
+		for (std::filesystem::directory_entry const& dirEntry : std::filesystem::directory_iterator(CACHE_FOLDER_PATH)) {
+			if (dirEntry.path().extension() == ".deps")
+				return (dirEntry.path().parent_path() / dirEntry.path().stem()).string();
+		}
+		return std::string();
+	}
+
+	bool isLoadedAsStored(ImportedModel const& loadedModel, ImportedModel const& storedModel) {
+		if (!loadedModel.modelDesc || loadedModel.importer || loadedModel.sourcesPaths != storedModel.sourcesPaths ||
+			loadedModel.aabbMinVertex != storedModel.aabbMinVertex || loadedModel.aabbMaxVertex != storedModel.aabbMaxVertex ||
+			loadedModel.boundingCapsule.axisVec != storedModel.boundingCapsule.axisVec || loadedModel.boundingCapsule.radius != storedModel.boundingCapsule.radius)
+			return false;
+
+		// as generated out of the cache - byte for byte the same assets
+		writeMappedAssetsFile(ASSETS_FILE_NAME, { storedModel.modelDesc.get() }, std::vector<SceneData const*>());
+		writeMappedAssetsFile(LOADED_ASSETS_FILE_NAME, { loadedModel.modelDesc.get() }, std::vector<SceneData const*>());
+		return readFile(ASSETS_FILE_NAME) == readFile(LOADED_ASSETS_FILE_NAME);
+	}
+
+	void testHitsAndMisses() {
+		writeFile(MODEL_PATH, "<COLLADA>model</COLLADA>");
+		writeFile(DEP_PATH, "texture");
+		ImportedModel storedModel;
+		genImportedModel(storedModel);
+		ModelsCache cache(CACHE_FOLDER_PATH);
+		ImportedModel loadedModel;
+		CHECK(!cache.load(MODEL_PATH, loadedModel));
+		cache.store(storedModel);
+		CHECK(cache.load(MODEL_PATH, loadedModel));
+		CHECK(isLoadedAsStored(loadedModel, storedModel));
+
+		// no temporary files are left behind
+		unsigned int entryFilesNr = 0;
+		for (std::filesystem::directory_entry const& dirEntry : std::filesystem::directory_iterator(CACHE_FOLDER_PATH)) {
+			CHECK(dirEntry.path().extension() != ".tmp");
+			entryFilesNr++;
+		}
+		CHECK(entryFilesNr == 2);
+
+		ModelsCache otherCache(CACHE_FOLDER_PATH);
+		ImportedModel otherLoadedModel;
+		CHECK(otherCache.load(MODEL_PATH, otherLoadedModel));
+		CHECK(isLoadedAsStored(otherLoadedModel, storedModel));
+
+		writeFile(DEP_PATH, "texture edited");
+		CHECK(!cache.load(MODEL_PATH, loadedModel));
+		remove(DEP_PATH);
+		CHECK(!cache.load(MODEL_PATH, loadedModel));
+		writeFile(DEP_PATH, "texture");
+		CHECK(cache.load(MODEL_PATH, loadedModel));
+		writeFile(MODEL_PATH, "<COLLADA>model edited</COLLADA>");
+		CHECK(!cache.load(MODEL_PATH, loadedModel));
+		writeFile(MODEL_PATH, "<COLLADA>model</COLLADA>");
+
+		ModelsCache::Report report = cache.getReport();
+		CHECK(report.hitsNr == 2 && report.missesNr == 4);
+		CHECK(report.modelsReports.size() == 6);
+		if (report.modelsReports.size() == 6) {
+			CHECK(report.modelsReports[0].missReason == "new");
+			CHECK(report.modelsReports[2].missReason == std::string(DEP_PATH) + " changed");
+			CHECK(report.modelsReports[3].missReason == std::string(DEP_PATH) + " missing");
+		}
+	}
+
+	void testInterruptedStores() {
+		ImportedModel storedModel;
+		genImportedModel(storedModel);
+		ModelsCache cache(CACHE_FOLDER_PATH);
+		ImportedModel loadedModel;
+		std::string entryPath = findEntryPath();
+		CHECK(!entryPath.empty());
+		std::vector<char> assetsBytes = readFile((entryPath + ".assets").c_str());
+		std::vector<char> depsBytes = readFile((entryPath + ".deps").c_str());
+
+		// interrupted while writing the assets file, after the deps file was removed
+		remove((entryPath + ".deps").c_str());
+		writeFile(entryPath + ".assets.tmp", std::string(assetsBytes.begin(), assetsBytes.begin() + assetsBytes.size() / 2));
+		CHECK(!cache.load(MODEL_PATH, loadedModel));
+		// interrupted before renaming the deps file
+		writeFile(entryPath + ".deps.tmp", std::string(depsBytes.begin(), depsBytes.end()));
+		CHECK(!cache.load(MODEL_PATH, loadedModel));
+		// even a deps file in place does not make a truncated assets file a hit
+		writeFile(entryPath + ".deps", std::string(depsBytes.begin(), depsBytes.end()));
+		writeFile(entryPath + ".assets", std::string(assetsBytes.begin(), assetsBytes.begin() + assetsBytes.size() / 2));
+		CHECK(!cache.load(MODEL_PATH, loadedModel));
+
+		// completed over the interrupted store's leftovers
+		cache.store(storedModel);
+		CHECK(cache.load(MODEL_PATH, loadedModel));
+		CHECK(isLoadedAsStored(loadedModel, storedModel));
+		CHECK(readFile((entryPath + ".assets").c_str()) == assetsBytes);
+		CHECK(readFile((entryPath + ".deps").c_str()) == depsBytes);
+		CHECK(!std::filesystem::exists(entryPath + ".assets.tmp") && !std::filesystem::exists(entryPath + ".deps.tmp"));
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	std::filesystem::remove_all(CACHE_FOLDER_PATH);
+	testHitsAndMisses();
+	testInterruptedStores();
+	std::filesystem::remove_all(CACHE_FOLDER_PATH);
+	remove(MODEL_PATH);
+	remove(DEP_PATH);
+	remove(ASSETS_FILE_NAME);
+	remove(LOADED_ASSETS_FILE_NAME);
+
+	return Corium3DTests::reportResults("ModelsCacheTest");
+}
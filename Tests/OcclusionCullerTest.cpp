@@ -0,0 +1,218 @@
+// Tests OcclusionCuller: the AABBs hidden by a wall, in front of it, straddling it, beside it and behind the camera,
+// occluders crossing the near plane, the adjacencies of a cube split into faces, and over random AABBs behind a wall
+// and behind randomly transformed cubes that a hidden AABB is hidden at every point of it (rays from the camera to its
+// corners and to samples inside of it hit the occluder first). The depth pyramid is the same on the thread pool.
+// Standalone - builds on Linux:
+//   g++ -std=c++14 -O2 -D_USE_MATH_DEFINES -I../Corium3D -I../externals/Include OcclusionCullerTest.cpp
+//       ../Corium3D/OcclusionCuller.cpp ../Corium3D/ThreadPool.cpp ../Corium3D/AABB.cpp -lpthread -o occlusionCullerTest
+// usage: occlusionCullerTest [<AABBs nr>]
+
+#include "Tests.h"
+#include "OcclusionCuller.h"
+#include "ThreadPool.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace Corium3D;
+
+namespace {
+
+	const glm::mat4 VP_MAT = glm::perspective(1.0f, 2.0f, 0.5f, 200.0f) * glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	const glm::vec3 QUAD_VERTICES[4] = { {-1.0f, -1.0f, 0.0f}, {1.0f, -1.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {-1.0f, 1.0f, 0.0f} };
+	const unsigned int QUAD_IDXS[6] = { 0, 1, 2, 0, 2, 3 };
+
+	// an AABB's corners first, then random points inside of it
+	glm::vec3 genAABBSample(glm::vec3 const& center, glm::vec3 const& extents, unsigned int sampleIdx, std::mt19937& rng) {
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		if (sampleIdx < 8)
+			return center + extents * glm::vec3(sampleIdx & 1 ? 1.0f : -1.0f, sampleIdx & 2 ? 1.0f : -1.0f, sampleIdx & 4 ? 1.0f : -1.0f);
+		else
+			return center + extents * glm::vec3(unit(rng), unit(rng), unit(rng));
+	}
+
+	// the ray from the camera (at the origin) to point enters the cube [-1, 1]^3, transformed by the inverse of invTransformat, before it reaches point
+	bool isCubeHitBefore(glm::mat4 const& invTransformat, glm::vec3 const& point) {
+		glm::vec3 origin = glm::vec3(invTransformat * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+		glm::vec3 dir = glm::vec3(invTransformat * glm::vec4(point, 1.0f)) - origin;
+		float tEnter = 0.0f;
+		float tExit = 1.0f;
+		for (unsigned int axisIdx = 0; axisIdx < 3; axisIdx++) {
+			if (fabs(dir[axisIdx]) < 1e-9f) {
+				if (origin[axisIdx] < -1.0f || origin[axisIdx] > 1.0f)
+					return false;
+				continue;
+			}
+			float tA = (-1.0f - origin[axisIdx]) / dir[axisIdx];
+			float tB = (1.0f - origin[axisIdx]) / dir[axisIdx];
+			tEnter = std::max(tEnter, std::min(tA, tB));
+			tExit = std::min(tExit, std::max(tA, tB));
+		}
+
+		return tEnter <= tExit && tEnter < 1.0f;
+	}
+
+	void checkHidden(OcclusionCuller const& occlusionCuller, glm::vec3 const& minVertex, glm::vec3 const& maxVertex, bool isHiddenExpected) {
+		CHECK(occlusionCuller.isAABBHidden(AABB3D(minVertex, maxVertex)) == isHiddenExpected);
+	}
+
+	// a 10x10 wall at z = -10, facing the camera
+	void testWall(Corium3DUtils::ThreadPool* threadPool, unsigned int aabbsNr) {
+		std::vector<unsigned int> adjacencies;
+		OcclusionCuller::genTrianglesAdjacencies(QUAD_VERTICES, QUAD_IDXS, 6, adjacencies);
+		CHECK(adjacencies.size() == 6);
+		OcclusionCuller::Occluder wall = { QUAD_VERTICES, 4, QUAD_IDXS, 6, adjacencies.data(),
+			glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -10.0f)) * glm::scale(glm::mat4(1.0f), glm::vec3(5.0f)) };
+		OcclusionCuller occlusionCuller(threadPool);
+		occlusionCuller.rasterizeOccluders(VP_MAT, &wall, 1);
+		CHECK(occlusionCuller.getRasterizedTrianglesNr() == 2);
+		checkHidden(occlusionCuller, glm::vec3(-1.0f, -1.0f, -21.0f), glm::vec3(1.0f, 1.0f, -19.0f), true);
+		checkHidden(occlusionCuller, glm::vec3(-1.0f, -1.0f, -6.0f), glm::vec3(1.0f, 1.0f, -4.0f), false);
+		checkHidden(occlusionCuller, glm::vec3(-1.0f, -1.0f, -11.0f), glm::vec3(1.0f, 1.0f, -9.0f), false);
+		checkHidden(occlusionCuller, glm::vec3(8.0f, -1.0f, -21.0f), glm::vec3(10.0f, 1.0f, -19.0f), false);
+		checkHidden(occlusionCuller, glm::vec3(-30.0f, -1.0f, -30.0f), glm::vec3(30.0f, 1.0f, -29.0f), false);
+		checkHidden(occlusionCuller, glm::vec3(-1.0f, -1.0f, 1.0f), glm::vec3(1.0f, 1.0f, 3.0f), false);
+
+		std::mt19937 rng(5);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		unsigned int hiddenNr = 0;
+		unsigned int wronglyHiddenNr = 0;
+		for (unsigned int aabbIdx = 0; aabbIdx < aabbsNr; aabbIdx++) {
+			glm::vec3 center(15.0f * unit(rng), 10.0f * unit(rng), -12.0f + 10.0f * unit(rng));
+			glm::vec3 extents(2.0f * fabs(unit(rng)) + 0.01f, 2.0f * fabs(unit(rng)) + 0.01f, 2.0f * fabs(unit(rng)) + 0.01f);
+			if (!occlusionCuller.isAABBHidden(AABB3D(center - extents, center + extents)))
+				continue;
+
+			hiddenNr++;
+			for (unsigned int sampleIdx = 0; sampleIdx < 64; sampleIdx++) {
+				glm::vec3 sample = genAABBSample(center, extents, sampleIdx, rng);
+				if (!(sample.z < -10.0f && fabs(sample.x * -10.0f / sample.z) <= 5.0f && fabs(sample.y * -10.0f / sample.z) <= 5.0f)) {
+					wronglyHiddenNr++;
+					break;
+				}
+			}
+		}
+		CHECK(hiddenNr > 0);
+		CHECK(wronglyHiddenNr == 0);
+		printf("wall: %u of %u AABBs hidden, %u wrongly\n", hiddenNr, aabbsNr, wronglyHiddenNr);
+	}
+
+	// a floor passing under and behind the camera, and a wall behind the camera, then a wall crossing the near plane to the side
+	void testNearPlaneCrossings(Corium3DUtils::ThreadPool* threadPool) {
+		glm::vec3 floorVertices[4] = { {-100.0f, -2.0f, 50.0f}, {100.0f, -2.0f, 50.0f}, {100.0f, -2.0f, -100.0f}, {-100.0f, -2.0f, -100.0f} };
+		glm::vec3 backWallVertices[4] = { {-100.0f, -2.0f, 2.0f}, {100.0f, -2.0f, 2.0f}, {100.0f, 10.0f, 2.0f}, {-100.0f, 10.0f, 2.0f} };
+		std::vector<unsigned int> adjacencies;
+		OcclusionCuller::genTrianglesAdjacencies(floorVertices, QUAD_IDXS, 6, adjacencies);
+		OcclusionCuller::Occluder occluders[2] = { { floorVertices, 4, QUAD_IDXS, 6, adjacencies.data(), glm::mat4(1.0f) },
+												   { backWallVertices, 4, QUAD_IDXS, 6, adjacencies.data(), glm::mat4(1.0f) } };
+		OcclusionCuller occlusionCuller(threadPool);
+		occlusionCuller.rasterizeOccluders(VP_MAT, occluders, 2);
+		checkHidden(occlusionCuller, glm::vec3(-1.0f, -5.0f, -21.0f), glm::vec3(1.0f, -3.0f, -19.0f), true);
+		checkHidden(occlusionCuller, glm::vec3(-1.0f, -1.0f, -21.0f), glm::vec3(1.0f, 1.0f, -19.0f), false);
+
+		glm::vec3 sideWallVertices[4] = { {-3.0f, -50.0f, 20.0f}, {-3.0f, -50.0f, -100.0f}, {-3.0f, 50.0f, -100.0f}, {-3.0f, 50.0f, 20.0f} };
+		OcclusionCuller::Occluder sideWall = { sideWallVertices, 4, QUAD_IDXS, 6, adjacencies.data(), glm::mat4(1.0f) };
+		occlusionCuller.rasterizeOccluders(VP_MAT, &sideWall, 1);
+		checkHidden(occlusionCuller, glm::vec3(-10.0f, -1.0f, -21.0f), glm::vec3(-8.0f, 1.0f, -19.0f), true);
+		checkHidden(occlusionCuller, glm::vec3(-2.0f, -1.0f, -21.0f), glm::vec3(0.0f, 1.0f, -19.0f), false);
+	}
+
+	// a cube with its vertices split per face, as the baked meshes' are
+	void genCube(std::vector<glm::vec3>& vertices, std::vector<unsigned int>& idxs) {
+		const unsigned int FACES[6][4] = { {0, 1, 3, 2}, {4, 6, 7, 5}, {0, 4, 5, 1}, {2, 3, 7, 6}, {0, 2, 6, 4}, {1, 5, 7, 3} };
+		for (unsigned int faceIdx = 0; faceIdx < 6; faceIdx++) {
+			unsigned int baseIdx = (unsigned int)vertices.size();
+			for (unsigned int cornerIdx = 0; cornerIdx < 4; cornerIdx++) {
+				unsigned int vertexIdx = FACES[faceIdx][cornerIdx];
+				vertices.push_back(glm::vec3(vertexIdx & 1 ? 1.0f : -1.0f, vertexIdx & 2 ? 1.0f : -1.0f, vertexIdx & 4 ? 1.0f : -1.0f));
+			}
+			for (unsigned int quadIdx = 0; quadIdx < 6; quadIdx++)
+				idxs.push_back(baseIdx + QUAD_IDXS[quadIdx]);
+		}
+	}
+
+	void testCubes(Corium3DUtils::ThreadPool* threadPool, unsigned int aabbsNr) {
+		std::vector<glm::vec3> vertices;
+		std::vector<unsigned int> idxs;
+		genCube(vertices, idxs);
+		std::vector<unsigned int> adjacencies;
+		OcclusionCuller::genTrianglesAdjacencies(vertices.data(), idxs.data(), (unsigned int)idxs.size(), adjacencies);
+		// the faces' vertices are welded - every edge of the closed cube has a neighbour
+		CHECK(std::count(adjacencies.begin(), adjacencies.end(), OcclusionCuller::NO_ADJACENT_TRIANGLE) == 0);
+
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		OcclusionCuller occlusionCuller(threadPool);
+		unsigned int hiddenNr = 0;
+		unsigned int wronglyHiddenNr = 0;
+		const unsigned int CUBES_NR = 50;
+		for (unsigned int cubeIdx = 0; cubeIdx < CUBES_NR; cubeIdx++) {
+			glm::mat4 transformat = glm::translate(glm::mat4(1.0f), glm::vec3(4.0f * unit(rng), 2.0f * unit(rng), -12.0f + 3.0f * unit(rng))) *
+				glm::rotate(glm::mat4(1.0f), 3.0f * unit(rng), glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.01f))) *
+				glm::scale(glm::mat4(1.0f), glm::vec3(2.0f + unit(rng), 2.0f + unit(rng), 2.0f + unit(rng)));
+			glm::mat4 invTransformat = glm::inverse(transformat);
+			OcclusionCuller::Occluder cube = { vertices.data(), (unsigned int)vertices.size(), idxs.data(), (unsigned int)idxs.size(), adjacencies.data(), transformat };
+			occlusionCuller.rasterizeOccluders(VP_MAT, &cube, 1);
+			for (unsigned int aabbIdx = 0; aabbIdx < aabbsNr / CUBES_NR; aabbIdx++) {
+				glm::vec3 center(10.0f * unit(rng), 5.0f * unit(rng), -20.0f + 6.0f * unit(rng));
+				glm::vec3 extents(fabs(unit(rng)) + 0.01f, fabs(unit(rng)) + 0.01f, fabs(unit(rng)) + 0.01f);
+				if (!occlusionCuller.isAABBHidden(AABB3D(center - extents, center + extents)))
+					continue;
+
+				hiddenNr++;
+				for (unsigned int sampleIdx = 0; sampleIdx < 200; sampleIdx++) {
+					if (!isCubeHitBefore(invTransformat, genAABBSample(center, extents, sampleIdx, rng))) {
+						wronglyHiddenNr++;
+						break;
+					}
+				}
+			}
+		}
+		CHECK(hiddenNr > 0);
+		CHECK(wronglyHiddenNr == 0);
+		printf("cubes: %u of %u AABBs hidden, %u wrongly\n", hiddenNr, aabbsNr, wronglyHiddenNr);
+	}
+
+	// the bands rasterized on the thread pool build the same pyramid as on the calling thread
+	void testThreadPoolPyramid(Corium3DUtils::ThreadPool* threadPool) {
+		std::vector<glm::vec3> vertices;
+		std::vector<unsigned int> idxs;
+		genCube(vertices, idxs);
+		std::vector<unsigned int> adjacencies;
+		OcclusionCuller::genTrianglesAdjacencies(vertices.data(), idxs.data(), (unsigned int)idxs.size(), adjacencies);
+		std::vector<OcclusionCuller::Occluder> cubes;
+		for (unsigned int cubeIdx = 0; cubeIdx < 12; cubeIdx++) {
+			glm::mat4 transformat = glm::translate(glm::mat4(1.0f), glm::vec3(-11.0f + 2.0f * cubeIdx, 0.5f * (cubeIdx % 3), -15.0f - cubeIdx)) *
+				glm::rotate(glm::mat4(1.0f), 0.4f * cubeIdx, glm::vec3(0.0f, 1.0f, 0.0f));
+			cubes.push_back({ vertices.data(), (unsigned int)vertices.size(), idxs.data(), (unsigned int)idxs.size(), adjacencies.data(), transformat });
+		}
+
+		OcclusionCuller serialOcclusionCuller(NULL);
+		serialOcclusionCuller.rasterizeOccluders(VP_MAT, cubes.data(), (unsigned int)cubes.size());
+		OcclusionCuller parallelOcclusionCuller(threadPool);
+		parallelOcclusionCuller.rasterizeOccluders(VP_MAT, cubes.data(), (unsigned int)cubes.size());
+		CHECK(serialOcclusionCuller.getRasterizedTrianglesNr() == parallelOcclusionCuller.getRasterizedTrianglesNr());
+		for (unsigned int levelIdx = 0; levelIdx < OcclusionCuller::LEVELS_NR; levelIdx++) {
+			unsigned int levelSz = (OcclusionCuller::DEPTH_BUFFER_WIDTH >> levelIdx) * std::max(OcclusionCuller::DEPTH_BUFFER_HEIGHT >> levelIdx, 1u);
+			CHECK(memcmp(serialOcclusionCuller.getDepthPyramidLevel(levelIdx), parallelOcclusionCuller.getDepthPyramidLevel(levelIdx), levelSz * sizeof(float)) == 0);
+		}
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned int aabbsNr = argc > 1 ? strtoul(argv[1], NULL, 10) : 20000;
+	Corium3DUtils::ThreadPool threadPool(2);
+	testWall(NULL, aabbsNr);
+	testWall(&threadPool, aabbsNr);
+	testNearPlaneCrossings(NULL);
+	testCubes(NULL, aabbsNr);
+	testThreadPoolPyramid(&threadPool);
+
+	return Corium3DTests::reportResults("OcclusionCullerTest");
+}
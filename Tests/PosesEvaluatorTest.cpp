@@ -0,0 +1,293 @@
+// Tests PosesEvaluator against a reference evaluation of each pose on its own - a recursive traversal of the model's
+// transformats hierarchy, the way the renderer evaluated each animated instance before the poses were batched - over
+// random hierarchies and animations (written to a mapped assets file and read back through its views) and random
+// instances' animation times (wrapping around their animations' ends): the located key frames are the same, and
+// interpolated between, and the bones' palettes match, on the calling thread and on the thread pool.
+// Standalone - builds on Linux:
+//   g++ -std=c++14 -O2 -DDEBUG=1 -D_USE_MATH_DEFINES -fpermissive -include cstring -w -I../Corium3D -I../externals/Include
+//       PosesEvaluatorTest.cpp ../Corium3D/PosesEvaluator.cpp ../Corium3D/MappedAssets.cpp ../Corium3D/AssetsOps.cpp
+//       ../Corium3D/LZCodec.cpp ../Corium3D/ThreadPool.cpp -lpthread -o posesEvaluatorTest
+// usage: posesEvaluatorTest [<frames nr>]
+
+#include "Tests.h"
+#include "PosesEvaluator.h"
+#include "MappedAssets.h"
+#include "ThreadPool.h"
+
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtx/transform.hpp>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace Corium3D;
+
+namespace {
+
+	const char* const ASSETS_FILE_NAME = "posesEvaluatorTest.assets";
+	const unsigned int INSTANCES_NR = 300;
+
+	std::mt19937 rng(7);
+
+	float genRandom(float min, float max) {
+		return std::uniform_real_distribution<float>(min, max)(rng);
+	}
+
+	glm::quat genRandomRot() {
+		return glm::normalize(glm::quat(genRandom(-1.0f, 1.0f), genRandom(-1.0f, 1.0f), genRandom(-1.0f, 1.0f), genRandom(-1.0f, 1.0f)));
+	}
+
+	// a random hierarchy, most of its nodes bones, and animations of random channels. a channel's consecutive rotations are
+	// at times the same, close but of opposite signs (the slerp takes the shorter path) or far apart
+	ModelDesc genModelDesc(unsigned int nodesNr, unsigned int animationsNr) {
+		ModelDesc modelDesc = ModelDesc();
+		std::vector<unsigned int> nodesParentsIdxs(nodesNr, UINT_MAX);
+		std::vector<unsigned int> ancestorsStack(1, 0);
+		for (unsigned int nodeIdx = 1; nodeIdx < nodesNr; nodeIdx++) {
+			if (rng() % 3 == 0)
+				ancestorsStack.resize(ancestorsStack.size() - rng() % ancestorsStack.size());
+			nodesParentsIdxs[nodeIdx] = ancestorsStack.back();
+			ancestorsStack.push_back(nodeIdx);
+		}
+
+		modelDesc.transformatsHierarchy.resize(nodesNr);
+		for (unsigned int nodeIdx = 0; nodeIdx < nodesNr; nodeIdx++) {
+			ModelDesc::TransformatsHierarchyNodeDesc& nodeDesc = modelDesc.transformatsHierarchy[nodeIdx];
+			nodeDesc.childrenNr = std::count(nodesParentsIdxs.begin(), nodesParentsIdxs.end(), nodeIdx);
+			nodeDesc.transformat = glm::translate(glm::vec3(genRandom(-1.0f, 1.0f), genRandom(-1.0f, 1.0f), genRandom(-1.0f, 1.0f))) * glm::mat4_cast(genRandomRot());
+			nodeDesc.boneIdx = rng() % 4 ? modelDesc.bonesNr++ : UINT_MAX;
+			nodeDesc.meshesIdxsBaseIdx = 0;
+			nodeDesc.meshesNr = 0;
+		}
+		for (unsigned int boneIdx = 0; boneIdx < modelDesc.bonesNr; boneIdx++)
+			modelDesc.bonesOffsets.push_back(glm::translate(glm::vec3(genRandom(-1.0f, 1.0f), genRandom(-1.0f, 1.0f), genRandom(-1.0f, 1.0f))) * glm::scale(glm::vec3(genRandom(0.5f, 2.0f))));
+
+		for (unsigned int animationIdx = 0; animationIdx < animationsNr; animationIdx++) {
+			ModelDesc::AnimationDesc animationDesc = ModelDesc::AnimationDesc();
+			ModelDesc::AnimationKeys animationKeys;
+			animationDesc.transformatsHierarchyNodesNr = nodesNr;
+			animationDesc.keyFramesNr = 4 + rng() % 20;
+			animationDesc.ticksPerSecond = 24 + animationIdx;
+			for (unsigned int nodeIdx = 0; nodeIdx < nodesNr; nodeIdx++) {
+				if (rng() % 3)
+					animationKeys.channelsNodesIdxs.push_back(nodeIdx);
+			}
+			animationDesc.channelsNr = animationKeys.channelsNodesIdxs.size();
+			double keyFrameTime = 0.0;
+			for (unsigned int keyFrameIdx = 0; keyFrameIdx < animationDesc.keyFramesNr; keyFrameIdx++) {
+				animationKeys.keyFramesTimes.push_back(keyFrameTime);
+				keyFrameTime += genRandom(0.5f, 3.0f);
+			}
+			animationDesc.dur = animationKeys.keyFramesTimes.back() / animationDesc.ticksPerSecond;
+			for (unsigned int channelIdx = 0; channelIdx < animationDesc.channelsNr; channelIdx++) {
+				glm::quat rot = genRandomRot();
+				for (unsigned int keyFrameIdx = 0; keyFrameIdx < animationDesc.keyFramesNr; keyFrameIdx++) {
+					animationKeys.scales.push_back(glm::vec3(genRandom(0.5f, 2.0f), genRandom(0.5f, 2.0f), genRandom(0.5f, 2.0f)));
+					animationKeys.translations.push_back(glm::vec3(genRandom(-2.0f, 2.0f), genRandom(-2.0f, 2.0f), genRandom(-2.0f, 2.0f)));
+					switch (rng() % 4) {
+					case 0:
+						break;
+					case 1:
+						rot = -glm::normalize(rot * glm::angleAxis(genRandom(-0.5f, 0.5f), glm::normalize(glm::vec3(genRandom(-1.0f, 1.0f), genRandom(-1.0f, 1.0f), genRandom(-1.0f, 1.0f)))));
+						break;
+					default:
+						rot = genRandomRot();
+					}
+					animationKeys.rots.push_back(rot);
+				}
+			}
+			modelDesc.animationsDescs.push_back(animationDesc);
+			modelDesc.animationsKeys.push_back(animationKeys);
+		}
+
+		// a single triangle mesh - the mapped assets hold only the baked models' data
+		modelDesc.colladaPath = "posesEvaluatorTest.dae";
+		modelDesc.verticesNr = 3;
+		modelDesc.meshesNr = 1;
+		modelDesc.verticesNrsPerMesh = { 3 };
+		modelDesc.extraColorsNrsPerMesh = { 0 };
+		modelDesc.extraColors.resize(1);
+		modelDesc.texesNrsPerMesh = { 0 };
+		modelDesc.facesNr = 1;
+		modelDesc.facesNrsPerMesh = { 1 };
+		modelDesc.bonesNrsPerMesh = { modelDesc.bonesNr };
+		modelDesc.vertices.resize(3, ModelDesc::VertexData());
+		modelDesc.idxs = { 0, 1, 2 };
+		modelDesc.submeshesDescs = { { 0, 3, 0, 3 } };
+		modelDesc.meshesTransforms = { glm::mat4(1.0f) };
+
+		return modelDesc;
+	}
+
+	struct RefPoseEval {
+		ModelDescView const& modelDesc;
+		ModelDescView::AnimationKeysView animationKeys;
+		unsigned int keyFramesNr;
+		unsigned int endKeyFrameIdx;
+		float interpolationFactor;
+		// per node
+		std::vector<std::vector<unsigned int>> nodesChildrenIdxs;
+		std::vector<unsigned int> nodesChannelsIdxs;
+		glm::mat4* outBonesTransformats;
+
+		void evalNode(unsigned int nodeIdx, glm::mat4 const& parentTransformat) {
+			glm::mat4 transformat;
+			unsigned int channelIdx = nodesChannelsIdxs[nodeIdx];
+			if (channelIdx != UINT_MAX) {
+				unsigned int startKeyIdx = channelIdx * keyFramesNr + endKeyFrameIdx - 1;
+				glm::vec3 scale = animationKeys.scales[startKeyIdx] * (1 - interpolationFactor) + animationKeys.scales[startKeyIdx + 1] * interpolationFactor;
+				glm::quat rot = glm::slerp(animationKeys.rots[startKeyIdx], animationKeys.rots[startKeyIdx + 1], interpolationFactor);
+				glm::vec3 translation = animationKeys.translations[startKeyIdx] * (1 - interpolationFactor) + animationKeys.translations[startKeyIdx + 1] * interpolationFactor;
+				transformat = parentTransformat * glm::translate(translation) * glm::mat4_cast(rot) * glm::scale(scale);
+			}
+			else
+				transformat = parentTransformat * modelDesc.transformatsHierarchy[nodeIdx].transformat;
+
+			unsigned int boneIdx = modelDesc.transformatsHierarchy[nodeIdx].boneIdx;
+			if (boneIdx != UINT_MAX)
+				outBonesTransformats[boneIdx] = transformat * modelDesc.bonesOffsets[boneIdx];
+			for (unsigned int childIdx : nodesChildrenIdxs[nodeIdx])
+				evalNode(childIdx, transformat);
+		}
+	};
+
+	void evalPoseRef(ModelDescView const& modelDesc, unsigned int animationIdx, unsigned int endKeyFrameIdx, float interpolationFactor, glm::mat4* outBonesTransformats) {
+		unsigned int nodesNr = modelDesc.transformatsHierarchy.size();
+		RefPoseEval eval = { modelDesc, modelDesc.animationsKeys[animationIdx], modelDesc.animationsDescs[animationIdx].keyFramesNr, endKeyFrameIdx, interpolationFactor,
+							 std::vector<std::vector<unsigned int>>(nodesNr), std::vector<unsigned int>(nodesNr, UINT_MAX), outBonesTransformats };
+		for (unsigned int channelIdx = 0; channelIdx < eval.animationKeys.channelsNodesIdxs.size(); channelIdx++)
+			eval.nodesChannelsIdxs[eval.animationKeys.channelsNodesIdxs[channelIdx]] = channelIdx;
+		std::vector<unsigned int> ancestorsStack;
+		std::vector<unsigned int> childrenLeftNrsStack;
+		for (unsigned int nodeIdx = 0; nodeIdx < nodesNr; nodeIdx++) {
+			if (nodeIdx > 0) {
+				while (childrenLeftNrsStack.back() == 0) {
+					ancestorsStack.pop_back();
+					childrenLeftNrsStack.pop_back();
+				}
+				eval.nodesChildrenIdxs[ancestorsStack.back()].push_back(nodeIdx);
+				childrenLeftNrsStack.back()--;
+			}
+			ancestorsStack.push_back(nodeIdx);
+			childrenLeftNrsStack.push_back(modelDesc.transformatsHierarchy[nodeIdx].childrenNr);
+		}
+		eval.evalNode(0, glm::mat4(1.0f));
+	}
+
+	// the first key frame past the first one at animationTime or after it
+	unsigned int locateKeyFramesRef(ArrView<double> const& keyFramesTimes, double animationTime) {
+		unsigned int endKeyFrameIdx = 1;
+		while (endKeyFrameIdx < keyFramesTimes.size() - 1 && keyFramesTimes[endKeyFrameIdx] < animationTime)
+			endKeyFrameIdx++;
+
+		return endKeyFrameIdx;
+	}
+
+	// relative to the reference's largest element
+	float calcMatsDiff(glm::mat4 const& mat, glm::mat4 const& refMat) {
+		float diffMax = 0.0f;
+		float refMax = 1.0f;
+		for (unsigned int colIdx = 0; colIdx < 4; colIdx++) {
+			for (unsigned int rowIdx = 0; rowIdx < 4; rowIdx++) {
+				diffMax = std::max(diffMax, std::fabs(mat[colIdx][rowIdx] - refMat[colIdx][rowIdx]));
+				refMax = std::max(refMax, std::fabs(refMat[colIdx][rowIdx]));
+			}
+		}
+
+		return diffMax / refMax;
+	}
+
+	struct Instance {
+		unsigned int modelIdx;
+		unsigned int animationIdx;
+		double animationStartTime;
+		// the instance's last located one
+		unsigned int endKeyFrameIdx;
+	};
+
+	void testAgainstRef(MappedAssets const& mappedAssets, Corium3DUtils::ThreadPool* threadPool, unsigned int framesNr) {
+		std::vector<ModelDescView> modelDescs;
+		std::vector<ModelAnimations*> modelsAnimations;
+		for (unsigned int modelIdx = 0; modelIdx < mappedAssets.getModelsNr(); modelIdx++) {
+			modelDescs.push_back(mappedAssets.getModelDesc(modelIdx));
+			modelsAnimations.push_back(new ModelAnimations(modelDescs.back()));
+			CHECK(modelsAnimations.back()->getBonesNr() == modelDescs.back().bonesNr);
+			CHECK(modelsAnimations.back()->getAnimationsNr() == modelDescs.back().animationsDescs.size());
+		}
+
+		std::vector<Instance> instances;
+		size_t palettesBonesNr = 0;
+		for (unsigned int instanceIdx = 0; instanceIdx < INSTANCES_NR; instanceIdx++) {
+			unsigned int modelIdx = instanceIdx % modelDescs.size();
+			instances.push_back({ modelIdx, (unsigned int)(rng() % modelsAnimations[modelIdx]->getAnimationsNr()), genRandom(0.0f, 5.0f), 1 });
+			palettesBonesNr += modelDescs[modelIdx].bonesNr;
+		}
+
+		PosesEvaluator posesEvaluator(threadPool);
+		std::vector<glm::mat4> palettes(palettesBonesNr);
+		std::vector<glm::mat4> refPalettes(palettesBonesNr);
+		std::vector<PosesEvaluator::Pose> poses;
+		unsigned int keyFramesMismatchesNr = 0;
+		unsigned int palettesMismatchesNr = 0;
+		float diffMax = 0.0f;
+		for (unsigned int frameIdx = 0; frameIdx < framesNr; frameIdx++) {
+			double currTime = 5.0 + 0.037 * frameIdx;
+			poses.clear();
+			size_t paletteBaseIdx = 0;
+			for (Instance& instance : instances) {
+				ModelAnimations const& modelAnimations = *modelsAnimations[instance.modelIdx];
+				double animationTime = fmod(currTime - instance.animationStartTime, modelAnimations.getAnimationDur(instance.animationIdx)) *
+									   modelAnimations.getAnimationTicksPerSecond(instance.animationIdx);
+				float interpolationFactor = modelAnimations.locateKeyFrames(instance.animationIdx, animationTime, instance.endKeyFrameIdx);
+				if (interpolationFactor < 0.0f || interpolationFactor > 1.0f ||
+					instance.endKeyFrameIdx != locateKeyFramesRef(modelDescs[instance.modelIdx].animationsKeys[instance.animationIdx].keyFramesTimes, animationTime))
+					keyFramesMismatchesNr++;
+
+				PosesEvaluator::Pose pose;
+				pose.modelAnimations = &modelAnimations;
+				pose.query = { instance.animationIdx, instance.endKeyFrameIdx, interpolationFactor, &palettes[paletteBaseIdx] };
+				poses.push_back(pose);
+				evalPoseRef(modelDescs[instance.modelIdx], instance.animationIdx, instance.endKeyFrameIdx, interpolationFactor, &refPalettes[paletteBaseIdx]);
+				paletteBaseIdx += modelDescs[instance.modelIdx].bonesNr;
+			}
+
+			posesEvaluator.evalPoses(poses.data(), poses.size());
+			for (size_t boneTransformatIdx = 0; boneTransformatIdx < palettesBonesNr; boneTransformatIdx++) {
+				float diff = calcMatsDiff(palettes[boneTransformatIdx], refPalettes[boneTransformatIdx]);
+				diffMax = std::max(diffMax, diff);
+				if (!(diff < 1e-3f))
+					palettesMismatchesNr++;
+			}
+		}
+		CHECK(keyFramesMismatchesNr == 0);
+		CHECK(palettesMismatchesNr == 0);
+		printf("%u frames x %u instances on %s: %u key frames mismatches, %u palettes mismatches (maximal difference %g)\n", framesNr, INSTANCES_NR,
+			   threadPool ? "the thread pool" : "the calling thread", keyFramesMismatchesNr, palettesMismatchesNr, diffMax);
+
+		for (ModelAnimations* modelAnimations : modelsAnimations)
+			delete modelAnimations;
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned int framesNr = argc > 1 ? strtoul(argv[1], NULL, 10) : 40;
+	std::vector<ModelDesc> modelDescs = { genModelDesc(37, 3), genModelDesc(64, 2), genModelDesc(9, 1) };
+	std::vector<ModelDesc const*> modelDescsPtrs;
+	for (ModelDesc const& modelDesc : modelDescs)
+		modelDescsPtrs.push_back(&modelDesc);
+	writeMappedAssetsFile(ASSETS_FILE_NAME, modelDescsPtrs, std::vector<SceneData const*>());
+	{
+		MappedAssets mappedAssets(ASSETS_FILE_NAME);
+		Corium3DUtils::ThreadPool threadPool(3);
+		testAgainstRef(mappedAssets, NULL, framesNr);
+		testAgainstRef(mappedAssets, &threadPool, framesNr);
+	}
+	remove(ASSETS_FILE_NAME);
+
+	return Corium3DTests::reportResults("PosesEvaluatorTest");
+}
@@ -0,0 +1,80 @@
+// Tests radixSort against std::sort, over random keys of a few distributions - full 64 bits keys, keys packing narrow
+// fields, keys of a single varying nibble and keys sharing all but 2 bytes (the passes over the shared bytes are skipped) -
+// and over no keys, a single key and presorted and reversed keys.
+// Standalone - builds on Linux:
+//   g++ -std=c++14 -O2 -I../Corium3D RadixSortTest.cpp ../Corium3D/RadixSort.cpp -o radixSortTest
+// usage: radixSortTest [<key sets nr>]
+
+#include "Tests.h"
+#include "RadixSort.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+	bool isSortedAsStdSort(std::vector<uint64_t> keys, std::vector<uint64_t>& scratch) {
+		std::vector<uint64_t> sortedKeys = keys;
+		std::sort(sortedKeys.begin(), sortedKeys.end());
+		Corium3DUtils::radixSort(keys, scratch);
+		return keys == sortedKeys;
+	}
+
+	void testEdgeCases() {
+		std::vector<uint64_t> scratch;
+		CHECK(isSortedAsStdSort(std::vector<uint64_t>(), scratch));
+		CHECK(isSortedAsStdSort(std::vector<uint64_t>(1, 0x0123456789ABCDEFull), scratch));
+		CHECK(isSortedAsStdSort(std::vector<uint64_t>(100, 42), scratch));
+
+		std::vector<uint64_t> keys;
+		for (uint64_t keyIdx = 0; keyIdx < 1000; keyIdx++)
+			keys.push_back(keyIdx * 0x0001000100010001ull);
+		CHECK(isSortedAsStdSort(keys, scratch));
+		std::reverse(keys.begin(), keys.end());
+		CHECK(isSortedAsStdSort(keys, scratch));
+		keys = { ~0ull, 0, 1ull << 63, (1ull << 63) - 1 };
+		CHECK(isSortedAsStdSort(keys, scratch));
+		CHECK(scratch.size() == keys.size());
+	}
+
+	void testRandomKeys(unsigned int keySetsNr) {
+		std::mt19937_64 rng(1);
+		std::vector<uint64_t> keys;
+		std::vector<uint64_t> scratch;
+		unsigned int mismatchesNr = 0;
+		for (unsigned int keySetIdx = 0; keySetIdx < keySetsNr; keySetIdx++) {
+			keys.resize(rng() % 3000);
+			for (uint64_t& key : keys) {
+				uint64_t randomBits = rng();
+				switch (keySetIdx % 4) {
+				case 0:
+					key = randomBits;
+					break;
+				case 1:
+					key = randomBits & 0xFF00000000FFull;
+					break;
+				case 2:
+					key = randomBits & 0xF;
+					break;
+				default:
+					key = 0x1234567800000000ull | (randomBits & 0xFFFF0000ull);
+				}
+			}
+			if (!isSortedAsStdSort(keys, scratch))
+				mismatchesNr++;
+		}
+		CHECK(mismatchesNr == 0);
+		printf("%u random key sets: %u mismatches\n", keySetsNr, mismatchesNr);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned int keySetsNr = argc > 1 ? strtoul(argv[1], NULL, 10) : 400;
+	testEdgeCases();
+	testRandomKeys(keySetsNr);
+
+	return Corium3DTests::reportResults("RadixSortTest");
+}
@@ -0,0 +1,143 @@
+// Stress tests RingBufferSPSC: a producer thread pounds it with sequenced, timestamped events while the consumer drains
+// it in ticks, as processInput does. Checks the per-tick order, that nothing is lost or duplicated, and the overflow
+// statistics, with a retrying producer and with a dropping one.
+// Standalone - builds on Linux:
+//   g++ -std=c++14 -O2 -I../Corium3D RingBufferSPSCTest.cpp -lpthread -o ringBufferSPSCTest
+// usage: ringBufferSPSCTest [<events nr>]
+
+#include "Tests.h"
+#include "RingBufferSPSC.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+
+using namespace Corium3DUtils;
+
+namespace {
+
+	// its holders are allocated with plain (C++14) new
+	static_assert(alignof(RingBufferSPSC<unsigned long long>) <= alignof(std::max_align_t), "RingBufferSPSC is over-aligned");
+
+	struct TestEvent {
+		unsigned long long seqIdx;
+		double timeStamp;
+	};
+
+	const unsigned int QUEUE_CAPACITY = 256;
+
+	double getTime() {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void testSingleThreaded() {
+		RingBufferSPSC<TestEvent> queue(100);
+		CHECK(queue.getCapacity() == 128);
+
+		TestEvent event;
+		CHECK(!queue.pop(event));
+		for (unsigned int eventIdx = 0; eventIdx < queue.getCapacity(); eventIdx++)
+			CHECK(queue.push({ eventIdx, 0.0 }));
+		CHECK(!queue.push({ queue.getCapacity(), 0.0 }));
+		CHECK(queue.getAvailableNr() == queue.getCapacity());
+
+		RingBufferSPSC<TestEvent>::Stats stats = queue.getStats();
+		CHECK(stats.pushedNr == queue.getCapacity());
+		CHECK(stats.droppedNr == 1);
+		CHECK(stats.occupancyMax == queue.getCapacity());
+
+		for (unsigned int eventIdx = 0; eventIdx < queue.getCapacity(); eventIdx++)
+			CHECK(queue.pop(event) && event.seqIdx == eventIdx);
+		CHECK(!queue.pop(event));
+
+		queue.resetStats();
+		stats = queue.getStats();
+		CHECK(stats.pushedNr == 0 && stats.droppedNr == 0 && stats.occupancyMax == 0);
+
+		bool isThrown = false;
+		try {
+			RingBufferSPSC<TestEvent> emptyQueue(0);
+		}
+		catch (std::invalid_argument const&) {
+			isThrown = true;
+		}
+		CHECK(isThrown);
+	}
+
+	// isProducerRetrying - a full queue's push is retried until it goes through. else the event is dropped
+	void testStress(unsigned long long eventsNr, bool isProducerRetrying) {
+		RingBufferSPSC<TestEvent> queue(QUEUE_CAPACITY);
+		unsigned long long failedPushesNr = 0;
+		std::thread producer([&]() {
+			for (unsigned long long seqIdx = 0; seqIdx < eventsNr; seqIdx++) {
+				while (!queue.push({ seqIdx, getTime() })) {
+					failedPushesNr++;
+					if (!isProducerRetrying)
+						break;
+					std::this_thread::yield();
+				}
+			}
+		});
+
+		// a tick drains the events available at its start only
+		unsigned long long poppedNr = 0;
+		unsigned long long nextSeqIdxMin = 0;
+		double lastTimeStamp = 0.0;
+		bool isOrdered = true;
+		unsigned long long ticksNr = 0;
+		TestEvent event;
+		while (nextSeqIdxMin < eventsNr) {
+			unsigned int availableNr = queue.getAvailableNr();
+			if (availableNr == 0) {
+				std::this_thread::yield();
+				// the dropping producer may be done with the last events dropped
+				if (!isProducerRetrying && queue.getStats().pushedNr + queue.getStats().droppedNr == eventsNr && queue.getAvailableNr() == 0)
+					break;
+				continue;
+			}
+
+			ticksNr++;
+			for (unsigned int eventIdx = 0; eventIdx < availableNr; eventIdx++) {
+				if (!queue.pop(event)) {
+					isOrdered = false;
+					break;
+				}
+				if (event.seqIdx < nextSeqIdxMin || (isProducerRetrying && event.seqIdx != nextSeqIdxMin) || event.timeStamp < lastTimeStamp)
+					isOrdered = false;
+				nextSeqIdxMin = event.seqIdx + 1;
+				lastTimeStamp = event.timeStamp;
+				poppedNr++;
+			}
+		}
+		producer.join();
+		while (queue.pop(event))
+			poppedNr++;
+
+		RingBufferSPSC<TestEvent>::Stats stats = queue.getStats();
+		CHECK(isOrdered);
+		CHECK(stats.droppedNr == failedPushesNr);
+		CHECK(stats.occupancyMax <= queue.getCapacity());
+		if (isProducerRetrying) {
+			CHECK(poppedNr == eventsNr);
+			CHECK(stats.pushedNr == eventsNr);
+		}
+		else {
+			CHECK(poppedNr == stats.pushedNr);
+			CHECK(stats.pushedNr + stats.droppedNr == eventsNr);
+		}
+		printf("%s producer: %llu events in %llu ticks, %llu dropped, occupancy max %u/%u\n", isProducerRetrying ? "retrying" : "dropping",
+			   eventsNr, ticksNr, stats.droppedNr, stats.occupancyMax, queue.getCapacity());
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned long long eventsNr = argc > 1 ? strtoull(argv[1], NULL, 10) : 2000000;
+	testSingleThreaded();
+	testStress(eventsNr, true);
+	testStress(eventsNr, false);
+
+	return Corium3DTests::reportResults("RingBufferSPSCTest");
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal checks for the headless tests: a failed check prints its expression and location and fails the run, the
+// following checks still run.
+namespace Corium3DTests {
+
+	inline unsigned int& getFailedChecksNr() {
+		static unsigned int failedChecksNr = 0;
+		return failedChecksNr;
+	}
+
+	inline bool check(bool cond, char const* condStr, char const* file, int line) {
+		if (!cond) {
+			printf("%s:%d: check failed: %s\n", file, line, condStr);
+			getFailedChecksNr()++;
+		}
+		return cond;
+	}
+
+	// the test's exit code
+	inline int reportResults(char const* testName) {
+		if (getFailedChecksNr())
+			printf("%s: FAILED (%u checks)\n", testName, getFailedChecksNr());
+		else
+			printf("%s: passed\n", testName);
+		return getFailedChecksNr() ? 1 : 0;
+	}
+
+} // namespace Corium3DTests
+
+#define CHECK(cond) Corium3DTests::check((cond), #cond, __FILE__, __LINE__)
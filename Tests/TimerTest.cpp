@@ -0,0 +1,128 @@
+// Tests Timer's fake clock - advancing it, sleepUntil moving it forward to later deadlines only, also from concurrent
+// sleepers, and disabling it back to the system's clock - and UpdatesPacer over it: the updates due per frame and the lag
+// left over for fast, slow and paced frames, and a paced loop running a single update per frame on the updates' grid.
+// Standalone - builds on Linux:
+//   g++ -std=c++14 -O2 -I../Corium3D TimerTest.cpp ../Corium3D/Timer.cpp -lpthread -o timerTest
+// usage: timerTest [<frames nr>]
+
+#include "Tests.h"
+#include "Timer.h"
+
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace Corium3DUtils;
+
+namespace {
+
+	const long long NS_PER_UPDATE = 16666667LL;
+
+	void testFakeClock() {
+		Timer timer;
+		CHECK(!timer.isFakeClockEnabled());
+		timer.enableFakeClock(1000);
+		CHECK(timer.isFakeClockEnabled());
+		CHECK(timer.getCurrentTimeNs() == 1000);
+		timer.advanceFakeClock(Timer::NS_PER_SEC);
+		CHECK(timer.getCurrentTimeNs() == 1000 + Timer::NS_PER_SEC);
+		timer.enableFakeClock(2 * Timer::NS_PER_SEC);
+		CHECK(timer.getCurrentTime() == 2.0);
+
+		timer.sleepUntil(3 * Timer::NS_PER_SEC);
+		CHECK(timer.getCurrentTimeNs() == 3 * Timer::NS_PER_SEC);
+		// a passed deadline does not turn the clock back
+		timer.sleepUntil(Timer::NS_PER_SEC);
+		CHECK(timer.getCurrentTimeNs() == 3 * Timer::NS_PER_SEC);
+
+		// the clock ends at the latest of concurrent sleepers' deadlines
+		std::vector<std::thread> sleepers;
+		for (unsigned int sleeperIdx = 0; sleeperIdx < 4; sleeperIdx++) {
+			sleepers.emplace_back([&timer, sleeperIdx]() {
+				for (long long deadlineIdx = 0; deadlineIdx < 1000; deadlineIdx++)
+					timer.sleepUntil(3 * Timer::NS_PER_SEC + deadlineIdx * 4 + sleeperIdx);
+			});
+		}
+		for (std::thread& sleeper : sleepers)
+			sleeper.join();
+		CHECK(timer.getCurrentTimeNs() == 3 * Timer::NS_PER_SEC + 999 * 4 + 3);
+
+		timer.disableFakeClock();
+		CHECK(!timer.isFakeClockEnabled());
+		long long startNs = timer.getCurrentTimeNs();
+		long long deadlineNs = startNs + Timer::NS_PER_SEC / 500;
+		timer.sleepUntil(deadlineNs);
+		CHECK(timer.getCurrentTimeNs() >= deadlineNs);
+	}
+
+	void testUpdatesPacer() {
+		Timer timer;
+		timer.enableFakeClock(5 * Timer::NS_PER_SEC);
+		UpdatesPacer updatesPacer(timer, NS_PER_UPDATE);
+		CHECK(updatesPacer.beginFrame() == 0);
+		CHECK(updatesPacer.getLagNs() == 0);
+
+		timer.advanceFakeClock(NS_PER_UPDATE / 2);
+		CHECK(updatesPacer.beginFrame() == 0);
+		CHECK(updatesPacer.getLagNs() == NS_PER_UPDATE / 2);
+		CHECK(updatesPacer.getNextUpdateTimeNs() == 5 * Timer::NS_PER_SEC + NS_PER_UPDATE);
+
+		// a slow frame catches up on its updates
+		timer.advanceFakeClock(3 * NS_PER_UPDATE);
+		CHECK(updatesPacer.beginFrame() == 3);
+		CHECK(updatesPacer.getLagNs() == NS_PER_UPDATE / 2);
+
+		// the next frame sleeps exactly to its update
+		updatesPacer.sleepUntilNextUpdate();
+		CHECK(updatesPacer.beginFrame() == 1);
+		CHECK(updatesPacer.getLagNs() == 0);
+		CHECK(timer.getCurrentTimeNs() == 5 * Timer::NS_PER_SEC + 4 * NS_PER_UPDATE);
+	}
+
+	// mirrors Corium3DEngineImpl::loop with random frames' work times - mostly within an update, some a few updates long
+	void testPacedLoop(unsigned int framesNr) {
+		std::mt19937 rng(7);
+		Timer timer;
+		timer.enableFakeClock(0);
+		UpdatesPacer updatesPacer(timer, NS_PER_UPDATE);
+		unsigned long long updatesNrTotal = 0;
+		unsigned int errsNr = 0;
+		unsigned int slowFramesNr = 0;
+		bool isPreviousFrameSlow = true;
+		for (unsigned int frameIdx = 0; frameIdx < framesNr; frameIdx++) {
+			long long frameStartNs = timer.getCurrentTimeNs();
+			unsigned int updatesNr = updatesPacer.beginFrame();
+			updatesNrTotal += updatesNr;
+			// a paced frame after a fast one runs a single update, right on the updates' grid
+			if (!isPreviousFrameSlow && (updatesNr != 1 || updatesPacer.getLagNs() != 0 || frameStartNs % NS_PER_UPDATE != 0))
+				errsNr++;
+			if (updatesPacer.getLagNs() < 0 || updatesPacer.getLagNs() >= NS_PER_UPDATE)
+				errsNr++;
+
+			long long workNs = rng() % 10 == 0 ? NS_PER_UPDATE + rng() % (3 * NS_PER_UPDATE) : rng() % NS_PER_UPDATE;
+			timer.advanceFakeClock(workNs);
+			isPreviousFrameSlow = timer.getCurrentTimeNs() >= updatesPacer.getNextUpdateTimeNs();
+			if (isPreviousFrameSlow)
+				slowFramesNr++;
+			updatesPacer.sleepUntilNextUpdate();
+		}
+		// every elapsed update ran, or is due in the next frame
+		long long elapsedUpdatesNr = timer.getCurrentTimeNs() / NS_PER_UPDATE;
+		if ((long long)updatesNrTotal > elapsedUpdatesNr || (long long)updatesNrTotal < elapsedUpdatesNr - 4)
+			errsNr++;
+		CHECK(errsNr == 0);
+		CHECK(slowFramesNr > 0);
+		printf("%u paced frames: %llu updates, %u slow frames, %u errors\n", framesNr, updatesNrTotal, slowFramesNr, errsNr);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned int framesNr = argc > 1 ? strtoul(argv[1], NULL, 10) : 5000;
+	testFakeClock();
+	testUpdatesPacer();
+	testPacedLoop(framesNr);
+
+	return Corium3DTests::reportResults("TimerTest");
+}
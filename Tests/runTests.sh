@@ -0,0 +1,46 @@
+#!/bin/sh
+# Builds and runs the headless tests (Linux, g++). Exits with the number of failed tests.
+# usage: runTests.sh [<build folder>]
+
+cd "$(dirname "$0")"
+BUILD_DIR=${1:-_build}
+mkdir -p "$BUILD_DIR"
+CXX_FLAGS="-std=c++14 -O2 -Wno-psabi -DDEBUG=1 -D_USE_MATH_DEFINES -I../Corium3D -I../externals/Include"
+# for the tests of the engine's sources, which lean on MSVC's leniencies (and on C++17's inline static constexpr members)
+ENGINE_FLAGS="-std=c++17 -fpermissive -include cstring"
+E=../Corium3D
+CULLING_SOURCES="$E/DrawListBuilder.cpp $E/FrustumCuller.cpp $E/OcclusionCuller.cpp $E/RadixSort.cpp $E/ThreadPool.cpp $E/BVH.cpp
+	$E/PhysicsEngine.cpp $E/CollisionPrimitives.cpp $E/AABB.cpp $E/BoundingSphere.cpp $E/MemoryReport.cpp $E/IdxPool.cpp"
+FAILED_NR=0
+
+runTest() {
+	TEST_NAME=$1
+	shift
+	echo "== $TEST_NAME"
+	if g++ $CXX_FLAGS "$TEST_NAME.cpp" "$@" -lpthread -o "$BUILD_DIR/$TEST_NAME"; then
+		"$BUILD_DIR/$TEST_NAME" || FAILED_NR=$((FAILED_NR + 1))
+	else
+		FAILED_NR=$((FAILED_NR + 1))
+	fi
+}
+
+runTest RingBufferSPSCTest
+runTest FrustumCullerTest $E/FrustumCuller.cpp $E/BoundingSphere.cpp
+runTest DrawListBuilderTest $ENGINE_FLAGS $CULLING_SOURCES
+runTest DirtyRangesTest $E/DirtyRanges.cpp
+runTest FrameRingTest $E/FrameRing.cpp
+runTest IndirectCommandsGeneratorTest $E/IndirectCommandsGenerator.cpp
+runTest OcclusionCullerTest $E/OcclusionCuller.cpp $E/ThreadPool.cpp $E/AABB.cpp
+runTest RadixSortTest $E/RadixSort.cpp
+runTest TimerTest $E/Timer.cpp
+runTest ChunkedPoolsTest $E/IdxPool.cpp
+runTest InstancesRangesTest $E/InstancesRanges.cpp $E/IdxPool.cpp
+runTest GameLmntsStorageTest $ENGINE_FLAGS $E/GameLmntsStorage.cpp $E/PhysicsEngine.cpp $E/IdxPool.cpp $E/MemoryReport.cpp
+runTest PosesEvaluatorTest $ENGINE_FLAGS $E/PosesEvaluator.cpp $E/MappedAssets.cpp $E/AssetsOps.cpp $E/LZCodec.cpp $E/ThreadPool.cpp
+runTest MappedAssetsTest $ENGINE_FLAGS $E/MappedAssets.cpp $E/AssetsOps.cpp $E/LZCodec.cpp
+runTest LZCodecTest $ENGINE_FLAGS $E/LZCodec.cpp $E/MappedAssets.cpp $E/AssetsOps.cpp
+runTest ModelsCacheTest $ENGINE_FLAGS ../Corium3DAssetsGen/ModelsCache.cpp $E/MappedAssets.cpp $E/AssetsOps.cpp $E/LZCodec.cpp
+runTest ModelBakerTest ../Corium3DAssetsGen/ModelBaker.cpp
+
+echo "$FAILED_NR failed"
+exit $FAILED_NR
@@ -1,6 +1,7 @@
 #version 430 core
 
 in uint aInstanceDataIdx;
+in uint aBonesTransformsBaseIdx;
 in vec4 aPos; 	
 in ivec4 aBonesIDs; 
 in vec4 aBonesWeights; 
@@ -12,12 +13,11 @@ uniform mat4 uMeshTransform;
 layout (std430, binding = 4) buffer MvpsBuffer { 
 	mat4 uMVPs[]; 
 };  
-layout (std430, binding = 5) buffer BonesTransformsBaseIdxsBuffer { 
-	uint uBonesTransformsBaseIdxs[]; 
-}; 
-layout (std430, binding = 6) buffer BonesTransformsBuffer { 
-	mat4 uBonesTransforms[]; 
+// the frame's region of the frame ring - the mobile instances' transformats and the bones palettes
+layout (std430, binding = 6) buffer FrameMatsBuffer { 
+	mat4 uFrameMats[]; 
 }; 	
+const uint FRAME_TRANSFORMAT_FLAG = 0x80000000u;
 layout (std430, binding = 7) buffer SelectedColorsIdxsBuffer { 
 	uint uSelectedColorsIdxs[]; 
 }; 
@@ -32,12 +32,12 @@ void main(void) {
    //passColor = vec4(aBonesWeights[0], aBonesWeights[1], aBonesWeights[2], 1.0f);  
 	mat4 boneTransform = mat4(1.0f); 
 	if (aBonesWeights[0] != 0 || aBonesWeights[1] != 0 || aBonesWeights[2] != 0 || aBonesWeights[3] != 0) { 
-		uint bonesTransformsBaseIdx = uBonesTransformsBaseIdxs[aInstanceDataIdx]; 
-		boneTransform = uBonesTransforms[bonesTransformsBaseIdx + aBonesIDs[0]]*aBonesWeights[0] + 
-						uBonesTransforms[bonesTransformsBaseIdx + aBonesIDs[1]]*aBonesWeights[1] + 
-						uBonesTransforms[bonesTransformsBaseIdx + aBonesIDs[2]]*aBonesWeights[2] + 
-						uBonesTransforms[bonesTransformsBaseIdx + aBonesIDs[3]]*aBonesWeights[3]; 
+		boneTransform = uFrameMats[aBonesTransformsBaseIdx + aBonesIDs[0]]*aBonesWeights[0] + 
+						uFrameMats[aBonesTransformsBaseIdx + aBonesIDs[1]]*aBonesWeights[1] + 
+						uFrameMats[aBonesTransformsBaseIdx + aBonesIDs[2]]*aBonesWeights[2] + 
+						uFrameMats[aBonesTransformsBaseIdx + aBonesIDs[3]]*aBonesWeights[3]; 
 	} 
 
-   gl_Position = uMVPs[aInstanceDataIdx] * uMeshTransform * boneTransform * aPos; 	
+	mat4 mvp = (aInstanceDataIdx & FRAME_TRANSFORMAT_FLAG) != 0u ? uFrameMats[aInstanceDataIdx & ~FRAME_TRANSFORMAT_FLAG] : uMVPs[aInstanceDataIdx]; 
+   gl_Position = mvp * uMeshTransform * boneTransform * aPos; 	
 };
\ No newline at end of file
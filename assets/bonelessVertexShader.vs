@@ -8,6 +8,11 @@ uniform uint uBaseVertex;  // TODO: simplify this shit
 layout (std430, binding = 4) buffer TransformatsBuffer { 
 	mat4 uTransformats[]; 
 };  
+// the frame's region of the frame ring - the mobile instances' transformats
+layout (std430, binding = 6) buffer FrameMatsBuffer { 
+	mat4 uFrameMats[]; 
+}; 
+const uint FRAME_TRANSFORMAT_FLAG = 0x80000000u;
 layout (std430, binding = 7) buffer SelectedColorsIdxsBuffer { 
 	uint uSelectedColorsIdxs[]; 
 }; 
@@ -21,5 +26,6 @@ void main(void) {
 //	passColor = uColors[uSelectedColorsIdxs[aInstanceDataIdx] + gl_VertexID - uBaseVertex]; //	passColor = uColors[gl_VertexID]; 
 //  passColor = vec4(aInstanceDataIdx/2.0f, aInstanceDataIdx/2.0f, aInstanceDataIdx/2.0f, 1.0f);
 	passColor = vec4(0.5f, 0.5f, 0.5f, 1.0f);
-	gl_Position = uVpMat * uTransformats[aInstanceDataIdx] * aPos;  //*** uVpMat 
+	mat4 transformat = (aInstanceDataIdx & FRAME_TRANSFORMAT_FLAG) != 0u ? uFrameMats[aInstanceDataIdx & ~FRAME_TRANSFORMAT_FLAG] : uTransformats[aInstanceDataIdx];
+	gl_Position = uVpMat * transformat * aPos;  //*** uVpMat 
 };
\ No newline at end of file